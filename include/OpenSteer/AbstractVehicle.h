@@ -41,6 +41,7 @@
 
 
 #include "OpenSteer/LocalSpace.h"
+#include "OpenSteer/NeighborRecord.h"
 
 
 // STL vector containers
@@ -100,6 +101,12 @@ namespace OpenSteer {
     typedef AbstractVehicle::group AVGroup;
     typedef AbstractVehicle::iterator AVIterator;
 
+    // proximity query results for AbstractVehicles: each neighbor with its
+    // distance squared and offset from the query center
+    typedef NeighborRecord<AbstractVehicle*> AVNeighbor;
+    typedef std::vector<AVNeighbor> AVNeighborGroup;
+    typedef AVNeighborGroup::const_iterator AVNeighborIterator;
+
 } // namespace OpenSteer
 
 
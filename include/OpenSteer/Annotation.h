@@ -48,16 +48,117 @@
 #ifndef NOT_OPENSTEERDEMO  // only when building OpenSteerDemo
 #include "OpenSteer/Draw.h"
 #endif // NOT_OPENSTEERDEMO
+#include <cstddef>
+#include <vector>
+#include <algorithm>
 #include "OpenSteer/Vec3.h"
 #include "OpenSteer/Color.h"
+#include "OpenSteer/MemoryAccount.h"
 
 // ----------------------------------------------------------------------------
 
 
 namespace OpenSteer {
 
+
+    // ------------------------------------------------------------------------
+    // TrailPool: storage for the trails of AnnotationMixin, shared by all
+    // vehicles.  A vehicle only gets a ring of trail vertices when its trail
+    // is drawn and wanted: it is opted in (setTrailOptIn), it is the focus
+    // vehicle (OpenSteerDemo's selected one), or it is within the focus
+    // radius of the focus point (the camera) and the pool has not yet handed
+    // out its budget of rings.  Rings which have not been drawn for a number
+    // of frames go back to the pool for other vehicles, so a vehicle which
+    // is never drawn never has trail storage, and recordTrailVertex for it
+    // only keeps its current position.
+    //
+    // Rings are acquired and recycled in the draw phase, never concurrently
+    // with updates (which record into rings they already have).
+
+
+    class TrailPool
+    {
+    public:
+
+        // one vehicle's ring of recent positions and their flags: bit 0
+        // draws the segment, bit 1 is a tick mark.  The generation changes
+        // whenever the ring changes hands.  Rings and their storage are
+        // charged to trail memory.
+        class Ring : public AccountedObject<MemoryAccount::trailMemory>
+        {
+        public:
+            Ring (void) : capacity (0), generation (0), lastDrawn (0),
+                          inUse (false) {}
+            AccountedVector<Vec3, MemoryAccount::trailMemory>::type vertices;
+            AccountedVector<char, MemoryAccount::trailMemory>::type flags;
+            int capacity;
+            unsigned generation;
+            unsigned long lastDrawn;
+            bool inUse;
+        };
+
+        TrailPool (void);
+        ~TrailPool (void);
+
+        // the pool used by AnnotationMixin (never destroyed, so vehicles
+        // may release their rings during static destruction)
+        static TrailPool& shared (void);
+
+        // called once per redraw before any trail is drawn: recycles the
+        // rings not drawn in the last idleFrames frames
+        void beginFrame (void);
+
+        // which vehicles want trails, see above.  The defaults (no focus
+        // vehicle, an unlimited radius) give a trail to every drawn
+        // vehicle, up to the budget.
+        // (vehicles are identified by the address of the most derived
+        // object, as from dynamic_cast<const void*>)
+        void setFocus (const Vec3& position, const float radius,
+                       const void* vehicle);
+        bool wantsTrail (const void* vehicle, const Vec3& position,
+                         const bool optIn) const;
+        bool isFocus (const void* vehicle) const
+            {return vehicle && (vehicle == focusVehicle);}
+
+        // a cleared ring of at least vertexCount vertices, or NULL when
+        // the budget is used up (unless priority: for opted in and focus
+        // vehicles), and its return
+        Ring* acquire (const int vertexCount, const bool priority);
+        void release (Ring* ring);
+
+        // note that a ring is drawn this frame
+        void touch (Ring& ring) const {ring.lastDrawn = frame;}
+
+        // largest number of rings handed out to vehicles which are neither
+        // opted in nor the focus vehicle, and frames a ring stays with a
+        // vehicle which stops drawing it
+        void setBudget (const size_t rings) {budget = rings;}
+        void setIdleFrames (const unsigned long frames) {idleFrames = frames;}
+
+        size_t ringsInUse (void) const {return inUse;}
+        size_t ringsAllocated (void) const {return rings.size();}
+
+    private:
+
+        AccountedVector<Ring*, MemoryAccount::trailMemory>::type rings;
+        AccountedVector<Ring*, MemoryAccount::trailMemory>::type freeRings;
+        size_t inUse;
+        size_t budget;
+        unsigned long idleFrames;
+        unsigned long frame;
+
+        Vec3 focusPosition;
+        float focusRadius;
+        const void* focusVehicle;
+
+        // not copyable
+        TrailPool (const TrailPool&);
+        TrailPool& operator= (const TrailPool&);
+    };
+
+
     extern bool enableAnnotation;
-    extern bool drawPhaseActive;
+    extern thread_local bool drawPhaseActive;
 
     // graphical annotation: master on/off switch
     inline bool annotationIsOn (void) {return enableAnnotation;}
@@ -76,6 +177,10 @@ namespace OpenSteer {
         // destructor
         virtual ~AnnotationMixin ();
 
+        // compile time annotation policy: SteerLibraryMixin calls its
+        // annotate* hooks only when layered on a class where this is true
+        static const bool hasAnnotation = true;
+
         // ------------------------------------------------------------------------
         // trails / streamers
         //
@@ -92,12 +197,24 @@ namespace OpenSteer {
         void drawTrail  (const Color& trailColor, const Color& tickColor);
 
         // set trail parameters: the amount of time it represents and the
-        // number of samples along its length.  re-allocates internal buffers.
+        // number of samples along its length.  Clears the trail.
         void setTrailParameters (const float duration, const int vertexCount);
 
         // forget trail history: used to prevent long streaks due to teleportation
         void clearTrailHistory (void);
 
+        // always keep a trail for this vehicle (while drawn), whatever the
+        // TrailPool's focus and budget
+        void setTrailOptIn (const bool optIn) {trailOptIn = optIn;}
+
+        // whether this vehicle currently has trail storage from the pool
+        bool hasTrail (void) const
+            {return trail && (trail->generation == trailGeneration);}
+
+        // trade trails (ring, history and parameters) with another vehicle,
+        // for when two vehicles trade the rest of their state too
+        void exchangeTrail (AnnotationMixin& other);
+
         // ------------------------------------------------------------------------
         // drawing of lines, circles and (filled) disks to annotate steering
         // behaviors.  When called during OpenSteerDemo's simulation update phase,
@@ -212,8 +329,85 @@ namespace OpenSteer {
         float trailLastSampleTime;  // global time when lat sample was taken
         int trailDottedPhase;       // dotted line: draw segment or not
         Vec3 curPosition;           // last reported position of vehicle
-        Vec3* trailVertices;        // array (ring) of recent points along trail
-        char* trailFlags;           // array (ring) of flag bits for trail points
+        TrailPool::Ring* trail;     // ring of recent points along the trail
+        unsigned trailGeneration;   // generation of the ring when acquired
+        bool trailOptIn;            // keep a trail whenever drawn
+
+        void clearTrail (void);
+    };
+
+
+    // ------------------------------------------------------------------------
+    // The "annotation off" policy: AnnotationMixin's interface, with every
+    // function an empty inline one and no trail storage, so annotation costs
+    // nothing at run time.  SteerLibraryMixin layered on it drops its
+    // annotate* hook calls from the steering loops.  SimpleVehicle uses it
+    // in place of AnnotationMixin when OPENSTEER_NULL_ANNOTATION is defined
+    // (a CMake option of the same name).
+    //
+    // (parameter names commented out to prevent compiler warning from "-W")
+
+
+    template <class Super>
+    class NullAnnotationMixin : public Super
+    {
+    public:
+
+        static const bool hasAnnotation = false;
+
+        // trails / streamers
+        void recordTrailVertex (const float /*currentTime*/,
+                                const Vec3& /*position*/) {}
+        void drawTrail (void) {}
+        void drawTrail (const Color& /*trailColor*/,
+                        const Color& /*tickColor*/) {}
+        void setTrailParameters (const float /*duration*/,
+                                 const int /*vertexCount*/) {}
+        void clearTrailHistory (void) {}
+        void setTrailOptIn (const bool /*optIn*/) {}
+        bool hasTrail (void) const {return false;}
+        void exchangeTrail (NullAnnotationMixin& /*other*/) {}
+
+        // lines, circles and (filled) disks
+        void annotationLine (const Vec3& /*startPoint*/,
+                             const Vec3& /*endPoint*/,
+                             const Color& /*color*/) const {}
+        void annotationXZCircle (const float /*radius*/,
+                                 const Vec3& /*center*/,
+                                 const Color& /*color*/,
+                                 const int /*segments*/) const {}
+        void annotationXZDisk (const float /*radius*/,
+                               const Vec3& /*center*/,
+                               const Color& /*color*/,
+                               const int /*segments*/) const {}
+        void annotation3dCircle (const float /*radius*/,
+                                 const Vec3& /*center*/,
+                                 const Vec3& /*axis*/,
+                                 const Color& /*color*/,
+                                 const int /*segments*/) const {}
+        void annotation3dDisk (const float /*radius*/,
+                               const Vec3& /*center*/,
+                               const Vec3& /*axis*/,
+                               const Color& /*color*/,
+                               const int /*segments*/) const {}
+        void annotationXZCircleOrDisk (const float /*radius*/,
+                                       const Vec3& /*center*/,
+                                       const Color& /*color*/,
+                                       const int /*segments*/,
+                                       const bool /*filled*/) const {}
+        void annotation3dCircleOrDisk (const float /*radius*/,
+                                       const Vec3& /*center*/,
+                                       const Vec3& /*axis*/,
+                                       const Color& /*color*/,
+                                       const int /*segments*/,
+                                       const bool /*filled*/) const {}
+        void annotationCircleOrDisk (const float /*radius*/,
+                                     const Vec3& /*axis*/,
+                                     const Vec3& /*center*/,
+                                     const Color& /*color*/,
+                                     const int /*segments*/,
+                                     const bool /*filled*/,
+                                     const bool /*in3d*/) const {}
     };
 
 } // namespace OpenSteer
@@ -227,14 +421,10 @@ namespace OpenSteer {
 template<class Super>
 OpenSteer::AnnotationMixin<Super>::AnnotationMixin (void)
 {
-    trailVertices = NULL;
-    trailFlags = NULL;
-
-    // xxx I wonder if it makes more sense to NOT do this here, see if the
-    // xxx vehicle class calls it to set custom parameters, and if not, set
-    // xxx these default parameters on first call to a "trail" function.  The
-    // xxx issue is whether it is a problem to allocate default-sized arrays
-    // xxx then to free them and allocate new ones
+    // no trail storage until the trail is drawn (see TrailPool)
+    trail = NULL;
+    trailGeneration = 0;
+    trailOptIn = false;
     setTrailParameters (5, 100);  // 5 seconds with 100 points along the trail
 }
 
@@ -242,14 +432,14 @@ OpenSteer::AnnotationMixin<Super>::AnnotationMixin (void)
 template<class Super>
 OpenSteer::AnnotationMixin<Super>::~AnnotationMixin (void)
 {
-    delete[] trailVertices;
-    delete[] trailFlags;
+    if (hasTrail ()) TrailPool::shared().release (trail);
 }
 
 
 // ----------------------------------------------------------------------------
 // set trail parameters: the amount of time it represents and the number of
-// samples along its length.  re-allocates internal buffers.
+// samples along its length.  A ring already held is kept when it is large
+// enough, so vehicles can be reset in place.
 
 
 template<class Super>
@@ -267,16 +457,29 @@ OpenSteer::AnnotationMixin<Super>::setTrailParameters (const float duration,
     trailSampleInterval = trailDuration / trailVertexCount;
     trailDottedPhase = 1;
 
-    // prepare trailVertices array: free old one if needed, allocate new one
-    delete[] trailVertices;
-    trailVertices = new Vec3[trailVertexCount];
+    if (hasTrail ())
+    {
+        if (trail->capacity < trailVertexCount)
+        {
+            TrailPool::shared().release (trail);
+            trail = NULL;
+        }
+        else
+        {
+            clearTrail ();
+        }
+    }
+}
+
+
+// initializing all flags to zero means "do not draw this segment"
 
-    // prepare trailFlags array: free old one if needed, allocate new one
-    delete[] trailFlags;
-    trailFlags = new char[trailVertexCount];
 
-    // initializing all flags to zero means "do not draw this segment"
-    for (int i = 0; i < trailVertexCount; i++) trailFlags[i] = 0;
+template<class Super>
+void 
+OpenSteer::AnnotationMixin<Super>::clearTrail (void)
+{
+    for (int i = 0; i < trailVertexCount; i++) trail->flags[i] = 0;
 }
 
 
@@ -296,6 +499,28 @@ OpenSteer::AnnotationMixin<Super>::clearTrailHistory (void)
 }
 
 
+// ----------------------------------------------------------------------------
+// trade trails with another vehicle: the ring stays handed out, to the
+// vehicle which now has the history it holds
+
+
+template<class Super>
+void 
+OpenSteer::AnnotationMixin<Super>::exchangeTrail (AnnotationMixin& other)
+{
+    std::swap (trailVertexCount, other.trailVertexCount);
+    std::swap (trailIndex, other.trailIndex);
+    std::swap (trailDuration, other.trailDuration);
+    std::swap (trailSampleInterval, other.trailSampleInterval);
+    std::swap (trailLastSampleTime, other.trailLastSampleTime);
+    std::swap (trailDottedPhase, other.trailDottedPhase);
+    std::swap (curPosition, other.curPosition);
+    std::swap (trail, other.trail);
+    std::swap (trailGeneration, other.trailGeneration);
+    std::swap (trailOptIn, other.trailOptIn);
+}
+
+
 // ----------------------------------------------------------------------------
 // record a position for the current time, called once per update
 
@@ -309,11 +534,14 @@ OpenSteer::AnnotationMixin<Super>::recordTrailVertex (const float currentTime,
     if (timeSinceLastTrailSample > trailSampleInterval)
     {
         trailIndex = (trailIndex + 1) % trailVertexCount;
-        trailVertices [trailIndex] = position;
         trailDottedPhase = (trailDottedPhase + 1) % 2;
-        const int tick = (floorXXX (currentTime) >
-                          floorXXX (trailLastSampleTime));
-        trailFlags [trailIndex] = trailDottedPhase | (tick ? '\2' : '\0');
+        if (hasTrail ())
+        {
+            trail->vertices [trailIndex] = position;
+            const int tick = (floorXXX (currentTime) >
+                              floorXXX (trailLastSampleTime));
+            trail->flags [trailIndex] = trailDottedPhase | (tick ? '\2' : '\0');
+        }
         trailLastSampleTime = currentTime;
     }
     curPosition = position;
@@ -331,6 +559,23 @@ OpenSteer::AnnotationMixin<Super>::drawTrail (const Color& trailColor,
 {
     if (enableAnnotation)
     {
+        // a ring from the pool, for a vehicle which wants one (it starts
+        // empty: the trail grows from here on)
+        TrailPool& pool = TrailPool::shared ();
+        const void* self = dynamic_cast<const void*> (this);
+        if (! pool.wantsTrail (self, curPosition, trailOptIn)) return;
+        if (! hasTrail ())
+        {
+            trail = pool.acquire (trailVertexCount,
+                                  trailOptIn || pool.isFocus (self));
+            if (! trail) return;
+            trailGeneration = trail->generation;
+            clearTrail ();
+        }
+        pool.touch (*trail);
+        const Vec3* trailVertices = &trail->vertices[0];
+        const char* trailFlags = &trail->flags[0];
+
         int index = trailIndex;
         for (int j = 0; j < trailVertexCount; j++)
         {
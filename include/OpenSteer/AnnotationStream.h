@@ -0,0 +1,235 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// AnnotationStream
+//
+// Moves annotation off the simulation: each step's annotation lines and
+// circles (those deferredDrawLine and deferredDrawCircleOrDisk would
+// queue, which is where AnnotationMixin's annotation* functions and so
+// the SteerLibraryMixin annotate* hooks end up during an update) and the
+// state of every vehicle go into a compact binary stream instead of being
+// drawn.  A viewer plays the stream back later, or live from the other
+// end of a pipe or socket, drawing the vehicles (and from their recorded
+// positions any trails) and the annotation of each step.
+//
+// AnnotationStreamWriter serializes a SimulationSnapshot into a frame
+// buffer on the simulation thread, which is a few copies per primitive,
+// and hands it to a thread of its own which writes it to a file or file
+// descriptor.  The simulation never waits for the disk or the network:
+// frames which would take the writer's queue over its limit are dropped
+// (and counted) instead.
+//
+// The stream starts with a header (magic, version, byte order mark and the
+// name of the PlugIn recorded), followed by one frame per step: a
+// FrameHeader, then its vehicles (SimulationSnapshot::Vehicle records),
+// lines and circles (the records below, with 8 bit RGBA colors).  The layout is native (byte order,
+// float format), for viewers on machines like the recording one.
+//
+// AnnotationStreamReader reads a stream back into SimulationSnapshots, see
+// OpenSteerDemo::setAnnotationPlayback.
+//
+// See OpenSteerDemo::setAnnotationStreamWriter, OpenSteerHeadless
+// --annotation and OpenSteerDemo --play.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_ANNOTATIONSTREAM_H
+#define OPENSTEER_ANNOTATIONSTREAM_H
+
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "OpenSteer/SimulationSnapshot.h"
+
+
+namespace OpenSteer {
+
+
+    // ------------------------------------------------------------------------
+    // the stream layout
+
+
+    struct AnnotationStreamFrameHeader
+    {
+        uint32_t size;          // bytes of records following the header
+        float currentTime;
+        float elapsedTime;
+        int32_t selected;       // index of the selected vehicle, -1 for none
+        uint32_t vehicleCount;
+        uint32_t lineCount;
+        uint32_t circleCount;
+    };
+
+
+    struct AnnotationStreamLine
+    {
+        PlainVec3 startPoint;
+        PlainVec3 endPoint;
+        uint8_t color[4];
+    };
+
+
+    struct AnnotationStreamCircle
+    {
+        float radius;
+        PlainVec3 axis;
+        PlainVec3 center;
+        uint8_t color[4];
+        uint16_t segments;
+        uint8_t flags;          // bit 0 filled, bit 1 in 3d
+        uint8_t unused;
+    };
+
+
+    // ------------------------------------------------------------------------
+    // the simulation side
+
+
+    class AnnotationStreamWriter
+    {
+    public:
+
+        static const uint32_t version = 1;
+
+        AnnotationStreamWriter (void);
+        ~AnnotationStreamWriter ();
+
+        // Start a stream of the named PlugIn in a new file, or on an open
+        // file descriptor such as a connected socket or a pipe (which is
+        // duplicated, the caller keeps its own; not on Windows).  Returns
+        // false if the stream cannot be started.
+        bool open (const char* fileName, const char* plugInName);
+        bool openDescriptor (const int descriptor, const char* plugInName);
+
+        // write out the frames still queued, then stop
+        void close (void);
+        bool isOpen (void) const {return file != 0;}
+
+        // Queue a snapshot's vehicles and annotation as the next frame, or
+        // drop it if the queue is full.
+        void writeFrame (const SimulationSnapshot& snapshot);
+
+        // most bytes of frames waiting to be written (default 64MB)
+        void setQueueLimit (const size_t bytes);
+
+        // frames queued and dropped so far, and whether writing failed
+        // (the writer then drops every frame)
+        size_t frameCount (void) const {return frames;}
+        size_t droppedFrameCount (void) const {return droppedFrames;}
+        bool failed (void) const {return writeFailed;}
+
+    private:
+
+        bool start (std::FILE* stream, const char* plugInName);
+
+        // body of the writing thread
+        void drain (void);
+
+        std::FILE* file;
+        std::thread drainer;
+        std::mutex mutex;
+        std::condition_variable wake;
+        bool stopping;
+        std::atomic<bool> writeFailed;
+
+        // frames waiting to be written, emptied buffers for reuse and the
+        // frame being serialized
+        std::vector<std::vector<unsigned char> > pending;
+        std::vector<std::vector<unsigned char> > spare;
+        std::vector<unsigned char> frame;
+        size_t queuedBytes;
+        size_t queueLimit;
+
+        size_t frames;
+        size_t droppedFrames;
+
+        // not copyable
+        AnnotationStreamWriter (const AnnotationStreamWriter&);
+        AnnotationStreamWriter& operator= (const AnnotationStreamWriter&);
+    };
+
+
+    // ------------------------------------------------------------------------
+    // the viewer side
+
+
+    class AnnotationStreamReader
+    {
+    public:
+
+        AnnotationStreamReader (void);
+        ~AnnotationStreamReader ();
+
+        // open a stream file, returns false unless it is one of this
+        // version and byte order
+        bool open (const char* fileName);
+        void close (void);
+        bool isOpen (void) const {return file != 0;}
+
+        // name of the PlugIn recorded
+        const std::string& plugInName (void) const {return name;}
+
+        // Read the next frame into a snapshot (its vehicles, lines,
+        // circles, selected vehicle and times).  Returns false at the end
+        // of the stream or if the frame is malformed.
+        bool readFrame (SimulationSnapshot& snapshot);
+
+        // continue with the first frame again
+        void rewind (void);
+
+        // frames read since opening or rewinding
+        size_t frameCount (void) const {return frames;}
+
+    private:
+
+        std::FILE* file;
+        long firstFrame;
+        std::string name;
+        size_t frames;
+        std::vector<unsigned char> records;
+
+        // not copyable
+        AnnotationStreamReader (const AnnotationStreamReader&);
+        AnnotationStreamReader& operator= (const AnnotationStreamReader&);
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_ANNOTATIONSTREAM_H
@@ -0,0 +1,206 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// AsyncJob
+//
+// Planning queries run off the frame thread.  A vehicle keeps an AsyncPlan
+// for each decision it makes this way: each frame it takes the result of
+// its latest query if that has finished, steers on the last result it
+// took, and submits the next query once none is pending.  The queries run
+// on the threads of an AsyncJobQueue, one query per thread at a time, so
+// however long a query takes, the frame only pays for copying its input.
+//
+// A query is a copyable function object returning the plan's result.  It
+// must own copies of everything it reads: it runs while the simulation
+// goes on, and may finish after its vehicle is gone.  Cancelling a plan
+// (as on reset, or by submitting another query) drops the result; a query
+// not yet started is skipped, and a running one may stop early by polling
+// AsyncJobQueue::currentJobCancelled.
+//
+// The queue has threads of its own rather than sharing WorkerPool's, whose
+// parallelFor waits for every one of its workers.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_ASYNCJOB_H
+#define OPENSTEER_ASYNCJOB_H
+
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+
+namespace OpenSteer {
+
+
+    // ------------------------------------------------------------------------
+    // background threads running queued jobs in submission order
+
+
+    class AsyncJobQueue
+    {
+    public:
+
+        // a job: run once on one of the queue's threads, unless cancelled
+        // before it starts
+        class Job
+        {
+        public:
+            Job (void) : cancelled (false), done (false) {}
+            virtual ~Job () {}
+            virtual void run (void) = 0;
+
+            std::atomic<bool> cancelled;
+            std::atomic<bool> done;
+        };
+
+        // threadCount threads (at least one)
+        AsyncJobQueue (int threadCount = 1);
+
+        // skips the jobs not yet started and waits for the running ones
+        ~AsyncJobQueue ();
+
+        int threadCount (void) const {return (int) threads.size();}
+
+        void submit (const std::shared_ptr<Job>& job);
+
+        // jobs submitted and not yet done or skipped
+        size_t pendingCount (void);
+
+        // wait until every job submitted so far is done or skipped
+        void waitUntilIdle (void);
+
+        // for a job: has the one running on the calling thread been
+        // cancelled?  (false outside jobs)
+        static bool currentJobCancelled (void);
+
+        // shared queue with one thread, created on first use
+        static AsyncJobQueue& shared (void);
+
+    private:
+
+        void threadLoop (void);
+
+        std::vector<std::thread> threads;
+        std::mutex mutex;
+        std::condition_variable wakeThreads;
+        std::condition_variable idle;
+        std::deque<std::shared_ptr<Job> > jobs;
+        size_t running;
+        bool stopping;
+
+        // not copyable
+        AsyncJobQueue (const AsyncJobQueue&);
+        AsyncJobQueue& operator= (const AsyncJobQueue&);
+    };
+
+
+    // ------------------------------------------------------------------------
+    // one decision made by queries on a queue: at most one query pending,
+    // whose result is taken in a later frame
+
+
+    template <class Result>
+    class AsyncPlan
+    {
+    public:
+
+        AsyncPlan (void) {}
+        ~AsyncPlan () {cancel ();}
+
+        // run query () on a queue, cancelling any query still pending
+        template <class Query>
+        void submit (const Query& query,
+                     AsyncJobQueue& queue = AsyncJobQueue::shared ())
+        {
+            cancel ();
+            pending = std::make_shared<QueryJob<Query> > (query);
+            queue.submit (pending);
+        }
+
+        // submitted and not taken yet, and finished
+        bool isPending (void) const {return pending.get() != 0;}
+        bool isReady (void) const {return pending && pending->done;}
+
+        // when the pending query has finished, set result to its result,
+        // stop it being pending and return true
+        bool take (Result& result)
+        {
+            if (! isReady ()) return false;
+            result = pending->result;
+            pending.reset ();
+            return true;
+        }
+
+        // forget the pending query, if any
+        void cancel (void)
+        {
+            if (pending) pending->cancelled = true;
+            pending.reset ();
+        }
+
+    private:
+
+        class ResultJob : public AsyncJobQueue::Job
+        {
+        public:
+            Result result;
+        };
+
+        template <class Query>
+        class QueryJob : public ResultJob
+        {
+        public:
+            QueryJob (const Query& q) : query (q) {}
+            void run (void) {this->result = query ();}
+        private:
+            Query query;
+        };
+
+        std::shared_ptr<ResultJob> pending;
+
+        // not copyable
+        AsyncPlan (const AsyncPlan&);
+        AsyncPlan& operator= (const AsyncPlan&);
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_ASYNCJOB_H
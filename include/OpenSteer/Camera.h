@@ -46,6 +46,7 @@
 
 #include "OpenSteer/LocalSpace.h"
 #include "OpenSteer/AbstractVehicle.h"
+#include "OpenSteer/ViewFrustum.h"
 
 
 // ----------------------------------------------------------------------------
@@ -94,6 +95,32 @@ namespace OpenSteer {
         bool smoothNextMove;
         float smoothMoveSpeed;
 
+        // the perspective projection OpenSteerDemo sets up: vertical field
+        // of view in degrees, distances of the near and far clipping planes
+        // and the window's width / height (kept up to date by OpenSteerDemo)
+        float fieldOfViewY;
+        float nearDistance;
+        float farDistance;
+        float aspectRatio;
+
+        // the volume the camera sees, as of its last update
+        ViewFrustum viewFrustum (void) const;
+
+        // for culling in PlugIn redraws: the vehicles which may be visible
+        // (see ViewFrustum::findVisibleVehicles), found with a query of
+        // token's proximity database (any token of the database will do)
+        // over the visible part of the box from lo to hi, which holds the
+        // centers of vehicles of radius up to maxRadius
+        void findVisibleVehicles (AbstractTokenForProximityDatabase<AbstractVehicle*>& token,
+                                  const Vec3& lo,
+                                  const Vec3& hi,
+                                  const float maxRadius,
+                                  AVGroup& results) const
+        {
+            viewFrustum().findVisibleVehicles (token, lo, hi, maxRadius,
+                                               results);
+        }
+
         // adjust the offset vector of the current camera mode based on a
         // "mouse adjustment vector" from OpenSteerDemo (xxx experiment 10-17-02)
         void mouseAdjustOffset (const Vec3& adjustment);
@@ -0,0 +1,328 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Checkpoint
+//
+// A compact binary snapshot of a PlugIn's world, so a long experiment can
+// be restarted from the same mid-simulation state instead of replaying its
+// warm-up.  A checkpoint file starts with a header (magic, format version
+// and a byte order mark) followed by tagged sections, each an array of
+// plain data records of one size: typically the SimpleVehicle state of
+// every vehicle (CheckpointVehicle), records of PlugIn specific fields,
+// the proximity database configuration, obstacles and path points.
+//
+// CheckpointWriter collects the sections in memory and writes them with a
+// single write.  CheckpointReader memory-maps a file (or reads it whole
+// where mmap is not available) and hands out pointers to the section
+// arrays in place, so restoring is a bulk copy per vehicle with no parsing.
+// Every section starts on an 8 byte boundary.
+//
+// Records are stored in the native layout of the build, so checkpoints are
+// only meant to be read by the build (or an identical one) that wrote
+// them; the reader rejects other versions and byte orders, and sections
+// whose record size does not match.
+//
+// PlugIns opt in through AbstractPlugIn::saveCheckpoint and
+// loadCheckpoint, see OpenSteerHeadless --save and --load.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_CHECKPOINT_H
+#define OPENSTEER_CHECKPOINT_H
+
+
+#include <cstddef>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include "OpenSteer/Proximity.h"
+#include "OpenSteer/Random.h"
+#include "OpenSteer/Vec3.h"
+
+
+namespace OpenSteer {
+
+
+    // section tag made of four characters, e.g. checkpointTag ("BOID")
+    typedef uint32_t CheckpointTag;
+
+    inline CheckpointTag checkpointTag (const char* name)
+    {
+        return ((uint32_t) (unsigned char) name[0]) |
+               ((uint32_t) (unsigned char) name[1] << 8) |
+               ((uint32_t) (unsigned char) name[2] << 16) |
+               ((uint32_t) (unsigned char) name[3] << 24);
+    }
+
+
+    // ------------------------------------------------------------------------
+    // the state SimpleVehicle keeps for the simulation, see
+    // SimpleVehicle::saveState and restoreState (plain data, as it is
+    // copied as raw bytes: also by steering logs and region messages)
+
+
+    struct CheckpointVehicle
+    {
+        // local space (and, built with OPENSTEER_COMPACT_LOCAL_SPACE, the
+        // rotation it is kept as, which restores it exactly)
+        PlainVec3 side;
+        PlainVec3 up;
+        PlainVec3 forward;
+        PlainVec3 position;
+#ifdef OPENSTEER_COMPACT_LOCAL_SPACE
+        float rotation[4];
+#endif
+
+        float mass;
+        float radius;
+        float speed;
+        float maxForce;
+        float maxSpeed;
+
+        // path curvature and the running averages
+        float curvature;
+        float smoothedCurvature;
+        PlainVec3 lastForward;
+        PlainVec3 lastPosition;
+        PlainVec3 smoothedPosition;
+        PlainVec3 smoothedAcceleration;
+
+        // wander state, and the vehicle's own random numbers continue
+        // where they left off
+        float wanderSide;
+        float wanderUp;
+        RandomStream randomStream;
+    };
+
+
+    // a sphere obstacle (center, radius and Obstacle::seenFromState)
+    struct CheckpointSphere
+    {
+        Vec3 center;
+        float radius;
+        int seenFrom;
+    };
+
+
+    // ------------------------------------------------------------------------
+
+
+    class CheckpointWriter
+    {
+    public:
+
+        // current file format version
+        static const uint32_t version = 1;
+
+        // a checkpoint of the named PlugIn at the given simulation time
+        CheckpointWriter (const char* plugInName, const float currentTime);
+
+        // add a section holding count plain data records
+        template <class Record>
+        void addArray (const CheckpointTag tag,
+                       const Record* records,
+                       const size_t count)
+        {
+            addSection (tag, sizeof (Record), count, records);
+        }
+
+        // add a section holding a single record
+        template <class Record>
+        void addRecord (const CheckpointTag tag, const Record& record)
+        {
+            addArray (tag, &record, 1);
+        }
+
+        // add a section with the SimpleVehicle state of each member of a
+        // group (an STL vector of pointers to SimpleVehicle subclasses)
+        template <class Group>
+        void addVehicles (const CheckpointTag tag, const Group& group)
+        {
+            vehicles.resize (group.size ());
+            for (size_t i = 0; i < group.size (); i++)
+                group[i]->saveState (vehicles[i]);
+            addArray (tag, vehicles.empty () ? 0 : &vehicles[0],
+                      vehicles.size ());
+        }
+
+        // add the state of a proximity database and, as indices into a
+        // group of the objects it holds, their placement order (see
+        // AbstractProximityDatabase::saveState)
+        template <class Group, class ContentType>
+        void addProximityDatabase (const CheckpointTag stateTag,
+                                   const CheckpointTag orderTag,
+                                   AbstractProximityDatabase<ContentType>& database,
+                                   const Group& group)
+        {
+            ProximityDatabaseState state;
+            database.saveState (state);
+            addRecord (stateTag, state);
+
+            std::map<ContentType, uint32_t> indices;
+            for (size_t i = 0; i < group.size (); i++)
+                indices[group[i]] = (uint32_t) i;
+            std::vector<ContentType> objects;
+            database.copyPlacementOrder (objects);
+            order.clear ();
+            for (size_t i = 0; i < objects.size (); i++)
+            {
+                typename std::map<ContentType, uint32_t>::const_iterator
+                    index = indices.find (objects[i]);
+                if (index != indices.end ()) order.push_back (index->second);
+            }
+            addArray (orderTag, order.empty () ? 0 : &order[0], order.size ());
+        }
+
+        // the checkpoint so far, and writing it to a file (returns false if
+        // the file cannot be written)
+        const std::vector<char>& bytes (void) const {return buffer;}
+        bool writeFile (const char* fileName) const;
+
+    private:
+
+        void addSection (const CheckpointTag tag,
+                         const size_t recordSize,
+                         const size_t count,
+                         const void* records);
+
+        std::vector<char> buffer;
+
+        // scratch space for addVehicles and addProximityDatabase
+        std::vector<CheckpointVehicle> vehicles;
+        std::vector<uint32_t> order;
+    };
+
+
+    // ------------------------------------------------------------------------
+
+
+    class CheckpointReader
+    {
+    public:
+
+        CheckpointReader (void);
+        ~CheckpointReader (void);
+
+        // map a checkpoint file, or use a checkpoint in memory (which must
+        // stay valid until close).  Either returns false, leaving the
+        // reader closed, if the data is not a checkpoint of this version.
+        bool open (const char* fileName);
+        bool openMemory (const void* data, const size_t size);
+        void close (void);
+
+        bool isOpen (void) const {return data != 0;}
+
+        // contents of the header section
+        const std::string& plugInName (void) const {return name;}
+        float currentTime (void) const {return time;}
+
+        // the records of a section in place, NULL (and count 0) if there
+        // is no such section or its records are not of this type
+        template <class Record>
+        const Record* array (const CheckpointTag tag, size_t& count) const
+        {
+            return (const Record*) section (tag, sizeof (Record), count);
+        }
+
+        // copy the single record of a section, false if there is none
+        template <class Record>
+        bool record (const CheckpointTag tag, Record& record) const
+        {
+            size_t count;
+            const Record* r = array<Record> (tag, count);
+            if (count != 1) return false;
+            memcpy (&record, r, sizeof (Record));
+            return true;
+        }
+
+        // restore the members of a group from a section written by
+        // addVehicles.  Returns false, changing nothing, unless the
+        // section has one record per member of the group.
+        template <class Group>
+        bool restoreVehicles (const CheckpointTag tag, Group& group) const
+        {
+            size_t count;
+            const CheckpointVehicle* v = array<CheckpointVehicle> (tag, count);
+            if ((v == 0 && ! group.empty ()) || (count != group.size ()))
+                return false;
+            for (size_t i = 0; i < count; i++) group[i]->restoreState (v[i]);
+            return true;
+        }
+
+        // read sections written by addProximityDatabase for a group of
+        // groupSize objects.  Returns false unless the placement order
+        // names each object exactly once.
+        bool proximityDatabase (const CheckpointTag stateTag,
+                                const CheckpointTag orderTag,
+                                const size_t groupSize,
+                                ProximityDatabaseState& state,
+                                std::vector<size_t>& order) const;
+
+    private:
+
+        struct Section
+        {
+            CheckpointTag tag;
+            uint32_t recordSize;
+            uint64_t count;
+            size_t offset;
+        };
+
+        // index the sections and read the header, false if malformed
+        bool parse (void);
+
+        const void* section (const CheckpointTag tag,
+                             const size_t recordSize,
+                             size_t& count) const;
+
+        const char* data;
+        size_t size;
+        std::vector<Section> sections;
+        std::string name;
+        float time;
+
+        // what close must release: a mapping or a file read into memory
+        void* mapping;
+        size_t mappingSize;
+        std::vector<char> fileContents;
+
+        // not copyable
+        CheckpointReader (const CheckpointReader&);
+        CheckpointReader& operator= (const CheckpointReader&);
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_CHECKPOINT_H
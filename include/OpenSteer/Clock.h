@@ -41,6 +41,12 @@
 // Usage: allocate a clock, set its "paused" or "targetFPS" parameters, then
 // call updateGlobalSimulationClock before each simulation step.
 //
+// Optionally the clock banks simulation time for a fixed time step: after
+// each update getSubsteps tells how many whole steps are due, at most the
+// substep budget, and the excess is dropped so a slow frame cannot make
+// the next one slower still.  A frame time budget lets the caller ask how
+// much real time is left in the current frame.
+//
 // 10-04-04 bk:  put everything into the OpenSteer namespace
 // 11-11-03 cwr: another overhaul: support aniamtion mode, switch to
 //               functional API, move smoothed stats inside this class
@@ -88,6 +94,67 @@ namespace OpenSteer {
         void frameRateSync (void);
 
 
+        // fixed time step: each update banks the elapsed simulation time
+        // and takes as many whole steps of it as are due, up to maxSubsteps,
+        // dropping any excess.  Zero seconds (the default) turns it off.
+    private:
+        float fixedTimeStep;
+        int maxSubsteps;
+        int substeps;
+        float stepAccumulator;
+        float steppedSimulationTime;
+        float droppedSimulationTime;
+    public:
+        void setFixedTimeStep (const float seconds, const int maxSubsteps);
+        float getFixedTimeStep (void) const {return fixedTimeStep;}
+        int getMaxSubsteps (void) const {return maxSubsteps;}
+
+        // steps due this frame, and the simulation time at the end of
+        // step i of them
+        int getSubsteps (void) const {return substeps;}
+        float getSubstepTime (const int i) const
+        {
+            return steppedSimulationTime - (substeps - 1 - i) * fixedTimeStep;
+        }
+
+        // give up the steps from i on (when out of frame time), dropping
+        // their simulation time
+        void dropSubsteps (const int i);
+
+        // banked time short of a whole step, as a fraction of a step (for
+        // drawing between steps), and simulation time dropped so far
+        float getStepInterpolation (void) const
+        {
+            return (fixedTimeStep > 0) ? stepAccumulator / fixedTimeStep : 0;
+        }
+        float getDroppedSimulationTime (void) const
+        {
+            return droppedSimulationTime;
+        }
+
+
+        // frame time budget (zero, the default, for none): real time each
+        // frame may take, counted from its update
+    private:
+        float frameBudget;
+    public:
+        void setFrameBudget (const float seconds) {frameBudget = seconds;}
+        float getFrameBudget (void) const {return frameBudget;}
+
+        // real time since this frame's update, and what is left of the
+        // budget (negative once it is exceeded, FLT_MAX without a budget)
+        float getFrameTimeUsed (void)
+        {
+            return realTimeSinceFirstClockUpdate () - totalRealTime;
+        }
+        float getFrameTimeLeft (void)
+        {
+            if (frameBudget <= 0) return FLT_MAX;
+            return frameBudget - getFrameTimeUsed ();
+        }
+        bool frameBudgetExceeded (void) {return getFrameTimeLeft () < 0;}
+
+
         // main clock modes: variable or fixed frame rate, real-time or animation
         // mode, running or paused.
     private:
@@ -0,0 +1,144 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// ContactBroadphase
+//
+// Finds the pairs of vehicles in contact, those whose spheres (position and
+// radius, see AbstractVehicle) overlap, by sweep and prune: each vehicle's
+// extent along one axis is an interval, the intervals are kept sorted by
+// their lower ends, and only vehicles whose intervals overlap have their
+// spheres tested.  The sorted order is kept from one update to the next
+// and repaired by insertion sort, which takes time proportional to the
+// number of vehicles plus the number of them which changed places, so
+// little more than linear time for vehicles which moved a little since the
+// previous frame.  The order is rebuilt from scratch when the group of
+// vehicles changes, along the axis in which they spread furthest.
+//
+// Contacts serve as a quality metric (how many agents overlap each frame,
+// reported by OpenSteerBenchmark) and for collision response, by way of
+// forEachContact.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_CONTACTBROADPHASE_H
+#define OPENSTEER_CONTACTBROADPHASE_H
+
+
+#include <cstddef>
+#include <vector>
+#include "OpenSteer/AbstractVehicle.h"
+
+
+namespace OpenSteer {
+
+
+    class ContactBroadphase
+    {
+    public:
+
+        // two vehicles in contact: vehicle comes before other in the group
+        // passed to update, and penetration is how far their spheres
+        // overlap (the sum of their radii less their distance)
+        struct Contact
+        {
+            AbstractVehicle* vehicle;
+            AbstractVehicle* other;
+            float penetration;
+        };
+
+        // type for a pointer to a function applied to contacts, such as a
+        // collision response, with a caller supplied state
+        typedef void (* contactCallBackFunction) (const Contact& contact,
+                                                  void* clientQueryState);
+
+        ContactBroadphase (void);
+
+        // find the contacts among the given vehicles at their current
+        // positions and radii, returning their number
+        size_t update (const AVGroup& vehicles);
+
+        // the contacts found by the last update, in no particular order
+        const std::vector<Contact>& contacts (void) const {return _contacts;}
+        size_t contactCount (void) const {return _contacts.size ();}
+
+        // apply a function to each contact found by the last update
+        void forEachContact (contactCallBackFunction func,
+                             void* clientQueryState) const;
+
+        // cost of the last update: places moved by the insertion sort (zero
+        // when the order was rebuilt), and pairs whose spheres were tested
+        size_t swapCount (void) const {return _swaps;}
+        size_t pairTestCount (void) const {return _pairTests;}
+
+        // whether the last update rebuilt the order, and the axis swept
+        // (0, 1 or 2 for x, y or z)
+        bool rebuilt (void) const {return _rebuilt;}
+        int sweepAxis (void) const {return _axis;}
+
+        // forget the vehicles, so the next update rebuilds the order
+        void clear (void);
+
+    private:
+
+        // one vehicle's extent along the sweep axis
+        struct Interval
+        {
+            float min;
+            float max;
+            size_t vehicle;
+
+            bool operator< (const Interval& other) const
+            {
+                return min < other.min;
+            }
+        };
+
+        void rebuild (const AVGroup& vehicles);
+        void sort (void);
+        void sweep (void);
+
+        // the vehicles of the last update, their intervals (sorted by min)
+        // and the contacts found
+        AVGroup _vehicles;
+        std::vector<Interval> _intervals;
+        std::vector<Contact> _contacts;
+        int _axis;
+        size_t _swaps;
+        size_t _pairTests;
+        bool _rebuilt;
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_CONTACTBROADPHASE_H
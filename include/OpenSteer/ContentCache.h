@@ -0,0 +1,154 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// ContentCache
+//
+// An on-disk cache of expensive derived data (generated maps, routes and
+// the acceleration structures built over them) addressed by the content
+// of what it was derived from.  The caller describes the inputs of the
+// generation in a ContentKey (parameters, random stream state, source
+// file identity) and stores the results as the sections of a checkpoint
+// (see Checkpoint.h); load then maps the file whose name is the hash of
+// the key, and accepts it only when the full key stored in it compares
+// equal, so a hash collision or a stale file just means regenerating.
+//
+// Files are written to a temporary name and renamed into place, so
+// several processes may share one cache directory.  Nothing is ever
+// evicted: remove the directory's files to reclaim the space.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_CONTENTCACHE_H
+#define OPENSTEER_CONTENTCACHE_H
+
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "OpenSteer/Checkpoint.h"
+
+
+namespace OpenSteer {
+
+
+    // ----------------------------------------------------------------------------
+    // 64 bit FNV-1a hash of size bytes, continuing from hash
+
+
+    const uint64_t contentHashBasis = 0xcbf29ce484222325ULL;
+
+    uint64_t contentHash (const void* data,
+                          const size_t size,
+                          uint64_t hash = contentHashBasis);
+
+
+    // ----------------------------------------------------------------------------
+    // the inputs a cached result was derived from, as bytes: plain data
+    // records (whose padding must be zeroed, say by memset), arrays and
+    // strings, in order
+
+
+    class ContentKey
+    {
+    public:
+
+        template <class Record>
+        void add (const Record& record) {addBytes (&record, sizeof (Record));}
+
+        template <class Record>
+        void addArray (const Record* records, const size_t count)
+        {
+            add ((uint64_t) count);
+            addBytes (records, count * sizeof (Record));
+        }
+
+        void addString (const char* s);
+
+        // the size, modification time and name of a file (empty when it
+        // does not exist), standing in for its contents
+        void addFileIdentity (const char* fileName);
+
+        void addBytes (const void* data, const size_t size);
+
+        const std::vector<char>& bytes (void) const {return key;}
+        uint64_t hash (void) const;
+
+    private:
+        std::vector<char> key;
+    };
+
+
+    // ----------------------------------------------------------------------------
+
+
+    class ContentCache
+    {
+    public:
+
+        // a cache in the given directory (which must exist), or a disabled
+        // cache for NULL or an empty name
+        ContentCache (const char* directory = 0);
+
+        // a cache in the directory named by an environment variable,
+        // disabled unless it is set
+        static ContentCache fromEnvironment (const char* variable);
+
+        bool isEnabled (void) const {return ! directory.empty ();}
+
+        // the file a key's results are stored in, kind being a short name
+        // for what is cached (used as the file name prefix)
+        std::string fileName (const char* kind, const ContentKey& key) const;
+
+        // map the results stored for key into reader, false (leaving it
+        // closed) if the cache is disabled or has none
+        bool load (const char* kind,
+                   const ContentKey& key,
+                   CheckpointReader& reader) const;
+
+        // store the sections of writer as the results for key (adding a
+        // section with the key itself), false if the file cannot be written
+        bool store (const char* kind,
+                    const ContentKey& key,
+                    CheckpointWriter& writer) const;
+
+        // section holding the key in each cache file
+        static CheckpointTag keyTag (void) {return checkpointTag ("CKEY");}
+
+    private:
+        std::string directory;
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_CONTENTCACHE_H
@@ -56,6 +56,7 @@
 #include "OpenSteer/Color.h"
 #include "OpenSteer/AbstractVehicle.h"
 #include "OpenSteer/Obstacle.h"
+#include "OpenSteer/SimulationSnapshot.h"
 
 
 namespace OpenSteer {
@@ -69,10 +70,11 @@ namespace OpenSteer {
     void warnIfInUpdatePhase2( const char* name);
 
     // hosting application must provide this bool. It's true when updating and not drawing,
-    // false otherwise.
+    // false otherwise (on the calling thread: a host may update on one thread
+    // while drawing on another).
     // it has been externed as a first step in making the Draw library useful from
     // other applications besides OpenSteerDemo
-    extern bool updatePhaseActive;
+    extern thread_local bool updatePhaseActive;
 
     inline void warnIfInUpdatePhase (const char* name)
     {
@@ -263,6 +265,16 @@ namespace OpenSteer {
     void drawBasic3dSphericalVehicle (drawTriangleRoutine, const AbstractVehicle& bv,
                                       const Color& color);
 
+    // ------------------------------------------------------------------------
+    // batched vehicle drawing: after beginVehicleBatch the two basic vehicle
+    // routines above only record each vehicle's position, basis, radius and
+    // color.  drawVehicleBatch draws all recorded vehicles with one vertex
+    // array call for the bodies and one for the outlines, then ends batching.
+    // For populations large enough that per vehicle GL calls dominate.
+
+    void beginVehicleBatch (void);
+    void drawVehicleBatch (void);
+
     // ------------------------------------------------------------------------
     // 2d text drawing requires w, h since retrieving viewport w and h differs
     // for every graphics API
@@ -307,6 +319,13 @@ namespace OpenSteer {
                     const Color& color,
                     float w, float h);
 
+    // many 2d lines in one batch: line i runs from endPoints[2*i] to
+    // endPoints[2*i+1] in colors[i]
+    void draw2dLines (const Vec3* endPoints,
+                      const Color* colors,
+                      const size_t lineCount,
+                      float w, float h);
+
 
     // ----------------------------------------------------------------------------
     // draw a line with alpha blending
@@ -336,6 +355,16 @@ namespace OpenSteer {
     void drawAllDeferredLines (void);
     void drawAllDeferredCirclesOrDisks (void);
 
+    // while a snapshot is set, deferred lines and circles requested on the
+    // calling thread are recorded into it instead of being queued for
+    // drawing (NULL to stop).  Used to hand an update's annotation from a
+    // simulation thread to the display.  Returns the snapshot previously
+    // set, so a capture can be nested and then restored.
+    SimulationSnapshot* captureDeferredAnnotation (SimulationSnapshot* snapshot);
+
+    // draw the annotation recorded in a snapshot
+    void drawSnapshotAnnotation (const SimulationSnapshot& snapshot);
+
 
     // ------------------------------------------------------------------------
     // Draw a single OpenGL triangle given three Vec3 vertices.
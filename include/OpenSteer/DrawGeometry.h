@@ -0,0 +1,113 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// DrawGeometry
+//
+// Geometry the drawing routines reuse instead of recomputing per call:
+// tables of points on the unit circle, one per segment count, and the
+// meshes of the basic vehicle bodies in a unit radius vehicle's local
+// space, placed for each vehicle as it is drawn.  GL free, shared by the
+// OpenGL and OpenGL ES drawing code.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_DRAWGEOMETRY_H
+#define OPENSTEER_DRAWGEOMETRY_H
+
+
+#include "OpenSteer/Color.h"
+#include "OpenSteer/Vec3.h"
+
+
+namespace OpenSteer {
+
+
+    // ----------------------------------------------------------------------------
+    // points on the unit circle in the XZ plane
+
+
+    class UnitCircleTable
+    {
+    public:
+
+        // segments + 1 points (the last repeats the first) starting at
+        // (1, 0, 0) and turning the way Vec3::rotateAboutGlobalY turns for
+        // a positive angle, 2 pi / segments apart.  Each table is computed
+        // on first use and kept for the rest of the run, so the pointer
+        // stays valid.  Fewer than one segment counts as one.  Safe to
+        // call from any thread.
+        static const Vec3* points (const int segments);
+
+        // counts up to this are found without locking
+        enum {maxLockFreeSegments = 256};
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // the bodies drawn by drawBasic2dCircularVehicle and
+    // drawBasic3dSphericalVehicle, for a vehicle of radius 1 in its local
+    // space (x along side, y along up and z along forward)
+
+
+    class BasicVehicleMesh
+    {
+    public:
+
+        // flat triangle of the 2d vehicle (lifted above the ground along
+        // the global up axis by liftOf2dBody times the radius)
+        static const Vec3 flatBody [3];
+        static const float liftOf2dBody;
+
+        // the six triangles of the 3d vehicle and the offset added to the
+        // vehicle's color for each
+        enum {sphericalTriangleCount = 6};
+        static const Vec3 sphericalBody [sphericalTriangleCount * 3];
+        static const Color sphericalShades [sphericalTriangleCount];
+
+        // a point of a mesh placed for a vehicle of the given radius,
+        // position and basis
+        static Vec3 place (const Vec3& local,
+                           const float radius,
+                           const Vec3& position,
+                           const Vec3& side,
+                           const Vec3& up,
+                           const Vec3& forward)
+        {
+            return position + (radius * ((side    * local.x) +
+                                         (up      * local.y) +
+                                         (forward * local.z)));
+        }
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_DRAWGEOMETRY_H
@@ -0,0 +1,199 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// FlockEngine
+//
+// A data parallel engine for the Boids flocking update, built like a GPU
+// compute pipeline.  The flock's state stays in the engine's
+// structure-of-arrays buffers (a VehiclePopulation) between frames.  Each
+// step runs the same sequence of passes:
+//
+//   - bounds: reduce the positions to their bounding box
+//   - grid: bin every boid into a uniform grid whose cells are at least
+//     the largest flocking radius wide, by counting sort (cell counts, an
+//     exclusive prefix sum of them, then a scatter), and copy the position
+//     and forward of each boid into cell order
+//   - steer: one kernel invocation per boid, which only reads the sorted
+//     copies and only writes that boid's force: avoidance of sphere
+//     obstacles, as Boid::steerToFlock takes it from steerToAvoidObstacles,
+//     and otherwise separation, alignment and cohesion over the 27 cells
+//     around the boid, as steerForSeparation, steerForAlignment and
+//     steerForCohesion compute them.  Optionally, alignment and cohesion
+//     approximate far cells by per cell aggregates (see
+//     Parameters::approximation), so a wide flocking radius costs a visit
+//     per cell rather than per neighbor.
+//   - integrate: VehiclePopulation::applySteeringForces, then spherical
+//     wrap around
+//
+// The steer and integrate passes may be spread over a WorkerPool; the
+// grid pass is serial, so neighbor order (and so the result) does not
+// depend on the thread count.  Within float rounding of the order in
+// which neighbors are summed, a step matches the per-Boid update.  The
+// host side objects (SimpleVehicles) are only refreshed when asked, with
+// VehiclePopulation::store.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_FLOCKENGINE_H
+#define OPENSTEER_FLOCKENGINE_H
+
+
+#include <cstddef>
+#include <vector>
+#include "OpenSteer/VehiclePopulation.h"
+#include "OpenSteer/Obstacle.h"
+
+
+namespace OpenSteer {
+
+
+    class WorkerPool;
+
+
+    class FlockEngine
+    {
+    public:
+
+        // weights, radii and angles (cosines) of the flocking behaviors,
+        // initially those of Boid::steerToFlock
+        class Parameters
+        {
+        public:
+            Parameters (void);
+
+            float separationRadius, separationAngle, separationWeight;
+            float alignmentRadius, alignmentAngle, alignmentWeight;
+            float cohesionRadius, cohesionAngle, cohesionWeight;
+
+            // look ahead time of obstacle avoidance
+            float minTimeToCollision;
+
+            // boids farther than this from the origin are wrapped around
+            // to the other side of the sphere (zero means never)
+            float wrapAroundRadius;
+
+            // above zero: alignment and cohesion take a grid cell beyond
+            // the separation radius as one boid of the cell's count at the
+            // cell's centroid (with the sum of its forwards) when the cell
+            // is seen under less than this width over distance, as in
+            // Barnes-Hut.  The grid's cells are then separation radius
+            // wide.  Zero (the default) is exact.
+            float approximation;
+
+            // when approximating, compare every errorSampleStride'th boid's
+            // flocking steering with the exact one each step (zero: never)
+            size_t errorSampleStride;
+        };
+
+        FlockEngine (void);
+
+        // the flock's state: add, load and store its vehicles to move
+        // state to and from the engine
+        VehiclePopulation& population (void) {return _population;}
+        const VehiclePopulation& population (void) const {return _population;}
+
+        const Parameters& parameters (void) const {return _parameters;}
+        void setParameters (const Parameters& p) {_parameters = p;}
+
+        // replace the obstacles to avoid by copies of the given spheres
+        void setObstacles (const std::vector<const SphereObstacle*>& spheres);
+
+        // run all passes over the whole flock, with the steer and
+        // integrate passes on pool when one is given
+        void step (const float elapsedTime, WorkerPool* pool = NULL);
+
+        // the steering force of boid i in the latest step, and the number
+        // of boids (itself included) within the largest flocking radius
+        const Vec3& steering (size_t i) const {return _steering[i];}
+        size_t neighborCount (size_t i) const {return _neighborCount[i];}
+
+        // number of grid cells along each axis in the latest step
+        size_t gridCells (int axis) const {return _cells[axis];}
+
+        // the mean and largest length of the difference between the
+        // approximated and the exact flocking steering of the boids
+        // sampled in the latest step, and their number (zero when not
+        // approximating or sampling)
+        float approximationErrorMean (void) const {return _errorMean;}
+        float approximationErrorMax (void) const {return _errorMax;}
+        size_t approximationErrorSamples (void) const {return _errorSamples;}
+
+        // the kernel of the steer pass for boid i, on the grid of the
+        // latest grid pass
+        void steer (size_t i);
+
+    private:
+
+        void buildGrid (void);
+        size_t cellIndex (const Vec3& p, size_t& cx, size_t& cy, size_t& cz) const;
+        Vec3 steerToAvoidObstacles (size_t i) const;
+        Vec3 steerToFlock (size_t i, const float approximation,
+                           size_t& neighborCount) const;
+        void measureApproximationError (void);
+
+        VehiclePopulation _population;
+        Parameters _parameters;
+
+        // obstacle spheres
+        std::vector<Vec3> _obstacleCenter;
+        std::vector<float> _obstacleRadius;
+        std::vector<Obstacle::seenFromState> _obstacleSeenFrom;
+
+        // grid: origin, cell size and cell counts, each cell's first entry
+        // in the sorted arrays (plus one past the last), and the sorted
+        // copies of index, position and forward of each boid
+        Vec3 _origin;
+        float _cellSize;
+        size_t _cells[3];
+        std::vector<size_t> _cellStart;
+        std::vector<size_t> _cellFill;
+        std::vector<size_t> _cellOf;
+        std::vector<size_t> _sortedIndex;
+        std::vector<float> _sortedX, _sortedY, _sortedZ;
+        std::vector<float> _sortedFX, _sortedFY, _sortedFZ;
+
+        // aggregates of each cell: sums of position and forward
+        std::vector<float> _cellPX, _cellPY, _cellPZ;
+        std::vector<float> _cellFX, _cellFY, _cellFZ;
+
+        // per boid outputs of the steer pass
+        std::vector<Vec3> _steering;
+        std::vector<size_t> _neighborCount;
+        float _errorMean, _errorMax;
+        size_t _errorSamples;
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_FLOCKENGINE_H
@@ -0,0 +1,149 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// FlowField
+//
+// A grid over the XZ ("ground") plane which holds, for the center of each
+// cell, where a pathway maps it: the point on the path center line, the
+// path tangent there, the path distance and how far outside the pathway
+// it is.  It is built once for a path which does not change, after which
+// a point in a cell is mapped to the path by a lookup and a few multiplies
+// rather than a search over the path's segments, so that many vehicles
+// following one path share the work.
+//
+// Within a cell the mapping is continued from the center along the
+// tangent, which is exact for a cell wholly inside the tube about one
+// segment.  Cells near the pathway boundary, at bends, at the ends, and
+// where the path passes near itself are not: for points in those (and
+// points off the grid) lookup returns false and the caller maps the point
+// with the pathway itself.  SteerLibrary's steerToFollowPath and
+// steerToStayOnPath overloads taking a FlowField do that.
+//
+// The grid ignores Y: cell centers are mapped at the middle height of the
+// bounds given to build, so it suits paths and vehicles on the ground.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_FLOWFIELD_H
+#define OPENSTEER_FLOWFIELD_H
+
+
+#include <vector>
+#include "OpenSteer/Vec3.h"
+
+
+namespace OpenSteer {
+
+
+    class Pathway;
+    class PolylineSegmentedPathwaySingleRadius;
+
+
+    class FlowField
+    {
+    public:
+
+        // an empty field, whose every lookup returns false
+        FlowField (void);
+
+        // map the cells, of a given size, of a grid covering the XZ
+        // extent of a bounding box to a pathway
+        void build (const Pathway& path,
+                    const Vec3& minCorner,
+                    const Vec3& maxCorner,
+                    const float cellSize);
+
+        // as above, for a grid covering a polyline pathway and its radius
+        void build (const PolylineSegmentedPathwaySingleRadius& path,
+                    const float cellSize);
+
+        // forget the grid
+        void clear (void);
+
+        // map a point to the path, via the output arguments, as the
+        // pathway's mapPointToPathAndDistance would and return true, or
+        // return false if the grid does not map the point exactly enough
+        bool lookup (const Vec3& point,
+                     Vec3& onPath,
+                     Vec3& tangent,
+                     float& outside,
+                     float& pathDistance) const;
+
+        // as above, only for the path distance
+        bool lookupPathDistance (const Vec3& point, float& pathDistance) const;
+
+        // true if a point lies in a cell whose whole area is inside the
+        // pathway (so that lookup would give a negative outside)
+        bool interior (const Vec3& point) const;
+
+        // grid size
+        int cellCountX (void) const {return countX;}
+        int cellCountZ (void) const {return countZ;}
+        float cellSize (void) const {return size;}
+
+        // number of cells lookup maps exactly
+        int exactCellCount (void) const;
+
+    private:
+
+        struct Cell
+        {
+            Vec3 center;
+            Vec3 onPath;
+            Vec3 tangent;
+            float pathDistance;
+            float outside;
+            bool exact;    // the continued mapping holds within the cell
+            bool interior; // and the cell lies inside the pathway
+        };
+
+        // the cell containing a point, or NULL if that is off the grid
+        const Cell* cellAt (const Vec3& point) const;
+
+        // a cell's mapping continued from its center to a point
+        static void continueMapping (const Cell& cell,
+                                     const Vec3& point,
+                                     Vec3& onPath,
+                                     Vec3& tangent,
+                                     float& outside,
+                                     float& pathDistance);
+
+        std::vector<Cell> cells;
+        Vec3 origin;
+        float size;
+        int countX;
+        int countZ;
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_FLOWFIELD_H
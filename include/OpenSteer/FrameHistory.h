@@ -0,0 +1,139 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// FrameHistory
+//
+// Per frame costs for the on-screen profiler of OpenSteerDemo: a
+// FrameSample holds one frame's milliseconds per phase (the exclusive
+// PhaseTimer phases of the update, then drawing and annotation drawing)
+// and, when the PlugIn reports them, neighbors per agent.  FrameHistory
+// keeps the latest samples in a ring.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_FRAMEHISTORY_H
+#define OPENSTEER_FRAMEHISTORY_H
+
+
+#include <cstddef>
+#include <vector>
+
+
+namespace OpenSteer {
+
+
+    class FrameSample
+    {
+    public:
+
+        // the phases of a frame, which add up to its total
+        enum Series
+        {
+            // PlugIn update time not charged to one of the phases below
+            updateSeries,
+            neighborQuerySeries,
+            steeringSeries,
+            applySteeringForceSeries,
+            proximityUpdateSeries,
+
+            // redraw, not counting annotation
+            drawSeries,
+
+            // drawing the annotation recorded during the update
+            annotationSeries,
+
+            seriesCount
+        };
+
+        // all zero, without neighbor statistics
+        FrameSample (void);
+
+        // set the update series from the calling thread's PhaseTimer totals
+        void setFromPhaseTimer (void);
+
+        // sum over all series
+        float total (void) const;
+
+        // short name of a given series, for legends
+        static const char* name (const Series series);
+
+        float milliseconds [seriesCount];
+
+        // neighbors per agent during the update, if reported
+        bool hasNeighborStatistics;
+        int minNeighbors;
+        int maxNeighbors;
+        float averageNeighbors;
+    };
+
+
+    class FrameHistory
+    {
+    public:
+
+        FrameHistory (const size_t capacity = 300);
+
+        // number of samples held, at most capacity
+        size_t size (void) const {return count;}
+        size_t capacity (void) const {return samples.size();}
+
+        // append a sample, dropping the oldest one when full
+        void add (const FrameSample& sample);
+
+        // drop all samples
+        void clear (void) {next = 0; count = 0;}
+
+        // the i-th oldest sample held
+        const FrameSample& operator[] (const size_t i) const
+        {
+            return samples[(next + samples.size() - count + i) % samples.size()];
+        }
+
+        // largest total of the samples held (zero when empty)
+        float maxTotal (void) const;
+
+        // mean of each series and of the average neighbor count (over the
+        // samples which have them), min and max neighbors over all samples
+        FrameSample average (void) const;
+
+    private:
+
+        std::vector<FrameSample> samples;
+        size_t next;
+        size_t count;
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_FRAMEHISTORY_H
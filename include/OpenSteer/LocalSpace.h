@@ -48,10 +48,13 @@
 //     [          ]      [             ]
 //     [ T T T  1 ]      [ Tx Ty Tz  1 ]
 //
-// This file defines three classes:
-//   AbstractLocalSpace:  pure virtual interface
-//   LocalSpaceMixin:     mixin to layer LocalSpace functionality on any base
-//   LocalSpace:          a concrete object (can be instantiated)
+// This file defines five classes:
+//   AbstractLocalSpace:     pure virtual interface
+//   LocalSpaceMixin:        mixin to layer LocalSpace functionality on any base
+//   LocalSpace:             a concrete object (can be instantiated)
+//   CompactLocalSpaceMixin: alternative mixin storing the rotation part as a
+//                           unit quaternion rather than three basis vectors
+//   CompactLocalSpace:      a concrete object using it
 //
 // 10-04-04 bk:  put everything into the OpenSteer namespace
 // 06-05-02 cwr: created 
@@ -64,6 +67,7 @@
 #define OPENSTEER_LOCALSPACE_H
 
 
+#include <cmath>
 #include "OpenSteer/Vec3.h"
 
 
@@ -346,12 +350,374 @@ namespace OpenSteer {
     };
 
 
+    // ----------------------------------------------------------------------------
+    // CompactLocalSpaceMixin is an alternative to LocalSpaceMixin which holds
+    // the rotation part of the transformation as a unit quaternion, 28 bytes
+    // with the position rather than 48.  Side, up and forward are derived from
+    // it when asked for, and the localize and globalize functions rotate by it
+    // directly.
+    //
+    // As the basis is always orthonormal, setting one basis vector turns the
+    // whole local space, by the smallest rotation taking the current vector
+    // to the new one.  So setting all three vectors of an orthonormal basis
+    // in turn (in any order, as vehicles do) gives exactly that basis, and
+    // setting up before regenerating the basis from a new forward works as
+    // it does for LocalSpaceMixin.  SimpleVehicle is built on it when
+    // OPENSTEER_COMPACT_LOCAL_SPACE is defined.
+
+
+    template <class Super>
+    class CompactLocalSpaceMixin : public Super
+    {
+        // rotation taking the local axes to the global side, up and forward
+        // vectors, as a unit quaternion: vector part (x, y, z) and scalar
+        // part w.  Side is the local x axis for a left-handed space and its
+        // opposite for a right-handed one (see resetLocalSpace).
+
+    private:
+
+        float _qx, _qy, _qz, _qw;
+        Vec3 _position; // origin of local space
+
+    public:
+
+        // accessors (get and set) for side, up, forward and position
+        Vec3 side (void) const
+        {
+            const float h = handedness ();
+            return Vec3 (h * (1 - 2 * (_qy * _qy + _qz * _qz)),
+                         h * 2 * (_qx * _qy + _qw * _qz),
+                         h * 2 * (_qx * _qz - _qw * _qy));
+        }
+        Vec3 up (void) const
+        {
+            return Vec3 (2 * (_qx * _qy - _qw * _qz),
+                         1 - 2 * (_qx * _qx + _qz * _qz),
+                         2 * (_qy * _qz + _qw * _qx));
+        }
+        Vec3 forward (void) const
+        {
+            return Vec3 (2 * (_qx * _qz + _qw * _qy),
+                         2 * (_qy * _qz - _qw * _qx),
+                         1 - 2 * (_qx * _qx + _qy * _qy));
+        }
+        Vec3 position (void) const {return _position;};
+        Vec3 setSide (Vec3 s)
+        {
+            rotateOnto (side (), s.normalize (), up ());
+            return s;
+        }
+        Vec3 setUp (Vec3 u)
+        {
+            rotateOnto (up (), u.normalize (), forward ());
+            return u;
+        }
+        Vec3 setForward (Vec3 f)
+        {
+            rotateOnto (forward (), f.normalize (), up ());
+            return f;
+        }
+        Vec3 setPosition (Vec3 p) {return _position = p;};
+        Vec3 setSide     (float x, float y, float z){return setSide     (Vec3 (x,y,z));};
+        Vec3 setUp       (float x, float y, float z){return setUp       (Vec3 (x,y,z));};
+        Vec3 setForward  (float x, float y, float z){return setForward  (Vec3 (x,y,z));};
+        Vec3 setPosition (float x, float y, float z){return _position.set(x,y,z);};
+
+        // the rotation itself (x, y, z, w), to save and restore the local
+        // space exactly: rebuilding it from side, up and forward is only
+        // accurate to rounding
+        void rotation (float q[4]) const
+        {
+            q[0] = _qx;
+            q[1] = _qy;
+            q[2] = _qz;
+            q[3] = _qw;
+        }
+        void setRotation (const float q[4])
+        {
+            _qx = q[0];
+            _qy = q[1];
+            _qz = q[2];
+            _qw = q[3];
+        }
+
+
+        // ------------------------------------------------------------------------
+        // handedness, as for LocalSpaceMixin
+
+
+        bool rightHanded (void) const {return true;}
+
+
+        // ------------------------------------------------------------------------
+        // constructors
+
+
+        CompactLocalSpaceMixin (void)
+        {
+            resetLocalSpace ();
+        };
+
+        CompactLocalSpaceMixin (const Vec3& Side,
+                                const Vec3& Up,
+                                const Vec3& Forward,
+                                const Vec3& Position)
+            : _position( Position )
+        {
+            setBasis (Side, Up, Forward);
+        }
+
+        CompactLocalSpaceMixin (const Vec3& Up,
+                                const Vec3& Forward,
+                                const Vec3& Position)
+            : _position( Position )
+        {
+            setBasis (unitSide (Forward, Up), Up, Forward);
+        }
+
+
+        virtual ~CompactLocalSpaceMixin() { /* Nothing to do. */ }
+
+
+        // ------------------------------------------------------------------------
+        // reset transform to identity, as for LocalSpaceMixin
+
+
+        void resetLocalSpace (void)
+        {
+            _qx = _qy = _qz = 0;
+            _qw = 1;
+            _position.set (0, 0, 0);
+        };
+
+
+        // ------------------------------------------------------------------------
+        // transform a direction in global space to its equivalent in local
+        // space: rotate it by the inverse rotation
+
+
+        Vec3 localizeDirection (const Vec3& globalDirection) const
+        {
+            const Vec3 v = rotate (-_qx, -_qy, -_qz, globalDirection);
+            return Vec3 (handedness () * v.x, v.y, v.z);
+        };
+
+
+        // ------------------------------------------------------------------------
+        // transform a point in global space to its equivalent in local space
+
+
+        Vec3 localizePosition (const Vec3& globalPosition) const
+        {
+            return localizeDirection (globalPosition - _position);
+        };
+
+
+        // ------------------------------------------------------------------------
+        // transform a point in local space to its equivalent in global space
+
+
+        Vec3 globalizePosition (const Vec3& localPosition) const
+        {
+            return _position + globalizeDirection (localPosition);
+        };
+
+
+        // ------------------------------------------------------------------------
+        // transform a direction in local space to its equivalent in global space
+
+
+        Vec3 globalizeDirection (const Vec3& localDirection) const
+        {
+            return rotate (_qx, _qy, _qz,
+                           Vec3 (handedness () * localDirection.x,
+                                 localDirection.y,
+                                 localDirection.z));
+        };
+
+
+        // ------------------------------------------------------------------------
+        // the basis is always orthonormal, so this only restores the unit
+        // length of the quaternion
+
+
+        void setUnitSideFromForwardAndUp (void)
+        {
+            normalizeRotation ();
+        }
+
+
+        // ------------------------------------------------------------------------
+        // regenerate the orthonormal basis given a new forward (which is
+        // expected to have unit length), keeping up as near the old one as
+        // it can be, as for LocalSpaceMixin
+
+
+        void regenerateOrthonormalBasisUF (const Vec3& newUnitForward)
+        {
+            regenerateBasis (newUnitForward, up ());
+        }
+
+
+        // for when the new forward is NOT know to have unit length
+
+        void regenerateOrthonormalBasis (const Vec3& newForward)
+        {
+            regenerateOrthonormalBasisUF (newForward.normalize());
+        }
+
+
+        // for supplying both a new forward and and new up
+
+        void regenerateOrthonormalBasis (const Vec3& newForward,
+                                         const Vec3& newUp)
+        {
+            regenerateBasis (newForward.normalize(), newUp);
+        }
+
+
+        // ------------------------------------------------------------------------
+        // rotate, in the canonical direction, a vector pointing in the
+        // "forward" (+Z) direction to the "side" (+/-X) direction
+
+
+        Vec3 localRotateForwardToSide (const Vec3& v) const
+        {
+            return Vec3 (rightHanded () ? -v.z : +v.z,
+                         v.y,
+                         v.x);
+        }
+
+        Vec3 globalRotateForwardToSide (const Vec3& globalForward) const
+        {
+            const Vec3 localForward = localizeDirection (globalForward);
+            const Vec3 localSide = localRotateForwardToSide (localForward);
+            return globalizeDirection (localSide);
+        }
+
+    private:
+
+        // side is the local x axis times this
+        float handedness (void) const {return rightHanded () ? -1.0f : 1.0f;}
+
+        // unit side for a given forward and up, as LocalSpaceMixin derives it
+        Vec3 unitSide (const Vec3& f, const Vec3& u) const
+        {
+            return (rightHanded () ?
+                    crossProduct (f, u) :
+                    crossProduct (u, f)).normalize ();
+        }
+
+        // set side from the new unit forward and the given up, then up
+        // from side and forward
+        void regenerateBasis (const Vec3& newUnitForward, const Vec3& oldUp)
+        {
+            const Vec3 s = unitSide (newUnitForward, oldUp);
+            const Vec3 u = (rightHanded () ?
+                            crossProduct (s, newUnitForward) :
+                            crossProduct (newUnitForward, s));
+            setBasis (s, u, newUnitForward);
+        }
+
+        // rotate v by the rotation with vector part (x, y, z) and scalar
+        // part _qw (so the inverse rotation for the negated vector part)
+        Vec3 rotate (const float x, const float y, const float z,
+                     const Vec3& v) const
+        {
+            const Vec3 q (x, y, z);
+            const Vec3 t = crossProduct (q, v) * 2;
+            return v + (t * _qw) + crossProduct (q, t);
+        }
+
+        // set the rotation from an orthonormal basis, by way of the matrix
+        // whose columns are the global local x, y and z axes
+        void setBasis (const Vec3& s, const Vec3& u, const Vec3& f)
+        {
+            const Vec3 x = s * handedness ();
+            const float trace = x.x + u.y + f.z;
+            if (trace > 0)
+            {
+                const float r = 0.5f / std::sqrt (trace + 1);
+                _qw = 0.25f / r;
+                _qx = (u.z - f.y) * r;
+                _qy = (f.x - x.z) * r;
+                _qz = (x.y - u.x) * r;
+            }
+            else if ((x.x > u.y) && (x.x > f.z))
+            {
+                const float r = 0.5f / std::sqrt (1 + x.x - u.y - f.z);
+                _qw = (u.z - f.y) * r;
+                _qx = 0.25f / r;
+                _qy = (u.x + x.y) * r;
+                _qz = (f.x + x.z) * r;
+            }
+            else if (u.y > f.z)
+            {
+                const float r = 0.5f / std::sqrt (1 + u.y - x.x - f.z);
+                _qw = (f.x - x.z) * r;
+                _qx = (u.x + x.y) * r;
+                _qy = 0.25f / r;
+                _qz = (f.y + u.z) * r;
+            }
+            else
+            {
+                const float r = 0.5f / std::sqrt (1 + f.z - x.x - u.y);
+                _qw = (x.y - u.x) * r;
+                _qx = (f.x + x.z) * r;
+                _qy = (f.y + u.z) * r;
+                _qz = 0.25f / r;
+            }
+            normalizeRotation ();
+        }
+
+        // turn the local space by the smallest rotation taking one unit
+        // vector to another, or by half a turn around the given axis
+        // (perpendicular to the first vector) when they are opposite
+        void rotateOnto (const Vec3& from, const Vec3& to,
+                         const Vec3& halfTurnAxis)
+        {
+            float w = 1 + from.dot (to);
+            Vec3 v;
+            if (w > 1e-6f)
+            {
+                v = crossProduct (from, to);
+            }
+            else
+            {
+                w = 0;
+                v = halfTurnAxis;
+            }
+
+            // the turn follows the current rotation: (v, w) * (q, _qw)
+            const Vec3 q (_qx, _qy, _qz);
+            const Vec3 r = (q * w) + (v * _qw) + crossProduct (v, q);
+            _qw = (w * _qw) - v.dot (q);
+            _qx = r.x;
+            _qy = r.y;
+            _qz = r.z;
+            normalizeRotation ();
+        }
+
+        void normalizeRotation (void)
+        {
+            const float n = 1 / std::sqrt ((_qx * _qx) + (_qy * _qy) +
+                                           (_qz * _qz) + (_qw * _qw));
+            _qx *= n;
+            _qy *= n;
+            _qz *= n;
+            _qw *= n;
+        }
+    };
+
+
     // ----------------------------------------------------------------------------
     // Concrete LocalSpace class, and a global constant for the identity transform
 
 
     typedef LocalSpaceMixin<AbstractLocalSpace> LocalSpace;
 
+    typedef CompactLocalSpaceMixin<AbstractLocalSpace> CompactLocalSpace;
+
     const LocalSpace gGlobalSpace;
 
 } // namespace OpenSteer
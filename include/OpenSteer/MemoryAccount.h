@@ -0,0 +1,240 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// MemoryAccount
+//
+// Live heap bytes and allocations (blocks) per subsystem, so the memory
+// of a simulation can be read off while it runs instead of estimated from
+// sizeof.  Nothing is sampled: each subsystem charges its storage where it
+// allocates it, by one of
+//
+//   AccountedObject<c>       a base class whose objects, when created with
+//                            new, are charged with their full (most
+//                            derived) size
+//   AccountingAllocator<T,c> an allocator for the std containers a
+//                            subsystem owns (AccountedVector<T,c>::type
+//                            is a std::vector using it)
+//   MemoryAccount::Charge    for storage whose type is fixed by an
+//                            interface: its owner restates the bytes it
+//                            holds after changing them
+//   add / remove             for everything else, such as pool chunks
+//
+// Objects which are not heap allocated (members, statics, locals) are not
+// charged, only the storage they own is.  Counters are atomic, so any
+// thread may charge.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_MEMORYACCOUNT_H
+#define OPENSTEER_MEMORYACCOUNT_H
+
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+
+namespace OpenSteer {
+
+
+    class MemoryAccount
+    {
+    public:
+
+        // subsystems storage is charged to
+        enum Category
+        {
+            // vehicle objects (and pooled vehicle storage)
+            vehicleMemory,
+
+            // proximity database tokens
+            tokenMemory,
+
+            // per vehicle neighbor lists and their bookkeeping
+            neighborMemory,
+
+            // annotation trails
+            trailMemory,
+
+            // path and pathway geometry and their indices
+            pathMemory,
+
+            // obstacle objects and obstacle indices
+            obstacleMemory,
+
+            // deferred draw queues and batches
+            drawQueueMemory,
+
+            // terrain maps and resident heightfield tiles
+            terrainMemory,
+
+            // anything else using the facilities below
+            otherMemory,
+
+            categoryCount
+        };
+
+        // a block of bytes allocated or released
+        static void add (const Category category, const size_t bytes);
+        static void remove (const Category category, const size_t bytes);
+
+        // bytes (and blocks) currently allocated.  The blocks are heap
+        // allocations, so a pool's many objects count as its few chunks.
+        static size_t liveBytes (const Category category);
+        static size_t liveAllocations (const Category category);
+
+        // blocks allocated since the start of the program
+        static size_t totalAllocations (const Category category);
+
+        // over all categories
+        static size_t liveBytes (void);
+        static size_t liveAllocations (void);
+
+        // short lower case name of a given category, for reports
+        static const char* name (const Category category);
+
+        // storage restated by its owner: one block while it holds any bytes.
+        // A copy starts out empty (its owner charges what the copy holds).
+        class Charge
+        {
+        public:
+            Charge (const Category c) : category (c), bytes (0) {}
+            Charge (const Charge& other)
+                : category (other.category), bytes (0) {}
+            ~Charge () {set (0);}
+
+            Charge& operator= (const Charge&) {return *this;}
+
+            // the bytes now held
+            void set (const size_t newBytes);
+            size_t charged (void) const {return bytes;}
+
+        private:
+            const Category category;
+            size_t bytes;
+        };
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // base for classes whose heap allocated objects are charged to a
+    // category.  The sized delete receives the size of the most derived
+    // class as long as the destructor is virtual.
+
+
+    template <MemoryAccount::Category category>
+    class AccountedObject
+    {
+    public:
+
+        static void* operator new (size_t size)
+        {
+            void* const object = ::operator new (size);
+            MemoryAccount::add (category, size);
+            return object;
+        }
+
+        static void operator delete (void* object, size_t size)
+        {
+            MemoryAccount::remove (category, size);
+            ::operator delete (object);
+        }
+
+        // construction in place charges nothing
+        static void* operator new (size_t, void* place) {return place;}
+        static void operator delete (void*, void*) {}
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // std allocator charging its allocations to a category
+
+
+    template <class T, MemoryAccount::Category category>
+    class AccountingAllocator
+    {
+    public:
+
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        template <class U>
+        struct rebind {typedef AccountingAllocator<U, category> other;};
+
+        AccountingAllocator (void) {}
+        template <class U>
+        AccountingAllocator (const AccountingAllocator<U, category>&) {}
+
+        T* allocate (const size_t n)
+        {
+            T* const p = static_cast<T*> (::operator new (n * sizeof (T)));
+            MemoryAccount::add (category, n * sizeof (T));
+            return p;
+        }
+
+        void deallocate (T* p, const size_t n)
+        {
+            MemoryAccount::remove (category, n * sizeof (T));
+            ::operator delete (p);
+        }
+    };
+
+    template <class T, class U, MemoryAccount::Category category>
+    inline bool operator== (const AccountingAllocator<T, category>&,
+                            const AccountingAllocator<U, category>&)
+    {
+        return true;
+    }
+
+    template <class T, class U, MemoryAccount::Category category>
+    inline bool operator!= (const AccountingAllocator<T, category>&,
+                            const AccountingAllocator<U, category>&)
+    {
+        return false;
+    }
+
+
+    // a std::vector charged to a category
+    template <class T, MemoryAccount::Category category>
+    struct AccountedVector
+    {
+        typedef std::vector<T, AccountingAllocator<T, category> > type;
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_MEMORYACCOUNT_H
@@ -0,0 +1,245 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// NeighborList
+//
+// Verlet style neighbor lists: a vehicle keeps the results of a proximity
+// query made with its radius plus a skin, and answers the queries of the
+// following frames by filtering that list by the true radius, with current
+// positions.  The lists of one population share a NeighborListSkin, which
+// keeps track of how far its vehicles moved since the lists were made and
+// has them all rebuilt once any vehicle, together with any other, could
+// have crossed the skin: when twice the largest displacement since the
+// rebuild, plus the largest step of a frame (vehicles updated one after
+// another move during the frame), exceeds the skin.  So a list holds every
+// vehicle within the true radius, as long as no vehicle moves much further
+// in one frame than any did in the previous one.
+//
+// Filtered results come in the order of the list, not of a fresh query,
+// so sums over them may differ in the last bits from an uncached query.
+//
+// A cheaper and inexact alternative: with NeighborRefreshSlices each list
+// is only refreshed (with a query of the true radius) at every Nth of its
+// vehicle's queries, staggered so that about 1/N of a population queries
+// the database per update.  Between refreshes the list's neighbors are
+// taken with their current positions, so those which left the radius are
+// dropped, but those which entered it are missed until the next refresh.
+// Since the count is per vehicle, not per frame, this composes with level
+// of detail scheduling: vehicles updated less often refresh less often.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_NEIGHBORLIST_H
+#define OPENSTEER_NEIGHBORLIST_H
+
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "OpenSteer/AbstractVehicle.h"
+#include "OpenSteer/MemoryAccount.h"
+#include "OpenSteer/Proximity.h"
+
+
+namespace OpenSteer {
+
+
+    // ----------------------------------------------------------------------------
+    // the skin and rebuild bookkeeping shared by the lists of a population
+
+
+    class NeighborListSkin
+    {
+    public:
+
+        NeighborListSkin (const float skin);
+
+        float skin (void) const {return _skin;}
+        void setSkin (const float skin) {_skin = skin; invalidate ();}
+
+        // called once per frame before the queries, given a container of
+        // pointers to all the population's vehicles, in a stable order
+        // (changing its size rebuilds all lists)
+        template <class Group>
+        void beginFrame (const Group& group)
+        {
+            beginFrame (group.size());
+            for (size_t i = 0; i < group.size(); i++)
+                noteVehicle (i, group[i]->position());
+            endFrame ();
+        }
+
+        // as above, given the vehicles' positions
+        void beginFrame (const Vec3* positions, const size_t count);
+
+        // have all lists rebuilt at their next query: needed when
+        // vehicles are removed (which lists may still hold), and when
+        // vehicles move other than by steering (teleports are caught by
+        // the displacement check, but only from the next frame on)
+        void invalidate (void) {rebuildPending = true; generation++;}
+
+        // lists made in another generation are out of date
+        unsigned long currentGeneration (void) const {return generation;}
+
+        // generations so far, that is rebuilds of all lists
+        unsigned long rebuildCount (void) const {return generation;}
+
+    private:
+
+        void beginFrame (const size_t count);
+        void noteVehicle (const size_t i, const Vec3& position);
+        void endFrame (void);
+
+        float _skin;
+        unsigned long generation;
+        bool rebuildPending;
+
+        // positions as of the last rebuild and as of the previous frame,
+        // and this frame's largest displacement from each
+        AccountedVector<Vec3, MemoryAccount::neighborMemory>::type rebuildPositions;
+        AccountedVector<Vec3, MemoryAccount::neighborMemory>::type previousPositions;
+        float maxDisplacementSquared;
+        float maxStepSquared;
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // round robin refresh of the lists of a population: each list is
+    // refreshed at every slices()th query (at every query for one slice)
+
+
+    class NeighborRefreshSlices
+    {
+    public:
+
+        NeighborRefreshSlices (const size_t slices = 1)
+            : _slices (slices ? slices : 1), minimum (1), generation (1) {}
+
+        size_t slices (void) const {return std::max (_slices, minimum);}
+        void setSlices (const size_t slices)
+        {
+            _slices = slices ? slices : 1;
+            invalidate ();
+        }
+
+        // refresh no more often than at every slices()th query, whatever
+        // setSlices says (when degrading under load; one for no minimum)
+        void setMinimumSlices (const size_t slices)
+        {
+            const size_t previous = this->slices ();
+            minimum = slices ? slices : 1;
+            if (this->slices () != previous) invalidate ();
+        }
+        size_t minimumSlices (void) const {return minimum;}
+
+        // have all lists refreshed at their next query: needed when
+        // vehicles are removed, which lists may still hold
+        void invalidate (void) {generation++;}
+
+        // lists made in another generation are out of date
+        unsigned long currentGeneration (void) const {return generation;}
+
+    private:
+        size_t _slices;
+        size_t minimum;
+        unsigned long generation;
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // one vehicle's cached neighbors
+
+
+    class NeighborList
+    {
+    public:
+
+        NeighborList (void)
+            : generation (0), builtRadius (-1), age (0),
+              storage (MemoryAccount::neighborMemory) {}
+
+        // the neighbors within radius of center (the vehicle's position),
+        // with their distances squared and offsets, appended to results:
+        // from the list, rebuilt first with a query of token if the skin
+        // says so or the radius grew
+        void findNeighbors (const NeighborListSkin& skin,
+                            AbstractTokenForProximityDatabase<AbstractVehicle*>& token,
+                            const Vec3& center,
+                            const float radius,
+                            AVNeighborGroup& results);
+
+        // the neighbors within radius of center, from the list refreshed
+        // with a query of token at every slices.slices()th call, in turns
+        // given by phase (such as the vehicle's index in its population),
+        // either with their distances squared and offsets, or not
+        void findNeighbors (const NeighborRefreshSlices& slices,
+                            const size_t phase,
+                            AbstractTokenForProximityDatabase<AbstractVehicle*>& token,
+                            const Vec3& center,
+                            const float radius,
+                            AVNeighborGroup& results);
+        void findNeighbors (const NeighborRefreshSlices& slices,
+                            const size_t phase,
+                            AbstractTokenForProximityDatabase<AbstractVehicle*>& token,
+                            const Vec3& center,
+                            const float radius,
+                            AVGroup& results);
+
+        // forget the list
+        void clear (void) {cached.clear (); builtRadius = -1;}
+
+        // number of vehicles in the list
+        size_t size (void) const {return cached.size ();}
+
+    private:
+        void refresh (const NeighborRefreshSlices& slices,
+                      const size_t phase,
+                      AbstractTokenForProximityDatabase<AbstractVehicle*>& token,
+                      const Vec3& center,
+                      const float radius);
+
+        AVNeighborGroup cached;
+        unsigned long generation;
+        float builtRadius;
+
+        // queries answered from the list since its last refresh
+        size_t age;
+
+        // the list's storage, restated at each refresh
+        MemoryAccount::Charge storage;
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_NEIGHBORLIST_H
@@ -0,0 +1,76 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// NeighborRecord
+//
+// One result of a proximity query: the object found, its distance squared
+// from the query center and the offset from the center to the object's
+// position.  Proximity databases compute both for their distance test, so
+// steering behaviors given records (see SteerLibraryMixin) need not
+// recompute them per neighbor.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_NEIGHBORRECORD_H
+#define OPENSTEER_NEIGHBORRECORD_H
+
+
+#include "OpenSteer/Vec3.h"
+
+
+namespace OpenSteer {
+
+
+    template <class ContentType>
+    class NeighborRecord
+    {
+    public:
+
+        NeighborRecord (void) : object (), distanceSquared (0) {}
+        NeighborRecord (ContentType o, const float d2, const Vec3& off)
+            : object (o), distanceSquared (d2), offset (off) {}
+
+        // the object found
+        ContentType object;
+
+        // offset.lengthSquared ()
+        float distanceSquared;
+
+        // (position of object) - (query center)
+        Vec3 offset;
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_NEIGHBORRECORD_H
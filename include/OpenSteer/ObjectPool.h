@@ -0,0 +1,203 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// ObjectPool
+//
+// Chunked storage for many objects of one type, such as the tokens of a
+// proximity database.  Objects never move once allocated, so pointers to
+// them stay valid, and allocation and release are O(1) pops and pushes of
+// a free list.  Storage is returned to the system only when the pool is
+// destroyed, by which time every object must have been released.
+//
+// A class derived from PooledObject<T> can only be created in a pool,
+// with "new (pool) T (...)", and its objects are deleted as usual: delete
+// hands their storage back to the pool they came from.  Pools are not
+// thread-safe: allocate from and delete into a pool on one thread at a
+// time.
+//
+// A pool's chunks are charged to the MemoryAccount category it is given.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_OBJECTPOOL_H
+#define OPENSTEER_OBJECTPOOL_H
+
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "OpenSteer/MemoryAccount.h"
+#include "OpenSteer/UnusedParameter.h"
+
+
+namespace OpenSteer {
+
+
+    template <class T>
+    class ObjectPool
+    {
+    public:
+
+        // storage grows by chunks of (at least) chunkSize objects
+        ObjectPool (const size_t chunkSize = 64,
+                    const MemoryAccount::Category category =
+                        MemoryAccount::otherMemory)
+            : chunkSize (chunkSize), category (category), freeSlots (NULL),
+              liveCount (0), slotCount (0) {}
+
+        ~ObjectPool ()
+        {
+            for (size_t i = 0; i < chunks.size(); i++)
+            {
+                MemoryAccount::remove (category,
+                                       chunkCounts[i] * sizeof (Slot));
+                delete [] chunks[i];
+            }
+        }
+
+        // storage for one object, for the caller to construct it in
+        void* allocate (void)
+        {
+            if (freeSlots == NULL) addChunk (chunkSize);
+            Slot* const slot = freeSlots;
+            freeSlots = slot->nextFree;
+            slot->owner = this;
+            liveCount++;
+            return &slot->storage;
+        }
+
+        // return storage (its object already destroyed) to the pool which
+        // allocated it
+        static void release (void* object)
+        {
+            Slot* const slot = slotOf (object);
+            ObjectPool& pool = *slot->owner;
+            slot->nextFree = pool.freeSlots;
+            pool.freeSlots = slot;
+            pool.liveCount--;
+        }
+
+        // make room for count more objects in one chunk, ahead of a bulk
+        // allocation
+        void reserve (const size_t count)
+        {
+            const size_t available = slotCount - liveCount;
+            if (available < count) addChunk (count - available);
+        }
+
+        // number of objects allocated and not yet released
+        size_t size (void) const {return liveCount;}
+
+        // number of objects the pool holds storage for
+        size_t capacity (void) const {return slotCount;}
+
+    private:
+
+        // an object's storage, preceded by the pool it belongs to
+        struct Slot
+        {
+            ObjectPool* owner;
+            Slot* nextFree;
+            typename std::aligned_storage<sizeof (T),
+                                          std::alignment_of<T>::value>::type
+                storage;
+        };
+
+        static Slot* slotOf (void* object)
+        {
+            return reinterpret_cast<Slot*> (static_cast<char*> (object) -
+                                            offsetof (Slot, storage));
+        }
+
+        void addChunk (const size_t count)
+        {
+            Slot* const chunk = new Slot [count];
+            chunks.push_back (chunk);
+            chunkCounts.push_back (count);
+            MemoryAccount::add (category, count * sizeof (Slot));
+            for (size_t i = count; i > 0; i--)
+            {
+                chunk[i - 1].nextFree = freeSlots;
+                freeSlots = &chunk[i - 1];
+            }
+            slotCount += count;
+        }
+
+        const size_t chunkSize;
+        const MemoryAccount::Category category;
+        std::vector<Slot*> chunks;
+        std::vector<size_t> chunkCounts;
+        Slot* freeSlots;
+        size_t liveCount;
+        size_t slotCount;
+
+        // not copyable
+        ObjectPool (const ObjectPool&);
+        ObjectPool& operator= (const ObjectPool&);
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // base for classes whose objects live in an ObjectPool<T>
+
+
+    template <class T>
+    class PooledObject
+    {
+    public:
+
+        static void* operator new (size_t size, ObjectPool<T>& pool)
+        {
+            assert (size == sizeof (T));
+            OPENSTEER_UNUSED_PARAMETER (size);
+            return pool.allocate ();
+        }
+
+        // used if a constructor throws
+        static void operator delete (void* object, ObjectPool<T>&)
+        {
+            ObjectPool<T>::release (object);
+        }
+
+        static void operator delete (void* object)
+        {
+            ObjectPool<T>::release (object);
+        }
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_OBJECTPOOL_H
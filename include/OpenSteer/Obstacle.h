@@ -44,6 +44,7 @@
 #include "OpenSteer/Vec3.h"
 #include "OpenSteer/LocalSpace.h"
 #include "OpenSteer/AbstractVehicle.h"
+#include "OpenSteer/MemoryAccount.h"
 
 
 namespace OpenSteer {
@@ -57,9 +58,10 @@ namespace OpenSteer {
     // AbstractObstacle: a pure virtual base class for an abstract shape in
     // space, to be used with obstacle avoidance.  (Oops, its not "pure" since
     // I added a concrete method to PathIntersection 11-04-04 -cwr).
+    // Obstacles created with new are charged to obstacle memory.
 
 
-    class AbstractObstacle
+    class AbstractObstacle : public AccountedObject<MemoryAccount::obstacleMemory>
     {
     public:
 
@@ -113,6 +115,16 @@ namespace OpenSteer {
         enum seenFromState {outside, inside, both};
         virtual seenFromState seenFrom (void) const = 0;
         virtual void setSeenFrom (seenFromState s) = 0;
+
+        // a sphere containing every point where findIntersectionWithVehiclePath
+        // can report an intersection, once grown by twice the vehicle's
+        // radius (used by ObstacleIndex to prune obstacles).  Returns false
+        // for obstacles without one, such as unbounded planes.
+        virtual bool getBoundingSphere (Vec3& /*center*/,
+                                        float& /*radius*/) const
+        {
+            return false;
+        }
     };
 
 
@@ -182,6 +194,10 @@ namespace OpenSteer {
         void findIntersectionWithVehiclePath (const AbstractVehicle& vehicle,
                                               PathIntersection& pi)
             const;
+
+        // the sphere itself, except when seen from inside: then a vehicle
+        // anywhere outside it intersects
+        bool getBoundingSphere (Vec3& c, float& r) const;
     };
 
 
@@ -216,6 +232,9 @@ namespace OpenSteer {
         void findIntersectionWithVehiclePath (const AbstractVehicle& vehicle,
                                               PathIntersection& pi)
             const;
+
+        // sphere through the box's corners
+        bool getBoundingSphere (Vec3& c, float& r) const;
     };
 
 
@@ -296,6 +315,94 @@ namespace OpenSteer {
 
         // determines if a given point on XY plane is inside obstacle shape
         bool xyPointInsideShape (const Vec3& point, float radius) const;
+
+        // sphere through the rectangle's corners
+        bool getBoundingSphere (Vec3& c, float& r) const;
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // ObstacleIndex: a bounding volume hierarchy over the obstacles of an
+    // ObstacleGroup, for groups too large to test every obstacle against
+    // every vehicle.  Obstacles with a bounding sphere are kept in a tree of
+    // axis aligned boxes and only those whose box meets the vehicle's path
+    // (out to the distance of interest, grown by the vehicle's radius) are
+    // tested; others are always tested.  For intersections nearer than that
+    // distance the result is the same as Obstacle's ObstacleGroup methods.
+    //
+    // The tree is built once for a given group.  When obstacles move, refit
+    // updates the boxes (of one obstacle, or all) without rebuilding, which
+    // stays correct but may prune less well after large moves.  Queries only
+    // read the index and may run on several threads at once.
+
+
+    class ObstacleIndex
+    {
+    public:
+
+        ObstacleIndex (void) {}
+        ObstacleIndex (const ObstacleGroup& obstacles) {build (obstacles);}
+
+        // build the tree for a group of obstacles, replacing any earlier
+        // contents.  Obstacles are identified by their index in the group.
+        void build (const ObstacleGroup& obstacles);
+
+        // update the bounds of the obstacle of the given group index, or of
+        // all obstacles, after they moved
+        void refit (const size_t obstacleIndex);
+        void refit (void);
+
+        // number of obstacles in the index
+        size_t size (void) const {return obstacles.size();}
+
+        // as Obstacle::steerToAvoidObstacles for the indexed group
+        Vec3 steerToAvoidObstacles (const AbstractVehicle& vehicle,
+                                    const float minTimeToCollision) const;
+
+        // as Obstacle::firstPathIntersectionWithObstacleGroup, but only
+        // exact for intersections nearer than maxDistance (further ones
+        // may be missed)
+        void firstPathIntersection (const AbstractVehicle& vehicle,
+                                    const float maxDistance,
+                                    AbstractObstacle::PathIntersection& nearest,
+                                    AbstractObstacle::PathIntersection& next)
+            const;
+
+    private:
+
+        // a tree node: an interior node has children left and right, a leaf
+        // (left < 0) covers count entries of leafObstacles from first
+        class Node
+        {
+        public:
+            Vec3 lo, hi;
+            int left, right;
+            int parent;
+            int first, count;
+        };
+
+        int buildNode (const int parent, const int first, const int count,
+                       const std::vector<Vec3>& centers);
+        void boundsOfObstacle (const size_t i, Vec3& lo, Vec3& hi) const;
+        void refitLeaf (const int node);
+
+        // storage charged to obstacle memory
+        typedef AccountedVector<int, MemoryAccount::obstacleMemory>::type
+            IndexVector;
+
+        // the indexed group
+        AccountedVector<AbstractObstacle*,
+                        MemoryAccount::obstacleMemory>::type obstacles;
+
+        // the tree, root first, and obstacle indices in leaf order
+        AccountedVector<Node, MemoryAccount::obstacleMemory>::type nodes;
+        IndexVector leafObstacles;
+
+        // leaf of each bounded obstacle (by group index), or -1
+        IndexVector leafOfObstacle;
+
+        // obstacles without bounds, always tested
+        IndexVector unbounded;
     };
 
 
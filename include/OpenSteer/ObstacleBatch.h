@@ -0,0 +1,123 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// ObstacleBatch
+//
+// Obstacles of an ObstacleGroup sorted into packets by concrete type
+// (SphereObstacle, BoxObstacle and RectangleObstacle) with their bounding
+// spheres stored as structure-of-arrays.  A path query first screens a
+// whole packet with the Vec3Batch operations, which keeps only obstacles
+// whose bounding sphere the vehicle's path line passes through ahead of it,
+// then tests those with a direct (not virtual) call to their type's
+// intersection routine.  Obstacles of other types, and spheres seen from
+// inside (which any vehicle outside them intersects), are always tested.
+// Results equal those of Obstacle's ObstacleGroup methods.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_OBSTACLEBATCH_H
+#define OPENSTEER_OBSTACLEBATCH_H
+
+
+#include <vector>
+#include "OpenSteer/Obstacle.h"
+#include "OpenSteer/Vec3Batch.h"
+
+
+namespace OpenSteer {
+
+
+    class ObstacleBatch
+    {
+    public:
+
+        ObstacleBatch (void) : storage (MemoryAccount::obstacleMemory) {}
+        ObstacleBatch (const ObstacleGroup& obstacles)
+            : storage (MemoryAccount::obstacleMemory) {build (obstacles);}
+
+        // sort a group of obstacles into packets, replacing any earlier
+        // contents
+        void build (const ObstacleGroup& obstacles);
+
+        // re-read the bounding spheres after obstacles moved
+        void refit (void);
+
+        // number of obstacles in the batch
+        size_t size (void) const {return group.size();}
+
+        // as Obstacle::steerToAvoidObstacles for the batched group
+        Vec3 steerToAvoidObstacles (const AbstractVehicle& vehicle,
+                                    const float minTimeToCollision) const;
+
+        // as Obstacle::firstPathIntersectionWithObstacleGroup.  Given a
+        // maxDistance, only exact for intersections nearer than that
+        // (further ones may be missed) but screens more obstacles out.
+        void firstPathIntersection (const AbstractVehicle& vehicle,
+                                    AbstractObstacle::PathIntersection& nearest,
+                                    AbstractObstacle::PathIntersection& next,
+                                    const float maxDistance = FLT_MAX) const;
+
+    private:
+
+        // obstacles of one type with their bounding spheres and group
+        // indices, in group order
+        class Packet
+        {
+        public:
+            void clear (void);
+            void add (const AbstractObstacle* o, const int index);
+            void refit (void);
+
+            // bytes of storage held
+            size_t bytes (void) const;
+
+            std::vector<const AbstractObstacle*> obstacles;
+            std::vector<int> indices;
+            Vec3Batch centers;
+            std::vector<float> radii;
+        };
+
+        ObstacleGroup group;
+        Packet spheres, boxes, rectangles;
+
+        // group indices of obstacles which are always tested
+        std::vector<int> others;
+
+        // the storage above, restated by build
+        MemoryAccount::Charge storage;
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_OBSTACLEBATCH_H
@@ -58,6 +58,13 @@ namespace OpenSteer {
 
     class Color;
     class Vec3;
+    class SimulationSnapshot;
+    class FrameHistory;
+    class TelemetryWriter;
+    class SteeringRecorder;
+    class SteeringReplayer;
+    class AnnotationStreamWriter;
+    class AnnotationStreamReader;
     
 
     class OpenSteerDemo
@@ -68,6 +75,10 @@ namespace OpenSteer {
         // clock keeps track of both "real time" and "simulation time"
         static Clock clock;
 
+        // paces the display on its own while the simulation runs on its own
+        // thread (see setDecoupledSimulation), then clock paces only that
+        static Clock displayClock;
+
         // camera automatically tracks selected vehicle
         static Camera camera;
 
@@ -116,6 +127,10 @@ namespace OpenSteer {
         static void updateSelectedPlugIn (const float currentTime,
                                           const float elapsedTime);
 
+        // do the updates clock says are due this frame: one by its elapsed
+        // simulation time, or its fixed time steps (annotating the last)
+        static void stepSelectedPlugIn (void);
+
         // redraw graphics for the currently selected plug-in
         static void redrawSelectedPlugIn (const float currentTime,
                                           const float elapsedTime);
@@ -128,6 +143,105 @@ namespace OpenSteer {
 
         static const AVGroup& allVehiclesOfSelectedPlugIn(void);
 
+        // -------------------------------------------- decoupled simulation
+
+        // Run the selected PlugIn's simulation on a thread of its own, at
+        // the rate set by clock, while each redraw shows the latest step's
+        // SimulationSnapshot.  Must not be called holding a SimulationLock.
+        static void setDecoupledSimulation (bool on);
+        static bool decoupledSimulationIsOn (void);
+
+        // the snapshot drawn by the latest redraw (display thread only)
+        static const SimulationSnapshot& displayedSnapshot (void);
+
+        // the camera's position, safe to call from PlugIn::update (with a
+        // decoupled simulation, as of the latest redraw)
+        static Vec3 cameraPosition (void);
+
+        // draw a snapshot of the selected PlugIn: camera, the PlugIn's
+        // scenery, then the snapshot's vehicles and annotation
+        static void redrawSnapshotOfSelectedPlugIn (const SimulationSnapshot& snapshot,
+                                                    const float currentTime,
+                                                    const float elapsedTime);
+
+        // Held by the simulation thread for each step.  Code on other threads
+        // which reads or changes simulation state (input handlers, PlugIn
+        // switching) holds one for its duration.  Costs nothing while the
+        // simulation is not decoupled.
+        class SimulationLock
+        {
+        public:
+            SimulationLock (void);
+            ~SimulationLock ();
+        private:
+            bool locked;
+            SimulationLock (const SimulationLock&);
+            SimulationLock& operator= (const SimulationLock&);
+        };
+
+        // ----------------------------------------------------- profiler display
+
+        // Graph the phase times of recent frames, and the selected PlugIn's
+        // neighbors per agent, over the scene.  PhaseTimer is on while it
+        // is shown.  Call holding a SimulationLock.
+        static void setProfilerDisplay (bool on);
+        static bool profilerDisplayIsOn (void);
+
+        // frames recorded since the profiler display was turned on
+        static const FrameHistory& frameHistory (void);
+
+        // ------------------------------------------------------------ telemetry
+
+        // Publish the state of every vehicle of the selected PlugIn to a
+        // TelemetryWriter at the end of each updateSelectedPlugIn (NULL, the
+        // default, for none).  The writer is not owned.
+        static void setTelemetryWriter (TelemetryWriter* writer);
+
+        // ------------------------------------------------ steering recording
+
+        // Record the steering forces of the selected PlugIn's vehicles at
+        // the end of each updateSelectedPlugIn (NULL, the default, for no
+        // recording), or replay them instead of calling PlugIn::update for
+        // as long as the replayer has frames for the vehicles (see
+        // SteeringLog.h).  Neither is owned.
+        static void setSteeringRecorder (SteeringRecorder* recorder);
+        static void setSteeringReplayer (SteeringReplayer* replayer);
+
+        // ------------------------------------------------- annotation stream
+
+        // Write each updateSelectedPlugIn's annotation and vehicles to an
+        // AnnotationStreamWriter (NULL, the default, for none).  While it
+        // is set the annotation requested during updates goes to the
+        // stream, and to the display only when the simulation is
+        // decoupled.  The writer is not owned.
+        static void setAnnotationStreamWriter (AnnotationStreamWriter* writer);
+
+        // Instead of simulating, draw the frames of an annotation stream at
+        // the pace they were recorded, looping at its end.  Selects and
+        // opens the PlugIn named by the stream for its scenery; returns
+        // false if there is none.  NULL stops playback.  Not owned.
+        static bool setAnnotationPlayback (AnnotationStreamReader* reader);
+
+        // ---------------------------------------------- frame time budget
+
+        // While clock has a frame budget, each frame over it degrades the
+        // simulation by a level, in this order, and a run of frames well
+        // within it restores a level.  OpenSteerDemo skips the annotation;
+        // PlugIns apply the later levels, taking the settings below.
+        enum DegradationLevel
+        {
+            fullQuality,
+            skipAnnotation,
+            widenDetailBands,
+            slowNeighborRefresh
+        };
+        static int degradationLevel (void);
+
+        // UpdateScheduler::setBandScale and
+        // NeighborRefreshSlices::setMinimumSlices values for the level
+        static float degradedBandScale (void);
+        static size_t degradedNeighborSlices (void);
+
         // ---------------------------------------------------- OpenSteerDemo phase
 
         static bool phaseIsDraw     (void) {return phase == drawPhase;}
@@ -250,17 +364,23 @@ namespace OpenSteer {
         // ---------------------------------------------------------------- private
 
     private:
-        static int phase;
-        static int phaseStack[];
-        static int phaseStackIndex;
-        static float phaseTimers[];
-        static float phaseTimerBase;
+        // per thread, since a decoupled simulation updates on one thread
+        // while the display draws on another
+        static thread_local int phase;
+        static thread_local int phaseStack[];
+        static thread_local int phaseStackIndex;
+        static thread_local float phaseTimers[];
+        static thread_local float phaseTimerBase;
         static const int phaseStackSize;
         static void pushPhase (const int newPhase);
         static void popPhase (void);
         static void initPhaseTimers (void);
         static void updatePhaseTimers (void);
 
+        // body of the decoupled simulation thread, and its one step
+        static void runSimulationThread (void);
+        static void updateSelectedPlugInIntoSnapshot (SimulationSnapshot& snapshot);
+
         // XXX apparently MS VC6 cannot handle initialized static const members,
         // XXX so they have to be initialized not-inline.
         // static const int drawPhase = 2;
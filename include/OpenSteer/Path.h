@@ -38,6 +38,7 @@ namespace OpenSteer {
 
     // Forward declaration.
     class Vec3;
+    class PathCursor;
     
     
     /**
@@ -82,6 +83,21 @@ namespace OpenSteer {
          */
 		virtual float mapPointToPathDistance (const Vec3& point) const = 0;
         
+        /**
+         * As the queries above but starting the search at the segment
+         * @a cursor remembers and updating it. Results are the same as
+         * without a cursor, though distances along the path may differ by
+         * rounding. The default ignores @a cursor.
+         */
+        virtual Vec3 mapPointToPath (const Vec3& point,
+                                     Vec3& tangent,
+                                     float& outside,
+                                     PathCursor& cursor) const;
+        virtual Vec3 mapPathDistanceToPoint (float pathDistance,
+                                             PathCursor& cursor) const;
+        virtual float mapPointToPathDistance (const Vec3& point,
+                                              PathCursor& cursor) const;
+        
         /**
          * Returns @c true f the path is closed, otherwise @c false.
          */
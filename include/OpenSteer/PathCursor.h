@@ -0,0 +1,96 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ * @file
+ *
+ * Per-caller hint for repeated queries against the same path.
+ */
+#ifndef OPENSTEER_PATHCURSOR_H
+#define OPENSTEER_PATHCURSOR_H
+
+// Include std::numeric_limits
+#include <limits>
+
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+
+namespace OpenSteer {
+    
+    /**
+     * Remembers the segment a path query found last so the next query of 
+     * the same caller can start its search there.
+     *
+     * A vehicle moving along a path keeps one cursor per path and passes it
+     * to the cursor taking overloads of @c Path and @c Pathway. The cursor
+     * only speeds up queries, a stale or foreign cursor never changes their
+     * results. Paths that can't use it ignore it.
+     */
+    class PathCursor {
+    public:
+        typedef size_t size_type;
+        
+        PathCursor() : segmentIndex_( noSegment() ) {}
+        
+        /**
+         * Forgets the hint, the next query searches from scratch.
+         */
+        void reset() {
+            segmentIndex_ = noSegment();
+        }
+        
+        /**
+         * Returns @c true if the cursor holds a hint.
+         */
+        bool valid() const {
+            return segmentIndex_ != noSegment();
+        }
+        
+        /**
+         * Returns the segment found last, only meaningful if @c valid.
+         */
+        size_type segmentIndex() const {
+            return segmentIndex_;
+        }
+        
+        void setSegmentIndex( size_type segmentIndex ) {
+            segmentIndex_ = segmentIndex;
+        }
+        
+    private:
+        static size_type noSegment() {
+            return std::numeric_limits< size_type >::max();
+        }
+        
+        size_type segmentIndex_;
+    }; // class PathCursor
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_PATHCURSOR_H
@@ -0,0 +1,206 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+//
+// PathDataset
+//
+// A binary file of many polyline paths and pathways, e.g. a road network,
+// that PathDatasetReader maps into memory and hands out as read-only
+// views: PolylineSegmentedPath, PolylineSegmentedPathwaySingleRadius and
+// PolylineSegmentedPathwaySegmentRadii objects that query the mapped
+// arrays in place (see their setView) instead of copying the points and
+// recomputing segment tangents, lengths, distances and the segment index.
+// Opening a dataset costs a check of its directory, whatever its size.
+//
+// The file is a checkpoint (see Checkpoint.h) with one section per kind of
+// data, concatenated over all paths: points (cyclic paths repeat their
+// first point at the end), segment tangents, segment lengths, segment
+// start distances followed by the path length, segment radii and the
+// nodes and segment order of each path's SegmentedPathIndex.  A directory
+// section holds one PathDatasetEntry per path locating its ranges.  Like
+// checkpoints, datasets are meant to be read by the build that wrote them.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_PATHDATASET_H
+#define OPENSTEER_PATHDATASET_H
+
+
+#include <vector>
+#include "OpenSteer/Checkpoint.h"
+#include "OpenSteer/PolylineSegmentedPath.h"
+#include "OpenSteer/PolylineSegmentedPathwaySegmentRadii.h"
+#include "OpenSteer/PolylineSegmentedPathwaySingleRadius.h"
+#include "OpenSteer/SegmentedPathIndex.h"
+#include "OpenSteer/SegmentedPathway.h"
+
+
+namespace OpenSteer {
+
+
+    // where the data of one path lies in the sections of a dataset
+    struct PathDatasetEntry
+    {
+        // first of pointCount points and start distances
+        uint64_t firstPoint;
+        // first of pointCount - 1 tangents, lengths, radii (and order
+        // entries if the path has a segment index)
+        uint64_t firstSegment;
+        // first of nodeCount index nodes
+        uint64_t firstNode;
+
+        uint32_t pointCount;
+        uint32_t nodeCount;     // 0 without segment index
+        uint32_t cyclic;
+        uint32_t singleRadius;  // all segments have the same radius
+        float indexSlack;
+        uint32_t unused;
+    };
+
+
+    // ------------------------------------------------------------------------
+
+
+    class PathDatasetWriter
+    {
+    public:
+
+        PathDatasetWriter (void);
+
+        // add a path (with radius 0) or a pathway, with its segment index
+        // if segmentIndex is true, returning its index in the dataset.
+        // The path must be valid (see SegmentedPath::isValid).
+        size_t addPath (const SegmentedPath& path, const bool segmentIndex);
+        size_t addPathway (const SegmentedPathway& pathway,
+                           const bool segmentIndex);
+
+        size_t pathCount (void) const {return entries.size ();}
+
+        // the dataset so far, and writing it to a file (returns false if
+        // the file cannot be written)
+        std::vector<char> bytes (void) const;
+        bool writeFile (const char* fileName) const;
+
+    private:
+
+        size_t add (const std::vector<Vec3>& pathPoints,
+                    const bool cyclic,
+                    const std::vector<float>& pathRadii,
+                    const bool segmentIndex);
+
+        CheckpointWriter checkpoint (void) const;
+
+        std::vector<PathDatasetEntry> entries;
+        std::vector<Vec3> points;
+        std::vector<Vec3> tangents;
+        std::vector<float> lengths;
+        std::vector<float> startDistances;
+        std::vector<float> radii;
+        std::vector<SegmentedPathIndex::Node> nodes;
+        std::vector<unsigned int> order;
+    };
+
+
+    // ------------------------------------------------------------------------
+
+
+    class PathDatasetReader
+    {
+    public:
+
+        PathDatasetReader (void);
+
+        // map a dataset file, or use a dataset in memory (which must stay
+        // valid until close).  Either returns false, leaving the reader
+        // closed, if the data is not a dataset of this version or its
+        // directory does not fit its sections.
+        bool open (const char* fileName);
+        bool openMemory (const void* data, const size_t size);
+        void close (void);
+
+        bool isOpen (void) const {return reader.isOpen ();}
+
+        size_t pathCount (void) const {return entryCount;}
+
+        // properties of path i
+        size_t pointCount (const size_t i) const;
+        bool isCyclic (const size_t i) const;
+        bool hasSingleRadius (const size_t i) const;
+        bool hasSegmentIndex (const size_t i) const;
+
+        // make a path or pathway a read-only view of path i, valid until
+        // the reader is closed.  Viewing a pathway with segment radii as a
+        // PolylineSegmentedPathwaySingleRadius returns false, changing
+        // nothing.
+        void view (const size_t i, PolylineSegmentedPath& path) const;
+        bool view (const size_t i,
+                   PolylineSegmentedPathwaySingleRadius& pathway) const;
+        void view (const size_t i,
+                   PolylineSegmentedPathwaySegmentRadii& pathway) const;
+
+    private:
+
+        // locate the sections, false unless every entry lies inside them
+        bool validDirectory (void);
+
+        PolylineSegmentedPath::View pathView (const size_t i) const;
+        SegmentedPathIndex::View indexView (const size_t i) const;
+
+        CheckpointReader reader;
+
+        const PathDatasetEntry* entries;
+        size_t entryCount;
+        const Vec3* points;
+        size_t pointTotal;
+        const Vec3* tangents;
+        size_t tangentTotal;
+        const float* lengths;
+        size_t lengthTotal;
+        const float* startDistances;
+        size_t startDistanceTotal;
+        const float* radii;
+        size_t radiusTotal;
+        const SegmentedPathIndex::Node* nodes;
+        size_t nodeTotal;
+        const unsigned int* order;
+        size_t orderTotal;
+
+        // not copyable
+        PathDatasetReader (const PathDatasetReader&);
+        PathDatasetReader& operator= (const PathDatasetReader&);
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_PATHDATASET_H
@@ -0,0 +1,132 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// PhaseTimer
+//
+// Accumulates wall clock time spent in the phases of a simulation step
+// (neighbor queries, steering, applySteeringForce, proximity updates) so
+// benchmarks can report where a frame goes.  Phases nest: time is charged
+// exclusively to the innermost active phase, so a neighbor query made from
+// inside a steering computation counts as neighbor query time only.
+//
+// Timing is off by default.  When off, a PhaseTimer::Scope costs a single
+// test of a bool.  Phase stacks and totals are kept per thread: total and
+// reset refer to the calling thread.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_PHASETIMER_H
+#define OPENSTEER_PHASETIMER_H
+
+
+#include "OpenSteer/Profiler.h"
+
+namespace OpenSteer {
+
+
+    class PhaseTimer
+    {
+    public:
+
+        // phases of a simulation step
+        enum Phase
+        {
+            // PlugIn update time not charged to one of the phases below
+            otherUpdatePhase,
+
+            // proximity database findNeighbors
+            neighborQueryPhase,
+
+            // computing steering forces (steering behaviors)
+            steeringPhase,
+
+            // integrating a steering force in applySteeringForce
+            applySteeringForcePhase,
+
+            // proximity database updateForNewPosition
+            proximityUpdatePhase,
+
+            phaseCount
+        };
+
+        // master on/off switch, off by default
+        static bool enabled;
+
+        // seconds charged to a given phase since the last reset
+        static double total (const Phase phase);
+
+        // zero all phase totals
+        static void reset (void);
+
+        // short lower case name of a given phase, for reports
+        static const char* name (const Phase phase);
+
+        // charges the time from its construction to its destruction to a
+        // given phase (minus time charged to any nested Scope).  In
+        // OPENSTEER_PROFILER builds it is also a Profiler::Scope.
+        class Scope
+        {
+        public:
+            Scope (const Phase phase)
+                : active (enabled)
+#ifdef OPENSTEER_PROFILER
+                , profile (name (phase))
+#endif
+            {
+                if (active) push (phase);
+            }
+            ~Scope ()
+            {
+                if (active) pop ();
+            }
+        private:
+            const bool active;
+#ifdef OPENSTEER_PROFILER
+            Profiler::Scope profile;
+#endif
+
+            // not copyable
+            Scope (const Scope&);
+            Scope& operator= (const Scope&);
+        };
+
+    private:
+
+        static void push (const Phase phase);
+        static void pop (void);
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_PHASETIMER_H
@@ -0,0 +1,92 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// PlanarVehicle
+//
+// A SimpleVehicle confined to the global XZ ("ground") plane, for PlugIns
+// whose vehicles walk or drive: pedestrians, cars, players.  Its up basis
+// vector is always global Y and its forward and side stay in the plane,
+// so its local space is regenerated from the X and Z of its velocity by a
+// quarter turn, without the cross products and normalizations of the
+// general case, and every steering force is projected onto the plane
+// before it is applied (in place of each PlugIn's own setYtoZero).  Its
+// heading may also be read or set as an angle about global Y.
+//
+// Vehicles opt in at compile time by deriving from PlanarVehicle rather
+// than SimpleVehicle.  Everything else (proximity databases, checkpoints,
+// steering logs, telemetry) still sees a SimpleVehicle.  For vehicles
+// which stay on the plane the motion is that of a SimpleVehicle, within
+// float rounding.  VehiclePopulation's planar mode is the matching batch
+// integrator.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_PLANARVEHICLE_H
+#define OPENSTEER_PLANARVEHICLE_H
+
+
+#include "OpenSteer/SimpleVehicle.h"
+
+
+namespace OpenSteer {
+
+
+    class PlanarVehicle : public SimpleVehicle
+    {
+    public:
+
+        // heading: the angle (in radians) of forward about global Y, zero
+        // facing +Z and a quarter turn facing +X
+        float heading (void) const;
+        void setHeading (const float angle);
+
+        // set forward to the projection of a direction onto the plane
+        // (unchanged if that is zero), side from it and up to global Y
+        void regenerateOrthonormalBasisUF (const Vec3& newForward);
+
+        // keep forward parallel to the velocity on the plane
+        void regenerateLocalSpace (const Vec3& newVelocity,
+                                   const float elapsedTime);
+
+        // SimpleVehicle's adjustment of the force projected onto the plane
+        Vec3 adjustRawSteeringForce (const Vec3& force,
+                                     const float deltaTime);
+
+    private:
+
+        // the local space of a given unit heading (x, z)
+        void setPlanarBasis (const float x, const float z);
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_PLANARVEHICLE_H
@@ -60,6 +60,12 @@ class FooPlugIn : public PlugIn
     bool requestInitialSelection (void) {return true;}
     void handleFunctionKeys (int keyNumber) {...} // fkeys reserved for PlugIns
     void printMiniHelpForFunctionKeys (void) {...} // if fkeys are used
+    bool setPopulation (int count) {...} // if population can vary
+    bool setParameter (const char* name, float value) {...} // for sweeps
+    void redrawSnapshot (const SimulationSnapshot& s, ...) {...} // scenery
+    bool saveCheckpoint (CheckpointWriter& c) {...} // if restartable
+    bool loadCheckpoint (const CheckpointReader& c) {...}
+    AbstractPlugIn* newWorldInstance (void) {...} // if it can run in Worlds
 };
 
 FooPlugIn gFooPlugIn;
@@ -81,6 +87,11 @@ FooPlugIn gFooPlugIn;
 
 namespace OpenSteer {
 
+    class SimulationSnapshot;
+    class CheckpointWriter;
+    class CheckpointReader;
+
+
     class AbstractPlugIn
     {
     public:
@@ -111,6 +122,50 @@ namespace OpenSteer {
         // print "mini help" documenting function keys handled by this PlugIn
         virtual void printMiniHelpForFunctionKeys (void) = 0;
 
+        // add or remove vehicles until there are the given number of them
+        // (for PlugIns with a variable population, used by benchmarks).
+        // Returns false if the PlugIn's population cannot be changed.
+        virtual bool setPopulation (int count) = 0;
+
+        // set one of the PlugIn's tuning parameters (such as a steering
+        // weight) by name, for parameter sweeps.  Takes effect from the
+        // next update and lasts until the PlugIn is next opened.  Returns
+        // false if the PlugIn has no parameter of that name.
+        virtual bool setParameter (const char* name, const float value) = 0;
+
+        // draw the PlugIn's own scenery (ground, paths, obstacles) for a
+        // snapshot of its simulation, while the simulation itself runs on
+        // another thread.  The host draws the snapshot's vehicles and
+        // annotation.  Must only read state the update does not change.
+        virtual void redrawSnapshot (const SimulationSnapshot& snapshot,
+                                     const float currentTime,
+                                     const float elapsedTime) = 0;
+
+        // neighbors per agent found during the last update, for the
+        // profiler display.  Returns false if the PlugIn does not count them.
+        virtual bool neighborStatistics (int& minNeighbors,
+                                         int& maxNeighbors,
+                                         float& averageNeighbors) = 0;
+
+        // add the sections describing the PlugIn's world (vehicles,
+        // proximity database configuration, obstacles, paths) to a
+        // checkpoint, see Checkpoint.h.  Returns false if the PlugIn
+        // cannot be checkpointed.
+        virtual bool saveCheckpoint (CheckpointWriter& checkpoint) = 0;
+
+        // replace the world of the open PlugIn with one saved by
+        // saveCheckpoint.  Returns false, leaving the world as it was, if
+        // the checkpoint lacks or has malformed sections.
+        virtual bool loadCheckpoint (const CheckpointReader& checkpoint) = 0;
+
+        // a new instance of the PlugIn, owned by the caller, for one of
+        // several independent worlds run in the same process (see World.h).
+        // It is not registered, must keep its whole state to itself and
+        // must leave OpenSteerDemo's (camera, selected vehicle) alone.
+        // Returns NULL if the PlugIn can only run as its registered
+        // singleton.
+        virtual AbstractPlugIn* newWorldInstance (void) = 0;
+
         // return an AVGroup (an STL vector of AbstractVehicle pointers) of
         // all vehicles(/agents/characters) defined by the PlugIn
         virtual const AVGroup& allVehicles (void) = 0;
@@ -148,6 +203,35 @@ namespace OpenSteer {
         // default "mini help": print nothing
         void printMiniHelpForFunctionKeys (void) {}
 
+        // default is a fixed population
+        bool setPopulation (int /*count*/) {return false;}
+
+        // default is to have no named parameters
+        bool setParameter (const char* /*name*/, const float /*value*/)
+            {return false;}
+
+        // default snapshot scenery: none
+        void redrawSnapshot (const SimulationSnapshot& /*snapshot*/,
+                             const float /*currentTime*/,
+                             const float /*elapsedTime*/) {}
+
+        // default is not to count neighbors
+        bool neighborStatistics (int& /*minNeighbors*/,
+                                 int& /*maxNeighbors*/,
+                                 float& /*averageNeighbors*/) {return false;}
+
+        // default is not to support checkpoints
+        bool saveCheckpoint (CheckpointWriter& /*checkpoint*/) {return false;}
+        bool loadCheckpoint (const CheckpointReader& /*checkpoint*/)
+            {return false;}
+
+        // default is to run as the registered singleton only
+        AbstractPlugIn* newWorldInstance (void) {return NULL;}
+
+        // whether this instance was made by newWorldInstance (rather than
+        // being the singleton OpenSteerDemo runs)
+        bool isWorldInstance (void) const {return ! registered;}
+
         // returns pointer to the next PlugIn in "selection order"
         PlugIn* next (void);
 
@@ -172,8 +256,18 @@ namespace OpenSteer {
         // returns pointer to default PlugIn (currently, first in registry)
         static PlugIn* findDefault (void);
 
+    protected:
+
+        // constructor for the instances made by newWorldInstance, which
+        // are not registered
+        enum WorldInstanceTag {worldInstance};
+        PlugIn (WorldInstanceTag);
+
     private:
 
+        // whether this instance is in the registry
+        bool registered;
+
         // save this instance in the class's registry of instances
         void addToRegistry (void);
 
@@ -49,6 +49,12 @@
 // Include OpenSteer::distance
 #include "OpenSteer/Vec3Utilities.h"
 
+// Include OpenSteer::SegmentedPathIndex
+#include "OpenSteer/SegmentedPathIndex.h"
+
+// Include OpenSteer::AccountedVector
+#include "OpenSteer/MemoryAccount.h"
+
 
 
 namespace OpenSteer {
@@ -58,11 +64,41 @@ namespace OpenSteer {
      * Segmented path build by polylines. The last point of the path might be 
      * connected to the first point building a closed cycle.
      *
-     * 
+     * Instead of its own storage the path can use a @c View of arrays owned
+     * elsewhere, e.g. mapped from a file by @c PathDatasetReader. Such a 
+     * path can be queried, copied and swapped but not changed besides 
+     * replacing it with @c setPath.
+     *
+     * A path that isn't cyclic can slide along a route: points can be 
+     * appended to its end or prepended to its start and removed from 
+     * either, at amortized constant cost per point. Distances along the 
+     * path returned or taken by its @c Path member functions are measured
+     * from a fixed origin, the path start when set by @c setPath, so they 
+     * stay valid while the path slides; @c startDistance returns where the
+     * path currently starts. @c segmentStartDistance, 
+     * @c segmentIndexAtDistance and the mapping functions of 
+     * @c QueryPathAlike.h measure from the current path start. Once the 
+     * start moved these distances may differ by rounding from those of a
+     * path set to the same points, and between the indexed and plain 
+     * mapping.
      */
     class PolylineSegmentedPath : public SegmentedPath {
     public:
         
+        /**
+         * The arrays the queries read: @c pointCount points (the first 
+         * one repeated at the end of a cyclic path), the tangent and length
+         * of each segment, and the distance of each segment start followed
+         * by that of the path end, all measured from the same point.
+         */
+        struct View {
+            Vec3 const* points;
+            Vec3 const* segmentTangents;
+            float const* segmentLengths;
+            float const* segmentStartDistances;
+            size_type pointCount;
+        };
+        
         /**
          * Constructs an invalid path. Behavior of most member functions is
          * undefined if a path has less than two distinct points.
@@ -109,7 +145,8 @@ namespace OpenSteer {
                       bool closedCycle );
         
         /**
-         * Replaces @a numOfPoints points starting at @a startIndex.
+         * Replaces @a numOfPoints points starting at @a startIndex. Not 
+         * allowed for a view, see @c setView.
          *
          * In the resulting sequence of points there mustn't be two adjacent 
          * ones that are equal. The first and last point mustn't be identical,
@@ -129,6 +166,94 @@ namespace OpenSteer {
                          size_type numOfPoints,
                          Vec3 const newPoints[]);
         
+        /**
+         * Appends @a numOfPoints points to the end of the path. Only the 
+         * new segments are computed.
+         *
+         * The path mustn't be cyclic or a view and must be valid. The first
+         * new point mustn't equal the last point, and adjacent new points 
+         * mustn't be equal.
+         */
+        void appendPoints( size_type numOfPoints,
+                           Vec3 const newPoints[] );
+        
+        /**
+         * Inserts @a numOfPoints points before the first point of the path,
+         * which then starts at <code>newPoints[ 0 ]</code>. Only the new
+         * segments are computed, @c startDistance decreases by their 
+         * length.
+         *
+         * The path mustn't be cyclic or a view and must be valid. The last
+         * new point mustn't equal the first point, and adjacent new points 
+         * mustn't be equal.
+         */
+        void prependPoints( size_type numOfPoints,
+                            Vec3 const newPoints[] );
+        
+        /**
+         * Removes the first @a numOfPoints points, @c startDistance 
+         * increases by the length of the removed segments. At least two
+         * points must remain. The path mustn't be cyclic or a view.
+         */
+        void removeFirstPoints( size_type numOfPoints );
+        
+        /**
+         * Removes the last @a numOfPoints points. At least two points must 
+         * remain. The path mustn't be cyclic or a view.
+         */
+        void removeLastPoints( size_type numOfPoints );
+        
+        /**
+         * Returns the distance of the path start from the distance origin,
+         * @c 0 unless points were removed from or prepended to the start.
+         */
+        float startDistance() const;
+        
+        /**
+         * Enables or disables an index over the segments that lets mapping a
+         * point to the path test only the segments near it instead of all.
+         * Mapping results are identical either way. The index costs memory
+         * and is updated by every change of the path. Disabled by default.
+         */
+        void setSegmentIndexEnabled( bool enabled );
+        
+        /**
+         * Returns @c true if the segment index is enabled.
+         */
+        bool segmentIndexEnabled() const;
+        
+        /**
+         * Returns the segment index, empty if disabled.
+         */
+        SegmentedPathIndex const& segmentIndex() const;
+        
+        /**
+         * Returns the arrays of the path, valid until it changes.
+         */
+        View view() const;
+        
+        /**
+         * Uses the arrays of @a view and, if it has nodes, the segment index
+         * @a index instead of own storage without copying them. They must 
+         * stay valid and unchanged while the path uses them, until 
+         * @c setPath replaces them.
+         *
+         * @param view Arrays of at least two points, adjacent points 
+         *             different, consistent like those @c view returns.
+         * @param closedCycle @c true if the last point of @a view repeats 
+         *                    the first one to close the cycle.
+         * @param index Index over the segments of @a view, enabling the
+         *              segment index if it has nodes.
+         */
+        void setView( View const& view, 
+                      bool closedCycle, 
+                      SegmentedPathIndex::View const& index );
+        
+        /**
+         * Returns @c true if the path uses arrays set by @c setView.
+         */
+        bool isView() const;
+        
         
         
         virtual bool isValid() const;
@@ -137,6 +262,14 @@ namespace OpenSteer {
                                      float& outside) const;
 		virtual Vec3 mapPathDistanceToPoint (float pathDistance) const;
 		virtual float mapPointToPathDistance (const Vec3& point) const;
+        virtual Vec3 mapPointToPath (const Vec3& point,
+                                     Vec3& tangent,
+                                     float& outside,
+                                     PathCursor& cursor) const;
+        virtual Vec3 mapPathDistanceToPoint (float pathDistance,
+                                             PathCursor& cursor) const;
+        virtual float mapPointToPathDistance (const Vec3& point,
+                                              PathCursor& cursor) const;
         virtual bool isCyclic() const;
         virtual float length() const;
         
@@ -167,11 +300,45 @@ namespace OpenSteer {
                                                                   Vec3& pointOnPath,
                                                                   Vec3& tangent ) const;
         
+        /**
+         * Returns the distance along the path from its current start to the
+         * start of segment @a segmentIndex.
+         */
+        float segmentStartDistance( size_type segmentIndex ) const;
+        
+        /**
+         * Returns the segment containing the point @a distance along the 
+         * path from its current start: the first segment ending at least @a distance from the path
+         * start, or the last segment. Searches all segments binary unless 
+         * @a hint is a valid segment index, then walks from @a hint.
+         */
+        size_type segmentIndexAtDistance( float distance, size_type hint ) const;
+        
     private:
-        std::vector< Vec3 > points_;
-        std::vector< Vec3 > segmentTangents_;
-        std::vector< float > segmentLengths_;
+        // Storage charged to path memory.
+        typedef AccountedVector< Vec3, MemoryAccount::pathMemory >::type Vec3Container;
+        typedef AccountedVector< float, MemoryAccount::pathMemory >::type FloatContainer;
+        
+        Vec3Container points_;
+        Vec3Container segmentTangents_;
+        FloatContainer segmentLengths_;
+        FloatContainer segmentStartDistances_;
         bool closedCycle_;
+        SegmentedPathIndex segmentIndex_;
+        bool segmentIndexEnabled_;
+        
+        // What the queries read, the containers above from firstPoint_ on
+        // unless set by setView.
+        View view_;
+        bool isView_;
+        
+        // Removed points and free room at the front of the containers, and
+        // the distance origin of the stored start distances.
+        size_type firstPoint_;
+        float originDistance_;
+        
+        void updateView();
+        void makeRoomAtFront( size_type numOfPoints );
     }; // class PolylineSegmentedPath
     
     
@@ -54,6 +54,9 @@
 // Include OpenSteer::distance
 #include "OpenSteer/Vec3Utilities.h"
 
+// Include OpenSteer::SegmentedPathIndex
+#include "OpenSteer/SegmentedPathIndex.h"
+
 
 
 namespace OpenSteer {
@@ -143,7 +146,8 @@ namespace OpenSteer {
         float segmentRadius( size_type segmentIndex ) const;
         
         /**
-         * Sets the radius @a r of the segment @a segmentIndex.
+         * Sets the radius @a r of the segment @a segmentIndex. Not allowed
+         * for a view.
          */
         void setSegmentRadius( size_type segmentIndex, float r );
         
@@ -152,7 +156,7 @@ namespace OpenSteer {
          * @a startIndex with the elements of @a radii.
          *
          * <code>startIndex + numOfRadii</code> must be lesser or equal to 
-         * @c segmentCount.
+         * @c segmentCount. Not allowed for a view.
          *
          * @todo Write unit test.
          */
@@ -160,6 +164,35 @@ namespace OpenSteer {
                               size_type numOfRadii,
                               float const radii[] );
         
+        /**
+         * Enables or disables the segment index, see 
+         * @c PolylineSegmentedPath::setSegmentIndexEnabled. The index also
+         * tracks the segments' radii.
+         */
+        void setSegmentIndexEnabled( bool enabled );
+        
+        /**
+         * Returns @c true if the segment index is enabled.
+         */
+        bool segmentIndexEnabled() const;
+        
+        /**
+         * Uses the path arrays @a path, one radius per segment @a radii and,
+         * if it has nodes, the segment index @a index instead of own storage
+         * without copying them, see @c PolylineSegmentedPath::setView. 
+         * @a index must account for @a radii. @c setPathway replaces the 
+         * view.
+         */
+        void setView( PolylineSegmentedPath::View const& path,
+                      bool closedCycle,
+                      float const radii[],
+                      SegmentedPathIndex::View const& index );
+        
+        /**
+         * Returns @c true if the pathway uses arrays set by @c setView.
+         */
+        bool isView() const;
+        
         
         virtual bool isValid() const;
         virtual Vec3 mapPointToPath (const Vec3& point,
@@ -167,6 +200,29 @@ namespace OpenSteer {
                                      float& outside) const;
 		virtual Vec3 mapPathDistanceToPoint (float pathDistance) const;
 		virtual float mapPointToPathDistance (const Vec3& point) const;
+        virtual Vec3 mapPointToPath (const Vec3& point,
+                                     Vec3& tangent,
+                                     float& outside,
+                                     PathCursor& cursor) const;
+        virtual Vec3 mapPathDistanceToPoint (float pathDistance,
+                                             PathCursor& cursor) const;
+        virtual float mapPointToPathDistance (const Vec3& point,
+                                              PathCursor& cursor) const;
+        
+        /**
+         * Maps @a point like the cursor versions of @c mapPointToPath and 
+         * @c mapPointToPathDistance together, searching for the nearest 
+         * segment once. Returns the point on the path center line and stores
+         * its distance from the path start in @a pathDistance.
+         *
+         * Not virtual, so the steering behaviors taking a 
+         * @c PolylineSegmentedPathwaySegmentRadii call it directly.
+         */
+        Vec3 mapPointToPathAndDistance( Vec3 const& point,
+                                        Vec3& tangent,
+                                        float& outside,
+                                        float& pathDistance,
+                                        PathCursor& cursor ) const;
         virtual bool isCyclic() const;
         virtual float length() const;
         
@@ -200,10 +256,24 @@ namespace OpenSteer {
                                                                            Vec3& pointOnPath,
                                                                            Vec3& tangent,
                                                                            float& radius) const;
+        
+        /**
+         * See @c PolylineSegmentedPath::segmentStartDistance.
+         */
+        float segmentStartDistance( size_type segmentIndex ) const;
+        
+        /**
+         * See @c PolylineSegmentedPath::segmentIndexAtDistance.
+         */
+        size_type segmentIndexAtDistance( float distance, size_type hint ) const;
 
     private:
         PolylineSegmentedPath path_;
-        std::vector< float > segmentRadii_; 
+        AccountedVector< float, MemoryAccount::pathMemory >::type segmentRadii_; 
+        // The radii the queries read, segmentRadii_ unless set by setView.
+        float const* radii_;
+        SegmentedPathIndex segmentIndex_;
+        bool segmentIndexEnabled_;
     }; // class PolylineSegmentedPathwaySegmentRadii
     
     
@@ -48,6 +48,9 @@
 // Include OpenSteer::distance
 #include "OpenSteer/Vec3Utilities.h"
 
+// Include OpenSteer::SegmentedPathIndex
+#include "OpenSteer/SegmentedPathIndex.h"
+
 
 
 namespace OpenSteer {
@@ -93,6 +96,25 @@ namespace OpenSteer {
         void movePoints( size_type startIndex,
                          size_type numOfPoints,
                          Vec3 const newPointValues[] );
+        
+        /**
+         * Appends, prepends or removes points at the ends of the pathway, 
+         * see @c PolylineSegmentedPath::appendPoints and its siblings. The 
+         * segment index only tests the new segments on their own until 
+         * enough changed to rebuild it.
+         */
+        void appendPoints( size_type numOfPoints,
+                           Vec3 const newPoints[] );
+        void prependPoints( size_type numOfPoints,
+                            Vec3 const newPoints[] );
+        void removeFirstPoints( size_type numOfPoints );
+        void removeLastPoints( size_type numOfPoints );
+        
+        /**
+         * See @c PolylineSegmentedPath::startDistance.
+         */
+        float startDistance() const;
+        
         /**
          * Replaces the pathway information completely.
          *
@@ -123,6 +145,34 @@ namespace OpenSteer {
          */
         float radius() const;
         
+        /**
+         * Enables or disables the segment index, see 
+         * @c PolylineSegmentedPath::setSegmentIndexEnabled. The index also
+         * accounts for the pathway radius.
+         */
+        void setSegmentIndexEnabled( bool enabled );
+        
+        /**
+         * Returns @c true if the segment index is enabled.
+         */
+        bool segmentIndexEnabled() const;
+        
+        /**
+         * Uses the path arrays @a path and, if it has nodes, the segment 
+         * index @a index instead of own storage without copying them, see
+         * @c PolylineSegmentedPath::setView. @a index must account for 
+         * radius @a r. @c setPathway replaces the view.
+         */
+        void setView( PolylineSegmentedPath::View const& path,
+                      bool closedCycle,
+                      float r,
+                      SegmentedPathIndex::View const& index );
+        
+        /**
+         * Returns @c true if the pathway uses arrays set by @c setView.
+         */
+        bool isView() const;
+        
         
         virtual bool isValid() const;
 		virtual Vec3 mapPointToPath (const Vec3& point,
@@ -130,6 +180,29 @@ namespace OpenSteer {
                                      float& outside) const;
 		virtual Vec3 mapPathDistanceToPoint (float pathDistance) const;
 		virtual float mapPointToPathDistance (const Vec3& point) const;
+        virtual Vec3 mapPointToPath (const Vec3& point,
+                                     Vec3& tangent,
+                                     float& outside,
+                                     PathCursor& cursor) const;
+        virtual Vec3 mapPathDistanceToPoint (float pathDistance,
+                                             PathCursor& cursor) const;
+        virtual float mapPointToPathDistance (const Vec3& point,
+                                              PathCursor& cursor) const;
+        
+        /**
+         * Maps @a point like the cursor versions of @c mapPointToPath and 
+         * @c mapPointToPathDistance together, searching for the nearest 
+         * segment once. Returns the point on the path center line and stores
+         * its distance from the path start in @a pathDistance.
+         *
+         * Not virtual, so the steering behaviors taking a 
+         * @c PolylineSegmentedPathwaySingleRadius call it directly.
+         */
+        Vec3 mapPointToPathAndDistance( Vec3 const& point,
+                                        Vec3& tangent,
+                                        float& outside,
+                                        float& pathDistance,
+                                        PathCursor& cursor ) const;
         virtual bool isCyclic() const;
         virtual float length() const;
         
@@ -163,10 +236,22 @@ namespace OpenSteer {
                                                                            Vec3& pointOnPath,
                                                                            Vec3& tangent,
                                                                            float& radius) const;
+        
+        /**
+         * See @c PolylineSegmentedPath::segmentStartDistance.
+         */
+        float segmentStartDistance( size_type segmentIndex ) const;
+        
+        /**
+         * See @c PolylineSegmentedPath::segmentIndexAtDistance.
+         */
+        size_type segmentIndexAtDistance( float distance, size_type hint ) const;
          
     private:
         PolylineSegmentedPath path_;
         float radius_;
+        SegmentedPathIndex segmentIndex_;
+        bool segmentIndexEnabled_;
     }; // class PolylineSegmentedPathwaySingleRadius
     
     
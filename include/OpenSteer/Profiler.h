@@ -0,0 +1,137 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Profiler
+//
+// Hierarchical scoped timing for traces of whole frames.  Each
+// OPENSTEER_PROFILE_SCOPE (name) records one span, from the point it is
+// reached to the end of the enclosing block, into a ring buffer owned by
+// the calling thread; nested scopes give nested spans.  writeChromeTrace
+// exports the spans of all threads in the Chrome trace event format, which
+// chrome://tracing and Perfetto (ui.perfetto.dev) open.
+//
+// Instrumentation only exists in builds configured with OPENSTEER_PROFILER
+// (cmake -DOPENSTEER_PROFILER=ON); otherwise the macro expands to nothing.
+// When built in, recording is still off until Profiler::enabled is set,
+// and each scope then costs one test of a bool.  Every PhaseTimer::Scope
+// is also a profile scope named after its phase, so neighbor queries,
+// proximity updates, steering behaviors and applySteeringForce show up
+// without further markup.
+//
+// Each thread's buffer keeps its latest ringCapacity spans, older ones are
+// overwritten.  clear and writeChromeTrace must not run while other threads
+// record (call them between frames, or after the run).
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_PROFILER_H
+#define OPENSTEER_PROFILER_H
+
+
+#include <cstddef>
+#include <ostream>
+
+
+namespace OpenSteer {
+
+
+    class Profiler
+    {
+    public:
+
+        // master on/off switch for recording, off by default
+        static bool enabled;
+
+        // number of spans each thread's ring buffer holds, for buffers made
+        // after it is set (default 65536)
+        static size_t ringCapacity;
+
+        // name the calling thread in exported traces (the name must stay
+        // valid, such as a string literal)
+        static void setThreadName (const char* name);
+
+        // discard all recorded spans
+        static void clear (void);
+
+        // number of spans recorded (and not overwritten) on all threads
+        static size_t spanCount (void);
+
+        // write all recorded spans as a Chrome trace event JSON document
+        static void writeChromeTrace (std::ostream& os);
+
+        // records a span named name (which must stay valid, such as a
+        // string literal) from its construction to its destruction
+        class Scope
+        {
+        public:
+            Scope (const char* name) : active (enabled)
+            {
+                if (active) begin (name);
+            }
+            ~Scope ()
+            {
+                if (active) end ();
+            }
+        private:
+            const bool active;
+
+            // not copyable
+            Scope (const Scope&);
+            Scope& operator= (const Scope&);
+        };
+
+    private:
+
+        static void begin (const char* name);
+        static void end (void);
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+// instrumentation points, compiled out unless OPENSTEER_PROFILER is defined
+
+
+#ifdef OPENSTEER_PROFILER
+    #define OPENSTEER_PROFILE_CONCATENATE2(a, b) a ## b
+    #define OPENSTEER_PROFILE_CONCATENATE(a, b) OPENSTEER_PROFILE_CONCATENATE2(a, b)
+    #define OPENSTEER_PROFILE_SCOPE(name) \
+        OpenSteer::Profiler::Scope \
+        OPENSTEER_PROFILE_CONCATENATE(openSteerProfileScope, __LINE__) (name)
+#else
+    #define OPENSTEER_PROFILE_SCOPE(name)
+#endif
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_PROFILER_H
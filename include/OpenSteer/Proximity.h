@@ -44,8 +44,18 @@
 
 
 #include <algorithm>
+#include <cassert>
+#include <cstdlib>
 #include <vector>
+#include <limits>
+#include <mutex>
+#include <atomic>
 #include "OpenSteer/Vec3.h"
+#include "OpenSteer/Vec3Batch.h"
+#include "OpenSteer/NeighborRecord.h"
+#include "OpenSteer/ObjectPool.h"
+#include "OpenSteer/PhaseTimer.h"
+#include "OpenSteer/WorkerPool.h"
 #include "OpenSteer/lq.h"   // XXX temp?
 
 
@@ -71,6 +81,88 @@ namespace OpenSteer {
                                     const float radius,
                                     std::vector<ContentType>& results) = 0;
 
+        // as above, recording each neighbor's distance squared and offset
+        // from center along with it
+        virtual void findNeighbors (const Vec3& center,
+                                    const float radius,
+                                    std::vector<NeighborRecord<ContentType> >& results) = 0;
+
+        // find neighbors within the given sphere without allocating: at
+        // most maxResults of them are written into the caller's results
+        // array and the number written is returned.  Which neighbors are
+        // kept when more than maxResults are in range is unspecified.
+        virtual size_t findNeighbors (const Vec3& center,
+                                      const float radius,
+                                      ContentType* results,
+                                      const size_t maxResults) = 0;
+
+        // as above, but the (at most) k neighbors within the sphere which
+        // are nearest to its center are written, nearest first
+        virtual size_t findNearestNeighbors (const Vec3& center,
+                                             const float radius,
+                                             ContentType* results,
+                                             const size_t k) = 0;
+
+        // as above, leaving out the exclude object (typically the querying
+        // object itself).  By default the k+1 nearest are found and the
+        // exclude object dropped from them.
+        virtual size_t findNearestNeighbors (const Vec3& center,
+                                             const float radius,
+                                             ContentType* results,
+                                             const size_t k,
+                                             ContentType exclude)
+        {
+            static thread_local std::vector<ContentType> nearest;
+            if (nearest.size() < k + 1) nearest.resize (k + 1);
+            const size_t found =
+                findNearestNeighbors (center, radius, nearest.data(), k + 1);
+            size_t count = 0;
+            for (size_t i = 0; (i < found) && (count < k); i++)
+                if (nearest[i] != exclude) results[count++] = nearest[i];
+            return count;
+        }
+
+        // the object nearest to center within radius other than exclude,
+        // or ContentType() if there is none
+        ContentType findNearestNeighbor (const Vec3& center,
+                                         const float radius,
+                                         ContentType exclude)
+        {
+            ContentType nearest = ContentType();
+            findNearestNeighbors (center, radius, &nearest, 1, exclude);
+            return nearest;
+        }
+
+        // as the first three queries above, but only neighbors in the
+        // layers whose bits are set in layerMask.  Only a
+        // LayeredProximityDatabase has more than one layer: all objects
+        // of the other databases are in layer 0.
+        virtual void findNeighborsInLayers (const Vec3& center,
+                                            const float radius,
+                                            const unsigned int layerMask,
+                                            std::vector<ContentType>& results)
+        {
+            if (layerMask & 1) findNeighbors (center, radius, results);
+        }
+
+        virtual void findNeighborsInLayers (const Vec3& center,
+                                            const float radius,
+                                            const unsigned int layerMask,
+                                            std::vector<NeighborRecord<ContentType> >& results)
+        {
+            if (layerMask & 1) findNeighbors (center, radius, results);
+        }
+
+        virtual size_t findNeighborsInLayers (const Vec3& center,
+                                              const float radius,
+                                              const unsigned int layerMask,
+                                              ContentType* results,
+                                              const size_t maxResults)
+        {
+            if (! (layerMask & 1)) return 0;
+            return findNeighbors (center, radius, results, maxResults);
+        }
+
 #ifndef NO_LQ_BIN_STATS
         // only meaningful for LQProximityDatabase, provide dummy default
         virtual void getBinPopulationStats (int& min, int& max, float& average)
@@ -79,85 +171,2196 @@ namespace OpenSteer {
     };
 
 
-    // ----------------------------------------------------------------------------
-    // abstract type for all kinds of proximity databases
+    // ----------------------------------------------------------------------------
+    // Query costs and bin occupancy of a proximity database, as returned by
+    // AbstractProximityDatabase::getStatistics.  Every database counts its
+    // lookup structure's units (LQ bins, grid or hash cells, the brute
+    // force database's single list) as bins.
+
+
+    class ProximityStatistics
+    {
+    public:
+
+        ProximityStatistics (void) {clear ();}
+
+        void clear (void)
+        {
+            queries = 0;
+            binsVisited = 0;
+            candidatesTested = 0;
+            candidatesAccepted = 0;
+            outsideBinCandidates = 0;
+            positionUpdates = 0;
+            binMigrations = 0;
+            occupancy.clear ();
+            outsideBinPopulation = 0;
+        }
+
+        // neighbor queries made
+        size_t queries;
+
+        // bins scanned by those queries
+        size_t binsVisited;
+
+        // objects whose distance from a query center was tested, and
+        // those found within the query's radius
+        size_t candidatesTested;
+        size_t candidatesAccepted;
+
+        // tested objects which were in the catch-all bin of an LQ
+        // database (for objects outside its super-brick)
+        size_t outsideBinCandidates;
+
+        // position updates, and those which moved a token to another bin
+        size_t positionUpdates;
+        size_t binMigrations;
+
+        // occupancy[n] is the number of bins holding n objects, the last
+        // entry also counting the bins holding more.  A spatial hash has
+        // no empty bins (occupancy[0] is 0).
+        std::vector<size_t> occupancy;
+
+        // objects in the catch-all bin of an LQ database
+        size_t outsideBinPopulation;
+
+        // average candidates tested per query, and the fraction of them
+        // which were accepted
+        float candidatesPerQuery (void) const
+        {
+            return queries ? ((float) candidatesTested / queries) : 0;
+        }
+        float acceptanceRate (void) const
+        {
+            return candidatesTested ?
+                ((float) candidatesAccepted / candidatesTested) : 0;
+        }
+    };
+
+
+    // cost of a single query, added up by a database while it scans
+    class ProximityQueryCost
+    {
+    public:
+        ProximityQueryCost (void)
+            : binsVisited (0),
+              candidatesTested (0),
+              candidatesAccepted (0),
+              outsideBinCandidates (0)
+        {}
+        size_t binsVisited;
+        size_t candidatesTested;
+        size_t candidatesAccepted;
+        size_t outsideBinCandidates;
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // Accumulates the results of a fixed capacity neighbor query into a
+    // caller owned array: either the first maxResults candidates offered or,
+    // when nearestFirst, the maxResults nearest ones sorted by distance.
+    // Used by the database implementations below.
+
+
+    template <class ContentType>
+    class NeighborCollector
+    {
+    public:
+
+        NeighborCollector (ContentType* results,
+                           const size_t maxResults,
+                           const bool nearestFirst)
+            : _results (results),
+              _maxResults (maxResults),
+              _count (0),
+              _nearestFirst (nearestFirst)
+        {
+            // distances of the kept results, per thread so concurrent
+            // queries neither share nor (after the first) allocate it
+            static thread_local std::vector<float> distances;
+            if (_nearestFirst && (distances.size() < maxResults))
+                distances.resize (maxResults);
+            _distances = distances.data();
+        }
+
+        // offer a candidate at the given squared distance from the center
+        void add (ContentType object, const float distanceSquared)
+        {
+            if (! _nearestFirst)
+            {
+                if (_count < _maxResults) _results[_count++] = object;
+                return;
+            }
+
+            // keep the nearest: find the insertion point from the far end,
+            // dropping the farthest kept result when already full
+            size_t i = _count;
+            if (_count < _maxResults)
+                _count++;
+            else if ((_count == 0) || (distanceSquared >= _distances[_count-1]))
+                return;
+            else
+                i--;
+            while ((i > 0) && (distanceSquared < _distances[i-1]))
+            {
+                _results[i] = _results[i-1];
+                _distances[i] = _distances[i-1];
+                i--;
+            }
+            _results[i] = object;
+            _distances[i] = distanceSquared;
+        }
+
+        // number of results written so far
+        size_t count (void) const {return _count;}
+
+    private:
+        ContentType* _results;
+        float* _distances;
+        const size_t _maxResults;
+        size_t _count;
+        const bool _nearestFirst;
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // Result sinks for databases which scan candidates with a template
+    // visitor: each is called with an object within the query sphere, its
+    // distance squared and its offset from the query center, and hands it
+    // on to one of the query result forms above.
+
+
+    template <class ContentType>
+    class NeighborObjectSink
+    {
+    public:
+        NeighborObjectSink (std::vector<ContentType>& r) : results (r) {}
+        void operator() (ContentType o, float, const Vec3&)
+            {results.push_back (o);}
+    private:
+        std::vector<ContentType>& results;
+    };
+
+    template <class ContentType>
+    class NeighborRecordSink
+    {
+    public:
+        NeighborRecordSink (std::vector<NeighborRecord<ContentType> >& r)
+            : results (r) {}
+        void operator() (ContentType o, float d2, const Vec3& offset)
+            {results.push_back (NeighborRecord<ContentType> (o, d2, offset));}
+    private:
+        std::vector<NeighborRecord<ContentType> >& results;
+    };
+
+    template <class ContentType>
+    class NeighborCollectorSink
+    {
+    public:
+        NeighborCollectorSink (NeighborCollector<ContentType>& c)
+            : collector (c) {}
+        void operator() (ContentType o, float d2, const Vec3&)
+            {collector.add (o, d2);}
+    private:
+        NeighborCollector<ContentType>& collector;
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // A spatial hash index over a fixed set of entries, each an object and
+    // its position: entries are counting sorted into flat arrays by cell,
+    // where cells are boxes of a given size keyed on their integer
+    // coordinates in an open addressing hash table.  There are no world
+    // bounds and memory scales with the number of occupied cells (the
+    // table is sized from the entry count, which bounds the occupied cell
+    // count).  A query looks up each cell its bounding box overlaps, or
+    // when that box covers more cells than are occupied, walks the
+    // occupied cells instead.
+    //
+    // Once built, queries only read the index so any number may run at
+    // once.  Used by SpatialHashProximityDatabase and ProximitySnapshot.
+
+
+    template <class ContentType>
+    class SpatialHashIndex
+    {
+    public:
+
+        // constructor: cells of the given dimensions
+        SpatialHashIndex (const Vec3& cellSize)
+            : occupiedCells (0)
+        {
+            setCellSize (cellSize);
+        }
+
+        // change the cell dimensions, which takes effect at the next build
+        void setCellSize (const Vec3& cellSize)
+        {
+            inverseCellSize = Vec3 (1.0f / cellSize.x,
+                                    1.0f / cellSize.y,
+                                    1.0f / cellSize.z);
+        }
+
+        // hash every entry (objects[i] at positions.get(i)) into the table,
+        // then counting sort them by cell
+        void build (const std::vector<ContentType>& objects,
+                    const Vec3Batch& positions)
+        {
+            const size_t count = objects.size();
+
+            // at most half full even if every entry occupies its own cell
+            size_t capacity = 16;
+            while (capacity < count * 2) capacity *= 2;
+            table.assign (capacity, Cell ());
+            occupiedCells = 0;
+
+            // count entries per cell, using end as the counter
+            cellOfEntry.resize (count);
+            slotOfEntry.resize (count);
+            for (size_t i = 0; i < count; i++)
+            {
+                const int c = insertCell (keyForPosition (positions.get (i)));
+                cellOfEntry[i] = c;
+                table[c].end++;
+            }
+
+            // assign each cell its range, leaving end as the fill pointer
+            int start = 0;
+            for (size_t c = 0; c < capacity; c++)
+            {
+                if (table[c].begin < 0) continue;
+                const int n = table[c].end;
+                table[c].begin = start;
+                table[c].end = start;
+                start += n;
+            }
+
+            sortedPositions.resize (count);
+            sortedObjects.resize (count);
+            for (size_t i = 0; i < count; i++)
+            {
+                const int slot = table[cellOfEntry[i]].end++;
+                slotOfEntry[i] = slot;
+                sortedPositions.set (slot, positions.get (i));
+                sortedObjects[slot] = objects[i];
+            }
+        }
+
+        // whether a position is in the cell entry i was sorted into
+        bool sameCell (const size_t i, const Vec3& p) const
+        {
+            return table[cellOfEntry[i]].key == keyForPosition (p);
+        }
+
+        // move entry i to a position within its cell (see sameCell)
+        void moveWithinCell (const size_t i, const Vec3& p)
+        {
+            sortedPositions.set (slotOfEntry[i], p);
+        }
+
+        // call sink (object, distanceSquared, offset) for every entry
+        // within the sphere
+        template <class Sink>
+        void scan (const Vec3& center, const float radius, Sink& sink) const
+        {
+            ProximityQueryCost cost;
+            scan (center, radius, sink, cost);
+        }
+
+        // as above, adding the cells scanned and entries tested and found
+        // to a query cost
+        template <class Sink>
+        void scan (const Vec3& center,
+                   const float radius,
+                   Sink& sink,
+                   ProximityQueryCost& cost) const
+        {
+            if (occupiedCells == 0) return;
+
+            const CellKey k0 = keyForPosition (center - Vec3 (radius, radius, radius));
+            const CellKey k1 = keyForPosition (center + Vec3 (radius, radius, radius));
+            const float r2 = radius * radius;
+
+            static thread_local std::vector<float> distances;
+
+            // for a box wider than the occupied set, walk occupied cells
+            const double boxCells = ((double) (k1.x - k0.x + 1) *
+                                     (double) (k1.y - k0.y + 1) *
+                                     (double) (k1.z - k0.z + 1));
+            if (boxCells > occupiedCells)
+            {
+                for (size_t c = 0; c < table.size(); c++)
+                {
+                    const Cell& cell = table[c];
+                    if ((cell.begin >= 0) &&
+                        (cell.key.x >= k0.x) && (cell.key.x <= k1.x) &&
+                        (cell.key.y >= k0.y) && (cell.key.y <= k1.y) &&
+                        (cell.key.z >= k0.z) && (cell.key.z <= k1.z))
+                        scanCell (cell, center, r2, distances, sink, cost);
+                }
+                return;
+            }
+
+            for (int ix = k0.x; ix <= k1.x; ix++)
+            {
+                for (int iy = k0.y; iy <= k1.y; iy++)
+                {
+                    for (int iz = k0.z; iz <= k1.z; iz++)
+                    {
+                        const int c = findCell (CellKey (ix, iy, iz));
+                        if (c >= 0) scanCell (table[c], center, r2, distances, sink, cost);
+                    }
+                }
+            }
+        }
+
+        // number of entries and of occupied cells as of the last build
+        size_t size (void) const {return sortedObjects.size();}
+        int getOccupiedCellCount (void) const {return occupiedCells;}
+
+        // statistics about cell populations: min, max and average of
+        // occupied cells
+        void getCellPopulationStats (int& min, int& max, float& average) const
+        {
+            min = occupiedCells ? std::numeric_limits<int>::max() : 0;
+            max = 0;
+            for (size_t c = 0; c < table.size(); c++)
+            {
+                if (table[c].begin < 0) continue;
+                const int n = table[c].end - table[c].begin;
+                if (n < min) min = n;
+                if (n > max) max = n;
+            }
+            average = occupiedCells ? ((float) size() / occupiedCells) : 0;
+        }
+
+        // add the population of each occupied cell to a histogram (see
+        // ProximityStatistics::occupancy)
+        void countOccupancy (std::vector<size_t>& occupancy) const
+        {
+            for (size_t c = 0; c < table.size(); c++)
+            {
+                if (table[c].begin < 0) continue;
+                const size_t n = table[c].end - table[c].begin;
+                occupancy[std::min (n, occupancy.size() - 1)]++;
+            }
+        }
+
+    private:
+
+        // integer coordinates of a cell
+        class CellKey
+        {
+        public:
+            CellKey () : x (0), y (0), z (0) {}
+            CellKey (const int ix, const int iy, const int iz)
+                : x (ix), y (iy), z (iz) {}
+            bool operator== (const CellKey& k) const
+                {return (x == k.x) && (y == k.y) && (z == k.z);}
+            int x, y, z;
+        };
+
+        // a hash table slot: entries of an occupied cell are the sorted
+        // range [begin, end), and begin < 0 marks an empty slot
+        class Cell
+        {
+        public:
+            Cell () : begin (-1), end (0) {}
+            CellKey key;
+            int begin, end;
+        };
+
+        // cell coordinate along one axis.  Coordinates are limited to keep
+        // the conversion to int defined for arbitrarily distant positions.
+        static int cellCoordinate (const float p, const float inverseSize)
+        {
+            const float limit = 1.0e9f;
+            const float c = floorf (p * inverseSize);
+            if (c < -limit) return (int) -limit;
+            if (c > limit) return (int) limit;
+            return (int) c;
+        }
+
+        CellKey keyForPosition (const Vec3& p) const
+        {
+            return CellKey (cellCoordinate (p.x, inverseCellSize.x),
+                            cellCoordinate (p.y, inverseCellSize.y),
+                            cellCoordinate (p.z, inverseCellSize.z));
+        }
+
+        size_t hashSlot (const CellKey& k) const
+        {
+            const unsigned int h = (((unsigned int) k.x * 73856093u) ^
+                                    ((unsigned int) k.y * 19349663u) ^
+                                    ((unsigned int) k.z * 83492791u));
+            return h & (table.size() - 1);
+        }
+
+        // table slot holding the given cell, or -1 if it is not occupied
+        int findCell (const CellKey& k) const
+        {
+            for (size_t s = hashSlot (k); ; s = (s + 1) & (table.size() - 1))
+            {
+                if (table[s].begin < 0) return -1;
+                if (table[s].key == k) return (int) s;
+            }
+        }
+
+        // table slot holding the given cell, claimed if empty
+        int insertCell (const CellKey& k)
+        {
+            for (size_t s = hashSlot (k); ; s = (s + 1) & (table.size() - 1))
+            {
+                if (table[s].begin < 0)
+                {
+                    table[s].key = k;
+                    table[s].begin = 0;
+                    table[s].end = 0;
+                    occupiedCells++;
+                    return (int) s;
+                }
+                if (table[s].key == k) return (int) s;
+            }
+        }
+
+        // call sink for every entry of one cell within the sphere
+        template <class Sink>
+        void scanCell (const Cell& cell,
+                       const Vec3& center,
+                       const float r2,
+                       std::vector<float>& distances,
+                       Sink& sink,
+                       ProximityQueryCost& cost) const
+        {
+            const int n = cell.end - cell.begin;
+            cost.binsVisited++;
+            cost.candidatesTested += n;
+            if ((int) distances.size() < n) distances.resize (n);
+            distanceSquaredMany (center,
+                                 &sortedPositions.x[cell.begin],
+                                 &sortedPositions.y[cell.begin],
+                                 &sortedPositions.z[cell.begin],
+                                 n,
+                                 distances.data());
+
+            for (int i = 0; i < n; i++)
+            {
+                if (distances[i] < r2)
+                {
+                    const int j = cell.begin + i;
+                    sink (sortedObjects[j],
+                          distances[i],
+                          sortedPositions.get (j) - center);
+                    cost.candidatesAccepted++;
+                }
+            }
+        }
+
+        Vec3 inverseCellSize;
+
+        // occupied cells, and the entries sorted by cell
+        std::vector<Cell> table;
+        int occupiedCells;
+        Vec3Batch sortedPositions;
+        std::vector<ContentType> sortedObjects;
+
+        // table slot and sorted slot of each entry as of the last build
+        std::vector<int> cellOfEntry;
+        std::vector<int> slotOfEntry;
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // A frozen, read-only copy of the contents of a proximity database, as
+    // made by AbstractProximityDatabase::publishSnapshot.  All queries are
+    // const and safe to run from any number of threads at once: they keep
+    // no state outside the caller's result storage beyond thread-local
+    // scratch.  A snapshot never changes while it is being queried, also
+    // while the database it came from is updated.
+
+
+    template <class ContentType>
+    class ProximitySnapshot
+    {
+    public:
+
+        ProximitySnapshot () : index (Vec3 (1, 1, 1))
+        {
+        }
+
+        // replace the contents, objects[i] at positions.get(i), indexed in
+        // cells of the given size.  Must not run concurrently with queries
+        // of this snapshot.
+        void assign (const std::vector<ContentType>& objects,
+                     const Vec3Batch& positions,
+                     const Vec3& cellSize)
+        {
+            index.setCellSize (cellSize);
+            index.build (objects, positions);
+        }
+
+        // number of objects in the snapshot
+        int getPopulation (void) const
+        {
+            return (int) index.size();
+        }
+
+        // find all neighbors within the given sphere (as center and radius)
+        void findNeighbors (const Vec3& center,
+                            const float radius,
+                            std::vector<ContentType>& results) const
+        {
+            PhaseTimer::Scope timer (PhaseTimer::neighborQueryPhase);
+            NeighborObjectSink<ContentType> sink (results);
+            index.scan (center, radius, sink);
+        }
+
+        // as above, with distances and offsets
+        void findNeighbors (const Vec3& center,
+                            const float radius,
+                            std::vector<NeighborRecord<ContentType> >& results) const
+        {
+            PhaseTimer::Scope timer (PhaseTimer::neighborQueryPhase);
+            NeighborRecordSink<ContentType> sink (results);
+            index.scan (center, radius, sink);
+        }
+
+        // fixed capacity versions, into a caller owned array
+        size_t findNeighbors (const Vec3& center,
+                              const float radius,
+                              ContentType* results,
+                              const size_t maxResults) const
+        {
+            PhaseTimer::Scope timer (PhaseTimer::neighborQueryPhase);
+            NeighborCollector<ContentType> c (results, maxResults, false);
+            NeighborCollectorSink<ContentType> sink (c);
+            index.scan (center, radius, sink);
+            return c.count();
+        }
+
+        size_t findNearestNeighbors (const Vec3& center,
+                                     const float radius,
+                                     ContentType* results,
+                                     const size_t k) const
+        {
+            PhaseTimer::Scope timer (PhaseTimer::neighborQueryPhase);
+            NeighborCollector<ContentType> c (results, k, true);
+            NeighborCollectorSink<ContentType> sink (c);
+            index.scan (center, radius, sink);
+            return c.count();
+        }
+
+    private:
+        SpatialHashIndex<ContentType> index;
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // the plain data state a proximity database needs, beyond its
+    // construction parameters and contents, to continue exactly where
+    // another one of the same kind left off (see
+    // AbstractProximityDatabase::saveState).  Only adaptive databases keep
+    // any: their current divisions and progress towards the next adaption.
+
+
+    struct ProximityDatabaseState
+    {
+        int divisions[3];
+        int framesSinceAdapt;
+        float maxQueryRadius;
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // abstract type for all kinds of proximity databases
+
+
+    template <class ContentType>
+    class AbstractProximityDatabase
+    {
+    public:
+
+        // type for the "tokens" manipulated by this spatial database
+        typedef AbstractTokenForProximityDatabase<ContentType> tokenType;
+
+        
+        // requests still staged are dropped (their tokens neither made
+        // nor deleted)
+        virtual ~AbstractProximityDatabase()
+        {
+            StagedMutation* m = stagedMutations.load (std::memory_order_acquire);
+            while (m)
+            {
+                StagedMutation* const next = m->next;
+                delete m;
+                m = next;
+            }
+        }
+        
+        // allocate a token to represent a given client object in this database
+        virtual tokenType* allocateToken (ContentType parentObject) = 0;
+
+        // make room for count more tokens, ahead of allocating them one by
+        // one (databases keeping their tokens in pools override this)
+        virtual void reserveTokens (const size_t /*count*/)
+        {
+        }
+
+        // allocate tokens for count client objects at once, tokens[i]
+        // representing objects[i]
+        void allocateTokens (const ContentType* objects,
+                             const size_t count,
+                             tokenType** tokens)
+        {
+            reserveTokens (count);
+            for (size_t i = 0; i < count; i++)
+                tokens[i] = allocateToken (objects[i]);
+        }
+
+        // delete count tokens at once (each removal costs O(1))
+        static void deleteTokens (tokenType* const* tokens, const size_t count)
+        {
+            for (size_t i = 0; i < count; i++) delete tokens[i];
+        }
+
+        // Staged mutation, for spawning and despawning from any thread while
+        // other threads query.  stageInsertion and stageRemoval only push a
+        // request onto a lock-free list, so they may be called from any
+        // number of threads at any time, even during queries and updates.
+        // Nothing changes until applyStagedMutations, which the thread
+        // owning the database calls at a frame boundary (never concurrently
+        // with queries, updates or maintain): it deletes the tokens staged
+        // for removal, then allocates (in one batch) the tokens staged for
+        // insertion, gives them their positions, and stores each in the
+        // place its stageInsertion named.  Queries thus only ever see the
+        // database between whole frames' worth of mutations.  Returns the
+        // number of requests applied.
+
+        // a token for object at position, stored to *token when applied
+        void stageInsertion (ContentType object,
+                             const Vec3& position,
+                             tokenType** token)
+        {
+            assert (token != NULL);
+            StagedMutation* const m = new StagedMutation;
+            m->kind = StagedMutation::insertion;
+            m->object = object;
+            m->position = position;
+            m->token = token;
+            m->removed = NULL;
+            pushStagedMutation (m);
+        }
+
+        // token (which must not be used once applied) is deleted
+        void stageRemoval (tokenType* token)
+        {
+            assert (token != NULL);
+            StagedMutation* const m = new StagedMutation;
+            m->kind = StagedMutation::removal;
+            m->token = NULL;
+            m->removed = token;
+            pushStagedMutation (m);
+        }
+
+        size_t applyStagedMutations (void)
+        {
+            // take the whole list, putting it back in staging order
+            StagedMutation* m = stagedMutations.exchange (NULL, std::memory_order_acquire);
+            StagedMutation* ordered = NULL;
+            while (m)
+            {
+                StagedMutation* const next = m->next;
+                m->next = ordered;
+                ordered = m;
+                m = next;
+            }
+
+            size_t count = 0;
+            stagedObjects.clear ();
+            stagedPositions.clear ();
+            for (m = ordered; m; m = m->next, count++)
+            {
+                if (m->kind == StagedMutation::removal)
+                {
+                    delete m->removed;
+                }
+                else
+                {
+                    stagedObjects.push_back (m->object);
+                    stagedPositions.push_back (m->position);
+                }
+            }
+
+            const size_t insertions = stagedObjects.size();
+            if (insertions)
+            {
+                stagedTokens.resize (insertions);
+                allocateTokens (&stagedObjects[0], insertions, &stagedTokens[0]);
+                updateForNewPositions (&stagedTokens[0], &stagedPositions[0],
+                                       insertions, NULL);
+            }
+
+            // (a token with nowhere to go is deleted rather than leaked)
+            size_t i = 0;
+            while (ordered)
+            {
+                StagedMutation* const next = ordered->next;
+                if (ordered->kind == StagedMutation::insertion)
+                {
+                    tokenType* const token = stagedTokens[i++];
+                    if (ordered->token) *ordered->token = token;
+                    else delete token;
+                }
+                delete ordered;
+                ordered = next;
+            }
+            return count;
+        }
+
+        // insert
+        // XXX maybe this should return an iterator?
+        // XXX see http://www.sgi.com/tech/stl/set.html
+        // virtual void insert (const ContentType& x) = 0;
+
+        // XXX name?
+        // returns the number of tokens in the proximity database
+        virtual int getPopulation (void) = 0;
+
+        // update the positions of count tokens of this database at once,
+        // tokens[i] moving to positions[i], with the same effect as calling
+        // updateForNewPosition on each.  Databases may override this to do
+        // the work in bulk, using pool (when not NULL) for the parts which
+        // can run in parallel.
+        virtual void updateForNewPositions (tokenType* const* tokens,
+                                            const Vec3* positions,
+                                            const size_t count,
+                                            WorkerPool* /*pool*/)
+        {
+            for (size_t i = 0; i < count; i++)
+                tokens[i]->updateForNewPosition (positions[i]);
+        }
+
+        // called once per frame, between the update and query phases (so
+        // never concurrently with either), for databases which do periodic
+        // upkeep of their own
+        virtual void maintain (void)
+        {
+        }
+
+        // copy out the database's contents: every object which has been
+        // given a position, and that position
+        virtual void copyContents (std::vector<ContentType>& objects,
+                                   Vec3Batch& positions) = 0;
+
+        // For checkpoints: a new database of the same kind, given this
+        // state (before any positions) and then the objects' positions in
+        // placement order, finds neighbors in the same order as this one,
+        // so a restored simulation sums them up in the same order.  By
+        // default there is no state and results come in token order,
+        // whatever the placement order.
+        virtual void saveState (ProximityDatabaseState& state)
+        {
+            state.divisions[0] = state.divisions[1] = state.divisions[2] = 0;
+            state.framesSinceAdapt = 0;
+            state.maxQueryRadius = 0;
+        }
+
+        virtual void restoreState (const ProximityDatabaseState& /*state*/)
+        {
+        }
+
+        virtual void copyPlacementOrder (std::vector<ContentType>& objects)
+        {
+            Vec3Batch positions;
+            copyContents (objects, positions);
+        }
+
+        // Double buffered frozen snapshots for concurrent queries.
+        // publishSnapshot copies the current contents into the back buffer,
+        // indexed in cells of the given size (about the typical query
+        // radius), then makes that the front buffer returned by
+        // snapshot().  Queries of a snapshot may run on any number of
+        // threads while the database itself takes the next frame's
+        // updates, and a snapshot stays unchanged until the second
+        // publishSnapshot after the one which published it.
+        // publishSnapshot must not run concurrently with updates.
+        void publishSnapshot (const Vec3& cellSize)
+        {
+            ProximitySnapshot<ContentType>& back = snapshots[1 - frontSnapshot];
+            copyContents (snapshotObjects, snapshotPositions);
+            back.assign (snapshotObjects, snapshotPositions, cellSize);
+            frontSnapshot = 1 - frontSnapshot;
+        }
+
+        void publishSnapshot (const float cellSize)
+        {
+            publishSnapshot (Vec3 (cellSize, cellSize, cellSize));
+        }
+
+        // the most recently published snapshot (empty before the first)
+        const ProximitySnapshot<ContentType>& snapshot (void) const
+        {
+            return snapshots[frontSnapshot];
+        }
+
+        // Query cost statistics.  While enabled (they are off by default)
+        // the database counts its neighbor queries and position updates,
+        // with relaxed atomic adds once per query so concurrent queries
+        // may be counted; while off counting costs a test of a bool.
+        // Enable, disable and reset between frames, not during queries.
+        void setStatisticsEnabled (const bool on) {statisticsOn = on;}
+        bool getStatisticsEnabled (void) const {return statisticsOn;}
+
+        // zero the counts, typically once per frame
+        void resetStatistics (void)
+        {
+            for (int i = 0; i < counterCount; i++)
+                counters[i].store (0, std::memory_order_relaxed);
+        }
+
+        // the counts since the last reset, and a histogram with the given
+        // number of entries of the current bin occupancy.  Must not run
+        // concurrently with updates.
+        void getStatistics (ProximityStatistics& statistics,
+                            const size_t histogramSize = 32)
+        {
+            statistics.queries = counterValue (queriesCounter);
+            statistics.binsVisited = counterValue (binsVisitedCounter);
+            statistics.candidatesTested = counterValue (candidatesTestedCounter);
+            statistics.candidatesAccepted = counterValue (candidatesAcceptedCounter);
+            statistics.outsideBinCandidates = counterValue (outsideBinCandidatesCounter);
+            statistics.positionUpdates = counterValue (positionUpdatesCounter);
+            statistics.binMigrations = counterValue (binMigrationsCounter);
+            statistics.occupancy.assign (std::max<size_t> (histogramSize, 1), 0);
+            statistics.outsideBinPopulation = 0;
+            countOccupancy (statistics.occupancy,
+                            statistics.outsideBinPopulation);
+        }
+
+    protected:
+        AbstractProximityDatabase ()
+            : stagedMutations (NULL), frontSnapshot (0), statisticsOn (false)
+        {
+            resetStatistics ();
+        }
+
+        // count one query of the given cost (if statistics are enabled)
+        void countQuery (const ProximityQueryCost& cost)
+        {
+            if (! statisticsOn) return;
+            addToCounter (queriesCounter, 1);
+            addToCounter (binsVisitedCounter, cost.binsVisited);
+            addToCounter (candidatesTestedCounter, cost.candidatesTested);
+            addToCounter (candidatesAcceptedCounter, cost.candidatesAccepted);
+            if (cost.outsideBinCandidates)
+                addToCounter (outsideBinCandidatesCounter, cost.outsideBinCandidates);
+        }
+
+        // count position updates, of which migrations changed bins
+        void countUpdates (const size_t updates, const size_t migrations)
+        {
+            if (! statisticsOn) return;
+            addToCounter (positionUpdatesCounter, updates);
+            if (migrations) addToCounter (binMigrationsCounter, migrations);
+        }
+
+        // add each bin to the histogram (sized and zeroed by the caller,
+        // bins holding too many for it to the last entry), and the objects
+        // kept outside any bin, if the database has such a thing
+        virtual void countOccupancy (std::vector<size_t>& occupancy,
+                                     size_t& outsideBinPopulation) = 0;
+
+        // add a bin of the given population to an occupancy histogram
+        static void addToOccupancy (std::vector<size_t>& occupancy,
+                                    const size_t population)
+        {
+            occupancy[std::min (population, occupancy.size() - 1)]++;
+        }
+
+    private:
+
+        // a request of stageInsertion or stageRemoval
+        struct StagedMutation : public AccountedObject<MemoryAccount::tokenMemory>
+        {
+            enum Kind {insertion, removal};
+
+            StagedMutation* next;
+            Kind kind;
+            ContentType object;
+            Vec3 position;
+            tokenType** token;
+            tokenType* removed;
+        };
+
+        // push onto the list of requests, newest first
+        void pushStagedMutation (StagedMutation* m)
+        {
+            m->next = stagedMutations.load (std::memory_order_relaxed);
+            while (! stagedMutations.compare_exchange_weak
+                   (m->next, m, std::memory_order_release,
+                    std::memory_order_relaxed))
+                ;
+        }
+
+        std::atomic<StagedMutation*> stagedMutations;
+
+        // scratch space for applyStagedMutations
+        std::vector<ContentType> stagedObjects;
+        std::vector<Vec3> stagedPositions;
+        std::vector<tokenType*> stagedTokens;
+
+        ProximitySnapshot<ContentType> snapshots[2];
+        int frontSnapshot;
+
+        // scratch space for publishSnapshot
+        std::vector<ContentType> snapshotObjects;
+        Vec3Batch snapshotPositions;
+
+        // statistics counters
+        enum Counter
+        {
+            queriesCounter,
+            binsVisitedCounter,
+            candidatesTestedCounter,
+            candidatesAcceptedCounter,
+            outsideBinCandidatesCounter,
+            positionUpdatesCounter,
+            binMigrationsCounter,
+            counterCount
+        };
+        bool statisticsOn;
+        std::atomic<size_t> counters [counterCount];
+
+        void addToCounter (const Counter c, const size_t n)
+        {
+            counters[c].fetch_add (n, std::memory_order_relaxed);
+        }
+        size_t counterValue (const Counter c) const
+        {
+            return counters[c].load (std::memory_order_relaxed);
+        }
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // This is the "brute force" O(n^2) approach implemented in terms of the
+    // AbstractProximityDatabase protocol so it can be compared directly to other
+    // approaches.  (e.g. the Boids plugin allows switching at runtime.)
+
+
+    template <class ContentType>
+    class BruteForceProximityDatabase
+        : public AbstractProximityDatabase<ContentType>
+    {
+    public:
+
+        // constructor
+        BruteForceProximityDatabase (void)
+            : tokenPool (64, MemoryAccount::tokenMemory)
+        {
+        }
+
+        // destructor
+        virtual ~BruteForceProximityDatabase ()
+        {
+        }
+
+        // "token" to represent objects stored in the database (allocated
+        // in the database's pool)
+        class tokenType : public AbstractTokenForProximityDatabase<ContentType>,
+                          public PooledObject<tokenType>
+        {
+        public:
+
+            // constructor
+            tokenType (ContentType parentObject, BruteForceProximityDatabase& pd)
+            {
+                // store pointer to our associated database, and store this
+                // token and the object it represents on the database's
+                // vectors (its position in the parallel component arrays)
+                bfpd = &pd;
+                index = bfpd->group.size();
+                bfpd->group.push_back (this);
+                bfpd->objects.push_back (parentObject);
+                bfpd->positions.push_back (Vec3::zero);
+            }
+
+            // destructor: move the last entry into this token's slot
+            virtual ~tokenType ()
+            {
+                const size_t last = bfpd->group.size() - 1;
+                if (index != last)
+                {
+                    bfpd->group[index] = bfpd->group[last];
+                    bfpd->objects[index] = bfpd->objects[last];
+                    bfpd->positions.set (index, bfpd->positions.get (last));
+                    bfpd->group[index]->index = index;
+                }
+                bfpd->group.pop_back ();
+                bfpd->objects.pop_back ();
+                bfpd->positions.pop_back ();
+            }
+
+            // the client object calls this each time its position changes
+            void updateForNewPosition (const Vec3& newPosition)
+            {
+                PhaseTimer::Scope timer (PhaseTimer::proximityUpdatePhase);
+                bfpd->positions.set (index, newPosition);
+                bfpd->countUpdates (1, 0);
+            }
+
+            // find all neighbors within the given sphere (as center and radius)
+            void findNeighbors (const Vec3& center,
+                                const float radius,
+                                std::vector<ContentType>& results)
+            {
+                PhaseTimer::Scope timer (PhaseTimer::neighborQueryPhase);
+
+                // distance squared from center to every token, computed
+                // several tokens at a time (per thread scratch space so
+                // concurrent queries do not allocate)
+                static thread_local std::vector<float> distances;
+                const size_t count = bfpd->group.size();
+                distances.resize (count);
+                bfpd->positions.distanceSquared (center, distances.data());
+
+                // push onto result vector when within given radius
+                const float r2 = radius * radius;
+                const size_t before = results.size();
+                for (size_t i = 0; i < count; i++)
+                {
+                    if (distances[i] < r2) results.push_back (bfpd->objects[i]);
+                }
+                bfpd->countScan (count, results.size() - before);
+            }
+
+            // find all neighbors within the given sphere, with their
+            // distances and offsets
+            void findNeighbors (const Vec3& center,
+                                const float radius,
+                                std::vector<NeighborRecord<ContentType> >& results)
+            {
+                PhaseTimer::Scope timer (PhaseTimer::neighborQueryPhase);
+
+                static thread_local std::vector<float> distances;
+                const size_t count = bfpd->group.size();
+                distances.resize (count);
+                bfpd->positions.distanceSquared (center, distances.data());
+
+                const float r2 = radius * radius;
+                const size_t before = results.size();
+                for (size_t i = 0; i < count; i++)
+                {
+                    if (distances[i] < r2)
+                    {
+                        const Vec3 offset = bfpd->positions.get (i) - center;
+                        results.push_back (NeighborRecord<ContentType>
+                                           (bfpd->objects[i],
+                                            distances[i],
+                                            offset));
+                    }
+                }
+                bfpd->countScan (count, results.size() - before);
+            }
+
+            // fixed capacity versions, into a caller owned array
+            size_t findNeighbors (const Vec3& center,
+                                  const float radius,
+                                  ContentType* results,
+                                  const size_t maxResults)
+            {
+                NeighborCollector<ContentType> c (results, maxResults, false);
+                collectNeighbors (center, radius, c);
+                return c.count();
+            }
+
+            size_t findNearestNeighbors (const Vec3& center,
+                                         const float radius,
+                                         ContentType* results,
+                                         const size_t k)
+            {
+                NeighborCollector<ContentType> c (results, k, true);
+                collectNeighbors (center, radius, c);
+                return c.count();
+            }
+
+            // offer every token within the given sphere to a collector
+            void collectNeighbors (const Vec3& center,
+                                   const float radius,
+                                   NeighborCollector<ContentType>& collector)
+            {
+                PhaseTimer::Scope timer (PhaseTimer::neighborQueryPhase);
+
+                static thread_local std::vector<float> distances;
+                const size_t count = bfpd->group.size();
+                distances.resize (count);
+                bfpd->positions.distanceSquared (center, distances.data());
+
+                const float r2 = radius * radius;
+                size_t accepted = 0;
+                for (size_t i = 0; i < count; i++)
+                {
+                    if (distances[i] < r2)
+                    {
+                        collector.add (bfpd->objects[i], distances[i]);
+                        accepted++;
+                    }
+                }
+                bfpd->countScan (count, accepted);
+            }
+
+        private:
+            friend class BruteForceProximityDatabase;
+            BruteForceProximityDatabase* bfpd;
+            size_t index;
+        };
+
+        typedef std::vector<tokenType*> tokenVector;
+        typedef typename tokenVector::const_iterator tokenIterator;    
+
+        // allocate a token to represent a given client object in this database
+        tokenType* allocateToken (ContentType parentObject)
+        {
+            return new (tokenPool) tokenType (parentObject, *this);
+        }
+
+        // make room for count more tokens
+        void reserveTokens (const size_t count)
+        {
+            tokenPool.reserve (count);
+            group.reserve (group.size() + count);
+            objects.reserve (objects.size() + count);
+            positions.reserve (positions.size() + count);
+        }
+
+        // return the number of tokens currently in the database
+        int getPopulation (void)
+        {
+            return (int) group.size();
+        }
+
+        // copy out the objects and their positions
+        void copyContents (std::vector<ContentType>& o, Vec3Batch& p)
+        {
+            o = objects;
+            p = positions;
+        }
+        
+    protected:
+        // all tokens are in one bin
+        void countOccupancy (std::vector<size_t>& occupancy, size_t&)
+        {
+            this->addToOccupancy (occupancy, group.size());
+        }
+
+    private:
+        // count a query which tested every token
+        void countScan (const size_t tested, const size_t accepted)
+        {
+            ProximityQueryCost cost;
+            cost.binsVisited = 1;
+            cost.candidatesTested = tested;
+            cost.candidatesAccepted = accepted;
+            this->countQuery (cost);
+        }
+
+        // storage of the tokens
+        ObjectPool<tokenType> tokenPool;
+
+        // STL vector containing all tokens in database, and the objects
+        // and positions of the tokens in the same order (contiguous for
+        // the query scans)
+        tokenVector group;
+        std::vector<ContentType> objects;
+        Vec3Batch positions;
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // A AbstractProximityDatabase-style wrapper for the LQ bin lattice system
+
+
+    template <class ContentType>
+    class LQProximityDatabase : public AbstractProximityDatabase<ContentType>
+    {
+    public:
+
+        // constructor
+        LQProximityDatabase (const Vec3& center,
+                             const Vec3& dimensions,
+                             const Vec3& divisions)
+            : tokenPool (64, MemoryAccount::tokenMemory),
+              size (dimensions),
+              divx ((int) round (divisions.x)),
+              divy ((int) round (divisions.y)),
+              divz ((int) round (divisions.z)),
+              adaptive (false),
+              adaptInterval (0),
+              framesSinceAdapt (0),
+              maxQueryRadius (0)
+        {
+            const Vec3 halfsize (dimensions * 0.5f);
+            const Vec3 origin (center - halfsize);
+
+            lq = lqCreateDatabase (origin.x, origin.y, origin.z, 
+                                   dimensions.x, dimensions.y, dimensions.z,  
+                                   divx, divy, divz);
+        }
+
+        // destructor
+        virtual ~LQProximityDatabase ()
+        {
+            lqDeleteDatabase (lq);
+            lq = NULL;
+        }
+
+        // "token" to represent objects stored in the database (allocated
+        // in the database's pool)
+        class tokenType : public AbstractTokenForProximityDatabase<ContentType>,
+                          public PooledObject<tokenType>
+        {
+        public:
+
+            // constructor
+            tokenType (ContentType parentObject, LQProximityDatabase& lqsd)
+                : lqpd (&lqsd)
+            {
+                lqInitClientProxy (&proxy, parentObject);
+                lq = lqsd.lq;
+            }
+
+            // destructor
+            virtual ~tokenType (void)
+            {
+                lqRemoveFromBin (&proxy);
+            }
+
+            // the client object calls this each time its position changes
+            void updateForNewPosition (const Vec3& p)
+            {
+                PhaseTimer::Scope timer (PhaseTimer::proximityUpdatePhase);
+                lqClientProxy** const bin = proxy.bin;
+                lqUpdateForNewLocation (lq, &proxy, p.x, p.y, p.z);
+                lqpd->countUpdates (1, (proxy.bin != bin) ? 1 : 0);
+            }
+
+            // find all neighbors within the given sphere (as center and radius)
+            void findNeighbors (const Vec3& center,
+                                const float radius,
+                                std::vector<ContentType>& results)
+            {
+                PhaseTimer::Scope timer (PhaseTimer::neighborQueryPhase);
+                lqpd->noteQueryRadius (radius);
+                lqQueryCounts counts = {0, 0, 0, 0};
+                lqMapOverAllObjectsInLocalityCounted (lq, 
+                                                      center.x, center.y, center.z,
+                                                      radius,
+                                                      perNeighborCallBackFunction,
+                                                      (void*)&results,
+                                                      &counts);
+                lqpd->countLQQuery (counts);
+            }
+
+            // find all neighbors within the given sphere, with their
+            // distances and offsets
+            void findNeighbors (const Vec3& center,
+                                const float radius,
+                                std::vector<NeighborRecord<ContentType> >& results)
+            {
+                PhaseTimer::Scope timer (PhaseTimer::neighborQueryPhase);
+                lqpd->noteQueryRadius (radius);
+                lqQueryCounts counts = {0, 0, 0, 0};
+                lqMapOverAllObjectsInLocalityWithOffsetsCounted (lq, 
+                                                                 center.x, center.y, center.z,
+                                                                 radius,
+                                                                 perNeighborRecordCallBackFunction,
+                                                                 (void*)&results,
+                                                                 &counts);
+                lqpd->countLQQuery (counts);
+            }
+
+            // called by LQ for each clientObject in the specified neighborhood:
+            // push a record of it onto the NeighborRecord vector in void*
+            // clientQueryState
+            static void perNeighborRecordCallBackFunction (void* clientObject,
+                                                           float distanceSquared,
+                                                           float offsetX,
+                                                           float offsetY,
+                                                           float offsetZ,
+                                                           void* clientQueryState)
+            {
+                typedef std::vector<NeighborRecord<ContentType> > nrv;
+                nrv& results = *((nrv*) clientQueryState);
+                results.push_back (NeighborRecord<ContentType>
+                                   ((ContentType) clientObject,
+                                    distanceSquared,
+                                    Vec3 (offsetX, offsetY, offsetZ)));
+            }
+
+            // fixed capacity versions, into a caller owned array
+            size_t findNeighbors (const Vec3& center,
+                                  const float radius,
+                                  ContentType* results,
+                                  const size_t maxResults)
+            {
+                NeighborCollector<ContentType> c (results, maxResults, false);
+                collectNeighbors (center, radius, c);
+                return c.count();
+            }
+
+            size_t findNearestNeighbors (const Vec3& center,
+                                         const float radius,
+                                         ContentType* results,
+                                         const size_t k)
+            {
+                return findNearestNeighbors (center, radius, results, k,
+                                             ContentType());
+            }
+
+            // the k nearest by lqFindKNearestNeighborsWithinRadius, which
+            // visits bins in shells around the center's bin and stops at
+            // the first shell beyond the k-th nearest found.  The radius
+            // only bounds the search, so an adaptive database does not
+            // size its bins by it.
+            size_t findNearestNeighbors (const Vec3& center,
+                                         const float radius,
+                                         ContentType* results,
+                                         const size_t k,
+                                         ContentType exclude)
+            {
+                if (k == 0) return 0;
+                PhaseTimer::Scope timer (PhaseTimer::neighborQueryPhase);
+                static thread_local std::vector<void*> objects;
+                static thread_local std::vector<float> distances;
+                if (objects.size() < k)
+                {
+                    objects.resize (k);
+                    distances.resize (k);
+                }
+                lqQueryCounts counts = {0, 0, 0, 0};
+                const int found =
+                    lqFindKNearestNeighborsWithinRadiusCounted (lq,
+                                                                center.x, center.y, center.z,
+                                                                radius,
+                                                                (void*) exclude,
+                                                                (int) k,
+                                                                objects.data(),
+                                                                distances.data(),
+                                                                &counts);
+                lqpd->countLQQuery (counts);
+                for (int i = 0; i < found; i++)
+                    results[i] = (ContentType) objects[i];
+                return found;
+            }
+
+            // offer every object within the given sphere to a collector
+            void collectNeighbors (const Vec3& center,
+                                   const float radius,
+                                   NeighborCollector<ContentType>& collector)
+            {
+                PhaseTimer::Scope timer (PhaseTimer::neighborQueryPhase);
+                lqpd->noteQueryRadius (radius);
+                lqQueryCounts counts = {0, 0, 0, 0};
+                lqMapOverAllObjectsInLocalityCounted (lq, 
+                                                      center.x, center.y, center.z,
+                                                      radius,
+                                                      collectorCallBackFunction,
+                                                      (void*)&collector,
+                                                      &counts);
+                lqpd->countLQQuery (counts);
+            }
+
+            // called by LQ for each clientObject in the specified neighborhood:
+            // offer it to the NeighborCollector in void* clientQueryState
+            static void collectorCallBackFunction (void* clientObject,
+                                                   float distanceSquared,
+                                                   void* clientQueryState)
+            {
+                typedef NeighborCollector<ContentType> nc;
+                nc& collector = *((nc*) clientQueryState);
+                collector.add ((ContentType) clientObject, distanceSquared);
+            }
+
+            // called by LQ for each clientObject in the specified neighborhood:
+            // push that clientObject onto the ContentType vector in void*
+            // clientQueryState
+            // (parameter names commented out to prevent compiler warning from "-W")
+            static void perNeighborCallBackFunction  (void* clientObject,
+                                                      float /*distanceSquared*/,
+                                                      void* clientQueryState)
+            {
+                typedef std::vector<ContentType> ctv;
+                ctv& results = *((ctv*) clientQueryState);
+                results.push_back ((ContentType) clientObject);
+            }
+
+#ifndef NO_LQ_BIN_STATS
+            // Get statistics about bin populations: min, max and
+            // average of non-empty bins.
+            void getBinPopulationStats (int& min, int& max, float& average)
+            {
+                lqGetBinPopulationStats (lq, &min, &max, &average);
+            }
+#endif // NO_LQ_BIN_STATS
+
+        private:
+            friend class LQProximityDatabase;
+            lqClientProxy proxy;
+            lqDB* lq;
+            LQProximityDatabase* lqpd;
+        };
+
+
+        // allocate a token to represent a given client object in this database
+        tokenType* allocateToken (ContentType parentObject)
+        {
+            return new (tokenPool) tokenType (parentObject, *this);
+        }
+
+        // make room for count more tokens
+        void reserveTokens (const size_t count)
+        {
+            tokenPool.reserve (count);
+        }
+
+        // count the number of tokens currently in the database
+        int getPopulation (void)
+        {
+            int count = 0;
+            lqMapOverAllObjects (lq, counterCallBackFunction, &count);
+            return count;
+        }
+        
+        // (parameter names commented out to prevent compiler warning from "-W")
+        static void counterCallBackFunction  (void* /*clientObject*/,
+                                              float /*distanceSquared*/,
+                                              void* clientQueryState)
+        {
+            int& counter = *(int*)clientQueryState;
+            counter++;
+        }
+
+        // copy out the objects and their positions
+        void copyContents (std::vector<ContentType>& objects, Vec3Batch& p)
+        {
+            objects.clear ();
+            p.clear ();
+            ContentsState state (objects, p);
+            lqMapOverAllObjectsWithLocations (lq, contentsCallBackFunction, &state);
+        }
+
+        // batch update: the destination bin of every token is found first
+        // (in parallel on pool if given), then lqUpdateManyForNewLocations
+        // stores the positions and relinks only tokens which changed bins
+        typedef typename AbstractProximityDatabase<ContentType>::tokenType
+            abstractTokenType;
+
+        void updateForNewPositions (abstractTokenType* const* tokens,
+                                    const Vec3* positions,
+                                    const size_t count,
+                                    WorkerPool* pool)
+        {
+            if (count == 0) return;
+            PhaseTimer::Scope timer (PhaseTimer::proximityUpdatePhase);
+
+            batchProxies.resize (count);
+            batchX.resize (count);
+            batchY.resize (count);
+            batchZ.resize (count);
+            batchBins.resize (count);
+
+            FindBins findBins (*this, tokens, positions);
+            if (pool)
+                pool->parallelFor (count, findBins);
+            else
+                findBins (0, count);
+
+            const int migrations =
+                lqUpdateManyForNewLocations (lq,
+                                             &batchProxies[0],
+                                             &batchX[0], &batchY[0], &batchZ[0],
+                                             &batchBins[0],
+                                             (int) count);
+            this->countUpdates (count, migrations);
+        }
+
+        // Adaptive mode: while on, the database tracks the largest query
+        // radius and every interval calls of maintain picks divisions for
+        // bins about that size (half that where occupied bins are crowded),
+        // resizing the lattice when some axis would change by more than a
+        // quarter.  Axes of one division (as for a planar world) stay so.
+        void setAdaptive (const bool adapt, const int interval = 30)
+        {
+            adaptive = adapt;
+            adaptInterval = interval;
+            framesSinceAdapt = 0;
+            maxQueryRadius.store (0, std::memory_order_relaxed);
+        }
+
+        void maintain (void)
+        {
+            if (! adaptive || (++framesSinceAdapt < adaptInterval)) return;
+            framesSinceAdapt = 0;
+
+            const float radius = maxQueryRadius.exchange (0, std::memory_order_relaxed);
+            if (radius <= 0) return;
+
+            float binSize = radius;
+#ifndef NO_LQ_BIN_STATS
+            int min, max;
+            float average;
+            lqGetBinPopulationStats (lq, &min, &max, &average);
+            if ((max > 0) && (average > crowdedBinPopulation)) binSize *= 0.5f;
+#endif // NO_LQ_BIN_STATS
+
+            const int nx = adaptedDivisions (divx, size.x, binSize);
+            const int ny = adaptedDivisions (divy, size.y, binSize);
+            const int nz = adaptedDivisions (divz, size.z, binSize);
+            if (significantChange (divx, nx) ||
+                significantChange (divy, ny) ||
+                significantChange (divz, nz))
+            {
+                divx = nx;
+                divy = ny;
+                divz = nz;
+                lqResizeBins (lq, divx, divy, divz);
+            }
+        }
+
+        // current number of divisions along each axis
+        Vec3 getDivisions (void) const
+        {
+            return Vec3 ((float) divx, (float) divy, (float) divz);
+        }
+
+        // checkpoint support: the adapted divisions and adaptive mode
+        // progress, and the placement order (each bin lists its objects
+        // newest first, so they are placed in reverse)
+        void saveState (ProximityDatabaseState& state)
+        {
+            state.divisions[0] = divx;
+            state.divisions[1] = divy;
+            state.divisions[2] = divz;
+            state.framesSinceAdapt = framesSinceAdapt;
+            state.maxQueryRadius = maxQueryRadius.load (std::memory_order_relaxed);
+        }
+
+        void restoreState (const ProximityDatabaseState& state)
+        {
+            const int* d = state.divisions;
+            if ((d[0] > 0) && (d[1] > 0) && (d[2] > 0) &&
+                ((d[0] != divx) || (d[1] != divy) || (d[2] != divz)))
+            {
+                divx = d[0];
+                divy = d[1];
+                divz = d[2];
+                lqResizeBins (lq, divx, divy, divz);
+            }
+            framesSinceAdapt = state.framesSinceAdapt;
+            maxQueryRadius.store (state.maxQueryRadius, std::memory_order_relaxed);
+        }
+
+        void copyPlacementOrder (std::vector<ContentType>& objects)
+        {
+            AbstractProximityDatabase<ContentType>::copyPlacementOrder (objects);
+            std::reverse (objects.begin (), objects.end ());
+        }
+
+    protected:
+        void countOccupancy (std::vector<size_t>& occupancy,
+                             size_t& outsideBinPopulation)
+        {
+            histogram.resize (occupancy.size());
+            outsideBinPopulation =
+                lqGetBinPopulationHistogram (lq, &histogram[0],
+                                             (int) histogram.size());
+            for (size_t i = 0; i < histogram.size(); i++)
+                occupancy[i] = histogram[i];
+        }
+
+    private:
+
+        // storage of the tokens
+        ObjectPool<tokenType> tokenPool;
+
+        void countLQQuery (const lqQueryCounts& counts)
+        {
+            ProximityQueryCost cost;
+            cost.binsVisited = counts.binsVisited;
+            cost.candidatesTested = counts.candidatesTested;
+            cost.candidatesAccepted = counts.candidatesAccepted;
+            cost.outsideBinCandidates = counts.outsideCandidates;
+            this->countQuery (cost);
+        }
+
+        // accumulator for copyContents
+        class ContentsState
+        {
+        public:
+            ContentsState (std::vector<ContentType>& o, Vec3Batch& p)
+                : objects (o), positions (p) {}
+            std::vector<ContentType>& objects;
+            Vec3Batch& positions;
+        };
+
+        static void contentsCallBackFunction (void* clientObject,
+                                              float x, float y, float z,
+                                              void* clientQueryState)
+        {
+            ContentsState& state = *((ContentsState*) clientQueryState);
+            state.objects.push_back ((ContentType) clientObject);
+            state.positions.push_back (Vec3 (x, y, z));
+        }
+
+        // average population of non-empty bins above which adaptive mode
+        // prefers bins of half the query radius, and the most divisions it
+        // will use along an axis
+        static const int crowdedBinPopulation = 16;
+        static const int maxAdaptedDivisions = 64;
+
+        // record a query radius for adaptive mode.  Queries run
+        // concurrently so this is atomic, but rarely writes.
+        void noteQueryRadius (const float radius)
+        {
+            if (! adaptive) return;
+            float current = maxQueryRadius.load (std::memory_order_relaxed);
+            while ((radius > current) &&
+                   ! maxQueryRadius.compare_exchange_weak (current, radius,
+                                                           std::memory_order_relaxed))
+            {
+            }
+        }
+
+        static int adaptedDivisions (const int current,
+                                     const float extent,
+                                     const float binSize)
+        {
+            if (current == 1) return 1;
+            const int d = (int) round (extent / binSize);
+            if (d > maxAdaptedDivisions) return maxAdaptedDivisions;
+            return (d < 1) ? 1 : d;
+        }
+
+        static bool significantChange (const int current, const int proposed)
+        {
+            return std::abs (proposed - current) * 4 > current;
+        }
+
+        // loop body of updateForNewPositions' first pass: gathers proxies
+        // and positions for LQ and finds their new bins
+        class FindBins
+        {
+        public:
+            FindBins (LQProximityDatabase& d,
+                      abstractTokenType* const* t,
+                      const Vec3* p)
+                : db (d), tokens (t), positions (p) {}
+
+            void operator() (size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; i++)
+                {
+                    const Vec3& p = positions[i];
+                    db.batchProxies[i] = &(static_cast<tokenType*> (tokens[i])->proxy);
+                    db.batchX[i] = p.x;
+                    db.batchY[i] = p.y;
+                    db.batchZ[i] = p.z;
+                    db.batchBins[i] = lqBinIndexForLocation (db.lq, p.x, p.y, p.z);
+                }
+            }
+
+        private:
+            LQProximityDatabase& db;
+            abstractTokenType* const* tokens;
+            const Vec3* positions;
+        };
+
+        lqDB* lq;
+
+        // super-brick size and current divisions
+        const Vec3 size;
+        int divx, divy, divz;
+
+        // adaptive mode state
+        bool adaptive;
+        int adaptInterval;
+        int framesSinceAdapt;
+        std::atomic<float> maxQueryRadius;
+
+        // scratch space for updateForNewPositions, reused between frames
+        std::vector<lqClientProxy*> batchProxies;
+        std::vector<float> batchX, batchY, batchZ;
+        std::vector<int> batchBins;
+
+        // scratch space for countOccupancy
+        std::vector<int> histogram;
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // A uniform grid stored as flat arrays instead of linked lists: token
+    // positions are written to an unsorted array as they change, and before
+    // the first query after any change the grid is rebuilt by counting sort
+    // into per-cell ranges of contiguous positions and objects.  A query
+    // then scans, for each row of cells it overlaps, one contiguous run of
+    // memory.  Positions outside the grid's bounds are kept in the nearest
+    // edge cell, so queries anywhere are exact.
+    //
+    // The rebuild happens inside whichever query comes first, guarded so
+    // concurrent queries (as in the two-phase parallel update) are safe, and
+    // is skipped when no token has changed cell.  Updates must not run
+    // concurrently with queries.
+
+
+    template <class ContentType>
+    class GridProximityDatabase : public AbstractProximityDatabase<ContentType>
+    {
+    public:
+
+        // constructor: a box of the given center and dimensions, divided
+        // into the given number of cells along each axis
+        GridProximityDatabase (const Vec3& center,
+                               const Vec3& dimensions,
+                               const Vec3& divisions)
+            : tokenPool (64, MemoryAccount::tokenMemory),
+              origin (center - (dimensions * 0.5f)),
+              divx (std::max (1, (int) round (divisions.x))),
+              divy (std::max (1, (int) round (divisions.y))),
+              divz (std::max (1, (int) round (divisions.z))),
+              inverseCellSize (divx / dimensions.x,
+                               divy / dimensions.y,
+                               divz / dimensions.z),
+              cellStart (divx * divy * divz + 1, 0),
+              dirty (true)
+        {
+        }
+
+        // destructor
+        virtual ~GridProximityDatabase ()
+        {
+        }
+
+        // "token" to represent objects stored in the database (allocated
+        // in the database's pool)
+        class tokenType : public AbstractTokenForProximityDatabase<ContentType>,
+                          public PooledObject<tokenType>
+        {
+        public:
+
+            // constructor: append an entry for this token
+            tokenType (ContentType parentObject, GridProximityDatabase& pd)
+                : gpd (&pd), index (pd.tokens.size())
+            {
+                gpd->tokens.push_back (this);
+                gpd->objects.push_back (parentObject);
+                gpd->positions.push_back (Vec3::zero);
+                gpd->dirty = true;
+            }
+
+            // destructor: move the last entry into this token's slot
+            virtual ~tokenType ()
+            {
+                const size_t last = gpd->tokens.size() - 1;
+                if (index != last)
+                {
+                    gpd->tokens[index] = gpd->tokens[last];
+                    gpd->objects[index] = gpd->objects[last];
+                    gpd->positions.set (index, gpd->positions.get (last));
+                    gpd->tokens[index]->index = index;
+                }
+                gpd->tokens.pop_back ();
+                gpd->objects.pop_back ();
+                gpd->positions.pop_back ();
+                gpd->dirty = true;
+            }
+
+            // the client object calls this each time its position changes.
+            // While the grid is built a move within the same cell is applied
+            // to the sorted arrays in place, so only a change of cell makes
+            // the next query rebuild.
+            void updateForNewPosition (const Vec3& newPosition)
+            {
+                PhaseTimer::Scope timer (PhaseTimer::proximityUpdatePhase);
+                gpd->positions.set (index, newPosition);
+                const bool built = ! gpd->dirty.load (std::memory_order_relaxed);
+                if (built || gpd->getStatisticsEnabled ())
+                {
+                    const bool sameCell =
+                        (index < gpd->cellOfEntry.size()) &&
+                        (gpd->cellForPosition (newPosition) == gpd->cellOfEntry[index]);
+                    if (! sameCell)
+                        gpd->dirty = true;
+                    else if (built)
+                        gpd->sortedPositions.set (gpd->slotOfEntry[index], newPosition);
+                    gpd->countUpdates (1, sameCell ? 0 : 1);
+                }
+            }
+
+            // find all neighbors within the given sphere (as center and radius)
+            void findNeighbors (const Vec3& center,
+                                const float radius,
+                                std::vector<ContentType>& results)
+            {
+                PhaseTimer::Scope timer (PhaseTimer::neighborQueryPhase);
+                NeighborObjectSink<ContentType> sink (results);
+                gpd->scan (center, radius, sink);
+            }
+
+            // as above, with distances and offsets
+            void findNeighbors (const Vec3& center,
+                                const float radius,
+                                std::vector<NeighborRecord<ContentType> >& results)
+            {
+                PhaseTimer::Scope timer (PhaseTimer::neighborQueryPhase);
+                NeighborRecordSink<ContentType> sink (results);
+                gpd->scan (center, radius, sink);
+            }
+
+            // fixed capacity versions, into a caller owned array
+            size_t findNeighbors (const Vec3& center,
+                                  const float radius,
+                                  ContentType* results,
+                                  const size_t maxResults)
+            {
+                PhaseTimer::Scope timer (PhaseTimer::neighborQueryPhase);
+                NeighborCollector<ContentType> c (results, maxResults, false);
+                NeighborCollectorSink<ContentType> sink (c);
+                gpd->scan (center, radius, sink);
+                return c.count();
+            }
+
+            size_t findNearestNeighbors (const Vec3& center,
+                                         const float radius,
+                                         ContentType* results,
+                                         const size_t k)
+            {
+                PhaseTimer::Scope timer (PhaseTimer::neighborQueryPhase);
+                NeighborCollector<ContentType> c (results, k, true);
+                NeighborCollectorSink<ContentType> sink (c);
+                gpd->scan (center, radius, sink);
+                return c.count();
+            }
+
+#ifndef NO_LQ_BIN_STATS
+            // statistics about cell populations: min, max and average of
+            // non-empty cells
+            void getBinPopulationStats (int& min, int& max, float& average)
+            {
+                gpd->getCellPopulationStats (min, max, average);
+            }
+#endif // NO_LQ_BIN_STATS
+
+        private:
+            friend class GridProximityDatabase;
+            GridProximityDatabase* gpd;
+            size_t index;
+        };
+
+
+        // allocate a token to represent a given client object in this database
+        tokenType* allocateToken (ContentType parentObject)
+        {
+            return new (tokenPool) tokenType (parentObject, *this);
+        }
+
+        // make room for count more tokens
+        void reserveTokens (const size_t count)
+        {
+            tokenPool.reserve (count);
+            tokens.reserve (tokens.size() + count);
+            objects.reserve (objects.size() + count);
+            positions.reserve (positions.size() + count);
+        }
+
+        // return the number of tokens currently in the database
+        int getPopulation (void)
+        {
+            return (int) tokens.size();
+        }
+
+        // copy out the objects and their positions
+        void copyContents (std::vector<ContentType>& o, Vec3Batch& p)
+        {
+            o = objects;
+            p = positions;
+        }
+
+    protected:
+        void countOccupancy (std::vector<size_t>& occupancy, size_t&)
+        {
+            ensureBuilt ();
+            const int cellCount = divx * divy * divz;
+            for (int c = 0; c < cellCount; c++)
+                this->addToOccupancy (occupancy, cellStart[c + 1] - cellStart[c]);
+        }
+
+    private:
 
+        // storage of the tokens
+        ObjectPool<tokenType> tokenPool;
 
-    template <class ContentType>
-    class AbstractProximityDatabase
-    {
-    public:
+        // cell coordinate along one axis, clamped into the grid
+        static int clampedCell (const float p, const float o,
+                                const float inverseSize, const int div)
+        {
+            const float c = (p - o) * inverseSize;
+            if (c < 0) return 0;
+            if (c >= div) return div - 1;
+            return (int) c;
+        }
 
-        // type for the "tokens" manipulated by this spatial database
-        typedef AbstractTokenForProximityDatabase<ContentType> tokenType;
+        int cellIndex (const int ix, const int iy, const int iz) const
+        {
+            return (((ix * divy) + iy) * divz) + iz;
+        }
 
-        
-        virtual ~AbstractProximityDatabase() { /* Nothing to do? */ }
-        
-        // allocate a token to represent a given client object in this database
-        virtual tokenType* allocateToken (ContentType parentObject) = 0;
+        int cellForPosition (const Vec3& p) const
+        {
+            return cellIndex (clampedCell (p.x, origin.x, inverseCellSize.x, divx),
+                              clampedCell (p.y, origin.y, inverseCellSize.y, divy),
+                              clampedCell (p.z, origin.z, inverseCellSize.z, divz));
+        }
 
-        // insert
-        // XXX maybe this should return an iterator?
-        // XXX see http://www.sgi.com/tech/stl/set.html
-        // virtual void insert (const ContentType& x) = 0;
+        // rebuild the sorted arrays if any token changed since the last
+        // rebuild.  The first query after a change does this while any
+        // others wait.
+        void ensureBuilt (void)
+        {
+            if (! dirty.load (std::memory_order_acquire)) return;
+            std::lock_guard<std::mutex> lock (buildMutex);
+            if (! dirty.load (std::memory_order_relaxed)) return;
+            rebuild ();
+            dirty.store (false, std::memory_order_release);
+        }
 
-        // XXX name?
-        // returns the number of tokens in the proximity database
-        virtual int getPopulation (void) = 0;
+        // counting sort of all entries by cell
+        void rebuild (void)
+        {
+            const size_t count = tokens.size();
+            const int cellCount = divx * divy * divz;
+
+            cellOfEntry.resize (count);
+            slotOfEntry.resize (count);
+            std::fill (cellStart.begin(), cellStart.end(), 0);
+            for (size_t i = 0; i < count; i++)
+            {
+                const int c = cellForPosition (positions.get (i));
+                cellOfEntry[i] = c;
+                cellStart[c + 1]++;
+            }
+            for (int c = 0; c < cellCount; c++) cellStart[c + 1] += cellStart[c];
+
+            sortedPositions.resize (count);
+            sortedObjects.resize (count);
+            cellFill.assign (cellStart.begin(), cellStart.end() - 1);
+            for (size_t i = 0; i < count; i++)
+            {
+                const int slot = cellFill[cellOfEntry[i]]++;
+                slotOfEntry[i] = slot;
+                sortedPositions.set (slot, positions.get (i));
+                sortedObjects[slot] = objects[i];
+            }
+        }
+
+        // call sink for every entry within the sphere, visiting for each
+        // (x, y) row of overlapped cells the contiguous run of entries of
+        // the overlapped z cells
+        template <class Sink>
+        void scan (const Vec3& center, const float radius, Sink& sink)
+        {
+            ensureBuilt ();
+
+            const int x0 = clampedCell (center.x - radius, origin.x, inverseCellSize.x, divx);
+            const int x1 = clampedCell (center.x + radius, origin.x, inverseCellSize.x, divx);
+            const int y0 = clampedCell (center.y - radius, origin.y, inverseCellSize.y, divy);
+            const int y1 = clampedCell (center.y + radius, origin.y, inverseCellSize.y, divy);
+            const int z0 = clampedCell (center.z - radius, origin.z, inverseCellSize.z, divz);
+            const int z1 = clampedCell (center.z + radius, origin.z, inverseCellSize.z, divz);
+            const float r2 = radius * radius;
+
+            static thread_local std::vector<float> distances;
+
+            ProximityQueryCost cost;
+            cost.binsVisited = (x1 - x0 + 1) * (y1 - y0 + 1) * (z1 - z0 + 1);
+
+            for (int ix = x0; ix <= x1; ix++)
+            {
+                for (int iy = y0; iy <= y1; iy++)
+                {
+                    const int begin = cellStart[cellIndex (ix, iy, z0)];
+                    const int end = cellStart[cellIndex (ix, iy, z1) + 1];
+                    const int n = end - begin;
+                    if (n == 0) continue;
+                    cost.candidatesTested += n;
+
+                    if ((int) distances.size() < n) distances.resize (n);
+                    distanceSquaredMany (center,
+                                         &sortedPositions.x[begin],
+                                         &sortedPositions.y[begin],
+                                         &sortedPositions.z[begin],
+                                         n,
+                                         distances.data());
+
+                    for (int i = 0; i < n; i++)
+                    {
+                        if (distances[i] < r2)
+                        {
+                            const int j = begin + i;
+                            sink (sortedObjects[j],
+                                  distances[i],
+                                  sortedPositions.get (j) - center);
+                            cost.candidatesAccepted++;
+                        }
+                    }
+                }
+            }
+
+            this->countQuery (cost);
+        }
+
+#ifndef NO_LQ_BIN_STATS
+        void getCellPopulationStats (int& min, int& max, float& average)
+        {
+            ensureBuilt ();
+            const int cellCount = divx * divy * divz;
+            int nonEmpty = 0;
+            min = std::numeric_limits<int>::max();
+            max = 0;
+            for (int c = 0; c < cellCount; c++)
+            {
+                const int n = cellStart[c + 1] - cellStart[c];
+                if (n > 0)
+                {
+                    nonEmpty++;
+                    if (n < min) min = n;
+                    if (n > max) max = n;
+                }
+            }
+            if (nonEmpty == 0) min = 0;
+            average = nonEmpty ? ((float) tokens.size() / nonEmpty) : 0;
+        }
+#endif // NO_LQ_BIN_STATS
+
+        // grid geometry
+        const Vec3 origin;
+        const int divx, divy, divz;
+        const Vec3 inverseCellSize;
+
+        // entries in order of token creation (modulo removals)
+        std::vector<tokenType*> tokens;
+        std::vector<ContentType> objects;
+        Vec3Batch positions;
+
+        // entries sorted by cell: cell c holds [cellStart[c], cellStart[c+1])
+        std::vector<int> cellStart;
+        Vec3Batch sortedPositions;
+        std::vector<ContentType> sortedObjects;
+
+        // cell and sorted slot of each entry as of the last rebuild
+        std::vector<int> cellOfEntry;
+        std::vector<int> slotOfEntry;
+
+        // scratch space for rebuild
+        std::vector<int> cellFill;
+
+        // whether the sorted arrays are out of date
+        std::atomic<bool> dirty;
+        std::mutex buildMutex;
     };
 
 
     // ----------------------------------------------------------------------------
-    // This is the "brute force" O(n^2) approach implemented in terms of the
-    // AbstractProximityDatabase protocol so it can be compared directly to other
-    // approaches.  (e.g. the Boids plugin allows switching at runtime.)
+    // A proximity database over a SpatialHashIndex, so with no world bounds
+    // and memory scaling with occupied cells.  Token positions are written
+    // to an unsorted array as they change, and before the first query after
+    // any change the index is rebuilt.
+    //
+    // As for the grid, the rebuild happens inside whichever query comes
+    // first and is safe under concurrent queries, but updates must not run
+    // concurrently with queries.
 
 
     template <class ContentType>
-    class BruteForceProximityDatabase
+    class SpatialHashProximityDatabase
         : public AbstractProximityDatabase<ContentType>
     {
     public:
 
-        // constructor
-        BruteForceProximityDatabase (void)
+        // constructor: cubic cells of the given edge length
+        SpatialHashProximityDatabase (const float cellSize)
+            : tokenPool (64, MemoryAccount::tokenMemory),
+              cells (Vec3 (cellSize, cellSize, cellSize)),
+              dirty (true)
+        {
+        }
+
+        // constructor: cells of the given dimensions, for instance one tall
+        // layer of cells for a mostly planar world
+        SpatialHashProximityDatabase (const Vec3& cellSize)
+            : tokenPool (64, MemoryAccount::tokenMemory),
+              cells (cellSize),
+              dirty (true)
         {
         }
 
         // destructor
-        virtual ~BruteForceProximityDatabase ()
+        virtual ~SpatialHashProximityDatabase ()
         {
         }
 
-        // "token" to represent objects stored in the database
-        class tokenType : public AbstractTokenForProximityDatabase<ContentType>
+        // "token" to represent objects stored in the database (allocated
+        // in the database's pool)
+        class tokenType : public AbstractTokenForProximityDatabase<ContentType>,
+                          public PooledObject<tokenType>
         {
         public:
 
-            // constructor
-            tokenType (ContentType parentObject, BruteForceProximityDatabase& pd)
+            // constructor: append an entry for this token
+            tokenType (ContentType parentObject, SpatialHashProximityDatabase& pd)
+                : spd (&pd), index (pd.tokens.size())
             {
-                // store pointer to our associated database and the object this
-                // token represents, and store this token on the database's vector
-                bfpd = &pd;
-                object = parentObject;
-                bfpd->group.push_back (this);
+                spd->tokens.push_back (this);
+                spd->objects.push_back (parentObject);
+                spd->positions.push_back (Vec3::zero);
+                spd->dirty = true;
             }
 
-            // destructor
+            // destructor: move the last entry into this token's slot
             virtual ~tokenType ()
             {
-                // remove this token from the database's vector
-                bfpd->group.erase (std::find (bfpd->group.begin(),
-                                              bfpd->group.end(),
-                                              this));
+                const size_t last = spd->tokens.size() - 1;
+                if (index != last)
+                {
+                    spd->tokens[index] = spd->tokens[last];
+                    spd->objects[index] = spd->objects[last];
+                    spd->positions.set (index, spd->positions.get (last));
+                    spd->tokens[index]->index = index;
+                }
+                spd->tokens.pop_back ();
+                spd->objects.pop_back ();
+                spd->positions.pop_back ();
+                spd->dirty = true;
             }
 
-            // the client object calls this each time its position changes
+            // the client object calls this each time its position changes.
+            // As in GridProximityDatabase a move within the same cell is
+            // applied in place and only a change of cell forces a rebuild.
             void updateForNewPosition (const Vec3& newPosition)
             {
-                position = newPosition;
+                PhaseTimer::Scope timer (PhaseTimer::proximityUpdatePhase);
+                spd->positions.set (index, newPosition);
+                const bool built = ! spd->dirty.load (std::memory_order_relaxed);
+                if (built || spd->getStatisticsEnabled ())
+                {
+                    const bool sameCell =
+                        (index < spd->cells.size()) &&
+                        spd->cells.sameCell (index, newPosition);
+                    if (! sameCell)
+                        spd->dirty = true;
+                    else if (built)
+                        spd->cells.moveWithinCell (index, newPosition);
+                    spd->countUpdates (1, sameCell ? 0 : 1);
+                }
             }
 
             // find all neighbors within the given sphere (as center and radius)
@@ -165,170 +2368,442 @@ namespace OpenSteer {
                                 const float radius,
                                 std::vector<ContentType>& results)
             {
-                // loop over all tokens
-                const float r2 = radius * radius;
-                for (tokenIterator i = bfpd->group.begin();
-                     i != bfpd->group.end();
-                     i++)
-                {
-                    const Vec3 offset = center - (**i).position;
-                    const float d2 = offset.lengthSquared();
+                PhaseTimer::Scope timer (PhaseTimer::neighborQueryPhase);
+                NeighborObjectSink<ContentType> sink (results);
+                spd->scan (center, radius, sink);
+            }
 
-                    // push onto result vector when within given radius
-                    if (d2 < r2) results.push_back ((**i).object);
-                }
+            // as above, with distances and offsets
+            void findNeighbors (const Vec3& center,
+                                const float radius,
+                                std::vector<NeighborRecord<ContentType> >& results)
+            {
+                PhaseTimer::Scope timer (PhaseTimer::neighborQueryPhase);
+                NeighborRecordSink<ContentType> sink (results);
+                spd->scan (center, radius, sink);
+            }
+
+            // fixed capacity versions, into a caller owned array
+            size_t findNeighbors (const Vec3& center,
+                                  const float radius,
+                                  ContentType* results,
+                                  const size_t maxResults)
+            {
+                PhaseTimer::Scope timer (PhaseTimer::neighborQueryPhase);
+                NeighborCollector<ContentType> c (results, maxResults, false);
+                NeighborCollectorSink<ContentType> sink (c);
+                spd->scan (center, radius, sink);
+                return c.count();
+            }
+
+            size_t findNearestNeighbors (const Vec3& center,
+                                         const float radius,
+                                         ContentType* results,
+                                         const size_t k)
+            {
+                PhaseTimer::Scope timer (PhaseTimer::neighborQueryPhase);
+                NeighborCollector<ContentType> c (results, k, true);
+                NeighborCollectorSink<ContentType> sink (c);
+                spd->scan (center, radius, sink);
+                return c.count();
+            }
+
+#ifndef NO_LQ_BIN_STATS
+            // statistics about cell populations: min, max and average of
+            // occupied cells
+            void getBinPopulationStats (int& min, int& max, float& average)
+            {
+                spd->ensureBuilt ();
+                spd->cells.getCellPopulationStats (min, max, average);
             }
+#endif // NO_LQ_BIN_STATS
 
         private:
-            BruteForceProximityDatabase* bfpd;
-            ContentType object;
-            Vec3 position;
+            friend class SpatialHashProximityDatabase;
+            SpatialHashProximityDatabase* spd;
+            size_t index;
         };
 
-        typedef std::vector<tokenType*> tokenVector;
-        typedef typename tokenVector::const_iterator tokenIterator;    
 
         // allocate a token to represent a given client object in this database
         tokenType* allocateToken (ContentType parentObject)
         {
-            return new tokenType (parentObject, *this);
+            return new (tokenPool) tokenType (parentObject, *this);
+        }
+
+        // make room for count more tokens
+        void reserveTokens (const size_t count)
+        {
+            tokenPool.reserve (count);
+            tokens.reserve (tokens.size() + count);
+            objects.reserve (objects.size() + count);
+            positions.reserve (positions.size() + count);
         }
 
         // return the number of tokens currently in the database
         int getPopulation (void)
         {
-            return (int) group.size();
+            return (int) tokens.size();
         }
-        
+
+        // number of occupied cells as of the last rebuild
+        int getOccupiedCellCount (void)
+        {
+            ensureBuilt ();
+            return cells.getOccupiedCellCount ();
+        }
+
+        // copy out the objects and their positions
+        void copyContents (std::vector<ContentType>& o, Vec3Batch& p)
+        {
+            o = objects;
+            p = positions;
+        }
+
+    protected:
+        void countOccupancy (std::vector<size_t>& occupancy, size_t&)
+        {
+            ensureBuilt ();
+            cells.countOccupancy (occupancy);
+        }
+
     private:
-        // STL vector containing all tokens in database
-        tokenVector group;
+
+        // storage of the tokens
+        ObjectPool<tokenType> tokenPool;
+
+        // rebuild the cells if any token changed since the last rebuild.
+        // The first query after a change does this while any others wait.
+        void ensureBuilt (void)
+        {
+            if (! dirty.load (std::memory_order_acquire)) return;
+            std::lock_guard<std::mutex> lock (buildMutex);
+            if (! dirty.load (std::memory_order_relaxed)) return;
+            cells.build (objects, positions);
+            dirty.store (false, std::memory_order_release);
+        }
+
+        template <class Sink>
+        void scan (const Vec3& center, const float radius, Sink& sink)
+        {
+            ensureBuilt ();
+            ProximityQueryCost cost;
+            cells.scan (center, radius, sink, cost);
+            this->countQuery (cost);
+        }
+
+        // entries in order of token creation (modulo removals)
+        std::vector<tokenType*> tokens;
+        std::vector<ContentType> objects;
+        Vec3Batch positions;
+
+        // the entries sorted by cell as of the last rebuild
+        SpatialHashIndex<ContentType> cells;
+
+        // whether the cells are out of date
+        std::atomic<bool> dirty;
+        std::mutex buildMutex;
     };
 
 
     // ----------------------------------------------------------------------------
-    // A AbstractProximityDatabase-style wrapper for the LQ bin lattice system
+    // A proximity database made of up to 32 layers, each a database of its
+    // own (of any kind), holding the objects of one kind: say the enemies
+    // in one layer and the teammates in another.  Every token is in one
+    // layer, and queries name the layers to search with a bit mask
+    // (findNeighborsInLayers), so the objects of the other layers are
+    // never scanned.  The plain queries search all layers.
+    //
+    // Query statistics are kept by the layers (see layer), the occupancy
+    // histogram adds up theirs.
 
 
     template <class ContentType>
-    class LQProximityDatabase : public AbstractProximityDatabase<ContentType>
+    class LayeredProximityDatabase
+        : public AbstractProximityDatabase<ContentType>
     {
     public:
 
-        // constructor
-        LQProximityDatabase (const Vec3& center,
-                             const Vec3& dimensions,
-                             const Vec3& divisions)
+        typedef AbstractProximityDatabase<ContentType> layerType;
+
+        // constructor: takes ownership of the layers, from one to 32 of
+        // them, layer i being layers[i]
+        LayeredProximityDatabase (const std::vector<layerType*>& layers)
+            : layers (layers),
+              members (layers.size ()),
+              tokenPool (64, MemoryAccount::tokenMemory)
         {
-            const Vec3 halfsize (dimensions * 0.5f);
-            const Vec3 origin (center - halfsize);
+            assert ((layers.size () > 0) && (layers.size () <= 32));
+        }
 
-            lq = lqCreateDatabase (origin.x, origin.y, origin.z, 
-                                   dimensions.x, dimensions.y, dimensions.z,  
-                                   (int) round (divisions.x),
-                                   (int) round (divisions.y),
-                                   (int) round (divisions.z));
+        // destructor (delete the tokens first, as for any database)
+        virtual ~LayeredProximityDatabase ()
+        {
+            for (size_t i = 0; i < layers.size (); i++) delete layers[i];
         }
 
-        // destructor
-        virtual ~LQProximityDatabase ()
+        // mask for queries of one layer, and of all of them
+        static unsigned int layerBit (const int layer) {return 1u << layer;}
+        unsigned int allLayers (void) const
         {
-            lqDeleteDatabase (lq);
-            lq = NULL;
+            return (layers.size () == 32) ?
+                ~0u : (layerBit ((int) layers.size ()) - 1);
         }
 
-        // "token" to represent objects stored in the database
-        class tokenType : public AbstractTokenForProximityDatabase<ContentType>
+        int getLayerCount (void) const {return (int) layers.size ();}
+        layerType& layer (const int i) {return *layers[i];}
+
+        // "token" to represent objects stored in the database: a token of
+        // its layer's database, replaced when the object changes layers
+        class tokenType : public AbstractTokenForProximityDatabase<ContentType>,
+                          public PooledObject<tokenType>
         {
         public:
 
             // constructor
-            tokenType (ContentType parentObject, LQProximityDatabase& lqsd)
+            tokenType (ContentType parentObject,
+                       LayeredProximityDatabase& pd,
+                       const int layer)
+                : object (parentObject),
+                  lpd (&pd),
+                  layerIndex (-1),
+                  inner (NULL),
+                  placed (false)
             {
-                lqInitClientProxy (&proxy, parentObject);
-                lq = lqsd.lq;
+                setLayer (layer);
             }
 
             // destructor
-            virtual ~tokenType (void)
+            virtual ~tokenType ()
             {
-                lqRemoveFromBin (&proxy);
+                leaveLayer ();
+            }
+
+            // move the object to another layer, keeping its position
+            void setLayer (const int layer)
+            {
+                assert ((layer >= 0) && (layer < lpd->getLayerCount ()));
+                if (layer == layerIndex) return;
+                leaveLayer ();
+                layerIndex = layer;
+                std::vector<tokenType*>& m = lpd->members[layerIndex];
+                memberIndex = m.size ();
+                m.push_back (this);
+                inner = lpd->layers[layerIndex]->allocateToken (object);
+                if (placed) inner->updateForNewPosition (position);
             }
 
+            int getLayer (void) const {return layerIndex;}
+
             // the client object calls this each time its position changes
-            void updateForNewPosition (const Vec3& p)
+            void updateForNewPosition (const Vec3& newPosition)
             {
-                lqUpdateForNewLocation (lq, &proxy, p.x, p.y, p.z);
+                position = newPosition;
+                placed = true;
+                inner->updateForNewPosition (newPosition);
             }
 
-            // find all neighbors within the given sphere (as center and radius)
+            // queries of all layers
             void findNeighbors (const Vec3& center,
                                 const float radius,
                                 std::vector<ContentType>& results)
             {
-                lqMapOverAllObjectsInLocality (lq, 
-                                               center.x, center.y, center.z,
-                                               radius,
-                                               perNeighborCallBackFunction,
-                                               (void*)&results);
+                findNeighborsInLayers (center, radius, lpd->allLayers (), results);
             }
 
-            // called by LQ for each clientObject in the specified neighborhood:
-            // push that clientObject onto the ContentType vector in void*
-            // clientQueryState
-            // (parameter names commented out to prevent compiler warning from "-W")
-            static void perNeighborCallBackFunction  (void* clientObject,
-                                                      float /*distanceSquared*/,
-                                                      void* clientQueryState)
+            void findNeighbors (const Vec3& center,
+                                const float radius,
+                                std::vector<NeighborRecord<ContentType> >& results)
             {
-                typedef std::vector<ContentType> ctv;
-                ctv& results = *((ctv*) clientQueryState);
-                results.push_back ((ContentType) clientObject);
+                findNeighborsInLayers (center, radius, lpd->allLayers (), results);
             }
 
-#ifndef NO_LQ_BIN_STATS
-            // Get statistics about bin populations: min, max and
-            // average of non-empty bins.
-            void getBinPopulationStats (int& min, int& max, float& average)
+            size_t findNeighbors (const Vec3& center,
+                                  const float radius,
+                                  ContentType* results,
+                                  const size_t maxResults)
             {
-                lqGetBinPopulationStats (lq, &min, &max, &average);
+                return findNeighborsInLayers (center, radius, lpd->allLayers (),
+                                              results, maxResults);
+            }
+
+            // the nearest of all layers: each layer's neighbors with their
+            // distances, the nearest k of them kept
+            size_t findNearestNeighbors (const Vec3& center,
+                                         const float radius,
+                                         ContentType* results,
+                                         const size_t k)
+            {
+                static thread_local std::vector<NeighborRecord<ContentType> > records;
+                records.clear ();
+                findNeighborsInLayers (center, radius, lpd->allLayers (), records);
+                NeighborCollector<ContentType> c (results, k, true);
+                for (size_t i = 0; i < records.size (); i++)
+                    c.add (records[i].object, records[i].distanceSquared);
+                return c.count ();
+            }
+
+            // queries of the layers in the mask, through a token of each
+            // (layers without tokens are empty)
+            void findNeighborsInLayers (const Vec3& center,
+                                        const float radius,
+                                        const unsigned int layerMask,
+                                        std::vector<ContentType>& results)
+            {
+                for (int i = 0; i < lpd->getLayerCount (); i++)
+                {
+                    AbstractTokenForProximityDatabase<ContentType>* const t =
+                        lpd->queryToken (i, layerMask);
+                    if (t) t->findNeighbors (center, radius, results);
+                }
+            }
+
+            void findNeighborsInLayers (const Vec3& center,
+                                        const float radius,
+                                        const unsigned int layerMask,
+                                        std::vector<NeighborRecord<ContentType> >& results)
+            {
+                for (int i = 0; i < lpd->getLayerCount (); i++)
+                {
+                    AbstractTokenForProximityDatabase<ContentType>* const t =
+                        lpd->queryToken (i, layerMask);
+                    if (t) t->findNeighbors (center, radius, results);
+                }
+            }
+
+            size_t findNeighborsInLayers (const Vec3& center,
+                                          const float radius,
+                                          const unsigned int layerMask,
+                                          ContentType* results,
+                                          const size_t maxResults)
+            {
+                size_t count = 0;
+                for (int i = 0; (i < lpd->getLayerCount ()) && (count < maxResults); i++)
+                {
+                    AbstractTokenForProximityDatabase<ContentType>* const t =
+                        lpd->queryToken (i, layerMask);
+                    if (t) count += t->findNeighbors (center, radius,
+                                                      results + count,
+                                                      maxResults - count);
+                }
+                return count;
             }
-#endif // NO_LQ_BIN_STATS
 
         private:
-            lqClientProxy proxy;
-            lqDB* lq;
-        };
+            friend class LayeredProximityDatabase;
 
+            // delete the layer's token, and move the layer's last member
+            // into this one's place
+            void leaveLayer (void)
+            {
+                if (layerIndex < 0) return;
+                delete inner;
+                inner = NULL;
+                std::vector<tokenType*>& m = lpd->members[layerIndex];
+                m[memberIndex] = m.back ();
+                m[memberIndex]->memberIndex = memberIndex;
+                m.pop_back ();
+                layerIndex = -1;
+            }
 
-        // allocate a token to represent a given client object in this database
+            ContentType object;
+            LayeredProximityDatabase* lpd;
+            int layerIndex;
+            size_t memberIndex;
+            AbstractTokenForProximityDatabase<ContentType>* inner;
+            Vec3 position;
+            bool placed;
+        };
+
+        // allocate a token to represent a given client object, in layer 0
+        // or in the given layer
         tokenType* allocateToken (ContentType parentObject)
         {
-            return new tokenType (parentObject, *this);
+            return allocateToken (parentObject, 0);
         }
 
-        // count the number of tokens currently in the database
+        tokenType* allocateToken (ContentType parentObject, const int layer)
+        {
+            return new (tokenPool) tokenType (parentObject, *this, layer);
+        }
+
+        // make room for count more tokens
+        void reserveTokens (const size_t count)
+        {
+            tokenPool.reserve (count);
+        }
+
+        // return the number of tokens currently in the database
         int getPopulation (void)
         {
-            int count = 0;
-            lqMapOverAllObjects (lq, counterCallBackFunction, &count);
-            return count;
+            int population = 0;
+            for (size_t i = 0; i < layers.size (); i++)
+                population += layers[i]->getPopulation ();
+            return population;
         }
-        
-        // (parameter names commented out to prevent compiler warning from "-W")
-        static void counterCallBackFunction  (void* /*clientObject*/,
-                                              float /*distanceSquared*/,
-                                              void* clientQueryState)
+
+        void maintain (void)
         {
-            int& counter = *(int*)clientQueryState;
-            counter++;
+            for (size_t i = 0; i < layers.size (); i++) layers[i]->maintain ();
+        }
+
+        // copy out the objects and their positions, layer by layer
+        void copyContents (std::vector<ContentType>& o, Vec3Batch& p)
+        {
+            o.clear ();
+            p.clear ();
+            std::vector<ContentType> layerObjects;
+            Vec3Batch layerPositions;
+            for (size_t i = 0; i < layers.size (); i++)
+            {
+                layers[i]->copyContents (layerObjects, layerPositions);
+                for (size_t j = 0; j < layerObjects.size (); j++)
+                {
+                    o.push_back (layerObjects[j]);
+                    p.push_back (layerPositions.get (j));
+                }
+            }
         }
 
+    protected:
+        // the bins of every layer
+        void countOccupancy (std::vector<size_t>& occupancy,
+                             size_t& outsideBinPopulation)
+        {
+            ProximityStatistics statistics;
+            for (size_t i = 0; i < layers.size (); i++)
+            {
+                layers[i]->getStatistics (statistics, occupancy.size ());
+                for (size_t j = 0; j < occupancy.size (); j++)
+                    occupancy[j] += statistics.occupancy[j];
+                outsideBinPopulation += statistics.outsideBinPopulation;
+            }
+        }
 
     private:
-        lqDB* lq;
+        // a token to query layer i through, if the mask selects it and it
+        // has any tokens
+        AbstractTokenForProximityDatabase<ContentType>*
+        queryToken (const int i, const unsigned int layerMask) const
+        {
+            if (! (layerMask & layerBit (i)) || members[i].empty ()) return NULL;
+            return members[i][0]->inner;
+        }
+
+        std::vector<layerType*> layers;
+
+        // the tokens in each layer
+        std::vector<std::vector<tokenType*> > members;
+
+        // storage of the tokens
+        ObjectPool<tokenType> tokenPool;
+
+        // not copyable
+        LayeredProximityDatabase (const LayeredProximityDatabase&);
+        LayeredProximityDatabase& operator= (const LayeredProximityDatabase&);
     };
 
+
 } // namespace OpenSteer
 
 
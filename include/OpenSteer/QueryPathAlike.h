@@ -37,6 +37,12 @@
 // Include std::numeric_limits< float >::max
 #include <limits>
 
+// Include std::min
+#include <algorithm>
+
+// Include size_t
+#include <cstddef>
+
 
 
 // Include OpenSteer::Vec3
@@ -51,6 +57,13 @@
 // Include OpenSteer::PointToPathAlikeBaseDataExtractionPolicy, OpenSteer::DistanceToPathAlikeBaseDataExtractionPolicy
 #include "OpenSteer/QueryPathAlikeBaseDataExtractionPolicies.h"
 
+#include "OpenSteer/SegmentedPathIndex.h"
+
+#include "OpenSteer/PathCursor.h"
+
+// Include OpenSteer::WorkerPool
+#include "OpenSteer/WorkerPool.h"
+
 #ifdef _MSC_VER
 #undef min
 #undef max
@@ -132,6 +145,83 @@ namespace OpenSteer {
             }
         }
         
+        /**
+         * Like @c map but only tests the segments @a index can't rule out.
+         * The mapping is identical, @a index must have been built for
+         * @a pathAlike. Falls back to testing all segments if @a index is
+         * empty.
+         */
+        static void map( PathAlike const& pathAlike, SegmentedPathIndex const& index, Vec3 const& queryPoint, Mapping& mapping ) {
+            PathCursor cursor;
+            map( pathAlike, index, queryPoint, mapping, cursor );
+        }
+        
+        /**
+         * Like the indexed @c map but starting the search at the segment 
+         * @a cursor found last and storing the segment found in it.
+         */
+        static void map( PathAlike const& pathAlike, SegmentedPathIndex const& index, Vec3 const& queryPoint, Mapping& mapping, PathCursor& cursor ) {
+            if ( index.empty() ) {
+                map( pathAlike, queryPoint, mapping );
+                return;
+            }
+            
+            mapping.setDistanceOnPathFlag( 0.0f );
+            
+            typedef typename PathAlike::size_type size_type;
+            size_type const hint = cursor.valid() ? cursor.segmentIndex() : index.segmentCount();
+            size_type const segmentIndex = index.nearestSegment( queryPoint, SegmentMetric( pathAlike, queryPoint ), hint );
+            if ( segmentIndex == index.segmentCount() ) {
+                return;
+            }
+            cursor.setSegmentIndex( segmentIndex );
+            
+            float segmentDistance = 0.0f;
+            float radius = 0.0f;
+            float distancePointToPath = 0.0f;
+            Vec3 pointOnPathCenterLine( 0.0f, 0.0f, 0.0f );
+            Vec3 tangent( 0.0f, 0.0f, 0.0f );
+            
+            BaseDataExtractionPolicy::extract( pathAlike, segmentIndex, queryPoint, segmentDistance, radius, distancePointToPath, pointOnPathCenterLine, tangent );
+            
+            mapping.setDistanceOnPathFlag( pathAlike.segmentStartDistance( segmentIndex ) );
+            mapping.setPointOnPathCenterLine( pointOnPathCenterLine );
+            mapping.setPointOnPathBoundary( pointOnPathCenterLine + ( ( queryPoint - pointOnPathCenterLine ).normalize() * radius ) );
+            mapping.setRadius( radius );
+            mapping.setTangent( tangent );
+            mapping.setSegmentIndex( segmentIndex );
+            mapping.setDistancePointToPath( distancePointToPath );
+            mapping.setDistancePointToPathCenterLine( distancePointToPath + radius );
+            mapping.setDistanceOnPath( mapping.distanceOnPathFlag() + segmentDistance );
+            mapping.setDistanceOnSegment( segmentDistance );
+        }
+        
+    private:
+        
+        /**
+         * Distance of the query point to a segment's pathway boundary, the
+         * value @c map minimizes.
+         */
+        class SegmentMetric {
+        public:
+            SegmentMetric( PathAlike const& pathAlike, Vec3 const& queryPoint ) 
+                : pathAlike_( pathAlike ), queryPoint_( queryPoint ) {}
+            
+            float operator()( typename PathAlike::size_type segmentIndex ) const {
+                float segmentDistance = 0.0f;
+                float radius = 0.0f;
+                float distancePointToPath = 0.0f;
+                Vec3 pointOnPathCenterLine( 0.0f, 0.0f, 0.0f );
+                Vec3 tangent( 0.0f, 0.0f, 0.0f );
+                BaseDataExtractionPolicy::extract( pathAlike_, segmentIndex, queryPoint_, segmentDistance, radius, distancePointToPath, pointOnPathCenterLine, tangent );
+                return distancePointToPath;
+            }
+            
+        private:
+            PathAlike const& pathAlike_;
+            Vec3 const& queryPoint_;
+        }; // class SegmentMetric
+        
     }; // class PointToPathAlikeMapping
     
     /**
@@ -145,6 +235,212 @@ namespace OpenSteer {
         PointToPathAlikeMapping< PathAlike, Mapping >::map( pathAlike, point, mapping );
     }
     
+    /**
+     * Maps @a point to @a pathAlike using the segment index @a index built
+     * for it and returns the data extracted in @a mapping.
+     *
+     * See @c MapPointToPathAlike::map for further information.
+     */
+    template< class PathAlike, class Mapping >
+    void mapPointToPathAlike( PathAlike const& pathAlike, SegmentedPathIndex const& index, Vec3 const& point, Mapping& mapping ) {
+        PointToPathAlikeMapping< PathAlike, Mapping >::map( pathAlike, index, point, mapping );
+    }
+    
+    /**
+     * Maps @a point to @a pathAlike using the segment index @a index and the
+     * hint of @a cursor, which is updated.
+     *
+     * See @c MapPointToPathAlike::map for further information.
+     */
+    template< class PathAlike, class Mapping >
+    void mapPointToPathAlike( PathAlike const& pathAlike, SegmentedPathIndex const& index, Vec3 const& point, Mapping& mapping, PathCursor& cursor ) {
+        PointToPathAlikeMapping< PathAlike, Mapping >::map( pathAlike, index, point, mapping, cursor );
+    }
+    
+    
+    /**
+     * Maps arrays of points to a path alike. Loops over the segments in the
+     * outer loop and over a block of points in the inner one, which the
+     * compiler can vectorize, instead of looping over all segments for each
+     * point.
+     *
+     * The mapping stored in @c mappings[ i ] is the one 
+     * @c PointToPathAlikeMapping::map returns for @c queryPoints[ i ]
+     * (built without fast math both compute the same closest segment bit for
+     * bit). @c Mapping must provide the member functions listed there.
+     *
+     * Segment start, tangent and radius are queried once per segment via
+     * @c SegmentBaseDataExtractionPolicy at segment distance zero, so the
+     * radius must be constant along each segment, which holds for all 
+     * polyline path alikes.
+     *
+     * For long paths with an enabled segment index mapping the points one
+     * by one with the index is faster, the batch pays off for short paths
+     * and many points.
+     */
+    template< class PathAlike, class Mapping, class PointBaseDataExtractionPolicy = PointToPathAlikeBaseDataExtractionPolicy< PathAlike >, class SegmentBaseDataExtractionPolicy = DistanceToPathAlikeBaseDataExtractionPolicy< PathAlike > >
+    class PointsToPathAlikeMapping {
+    public:
+        
+        /**
+         * Number of points mapped together per pass over the segments.
+         */
+        enum { blockSize = 64 };
+        
+        /**
+         * Below this number of points the pool overload doesn't split work.
+         */
+        enum { minParallelPointCount = 8 * blockSize };
+        
+        /**
+         * Maps the @a pointCount points of @a queryPoints to @a pathAlike and
+         * stores the queried data in the elements of @a mappings.
+         */
+        static void map( PathAlike const& pathAlike, Vec3 const queryPoints[], size_t pointCount, Mapping mappings[] ) {
+            for ( size_t first = 0; first < pointCount; first += blockSize ) {
+                size_t const count = std::min( static_cast< size_t >( blockSize ), pointCount - first );
+                mapBlock( pathAlike, queryPoints + first, count, mappings + first );
+            }
+        }
+        
+        /**
+         * Like @c map but splits the blocks of points across @a pool if there
+         * are at least @c minParallelPointCount points.
+         */
+        static void map( PathAlike const& pathAlike, Vec3 const queryPoints[], size_t pointCount, Mapping mappings[], WorkerPool& pool ) {
+            if ( ( pointCount < minParallelPointCount ) || ( pool.threadCount() < 2 ) ) {
+                map( pathAlike, queryPoints, pointCount, mappings );
+                return;
+            }
+            
+            BlockRange range( pathAlike, queryPoints, pointCount, mappings );
+            pool.parallelFor( ( pointCount + blockSize - 1 ) / blockSize, range );
+        }
+        
+    private:
+        
+        /**
+         * Maps up to @c blockSize points.
+         */
+        static void mapBlock( PathAlike const& pathAlike, Vec3 const queryPoints[], size_t pointCount, Mapping mappings[] ) {
+            typedef typename PathAlike::size_type size_type;
+            size_type const segmentCount = pathAlike.segmentCount();
+            
+            float x[ blockSize ];
+            float y[ blockSize ];
+            float z[ blockSize ];
+            float minDistancePointToPath[ blockSize ];
+            float distanceOnPathFlag[ blockSize ];
+            size_type closestSegmentIndex[ blockSize ];
+            for ( size_t i = 0; i < pointCount; ++i ) {
+                x[ i ] = queryPoints[ i ].x;
+                y[ i ] = queryPoints[ i ].y;
+                z[ i ] = queryPoints[ i ].z;
+                minDistancePointToPath[ i ] = std::numeric_limits< float >::max();
+                distanceOnPathFlag[ i ] = 0.0f;
+                closestSegmentIndex[ i ] = segmentCount;
+            }
+            
+            float segmentStartDistance = 0.0f;
+            for ( size_type segmentIndex = 0; segmentIndex < segmentCount; ++segmentIndex ) {
+                
+                Vec3 start( 0.0f, 0.0f, 0.0f );
+                Vec3 tangent( 0.0f, 0.0f, 0.0f );
+                float radius = 0.0f;
+                SegmentBaseDataExtractionPolicy::extract( pathAlike, segmentIndex, 0.0f, start, tangent, radius );
+                float const segmentLength = pathAlike.segmentLength( segmentIndex );
+                
+                // Same operations in the same order as the per point 
+                // extraction to select the same segment.
+                for ( size_t i = 0; i < pointCount; ++i ) {
+                    float segmentDistance = ( x[ i ] - start.x ) * tangent.x + ( y[ i ] - start.y ) * tangent.y + ( z[ i ] - start.z ) * tangent.z;
+                    segmentDistance = clamp( segmentDistance, 0.0f, segmentLength );
+                    float const dx = x[ i ] - ( tangent.x * segmentDistance + start.x );
+                    float const dy = y[ i ] - ( tangent.y * segmentDistance + start.y );
+                    float const dz = z[ i ] - ( tangent.z * segmentDistance + start.z );
+                    float const distancePointToPath = sqrtXXX( dx * dx + dy * dy + dz * dz ) - radius;
+                    
+                    bool const closer = distancePointToPath < minDistancePointToPath[ i ];
+                    minDistancePointToPath[ i ] = closer ? distancePointToPath : minDistancePointToPath[ i ];
+                    distanceOnPathFlag[ i ] = closer ? segmentStartDistance : distanceOnPathFlag[ i ];
+                    closestSegmentIndex[ i ] = closer ? segmentIndex : closestSegmentIndex[ i ];
+                }
+                
+                segmentStartDistance += segmentLength;
+            }
+            
+            for ( size_t i = 0; i < pointCount; ++i ) {
+                Mapping& mapping = mappings[ i ];
+                mapping.setDistanceOnPathFlag( distanceOnPathFlag[ i ] );
+                
+                size_type const segmentIndex = closestSegmentIndex[ i ];
+                if ( segmentIndex == segmentCount ) {
+                    continue;
+                }
+                
+                Vec3 const& queryPoint = queryPoints[ i ];
+                float segmentDistance = 0.0f;
+                float radius = 0.0f;
+                float distancePointToPath = 0.0f;
+                Vec3 pointOnPathCenterLine( 0.0f, 0.0f, 0.0f );
+                Vec3 tangent( 0.0f, 0.0f, 0.0f );
+                
+                PointBaseDataExtractionPolicy::extract( pathAlike, segmentIndex, queryPoint, segmentDistance, radius, distancePointToPath, pointOnPathCenterLine, tangent );
+                
+                mapping.setPointOnPathCenterLine( pointOnPathCenterLine );
+                mapping.setPointOnPathBoundary( pointOnPathCenterLine + ( ( queryPoint - pointOnPathCenterLine ).normalize() * radius ) );
+                mapping.setRadius( radius );
+                mapping.setTangent( tangent );
+                mapping.setSegmentIndex( segmentIndex );
+                mapping.setDistancePointToPath( distancePointToPath );
+                mapping.setDistancePointToPathCenterLine( distancePointToPath + radius );
+                mapping.setDistanceOnPath( mapping.distanceOnPathFlag() + segmentDistance );
+                mapping.setDistanceOnSegment( segmentDistance );
+            }
+        }
+        
+        /**
+         * @c WorkerPool body mapping the points of a range of blocks.
+         */
+        class BlockRange {
+        public:
+            BlockRange( PathAlike const& pathAlike, Vec3 const queryPoints[], size_t pointCount, Mapping mappings[] )
+                : pathAlike_( pathAlike ), queryPoints_( queryPoints ), pointCount_( pointCount ), mappings_( mappings ) {}
+            
+            void operator()( size_t beginBlock, size_t endBlock ) const {
+                size_t const first = beginBlock * blockSize;
+                size_t const last = std::min( endBlock * blockSize, pointCount_ );
+                PointsToPathAlikeMapping::map( pathAlike_, queryPoints_ + first, last - first, mappings_ + first );
+            }
+            
+        private:
+            PathAlike const& pathAlike_;
+            Vec3 const* queryPoints_;
+            size_t pointCount_;
+            Mapping* mappings_;
+        }; // class BlockRange
+        
+    }; // class PointsToPathAlikeMapping
+    
+    /**
+     * Maps the @a pointCount points of @a points to @a pathAlike and stores 
+     * the data extracted in the elements of @a mappings.
+     *
+     * See @c PointsToPathAlikeMapping::map for further information.
+     */
+    template< class PathAlike, class Mapping >
+    void mapPointsToPathAlike( PathAlike const& pathAlike, Vec3 const points[], size_t pointCount, Mapping mappings[] ) {
+        PointsToPathAlikeMapping< PathAlike, Mapping >::map( pathAlike, points, pointCount, mappings );
+    }
+    
+    /**
+     * Like @c mapPointsToPathAlike but splits many points across @a pool.
+     */
+    template< class PathAlike, class Mapping >
+    void mapPointsToPathAlike( PathAlike const& pathAlike, Vec3 const points[], size_t pointCount, Mapping mappings[], WorkerPool& pool ) {
+        PointsToPathAlikeMapping< PathAlike, Mapping >::map( pathAlike, points, pointCount, mappings, pool );
+    }
+    
         
     
     /**
@@ -208,6 +504,46 @@ namespace OpenSteer {
             mapping.setDistanceOnSegment( remainingDistance );            
         }
         
+        /**
+         * Like @c map for path alikes that store the distance to every 
+         * segment start. Their member functions 
+         * <code> float segmentStartDistance( size_type ) const </code> and
+         * <code> size_type segmentIndexAtDistance( float, size_type ) const </code>
+         * find the segment reached by @a distanceOnPath by binary search, or
+         * by walking from the segment @a cursor found last. The segment found
+         * is stored in @a cursor.
+         *
+         * The distance on the segment is computed from the stored segment
+         * start instead of subtracting segment lengths one by one and may 
+         * differ from that of the linear @c map by rounding.
+         */
+        static void map( PathAlike const& pathAlike, float distanceOnPath, Mapping& mapping, PathCursor& cursor ) {
+            float const pathLength = pathAlike.length();
+            
+            if ( pathAlike.isCyclic() ) {
+                distanceOnPath = modulo( distanceOnPath, pathLength );       
+            }
+            distanceOnPath = clamp( distanceOnPath, 0.0f, pathLength );
+            
+            typedef typename PathAlike::size_type size_type;
+            size_type const hint = cursor.valid() ? cursor.segmentIndex() : pathAlike.segmentCount();
+            size_type const segmentIndex = pathAlike.segmentIndexAtDistance( distanceOnPath, hint );
+            cursor.setSegmentIndex( segmentIndex );
+            float const remainingDistance = distanceOnPath - pathAlike.segmentStartDistance( segmentIndex );
+            
+            Vec3 pointOnPathCenterLine( 0.0f, 0.0f, 0.0f );
+            Vec3 tangent( 0.0f, 0.0f, 0.0f );
+            float radius = 0.0f;
+            BaseDataExtractionPolicy::extract( pathAlike, segmentIndex, remainingDistance, pointOnPathCenterLine, tangent, radius );
+            
+            mapping.setPointOnPathCenterLine( pointOnPathCenterLine );
+            mapping.setRadius( radius );
+            mapping.setTangent( tangent );
+            mapping.setSegmentIndex( segmentIndex );
+            mapping.setDistanceOnPath( distanceOnPath );
+            mapping.setDistanceOnSegment( remainingDistance );
+        }
+        
     }; // class DistanceToPathAlikeMapping
     
     
@@ -223,6 +559,106 @@ namespace OpenSteer {
         DistanceToPathAlikeMapping< PathAlike, Mapping >::map( pathAlike, distance, mapping );
     }
     
+    /**
+     * Maps @a distance to @a pathAlike using the segment start distances it
+     * stores and the hint of @a cursor, which is updated.
+     *
+     * See @c DistanceToPathAlikeMapping::map for further information.
+     */
+    template< class PathAlike, class Mapping >
+    void mapDistanceToPathAlike( PathAlike const& pathAlike, float distance, Mapping& mapping, PathCursor& cursor ) {
+        DistanceToPathAlikeMapping< PathAlike, Mapping >::map( pathAlike, distance, mapping, cursor );
+    }
+    
+    
+    
+    /**
+     * Maps arrays of distances to a path alike that stores its segment start
+     * distances, see the cursor version of @c DistanceToPathAlikeMapping::map.
+     *
+     * A cursor is carried from one distance to the next so ascending or 
+     * nearby distances, like those of vehicles queued along a path, find 
+     * their segment by a short walk. The mappings are identical to those
+     * of the cursor version of @c DistanceToPathAlikeMapping::map.
+     */
+    template< class PathAlike, class Mapping, class BaseDataExtractionPolicy = DistanceToPathAlikeBaseDataExtractionPolicy< PathAlike > >
+    class DistancesToPathAlikeMapping {
+    public:
+        
+        /**
+         * Below this number of distances the pool overload doesn't split 
+         * work.
+         */
+        enum { minParallelDistanceCount = 1024 };
+        
+        /**
+         * Maps the @a distanceCount distances of @a distancesOnPath to 
+         * @a pathAlike and stores the queried data in the elements of 
+         * @a mappings.
+         */
+        static void map( PathAlike const& pathAlike, float const distancesOnPath[], size_t distanceCount, Mapping mappings[] ) {
+            PathCursor cursor;
+            for ( size_t i = 0; i < distanceCount; ++i ) {
+                DistanceToPathAlikeMapping< PathAlike, Mapping, BaseDataExtractionPolicy >::map( pathAlike, distancesOnPath[ i ], mappings[ i ], cursor );
+            }
+        }
+        
+        /**
+         * Like @c map but splits the distances across @a pool if there are 
+         * at least @c minParallelDistanceCount of them.
+         */
+        static void map( PathAlike const& pathAlike, float const distancesOnPath[], size_t distanceCount, Mapping mappings[], WorkerPool& pool ) {
+            if ( ( distanceCount < minParallelDistanceCount ) || ( pool.threadCount() < 2 ) ) {
+                map( pathAlike, distancesOnPath, distanceCount, mappings );
+                return;
+            }
+            
+            Range range( pathAlike, distancesOnPath, mappings );
+            pool.parallelFor( distanceCount, range );
+        }
+        
+    private:
+        
+        /**
+         * @c WorkerPool body mapping a range of distances.
+         */
+        class Range {
+        public:
+            Range( PathAlike const& pathAlike, float const distancesOnPath[], Mapping mappings[] )
+                : pathAlike_( pathAlike ), distancesOnPath_( distancesOnPath ), mappings_( mappings ) {}
+            
+            void operator()( size_t begin, size_t end ) const {
+                DistancesToPathAlikeMapping::map( pathAlike_, distancesOnPath_ + begin, end - begin, mappings_ + begin );
+            }
+            
+        private:
+            PathAlike const& pathAlike_;
+            float const* distancesOnPath_;
+            Mapping* mappings_;
+        }; // class Range
+        
+    }; // class DistancesToPathAlikeMapping
+    
+    /**
+     * Maps the @a distanceCount distances of @a distances to @a pathAlike and
+     * stores the data queried in the elements of @a mappings.
+     *
+     * See @c DistancesToPathAlikeMapping::map for further information.
+     */
+    template< class PathAlike, class Mapping >
+    void mapDistancesToPathAlike( PathAlike const& pathAlike, float const distances[], size_t distanceCount, Mapping mappings[] ) {
+        DistancesToPathAlikeMapping< PathAlike, Mapping >::map( pathAlike, distances, distanceCount, mappings );
+    }
+    
+    /**
+     * Like @c mapDistancesToPathAlike but splits many distances across 
+     * @a pool.
+     */
+    template< class PathAlike, class Mapping >
+    void mapDistancesToPathAlike( PathAlike const& pathAlike, float const distances[], size_t distanceCount, Mapping mappings[], WorkerPool& pool ) {
+        DistancesToPathAlikeMapping< PathAlike, Mapping >::map( pathAlike, distances, distanceCount, mappings, pool );
+    }
+    
     
 } // namespace OpenSteer
 
@@ -137,6 +137,41 @@ namespace OpenSteer {
     }; // class PointToPathDistanceMapping
     
     
+    /**
+     * Stores what @c PointToPathMapping and @c PointToPathDistanceMapping 
+     * store together, so one mapping of a query point gives both - used by
+     * @c OpenSteer::mapPointToPathAlike.
+     */
+    class PointToPathAndDistanceMapping
+        : public ExtractPathDistance {
+    public:
+        PointToPathAndDistanceMapping() : pointOnPathCenterLine( 0.0f, 0.0f, 0.0f ), tangent( 0.0f, 0.0f, 0.0f ), distancePointToPath( 0.0f ), distanceOnPath( 0.0f ) {}
+        
+        void setPointOnPathCenterLine( Vec3 const& point ) {
+            pointOnPathCenterLine = point;
+        }
+        void setPointOnPathBoundary( Vec3 const&  ) {}
+        void setRadius( float ) {}
+        void setTangent( Vec3 const& t ) {
+            tangent = t;
+        }
+        void setSegmentIndex( size_t ) {}
+        void setDistancePointToPath( float distance ) {
+            distancePointToPath = distance;
+        }
+        void setDistancePointToPathCenterLine( float ) {}
+        void setDistanceOnPath( float distance ) {
+            distanceOnPath = distance;
+        }
+        void setDistanceOnSegment( float ) {}
+        
+        Vec3 pointOnPathCenterLine;
+        Vec3 tangent;
+        float distancePointToPath;
+        float distanceOnPath;
+    }; // class PointToPathAndDistanceMapping
+    
+    
 } // namespace OpenSteer
 
 
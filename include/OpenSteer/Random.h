@@ -0,0 +1,193 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Random
+//
+// RandomStream is a small, fast pseudo-random number generator (PCG32,
+// see pcg-random.org) with explicit state, replacing the global rand().
+// Each stream is selected by a seed and a stream number: streams with the
+// same seed but different stream numbers are statistically independent,
+// streams with equal seed and stream number produce the same sequence.
+//
+// Every SimpleVehicle owns a stream seeded from the global random seed and
+// its serial number, so a simulation that draws its random numbers from
+// the vehicles' streams is reproducible no matter how its vehicles are
+// distributed over threads.  The free functions frandom01, frandom2 and so
+// on draw from the calling thread's default stream.  setRandomSeed reseeds
+// the calling thread's default stream and determines the streams of
+// vehicles created after the call.  The default streams of other threads
+// are seeded in the order in which they are first used, so code running on
+// worker threads should draw from a vehicle's stream instead.
+//
+// A RandomScope gives a thread the random numbers of one world (see
+// World.h) for a while: its own default stream, and its own seed and
+// numbering for the streams of the vehicles created meanwhile.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_RANDOM_H
+#define OPENSTEER_RANDOM_H
+
+
+#include <stdint.h>  // for uint32_t, uint64_t
+
+
+namespace OpenSteer {
+
+
+    class RandomStream
+    {
+    public:
+
+        // seed used when none is given
+        static const uint64_t defaultSeed = 0x853c49e6748fea9bULL;
+
+        RandomStream (const uint64_t seed = defaultSeed,
+                      const uint64_t stream = 0)
+        {
+            this->seed (seed, stream);
+        }
+
+        // restart the stream: equal arguments give equal sequences
+        void seed (const uint64_t seed, const uint64_t stream = 0)
+        {
+            state = 0;
+            increment = (stream << 1) | 1;
+            next ();
+            state += seed;
+            next ();
+        }
+
+        // returns 32 uniformly distributed random bits
+        uint32_t next (void)
+        {
+            const uint64_t old = state;
+            state = (old * 6364136223846793005ULL) + increment;
+            const uint32_t xorShifted = (uint32_t) (((old >> 18) ^ old) >> 27);
+            const uint32_t rotation = (uint32_t) (old >> 59);
+            return (xorShifted >> rotation) |
+                   (xorShifted << ((0u - rotation) & 31));
+        }
+
+        // returns a float uniformly distributed in [0, 1)
+        float frandom01 (void)
+        {
+            // the upper 24 bits fill the float's mantissa exactly
+            return (next () >> 8) * (1.0f / 16777216.0f);
+        }
+
+        // returns a float uniformly distributed in [lowerBound, upperBound)
+        float frandom2 (const float lowerBound, const float upperBound)
+        {
+            return lowerBound + (frandom01 () * (upperBound - lowerBound));
+        }
+
+        bool operator== (const RandomStream& other) const
+        {
+            return (state == other.state) && (increment == other.increment);
+        }
+        bool operator!= (const RandomStream& other) const
+        {
+            return ! (*this == other);
+        }
+
+    private:
+
+        uint64_t state;
+        uint64_t increment;
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // the global random seed: reseeds the calling thread's default stream
+    // and seeds the streams of vehicles created from then on
+
+
+    void setRandomSeed (const uint64_t seed);
+    uint64_t randomSeed (void);
+
+
+    // ----------------------------------------------------------------------------
+    // the calling thread's default stream, used by frandom01 and friends
+    // (the stream of its innermost RandomScope, if any)
+
+
+    RandomStream& defaultRandomStream (void);
+
+
+    // ----------------------------------------------------------------------------
+    // seed the stream of a new vehicle with the given serial number: from
+    // the global seed and the serial number, or inside a RandomScope from
+    // the scope's seed and vehicle count (which this advances)
+
+
+    void seedVehicleRandomStream (RandomStream& stream, const int serialNumber);
+
+
+    // ----------------------------------------------------------------------------
+    // while it exists, the calling thread draws its default random numbers
+    // from stream, and seeds the vehicles it creates from seed and the
+    // count of vehicles created so far in the same world (vehicleCount),
+    // whatever their serial numbers.  A world stepped within its scope thus
+    // repeats itself given the same seed on whichever thread it runs.
+    // Scopes nest; they must be destroyed on the thread creating them.
+
+
+    class RandomScope
+    {
+    public:
+
+        RandomScope (RandomStream& stream,
+                     const uint64_t seed,
+                     uint64_t& vehicleCount);
+        ~RandomScope ();
+
+    private:
+
+        friend RandomStream& defaultRandomStream (void);
+        friend void seedVehicleRandomStream (RandomStream&, const int);
+
+        RandomStream& stream;
+        const uint64_t seed;
+        uint64_t& vehicleCount;
+        RandomScope* const outer;
+
+        // not copyable
+        RandomScope (const RandomScope&);
+        RandomScope& operator= (const RandomScope&);
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_RANDOM_H
@@ -0,0 +1,257 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// RegionPartition
+//
+// Spatial partitioning of a world among several simulation nodes (such as
+// processes on different machines).  RegionPartition divides the XZ
+// extent of the world into a grid of rectangular regions, one per node.
+// Each RegionNode owns the vehicles in its region and, once per frame,
+// runs an exchange with every other node:
+//
+//   - ghosts: owned vehicles within the ghost radius (the largest query
+//     radius of the simulation) of another region are sent to it, and
+//     appear there as read-only GhostVehicles with tokens in that node's
+//     proximity database, so queries near a border see both sides
+//   - migrants: owned vehicles which have moved into another region are
+//     sent to it, and the receiving node makes them into owned vehicles
+//     (the sender drops them)
+//
+// Vehicles travel as CheckpointVehicle records (see Checkpoint.h), so a
+// migrant resumes with all of its SimpleVehicle state, its random stream
+// included.  Messages go through a RegionTransport; LocalRegionTransport
+// connects nodes in one process (running on threads, or in turns); an
+// implementation over sockets or MPI connects processes.  Every frame
+// each node sends one message (possibly empty) to every other node and
+// receives one from each, so the nodes stay in lock step.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_REGIONPARTITION_H
+#define OPENSTEER_REGIONPARTITION_H
+
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include "OpenSteer/SimpleVehicle.h"
+#include "OpenSteer/Checkpoint.h"
+#include "OpenSteer/Proximity.h"
+
+
+namespace OpenSteer {
+
+
+    // ------------------------------------------------------------------------
+    // a grid of columns (along X) by rows (along Z) regions covering the
+    // world's bounds; positions outside the bounds belong to the nearest
+    // region
+
+
+    class RegionPartition
+    {
+    public:
+
+        RegionPartition (const Vec3& lo, const Vec3& hi,
+                         const int columns, const int rows);
+
+        int regionCount (void) const {return _columns * _rows;}
+
+        // the region a position belongs to
+        int regionOf (const Vec3& position) const;
+
+        // the regions other than exclude whose rectangle comes within
+        // radius of position (in the XZ plane)
+        void regionsNear (const Vec3& position, const float radius,
+                          const int exclude, std::vector<int>& regions) const;
+
+        // the XZ rectangle of a region (y of lo and hi as given)
+        void bounds (const int region, Vec3& lo, Vec3& hi) const;
+
+    private:
+
+        Vec3 _lo;
+        Vec3 _hi;
+        int _columns;
+        int _rows;
+        float _columnWidth;
+        float _rowDepth;
+    };
+
+
+    // ------------------------------------------------------------------------
+    // delivers byte messages between nodes, in order for each sender and
+    // receiver pair
+
+
+    class RegionTransport
+    {
+    public:
+        virtual ~RegionTransport () {}
+
+        virtual void send (const int from, const int to,
+                           const std::vector<char>& message) = 0;
+
+        // wait for the next message from one node to another
+        virtual void receive (const int from, const int to,
+                              std::vector<char>& message) = 0;
+    };
+
+
+    // in-process transport: a queue for each pair of nodes, safe to use
+    // from one thread per node
+    class LocalRegionTransport : public RegionTransport
+    {
+    public:
+
+        LocalRegionTransport (const int nodeCount);
+
+        void send (const int from, const int to,
+                   const std::vector<char>& message);
+        void receive (const int from, const int to,
+                      std::vector<char>& message);
+
+    private:
+
+        int _nodeCount;
+        std::vector<std::deque<std::vector<char> > > _queues;
+        std::mutex _mutex;
+        std::condition_variable _arrived;
+    };
+
+
+    // ------------------------------------------------------------------------
+    // read-only copy of another node's vehicle
+
+
+    class GhostVehicle : public SimpleVehicle
+    {
+    public:
+        // ghosts are moved by their owners, not by this node
+        void update (const float, const float) {}
+    };
+
+
+    // ------------------------------------------------------------------------
+
+
+    class RegionNode
+    {
+    public:
+
+        typedef AbstractProximityDatabase<AbstractVehicle*> ProximityDatabase;
+        typedef AbstractTokenForProximityDatabase<AbstractVehicle*> ProximityToken;
+
+        RegionNode (const RegionPartition& partition,
+                    const int rank,
+                    RegionTransport& transport,
+                    const float ghostRadius);
+        ~RegionNode ();
+
+        int rank (void) const {return _rank;}
+        const RegionPartition& partition (void) const {return _partition;}
+
+        // the database the ghosts have tokens in (or none), which keeps
+        // them across changes of database and exchanges.  It must outlive
+        // the node, or be replaced first.
+        void setProximityDatabase (ProximityDatabase* pd);
+
+        // one frame's exchange: send, then receive (the owned vehicles
+        // must be SimpleVehicles)
+        void exchange (const AVGroup& owned, std::vector<size_t>& emigrated)
+        {
+            send (owned, emigrated);
+            receive ();
+        }
+
+        // send every other node the owned vehicles it should ghost, and
+        // those which have moved into its region.  emigrated gets the
+        // indices (ascending) of the latter in owned, for the caller to
+        // remove.
+        void send (const AVGroup& owned, std::vector<size_t>& emigrated);
+
+        // receive every other node's message of this frame: replaces the
+        // ghosts (and places their tokens) and the immigrants
+        void receive (void);
+
+        // vehicles which moved into this node's region, as of the latest
+        // receive, for the caller to make into owned vehicles
+        // (SimpleVehicle::restoreState)
+        const std::vector<CheckpointVehicle>& immigrants (void) const
+            {return _immigrants;}
+
+        // the ghosts of the latest receive: other nodes' vehicles within
+        // the ghost radius of this region, including this node's own
+        // emigrants which stay that close
+        const AVGroup& ghosts (void) const {return _ghostGroup;}
+
+    private:
+
+        void writeMessage (const int to, std::vector<char>& message) const;
+        void readMessage (const std::vector<char>& message);
+        void placeGhosts (void);
+
+        const RegionPartition& _partition;
+        const int _rank;
+        RegionTransport& _transport;
+        const float _ghostRadius;
+        ProximityDatabase* _pd;
+
+        // records to send each node, and the emigrants kept as ghosts here
+        std::vector<std::vector<CheckpointVehicle> > _outGhosts;
+        std::vector<std::vector<CheckpointVehicle> > _outMigrants;
+        std::vector<CheckpointVehicle> _keptGhosts;
+
+        // received this frame
+        std::vector<CheckpointVehicle> _inGhosts;
+        std::vector<CheckpointVehicle> _immigrants;
+
+        // ghost vehicles (reused between frames) and their tokens
+        std::vector<GhostVehicle*> _ghosts;
+        std::vector<ProximityToken*> _tokens;
+        AVGroup _ghostGroup;
+
+        std::vector<int> _near;
+        std::vector<char> _message;
+        std::vector<Vec3> _positions;
+
+        // not copyable
+        RegionNode (const RegionNode&);
+        RegionNode& operator= (const RegionNode&);
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_REGIONPARTITION_H
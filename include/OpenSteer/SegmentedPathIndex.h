@@ -0,0 +1,387 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ * @file
+ *
+ * Bounding volume hierarchy over the segments of a segmented path to map
+ * points to long paths without testing every segment.
+ */
+#ifndef OPENSTEER_SEGMENTEDPATHINDEX_H
+#define OPENSTEER_SEGMENTEDPATHINDEX_H
+
+// Include std::vector
+#include <vector>
+
+// Include std::numeric_limits
+#include <limits>
+
+// Include std::swap
+#include <algorithm>
+
+// Include std::abs, std::sqrt
+#include <cmath>
+
+// Include assert
+#include <cassert>
+
+
+
+// Include OpenSteer::SegmentedPath
+#include "OpenSteer/SegmentedPath.h"
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OpenSteer::AccountedVector
+#include "OpenSteer/MemoryAccount.h"
+
+
+
+namespace OpenSteer {
+    
+    /**
+     * Axis aligned bounding box tree over the segments of a segmented path.
+     *
+     * Every segment may carry a radius (the pathway radius around it). 
+     * @c nearestSegment returns the segment with the smallest value of a 
+     * caller supplied metric, which must never be smaller than the 
+     * distance of the query point to the segment minus the segment radius.
+     * Of segments with equal metric the one with the lowest index is 
+     * returned, so the result is the same as that of testing all segments in
+     * order and keeping the first minimum.
+     *
+     * The index holds no reference to the path; after changing the path call
+     * @c build or @c pointsMoved again.
+     *
+     * Instead of its own storage the index can use a @c View of arrays 
+     * owned elsewhere, e.g. mapped from a file by @c PathDatasetReader. 
+     * Such an index can be queried, copied, swapped, cleared and rebuilt
+     * but not refitted.
+     *
+     * Segments inserted at either end of a path after building aren't put
+     * into the tree but tested one by one, and segments removed from 
+     * either end stay in the tree but are skipped, until so many changed
+     * that @c segmentsInserted or @c segmentsRemoved rebuild the tree.
+     */
+    class SegmentedPathIndex {
+    public:
+        typedef SegmentedPath::size_type size_type;
+        
+        /**
+         * Node of the tree. Inner nodes store the index of their first child,
+         * the second child follows it. Leaves store a range of the segment
+         * order.
+         */
+        struct Node {
+            Vec3 minimum;
+            Vec3 maximum;
+            float radius;
+            int parent;
+            int firstChild;
+            unsigned int first;
+            unsigned int count;
+        };
+        
+        /**
+         * The arrays the queries read: @c nodeCount nodes with the root 
+         * first, the segment order their leaves refer to (one entry per 
+         * segment) and the rounding slack of the tree.
+         */
+        struct View {
+            Node const* nodes;
+            size_type nodeCount;
+            unsigned int const* order;
+            size_type segmentCount;
+            float slack;
+        };
+        
+        SegmentedPathIndex();
+        
+        SegmentedPathIndex( SegmentedPathIndex const& other );
+        
+        SegmentedPathIndex& operator=( SegmentedPathIndex other );
+        
+        /**
+         * Swaps the content with @a other.
+         */
+        void swap( SegmentedPathIndex& other );
+        
+        /**
+         * Removes all segments. An empty index is unused by the mappings.
+         */
+        void clear();
+        
+        /**
+         * Returns @c true if the index holds no segments.
+         */
+        bool empty() const;
+        
+        /**
+         * Builds the index for all segments of @a path, each with radius 
+         * @a radius.
+         */
+        void build( SegmentedPath const& path, float radius = 0.0f );
+        
+        /**
+         * Builds the index for all segments of @a path. @a radii must have 
+         * one element per segment.
+         */
+        void build( SegmentedPath const& path, float const radii[] );
+        
+        /**
+         * Refits the index after @a numOfPoints points starting at 
+         * @a startIndex of @a path have been moved, see 
+         * @c PolylineSegmentedPath::movePoints.
+         */
+        void pointsMoved( SegmentedPath const& path, 
+                          size_type startIndex, 
+                          size_type numOfPoints );
+        
+        /**
+         * Accounts for @a numOfSegments segments inserted before the first
+         * (if @a atFront is @c true) or after the last segment of @a path,
+         * each with radius @a radius. All segments inserted since the index
+         * was built must have the same radius.
+         */
+        void segmentsInserted( SegmentedPath const& path,
+                               size_type numOfSegments,
+                               bool atFront,
+                               float radius );
+        
+        /**
+         * Accounts for @a numOfSegments segments removed from the start (if
+         * @a atFront is @c true) or the end of @a path.
+         */
+        void segmentsRemoved( SegmentedPath const& path,
+                              size_type numOfSegments,
+                              bool atFront );
+        
+        /**
+         * Sets the radius of every segment to @a radius.
+         */
+        void setRadius( float radius );
+        
+        /**
+         * Sets the radii of @a numOfRadii segments starting at @a startIndex.
+         */
+        void setSegmentRadii( size_type startIndex, 
+                              size_type numOfRadii, 
+                              float const radii[] );
+        
+        /**
+         * Returns the number of indexed segments, including those inserted
+         * since the index was built.
+         */
+        size_type segmentCount() const;
+        
+        /**
+         * Returns the arrays of the index, valid until it changes.
+         */
+        View view() const;
+        
+        /**
+         * Uses the arrays of @a view instead of own storage without copying
+         * them. They must stay valid and unchanged while the index uses 
+         * them, until it is cleared or built again.
+         */
+        void setView( View const& view );
+        
+        /**
+         * Returns @c true if the index uses arrays set by @c setView.
+         */
+        bool isView() const;
+        
+        /**
+         * Returns the index of the segment with the smallest 
+         * <code>metric( segmentIndex )</code> for @a point, or 
+         * @c segmentCount if the index is empty.
+         */
+        template< class SegmentMetric >
+        size_type nearestSegment( Vec3 const& point, SegmentMetric const& metric ) const;
+        
+        /**
+         * As above but first tests segment @a hint and its neighbors, which
+         * usually tightens the search to a few boxes when the point moved 
+         * little since @a hint was found. The result doesn't depend on 
+         * @a hint, ignored if it isn't a valid segment index.
+         */
+        template< class SegmentMetric >
+        size_type nearestSegment( Vec3 const& point, SegmentMetric const& metric, size_type hint ) const;
+        
+    private:
+        
+        void buildTree( SegmentedPath const& path );
+        void distribute( std::vector< Vec3 >& centers, int node, unsigned int first, unsigned int count );
+        void fitLeaf( int node );
+        void fitInner( int node );
+        void refitAncestors( int node );
+        void refitAll();
+        void updateSlack();
+        void updateView();
+        void rebuildIfStale( SegmentedPath const& path );
+        bool treeIndex( size_type segmentIndex, size_type& treeSegment ) const;
+        
+        float lowerBound( Node const& node, Vec3 const& point ) const;
+        
+        // Storage charged to path memory.
+        AccountedVector< Node, MemoryAccount::pathMemory >::type nodes_;
+        AccountedVector< unsigned int, MemoryAccount::pathMemory >::type order_;
+        AccountedVector< int, MemoryAccount::pathMemory >::type leafOfSegment_;
+        AccountedVector< Vec3, MemoryAccount::pathMemory >::type segmentStarts_;
+        AccountedVector< Vec3, MemoryAccount::pathMemory >::type segmentEnds_;
+        AccountedVector< float, MemoryAccount::pathMemory >::type segmentRadii_;
+        float slack_;
+        
+        // What the queries read, the vectors above unless set by setView.
+        View view_;
+        bool isView_;
+        
+        // Changes at the ends of the path since the tree was built: path 
+        // segments before and behind those in the tree, and tree segments
+        // removed from the path at its start and end.
+        size_type insertedFront_;
+        size_type insertedBack_;
+        size_type removedFront_;
+        size_type removedBack_;
+        float insertedRadius_;
+    }; // class SegmentedPathIndex
+    
+    
+    /**
+     * Swaps the content of @a lhs and @a rhs.
+     */
+    inline void swap( SegmentedPathIndex& lhs, SegmentedPathIndex& rhs ) {
+        lhs.swap( rhs );
+    }
+    
+    
+    
+    template< class SegmentMetric >
+    SegmentedPathIndex::size_type 
+    SegmentedPathIndex::nearestSegment( Vec3 const& point, SegmentMetric const& metric ) const {
+        return nearestSegment( point, metric, segmentCount() );
+    }
+    
+    
+    template< class SegmentMetric >
+    SegmentedPathIndex::size_type 
+    SegmentedPathIndex::nearestSegment( Vec3 const& point, SegmentMetric const& metric, size_type hint ) const {
+        
+        size_type const segments = segmentCount();
+        size_type bestSegment = segments;
+        if ( 0 == view_.nodeCount ) {
+            return bestSegment;
+        }
+        
+        // The metric is computed in float, so a bound may exceed the value of
+        // a segment inside the box by some rounding relative to the 
+        // magnitudes involved; only prune clearly farther boxes.
+        float const slack = view_.slack + 1.0e-5f * ( std::abs( point.x ) + std::abs( point.y ) + std::abs( point.z ) );
+        float best = std::numeric_limits< float >::max();
+        
+        if ( hint < segments ) {
+            size_type const first = ( 0 < hint ) ? ( hint - 1 ) : 0;
+            size_type const last = std::min( hint + 2, segments );
+            for ( size_type segmentIndex = first; segmentIndex < last; ++segmentIndex ) {
+                float const value = metric( segmentIndex );
+                if ( value < best ) {
+                    best = value;
+                    bestSegment = segmentIndex;
+                }
+            }
+        }
+        
+        // Segments inserted at either end since the tree was built.
+        size_type const inserted[ 4 ] = { 0, insertedFront_, segments - insertedBack_, segments };
+        for ( int range = 0; range < 4; range += 2 ) {
+            for ( size_type segmentIndex = inserted[ range ]; segmentIndex < inserted[ range + 1 ]; ++segmentIndex ) {
+                float const value = metric( segmentIndex );
+                if ( ( value < best ) || ( ( value == best ) && ( segmentIndex < bestSegment ) ) ) {
+                    best = value;
+                    bestSegment = segmentIndex;
+                }
+            }
+        }
+        
+        // Tree segments still on the path.
+        size_type const firstTreeSegment = removedFront_;
+        size_type const lastTreeSegment = view_.segmentCount - removedBack_;
+        
+        // Median splits keep the tree depth logarithmic, far below the stack
+        // size.
+        int stack[ 128 ];
+        int top = 0;
+        stack[ top++ ] = 0;
+        
+        while ( 0 < top ) {
+            Node const& node = view_.nodes[ stack[ --top ] ];
+            if ( lowerBound( node, point ) > best + slack ) {
+                continue;
+            }
+            
+            if ( node.firstChild < 0 ) {
+                for ( unsigned int i = node.first; i < node.first + node.count; ++i ) {
+                    size_type const treeSegment = view_.order[ i ];
+                    if ( ( treeSegment < firstTreeSegment ) || ( treeSegment >= lastTreeSegment ) ) {
+                        continue;
+                    }
+                    size_type const segmentIndex = treeSegment - removedFront_ + insertedFront_;
+                    float const value = metric( segmentIndex );
+                    if ( ( value < best ) || ( ( value == best ) && ( segmentIndex < bestSegment ) ) ) {
+                        best = value;
+                        bestSegment = segmentIndex;
+                    }
+                }
+            } else {
+                // Visit the nearer child first to tighten the bound early.
+                int near = node.firstChild;
+                int far = node.firstChild + 1;
+                if ( lowerBound( view_.nodes[ far ], point ) < lowerBound( view_.nodes[ near ], point ) ) {
+                    std::swap( near, far );
+                }
+                assert( top + 2 <= 128 && "Segment index tree too deep." );
+                stack[ top++ ] = far;
+                stack[ top++ ] = near;
+            }
+        }
+        
+        return bestSegment;
+    }
+    
+    
+    inline float 
+    SegmentedPathIndex::lowerBound( Node const& node, Vec3 const& point ) const {
+        float const dx = ( point.x < node.minimum.x ) ? ( node.minimum.x - point.x ) : ( ( point.x > node.maximum.x ) ? ( point.x - node.maximum.x ) : 0.0f );
+        float const dy = ( point.y < node.minimum.y ) ? ( node.minimum.y - point.y ) : ( ( point.y > node.maximum.y ) ? ( point.y - node.maximum.y ) : 0.0f );
+        float const dz = ( point.z < node.minimum.z ) ? ( node.minimum.z - point.z ) : ( ( point.z > node.maximum.z ) ? ( point.z - node.maximum.z ) : 0.0f );
+        return std::sqrt( dx * dx + dy * dy + dz * dz ) - node.radius;
+    }
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_SEGMENTEDPATHINDEX_H
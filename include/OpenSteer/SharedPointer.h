@@ -39,6 +39,11 @@
 // Include assert
 #include <cassert>
 
+// Include std::forward
+#include <utility>
+
+// Include std::atomic
+#include <atomic>
 
 
 
@@ -50,9 +55,91 @@
 namespace OpenSteer {
     
     /**
-     * Helper class for @c SharedPointer.
+     * Reference count policy for @c SharedPointer that uses a plain counter.
+     * Cheapest policy but only safe if the shared pointers of one managed
+     * object are never copied or destroyed concurrently.
      */
-    struct SharedPointerReferenceCount {
+    struct SharedPointerPlainCount {
+        typedef size_t size_type;
+        typedef size_t count_type;
+        
+        static size_type load( count_type const& count ) {
+            return count;
+        }
+        
+        static void increment( count_type& count ) {
+            ++count;
+        }
+        
+        /**
+         * Returns the count after decrementing it.
+         *
+         * GCC 12 can't tell that a count reaching @c 0 is never decremented
+         * again and, once two shared pointers to one object are destroyed in
+         * a row, warns of a use after @c dispose on that impossible path.
+         */
+#if defined( __GNUC__ ) && ( __GNUC__ >= 12 ) && ! defined( __clang__ )
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuse-after-free"
+#endif
+        static size_type decrement( count_type& count ) {
+            return --count;
+        }
+#if defined( __GNUC__ ) && ( __GNUC__ >= 12 ) && ! defined( __clang__ )
+#pragma GCC diagnostic pop
+#endif
+    };
+    
+    
+    /**
+     * Reference count policy for @c SharedPointer that uses an atomic counter
+     * so shared pointers of one managed object can be copied and destroyed
+     * from different threads, e.g. from the tasks of a @c WorkerPool.
+     *
+     * Only the reference count is thread safe, the managed object and a
+     * single @c SharedPointer instance are not.
+     */
+    struct SharedPointerAtomicCount {
+        typedef size_t size_type;
+        typedef std::atomic< size_t > count_type;
+        
+        static size_type load( count_type const& count ) {
+            return count.load( std::memory_order_relaxed );
+        }
+        
+        static void increment( count_type& count ) {
+            count.fetch_add( 1, std::memory_order_relaxed );
+        }
+        
+        /**
+         * Returns the count after decrementing it. Acquire-release ordering
+         * makes all writes to the managed object visible to the thread that
+         * destroys it.
+         */
+        static size_type decrement( count_type& count ) {
+            return count.fetch_sub( 1, std::memory_order_acq_rel ) - 1;
+        }
+    };
+    
+    
+    /**
+     * Reference count policy used if none is given to @c SharedPointer:
+     * atomic unless the build defines @c OPENSTEER_SINGLE_THREADED.
+     */
+#ifdef OPENSTEER_SINGLE_THREADED
+    typedef SharedPointerPlainCount SharedPointerDefaultCount;
+#else
+    typedef SharedPointerAtomicCount SharedPointerDefaultCount;
+#endif
+    
+    
+    /**
+     * Helper class for @c SharedPointer. Holds the reference count and knows
+     * how to destroy the managed object together with itself.
+     */
+    template< typename CountPolicy >
+    class SharedPointerReferenceCount {
+    public:
         typedef size_t size_type;
         
         
@@ -60,7 +147,90 @@ namespace OpenSteer {
             // Nothing to do.
         }
         
-        size_type referenceCount_;
+        size_type useCount() const {
+            return CountPolicy::load( referenceCount_ );
+        }
+        
+        void retain() {
+            CountPolicy::increment( referenceCount_ );
+        }
+        
+        /**
+         * Decreases the reference count and returns @c true if it hit @c 0.
+         */
+        bool release() {
+            return 0 == CountPolicy::decrement( referenceCount_ );
+        }
+        
+        /**
+         * Deletes the managed object and the reference count itself.
+         */
+        virtual void dispose() = 0;
+        
+    protected:
+        virtual ~SharedPointerReferenceCount() {
+            // Nothing to do.
+        }
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        SharedPointerReferenceCount( SharedPointerReferenceCount const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        SharedPointerReferenceCount& operator=( SharedPointerReferenceCount const& );
+        
+    private:
+        typename CountPolicy::count_type referenceCount_;
+    };
+    
+    
+    /**
+     * Reference count allocated separately from the managed object, used if
+     * a raw pointer is handed to a @c SharedPointer.
+     */
+    template< typename U, typename CountPolicy >
+    class SharedPointerSeparateReferenceCount : public SharedPointerReferenceCount< CountPolicy > {
+    public:
+        explicit SharedPointerSeparateReferenceCount( U* _data ): data_( _data ) {
+            // Nothing to do.
+        }
+        
+        virtual void dispose() {
+            delete data_;
+            delete this;
+        }
+        
+    private:
+        U* data_;
+    };
+    
+    
+    /**
+     * Reference count that stores the managed object in the same allocation,
+     * used by @c makeShared.
+     */
+    template< typename U, typename CountPolicy >
+    class SharedPointerInPlaceReferenceCount : public SharedPointerReferenceCount< CountPolicy > {
+    public:
+        template< typename... Args >
+        explicit SharedPointerInPlaceReferenceCount( Args&&... args ): object_( std::forward< Args >( args )... ) {
+            // Nothing to do.
+        }
+        
+        U* get() {
+            return &object_;
+        }
+        
+        virtual void dispose() {
+            delete this;
+        }
+        
+    private:
+        U object_;
     };
     
     
@@ -85,8 +255,13 @@ namespace OpenSteer {
      *
      * @attention Beware of cycles of smart pointers as these will lead to 
      * memory leaks.
+     *
+     * @c CountPolicy selects the reference counter, see 
+     * @c SharedPointerAtomicCount and @c SharedPointerPlainCount. Use
+     * @c makeShared to allocate the managed object and its reference count
+     * with a single allocation.
      */
-    template< typename T >
+    template< typename T, typename CountPolicy = SharedPointerDefaultCount >
     class SharedPointer {
     public:
         typedef size_t size_type;
@@ -96,7 +271,7 @@ namespace OpenSteer {
         typedef value_type* pointer;
         typedef value_type const* const_pointer;
         
-        template< typename U > friend class SharedPointer;
+        template< typename U, typename P > friend class SharedPointer;
         
         
         /**
@@ -106,7 +281,7 @@ namespace OpenSteer {
          *
          * @throw @c std::bad_alloc if memory could not be obtained.
          */
-        SharedPointer() : data_( 0 ), referenceCount_( new SharedPointerReferenceCount() ) {
+        SharedPointer() : data_( 0 ), referenceCount_( new SharedPointerSeparateReferenceCount< T, CountPolicy >( 0 ) ) {
             // Nothing to do.
         }
         
@@ -117,7 +292,7 @@ namespace OpenSteer {
          *
          * @throw @c std::bad_alloc if memory could not be obtained.
          */
-        explicit SharedPointer( T* _data ) : data_( _data ), referenceCount_( new SharedPointerReferenceCount() ) {
+        explicit SharedPointer( T* _data ) : data_( _data ), referenceCount_( new SharedPointerSeparateReferenceCount< T, CountPolicy >( _data ) ) {
             // Nothing to do.
         }
         
@@ -143,7 +318,7 @@ namespace OpenSteer {
          * @throw Nothing. 
          */
         template< typename U >
-        SharedPointer( SharedPointer< U > const& other ) : data_( other.data_ ), referenceCount_( other.referenceCount_ ) {
+        SharedPointer( SharedPointer< U, CountPolicy > const& other ) : data_( other.data_ ), referenceCount_( other.referenceCount_ ) {
             retain();
         }
         
@@ -204,7 +379,7 @@ namespace OpenSteer {
         */
         
         size_type useCount() const {
-            return referenceCount_->referenceCount_;
+            return referenceCount_->useCount();
         }
         
         /**
@@ -231,6 +406,22 @@ namespace OpenSteer {
             SharedPointer( _data ).swap( *this );
         }
         
+        /**
+         * Constructs a @c T from @a args and places it in one allocation
+         * together with its reference count. Prefer @c makeShared.
+         *
+         * @post <code> useCount() == 1 </code>
+         *
+         * @throw @c std::bad_alloc if memory could not be obtained or any
+         *        exception thrown by the constructor of @c T.
+         */
+        template< typename... Args >
+        static SharedPointer create( Args&&... args ) {
+            SharedPointerInPlaceReferenceCount< T, CountPolicy >* referenceCount = 
+                new SharedPointerInPlaceReferenceCount< T, CountPolicy >( std::forward< Args >( args )... );
+            return SharedPointer( referenceCount->get(), referenceCount );
+        }
+        
 
         /**
          * See http://Boost.org shared_ptr 
@@ -288,7 +479,7 @@ namespace OpenSteer {
 
         
         template< typename U >
-            bool operator<( SharedPointer< U > const& rhs ) {
+            bool operator<( SharedPointer< U, CountPolicy > const& rhs ) {
                 // Because of sub-typing two different pointers might
                 // nonetheless point to the same class instance. Therefore use
                 // the reference count pointer for comparisons.
@@ -299,6 +490,13 @@ namespace OpenSteer {
 
     private:
         
+        /**
+         * Takes over @a _referenceCount which already counts one owner.
+         */
+        SharedPointer( T* _data, SharedPointerReferenceCount< CountPolicy >* _referenceCount ) : data_( _data ), referenceCount_( _referenceCount ) {
+            // Nothing to do.
+        }
+        
         /**
          * Decreases the reference count of the managed pointer. If the 
          * reference count reaches @c 0 the managed pointer is deleted, too.
@@ -311,14 +509,15 @@ namespace OpenSteer {
          *            undefined behavior and might crash the application.
          */
         void release() {
-            assert( 0 < referenceCount_->referenceCount_ && "Only call release for reference counts greater than 0." );
+            assert( 0 < referenceCount_->useCount() && "Only call release for reference counts greater than 0." );
             
-            --( referenceCount_->referenceCount_ );
-            if ( 0 == referenceCount_->referenceCount_ ) {
-                delete data_;
+            // Forget the reference count before disposing of it, so nothing
+            // reads it once @c dispose has deleted it.
+            SharedPointerReferenceCount< CountPolicy >* const referenceCount = referenceCount_;
+            if ( referenceCount->release() ) {
                 data_ = 0;
-                delete referenceCount_;
                 referenceCount_ = 0;
+                referenceCount->dispose();
             }
         }
         
@@ -329,21 +528,20 @@ namespace OpenSteer {
          * lead to memory leaks.
          */
         void retain() {
-            ++( referenceCount_->referenceCount_ );
-            
+            referenceCount_->retain();
         }
         
         
     private:
         pointer data_;
-        SharedPointerReferenceCount* referenceCount_;
+        SharedPointerReferenceCount< CountPolicy >* referenceCount_;
     }; // class SharedPointer
     
 
  
     
-    template< typename T, typename U >
-        bool operator==( SharedPointer< T > const& lhs, SharedPointer< U > const& rhs ) {
+    template< typename T, typename U, typename P >
+        bool operator==( SharedPointer< T, P > const& lhs, SharedPointer< U, P > const& rhs ) {
             return lhs.get() == rhs.get();
         }
     
@@ -358,8 +556,8 @@ namespace OpenSteer {
     //     }
     
     
-    template< typename T, typename U >
-        bool operator!=( SharedPointer< T > const& lhs, SharedPointer< U > const& rhs ) {
+    template< typename T, typename U, typename P >
+        bool operator!=( SharedPointer< T, P > const& lhs, SharedPointer< U, P > const& rhs ) {
             return !( lhs == rhs );
         }
     
@@ -375,12 +573,26 @@ namespace OpenSteer {
     
     
     
-    template< typename T >
-        void swap( SharedPointer< T >& lhs, SharedPointer< T >& rhs ) {
+    template< typename T, typename P >
+        void swap( SharedPointer< T, P >& lhs, SharedPointer< T, P >& rhs ) {
             lhs.swap( rhs );
         }
     
     
+    /**
+     * Constructs a @c T from @a args and returns a @c SharedPointer managing
+     * it. The object and its reference count share one allocation.
+     *
+     * Example: <code>makeShared< SphereObstacle >( radius, center )</code> or, with
+     * an explicit count policy, 
+     * <code>makeShared< SphereObstacle, SharedPointerPlainCount >()</code>.
+     */
+    template< typename T, typename CountPolicy = SharedPointerDefaultCount, typename... Args >
+        SharedPointer< T, CountPolicy > makeShared( Args&&... args ) {
+            return SharedPointer< T, CountPolicy >::create( std::forward< Args >( args )... );
+        }
+    
+    
 } // namespace OpenSteer
 
 
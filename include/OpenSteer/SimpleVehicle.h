@@ -67,28 +67,46 @@
 #include "OpenSteer/AbstractVehicle.h"
 #include "OpenSteer/SteerLibrary.h"
 #include "OpenSteer/Annotation.h"
+#include "OpenSteer/MemoryAccount.h"
+#include <atomic>
 
 
 namespace OpenSteer {
 
 
+    struct CheckpointVehicle;
+
+
     // ----------------------------------------------------------------------------
 
 
     // SimpleVehicle_1 adds concrete LocalSpace methods to AbstractVehicle
+    // (or, built with OPENSTEER_COMPACT_LOCAL_SPACE, ones keeping the
+    // orientation as a quaternion)
+#ifdef OPENSTEER_COMPACT_LOCAL_SPACE
+    typedef CompactLocalSpaceMixin<AbstractVehicle> SimpleVehicle_1;
+#else
     typedef LocalSpaceMixin<AbstractVehicle> SimpleVehicle_1;
+#endif
 
 
     // SimpleVehicle_2 adds concrete annotation methods to SimpleVehicle_1
+    // (or, built with OPENSTEER_NULL_ANNOTATION, empty ones costing nothing)
+#ifdef OPENSTEER_NULL_ANNOTATION
+    typedef NullAnnotationMixin<SimpleVehicle_1> SimpleVehicle_2;
+#else
     typedef AnnotationMixin<SimpleVehicle_1> SimpleVehicle_2;
+#endif
 
 
     // SimpleVehicle_3 adds concrete steering methods to SimpleVehicle_2
     typedef SteerLibraryMixin<SimpleVehicle_2> SimpleVehicle_3;
 
 
-    // SimpleVehicle adds concrete vehicle methods to SimpleVehicle_3
-    class SimpleVehicle : public SimpleVehicle_3
+    // SimpleVehicle adds concrete vehicle methods to SimpleVehicle_3 (and
+    // charges vehicles created with new to MemoryAccount::vehicleMemory)
+    class SimpleVehicle : public SimpleVehicle_3,
+                          public AccountedObject<MemoryAccount::vehicleMemory>
     {
     public:
 
@@ -120,18 +138,86 @@ namespace OpenSteer {
             resetSmoothedPosition ();
             resetSmoothedCurvature ();
             resetSmoothedAcceleration ();
+
+            // no steering applied yet
+            _steeringApplied = false;
         }
 
         // get/set mass
         float mass (void) const {return _mass;}
         float setMass (float m) {return _mass = m;}
 
-        // get velocity of vehicle
-        Vec3 velocity (void) const {return forward() * _speed;}
+        // get velocity of vehicle.  It is kept up to date by the setters of
+        // speed and of the basis (see updateMotion), so the many vehicles
+        // steering against one target read it rather than each deriving it
+        // again.
+        Vec3 velocity (void) const {return _velocity;}
 
         // get/set speed of vehicle  (may be faster than taking mag of velocity)
         float speed (void) const {return _speed;}
-        float setSpeed (float s) {return _speed = s;}
+        float setSpeed (float s) {_speed = s; updateMotion (); return s;}
+
+        // the changes of local space which may change forward, so
+        // velocity: every setter of the basis, as with a local space
+        // policy other than LocalSpaceMixin (such as
+        // CompactLocalSpaceMixin) setting side or up turns forward too
+        Vec3 setSide (Vec3 s)
+        {
+            SimpleVehicle_3::setSide (s);
+            updateMotion ();
+            return s;
+        }
+        Vec3 setSide (float x, float y, float z)
+            {return setSide (Vec3 (x, y, z));}
+        Vec3 setUp (Vec3 u)
+        {
+            SimpleVehicle_3::setUp (u);
+            updateMotion ();
+            return u;
+        }
+        Vec3 setUp (float x, float y, float z)
+            {return setUp (Vec3 (x, y, z));}
+        Vec3 setForward (Vec3 f)
+        {
+            SimpleVehicle_3::setForward (f);
+            updateMotion ();
+            return f;
+        }
+        Vec3 setForward (float x, float y, float z)
+            {return setForward (Vec3 (x, y, z));}
+        void resetLocalSpace (void)
+        {
+            SimpleVehicle_3::resetLocalSpace ();
+            updateMotion ();
+        }
+        void setUnitSideFromForwardAndUp (void)
+        {
+            SimpleVehicle_3::setUnitSideFromForwardAndUp ();
+            updateMotion ();
+        }
+        void regenerateOrthonormalBasisUF (const Vec3& newUnitForward)
+        {
+            SimpleVehicle_3::regenerateOrthonormalBasisUF (newUnitForward);
+            updateMotion ();
+        }
+        void regenerateOrthonormalBasis (const Vec3& newForward)
+        {
+            SimpleVehicle_3::regenerateOrthonormalBasis (newForward);
+            updateMotion ();
+        }
+        void regenerateOrthonormalBasis (const Vec3& newForward,
+                                         const Vec3& newUp)
+        {
+            SimpleVehicle_3::regenerateOrthonormalBasis (newForward, newUp);
+            updateMotion ();
+        }
+#ifdef OPENSTEER_COMPACT_LOCAL_SPACE
+        void setRotation (const float q[4])
+        {
+            SimpleVehicle_3::setRotation (q);
+            updateMotion ();
+        }
+#endif
 
         // size of bounding sphere, for obstacle avoidance, etc.
         float radius (void) const {return _radius;}
@@ -153,6 +239,18 @@ namespace OpenSteer {
         // adjusting our orientation to maintain velocity-alignment.
         void applySteeringForce (const Vec3& force, const float deltaTime);
 
+        // the (raw) force and time step of the latest applySteeringForce
+        // call, for SteeringRecorder.  Returns false if there was none since
+        // the previous takeAppliedSteering.
+        bool takeAppliedSteering (Vec3& force, float& deltaTime)
+        {
+            if (! _steeringApplied) return false;
+            force = _appliedSteering;
+            deltaTime = _appliedSteeringTime;
+            _steeringApplied = false;
+            return true;
+        }
+
         // the default version: keep FORWARD parallel to velocity, change
         // UP as little as possible.
         virtual void regenerateLocalSpace (const Vec3& newVelocity,
@@ -183,41 +281,61 @@ namespace OpenSteer {
         float curvature (void) const {return _curvature;}
 
         // get/reset smoothedCurvature, smoothedAcceleration and smoothedPosition
-        float smoothedCurvature (void) {return _smoothedCurvature;}
+        float smoothedCurvature (void) const {return _smoothedCurvature;}
         float resetSmoothedCurvature (float value = 0)
         {
             _lastForward = Vec3::zero;
             _lastPosition = Vec3::zero;
             return _smoothedCurvature = _curvature = value;
         }
-        Vec3 smoothedAcceleration (void) {return _smoothedAcceleration;}
+        Vec3 smoothedAcceleration (void) const {return _smoothedAcceleration;}
         Vec3 resetSmoothedAcceleration (const Vec3& value = Vec3::zero)
         {
             return _smoothedAcceleration = value;
         }
-        Vec3 smoothedPosition (void) {return _smoothedPosition;}
+        Vec3 smoothedPosition (void) const {return _smoothedPosition;}
         Vec3 resetSmoothedPosition (const Vec3& value = Vec3::zero)
         {
             return _smoothedPosition = value;
         }
 
-        // give each vehicle a unique number
+        // give each vehicle a unique number (atomically, so vehicles may be
+        // created on several threads at once)
         int serialNumber;
-        static int serialNumberCounter;
+        static std::atomic<int> serialNumberCounter;
 
         // draw lines from vehicle's position showing its velocity and acceleration
-        void annotationVelocityAcceleration (float maxLengthA, float maxLengthV);
+        //
+        // (defined inline so that only hosts which actually draw annotation
+        // need to link the Draw library)
+        void annotationVelocityAcceleration (float maxLengthA, float maxLengthV)
+        {
+            const float desat = 0.4f;
+            const float aScale = maxLengthA / maxForce ();
+            const float vScale = maxLengthV / maxSpeed ();
+            const Vec3& p = position();
+            const Color aColor (desat, desat, 1); // bluish
+            const Color vColor (    1, desat, 1); // pinkish
+
+            annotationLine (p, p + (velocity ()           * vScale), vColor);
+            annotationLine (p, p + (_smoothedAcceleration * aScale), aColor);
+        }
         void annotationVelocityAcceleration (float maxLength)
             {annotationVelocityAcceleration (maxLength, maxLength);}
         void annotationVelocityAcceleration (void)
             {annotationVelocityAcceleration (3, 3);}
 
+        // copy this vehicle's simulation state to/from a checkpoint record
+        // (see Checkpoint.h).  Subclasses save their own fields separately.
+        void saveState (CheckpointVehicle& record) const;
+        void restoreState (const CheckpointVehicle& record);
+
         // set a random "2D" heading: set local Up to global Y, then effectively
         // rotate about it by a random angle (pick random forward, derive side).
         void randomizeHeadingOnXZPlane (void)
         {
             setUp (Vec3::up);
-            setForward (RandomUnitVectorOnXZPlane ());
+            setForward (RandomUnitVectorOnXZPlane (randomStream ()));
             setSide (localRotateForwardToSide (forward()));
         }
 
@@ -230,6 +348,10 @@ namespace OpenSteer {
         float _speed;      // speed along Forward direction.  Because local space
                            // is velocity-aligned, velocity = Forward * Speed
 
+        Vec3 _velocity;    // Forward * Speed, as of the latest change of either
+
+        void updateMotion (void) {_velocity = forward () * _speed;}
+
         float _maxForce;   // the maximum steering force this vehicle can apply
                            // (steering force is clipped to this magnitude)
 
@@ -243,6 +365,11 @@ namespace OpenSteer {
         float _smoothedCurvature;
         Vec3 _smoothedAcceleration;
 
+        // latest applySteeringForce arguments, see takeAppliedSteering
+        Vec3 _appliedSteering;
+        float _appliedSteeringTime;
+        bool _steeringApplied;
+
         // measure path curvature (1/turning-radius), maintain smoothed version
         void measurePathCurvature (const float elapsedTime);
     };
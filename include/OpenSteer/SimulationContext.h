@@ -0,0 +1,116 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// SimulationContext
+//
+// Scratch state a vehicle needs during one update, such as the vectors its
+// neighbor queries fill.  Rather than sharing such state through mutable
+// statics, each world (usually a PlugIn) owns SimulationContexts: one
+// context per thread of the WorkerPool which updates it.  A vehicle
+// updated on some thread uses that thread's context, so a world's vehicles
+// can be updated in parallel, and several worlds side by side, without
+// locks.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_SIMULATIONCONTEXT_H
+#define OPENSTEER_SIMULATIONCONTEXT_H
+
+
+#include "OpenSteer/AbstractVehicle.h"
+#include "OpenSteer/WorkerPool.h"
+
+#include <cassert>
+#include <vector>
+
+
+namespace OpenSteer {
+
+
+    class SimulationContext
+    {
+    public:
+
+        // scratch results of neighbor queries: each user clears one before
+        // filling it, their storage carries over from query to query
+        AVGroup neighbors;
+        AVNeighborGroup neighborRecords;
+    };
+
+
+    // ----------------------------------------------------------------------------
+
+
+    class SimulationContexts
+    {
+    public:
+
+        // a single context, enough for serial updates
+        SimulationContexts (void) : contexts (1) {}
+
+        // make sure every thread of pool has a context.  Call before each
+        // parallel update, from outside the pool's loops.
+        void prepare (const WorkerPool& pool)
+        {
+            if (contexts.size() < (size_t) pool.threadCount ())
+                contexts.resize (pool.threadCount ());
+        }
+
+        // make sure the calling thread has a context, for a serial update
+        // run on a pool's thread (such as a World's, see World.h)
+        void prepareForThisThread (void)
+        {
+            const size_t i = (size_t) WorkerPool::currentThreadIndex ();
+            if (contexts.size() <= i) contexts.resize (i + 1);
+        }
+
+        // the calling thread's context
+        SimulationContext& forThisThread (void)
+        {
+            const size_t i = (size_t) WorkerPool::currentThreadIndex ();
+            assert (i < contexts.size());
+            return contexts[i];
+        }
+
+        size_t size (void) const {return contexts.size();}
+        SimulationContext& operator[] (const size_t i) {return contexts[i];}
+
+    private:
+
+        std::vector<SimulationContext> contexts;
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_SIMULATIONCONTEXT_H
@@ -0,0 +1,203 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// SimulationSnapshot
+//
+// A copy of what one simulation step leaves for the display: the transform
+// of every vehicle of a PlugIn plus the annotation lines and circles queued
+// during the step.  It holds no pointers into the simulation, so it can be
+// drawn while the next step runs on another thread.
+//
+// SnapshotTripleBuffer hands snapshots from one writer thread (the
+// simulation) to one reader thread (the display) without either waiting
+// for the other.  The writer fills back(), then publish() swaps it with the
+// shared middle buffer.  The reader's acquire() swaps the middle buffer
+// with front() when a newer snapshot has been published since.  Snapshots
+// the reader is too slow to see are overwritten, never queued.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_SIMULATIONSNAPSHOT_H
+#define OPENSTEER_SIMULATIONSNAPSHOT_H
+
+
+#include <vector>
+#include <atomic>
+#include "OpenSteer/AbstractVehicle.h"
+#include "OpenSteer/Color.h"
+#include "OpenSteer/FrameHistory.h"
+#include "OpenSteer/MemoryAccount.h"
+
+
+namespace OpenSteer {
+
+
+    class AbstractPlugIn;
+
+
+    class SimulationSnapshot
+    {
+    public:
+
+        // a vehicle's local space, size and speed (plain data, as annotation
+        // streams copy it as raw bytes)
+        struct Vehicle
+        {
+            PlainVec3 side;
+            PlainVec3 up;
+            PlainVec3 forward;
+            PlainVec3 position;
+            float radius;
+            float speed;
+        };
+
+        // arguments of one deferredDrawLine call
+        struct Line
+        {
+            Vec3 startPoint;
+            Vec3 endPoint;
+            Color color;
+        };
+
+        // arguments of one deferredDrawCircleOrDisk call
+        struct CircleOrDisk
+        {
+            float radius;
+            Vec3 axis;
+            Vec3 center;
+            Color color;
+            int segments;
+            bool filled;
+            bool in3d;
+        };
+
+        SimulationSnapshot (void);
+
+        // forget the previous contents (keeping the storage for reuse)
+        void clear (void);
+
+        // copy the state of each vehicle of a group, noting the index of
+        // "selected" within it (or none if it is not in the group)
+        void captureVehicles (const AVGroup& group,
+                              const AbstractVehicle* selected);
+
+        void addLine (const Vec3& startPoint,
+                      const Vec3& endPoint,
+                      const Color& color);
+        void addCircleOrDisk (const float radius,
+                              const Vec3& axis,
+                              const Vec3& center,
+                              const Color& color,
+                              const int segments,
+                              const bool filled,
+                              const bool in3d);
+
+        // record of the selected vehicle, NULL if there is none
+        const Vehicle* selectedVehicle (void) const
+        {
+            return (selected < 0) ? 0 : &vehicles[selected];
+        }
+
+        // (charged to draw queue memory)
+        AccountedVector<Vehicle, MemoryAccount::drawQueueMemory>::type vehicles;
+        AccountedVector<Line, MemoryAccount::drawQueueMemory>::type lines;
+        AccountedVector<CircleOrDisk, MemoryAccount::drawQueueMemory>::type circles;
+
+        // index of the selected vehicle in "vehicles", -1 for none
+        int selected;
+
+        // PlugIn which produced the snapshot (only compared, never called)
+        const AbstractPlugIn* plugIn;
+
+        // simulation time at the end of the step and the step's length
+        float currentTime;
+        float elapsedTime;
+
+        // real time spent on the step and the stepping rate, in seconds
+        // and steps per second
+        float updateTime;
+        float stepsPerSecond;
+
+        bool paused;
+
+        // phase times and neighbor counts of the step, for the profiler
+        // display (only its update series are set by the simulation)
+        FrameSample frameSample;
+
+        // counts publications, so a reader can tell snapshots apart
+        unsigned long serialNumber;
+    };
+
+
+    // ------------------------------------------------------------------------
+
+
+    class SnapshotTripleBuffer
+    {
+    public:
+
+        SnapshotTripleBuffer (void);
+
+        // writer side: the snapshot being filled, then hand it over
+        SimulationSnapshot& back (void) {return buffers[backIndex];}
+        void publish (void);
+
+        // reader side: switch front() to the latest published snapshot.
+        // Returns false (leaving front() as it was) if nothing has been
+        // published since the previous acquire.
+        bool acquire (void);
+        const SimulationSnapshot& front (void) const
+        {
+            return buffers[frontIndex];
+        }
+
+    private:
+
+        // set in "middle" while it holds a snapshot the reader has not seen
+        static const int fresh = 4;
+
+        SimulationSnapshot buffers[3];
+        int backIndex;
+        int frontIndex;
+        std::atomic<int> middle;
+        unsigned long published;
+
+        // not copyable
+        SnapshotTripleBuffer (const SnapshotTripleBuffer&);
+        SnapshotTripleBuffer& operator= (const SnapshotTripleBuffer&);
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_SIMULATIONSNAPSHOT_H
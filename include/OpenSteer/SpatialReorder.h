@@ -0,0 +1,149 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// SpatialReorder
+//
+// Keeps a population's vehicles in spatially coherent order, so that
+// vehicles near each other in space are near each other in memory and
+// neighbor scans touch fewer cache lines.  Every period frames a pass
+// sorts the vehicles along a Morton (Z order) curve through the bounding
+// box of their positions.  The pass is spread over passFrames frames:
+// each frame moves the next share of the sorted order into place by
+// exchanges, in which the vehicle due at index k trades places with the
+// one there, so that index k is settled for the rest of the pass.
+//
+// The population carries out each frame's exchanges itself.  Exchanging
+// the vehicles' state between their storage (rather than the pointers to
+// them) moves them in memory while pointers to the storage stay valid,
+// but a pointer then refers to whichever vehicle now occupies that
+// storage, not to the vehicle it referred to before: the population
+// remaps the pointers and indices held to its vehicles by identity, and
+// what belongs to the storage (such as its proximity token) stays put.
+//
+// A pass in progress is abandoned when the population changes size.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_SPATIALREORDER_H
+#define OPENSTEER_SPATIALREORDER_H
+
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+#include "OpenSteer/Vec3.h"
+
+
+namespace OpenSteer {
+
+
+    // ----------------------------------------------------------------------------
+    // the position of a point along the Morton curve through a box: its
+    // coordinates quantized to 21 bits each (clamped to the box) and their
+    // bits interleaved
+
+
+    uint64_t mortonCode (const Vec3& point,
+                         const Vec3& minCorner,
+                         const Vec3& maxCorner);
+
+
+    // ----------------------------------------------------------------------------
+
+
+    class SpatialReorder
+    {
+    public:
+
+        // the vehicles at two indices trade places
+        typedef std::pair<size_t, size_t> Exchange;
+
+        SpatialReorder (void);
+
+        // a pass every period frames (zero for none), spread over
+        // passFrames frames (at least one)
+        void setSchedule (const int period, const int passFrames);
+        int period (void) const {return _period;}
+        int passFrames (void) const {return _passFrames;}
+
+        // called once per frame for a population of count vehicles: plans
+        // this frame's share of a pass in progress, and returns true when a
+        // pass is due to begin (with beginPass)
+        bool beginFrame (const size_t count);
+
+        // begin a pass over the vehicles at the given positions (in their
+        // current order), planning this frame's share of it
+        void beginPass (const Vec3* positions, const size_t count);
+
+        // abandon a pass in progress, such as when the vehicles have been
+        // replaced (the next pass is one period later)
+        void cancel (void);
+
+        // this frame's exchanges, to carry out in order
+        const std::vector<Exchange>& exchanges (void) const {return planned;}
+
+        bool passInProgress (void) const {return inProgress;}
+
+        // passes completed and exchanges planned so far
+        unsigned long passCount (void) const {return passes;}
+        unsigned long exchangeCount (void) const {return exchangesSoFar;}
+
+    private:
+
+        void planExchanges (void);
+
+        int _period;
+        int _passFrames;
+        int framesSincePass;
+        bool inProgress;
+
+        // the pass's sorted order (order[k] is the vehicle, by its index at
+        // the start of the pass, which belongs at index k), the vehicle
+        // now at each index and the index of each vehicle, and the next
+        // index to settle
+        std::vector<size_t> order;
+        std::vector<size_t> vehicleAt;
+        std::vector<size_t> indexOf;
+        size_t nextIndex;
+        size_t perFrame;
+
+        std::vector<Exchange> planned;
+        unsigned long passes;
+        unsigned long exchangesSoFar;
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_SPATIALREORDER_H
@@ -47,16 +47,87 @@
 #define OPENSTEER_STEERLIBRARY_H
 
 
+#include <cassert>
 #include "OpenSteer/AbstractVehicle.h"
+#include "OpenSteer/FlowField.h"
 #include "OpenSteer/Pathway.h"
+#include "OpenSteer/PathCursor.h"
+#include "OpenSteer/PolylineSegmentedPathwaySegmentRadii.h"
+#include "OpenSteer/PolylineSegmentedPathwaySingleRadius.h"
 #include "OpenSteer/Obstacle.h"
 #include "OpenSteer/Utilities.h"
+#include "OpenSteer/Vec3Batch.h"
 
 // Include OpenSteer::Color, OpenSteer::gBlack, ...
 #include "Color.h"
 
 namespace OpenSteer {
 
+    // ----------------------------------------------------------------------------
+    // StaticVehicleAccess: reads the vehicle state used by the neighbor
+    // behaviors through qualified, non-virtual calls, so when Vehicle is a
+    // concrete type the compiler can inline them.  Vehicle has to be the
+    // most derived type of every vehicle passed in (a subclass overriding
+    // position() would otherwise be bypassed).  The AbstractVehicle
+    // specialization keeps ordinary virtual dispatch and is what the
+    // AVGroup versions of the behaviors use.
+
+
+    template <class Vehicle>
+    struct StaticVehicleAccess
+    {
+        static Vec3 position (const Vehicle& v) {return v.Vehicle::position ();}
+        static Vec3 forward (const Vehicle& v) {return v.Vehicle::forward ();}
+        static Vec3 side (const Vehicle& v) {return v.Vehicle::side ();}
+        static Vec3 velocity (const Vehicle& v) {return v.Vehicle::velocity ();}
+        static float speed (const Vehicle& v) {return v.Vehicle::speed ();}
+        static float radius (const Vehicle& v) {return v.Vehicle::radius ();}
+    };
+
+
+    template <>
+    struct StaticVehicleAccess<AbstractVehicle>
+    {
+        static Vec3 position (const AbstractVehicle& v) {return v.position ();}
+        static Vec3 forward (const AbstractVehicle& v) {return v.forward ();}
+        static Vec3 side (const AbstractVehicle& v) {return v.side ();}
+        static Vec3 velocity (const AbstractVehicle& v) {return v.velocity ();}
+        static float speed (const AbstractVehicle& v) {return v.speed ();}
+        static float radius (const AbstractVehicle& v) {return v.radius ();}
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // BoidBehavior: one of the boid behaviors combined by steerForFlocking,
+    // its neighborhood (as for steerForSeparation and the others) and the
+    // weight of its steering in the sum
+
+
+    class BoidBehavior
+    {
+    public:
+        enum Kind {separation, alignment, cohesion};
+
+        BoidBehavior (const Kind k,
+                      const float maxDistance,
+                      const float cosMaxAngle,
+                      const float weight)
+            : kind (k),
+              maxDistance (maxDistance),
+              cosMaxAngle (cosMaxAngle),
+              weight (weight)
+        {}
+
+        Kind kind;
+        float maxDistance;
+        float cosMaxAngle;
+        float weight;
+    };
+
+    // the most behaviors one steerForFlocking call combines
+    const int maxBoidBehaviors = 8;
+
+
     // ----------------------------------------------------------------------------
 
 
@@ -97,6 +168,12 @@ namespace OpenSteer {
 
         // -------------------------------------------------- steering behaviors
 
+        // this vehicle's own random number stream (see Random.h), used by
+        // steerForWander.  Drawing from it rather than from frandom01 keeps
+        // a vehicle's behavior independent of which thread updates it.
+        RandomStream& randomStream (void) {return _randomStream;}
+        const RandomStream& randomStream (void) const {return _randomStream;}
+
         // Wander behavior
         float WanderSide;
         float WanderUp;
@@ -115,8 +192,76 @@ namespace OpenSteer {
         // Path Following behaviors
         Vec3 steerToFollowPath (const int direction,
                                 const float predictionTime,
-                                Pathway& path);
-        Vec3 steerToStayOnPath (const float predictionTime, Pathway& path);
+                                const Pathway& path);
+        Vec3 steerToStayOnPath (const float predictionTime, const Pathway& path);
+
+        // as above, with a cursor the vehicle keeps for the path so each
+        // query starts its search at the segment found in the last one
+        Vec3 steerToFollowPath (const int direction,
+                                const float predictionTime,
+                                const Pathway& path,
+                                PathCursor& cursor);
+        Vec3 steerToStayOnPath (const float predictionTime,
+                                const Pathway& path,
+                                PathCursor& cursor);
+
+        // as above for the polyline pathways, calling their queries directly
+        // rather than through the virtual Pathway interface, and mapping the
+        // predicted position to the path once rather than twice
+        Vec3 steerToFollowPath (const int direction,
+                                const float predictionTime,
+                                const PolylineSegmentedPathwaySingleRadius& path,
+                                PathCursor& cursor)
+        {
+            return steerToFollowPolylinePathway (direction, predictionTime,
+                                                 path, cursor);
+        }
+        Vec3 steerToFollowPath (const int direction,
+                                const float predictionTime,
+                                const PolylineSegmentedPathwaySegmentRadii& path,
+                                PathCursor& cursor)
+        {
+            return steerToFollowPolylinePathway (direction, predictionTime,
+                                                 path, cursor);
+        }
+        Vec3 steerToStayOnPath (const float predictionTime,
+                                const PolylineSegmentedPathwaySingleRadius& path,
+                                PathCursor& cursor)
+        {
+            return steerToStayOnPolylinePathway (predictionTime, path, cursor);
+        }
+        Vec3 steerToStayOnPath (const float predictionTime,
+                                const PolylineSegmentedPathwaySegmentRadii& path,
+                                PathCursor& cursor)
+        {
+            return steerToStayOnPolylinePathway (predictionTime, path, cursor);
+        }
+
+        // the above for either polyline pathway class
+        template <class PathType>
+        Vec3 steerToFollowPolylinePathway (const int direction,
+                                           const float predictionTime,
+                                           const PathType& path,
+                                           PathCursor& cursor);
+        template <class PathType>
+        Vec3 steerToStayOnPolylinePathway (const float predictionTime,
+                                           const PathType& path,
+                                           PathCursor& cursor);
+
+        // as above, mapping the vehicle's position and predicted position
+        // to the path by a FlowField of it where that is exact, and with
+        // the pathway (as above) where it is not
+        template <class PathType>
+        Vec3 steerToFollowPath (const int direction,
+                                const float predictionTime,
+                                const PathType& path,
+                                const FlowField& field,
+                                PathCursor& cursor);
+        template <class PathType>
+        Vec3 steerToStayOnPath (const float predictionTime,
+                                const PathType& path,
+                                const FlowField& field,
+                                PathCursor& cursor);
 
         // ------------------------------------------------------------------------
         // Obstacle Avoidance behavior
@@ -139,6 +284,11 @@ namespace OpenSteer {
         Vec3 steerToAvoidObstacles (const float minTimeToCollision,
                                     const ObstacleGroup& obstacles);
 
+        // as above, testing only obstacles of an ObstacleIndex near the path
+
+        Vec3 steerToAvoidObstacles (const float minTimeToCollision,
+                                    const ObstacleIndex& obstacles);
+
 
         // ------------------------------------------------------------------------
         // Unaligned collision avoidance behavior: avoid colliding with other
@@ -216,6 +366,103 @@ namespace OpenSteer {
                                const AVGroup& flock);
 
 
+        // ------------------------------------------------------------------------
+        // versions of the boid behaviors taking proximity query records made
+        // from a query centered at this vehicle's position: they use the
+        // recorded offsets and distances instead of recomputing them
+
+
+        bool inBoidNeighborhood (const AVNeighbor& neighbor,
+                                 const float minDistance,
+                                 const float maxDistance,
+                                 const float cosMaxAngle);
+
+        Vec3 steerForSeparation (const float maxDistance,
+                                 const float cosMaxAngle,
+                                 const AVNeighborGroup& flock);
+
+        Vec3 steerForAlignment (const float maxDistance,
+                                const float cosMaxAngle,
+                                const AVNeighborGroup& flock);
+
+        Vec3 steerForCohesion (const float maxDistance,
+                               const float cosMaxAngle,
+                               const AVNeighborGroup& flock);
+
+        // the weighted sum of count (at most maxBoidBehaviors) boid
+        // behaviors, found in one pass over the records: each neighbor's
+        // offset angle is computed once for all of them.  Returns exactly
+        // the sum, in order, of each behavior's steering (from the separate
+        // versions above) times its weight.
+        Vec3 steerForFlocking (const BoidBehavior* behaviors,
+                               const int count,
+                               const AVNeighborGroup& flock);
+
+
+        // ------------------------------------------------------------------------
+        // statically dispatched versions of the neighbor behaviors, for a
+        // flock whose members (this vehicle included) are all of the concrete
+        // type Vehicle, called as steerForSeparation<Boid> (...).  They give
+        // the same results as the versions above, which forward to them with
+        // Vehicle = AbstractVehicle.  Element is the neighbor container's
+        // pointer type, so both AVGroup and std::vector<Vehicle*> work.
+
+
+        template <class Vehicle, class Element>
+        Vec3 steerToAvoidNeighbors (const float minTimeToCollision,
+                                    const std::vector<Element*>& others);
+
+        template <class Vehicle, class Element>
+        Vec3 steerToAvoidCloseNeighbors (const float minSeparationDistance,
+                                         const std::vector<Element*>& others);
+
+        // used by steerToAvoidNeighbors: the other vehicle whose nearest
+        // approach comes soonest (in the future but within minTimeToCollision
+        // seconds) among those passing closer than twice our radius, with
+        // our and its positions then, or NULL if there is none.  Others are
+        // taken in batches for nearestApproachMany (see Vec3Batch.h).
+        template <class Vehicle, class Element>
+        const Vehicle* findNearestApproachThreat (const float minTimeToCollision,
+                                                  const std::vector<Element*>& others,
+                                                  Vec3& ourPosition,
+                                                  Vec3& threatPosition);
+
+        template <class Vehicle, class Element>
+        Vec3 steerForSeparation (const float maxDistance,
+                                 const float cosMaxAngle,
+                                 const std::vector<Element*>& flock);
+
+        template <class Vehicle, class Element>
+        Vec3 steerForAlignment (const float maxDistance,
+                                const float cosMaxAngle,
+                                const std::vector<Element*>& flock);
+
+        template <class Vehicle, class Element>
+        Vec3 steerForCohesion (const float maxDistance,
+                               const float cosMaxAngle,
+                               const std::vector<Element*>& flock);
+
+        template <class Vehicle>
+        Vec3 steerForSeparation (const float maxDistance,
+                                 const float cosMaxAngle,
+                                 const AVNeighborGroup& flock);
+
+        template <class Vehicle>
+        Vec3 steerForAlignment (const float maxDistance,
+                                const float cosMaxAngle,
+                                const AVNeighborGroup& flock);
+
+        template <class Vehicle>
+        Vec3 steerForCohesion (const float maxDistance,
+                               const float cosMaxAngle,
+                               const AVNeighborGroup& flock);
+
+        template <class Vehicle>
+        Vec3 steerForFlocking (const BoidBehavior* behaviors,
+                               const int count,
+                               const AVNeighborGroup& flock);
+
+
         // ------------------------------------------------------------------------
         // pursuit of another vehicle (& version with ceiling on prediction time)
 
@@ -255,19 +502,43 @@ namespace OpenSteer {
         bool isAside (const Vec3& target) const {return isAside (target, 0.707f);};
         bool isBehind (const Vec3& target) const {return isBehind (target, -0.707f);};
 
+        // (with approximate math, see Utilities.h, these compare squares
+        // rather than normalize the offset to the target)
         bool isAhead (const Vec3& target, float cosThreshold) const
         {
+            if (approximateMathIsOn ())
+            {
+                const Vec3 offset = target - position ();
+                return cosineExceeds (forward().dot(offset),
+                                      offset.lengthSquared (),
+                                      cosThreshold);
+            }
             const Vec3 targetDirection = (target - position ()).normalize ();
             return forward().dot(targetDirection) > cosThreshold;
         };
         bool isAside (const Vec3& target, float cosThreshold) const
         {
+            if (approximateMathIsOn ())
+            {
+                const Vec3 offset = target - position ();
+                const float dp = forward().dot(offset);
+                const float lengthSquared = offset.lengthSquared ();
+                return (cosineExceeds (-dp, lengthSquared, -cosThreshold) &&
+                        cosineExceeds (dp, lengthSquared, -cosThreshold));
+            }
             const Vec3 targetDirection = (target - position ()).normalize ();
             const float dp = forward().dot(targetDirection);
             return (dp < cosThreshold) && (dp > -cosThreshold);
         };
         bool isBehind (const Vec3& target, float cosThreshold) const
         {
+            if (approximateMathIsOn ())
+            {
+                const Vec3 offset = target - position ();
+                return cosineExceeds (-forward().dot(offset),
+                                      offset.lengthSquared (),
+                                      -cosThreshold);
+            }
             const Vec3 targetDirection = (target - position()).normalize ();
             return forward().dot(targetDirection) < cosThreshold;
         };
@@ -307,6 +578,43 @@ namespace OpenSteer {
                                             const Vec3& /*threatFuture*/)
         {
         }
+
+    private:
+
+        RandomStream _randomStream;
+
+        // this vehicle seen as its concrete type
+        template <class Vehicle>
+        const Vehicle& asVehicle (void) const
+        {
+            return static_cast<const Vehicle&> (*this);
+        }
+
+        // pairwise helpers shared by the virtual and the static versions
+        template <class Vehicle>
+        static float predictNearestApproachTime (const Vehicle& self,
+                                                 const Vehicle& otherVehicle);
+
+        template <class Vehicle>
+        static float computeNearestApproachPositions (const Vehicle& self,
+                                                      const Vehicle& otherVehicle,
+                                                      float time,
+                                                      Vec3& ourPosition,
+                                                      Vec3& hisPosition);
+
+        template <class Vehicle>
+        static bool inBoidNeighborhood (const Vehicle& self,
+                                        const Vehicle& otherVehicle,
+                                        const float minDistance,
+                                        const float maxDistance,
+                                        const float cosMaxAngle);
+
+        static bool inBoidNeighborhood (const AVNeighbor& neighbor,
+                                        const AbstractVehicle* self,
+                                        const Vec3& selfForward,
+                                        const float minDistance,
+                                        const float maxDistance,
+                                        const float cosMaxAngle);
     };
 
     
@@ -322,8 +630,8 @@ steerForWander (float dt)
 {
     // random walk WanderSide and WanderUp between -1 and +1
     const float speed = 12.0f * dt; // maybe this (12) should be an argument?
-    WanderSide = scalarRandomWalk (WanderSide, speed, -1, +1);
-    WanderUp   = scalarRandomWalk (WanderUp,   speed, -1, +1);
+    WanderSide = scalarRandomWalk (_randomStream, WanderSide, speed, -1, +1);
+    WanderUp   = scalarRandomWalk (_randomStream, WanderUp,   speed, -1, +1);
 
     // return a pure lateral steering vector: (+/-Side) + (+/-Up)
     return (side() * WanderSide) + (up() * WanderUp);
@@ -393,7 +701,19 @@ xxxsteerForSeek (const Vec3& target)
 template<class Super>
 OpenSteer::Vec3
 OpenSteer::SteerLibraryMixin<Super>::
-steerToStayOnPath (const float predictionTime, Pathway& path)
+steerToStayOnPath (const float predictionTime, const Pathway& path)
+{
+    PathCursor cursor;
+    return steerToStayOnPath (predictionTime, path, cursor);
+}
+
+
+template<class Super>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerToStayOnPath (const float predictionTime,
+                   const Pathway& path,
+                   PathCursor& cursor)
 {
     // predict our future position
     const Vec3 futurePosition = predictFuturePosition (predictionTime);
@@ -403,7 +723,8 @@ steerToStayOnPath (const float predictionTime, Pathway& path)
     float outside;
     const Vec3 onPath = path.mapPointToPath (futurePosition,
                                              tangent,     // output argument
-                                             outside);    // output argument
+                                             outside,     // output argument
+                                             cursor);
 
     if (outside < 0)
     {
@@ -416,7 +737,8 @@ steerToStayOnPath (const float predictionTime, Pathway& path)
         // our predicted future position was outside the path, need to
         // steer towards it.  Use onPath projection of futurePosition
         // as seek target
-        annotatePathFollowing (futurePosition, onPath, onPath, outside);
+        if (Super::hasAnnotation)
+            annotatePathFollowing (futurePosition, onPath, onPath, outside);
         return steerForSeek (onPath);
     }
 }
@@ -427,7 +749,20 @@ OpenSteer::Vec3
 OpenSteer::SteerLibraryMixin<Super>::
 steerToFollowPath (const int direction,
                    const float predictionTime,
-                   Pathway& path)
+                   const Pathway& path)
+{
+    PathCursor cursor;
+    return steerToFollowPath (direction, predictionTime, path, cursor);
+}
+
+
+template<class Super>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerToFollowPath (const int direction,
+                   const float predictionTime,
+                   const Pathway& path,
+                   PathCursor& cursor)
 {
     // our goal will be offset from our path distance by this amount
     const float pathDistanceOffset = direction * predictionTime * speed();
@@ -437,9 +772,9 @@ steerToFollowPath (const int direction,
 
     // measure distance along path of our current and predicted positions
     const float nowPathDistance =
-        path.mapPointToPathDistance (position ());
+        path.mapPointToPathDistance (position (), cursor);
     const float futurePathDistance =
-        path.mapPointToPathDistance (futurePosition);
+        path.mapPointToPathDistance (futurePosition, cursor);
 
     // are we facing in the correction direction?
     const bool rightway = ((pathDistanceOffset > 0) ?
@@ -455,7 +790,8 @@ steerToFollowPath (const int direction,
     const Vec3 onPath = path.mapPointToPath (futurePosition,
                                              // output arguments:
                                              tangent,
-                                             outside);
+                                             outside,
+                                             cursor);
 
     // no steering is required if (a) our future position is inside
     // the path tube and (b) we are facing in the correct direction
@@ -470,9 +806,10 @@ steerToFollowPath (const int direction,
         // by adding pathDistanceOffset to our current path position
 
         float const targetPathDistance = nowPathDistance + pathDistanceOffset;
-        Vec3 const target = path.mapPathDistanceToPoint (targetPathDistance);
+        Vec3 const target = path.mapPathDistanceToPoint (targetPathDistance, cursor);
 
-        annotatePathFollowing (futurePosition, onPath, target, outside);
+        if (Super::hasAnnotation)
+            annotatePathFollowing (futurePosition, onPath, target, outside);
 
         // return steering to seek target on path
         return steerForSeek (target);
@@ -480,6 +817,153 @@ steerToFollowPath (const int direction,
 }
 
 
+// ----------------------------------------------------------------------------
+// The path following behaviors above for the polyline pathways.  The
+// queries are qualified with the pathway class so they are not virtual
+// calls, and mapPointToPathAndDistance gives the predicted position's path
+// distance and point on the path with one search.  The results are those
+// of the Pathway versions.
+
+
+template<class Super>
+template<class PathType>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerToStayOnPolylinePathway (const float predictionTime,
+                              const PathType& path,
+                              PathCursor& cursor)
+{
+    const Vec3 futurePosition = predictFuturePosition (predictionTime);
+
+    Vec3 tangent;
+    float outside;
+    const Vec3 onPath = path.PathType::mapPointToPath (futurePosition,
+                                                        tangent,
+                                                        outside,
+                                                        cursor);
+    if (outside < 0) return Vec3::zero;
+
+    if (Super::hasAnnotation)
+        annotatePathFollowing (futurePosition, onPath, onPath, outside);
+    return steerForSeek (onPath);
+}
+
+
+template<class Super>
+template<class PathType>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerToFollowPolylinePathway (const int direction,
+                              const float predictionTime,
+                              const PathType& path,
+                              PathCursor& cursor)
+{
+    const float pathDistanceOffset = direction * predictionTime * speed();
+    const Vec3 futurePosition = predictFuturePosition (predictionTime);
+
+    const float nowPathDistance =
+        path.PathType::mapPointToPathDistance (position (), cursor);
+    Vec3 tangent;
+    float outside;
+    float futurePathDistance;
+    const Vec3 onPath =
+        path.PathType::mapPointToPathAndDistance (futurePosition,
+                                                   tangent,
+                                                   outside,
+                                                   futurePathDistance,
+                                                   cursor);
+
+    const bool rightway = ((pathDistanceOffset > 0) ?
+                           (nowPathDistance < futurePathDistance) :
+                           (nowPathDistance > futurePathDistance));
+    if ((outside < 0) && rightway) return Vec3::zero;
+
+    const float targetPathDistance = nowPathDistance + pathDistanceOffset;
+    const Vec3 target =
+        path.PathType::mapPathDistanceToPoint (targetPathDistance,
+                                               cursor);
+
+    if (Super::hasAnnotation)
+        annotatePathFollowing (futurePosition, onPath, target, outside);
+    return steerForSeek (target);
+}
+
+
+// ----------------------------------------------------------------------------
+// The polyline path following behaviors above with a FlowField of the
+// path.  Inside the pathway, away from its boundary, bends and ends, the
+// position and predicted position are mapped by the field's lookup.
+// Elsewhere the behaviors above are used.  Only the target of a vehicle
+// which needs to steer back along the path is mapped by the pathway.
+
+
+template<class Super>
+template<class PathType>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerToStayOnPath (const float predictionTime,
+                   const PathType& path,
+                   const FlowField& field,
+                   PathCursor& cursor)
+{
+    const Vec3 futurePosition = predictFuturePosition (predictionTime);
+    if (field.interior (futurePosition)) return Vec3::zero;
+
+    Vec3 tangent;
+    float outside;
+    float pathDistance;
+    Vec3 onPath;
+    if (! field.lookup (futurePosition,
+                        onPath, tangent, outside, pathDistance))
+        return steerToStayOnPolylinePathway (predictionTime, path, cursor);
+    if (outside < 0) return Vec3::zero;
+
+    if (Super::hasAnnotation)
+        annotatePathFollowing (futurePosition, onPath, onPath, outside);
+    return steerForSeek (onPath);
+}
+
+
+template<class Super>
+template<class PathType>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerToFollowPath (const int direction,
+                   const float predictionTime,
+                   const PathType& path,
+                   const FlowField& field,
+                   PathCursor& cursor)
+{
+    const float pathDistanceOffset = direction * predictionTime * speed();
+    const Vec3 futurePosition = predictFuturePosition (predictionTime);
+
+    float nowPathDistance;
+    Vec3 tangent;
+    float outside;
+    float futurePathDistance;
+    Vec3 onPath;
+    if (! (field.lookupPathDistance (position (), nowPathDistance) &&
+           field.lookup (futurePosition,
+                         onPath, tangent, outside, futurePathDistance)))
+        return steerToFollowPolylinePathway (direction, predictionTime,
+                                             path, cursor);
+
+    const bool rightway = ((pathDistanceOffset > 0) ?
+                           (nowPathDistance < futurePathDistance) :
+                           (nowPathDistance > futurePathDistance));
+    if ((outside < 0) && rightway) return Vec3::zero;
+
+    const float targetPathDistance = nowPathDistance + pathDistanceOffset;
+    const Vec3 target =
+        path.PathType::mapPathDistanceToPoint (targetPathDistance,
+                                               cursor);
+
+    if (Super::hasAnnotation)
+        annotatePathFollowing (futurePosition, onPath, target, outside);
+    return steerForSeek (target);
+}
+
+
 // ----------------------------------------------------------------------------
 // Obstacle Avoidance behavior
 //
@@ -510,7 +994,7 @@ steerToAvoidObstacle (const float minTimeToCollision,
     const Vec3 avoidance = obstacle.steerToAvoid (*this, minTimeToCollision);
 
     // XXX more annotation modularity problems (assumes spherical obstacle)
-    if (avoidance != Vec3::zero)
+    if (Super::hasAnnotation && (avoidance != Vec3::zero))
         annotateAvoidObstacle (minTimeToCollision * speed());
 
     return avoidance;
@@ -530,7 +1014,26 @@ steerToAvoidObstacles (const float minTimeToCollision,
                                                             obstacles);
 
     // XXX more annotation modularity problems (assumes spherical obstacle)
-    if (avoidance != Vec3::zero)
+    if (Super::hasAnnotation && (avoidance != Vec3::zero))
+        annotateAvoidObstacle (minTimeToCollision * speed());
+
+    return avoidance;
+}
+
+
+// this version avoids the obstacles of an ObstacleIndex
+
+template<class Super>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerToAvoidObstacles (const float minTimeToCollision,
+                       const ObstacleIndex& obstacles)
+{
+    const Vec3 avoidance = obstacles.steerToAvoidObstacles (*this,
+                                                            minTimeToCollision);
+
+    // XXX more annotation modularity problems (assumes spherical obstacle)
+    if (Super::hasAnnotation && (avoidance != Vec3::zero))
         annotateAvoidObstacle (minTimeToCollision * speed());
 
     return avoidance;
@@ -551,69 +1054,50 @@ OpenSteer::SteerLibraryMixin<Super>::
 steerToAvoidNeighbors (const float minTimeToCollision,
                        const AVGroup& others)
 {
+    return steerToAvoidNeighbors<AbstractVehicle> (minTimeToCollision, others);
+}
+
+
+template<class Super>
+template<class Vehicle, class Element>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerToAvoidNeighbors (const float minTimeToCollision,
+                       const std::vector<Element*>& others)
+{
+    typedef StaticVehicleAccess<Vehicle> Access;
+    const Vehicle& self = asVehicle<Vehicle> ();
+
     // first priority is to prevent immediate interpenetration
-    const Vec3 separation = steerToAvoidCloseNeighbors (0, others);
+    const Vec3 separation = steerToAvoidCloseNeighbors<Vehicle> (0, others);
     if (separation != Vec3::zero) return separation;
 
-    // otherwise, go on to consider potential future collisions
+    // otherwise, go on to consider potential future collisions: determine
+    // which (if any) of the other vehicles poses the most immediate threat
     float steer = 0;
-    AbstractVehicle* threat = NULL;
-
-    // Time (in seconds) until the most immediate collision threat found
-    // so far.  Initial value is a threshold: don't look more than this
-    // many frames into the future.
-    float minTime = minTimeToCollision;
+    const Vehicle* threat =
+        findNearestApproachThreat<Vehicle> (minTimeToCollision,
+                                            others,
+                                            ourPositionAtNearestApproach,
+                                            hisPositionAtNearestApproach);
 
     // xxx solely for annotation
-    Vec3 xxxThreatPositionAtNearestApproach;
-    Vec3 xxxOurPositionAtNearestApproach;
-
-    // for each of the other vehicles, determine which (if any)
-    // pose the most immediate threat of collision.
-    for (AVIterator i = others.begin(); i != others.end(); i++)
-    {
-        AbstractVehicle& other = **i;
-        if (&other != this)
-        {	
-            // avoid when future positions are this close (or less)
-            const float collisionDangerThreshold = radius() * 2;
-
-            // predicted time until nearest approach of "this" and "other"
-            const float time = predictNearestApproachTime (other);
-
-            // If the time is in the future, sooner than any other
-            // threatened collision...
-            if ((time >= 0) && (time < minTime))
-            {
-                // if the two will be close enough to collide,
-                // make a note of it
-                if (computeNearestApproachPositions (other, time)
-                    < collisionDangerThreshold)
-                {
-                    minTime = time;
-                    threat = &other;
-                    xxxThreatPositionAtNearestApproach
-                        = hisPositionAtNearestApproach;
-                    xxxOurPositionAtNearestApproach
-                        = ourPositionAtNearestApproach;
-                }
-            }
-        }
-    }
+    const Vec3 xxxThreatPositionAtNearestApproach = hisPositionAtNearestApproach;
+    const Vec3 xxxOurPositionAtNearestApproach = ourPositionAtNearestApproach;
 
     // if a potential collision was found, compute steering to avoid
     if (threat != NULL)
     {
         // parallel: +1, perpendicular: 0, anti-parallel: -1
-        float parallelness = forward().dot(threat->forward());
+        float parallelness = Access::forward (self).dot (Access::forward (*threat));
         float angle = 0.707f;
 
         if (parallelness < -angle)
         {
             // anti-parallel "head on" paths:
             // steer away from future threat position
-            Vec3 offset = xxxThreatPositionAtNearestApproach - position();
-            float sideDot = offset.dot(side());
+            Vec3 offset = xxxThreatPositionAtNearestApproach - Access::position (self);
+            float sideDot = offset.dot (Access::side (self));
             steer = (sideDot > 0) ? -1.0f : 1.0f;
         }
         else
@@ -621,33 +1105,105 @@ steerToAvoidNeighbors (const float minTimeToCollision,
             if (parallelness > angle)
             {
                 // parallel paths: steer away from threat
-                Vec3 offset = threat->position() - position();
-                float sideDot = offset.dot(side());
+                Vec3 offset = Access::position (*threat) - Access::position (self);
+                float sideDot = offset.dot (Access::side (self));
                 steer = (sideDot > 0) ? -1.0f : 1.0f;
             }
             else
             {
                 // perpendicular paths: steer behind threat
                 // (only the slower of the two does this)
-                if (threat->speed() <= speed())
+                if (Access::speed (*threat) <= Access::speed (self))
                 {
-                    float sideDot = side().dot(threat->velocity());
+                    float sideDot = Access::side (self).dot (Access::velocity (*threat));
                     steer = (sideDot > 0) ? -1.0f : 1.0f;
                 }
             }
         }
 
-        annotateAvoidNeighbor (*threat,
-                               steer,
-                               xxxOurPositionAtNearestApproach,
-                               xxxThreatPositionAtNearestApproach);
+        if (Super::hasAnnotation)
+            annotateAvoidNeighbor (*threat,
+                                   steer,
+                                   xxxOurPositionAtNearestApproach,
+                                   xxxThreatPositionAtNearestApproach);
     }
 
-    return side() * steer;
+    return Access::side (self) * steer;
 }
 
 
 
+template<class Super>
+template<class Vehicle, class Element>
+const Vehicle*
+OpenSteer::SteerLibraryMixin<Super>::
+findNearestApproachThreat (const float minTimeToCollision,
+                           const std::vector<Element*>& others,
+                           Vec3& ourPosition,
+                           Vec3& threatPosition)
+{
+    typedef StaticVehicleAccess<Vehicle> Access;
+    const Vehicle& self = asVehicle<Vehicle> ();
+    const Vec3 selfPosition = Access::position (self);
+    const Vec3 selfVelocity = Access::velocity (self);
+
+    // avoid when future positions are this close (or less)
+    const float collisionDangerThreshold = Access::radius (self) * 2;
+
+    // Time (in seconds) until the most immediate collision threat found
+    // so far.  Initial value is a threshold: don't look more than this
+    // many frames into the future.
+    float minTime = minTimeToCollision;
+    const Vehicle* threat = NULL;
+
+    // gather the others into structure-of-arrays batches, then take the
+    // threats of each batch in order
+    const size_t batchSize = 8;
+    float px[batchSize], py[batchSize], pz[batchSize];
+    float vx[batchSize], vy[batchSize], vz[batchSize];
+    float time[batchSize], distance[batchSize];
+    const Vehicle* batch[batchSize];
+
+    typedef typename std::vector<Element*>::const_iterator iterator;
+    iterator i = others.begin();
+    while (i != others.end())
+    {
+        size_t count = 0;
+        for (; (i != others.end()) && (count < batchSize); i++)
+        {
+            const Vehicle& other = static_cast<const Vehicle&> (**i);
+            if (&other == &self) continue;
+            const Vec3 p = Access::position (other);
+            const Vec3 v = Access::velocity (other);
+            px[count] = p.x; py[count] = p.y; pz[count] = p.z;
+            vx[count] = v.x; vy[count] = v.y; vz[count] = v.z;
+            batch[count++] = &other;
+        }
+
+        nearestApproachMany (selfPosition, selfVelocity,
+                             px, py, pz, vx, vy, vz, count, time, distance);
+
+        // If the time is in the future, sooner than any other threatened
+        // collision, and the two will be close enough to collide, make a
+        // note of it
+        for (size_t j = 0; j < count; j++)
+        {
+            if ((time[j] >= 0) && (time[j] < minTime) &&
+                (distance[j] < collisionDangerThreshold))
+            {
+                minTime = time[j];
+                threat = batch[j];
+            }
+        }
+    }
+
+    if (threat != NULL)
+        computeNearestApproachPositions (self, *threat, minTime,
+                                         ourPosition, threatPosition);
+    return threat;
+}
+
+
 // Given two vehicles, based on their current positions and velocities,
 // determine the time until nearest approach
 //
@@ -658,10 +1214,22 @@ float
 OpenSteer::SteerLibraryMixin<Super>::
 predictNearestApproachTime (AbstractVehicle& otherVehicle)
 {
+    return predictNearestApproachTime<AbstractVehicle> (*this, otherVehicle);
+}
+
+
+template<class Super>
+template<class Vehicle>
+float
+OpenSteer::SteerLibraryMixin<Super>::
+predictNearestApproachTime (const Vehicle& self, const Vehicle& otherVehicle)
+{
+    typedef StaticVehicleAccess<Vehicle> Access;
+
     // imagine we are at the origin with no velocity,
     // compute the relative velocity of the other vehicle
-    const Vec3 myVelocity = velocity();
-    const Vec3 otherVelocity = otherVehicle.velocity();
+    const Vec3 myVelocity = Access::velocity (self);
+    const Vec3 otherVelocity = Access::velocity (otherVehicle);
     const Vec3 relVelocity = otherVelocity - myVelocity;
     const float relSpeed = relVelocity.length();
 
@@ -679,7 +1247,7 @@ predictNearestApproachTime (AbstractVehicle& otherVehicle)
 
     // find distance from its path to origin (compute offset from
     // other to us, find length of projection onto path)
-    const Vec3 relPosition = position() - otherVehicle.position();
+    const Vec3 relPosition = Access::position (self) - Access::position (otherVehicle);
     const float projection = relTangent.dot(relPosition);
 
     return projection / relSpeed;
@@ -697,15 +1265,34 @@ OpenSteer::SteerLibraryMixin<Super>::
 computeNearestApproachPositions (AbstractVehicle& otherVehicle,
                                  float time)
 {
-    const Vec3    myTravel =       forward () *       speed () * time;
-    const Vec3 otherTravel = otherVehicle.forward () * otherVehicle.speed () * time;
+    return computeNearestApproachPositions<AbstractVehicle>
+        (*this, otherVehicle, time,
+         ourPositionAtNearestApproach,   // output argument (for annotation)
+         hisPositionAtNearestApproach);  // output argument (for annotation)
+}
+
+
+template<class Super>
+template<class Vehicle>
+float
+OpenSteer::SteerLibraryMixin<Super>::
+computeNearestApproachPositions (const Vehicle& self,
+                                 const Vehicle& otherVehicle,
+                                 float time,
+                                 Vec3& ourPosition,
+                                 Vec3& hisPosition)
+{
+    typedef StaticVehicleAccess<Vehicle> Access;
+
+    const Vec3    myTravel = Access::forward (self) * Access::speed (self) * time;
+    const Vec3 otherTravel = Access::forward (otherVehicle) *
+                             Access::speed (otherVehicle) * time;
 
-    const Vec3    myFinal =       position () +    myTravel;
-    const Vec3 otherFinal = otherVehicle.position () + otherTravel;
+    const Vec3    myFinal = Access::position (self) +    myTravel;
+    const Vec3 otherFinal = Access::position (otherVehicle) + otherTravel;
 
-    // xxx for annotation
-    ourPositionAtNearestApproach = myFinal;
-    hisPositionAtNearestApproach = otherFinal;
+    ourPosition = myFinal;
+    hisPosition = otherFinal;
 
     return Vec3::distance (myFinal, otherFinal);
 }
@@ -726,21 +1313,38 @@ OpenSteer::SteerLibraryMixin<Super>::
 steerToAvoidCloseNeighbors (const float minSeparationDistance,
                             const AVGroup& others)
 {
+    return steerToAvoidCloseNeighbors<AbstractVehicle> (minSeparationDistance,
+                                                        others);
+}
+
+
+template<class Super>
+template<class Vehicle, class Element>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerToAvoidCloseNeighbors (const float minSeparationDistance,
+                            const std::vector<Element*>& others)
+{
+    typedef StaticVehicleAccess<Vehicle> Access;
+    const Vehicle& self = asVehicle<Vehicle> ();
+
     // for each of the other vehicles...
-    for (AVIterator i = others.begin(); i != others.end(); i++)    
+    typedef typename std::vector<Element*>::const_iterator iterator;
+    for (iterator i = others.begin(); i != others.end(); i++)    
     {
-        AbstractVehicle& other = **i;
-        if (&other != this)
+        const Vehicle& other = static_cast<const Vehicle&> (**i);
+        if (&other != &self)
         {
-            const float sumOfRadii = radius() + other.radius();
+            const float sumOfRadii = Access::radius (self) + Access::radius (other);
             const float minCenterToCenter = minSeparationDistance + sumOfRadii;
-            const Vec3 offset = other.position() - position();
+            const Vec3 offset = Access::position (other) - Access::position (self);
             const float currentDistance = offset.length();
 
             if (currentDistance < minCenterToCenter)
             {
-                annotateAvoidCloseNeighbor (other, minSeparationDistance);
-                return (-offset).perpendicularComponent (forward());
+                if (Super::hasAnnotation)
+                    annotateAvoidCloseNeighbor (other, minSeparationDistance);
+                return (-offset).perpendicularComponent (Access::forward (self));
             }
         }
     }
@@ -762,13 +1366,32 @@ inBoidNeighborhood (const AbstractVehicle& otherVehicle,
                     const float maxDistance,
                     const float cosMaxAngle)
 {
-    if (&otherVehicle == this)
+    return inBoidNeighborhood<AbstractVehicle> (*this, otherVehicle,
+                                                minDistance,
+                                                maxDistance,
+                                                cosMaxAngle);
+}
+
+
+template<class Super>
+template<class Vehicle>
+bool
+OpenSteer::SteerLibraryMixin<Super>::
+inBoidNeighborhood (const Vehicle& self,
+                    const Vehicle& otherVehicle,
+                    const float minDistance,
+                    const float maxDistance,
+                    const float cosMaxAngle)
+{
+    typedef StaticVehicleAccess<Vehicle> Access;
+
+    if (&otherVehicle == &self)
     {
         return false;
     }
     else
     {
-        const Vec3 offset = otherVehicle.position() - position();
+        const Vec3 offset = Access::position (otherVehicle) - Access::position (self);
         const float distanceSquared = offset.lengthSquared ();
 
         // definitely in neighborhood if inside minDistance sphere
@@ -786,8 +1409,12 @@ inBoidNeighborhood (const AbstractVehicle& otherVehicle,
             else
             {
                 // otherwise, test angular offset from forward axis
+                if (approximateMathIsOn ())
+                    return cosineExceeds (Access::forward (self).dot (offset),
+                                          distanceSquared,
+                                          cosMaxAngle);
                 const Vec3 unitOffset = offset / sqrt (distanceSquared);
-                const float forwardness = forward().dot (unitOffset);
+                const float forwardness = Access::forward (self).dot (unitOffset);
                 return forwardness > cosMaxAngle;
             }
         }
@@ -806,20 +1433,38 @@ steerForSeparation (const float maxDistance,
                     const float cosMaxAngle,
                     const AVGroup& flock)
 {
+    return steerForSeparation<AbstractVehicle> (maxDistance, cosMaxAngle, flock);
+}
+
+
+template<class Super>
+template<class Vehicle, class Element>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerForSeparation (const float maxDistance,
+                    const float cosMaxAngle,
+                    const std::vector<Element*>& flock)
+{
+    typedef StaticVehicleAccess<Vehicle> Access;
+    const Vehicle& self = asVehicle<Vehicle> ();
+    const float minDistance = Access::radius (self) * 3;
+
     // steering accumulator and count of neighbors, both initially zero
     Vec3 steering;
     int neighbors = 0;
 
     // for each of the other vehicles...
-    AVIterator flockEndIter = flock.end();
-    for (AVIterator otherVehicle = flock.begin(); otherVehicle != flockEndIter; ++otherVehicle )
+    typedef typename std::vector<Element*>::const_iterator iterator;
+    iterator flockEndIter = flock.end();
+    for (iterator i = flock.begin(); i != flockEndIter; ++i)
     {
-        if (inBoidNeighborhood (**otherVehicle, radius()*3, maxDistance, cosMaxAngle))
+        const Vehicle& other = static_cast<const Vehicle&> (**i);
+        if (inBoidNeighborhood (self, other, minDistance, maxDistance, cosMaxAngle))
         {
             // add in steering contribution
             // (opposite of the offset direction, divided once by distance
             // to normalize, divided another time to get 1/d falloff)
-            const Vec3 offset = (**otherVehicle).position() - position();
+            const Vec3 offset = Access::position (other) - Access::position (self);
             const float distanceSquared = offset.dot(offset);
             steering += (offset / -distanceSquared);
 
@@ -855,17 +1500,35 @@ steerForAlignment (const float maxDistance,
                    const float cosMaxAngle,
                    const AVGroup& flock)
 {
+    return steerForAlignment<AbstractVehicle> (maxDistance, cosMaxAngle, flock);
+}
+
+
+template<class Super>
+template<class Vehicle, class Element>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerForAlignment (const float maxDistance,
+                   const float cosMaxAngle,
+                   const std::vector<Element*>& flock)
+{
+    typedef StaticVehicleAccess<Vehicle> Access;
+    const Vehicle& self = asVehicle<Vehicle> ();
+    const float minDistance = Access::radius (self) * 3;
+
     // steering accumulator and count of neighbors, both initially zero
     Vec3 steering;
     int neighbors = 0;
 
     // for each of the other vehicles...
-    for (AVIterator otherVehicle = flock.begin(); otherVehicle != flock.end(); otherVehicle++)
+    typedef typename std::vector<Element*>::const_iterator iterator;
+    for (iterator i = flock.begin(); i != flock.end(); i++)
     {
-        if (inBoidNeighborhood (**otherVehicle, radius()*3, maxDistance, cosMaxAngle))
+        const Vehicle& other = static_cast<const Vehicle&> (**i);
+        if (inBoidNeighborhood (self, other, minDistance, maxDistance, cosMaxAngle))
         {
             // accumulate sum of neighbor's heading
-            steering += (**otherVehicle).forward();
+            steering += Access::forward (other);
 
             // count neighbors
             neighbors++;
@@ -874,7 +1537,7 @@ steerForAlignment (const float maxDistance,
 
     // divide by neighbors, subtract off current heading to get error-
     // correcting direction, then normalize to pure direction
-    if (neighbors > 0) steering = ((steering / (float)neighbors) - forward()).normalize();
+    if (neighbors > 0) steering = ((steering / (float)neighbors) - Access::forward (self)).normalize();
 
     return steering;
 }
@@ -892,17 +1555,35 @@ steerForCohesion (const float maxDistance,
                   const float cosMaxAngle,
                   const AVGroup& flock)
 {
+    return steerForCohesion<AbstractVehicle> (maxDistance, cosMaxAngle, flock);
+}
+
+
+template<class Super>
+template<class Vehicle, class Element>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerForCohesion (const float maxDistance,
+                  const float cosMaxAngle,
+                  const std::vector<Element*>& flock)
+{
+    typedef StaticVehicleAccess<Vehicle> Access;
+    const Vehicle& self = asVehicle<Vehicle> ();
+    const float minDistance = Access::radius (self) * 3;
+
     // steering accumulator and count of neighbors, both initially zero
     Vec3 steering;
     int neighbors = 0;
 
     // for each of the other vehicles...
-    for (AVIterator otherVehicle = flock.begin(); otherVehicle != flock.end(); otherVehicle++)
+    typedef typename std::vector<Element*>::const_iterator iterator;
+    for (iterator i = flock.begin(); i != flock.end(); i++)
     {
-        if (inBoidNeighborhood (**otherVehicle, radius()*3, maxDistance, cosMaxAngle))
+        const Vehicle& other = static_cast<const Vehicle&> (**i);
+        if (inBoidNeighborhood (self, other, minDistance, maxDistance, cosMaxAngle))
         {
             // accumulate sum of neighbor's positions
-            steering += (**otherVehicle).position();
+            steering += Access::position (other);
 
             // count neighbors
             neighbors++;
@@ -911,8 +1592,305 @@ steerForCohesion (const float maxDistance,
 
     // divide by neighbors, subtract off current position to get error-
     // correcting direction, then normalize to pure direction
-    if (neighbors > 0) steering = ((steering / (float)neighbors) - position()).normalize();
+    if (neighbors > 0) steering = ((steering / (float)neighbors) - Access::position (self)).normalize();
+
+    return steering;
+}
+
+
+// ----------------------------------------------------------------------------
+// boid behaviors over proximity query records: the same as the versions
+// above, but each neighbor's offset and distance squared come from the
+// record (cohesion sums offsets rather than positions)
+
+
+template<class Super>
+bool
+OpenSteer::SteerLibraryMixin<Super>::
+inBoidNeighborhood (const AVNeighbor& neighbor,
+                    const float minDistance,
+                    const float maxDistance,
+                    const float cosMaxAngle)
+{
+    return inBoidNeighborhood (neighbor, this, forward (),
+                               minDistance, maxDistance, cosMaxAngle);
+}
+
+
+template<class Super>
+bool
+OpenSteer::SteerLibraryMixin<Super>::
+inBoidNeighborhood (const AVNeighbor& neighbor,
+                    const AbstractVehicle* self,
+                    const Vec3& selfForward,
+                    const float minDistance,
+                    const float maxDistance,
+                    const float cosMaxAngle)
+{
+    if (neighbor.object == self) return false;
+
+    const float distanceSquared = neighbor.distanceSquared;
+
+    // definitely in neighborhood if inside minDistance sphere
+    if (distanceSquared < (minDistance * minDistance)) return true;
+
+    // definitely not in neighborhood if outside maxDistance sphere
+    if (distanceSquared > (maxDistance * maxDistance)) return false;
+
+    // otherwise, test angular offset from forward axis
+    if (approximateMathIsOn ())
+        return cosineExceeds (selfForward.dot (neighbor.offset),
+                              distanceSquared,
+                              cosMaxAngle);
+    const Vec3 unitOffset = neighbor.offset / sqrt (distanceSquared);
+    const float forwardness = selfForward.dot (unitOffset);
+    return forwardness > cosMaxAngle;
+}
+
+
+template<class Super>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerForSeparation (const float maxDistance,
+                    const float cosMaxAngle,
+                    const AVNeighborGroup& flock)
+{
+    return steerForSeparation<AbstractVehicle> (maxDistance, cosMaxAngle, flock);
+}
+
+
+template<class Super>
+template<class Vehicle>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerForSeparation (const float maxDistance,
+                    const float cosMaxAngle,
+                    const AVNeighborGroup& flock)
+{
+    typedef StaticVehicleAccess<Vehicle> Access;
+    const Vehicle& self = asVehicle<Vehicle> ();
+    const Vec3 selfForward = Access::forward (self);
+    const float minDistance = Access::radius (self) * 3;
+
+    Vec3 steering;
+    for (AVNeighborIterator i = flock.begin(); i != flock.end(); ++i)
+    {
+        if (inBoidNeighborhood (*i, &self, selfForward,
+                                minDistance, maxDistance, cosMaxAngle))
+        {
+            // opposite of the offset direction, with 1/d falloff
+            steering += (i->offset / -i->distanceSquared);
+        }
+    }
+
+    return steering.normalize();
+}
+
+
+template<class Super>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerForAlignment (const float maxDistance,
+                   const float cosMaxAngle,
+                   const AVNeighborGroup& flock)
+{
+    return steerForAlignment<AbstractVehicle> (maxDistance, cosMaxAngle, flock);
+}
+
+
+template<class Super>
+template<class Vehicle>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerForAlignment (const float maxDistance,
+                   const float cosMaxAngle,
+                   const AVNeighborGroup& flock)
+{
+    typedef StaticVehicleAccess<Vehicle> Access;
+    const Vehicle& self = asVehicle<Vehicle> ();
+    const Vec3 selfForward = Access::forward (self);
+    const float minDistance = Access::radius (self) * 3;
+
+    Vec3 steering;
+    int neighbors = 0;
+    for (AVNeighborIterator i = flock.begin(); i != flock.end(); ++i)
+    {
+        if (inBoidNeighborhood (*i, &self, selfForward,
+                                minDistance, maxDistance, cosMaxAngle))
+        {
+            // accumulate sum of neighbor's heading
+            steering += Access::forward (static_cast<const Vehicle&> (*i->object));
+            neighbors++;
+        }
+    }
+
+    if (neighbors > 0) steering = ((steering / (float)neighbors) - selfForward).normalize();
+
+    return steering;
+}
+
+
+template<class Super>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerForCohesion (const float maxDistance,
+                  const float cosMaxAngle,
+                  const AVNeighborGroup& flock)
+{
+    return steerForCohesion<AbstractVehicle> (maxDistance, cosMaxAngle, flock);
+}
+
+
+template<class Super>
+template<class Vehicle>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerForCohesion (const float maxDistance,
+                  const float cosMaxAngle,
+                  const AVNeighborGroup& flock)
+{
+    typedef StaticVehicleAccess<Vehicle> Access;
+    const Vehicle& self = asVehicle<Vehicle> ();
+    const Vec3 selfForward = Access::forward (self);
+    const float minDistance = Access::radius (self) * 3;
+
+    Vec3 steering;
+    int neighbors = 0;
+    for (AVNeighborIterator i = flock.begin(); i != flock.end(); ++i)
+    {
+        if (inBoidNeighborhood (*i, &self, selfForward,
+                                minDistance, maxDistance, cosMaxAngle))
+        {
+            // accumulate sum of offsets to neighbor's positions
+            steering += i->offset;
+            neighbors++;
+        }
+    }
+
+    // the average offset is the direction to the center of the neighbors
+    if (neighbors > 0) steering = (steering / (float)neighbors).normalize();
+
+    return steering;
+}
+
+
+// ----------------------------------------------------------------------------
+// several boid behaviors in one pass over the neighbor records.  The tests
+// and sums are those of steerForSeparation, steerForAlignment and
+// steerForCohesion above, made in the same order, so the results match.
+
 
+template<class Super>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerForFlocking (const BoidBehavior* behaviors,
+                  const int count,
+                  const AVNeighborGroup& flock)
+{
+    return steerForFlocking<AbstractVehicle> (behaviors, count, flock);
+}
+
+
+template<class Super>
+template<class Vehicle>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerForFlocking (const BoidBehavior* behaviors,
+                  const int count,
+                  const AVNeighborGroup& flock)
+{
+    assert (count <= maxBoidBehaviors);
+
+    typedef StaticVehicleAccess<Vehicle> Access;
+    const Vehicle& self = asVehicle<Vehicle> ();
+    const Vec3 selfForward = Access::forward (self);
+    const float minDistance = Access::radius (self) * 3;
+    const float minDistanceSquared = minDistance * minDistance;
+    const bool approximate = approximateMathIsOn ();
+
+    float maxDistanceSquared [maxBoidBehaviors];
+    Vec3 sums [maxBoidBehaviors];
+    int neighbors [maxBoidBehaviors];
+    for (int b = 0; b < count; b++)
+    {
+        maxDistanceSquared[b] = behaviors[b].maxDistance * behaviors[b].maxDistance;
+        neighbors[b] = 0;
+    }
+
+    for (AVNeighborIterator i = flock.begin(); i != flock.end(); ++i)
+    {
+        if (i->object == &self) continue;
+        const float distanceSquared = i->distanceSquared;
+
+        // angular offset from forward axis, when first needed
+        bool forwardnessKnown = false;
+        float forwardness = 0;
+
+        for (int b = 0; b < count; b++)
+        {
+            // as inBoidNeighborhood
+            if (distanceSquared >= minDistanceSquared)
+            {
+                if (distanceSquared > maxDistanceSquared[b]) continue;
+                if (approximate)
+                {
+                    // as inBoidNeighborhood, comparing squares (so here
+                    // forwardness is the unnormalized dot product)
+                    if (! forwardnessKnown)
+                    {
+                        forwardness = selfForward.dot (i->offset);
+                        forwardnessKnown = true;
+                    }
+                    if (! cosineExceeds (forwardness, distanceSquared,
+                                         behaviors[b].cosMaxAngle)) continue;
+                }
+                else
+                {
+                    if (! forwardnessKnown)
+                    {
+                        const Vec3 unitOffset = i->offset / sqrt (distanceSquared);
+                        forwardness = selfForward.dot (unitOffset);
+                        forwardnessKnown = true;
+                    }
+                    if (forwardness <= behaviors[b].cosMaxAngle) continue;
+                }
+            }
+
+            switch (behaviors[b].kind)
+            {
+            case BoidBehavior::separation:
+                sums[b] += (i->offset / -distanceSquared);
+                break;
+            case BoidBehavior::alignment:
+                sums[b] += Access::forward (static_cast<const Vehicle&> (*i->object));
+                neighbors[b]++;
+                break;
+            case BoidBehavior::cohesion:
+                sums[b] += i->offset;
+                neighbors[b]++;
+                break;
+            }
+        }
+    }
+
+    Vec3 steering;
+    for (int b = 0; b < count; b++)
+    {
+        Vec3 s = sums[b];
+        switch (behaviors[b].kind)
+        {
+        case BoidBehavior::separation:
+            s = s.normalize();
+            break;
+        case BoidBehavior::alignment:
+            if (neighbors[b] > 0) s = ((s / (float)neighbors[b]) - selfForward).normalize();
+            break;
+        case BoidBehavior::cohesion:
+            if (neighbors[b] > 0) s = (s / (float)neighbors[b]).normalize();
+            break;
+        }
+        steering += s * behaviors[b].weight;
+    }
     return steering;
 }
 
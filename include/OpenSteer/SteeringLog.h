@@ -0,0 +1,174 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// SteeringLog
+//
+// Records the steering force each vehicle applies in each frame, so a run
+// can be played back later by integrating those forces alone: no neighbor
+// queries, no steering behaviors, no PlugIn update.  That replays a long
+// run at the speed of applySteeringForce, e.g. to look at a late stretch
+// of it again while debugging.
+//
+// SteeringRecorder writes a log file: a header, then one chunk per frame
+// and, every so many frames, a keyframe chunk.  A frame chunk holds, for
+// each vehicle of the group, whether applySteeringForce was called during
+// the frame and, if so, the (raw) force and time step of the last call.
+// These are delta compressed: each float's bits are XORed with those the
+// same vehicle applied the previous time and the result is written as a
+// variable length integer, so forces which change little take a byte or
+// two per component.  A keyframe chunk holds every vehicle's full state
+// (CheckpointVehicle, see SimpleVehicle::saveState), starting with the
+// state the recording began from.
+//
+// SteeringReplayer reads a log back: replayFrame applies one frame's
+// forces to a group of vehicles with SimpleVehicle::applySteeringForce, and
+// restores the keyframes when it gets to them.  Replays are exact for
+// vehicles only moved by applySteeringForce (and deterministic builds of
+// it).  Changes PlugIns make to vehicles besides that (wrap around,
+// braking, respawning) are only caught up with at the next keyframe, as
+// is anything other than the vehicles' state: replaying moves the
+// vehicles but not their proximity tokens, path cursors or trails.
+//
+// The group replayed into must have the vehicle count recorded, and the
+// recording only covers vehicles derived from SimpleVehicle.
+//
+// See OpenSteerDemo::setSteeringRecorder and setSteeringReplayer, and
+// OpenSteerHeadless --record and --replay.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_STEERINGLOG_H
+#define OPENSTEER_STEERINGLOG_H
+
+
+#include <cstddef>
+#include <fstream>
+#include <vector>
+#include "OpenSteer/AbstractVehicle.h"
+#include "OpenSteer/Checkpoint.h"
+
+
+namespace OpenSteer {
+
+
+    class SteeringRecorder
+    {
+    public:
+
+        static const uint32_t version = 1;
+
+        SteeringRecorder (void);
+
+        // Start a log file, with a keyframe of the vehicles' current state,
+        // then one every keyframeInterval frames.  Returns false if the
+        // file cannot be written.
+        bool open (const char* fileName,
+                   const AVGroup& vehicles,
+                   const size_t keyframeInterval = 600);
+        void close (void);
+        bool isOpen (void) const {return file.is_open ();}
+
+        // Record the forces applied during the frame which just ended.  A
+        // group of a different size starts with a keyframe.  Returns false
+        // if writing fails.
+        bool recordFrame (const AVGroup& vehicles, const float currentTime);
+
+        // frames recorded so far
+        size_t frameCount (void) const {return frames;}
+
+    private:
+
+        bool writeKeyframe (const AVGroup& vehicles, const float currentTime);
+
+        std::ofstream file;
+        size_t keyframeInterval;
+        size_t frames;
+
+        // float bits each vehicle applied last, 4 per vehicle (force,
+        // time step), and the chunk being encoded
+        std::vector<uint32_t> previous;
+        std::vector<unsigned char> chunk;
+        std::vector<CheckpointVehicle> states;
+
+        // not copyable
+        SteeringRecorder (const SteeringRecorder&);
+        SteeringRecorder& operator= (const SteeringRecorder&);
+    };
+
+
+    // ------------------------------------------------------------------------
+
+
+    class SteeringReplayer
+    {
+    public:
+
+        SteeringReplayer (void);
+
+        // open a log file, returns false unless it is one of this version
+        bool open (const char* fileName);
+        void close (void);
+        bool isOpen (void) const {return file.is_open ();}
+
+        // Replay the next frame into a group: restore a keyframe if one
+        // comes first, then apply the frame's forces.  Returns false (and
+        // leaves the group unchanged) at the end of the log, or if the log
+        // is malformed or recorded a different number of vehicles.
+        bool replayFrame (const AVGroup& vehicles);
+
+        // true once the whole log has been replayed
+        bool atEnd (void);
+
+        // simulation time of the frame replayed last, and frames so far
+        float currentTime (void) const {return time;}
+        size_t frameCount (void) const {return frames;}
+
+    private:
+
+        std::ifstream file;
+        float time;
+        size_t frames;
+
+        std::vector<uint32_t> previous;
+        std::vector<unsigned char> chunk;
+        std::vector<CheckpointVehicle> states;
+
+        // not copyable
+        SteeringReplayer (const SteeringReplayer&);
+        SteeringReplayer& operator= (const SteeringReplayer&);
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_STEERINGLOG_H
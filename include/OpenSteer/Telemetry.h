@@ -0,0 +1,191 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Telemetry
+//
+// A frame by frame stream of every vehicle's position, velocity and
+// heading through POSIX shared memory, for visualizers and analysis tools
+// running as processes of their own.  The simulation writes each frame
+// straight into the shared ring and never waits for, or even knows about,
+// its readers; a reader too slow to keep up misses frames rather than
+// holding the simulation back.
+//
+// The shared memory object holds a TelemetryHeader followed by slotCount
+// slots, each a TelemetrySlot followed by room for capacity
+// TelemetryRecords.  Frame n (counting from 1) goes into slot n % slotCount.
+// A slot's sequence number is odd while the frame is written into it and
+// 2n once frame n is complete, and the header's latestFrame is n from then
+// on.  A reader copies a slot and checks the sequence number is unchanged
+// afterwards (a seqlock); see TelemetryReader.
+//
+// The layout is native (byte order, float format, 64 bit atomics), for
+// readers on the same machine.  Each TelemetryWriter owns its shared
+// memory object and unlinks it when destroyed.  Not available on Windows,
+// where open fails.
+//
+// See OpenSteerDemo::setTelemetryWriter and OpenSteerHeadless --telemetry.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_TELEMETRY_H
+#define OPENSTEER_TELEMETRY_H
+
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "OpenSteer/AbstractVehicle.h"
+#include "OpenSteer/Vec3.h"
+
+
+namespace OpenSteer {
+
+
+    // ------------------------------------------------------------------------
+    // the shared memory layout
+
+
+    struct TelemetryHeader
+    {
+        char magic[8];          // "OSTEERTM"
+        uint32_t version;
+        uint32_t slotCount;
+        uint32_t capacity;      // records per slot
+        uint32_t recordSize;    // sizeof (TelemetryRecord)
+        uint64_t slotSize;      // bytes from one slot to the next
+        std::atomic<uint64_t> latestFrame; // 0 before the first frame
+        char padding[24];
+    };
+
+
+    struct TelemetrySlot
+    {
+        std::atomic<uint64_t> sequence;
+        uint32_t vehicleCount;
+        float currentTime;
+    };
+
+
+    struct TelemetryRecord
+    {
+        PlainVec3 position;
+        PlainVec3 velocity;
+        PlainVec3 forward;
+    };
+
+
+    // ------------------------------------------------------------------------
+    // the simulation side: creates the shared memory object and publishes
+    // frames into it
+
+
+    class TelemetryWriter
+    {
+    public:
+
+        static const uint32_t version = 1;
+
+        TelemetryWriter (void);
+        ~TelemetryWriter ();
+
+        // Create (or replace) the shared memory object of the given name
+        // with room for "capacity" vehicles in each of "slotCount" slots.
+        // Returns false if that fails.
+        bool open (const char* name,
+                   const size_t capacity,
+                   const size_t slotCount = 4);
+        void close (void);
+        bool isOpen (void) const {return header != 0;}
+
+        // write the state of every vehicle of a group as the next frame
+        // (only the first "capacity" of them if there are more)
+        void publish (const AVGroup& vehicles, const float currentTime);
+
+        // frames published so far
+        uint64_t frameCount (void) const {return frames;}
+
+    private:
+
+        TelemetryHeader* header;
+        size_t mappedSize;
+        std::string name;
+        uint64_t frames;
+
+        // not copyable
+        TelemetryWriter (const TelemetryWriter&);
+        TelemetryWriter& operator= (const TelemetryWriter&);
+    };
+
+
+    // ------------------------------------------------------------------------
+    // the consumer side: maps a stream read-only and copies frames out
+
+
+    class TelemetryReader
+    {
+    public:
+
+        TelemetryReader (void);
+        ~TelemetryReader ();
+
+        // map the named stream, returns false unless it exists and is of
+        // this version and layout
+        bool open (const char* name);
+        void close (void);
+        bool isOpen (void) const {return header != 0;}
+
+        // the newest complete frame, 0 if none has been published yet
+        uint64_t latestFrame (void) const;
+
+        // Copy frame n (and its simulation time) out.  Returns false if it
+        // has not been published yet, has been overwritten by a later one,
+        // or is overwritten during the copy.
+        bool readFrame (const uint64_t frame,
+                        std::vector<TelemetryRecord>& records,
+                        float& currentTime) const;
+
+    private:
+
+        const TelemetryHeader* header;
+        size_t mappedSize;
+
+        // not copyable
+        TelemetryReader (const TelemetryReader&);
+        TelemetryReader& operator= (const TelemetryReader&);
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_TELEMETRY_H
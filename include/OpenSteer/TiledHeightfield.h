@@ -0,0 +1,195 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// TiledHeightfield
+//
+// A regular grid heightfield stored in a binary file of square tiles and
+// memory mapped read-only, so opening even a gigabyte terrain costs a few
+// system calls: a tile's pages are read the first time a query touches the
+// tile.  Each tile carries the max height quadtree of its cells (for the
+// RayTester's hierarchical traversal) and the file starts with a directory
+// of per tile min/max heights, so coarse culling needs no tile data at all.
+//
+// Residency: the field counts the tiles touched since they were last
+// evicted.  evictColdTiles, called between frames, releases the least
+// recently used ones (madvise MADV_DONTNEED) until the touched tiles fit
+// the memory budget, and prefetch asks the system to read ahead the tiles
+// around a point (a vehicle about to drive there).  The touched tiles are
+// charged to MemoryAccount::terrainMemory as one block.  Queries update the use
+// stamps, so a field must not be queried from several threads at once.
+//
+// File layout (native byte order):
+//   header       "OSTH", version, width, height (vertices), tileLog2,
+//                originX, originZ, spacingX, spacingZ, tilesX, tilesZ
+//   directory    min and max height of each tile, row by row
+//   tiles        row by row, each starting on a 4096 byte boundary: the
+//                (2^tileLog2 + 1)^2 vertex heights of the tile (edge
+//                vertices are shared with the neighbor tile, vertices past
+//                the grid repeat the last row or column), then the tile's
+//                max height quadtree from its cells up to a single root
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_TILEDHEIGHTFIELD_H
+#define OPENSTEER_TILEDHEIGHTFIELD_H
+
+
+#include <cstddef>
+#include <vector>
+
+#include "OpenSteer/MemoryAccount.h"
+
+
+namespace OpenSteer {
+
+
+    class TiledHeightfield
+    {
+    public:
+
+        TiledHeightfield ();
+        ~TiledHeightfield ();
+
+        // writes the width x height vertex heights (row by row, x varying
+        // fastest) as a tiled file with tiles of 2^tileLog2 cells on a side
+        static bool write (const char* path,
+                           const int width, const int height,
+                           const float* heights,
+                           const float originX, const float originZ,
+                           const float spacingX, const float spacingZ,
+                           const int tileLog2 = 6);
+
+        // map a tiled file (closing any previous one), false on failure
+        bool open (const char* path);
+        void close (void);
+        bool isOpen (void) const {return base != NULL;}
+
+        // grid geometry: vertex (i, j) lies at x = originX + i * spacingX,
+        // z = originZ + j * spacingZ
+        int width (void) const {return header.width;}
+        int height (void) const {return header.height;}
+        float originX (void) const {return header.originX;}
+        float originZ (void) const {return header.originZ;}
+        float spacingX (void) const {return header.spacingX;}
+        float spacingZ (void) const {return header.spacingZ;}
+
+        // tiles are 2^tileLog2 cells on a side
+        int tileLog2 (void) const {return header.tileLog2;}
+        int tilesX (void) const {return header.tilesX;}
+        int tilesZ (void) const {return header.tilesZ;}
+
+        // height range of the whole field and of one tile (from the
+        // directory, touches no tile)
+        float minHeight (void) const {return fieldMin;}
+        float maxHeight (void) const {return fieldMax;}
+        float tileMinHeight (const int tx, const int tz) const
+            {return directory[2 * (tx + tz * header.tilesX)];}
+        float tileMaxHeight (const int tx, const int tz) const
+            {return directory[2 * (tx + tz * header.tilesX) + 1];}
+
+        // height of vertex (i, j), which must lie on the grid
+        float vertexHeight (const int i, const int j) const;
+
+        // height of the surface at a point of the XZ plane (clamped to the
+        // grid), on the same two triangles per cell the RayTester uses
+        float heightAt (const float x, const float z) const;
+
+        // max height of the cells covered by node (x, z) of the field's
+        // max height quadtree at the given level, for levels up to
+        // tileLog2 (level 0 is a cell, level tileLog2 a whole tile)
+        float nodeMaxHeight (const int level, const int x, const int z) const;
+
+        // ask the system to read ahead the tiles within radius of a point
+        void prefetch (const float x, const float z, const float radius) const;
+
+        // bytes the touched tiles may occupy before evictColdTiles releases
+        // any (default 256 MB)
+        void setMemoryBudget (const size_t bytes) {budget = bytes;}
+        size_t memoryBudget (void) const {return budget;}
+
+        // bytes of the tiles touched since they were last evicted
+        size_t residentBytes (void) const {return residentCount * tileBytes;}
+        int residentTileCount (void) const {return (int) residentCount;}
+
+        // release least recently used tiles until the resident ones fit the
+        // budget, returns the number of tiles released
+        int evictColdTiles (void);
+
+    private:
+
+        struct Header
+        {
+            char magic[4];
+            int version;
+            int width, height;
+            int tileLog2;
+            float originX, originZ;
+            float spacingX, spacingZ;
+            int tilesX, tilesZ;
+            int reserved;
+        };
+
+        // the data of tile (tx, tz), marks it used
+        const float* tile (const int tx, const int tz) const;
+
+        // floats in a tile: vertex heights, then the quadtree levels
+        static size_t tileFloatCount (const int tileLog2);
+        static size_t levelOffset (const int tileLog2, const int level);
+
+        // not copyable
+        TiledHeightfield (const TiledHeightfield&);
+        TiledHeightfield& operator= (const TiledHeightfield&);
+
+        Header header;
+        const char* base;       // the mapped file
+        size_t fileBytes;
+        const float* directory;
+        size_t tilesOffset;
+        size_t tileBytes;
+        float fieldMin, fieldMax;
+        std::vector<size_t> levelOffsets;   // of each quadtree level in a tile
+
+        // residency bookkeeping, updated by the (const) queries
+        // (lastUse 0: not resident)
+        mutable AccountedVector<unsigned long,
+                                MemoryAccount::terrainMemory>::type lastUse;
+        mutable unsigned long useClock;
+        mutable size_t residentCount;
+        mutable MemoryAccount::Charge residentStorage;  // resident tiles
+        size_t budget;
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_TILEDHEIGHTFIELD_H
@@ -0,0 +1,234 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// UpdateScheduler
+//
+// Level of detail update scheduling: decides, frame by frame, which agents
+// of a PlugIn are updated.  Agents are sorted into distance bands around a
+// set of foci (typically the camera and the selected vehicle, plus any the
+// PlugIn chooses); an agent in a band with period p is updated on every
+// p-th frame, with the elapsed time of the skipped frames accumulated and
+// handed to its next update.  Agent i of a band is due when
+// (frame + i) % p == 0, so a band's updates are spread evenly over its
+// p frames and the number of agents updated per frame stays flat.
+//
+// Staleness is bounded two ways: an agent in a band with period p is
+// updated within the next p frames (also right after changing bands), and,
+// when a maximum staleness is set, it is updated as soon as its accumulated
+// time would reach that many seconds, whatever its band.
+//
+// Without any bands every agent is due every frame with the frame's own
+// elapsed time, so a PlugIn can run all its updates through a scheduler
+// and turn level of detail on and off by adding or clearing bands.
+//
+// Sleeping: when it is on, an agent whose speed and steering (as the
+// PlugIn reports them after each of its updates) stay below thresholds for
+// a number of updates falls asleep, and is not due again until it is
+// woken: by the PlugIn, or by an active (not resting) agent coming within
+// the wake radius.  A sleeping agent is at rest, so it accumulates no time.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_UPDATESCHEDULER_H
+#define OPENSTEER_UPDATESCHEDULER_H
+
+
+#include <cstddef>
+#include <vector>
+#include "OpenSteer/Vec3.h"
+#include "OpenSteer/Vec3Batch.h"
+
+
+namespace OpenSteer {
+
+
+    class UpdateScheduler
+    {
+    public:
+
+        UpdateScheduler (void);
+
+        // ------------------------------------------------------ configuration
+
+        // remove all bands: every agent is updated every frame
+        void clearBands (void);
+
+        // agents nearer to the nearest focus than maxDistance (and not in a
+        // nearer band) are updated every period frames.  Agents beyond
+        // every band use the period of the farthest one.
+        void addBand (const float maxDistance, const int period);
+
+        size_t bandCount (void) const {return bands.size();}
+
+        // scale every band's maxDistance (when degrading under load: below
+        // one the near bands shrink and the coarser ones widen)
+        void setBandScale (const float scale) {bandScale = scale;}
+        float getBandScale (void) const {return bandScale;}
+
+        // upper bound (in seconds) on the time between two updates of an
+        // agent, zero for none beyond the band periods
+        void setMaxStaleness (const float seconds) {maxStaleness = seconds;}
+        float getMaxStaleness (void) const {return maxStaleness;}
+
+        // sleep after quietUpdates consecutive updates with speed at most
+        // maxSpeed and steering at most maxSteering, to be woken by active
+        // agents within wakeRadius (zero: only by wake).  quietUpdates
+        // zero (the default) turns sleeping off and wakes every agent.
+        void setSleeping (const float maxSpeed,
+                          const float maxSteering,
+                          const int quietUpdates,
+                          const float wakeRadius);
+        bool sleepingIsOn (void) const {return sleepQuietUpdates > 0;}
+
+        // points of interest, normally reset and set again every frame.
+        // Without any foci every agent is in the nearest band.
+        void clearFoci (void) {foci.clear();}
+        void addFocus (const Vec3& point) {foci.push_back (point);}
+
+        // ---------------------------------------------------------- per frame
+
+        // decide which of the vehicles in group (a container of pointers to
+        // vehicles) are due this frame, elapsedTime after the previous one.
+        // The scheduler keeps per agent state by index, so agents should keep
+        // their index between frames (adding or removing at the end is fine).
+        template <class Group>
+        void schedule (const Group& group, const float elapsedTime)
+        {
+            beginFrame (group.size(), elapsedTime);
+            for (size_t i = 0; i < group.size(); i++)
+                scheduleAgent (i, group[i]->position());
+            endFrame ();
+        }
+
+        // as above, given the agents' positions
+        void schedule (const Vec3* positions, const size_t count,
+                       const float elapsedTime);
+
+        // is agent i due this frame?
+        bool isDue (const size_t i) const {return due[i] != 0;}
+
+        // the time to update due agent i by: the frame's elapsed time plus
+        // that of the frames it skipped since its last update
+        float elapsedTime (const size_t i) const {return elapsed[i];}
+
+        // indices of this frame's due agents, in increasing order
+        const std::vector<size_t>& dueAgents (void) const {return dueList;}
+
+        // frames scheduled so far
+        unsigned long frameCount (void) const {return frame;}
+
+        // band of agent i as of this frame (0 is the nearest)
+        int band (const size_t i) const {return agentBand[i];}
+
+        // report the speed and the magnitude of the steering force of
+        // agent i after its update, for sleeping
+        void noteActivity (const size_t i, const float speed,
+                           const float steering);
+
+        // wake agent i (due from the next frame on), and whether it sleeps
+        void wake (const size_t i);
+        bool isAsleep (const size_t i) const
+            {return (i < asleep.size()) && asleep[i];}
+
+        // number of sleeping agents
+        size_t sleepingCount (void) const;
+
+        // ---------------------------------------------------- reordering
+
+        // for PlugIns which reorder their agents between frames: agents i
+        // and j trade indices, or agent order[i] becomes agent i, taking
+        // their per agent state along (dueAgents is not remapped, it is
+        // that of the frame already scheduled)
+        void swapAgents (const size_t i, const size_t j);
+        void reorderAgents (const std::vector<size_t>& order);
+
+    private:
+
+        void beginFrame (const size_t count, const float elapsedTime);
+        void scheduleAgent (const size_t i, const Vec3& position);
+        void endFrame (void);
+
+        // sleeping agent i woken this frame, so due now
+        void wakeNow (const size_t i);
+        class WakeSink;
+
+        // squared distance from a position to the nearest focus
+        float distanceSquaredToFoci (const Vec3& position) const;
+
+        class Band
+        {
+        public:
+            Band (const float d, const int p)
+                : maxDistanceSquared (d * d), period (p) {}
+            float maxDistanceSquared;
+            int period;
+        };
+
+        // bands sorted by distance
+        std::vector<Band> bands;
+        std::vector<Vec3> foci;
+        float bandScale;
+        float maxStaleness;
+
+        // per agent state: time accumulated since the last update, and
+        // the outcome of this frame
+        std::vector<float> accumulated;
+        std::vector<float> elapsed;
+        std::vector<char> due;
+        std::vector<int> agentBand;
+        std::vector<size_t> dueList;
+
+        // sleeping: thresholds, and per agent the consecutive quiet
+        // updates, whether it sleeps and whether its latest reported
+        // update was active (above a threshold)
+        float sleepMaxSpeed;
+        float sleepMaxSteering;
+        int sleepQuietUpdates;
+        float sleepWakeRadius;
+        std::vector<int> quietUpdates;
+        std::vector<char> asleep;
+        std::vector<char> active;
+
+        // this frame's sleeping agents and active agents' positions
+        std::vector<size_t> sleepers;
+        Vec3Batch sleeperPositions;
+        std::vector<Vec3> wakers;
+
+        unsigned long frame;
+        float frameElapsedTime;
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_UPDATESCHEDULER_H
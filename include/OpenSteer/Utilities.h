@@ -50,6 +50,10 @@
 #include <vector>    // for std::vector
 #include <cassert>   // for assert
 #include <limits>    // for numeric_limits
+#include <cstring>   // for memcpy
+#include <stdint.h>  // for int32_t
+
+#include "OpenSteer/Random.h"
 
 // ----------------------------------------------------------------------------
 // For the sake of Windows, apparently this is a "Linux/Unix thing"
@@ -81,11 +85,12 @@ namespace OpenSteer {
     // Random number utilities
 
 
-    // Returns a float randomly distributed between 0 and 1
+    // Returns a float randomly distributed between 0 and 1, drawn from the
+    // calling thread's default stream (see Random.h)
 
     inline float frandom01 (void)
     {
-        return (((float) rand ()) / ((float) RAND_MAX));
+        return defaultRandomStream().frandom01 ();
     }
 
 
@@ -164,17 +169,27 @@ namespace OpenSteer {
     // ----------------------------------------------------------------------------
 
 
-    inline float scalarRandomWalk (const float initial, 
+    inline float scalarRandomWalk (RandomStream& random,
+                                   const float initial, 
                                    const float walkspeed,
                                    const float min,
                                    const float max)
     {
-        const float next = initial + (((frandom01() * 2) - 1) * walkspeed);
+        const float next = initial + (((random.frandom01() * 2) - 1) * walkspeed);
         if (next < min) return min;
         if (next > max) return max;
         return next;
     }
 
+    inline float scalarRandomWalk (const float initial, 
+                                   const float walkspeed,
+                                   const float min,
+                                   const float max)
+    {
+        return scalarRandomWalk (defaultRandomStream(),
+                                 initial, walkspeed, min, max);
+    }
+
 
     // ----------------------------------------------------------------------------
 
@@ -290,6 +305,86 @@ namespace OpenSteer {
     #endif
 
 
+    // ----------------------------------------------------------------------------
+    // Approximate math: cheaper replacements for the square roots, sines and
+    // cosines in Vec3's length, normalize, truncateLength and
+    // rotateAboutGlobalY, in vecLimitDeviationAngleUtility, and for the
+    // angle tests (SteerLibrary's isAhead, isAside, isBehind and
+    // inBoidNeighborhood), which then compare squares instead of taking a
+    // square root.  The inverse square root is the bit level estimate
+    // refined by one Newton-Raphson step (relative error under 0.2%), the
+    // sine and cosine odd polynomials after range reduction (absolute error
+    // under 4e-6).
+    //
+    // Whether they are used is chosen when building: approximate when
+    // OPENSTEER_APPROXIMATE_MATH is defined, otherwise exact, in which case
+    // results are those of the exact functions.  approximateMathIsOn is a
+    // constant, so the test at each call site costs nothing.
+
+
+    #ifdef OPENSTEER_APPROXIMATE_MATH
+    inline bool approximateMathIsOn (void) {return true;}
+    #else
+    inline bool approximateMathIsOn (void) {return false;}
+    #endif
+
+
+    // for x > 0
+    inline float approximateInverseSqrt (const float x)
+    {
+        int32_t i;
+        memcpy (&i, &x, sizeof (i));
+        i = 0x5f3759df - (i >> 1);
+        float y;
+        memcpy (&y, &i, sizeof (y));
+        return y * (1.5f - (0.5f * x * y * y));
+    }
+
+    inline float approximateSqrt (const float x)
+    {
+        return (x > 0) ? x * approximateInverseSqrt (x) : 0;
+    }
+
+    // reduced to [-pi, pi] (rounding by conversion to int, for arguments
+    // of less than millions of turns), folded into [-pi/2, pi/2], then
+    // the Taylor polynomial to x^9
+    inline float approximateSin (float x)
+    {
+        const float pi = OPENSTEER_M_PI;
+        const float twoPi = 2 * OPENSTEER_M_PI;
+        const float halfPi = 0.5f * OPENSTEER_M_PI;
+        const float turns = x * (1 / twoPi);
+        x -= twoPi * (float) (int) (turns + ((turns < 0) ? -0.5f : 0.5f));
+        if (x > halfPi) x = pi - x;
+        else if (x < -halfPi) x = -pi - x;
+        const float x2 = x * x;
+        return x * (1 + x2 * (-1.0f / 6 +
+                              x2 * (1.0f / 120 +
+                                    x2 * (-1.0f / 5040 +
+                                          x2 * (1.0f / 362880)))));
+    }
+
+    inline float approximateCos (const float x)
+    {
+        return approximateSin (x + (0.5f * OPENSTEER_M_PI));
+    }
+
+    inline float mathSqrt (const float x)
+    {
+        return approximateMathIsOn () ? approximateSqrt (x) : sqrtXXX (x);
+    }
+
+    inline float mathSin (const float x)
+    {
+        return approximateMathIsOn () ? approximateSin (x) : sinXXX (x);
+    }
+
+    inline float mathCos (const float x)
+    {
+        return approximateMathIsOn () ? approximateCos (x) : cosXXX (x);
+    }
+
+
     // ----------------------------------------------------------------------------
     // round (x)  "round off" x to the nearest integer (as a float value)
     //
@@ -500,9 +595,9 @@ namespace OpenSteer {
      *
      * See Scott Meyer, Effective STL, Addison-Wesley, 2001, pp. 77--79.
      */
-    template< typename T >
-    void shrinkToFit( std::vector< T >& v ) {
-        std::vector< T >( v ).swap( v );
+    template< typename T, typename Allocator >
+    void shrinkToFit( std::vector< T, Allocator >& v ) {
+        std::vector< T, Allocator >( v ).swap( v );
     }
     
 
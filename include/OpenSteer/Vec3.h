@@ -91,7 +91,7 @@ namespace OpenSteer {
         float dot (const Vec3& v) const {return (x * v.x) + (y * v.y) + (z * v.z);}
 
         // length
-        float length (void) const {return sqrtXXX (lengthSquared ());}
+        float length (void) const {return mathSqrt (lengthSquared ());}
 
         // length squared
         float lengthSquared (void) const {return this->dot (*this);}
@@ -99,6 +99,15 @@ namespace OpenSteer {
         // normalize: returns normalized version (parallel to this, length = 1)
         Vec3 normalize (void) const
         {
+            // approximate: multiply by the inverse length instead
+            if (approximateMathIsOn ())
+            {
+                const float lenSquared = lengthSquared ();
+                return ((lenSquared>0) ?
+                        (*this) * approximateInverseSqrt (lenSquared) :
+                        (*this));
+            }
+
             // skip divide if length is zero
             const float len = length ();
             return (len>0) ? (*this)/len : (*this);
@@ -171,6 +180,9 @@ namespace OpenSteer {
             const float vecLengthSquared = this->lengthSquared ();
             if (vecLengthSquared <= maxLengthSquared)
                 return *this;
+            else if (approximateMathIsOn ())
+                return (*this) * (maxLength *
+                                  approximateInverseSqrt (vecLengthSquared));
             else
                 return (*this) * (maxLength / sqrtXXX (vecLengthSquared));
         }
@@ -183,8 +195,8 @@ namespace OpenSteer {
 
         Vec3 rotateAboutGlobalY (float angle) const 
         {
-            const float s = sinXXX (angle);
-            const float c = cosXXX (angle);
+            const float s = mathSin (angle);
+            const float c = mathCos (angle);
             return Vec3 ((this->x * c) + (this->z * s),
                          (this->y),
                          (this->z * c) - (this->x * s));
@@ -196,8 +208,8 @@ namespace OpenSteer {
             // is both are zero, they have not be initialized yet
             if (sin==0 && cos==0)
             {
-                sin = sinXXX (angle);
-                cos = cosXXX (angle);
+                sin = mathSin (angle);
+                cos = mathCos (angle);
             }
             return Vec3 ((this->x * cos) + (this->z * sin),
                          (this->y),
@@ -224,6 +236,29 @@ namespace OpenSteer {
     };
 
 
+    // ----------------------------------------------------------------------------
+    // a Vec3 as plain data, for records copied as raw bytes (to files,
+    // messages and shared memory): Vec3's own assignment operator keeps it
+    // from being trivially copyable, this is.  It is assigned from a Vec3
+    // and converts back to one.
+
+
+    struct PlainVec3
+    {
+        float x, y, z;
+
+        PlainVec3& operator= (const Vec3& v)
+        {
+            x = v.x;
+            y = v.y;
+            z = v.z;
+            return *this;
+        }
+
+        operator Vec3 (void) const {return Vec3 (x, y, z);}
+    };
+
+
     // ----------------------------------------------------------------------------
     // scalar times vector product ("float * Vec3")
 
@@ -259,7 +294,11 @@ namespace OpenSteer {
     // between 0 and 1
 
 
-    Vec3 RandomVectorInUnitRadiusSphere (void);
+    Vec3 RandomVectorInUnitRadiusSphere (RandomStream& random);
+    inline Vec3 RandomVectorInUnitRadiusSphere (void)
+    {
+        return RandomVectorInUnitRadiusSphere (defaultRandomStream ());
+    }
 
 
     // ----------------------------------------------------------------------------
@@ -268,7 +307,11 @@ namespace OpenSteer {
     // random and length will range between 0 and 1
 
 
-    Vec3 randomVectorOnUnitRadiusXZDisk (void);
+    Vec3 randomVectorOnUnitRadiusXZDisk (RandomStream& random);
+    inline Vec3 randomVectorOnUnitRadiusXZDisk (void)
+    {
+        return randomVectorOnUnitRadiusXZDisk (defaultRandomStream ());
+    }
 
 
     // ----------------------------------------------------------------------------
@@ -281,6 +324,10 @@ namespace OpenSteer {
     {
         return RandomVectorInUnitRadiusSphere().normalize();
     }
+    inline Vec3 RandomUnitVector (RandomStream& random)
+    {
+        return RandomVectorInUnitRadiusSphere(random).normalize();
+    }
 
 
     // ----------------------------------------------------------------------------
@@ -293,6 +340,10 @@ namespace OpenSteer {
     {
         return RandomVectorInUnitRadiusSphere().setYtoZero().normalize();
     }
+    inline Vec3 RandomUnitVectorOnXZPlane (RandomStream& random)
+    {
+        return RandomVectorInUnitRadiusSphere(random).setYtoZero().normalize();
+    }
 
 
     // ----------------------------------------------------------------------------
@@ -341,6 +392,26 @@ namespace OpenSteer {
     }
 
 
+    // ----------------------------------------------------------------------------
+    // Compares the cosine of the angle between a unit vector and an offset,
+    // given their dot product and the offset's length squared, with a given
+    // cosine: true if dot / sqrt (lengthSquared) > cosine, which it tests
+    // without the square root by comparing squares.  (A zero offset has a
+    // cosine of zero, as it would normalized.)
+
+
+    inline bool cosineExceeds (const float dot,
+                               const float lengthSquared,
+                               const float cosine)
+    {
+        const float c2 = cosine * cosine * lengthSquared;
+        if (cosine >= 0)
+            return (dot > 0) && ((dot * dot) > c2);
+        else
+            return (dot >= 0) || ((dot * dot) < c2);
+    }
+
+
     // ----------------------------------------------------------------------------
     // Returns the distance between a point and a line.  The line is defined in
     // terms of a point on the line ("lineOrigin") and a UNIT vector parallel to
@@ -0,0 +1,160 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Vec3Batch
+//
+// Operations on many 3d vectors at once, for inner loops which would
+// otherwise handle one Vec3 per iteration.  The vectors are stored as
+// structure-of-arrays (separate x, y and z float arrays) so each operation
+// processes 4 (SSE2, NEON) or 8 (AVX2) vectors per instruction.  The
+// instruction set is chosen at compile time from the target the library is
+// built for (see WITH_NATIVE_ARCH in CMakeLists.txt), with a scalar version
+// for other targets and for the tail of each array.  Per-vector results
+// equal those of the corresponding scalar Vec3 expressions; sums may differ
+// from a sequential scalar sum in rounding only.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_VEC3BATCH_H
+#define OPENSTEER_VEC3BATCH_H
+
+
+#include <cstddef>
+#include <vector>
+#include "OpenSteer/Vec3.h"
+
+
+namespace OpenSteer {
+
+
+    // ----------------------------------------------------------------------------
+    // name of the instruction set the batch operations were compiled for:
+    // "AVX2", "SSE2", "NEON" or "scalar"
+
+
+    const char* vec3BatchInstructionSet (void);
+
+
+    // ----------------------------------------------------------------------------
+    // batch operations over count vectors given as component arrays
+
+
+    // result[i] = (p[i] - point).lengthSquared ()
+    void distanceSquaredMany (const Vec3& point,
+                              const float* x, const float* y, const float* z,
+                              size_t count,
+                              float* result);
+
+    // result[i] = v.dot (p[i])
+    void dotMany (const Vec3& v,
+                  const float* x, const float* y, const float* z,
+                  size_t count,
+                  float* result);
+
+    // p[i] = p[i].normalize ()  (zero length vectors are left unchanged)
+    void normalizeMany (float* x, float* y, float* z, size_t count);
+
+    // sum of (p[i] - point) over all i
+    Vec3 sumOfOffsets (const Vec3& point,
+                       const float* x, const float* y, const float* z,
+                       size_t count);
+
+    // nearest approach of a vehicle at "position" moving with "velocity" to
+    // others at p[i] moving with v[i], each keeping its velocity: time[i]
+    // is when they are nearest (0 if their relative velocity is zero, less
+    // than 0 if that was in the past) and distance[i] how far apart they
+    // are then, as SteerLibraryMixin's predictNearestApproachTime and
+    // computeNearestApproachPositions compute them one at a time
+    void nearestApproachMany (const Vec3& position, const Vec3& velocity,
+                              const float* px, const float* py, const float* pz,
+                              const float* vx, const float* vy, const float* vz,
+                              size_t count,
+                              float* time, float* distance);
+
+
+    // ----------------------------------------------------------------------------
+    // a growable array of Vec3 stored as separate component arrays, in the
+    // layout the batch operations above expect
+
+
+    class Vec3Batch
+    {
+    public:
+
+        size_t size (void) const {return x.size();}
+        size_t capacity (void) const {return x.capacity();}
+        bool empty (void) const {return x.empty();}
+
+        Vec3 get (size_t i) const {return Vec3 (x[i], y[i], z[i]);}
+        void set (size_t i, const Vec3& v) {x[i] = v.x; y[i] = v.y; z[i] = v.z;}
+
+        void push_back (const Vec3& v)
+            {x.push_back (v.x); y.push_back (v.y); z.push_back (v.z);}
+        void pop_back (void) {x.pop_back (); y.pop_back (); z.pop_back ();}
+        void erase (size_t i)
+        {
+            x.erase (x.begin() + i);
+            y.erase (y.begin() + i);
+            z.erase (z.begin() + i);
+        }
+        void clear (void) {x.clear (); y.clear (); z.clear ();}
+        void reserve (size_t n) {x.reserve (n); y.reserve (n); z.reserve (n);}
+        void resize (size_t n) {x.resize (n); y.resize (n); z.resize (n);}
+
+        // batch operations over the whole array
+        void distanceSquared (const Vec3& point, float* result) const
+        {
+            if (!empty())
+                distanceSquaredMany (point, &x[0], &y[0], &z[0], size(), result);
+        }
+        void dot (const Vec3& v, float* result) const
+        {
+            if (!empty()) dotMany (v, &x[0], &y[0], &z[0], size(), result);
+        }
+        void normalize (void)
+        {
+            if (!empty()) normalizeMany (&x[0], &y[0], &z[0], size());
+        }
+        Vec3 sumOfOffsets (const Vec3& point) const
+        {
+            if (empty()) return Vec3::zero;
+            return OpenSteer::sumOfOffsets (point, &x[0], &y[0], &z[0], size());
+        }
+
+        std::vector<float> x, y, z;
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_VEC3BATCH_H
@@ -0,0 +1,172 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// VehiclePopulation
+//
+// Structure-of-arrays storage for the kinematic state of a population of
+// vehicles: each component of each per-vehicle quantity lives in its own
+// contiguous float array.  applySteeringForces integrates a whole array of
+// steering forces in one pass with the same arithmetic as
+// SimpleVehicle::applySteeringForce (force adjustment at low speed,
+// truncation, mass division, acceleration smoothing, speed clamp and
+// regeneration of a right handed local space) without a virtual call or a
+// pointer chase per vehicle.
+//
+// SimpleVehicle remains the per-object type used by the PlugIns and the
+// steering library.  load and store copy state between a SimpleVehicle and
+// a slot of the population, so an existing vehicle can be viewed as, or
+// refreshed from, its SoA record.  Path curvature bookkeeping, which only
+// feeds annotation and the camera, is not maintained here.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_VEHICLEPOPULATION_H
+#define OPENSTEER_VEHICLEPOPULATION_H
+
+
+#include <cstddef>
+#include <vector>
+#include "OpenSteer/Vec3Batch.h"
+
+
+namespace OpenSteer {
+
+
+    class SimpleVehicle;
+    class WorkerPool;
+
+
+    class VehiclePopulation
+    {
+    public:
+
+        // how applySteeringForces regenerates each vehicle's local space,
+        // matching SimpleVehicle::regenerateLocalSpace,
+        // SimpleVehicle::regenerateLocalSpaceForBanking and PlanarVehicle
+        // (which also projects the forces onto the XZ plane) respectively
+        enum LocalSpaceMode {alignWithVelocity, banking, planar};
+
+        VehiclePopulation (LocalSpaceMode mode = alignWithVelocity);
+
+        // number of vehicles
+        size_t size (void) const {return _speed.size();}
+
+        // remove all vehicles
+        void clear (void);
+
+        // reserve storage for n vehicles
+        void reserve (size_t n);
+
+        // append a vehicle with the (reset) state of a default SimpleVehicle,
+        // returns its index
+        size_t add (void);
+
+        // append a copy of a vehicle's state, returns its index
+        size_t add (const SimpleVehicle& vehicle);
+
+        // remove vehicle i by moving the last vehicle into its slot (so the
+        // index of the last vehicle changes to i)
+        void remove (size_t i);
+
+        // copy a vehicle's state into slot i, or slot i into a vehicle
+        void load (size_t i, const SimpleVehicle& vehicle);
+        void store (size_t i, SimpleVehicle& vehicle) const;
+
+        // get/set the local space regeneration mode
+        LocalSpaceMode localSpaceMode (void) const {return _mode;}
+        void setLocalSpaceMode (LocalSpaceMode mode) {_mode = mode;}
+
+        // per-vehicle accessors
+        Vec3 position (size_t i) const {return _position.get (i);}
+        Vec3 forward (size_t i) const {return _forward.get (i);}
+        Vec3 side (size_t i) const {return _side.get (i);}
+        Vec3 up (size_t i) const {return _up.get (i);}
+        Vec3 velocity (size_t i) const {return forward (i) * _speed[i];}
+        Vec3 smoothedAcceleration (size_t i) const
+            {return _smoothedAcceleration.get (i);}
+        Vec3 smoothedPosition (size_t i) const
+            {return _smoothedPosition.get (i);}
+        float speed (size_t i) const {return _speed[i];}
+        float mass (size_t i) const {return _mass[i];}
+        float maxForce (size_t i) const {return _maxForce[i];}
+        float maxSpeed (size_t i) const {return _maxSpeed[i];}
+        float radius (size_t i) const {return _radius[i];}
+
+        void setPosition (size_t i, const Vec3& p) {_position.set (i, p);}
+        void setSpeed (size_t i, float s) {_speed[i] = s;}
+        void setMass (size_t i, float m) {_mass[i] = m;}
+        void setMaxForce (size_t i, float mf) {_maxForce[i] = mf;}
+        void setMaxSpeed (size_t i, float ms) {_maxSpeed[i] = ms;}
+        void setRadius (size_t i, float r) {_radius[i] = r;}
+
+        // set forward (unit length), keeping up as close to its old value
+        // as possible, like LocalSpaceMixin::regenerateOrthonormalBasisUF
+        void setForward (size_t i, const Vec3& newUnitForward);
+
+        // apply forces[i] to vehicle i for every vehicle in the population
+        // (or in [begin, end)), integrating over elapsedTime
+        void applySteeringForces (const Vec3* forces, const float elapsedTime);
+        void applySteeringForces (const Vec3* forces, const float elapsedTime,
+                                  size_t begin, size_t end);
+
+        // as above, with the population split into ranges run on a pool
+        void applySteeringForces (const Vec3* forces, const float elapsedTime,
+                                  WorkerPool& pool);
+
+    private:
+
+        // applySteeringForces for the planar mode, leaving the Y of
+        // positions and forwards (and the up vectors) alone
+        void applyPlanarSteeringForces (const Vec3* forces,
+                                        const float elapsedTime,
+                                        size_t begin, size_t end);
+
+        Vec3Batch _position;
+        Vec3Batch _forward;
+        Vec3Batch _side;
+        Vec3Batch _up;
+        Vec3Batch _smoothedAcceleration;
+        Vec3Batch _smoothedPosition;
+        std::vector<float> _speed;
+        std::vector<float> _mass;
+        std::vector<float> _maxForce;
+        std::vector<float> _maxSpeed;
+        std::vector<float> _radius;
+
+        LocalSpaceMode _mode;
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_VEHICLEPOPULATION_H
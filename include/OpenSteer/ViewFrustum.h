@@ -0,0 +1,117 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// ViewFrustum
+//
+// The volume a perspective camera sees: a truncated pyramid from the near
+// to the far distance along the line of sight.  For culling it answers
+// whether a sphere may be visible, and bounds the part of the frustum
+// within a box (such as a world's extent) by a sphere, which a proximity
+// database can be queried with: so finding the vehicles which may be
+// visible costs about as much as the visible part of the world holds,
+// rather than as much as the whole population.
+//
+// Tests are conservative: a sphere outside the frustum but near one of its
+// edges may be taken as visible, a visible one is never rejected.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_VIEWFRUSTUM_H
+#define OPENSTEER_VIEWFRUSTUM_H
+
+
+#include "OpenSteer/AbstractVehicle.h"
+#include "OpenSteer/Proximity.h"
+#include "OpenSteer/Vec3.h"
+
+
+namespace OpenSteer {
+
+
+    class ViewFrustum
+    {
+    public:
+
+        // the view from eye towards target with the given up direction
+        // (only its component across the line of sight counts), vertical
+        // field of view in degrees, width / height aspect ratio and
+        // distances of the near and far planes
+        ViewFrustum (const Vec3& eye,
+                     const Vec3& target,
+                     const Vec3& up,
+                     const float fieldOfViewY,
+                     const float aspectRatio,
+                     const float nearDistance,
+                     const float farDistance);
+
+        // whether any part of a sphere may be within the frustum
+        bool intersectsSphere (const Vec3& center, const float radius) const;
+
+        // a sphere containing the part of the frustum within the box from
+        // lo to hi, false if there is no such part
+        bool boundingSphereWithin (const Vec3& lo, const Vec3& hi,
+                                   Vec3& center, float& radius) const;
+
+        // the vehicles (of radius up to maxRadius, centered within the
+        // box from lo to hi) which may be visible, appended to results:
+        // those of token's database within the sphere bounding the
+        // visible part of the box which intersect the frustum
+        void findVisibleVehicles (AbstractTokenForProximityDatabase<AbstractVehicle*>& token,
+                                  const Vec3& lo,
+                                  const Vec3& hi,
+                                  const float maxRadius,
+                                  AVGroup& results) const;
+
+        // corner i: to the right of the line of sight if bit 0 is set,
+        // above it if bit 1 is, on the far plane if bit 2 is
+        const Vec3& corner (const int i) const {return corners[i];}
+
+    private:
+
+        // signed distance of a point from plane i, positive inside
+        float planeDistance (const int i, const Vec3& point) const
+        {
+            return normals[i].dot (point) + offsets[i];
+        }
+
+        bool contains (const Vec3& point, const float tolerance) const;
+
+        Vec3 corners [8];
+
+        // the six bounding planes, normals pointing inside
+        Vec3 normals [6];
+        float offsets [6];
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_VIEWFRUSTUM_H
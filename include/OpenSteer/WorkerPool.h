@@ -0,0 +1,164 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// WorkerPool
+//
+// A reusable pool of worker threads for data parallel loops over vehicles.
+// parallelFor splits an index range into chunks which the workers and the
+// calling thread claim until the range is exhausted, then returns once
+// every chunk is done.  The threads persist between calls, so the per call
+// cost is a wakeup rather than thread creation.
+//
+// Also provides the master switch for the PlugIns' two-phase parallel
+// update mode: when on, PlugIns that support it compute all steering forces
+// in parallel from the vehicle state of the previous frame, then integrate
+// them and update proximity tokens serially.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_WORKERPOOL_H
+#define OPENSTEER_WORKERPOOL_H
+
+
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+
+namespace OpenSteer {
+
+
+    // ------------------------------------------------------------------------
+    // two-phase parallel PlugIn update: master on/off switch (off by default)
+
+
+    extern bool enableParallelUpdate;
+
+    inline bool parallelUpdateIsOn (void) {return enableParallelUpdate;}
+    inline void setParallelUpdateOn (void) {enableParallelUpdate = true;}
+    inline void setParallelUpdateOff (void) {enableParallelUpdate = false;}
+    inline bool toggleParallelUpdateState (void)
+        {return (enableParallelUpdate = !enableParallelUpdate);}
+
+
+    // ------------------------------------------------------------------------
+
+
+    class WorkerPool
+    {
+    public:
+
+        // a pool of threadCount threads in total, counting the thread which
+        // calls parallelFor.  Zero means one per hardware thread.
+        WorkerPool (int threadCount = 0);
+        ~WorkerPool ();
+
+        // number of threads which run loop bodies, including the caller
+        int threadCount (void) const {return (int) workers.size() + 1;}
+
+        // stop the current workers and start threadCount - 1 new ones
+        // (zero means one per hardware thread).  Must not be called from
+        // inside parallelFor.
+        void setThreadCount (int threadCount);
+
+        // call body (begin, end) over consecutive sub-ranges covering
+        // [0, count) exactly once, concurrently, then return.  Ranges hold
+        // at most grainSize indices.  Body must be safe to call from
+        // several threads at once.  A call made while the pool runs another
+        // loop, such as one nested in a loop body, runs serially on the
+        // calling thread.
+        template <class Body>
+        void parallelFor (const size_t count, Body& body,
+                          const size_t grainSize = 0)
+        {
+            run (count, grainSize, callBody<Body>, &body);
+        }
+
+        // shared pool sized to the hardware, created on first use
+        static WorkerPool& shared (void);
+
+        // index of the calling thread within the pool running it: 1 to
+        // threadCount - 1 on the workers, 0 on every other thread (such as
+        // the one which calls parallelFor).  For per thread state indexed
+        // by thread, see SimulationContext.h
+        static int currentThreadIndex (void);
+
+    private:
+
+        typedef void (* rangeCallBackFunction) (void* body,
+                                                size_t begin,
+                                                size_t end);
+
+        template <class Body>
+        static void callBody (void* body, size_t begin, size_t end)
+        {
+            (*(Body*) body) (begin, end);
+        }
+
+        void run (size_t count, size_t grainSize,
+                  rangeCallBackFunction f, void* body);
+        void startWorkers (int threadCount);
+        void stopWorkers (void);
+        void workerLoop (int threadIndex, unsigned long seenGeneration);
+        void claimChunks (void);
+
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable wakeWorkers;
+        std::condition_variable jobDone;
+
+        // current job, protected by mutex except for nextIndex
+        rangeCallBackFunction jobFunction;
+        void* jobBody;
+        size_t jobCount;
+        size_t jobGrainSize;
+        std::atomic<size_t> nextIndex;
+        unsigned long jobGeneration;
+        int busyWorkers;
+        bool stopping;
+
+        // set while a loop is spread over the workers
+        std::atomic<bool> running;
+
+        // not copyable
+        WorkerPool (const WorkerPool&);
+        WorkerPool& operator= (const WorkerPool&);
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_WORKERPOOL_H
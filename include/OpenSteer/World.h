@@ -0,0 +1,163 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// World
+//
+// Independent simulations run side by side in one process.  A World owns
+// its own instance of a PlugIn (made by AbstractPlugIn::newWorldInstance,
+// so with its own vehicles, proximity database and obstacles), its own
+// simulation time and its own random numbers: everything the PlugIn draws
+// from the default random stream, and the seeds of the vehicles it makes,
+// come from the World's seed (see RandomScope in Random.h), so a World
+// repeats itself given the same seed no matter which thread steps it.
+//
+// A WorldScheduler steps many Worlds concurrently on a WorkerPool, each
+// World on one thread at a time, handing them out one by one so Worlds of
+// different cost balance out.  The PlugIns run their serial update inside
+// a World: the parallelism is across Worlds.
+//
+// Annotation is shared by the whole process, so it is turned off while
+// Worlds are stepped concurrently.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_WORLD_H
+#define OPENSTEER_WORLD_H
+
+
+#include <vector>
+
+#include "OpenSteer/PlugIn.h"
+#include "OpenSteer/Random.h"
+
+
+namespace OpenSteer {
+
+
+    class WorkerPool;
+
+
+    class World
+    {
+    public:
+
+        // a World (not yet open) running its own instance of prototype's
+        // PlugIn, drawing its random numbers from seed
+        World (AbstractPlugIn& prototype, const uint64_t seed);
+
+        // closes the World if it is open
+        ~World ();
+
+        // false if prototype's PlugIn cannot run in a World, in which case
+        // nothing else may be called
+        bool isValid (void) const {return instance != NULL;}
+
+        // open the PlugIn at time zero, step it by elapsedTime, close it
+        void open (void);
+        void step (const float elapsedTime);
+        void close (void);
+        bool isOpen (void) const {return opened;}
+
+        // the PlugIn's setPopulation and setParameter, for an open World,
+        // drawing from the World's random numbers (new vehicles do)
+        bool setPopulation (const int count);
+        bool setParameter (const char* name, const float value);
+
+        // simulation time, and steps taken, since the World was opened
+        float currentTime (void) const {return time;}
+        int stepCount (void) const {return steps;}
+
+        uint64_t seed (void) const {return worldSeed;}
+
+        AbstractPlugIn& plugIn (void) {return *instance;}
+        const AVGroup& allVehicles (void) {return instance->allVehicles ();}
+
+    private:
+
+        AbstractPlugIn* const instance;
+        const uint64_t worldSeed;
+
+        // the PlugIn's default stream, and the count of vehicles it has
+        // made, for its RandomScope
+        RandomStream random;
+        uint64_t vehicleCount;
+
+        float time;
+        int steps;
+        bool opened;
+
+        // not copyable
+        World (const World&);
+        World& operator= (const World&);
+    };
+
+
+    // ----------------------------------------------------------------------------
+
+
+    class WorldScheduler
+    {
+    public:
+
+        // Worlds are stepped on pool (its threads, and the caller's)
+        WorldScheduler (WorkerPool& pool);
+
+        // the Worlds stepped together, not owned by the scheduler
+        void add (World& world) {worlds.push_back (&world);}
+        void clear (void) {worlds.clear ();}
+        size_t size (void) const {return worlds.size();}
+        World& operator[] (const size_t i) {return *worlds[i];}
+
+        // open (or close) every World, concurrently
+        void openAll (void);
+        void closeAll (void);
+
+        // take stepCount steps of elapsedTime in every open World.  Each
+        // World takes its steps in one go, on one thread.
+        void step (const float elapsedTime, const int stepCount = 1);
+
+    private:
+
+        // call action on every World, concurrently, with annotation off
+        enum Action {openAction, stepAction, closeAction};
+        class ActionBody;
+        void runAll (const Action action,
+                     const float elapsedTime,
+                     const int stepCount);
+
+        WorkerPool& pool;
+        std::vector<World*> worlds;
+    };
+
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_WORLD_H
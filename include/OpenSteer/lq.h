@@ -74,7 +74,8 @@
     application-supplied call-back function to be applied to all
     client objects in the locality.  See lqCallBackFunction below for
     more detail.  The lqFindNearestNeighborWithinRadius function can
-    be used to find a single nearest neighbor using the database.
+    be used to find a single nearest neighbor using the database, and
+    lqFindKNearestNeighborsWithinRadius the k nearest.
 
     Note that "locality query" is also known as neighborhood query,
     neighborhood search, near neighbor search, and range query.  For
@@ -184,6 +185,43 @@ void lqUpdateForNewLocation (lqDB* lq,
 			     float x, float y, float z);
 
 
+/* ------------------------------------------------------------------ */
+/* Batch form of lqUpdateForNewLocation: call once per frame with the
+   new locations of many client objects (proxies[i] moves to x[i],
+   y[i], z[i]).  Locations are stored, then only the proxies whose bin
+   changed are relinked, in order of destination bin.  binIndices may
+   give each proxy's new bin as computed by lqBinIndexForLocation (for
+   example concurrently, by several threads), or be NULL.  Must not
+   run concurrently with queries or other updates of the database.
+   Returns the number of proxies which changed bins.  */
+
+
+int lqUpdateManyForNewLocations (lqDB* lq,
+				  lqClientProxy** proxies,
+				  const float* x, const float* y, const float* z,
+				  const int* binIndices,
+				  int count);
+
+
+/* ------------------------------------------------------------------ */
+/* The index of the bin containing a given location, or -1 for
+   locations outside the super-brick.  Only reads the database so may
+   be called from several threads at once.  */
+
+
+int lqBinIndexForLocation (lqDB* lq, float x, float y, float z);
+
+
+/* ------------------------------------------------------------------ */
+/* Change the number of sub-brick divisions along each axis, keeping
+   the super-brick and all objects.  Takes time proportional to the
+   number of objects and bins.  Must not run concurrently with queries
+   or updates of the database.  */
+
+
+void lqResizeBins (lqDB* lq, int divx, int divy, int divz);
+
+
 /* ------------------------------------------------------------------ */
 /* Apply an application-specific function to all objects in a certain
    locality.  The locality is specified as a sphere with a given
@@ -217,6 +255,63 @@ void lqMapOverAllObjectsInLocality (lqDB* lq,
 				    void* clientQueryState);
 
 
+/* ------------------------------------------------------------------ */
+/* Like lqMapOverAllObjectsInLocality but the function is also passed
+   the offset (x, y and z components) from the center of the search
+   locality sphere to the object's key-point, as computed for the
+   distance test, so clients need not recompute it. */
+
+
+/* type for a pointer to a function used to map over client objects
+   with their offsets */
+typedef void (* lqOffsetCallBackFunction)  (void* clientObject,
+					    float distanceSquared,
+					    float offsetX,
+					    float offsetY,
+					    float offsetZ,
+					    void* clientQueryState);
+
+
+void lqMapOverAllObjectsInLocalityWithOffsets (lqDB* lq, 
+					       float x, float y, float z,
+					       float radius,
+					       lqOffsetCallBackFunction func,
+					       void* clientQueryState);
+
+
+/* ------------------------------------------------------------------ */
+/* Like the two functions above, and adds the cost of the query to the
+   given counts (when not NULL): the bins whose object lists were
+   traversed, the objects whose distance was tested, those found
+   within the sphere, and how many of the tested objects were in the
+   catch-all bin for objects outside the super-brick.  */
+
+
+typedef struct lqQueryCounts
+{
+    int binsVisited;
+    int candidatesTested;
+    int candidatesAccepted;
+    int outsideCandidates;
+
+} lqQueryCounts;
+
+
+void lqMapOverAllObjectsInLocalityCounted (lqDB* lq, 
+					   float x, float y, float z,
+					   float radius,
+					   lqCallBackFunction func,
+					   void* clientQueryState,
+					   lqQueryCounts* counts);
+
+void lqMapOverAllObjectsInLocalityWithOffsetsCounted (lqDB* lq, 
+						      float x, float y, float z,
+						      float radius,
+						      lqOffsetCallBackFunction func,
+						      void* clientQueryState,
+						      lqQueryCounts* counts);
+
+
 /* ------------------------------------------------------------------ */
 /*                                                                    */
 /*                            Other API                               */
@@ -239,6 +334,37 @@ void* lqFindNearestNeighborWithinRadius (lqDB* lq,
 					 void* ignoreObject);
 
 
+/* ------------------------------------------------------------------ */
+/* Like lqFindNearestNeighborWithinRadius but finds the (at most) k
+   objects nearest to the location within the radius, except
+   ignoreObject.  They are written to the caller's objects array with
+   their squared distances in distancesSquared (both of length k),
+   nearest first, and their number is returned.  Bins are visited in
+   expanding shells around the location's bin, stopping as soon as no
+   unvisited bin can hold a nearer object than the k-th found, so a
+   large radius costs little when neighbors are near.  The Counted
+   form adds the cost of the query to counts as described for
+   lqMapOverAllObjectsInLocalityCounted.  */
+
+
+int lqFindKNearestNeighborsWithinRadius (lqDB* lq, 
+					 float x, float y, float z,
+					 float radius,
+					 void* ignoreObject,
+					 int k,
+					 void** objects,
+					 float* distancesSquared);
+
+int lqFindKNearestNeighborsWithinRadiusCounted (lqDB* lq, 
+						float x, float y, float z,
+						float radius,
+						void* ignoreObject,
+						int k,
+						void** objects,
+						float* distancesSquared,
+						lqQueryCounts* counts);
+
+
 /* ------------------------------------------------------------------ */
 /* Adds a given client object to a given bin, linking it into the bin
    contents list. */
@@ -287,6 +413,20 @@ void lqMapOverAllObjects (lqDB* lq,
 			  void* clientQueryState);
 
 
+/* ------------------------------------------------------------------ */
+/* Apply a user-supplied function to all objects in the database and
+   their locations, regardless of locality */
+
+
+typedef void (* lqLocationCallBackFunction) (void* clientObject,
+                                             float x, float y, float z,
+                                             void* clientQueryState);
+
+void lqMapOverAllObjectsWithLocations (lqDB* lq, 
+				       lqLocationCallBackFunction func,
+				       void* clientQueryState);
+
+
 /* ------------------------------------------------------------------ */
 /* Removes (all proxies for) all objects from all bins */
 
@@ -306,6 +446,19 @@ void lqGetBinPopulationStats (lqDB* lq,
                               float* average);
 #endif /* NO_LQ_BIN_STATS */
 
+
+/* ------------------------------------------------------------------ */
+/* Histogram of bin populations: histogram[n] is set to the number of
+   bins holding n objects, for n from 0 to histogramSize-1, where the
+   last entry also counts all bins holding more.  Returns the
+   population of the catch-all bin for objects outside the
+   super-brick, which is not included in the histogram.  */
+
+
+int lqGetBinPopulationHistogram (lqDB* lq,
+				 int* histogram,
+				 int histogramSize);
+
 /* ------------------------------------------------------------------ */
 
 
@@ -36,10 +36,21 @@
 // ----------------------------------------------------------------------------
 
 
+#include <algorithm>
+#include <cstring>
 #include <sstream>
 #include "OpenSteer/SimpleVehicle.h"
 #include "OpenSteer/OpenSteerDemo.h"
+#include "OpenSteer/Checkpoint.h"
+#include "OpenSteer/FlockEngine.h"
+#include "OpenSteer/PhaseTimer.h"
+#include "OpenSteer/ObjectPool.h"
+#include "OpenSteer/WorkerPool.h"
+#include "OpenSteer/SimulationContext.h"
 #include "OpenSteer/Proximity.h"
+#include "OpenSteer/NeighborList.h"
+#include "OpenSteer/UpdateScheduler.h"
+#include "OpenSteer/SpatialReorder.h"
 #include "OpenSteer/Color.h"
 #include "OpenSteer/UnusedParameter.h"
 
@@ -50,7 +61,6 @@
 #endif
 
 #ifndef NO_LQ_BIN_STATS
-#include <iomanip> // for setprecision
 #include <limits> // for numeric_limits::max()
 #endif // NO_LQ_BIN_STATS
 
@@ -70,25 +80,76 @@ namespace {
 
 
     // ----------------------------------------------------------------------------
+    // state shared by the boids of one flock: their flocking parameters,
+    // the obstacles they avoid (and an index over them), the per thread
+    // contexts they are updated with, and the skin or refresh slices of
+    // their neighbor lists (when they use them)
 
 
-    class Boid : public OpenSteer::SimpleVehicle
+    class BoidsWorld
     {
     public:
+        BoidsWorld (void) : neighborSkin (2), useNeighborLists (false) {}
+        void invalidateNeighborLists (void)
+        {
+            neighborSkin.invalidate ();
+            refreshSlices.invalidate ();
+        }
+        FlockEngine::Parameters flocking;
+        ObstacleGroup obstacles;
+        ObstacleIndex obstacleIndex;
+        SimulationContexts contexts;
+        NeighborListSkin neighborSkin;
+        bool useNeighborLists;
+        NeighborRefreshSlices refreshSlices;
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // checkpoint sections of the flock: the SimpleVehicle state of each
+    // boid, and the flock's proximity database, obstacles and scheduling
+
+
+    const CheckpointTag boidsTag = checkpointTag ("BOID");
+    const CheckpointTag flockSettingsTag = checkpointTag ("FLCK");
+    const CheckpointTag databaseStateTag = checkpointTag ("PDST");
+    const CheckpointTag placementOrderTag = checkpointTag ("PDOR");
+
+    struct FlockSettings
+    {
+        int proximityDatabase;
+        int constraint;
+        int levelOfDetail;
+    };
+
+
+    // ----------------------------------------------------------------------------
+
+
+    class Boid : public OpenSteer::SimpleVehicle, public PooledObject<Boid>
+    {
+    public:
+
+        // boids live in the plugin's pool (which charges its chunks to
+        // vehicle memory), so they take its new and delete
+        using PooledObject<Boid>::operator new;
+        using PooledObject<Boid>::operator delete;
 
         // type for a flock: an STL vector of Boid pointers
         typedef std::vector<Boid*> groupType;
 
 
-        // constructor
-        Boid (ProximityDatabase& pd)
+        // constructor: the new boid's token has no position in the
+        // proximity database until the caller gives it one (so a whole
+        // batch of new boids can be placed at once)
+        Boid (ProximityDatabase& pd, BoidsWorld& w) : world (w)
         {
             // allocate a token for this boid in the proximity database
             proximityToken = NULL;
             newPD (pd);
 
             // reset all boid state
-            reset ();
+            resetState ();
         }
 
 
@@ -102,6 +163,15 @@ namespace {
 
         // reset state
         void reset (void)
+        {
+            resetState ();
+
+            // notify proximity database that our position has changed
+            proximityToken->updateForNewPosition (position());
+        }
+
+        // reset state in place, except for the proximity token
+        void resetState (void)
         {
             // reset the vehicle
             SimpleVehicle::reset ();
@@ -115,14 +185,36 @@ namespace {
             // initial slow speed
             setSpeed (maxSpeed() * 0.3f);
 
+            // no neighbors seen yet
+            neighborCount = 0;
+
             // randomize initial orientation
-            regenerateOrthonormalBasisUF (RandomUnitVector ());
+            regenerateOrthonormalBasisUF (RandomUnitVector (randomStream ()));
 
             // randomize initial position
-            setPosition (RandomVectorInUnitRadiusSphere () * 20);
+            setPosition (RandomVectorInUnitRadiusSphere (randomStream ()) * 20);
+        }
 
-            // notify proximity database that our position has changed
-            proximityToken->updateForNewPosition (position());
+
+        // trade simulation state with another boid of the flock, each
+        // keeping its storage and proximity token (whose positions the
+        // caller updates), for the flock's spatial reorder.  The boid's
+        // identity (serial number, random stream) and its trail go with
+        // the state, so a pointer to either storage now refers to the
+        // other boid: the caller remaps the pointers it knows of, and
+        // neighbor lists (which hold boids by their storage) are
+        // invalidated.
+        void exchangeState (Boid& other)
+        {
+            CheckpointVehicle mine, theirs;
+            saveState (mine);
+            other.saveState (theirs);
+            restoreState (theirs);
+            other.restoreState (mine);
+            exchangeTrail (other);
+            std::swap (serialNumber, other.serialNumber);
+            std::swap (steering, other.steering);
+            std::swap (neighborCount, other.neighborCount);
         }
 
 
@@ -140,75 +232,89 @@ namespace {
             OPENSTEER_UNUSED_PARAMETER(currentTime);
             
             // steer to flock and avoid obstacles if any
-            applySteeringForce (steerToFlock (), elapsedTime);
+            computeSteering (world.contexts.forThisThread ());
+            applySteering (elapsedTime);
+        }
 
-            // wrap around to contrain boid within the spherical boundary
-            sphericalWrapAround ();
+
+        // two-phase update, phase one: determine this frame's steering force
+        // (only reads the other boids, so may run in parallel for all boids)
+        void computeSteering (SimulationContext& context)
+        {
+            steering = steerToFlock (context);
+        }
+
+
+        // two-phase update, phase two: apply the steering force computed by
+        // computeSteering
+        void applySteering (const float elapsedTime)
+        {
+            integrate (elapsedTime);
 
             // notify proximity database that our position has changed
             proximityToken->updateForNewPosition (position());
         }
 
+        // the part of applySteering which only changes this boid (so may
+        // run in parallel for all boids), leaving the proximity token as is
+        void integrate (const float elapsedTime)
+        {
+            applySteeringForce (steering, elapsedTime);
+
+            // wrap around to contrain boid within the spherical boundary
+            sphericalWrapAround ();
+        }
+
 
         // basic flocking
-        Vec3 steerToFlock (void)
+        Vec3 steerToFlock (SimulationContext& context)
         {
+            PhaseTimer::Scope timer (PhaseTimer::steeringPhase);
+
             // avoid obstacles if needed
             // XXX this should probably be moved elsewhere
-            const Vec3 avoidance = steerToAvoidObstacles (1.0f, obstacles);
+            const FlockEngine::Parameters& p = world.flocking;
+            const Vec3 avoidance = steerToAvoidObstacles (p.minTimeToCollision,
+                                                          world.obstacleIndex);
             if (avoidance != Vec3::zero) return avoidance;
 
-            const float separationRadius =  5.0f;
-            const float separationAngle  = -0.707f;
-            const float separationWeight =  12.0f;
-
-            const float alignmentRadius = 7.5f;
-            const float alignmentAngle  = 0.7f;
-            const float alignmentWeight = 8.0f;
-
-            const float cohesionRadius = 9.0f;
-            const float cohesionAngle  = -0.15f;
-            const float cohesionWeight = 8.0f;
+            const float separationRadius = p.separationRadius;
+            const float alignmentRadius = p.alignmentRadius;
+            const float cohesionRadius = p.cohesionRadius;
 
             const float maxRadius = maxXXX (separationRadius,
                                             maxXXX (alignmentRadius,
                                                     cohesionRadius));
 
             // find all flockmates within maxRadius using proximity database
+            // (or in this boid's neighbor list, when the flock uses them)
+            AVNeighborGroup& neighbors = context.neighborRecords;
             neighbors.clear();
-            proximityToken->findNeighbors (position(), maxRadius, neighbors);
-
-    #ifndef NO_LQ_BIN_STATS
-            // maintain stats on max/min/ave neighbors per boids
-            size_t count = neighbors.size();
-            if (maxNeighbors < count) maxNeighbors = count;
-            if (minNeighbors > count) minNeighbors = count;
-            totalNeighbors += count;
-    #endif // NO_LQ_BIN_STATS
-
-            // determine each of the three component behaviors of flocking
-            const Vec3 separation = steerForSeparation (separationRadius,
-                                                        separationAngle,
-                                                        neighbors);
-            const Vec3 alignment  = steerForAlignment  (alignmentRadius,
-                                                        alignmentAngle,
-                                                        neighbors);
-            const Vec3 cohesion   = steerForCohesion   (cohesionRadius,
-                                                        cohesionAngle,
-                                                        neighbors);
-
-            // apply weights to components (save in variables for annotation)
-            const Vec3 separationW = separation * separationWeight;
-            const Vec3 alignmentW = alignment * alignmentWeight;
-            const Vec3 cohesionW = cohesion * cohesionWeight;
-
-            // annotation
-            // const float s = 0.1;
-            // annotationLine (position, position + (separationW * s), gRed);
-            // annotationLine (position, position + (alignmentW  * s), gOrange);
-            // annotationLine (position, position + (cohesionW   * s), gYellow);
-
-            return separationW + alignmentW + cohesionW;
+            if (world.useNeighborLists)
+                neighborList.findNeighbors (world.neighborSkin, *proximityToken,
+                                            position(), maxRadius, neighbors);
+            else if (world.refreshSlices.slices () > 1)
+                neighborList.findNeighbors (world.refreshSlices, serialNumber,
+                                            *proximityToken,
+                                            position(), maxRadius, neighbors);
+            else
+                proximityToken->findNeighbors (position(), maxRadius, neighbors);
+
+            // saved for the max/min/ave neighbors per boid stats
+            neighborCount = neighbors.size();
+
+            // the weighted sum of the three component behaviors of
+            // flocking, in one pass over the neighbors
+            const BoidBehavior behaviors[] =
+            {
+                BoidBehavior (BoidBehavior::separation, separationRadius,
+                              p.separationAngle, p.separationWeight),
+                BoidBehavior (BoidBehavior::alignment, alignmentRadius,
+                              p.alignmentAngle, p.alignmentWeight),
+                BoidBehavior (BoidBehavior::cohesion, cohesionRadius,
+                              p.cohesionAngle, p.cohesionWeight)
+            };
+            return steerForFlocking<Boid> (behaviors, 3, neighbors);
         }
 
 
@@ -281,15 +387,21 @@ namespace {
         }
 
 
-        // group of all obstacles to be avoided by each Boid
-        static ObstacleGroup obstacles;
+        // the flock this boid belongs to
+        BoidsWorld& world;
 
         // a pointer to this boid's interface object for the proximity database
         ProximityToken* proximityToken;
 
-        // allocate one and share amoung instances just to save memory usage
-        // (change to per-instance allocation to be more MP-safe)
-        static AVGroup neighbors;
+        // this boid's flockmates as of the last rebuild (or refresh) of
+        // its neighbor list
+        NeighborList neighborList;
+
+        // steering force from computeSteering, used by applySteering
+        Vec3 steering;
+
+        // number of neighbors found by the last steerToFlock
+        size_t neighborCount;
 
         static float worldRadius;
 
@@ -310,19 +422,10 @@ namespace {
             annotationLine (BL, BR, white);
             annotationLine (BR, FR, white);
         }
-
-    #ifndef NO_LQ_BIN_STATS
-            static size_t minNeighbors, maxNeighbors, totalNeighbors;
-    #endif // NO_LQ_BIN_STATS
     };
 
 
-    AVGroup Boid::neighbors;
     float Boid::worldRadius = 50.0f;
-    ObstacleGroup Boid::obstacles;
-    #ifndef NO_LQ_BIN_STATS
-    size_t Boid::minNeighbors, Boid::maxNeighbors, Boid::totalNeighbors;
-    #endif // NO_LQ_BIN_STATS
 
 
     // ----------------------------------------------------------------------------
@@ -337,26 +440,64 @@ namespace {
 
         float selectionOrderSortKey (void) {return 0.03f;}
 
+        BoidsPlugIn (void) : boidPool (64, MemoryAccount::vehicleMemory) {}
+
+        // an unregistered flock, for a World
+        BoidsPlugIn (WorldInstanceTag tag)
+            : PlugIn (tag), boidPool (64, MemoryAccount::vehicleMemory) {}
+
+        AbstractPlugIn* newWorldInstance (void)
+        {
+            return new BoidsPlugIn (worldInstance);
+        }
+
         virtual ~BoidsPlugIn() {} // be more "nice" to avoid a compiler warning
 
         void open (void)
         {
             // make the database used to accelerate proximity queries
             cyclePD = -1;
+            showPDStatistics = false;
             nextPD ();
 
+    #ifndef NO_LQ_BIN_STATS
+            // no neighbors counted yet
+            minNeighbors = maxNeighbors = totalNeighbors = 0;
+    #endif // NO_LQ_BIN_STATS
+
+            // the boids are updated by their own objects until the grid
+            // engine is switched on
+            useEngine = false;
+            engineIsStale = true;
+            flockIsStale = false;
+
+            // boids query the database at every update until neighbor
+            // lists or staggered refresh are switched on
+            world.useNeighborLists = false;
+            world.refreshSlices.setSlices (1);
+
+            // flocking parameters are the standard ones until set by name
+            world.flocking = FlockEngine::Parameters ();
+
+            // the boids stay in the order they were added until a spatial
+            // reorder period is set by name (passes then take 8 frames)
+            reorder.setSchedule (0, 8);
+
             // make default-sized flock
             population = 0;
-            for (int i = 0; i < 200; i++) addBoidToFlock ();
+            addBoidsToFlock (200);
 
-            // initialize camera
-            OpenSteerDemo::init3dCamera (*OpenSteerDemo::selectedVehicle);
-            OpenSteerDemo::camera.mode = Camera::cmFixed;
-            OpenSteerDemo::camera.fixedDistDistance = OpenSteerDemo::cameraTargetDistance;
-            OpenSteerDemo::camera.fixedDistVOffset = 0;
-            OpenSteerDemo::camera.lookdownDistance = 20;
-            OpenSteerDemo::camera.aimLeadTime = 0.5;
-            OpenSteerDemo::camera.povOffset.set (0, 0.5, -2);
+            // initialize camera (of OpenSteerDemo's flock only)
+            if (! isWorldInstance ())
+            {
+                OpenSteerDemo::init3dCamera (*OpenSteerDemo::selectedVehicle);
+                OpenSteerDemo::camera.mode = Camera::cmFixed;
+                OpenSteerDemo::camera.fixedDistDistance = OpenSteerDemo::cameraTargetDistance;
+                OpenSteerDemo::camera.fixedDistVOffset = 0;
+                OpenSteerDemo::camera.lookdownDistance = 20;
+                OpenSteerDemo::camera.aimLeadTime = 0.5;
+                OpenSteerDemo::camera.povOffset.set (0, 0.5, -2);
+            }
 
             // set up obstacles
             initObstacles ();
@@ -365,19 +506,341 @@ namespace {
         void update (const float currentTime, const float elapsedTime)
         {
     #ifndef NO_LQ_BIN_STATS
-            Boid::maxNeighbors = Boid::totalNeighbors = 0;
-            Boid::minNeighbors = std::numeric_limits<int>::max();
+            maxNeighbors = totalNeighbors = 0;
+            minNeighbors = std::numeric_limits<int>::max();
     #endif // NO_LQ_BIN_STATS
 
-            // update flock simulation for each boid
+            // the grid engine updates the whole flock in its own buffers
+            if (engineIsOn ())
+            {
+                stepEngine (elapsedTime);
+                return;
+            }
+            synchronizeFlock ();
+
+            // move the next share of a spatial reorder pass into place
+            reorderFlock ();
+
+            // between frames: let the proximity database do its upkeep
+            pd->maintain ();
+            pd->resetStatistics ();
+
+            // and see whether the neighbor lists must be rebuilt
+            if (world.useNeighborLists) world.neighborSkin.beginFrame (flock);
+
+            // give up detail while over the frame time budget
+            if (! isWorldInstance ())
+            {
+                scheduler.setBandScale (OpenSteerDemo::degradedBandScale ());
+                world.refreshSlices.setMinimumSlices
+                    (OpenSteerDemo::degradedNeighborSlices ());
+            }
+
+            // pick the boids to update this frame (all of them unless level
+            // of detail scheduling is on)
+            scheduler.clearFoci ();
+            if (! isWorldInstance ())
+            {
+                scheduler.addFocus (OpenSteerDemo::cameraPosition ());
+                if (OpenSteerDemo::selectedVehicle)
+                    scheduler.addFocus (OpenSteerDemo::selectedVehicle->position ());
+            }
+            scheduler.schedule (flock, elapsedTime);
+            const std::vector<size_t>& due = scheduler.dueAgents ();
+
+            if (updatesInParallel ())
+            {
+                // phase one: every boid determines its steering from the
+                // flock's state as of the previous frame, in parallel.
+                // Annotation is not thread-safe, so it is off meanwhile.
+                const bool annotation = annotationIsOn ();
+                setAnnotationOff ();
+                world.contexts.prepare (WorkerPool::shared());
+                ComputeSteering computeSteering (flock, due, world.contexts);
+                {
+                    PhaseTimer::Scope timer (PhaseTimer::steeringPhase);
+                    WorkerPool::shared().parallelFor (due.size(),
+                                                      computeSteering);
+                }
+                if (annotation) setAnnotationOn ();
+
+                // phase two: integrate in parallel, then update all proximity
+                // tokens in one batch
+                tokens.resize (due.size());
+                positions.resize (due.size());
+                Integrate integrate (flock, due, scheduler,
+                                     tokens, positions);
+                WorkerPool::shared().parallelFor (due.size(), integrate);
+                if (! due.empty())
+                    pd->updateForNewPositions (&tokens[0], &positions[0],
+                                               due.size(),
+                                               &WorkerPool::shared());
+            }
+            else
+            {
+                // update flock simulation for each boid (on whichever
+                // thread of a pool steps this flock's World)
+                world.contexts.prepareForThisThread ();
+                for (size_t i = 0; i < due.size(); i++)
+                {
+                    flock[due[i]]->update (currentTime,
+                                           scheduler.elapsedTime (due[i]));
+                }
+            }
+
+    #ifndef NO_LQ_BIN_STATS
+            // maintain stats on max/min/ave neighbors per boids
             for (iterator i = flock.begin(); i != flock.end(); i++)
             {
-                (**i).update (currentTime, elapsedTime);
+                const size_t count = (**i).neighborCount;
+                if (maxNeighbors < count) maxNeighbors = count;
+                if (minNeighbors > count) minNeighbors = count;
+                totalNeighbors += count;
+            }
+    #endif // NO_LQ_BIN_STATS
+
+            // this frame's proximity database costs, for the status display
+            if (showPDStatistics) pd->getStatistics (pdStatistics, 9);
+        }
+
+        // the two-phase parallel update is for OpenSteerDemo's flock, the
+        // flocks of Worlds are updated in parallel with each other instead
+        bool updatesInParallel (void) const
+        {
+            return parallelUpdateIsOn () && ! isWorldInstance ();
+        }
+
+        // loop body for the parallel phase one of the two-phase update
+        class ComputeSteering
+        {
+        public:
+            ComputeSteering (Boid::groupType& f,
+                             const std::vector<size_t>& d,
+                             SimulationContexts& c)
+                : flock (f), due (d), contexts (c) {}
+            void operator() (size_t begin, size_t end)
+            {
+                SimulationContext& context = contexts.forThisThread ();
+                for (size_t i = begin; i < end; i++)
+                    flock[due[i]]->computeSteering (context);
+            }
+        private:
+            Boid::groupType& flock;
+            const std::vector<size_t>& due;
+            SimulationContexts& contexts;
+        };
+
+        // loop body for the parallel phase two: integrates each boid and
+        // gathers its token and new position for the batch token update
+        class Integrate
+        {
+        public:
+            Integrate (Boid::groupType& f,
+                       const std::vector<size_t>& d,
+                       const UpdateScheduler& s,
+                       std::vector<ProximityToken*>& t,
+                       std::vector<Vec3>& p)
+                : flock (f), due (d), scheduler (s), tokens (t), positions (p) {}
+            void operator() (size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; i++)
+                {
+                    Boid& boid = *flock[due[i]];
+                    boid.integrate (scheduler.elapsedTime (due[i]));
+                    tokens[i] = boid.proximityToken;
+                    positions[i] = boid.position();
+                }
+            }
+        private:
+            Boid::groupType& flock;
+            const std::vector<size_t>& due;
+            const UpdateScheduler& scheduler;
+            std::vector<ProximityToken*>& tokens;
+            std::vector<Vec3>& positions;
+        };
+
+        // grid engine update: upload the flock if the boids have changed
+        // since the engine last saw them, then step all of it
+        void stepEngine (const float elapsedTime)
+        {
+            if (engineIsStale)
+            {
+                VehiclePopulation& buffers = engine.population ();
+                buffers.clear ();
+                buffers.reserve (flock.size());
+                for (iterator i = flock.begin(); i != flock.end(); i++)
+                    buffers.add (**i);
+                engineIsStale = false;
+            }
+
+            {
+                PhaseTimer::Scope timer (PhaseTimer::steeringPhase);
+                engine.step (elapsedTime, (updatesInParallel () ?
+                                           &WorkerPool::shared() : NULL));
+            }
+            flockIsStale = true;
+
+    #ifndef NO_LQ_BIN_STATS
+            for (size_t i = 0; i < flock.size(); i++)
+            {
+                const size_t count = engine.neighborCount (i);
+                if (maxNeighbors < count) maxNeighbors = count;
+                if (minNeighbors > count) minNeighbors = count;
+                totalNeighbors += count;
+            }
+    #endif // NO_LQ_BIN_STATS
+        }
+
+        // spatial reorder (see SpatialReorder.h): at the start of a pass
+        // the flock is sorted by the boids' storage addresses, then each
+        // frame's exchanges swap the state of boids between their slots
+        // of the pool, so the boids end up in storage (and in the flock,
+        // and their tokens in the pool of tokens) in Morton order of their
+        // positions.  Vehicle pointers refer to storage, not to a boid:
+        // the plugin remaps the only one held outside it across frames,
+        // OpenSteerDemo's selected vehicle (the camera's tracked vehicle
+        // and the trail focus are set from it each frame), and the
+        // scheduler's state follows the boids too.  The moved boids'
+        // tokens are placed anew.
+        void reorderFlock (void)
+        {
+            if (reorder.beginFrame (flock.size()))
+            {
+                sortFlockByStorage ();
+                positions.resize (flock.size());
+                for (size_t i = 0; i < flock.size(); i++)
+                    positions[i] = flock[i]->position();
+                reorder.beginPass (&positions[0], flock.size());
             }
+
+            const std::vector<SpatialReorder::Exchange>& exchanges =
+                reorder.exchanges ();
+            if (exchanges.empty ()) return;
+            moved.clear ();
+            for (size_t e = 0; e < exchanges.size(); e++)
+            {
+                const size_t i = exchanges[e].first;
+                const size_t j = exchanges[e].second;
+                flock[i]->exchangeState (*flock[j]);
+                scheduler.swapAgents (i, j);
+                if (OpenSteerDemo::selectedVehicle == flock[i])
+                    OpenSteerDemo::selectedVehicle = flock[j];
+                else if (OpenSteerDemo::selectedVehicle == flock[j])
+                    OpenSteerDemo::selectedVehicle = flock[i];
+                moved.push_back (i);
+                moved.push_back (j);
+            }
+            std::sort (moved.begin(), moved.end());
+            moved.erase (std::unique (moved.begin(), moved.end()), moved.end());
+            placeInDatabase (moved);
+            engineIsStale = true;
+        }
+
+        // order the flock by the boids' addresses (so by their slots in
+        // the pool), taking their scheduling state along
+        void sortFlockByStorage (void)
+        {
+            std::vector<size_t> order (flock.size());
+            for (size_t i = 0; i < order.size(); i++) order[i] = i;
+            std::sort (order.begin(), order.end(), StorageOrder (flock));
+
+            Boid::groupType sorted (flock.size());
+            for (size_t i = 0; i < order.size(); i++) sorted[i] = flock[order[i]];
+            if (sorted == flock) return;
+            flock.swap (sorted);
+            scheduler.reorderAgents (order);
+            world.invalidateNeighborLists ();
+            engineIsStale = true;
+        }
+
+        class StorageOrder
+        {
+        public:
+            StorageOrder (const Boid::groupType& f) : flock (f) {}
+            bool operator() (const size_t a, const size_t b) const
+            {
+                return std::less<const Boid*> () (flock[a], flock[b]);
+            }
+        private:
+            const Boid::groupType& flock;
+        };
+
+        // read the engine's state back into the boids (and their proximity
+        // tokens) when it is newer than theirs
+        void synchronizeFlock (void)
+        {
+            if (! flockIsStale) return;
+            const VehiclePopulation& buffers = engine.population ();
+            for (size_t i = 0; i < flock.size(); i++)
+                buffers.store (i, *flock[i]);
+            placeInDatabase (0, flock.size());
+            flockIsStale = false;
+        }
+
+        // the grid engine runs when switched on and every obstacle is a
+        // sphere (the boids update themselves otherwise)
+        bool engineIsOn (void) const
+        {
+            return useEngine && (engineSpheres.size() == world.obstacles.size());
+        }
+
+        void toggleEngine (void)
+        {
+            synchronizeFlock ();
+            useEngine = ! useEngine;
+            engineIsStale = true;
+        }
+
+        // cycle the grid engine's far cell aggregation through off, 0.5
+        // and 1, sampling the error of every 64th boid while it is on
+        void nextApproximation (void)
+        {
+            FlockEngine::Parameters p = engine.parameters ();
+            if (p.approximation <= 0)
+                p.approximation = 0.5f;
+            else if (p.approximation < 1)
+                p.approximation = 1;
+            else
+                p.approximation = 0;
+            p.errorSampleStride = 64;
+            engine.setParameters (p);
+        }
+
+        // the grid engine's alignment and cohesion radii: those of
+        // Boid::steerToFlock, or wide ones
+        void toggleWideRadii (void)
+        {
+            FlockEngine::Parameters p = engine.parameters ();
+            const FlockEngine::Parameters standard;
+            const bool wide = (p.cohesionRadius != standard.cohesionRadius);
+            p.alignmentRadius = wide ? standard.alignmentRadius : 20.0f;
+            p.cohesionRadius = wide ? standard.cohesionRadius : 30.0f;
+            engine.setParameters (p);
+        }
+
+        // boids find their flockmates in persistent neighbor lists, made
+        // with a query of a larger radius and rebuilt only when some boid
+        // may have crossed the skin, or query the database each update
+        void toggleNeighborLists (void)
+        {
+            world.useNeighborLists = ! world.useNeighborLists;
+            world.invalidateNeighborLists ();
+        }
+
+        // when neighbor lists are off, boids may instead refresh their
+        // neighbors at every 2nd, 4th or 8th update only (and take them
+        // from their previous query otherwise), or at every update
+        void nextRefreshSlices (void)
+        {
+            const size_t n = world.refreshSlices.slices ();
+            world.refreshSlices.setSlices ((n >= 8) ? 1 : n * 2);
         }
 
         void redraw (const float currentTime, const float elapsedTime)
         {
+            // the boids are drawn from their own objects
+            synchronizeFlock ();
+
             // selected vehicle (user can mouse click to select another)
             AbstractVehicle& selected = *OpenSteerDemo::selectedVehicle;
 
@@ -387,8 +850,23 @@ namespace {
             // update camera
             OpenSteerDemo::updateCamera (currentTime, elapsedTime, selected);
 
-            // draw each boid in flock
-            for (iterator i = flock.begin(); i != flock.end(); i++) (**i).draw ();
+            // draw each boid the camera may see (all bodies in one batch),
+            // found by querying the proximity database over the part of the
+            // wrap-around sphere's bounding box inside the view frustum
+            visibleBoids.clear ();
+            if (! flock.empty ())
+            {
+                const float extent = Boid::worldRadius * 1.1f;
+                const Vec3 corner (extent, extent, extent);
+                OpenSteerDemo::camera.findVisibleVehicles (*flock[0]->proximityToken,
+                                                           -corner, corner,
+                                                           flock[0]->radius (),
+                                                           visibleBoids);
+            }
+            beginVehicleBatch ();
+            for (AVIterator i = visibleBoids.begin(); i != visibleBoids.end(); i++)
+                static_cast<Boid*> (*i)->draw ();
+            drawVehicleBatch ();
 
             // highlight vehicle nearest mouse
             OpenSteerDemo::drawCircleHighlightOnVehicle (nearMouse, 1, gGray70);
@@ -398,13 +876,65 @@ namespace {
 
             // display status in the upper left corner of the window
             std::ostringstream status;
-            status << "[F1/F2] " << population << " boids";
+            status << "[F1/F2] " << population << " boids ("
+                   << visibleBoids.size () << " in view)";
             status << "\n[F3]    PD type: ";
             switch (cyclePD)
             {
             case 0: status << "LQ bin lattice"; break;
             case 1: status << "brute force";    break;
+            case 2: status << "flat array grid"; break;
             }
+            status << "\n[F6]    Update: "
+                   << (parallelUpdateIsOn () ? "parallel two-phase" : "serial");
+            status << "\n[F8]    Grid engine: ";
+            if (! useEngine)
+                status << "off";
+            else if (engineIsOn ())
+                status << engine.gridCells (0) << "x" << engine.gridCells (1)
+                       << "x" << engine.gridCells (2) << " cells";
+            else
+                status << "on, not for these obstacles";
+            const FlockEngine::Parameters& ep = engine.parameters ();
+            status << "\n[F9]    Far cell aggregates: ";
+            if (ep.approximation <= 0)
+                status << "off";
+            else
+            {
+                status << "width/distance < " << ep.approximation;
+                if (engine.approximationErrorSamples ())
+                    status << ", steering error mean "
+                           << engine.approximationErrorMean ()
+                           << " max " << engine.approximationErrorMax ();
+            }
+            status << "\n[F10]   Engine flocking radii: "
+                   << ep.separationRadius << " / " << ep.alignmentRadius
+                   << " / " << ep.cohesionRadius;
+            status << "\n[F11]   Neighbor lists: ";
+            if (world.useNeighborLists)
+                status << "skin " << world.neighborSkin.skin ()
+                       << ", " << world.neighborSkin.rebuildCount ()
+                       << " rebuilds";
+            else
+                status << "off";
+            status << "\n[F12]   Neighbor refresh: ";
+            if (world.useNeighborLists)
+                status << "by neighbor lists";
+            else if (world.refreshSlices.slices () > 1)
+                status << "every " << world.refreshSlices.slices ()
+                       << " updates";
+            else
+                status << "every update";
+            status << "\n[F7]    Level of detail: ";
+            if (scheduler.bandCount () == 0)
+                status << "off";
+            else
+                status << scheduler.dueAgents().size() << " boids updated";
+            status << "\n[F5]    PD statistics: ";
+            if (showPDStatistics)
+                writePDStatistics (status);
+            else
+                status << "off";
             status << "\n[F4]    Obstacles: ";
             switch (constraint)
             {
@@ -438,7 +968,7 @@ namespace {
         void close (void)
         {
             // delete each member of the flock
-            while (population > 0) removeBoidFromFlock ();
+            removeBoidsFromFlock (population);
 
             // delete the proximity database
             delete pd;
@@ -447,8 +977,16 @@ namespace {
 
         void reset (void)
         {
-            // reset each boid in flock
-            for (iterator i = flock.begin(); i != flock.end(); i++) (**i).reset();
+            flockIsStale = false;
+            engineIsStale = true;
+            reorder.cancel ();
+
+            // reset each boid in flock in place, then update their
+            // proximity tokens in one batch
+            for (iterator i = flock.begin(); i != flock.end(); i++) (**i).resetState();
+            placeInDatabase (0, flock.size());
+
+            if (isWorldInstance ()) return;
 
             // reset camera position
             OpenSteerDemo::position3dCamera (*OpenSteerDemo::selectedVehicle);
@@ -466,7 +1004,6 @@ namespace {
             ProximityDatabase* oldPD = pd;
 
             // allocate new PD
-            const int totalPD = 2;
             switch (cyclePD = (cyclePD + 1) % totalPD)
             {
             case 0:
@@ -477,7 +1014,9 @@ namespace {
                     const float diameter = Boid::worldRadius * 1.1f * 2;
                     const Vec3 dimensions (diameter, diameter, diameter);
                     typedef LQProximityDatabase<AbstractVehicle*> LQPDAV;
-                    pd = new LQPDAV (center, dimensions, divisions);
+                    LQPDAV* lqpd = new LQPDAV (center, dimensions, divisions);
+                    lqpd->setAdaptive (true);
+                    pd = lqpd;
                     break;
                 }
             case 1:
@@ -485,10 +1024,24 @@ namespace {
                     pd = new BruteForceProximityDatabase<AbstractVehicle*> ();
                     break;
                 }
+            case 2:
+                {
+                    const Vec3 center;
+                    const float div = 10.0f;
+                    const Vec3 divisions (div, div, div);
+                    const float diameter = Boid::worldRadius * 1.1f * 2;
+                    const Vec3 dimensions (diameter, diameter, diameter);
+                    typedef GridProximityDatabase<AbstractVehicle*> GridPDAV;
+                    pd = new GridPDAV (center, dimensions, divisions);
+                    break;
+                }
             }
 
             // switch each boid to new PD
+            pd->setStatisticsEnabled (showPDStatistics);
+            pd->reserveTokens (flock.size());
             for (iterator i=flock.begin(); i!=flock.end(); i++) (**i).newPD(*pd);
+            world.invalidateNeighborLists ();
 
             // delete old PD (if any)
             delete oldPD;
@@ -502,29 +1055,84 @@ namespace {
             case 2:  removeBoidFromFlock ();    break;
             case 3:  nextPD ();                 break;
             case 4:  nextBoundaryCondition ();  break;
-            case 5:  printLQbinStats ();        break;
+            case 5:  togglePDStatistics ();     break;
+            case 6:  toggleParallelUpdateState (); break;
+            case 7:  toggleLevelOfDetail ();    break;
+            case 8:  toggleEngine ();           break;
+            case 9:  nextApproximation ();      break;
+            case 10: toggleWideRadii ();        break;
+            case 11: toggleNeighborLists ();    break;
+            case 12: nextRefreshSlices ();      break;
             }
         }
 
-        void printLQbinStats (void)
+        // level of detail: boids far from the camera and the selected
+        // boid are updated every second or fourth frame, none of them
+        // less than ten times a second
+        void toggleLevelOfDetail (void)
+        {
+            if (scheduler.bandCount () == 0)
+            {
+                scheduler.addBand (20, 1);
+                scheduler.addBand (40, 2);
+                scheduler.addBand (std::numeric_limits<float>::max(), 4);
+                scheduler.setMaxStaleness (0.1f);
+            }
+            else
+            {
+                scheduler.clearBands ();
+            }
+        }
+
+        // count the proximity database's query costs each frame, and show
+        // them with its bin occupancy in the status display
+        void togglePDStatistics (void)
+        {
+            showPDStatistics = ! showPDStatistics;
+            pd->setStatisticsEnabled (showPDStatistics);
+            pdStatistics.clear ();
+        }
+
+        void writePDStatistics (std::ostringstream& status)
+        {
+            const ProximityStatistics& s = pdStatistics;
+            status << s.queries << " queries, "
+                   << (int) round (s.candidatesPerQuery ()) << " candidates"
+                   << " (" << (int) round (100 * s.acceptanceRate ()) << "%"
+                   << " accepted) and "
+                   << (s.queries ? (int) round ((float) s.binsVisited / s.queries) : 0)
+                   << " bins per query";
+            status << "\n        " << s.binMigrations << " of "
+                   << s.positionUpdates << " updates changed bins, "
+                   << s.outsideBinCandidates << " outside bin candidates";
+            status << "\n        bins holding n boids:";
+            for (size_t n = 0; n < s.occupancy.size(); n++)
+            {
+                if (s.occupancy[n] == 0) continue;
+                status << " " << n;
+                if (n + 1 == s.occupancy.size()) status << "+";
+                status << ":" << s.occupancy[n];
+            }
+            if (s.outsideBinPopulation)
+                status << " outside:" << s.outsideBinPopulation;
+        }
+
+        // neighbors per boid found by the last update, for the profiler
+        // display of OpenSteerDemo
+        bool neighborStatistics (int& minimum, int& maximum,
+                                 float& average)
         {
     #ifndef NO_LQ_BIN_STATS
-            int min, max; float average;
-            Boid& aBoid = **(flock.begin());
-            aBoid.proximityToken->getBinPopulationStats (min, max, average);
-            std::cout << std::setprecision (2)
-                      << std::setiosflags (std::ios::fixed);
-            std::cout << "Bin populations: min, max, average: "
-                      << min << ", " << max << ", " << average
-                      << " (non-empty bins)" << std::endl; 
-            std::cout << "Boid neighbors:  min, max, average: "
-                      << Boid::minNeighbors << ", "
-                      << Boid::maxNeighbors << ", "
-                      << ((float)Boid::totalNeighbors) / ((float)population)
-                      << std::endl;
+            if (population == 0) return false;
+            minimum = (int) minNeighbors;
+            maximum = (int) maxNeighbors;
+            average = ((float)totalNeighbors) / ((float)population);
+            return true;
+    #else
+            return false;
     #endif // NO_LQ_BIN_STATS
         }
-     
+
         void printMiniHelpForFunctionKeys (void)
         {
             std::ostringstream message;
@@ -535,51 +1143,297 @@ namespace {
             OpenSteerDemo::printMessage ("  F2     remove a boid from the flock.");
             OpenSteerDemo::printMessage ("  F3     use next proximity database.");
             OpenSteerDemo::printMessage ("  F4     next flock boundary condition.");
+            OpenSteerDemo::printMessage ("  F5     toggle proximity database statistics.");
+            OpenSteerDemo::printMessage ("  F6     toggle parallel two-phase update.");
+            OpenSteerDemo::printMessage ("  F7     toggle level of detail update scheduling.");
+            OpenSteerDemo::printMessage ("  F8     toggle the data parallel grid engine.");
+            OpenSteerDemo::printMessage ("  F9     grid engine: next far cell aggregation threshold.");
+            OpenSteerDemo::printMessage ("  F10    grid engine: toggle wide alignment and cohesion radii.");
+            OpenSteerDemo::printMessage ("  F11    toggle persistent neighbor lists.");
+            OpenSteerDemo::printMessage ("  F12    next staggered neighbor refresh interval.");
             OpenSteerDemo::printMessage ("");
         }
 
         void addBoidToFlock (void)
         {
-            population++;
-            Boid* boid = new Boid (*pd);
-            flock.push_back (boid);
-            if (population == 1) OpenSteerDemo::selectedVehicle = boid;
+            addBoidsToFlock (1);
         }
 
         void removeBoidFromFlock (void)
         {
-            if (population > 0)
+            removeBoidsFromFlock (1);
+        }
+
+        // add count boids at once: their storage comes from the pool (in
+        // one chunk) and their tokens get their positions in one batch
+        void addBoidsToFlock (const int count)
+        {
+            if (count <= 0) return;
+            synchronizeFlock ();
+            engineIsStale = true;
+            reorder.cancel ();
+            boidPool.reserve (count);
+            pd->reserveTokens (count);
+            const size_t first = flock.size();
+            flock.reserve (first + count);
+            for (int i = 0; i < count; i++)
+                flock.push_back (new (boidPool) Boid (*pd, world));
+            population += count;
+            if ((first == 0) && ! isWorldInstance ())
+                OpenSteerDemo::selectedVehicle = flock[0];
+            placeInDatabase (first, flock.size());
+        }
+
+        // remove the last count boids (at most the whole flock) at once
+        void removeBoidsFromFlock (int count)
+        {
+            if (count > population) count = population;
+            synchronizeFlock ();
+            engineIsStale = true;
+            reorder.cancel ();
+            for (int i = 0; i < count; i++)
             {
                 // save a pointer to the last boid, then remove it from the flock
                 const Boid* boid = flock.back();
                 flock.pop_back();
-                population--;
 
                 // if it is OpenSteerDemo's selected vehicle, unselect it
                 if (boid == OpenSteerDemo::selectedVehicle)
                     OpenSteerDemo::selectedVehicle = NULL;
 
-                // delete the Boid
+                // delete the Boid (its storage goes back to the pool)
                 delete boid;
             }
+            population -= count;
+            world.invalidateNeighborLists ();
+        }
+
+        // notify the proximity database of the positions of the boids in
+        // [begin, end) of the flock, in one batch
+        void placeInDatabase (const size_t begin, const size_t end)
+        {
+            world.invalidateNeighborLists ();
+            const size_t count = end - begin;
+            if (count == 0) return;
+            tokens.resize (count);
+            positions.resize (count);
+            for (size_t i = 0; i < count; i++)
+            {
+                tokens[i] = flock[begin + i]->proximityToken;
+                positions[i] = flock[begin + i]->position();
+            }
+            pd->updateForNewPositions (&tokens[0], &positions[0], count,
+                                       &WorkerPool::shared());
+        }
+
+        // the same for the boids with the given indices, in that order
+        void placeInDatabase (const std::vector<size_t>& order)
+        {
+            world.invalidateNeighborLists ();
+            const size_t count = order.size();
+            if (count == 0) return;
+            tokens.resize (count);
+            positions.resize (count);
+            for (size_t i = 0; i < count; i++)
+            {
+                tokens[i] = flock[order[i]]->proximityToken;
+                positions[i] = flock[order[i]]->position();
+            }
+            pd->updateForNewPositions (&tokens[0], &positions[0], count,
+                                       &WorkerPool::shared());
+        }
+
+        // add or remove boids until the flock has the given size
+        bool setPopulation (int count)
+        {
+            if (population < count) addBoidsToFlock (count - population);
+            if (population > count) removeBoidsFromFlock (population - count);
+            return true;
+        }
+
+        // set a flocking weight or radius (of the boids and of the grid
+        // engine) by name: separationWeight, separationRadius,
+        // alignmentWeight, alignmentRadius, cohesionWeight, cohesionRadius;
+        // or the spatial reorder's schedule: reorderPeriod (frames between
+        // passes, zero for none) and reorderPassFrames (frames per pass)
+        bool setParameter (const char* name, const float value)
+        {
+            FlockEngine::Parameters e = engine.parameters ();
+            float* parameters [2];
+            if (strcmp (name, "separationWeight") == 0)
+            {
+                parameters[0] = &world.flocking.separationWeight;
+                parameters[1] = &e.separationWeight;
+            }
+            else if (strcmp (name, "separationRadius") == 0)
+            {
+                parameters[0] = &world.flocking.separationRadius;
+                parameters[1] = &e.separationRadius;
+            }
+            else if (strcmp (name, "alignmentWeight") == 0)
+            {
+                parameters[0] = &world.flocking.alignmentWeight;
+                parameters[1] = &e.alignmentWeight;
+            }
+            else if (strcmp (name, "alignmentRadius") == 0)
+            {
+                parameters[0] = &world.flocking.alignmentRadius;
+                parameters[1] = &e.alignmentRadius;
+            }
+            else if (strcmp (name, "cohesionWeight") == 0)
+            {
+                parameters[0] = &world.flocking.cohesionWeight;
+                parameters[1] = &e.cohesionWeight;
+            }
+            else if (strcmp (name, "cohesionRadius") == 0)
+            {
+                parameters[0] = &world.flocking.cohesionRadius;
+                parameters[1] = &e.cohesionRadius;
+            }
+            else if (strcmp (name, "reorderPeriod") == 0)
+            {
+                reorder.setSchedule ((int) value, reorder.passFrames ());
+                return true;
+            }
+            else if (strcmp (name, "reorderPassFrames") == 0)
+            {
+                reorder.setSchedule (reorder.period (), (int) value);
+                return true;
+            }
+            else
+            {
+                return false;
+            }
+            *parameters[0] = *parameters[1] = value;
+            engine.setParameters (e);
+
+            // neighbor lists were gathered with the old radii
+            world.invalidateNeighborLists ();
+            return true;
         }
 
-        // return an AVGroup containing each boid of the flock
-        const AVGroup& allVehicles (void) {return (const AVGroup&)flock;}
+        // save the flock, its proximity database type and obstacles
+        bool saveCheckpoint (CheckpointWriter& checkpoint)
+        {
+            synchronizeFlock ();
+            FlockSettings settings;
+            settings.proximityDatabase = cyclePD;
+            settings.constraint = constraint;
+            settings.levelOfDetail = (scheduler.bandCount () > 0);
+            checkpoint.addRecord (flockSettingsTag, settings);
+            checkpoint.addVehicles (boidsTag, flock);
+            checkpoint.addProximityDatabase (databaseStateTag,
+                                             placementOrderTag, *pd, flock);
+            return true;
+        }
+
+        // resize the flock to the saved one and restore each boid in place,
+        // then place them all in a new proximity database in one batch
+        bool loadCheckpoint (const CheckpointReader& checkpoint)
+        {
+            FlockSettings settings;
+            ProximityDatabaseState databaseState;
+            std::vector<size_t> order;
+            size_t count;
+            if (! checkpoint.record (flockSettingsTag, settings) ||
+                ! checkpoint.array<CheckpointVehicle> (boidsTag, count) ||
+                ! checkpoint.proximityDatabase (databaseStateTag,
+                                                placementOrderTag, count,
+                                                databaseState, order) ||
+                (settings.proximityDatabase < 0) ||
+                (settings.proximityDatabase >= totalPD) ||
+                (settings.constraint < none) ||
+                (settings.constraint > insideBox))
+                return false;
+
+            constraint = (ConstraintType) settings.constraint;
+            updateObstacles ();
+            if ((scheduler.bandCount () > 0) != (settings.levelOfDetail != 0))
+                toggleLevelOfDetail ();
+
+            setPopulation ((int) count);
+            checkpoint.restoreVehicles (boidsTag, flock);
+            engineIsStale = true;
+            reorder.cancel ();
+
+            // a new database (whose tokens have no positions yet) in the
+            // saved state
+            cyclePD = settings.proximityDatabase - 1;
+            nextPD ();
+            pd->restoreState (databaseState);
+            placeInDatabase (order);
+            return true;
+        }
+
+        // return an AVGroup containing each boid of the flock (brought up
+        // to date with the grid engine, which then takes them again from
+        // the boids, whose caller may change them)
+        const AVGroup& allVehicles (void)
+        {
+            if (useEngine)
+            {
+                synchronizeFlock ();
+                engineIsStale = true;
+            }
+            return (const AVGroup&)flock;
+        }
 
         // flock: a group (STL vector) of pointers to all boids
         Boid::groupType flock;
         typedef Boid::groupType::const_iterator iterator;
 
+        // the boids drawn by the last redraw: those the camera may see
+        AVGroup visibleBoids;
+
         // pointer to database used to accelerate proximity queries
         ProximityDatabase* pd;
 
+        // storage of the boids of the flock
+        ObjectPool<Boid> boidPool;
+
+        // the data parallel grid engine and its obstacles: whether it is
+        // switched on, whether it must take the flock from the boids at
+        // its next step, and whether its state is newer than the boids'
+        FlockEngine engine;
+        std::vector<const SphereObstacle*> engineSpheres;
+        bool useEngine;
+        bool engineIsStale;
+        bool flockIsStale;
+
+        // which boids to update each frame
+        UpdateScheduler scheduler;
+
+        // the flock's spatial reorder, and the indices of the boids moved
+        // by this frame's share of a pass
+        SpatialReorder reorder;
+        std::vector<size_t> moved;
+
+        // obstacles and per thread simulation contexts of the flock
+        BoidsWorld world;
+
+    #ifndef NO_LQ_BIN_STATS
+        // max/min/total neighbors per boid, of the latest update
+        size_t minNeighbors, maxNeighbors, totalNeighbors;
+    #endif // NO_LQ_BIN_STATS
+
+        // tokens and new positions for the batch updates of the parallel
+        // phase two and of new or reset boids, kept to reuse their storage
+        // between frames
+        std::vector<ProximityToken*> tokens;
+        std::vector<Vec3> positions;
+
         // keep track of current flock size
         int population;
 
         // which of the various proximity databases is currently in use
+        static const int totalPD = 3;
         int cyclePD;
 
+        // whether to count and show the proximity database's query costs,
+        // and the counts of the latest update
+        bool showPDStatistics;
+        ProximityStatistics pdStatistics;
+
         // --------------------------------------------------------
         // the rest of this plug-in supports the various obstacles:
         // --------------------------------------------------------
@@ -669,11 +1523,14 @@ namespace {
         }
 
 
-        // update Boid::obstacles list when constraint changes
+        // update the flock's obstacle list when constraint changes
         void updateObstacles (void)
         {
+            // the boids avoid the old obstacles until now
+            synchronizeFlock ();
+
             // first clear out obstacle list
-            Boid::obstacles.clear ();
+            world.obstacles.clear ();
 
             // add back obstacles based on mode
             switch (constraint)
@@ -684,43 +1541,56 @@ namespace {
             case none:
                 break;
             case insideSphere:
-                Boid::obstacles.push_back (&insideBigSphere);
+                world.obstacles.push_back (&insideBigSphere);
                 break;
             case outsideSphere:
-                Boid::obstacles.push_back (&insideBigSphere);
-                Boid::obstacles.push_back (&outsideSphere0);
+                world.obstacles.push_back (&insideBigSphere);
+                world.obstacles.push_back (&outsideSphere0);
                 break;
             case outsideSpheres:
-                Boid::obstacles.push_back (&insideBigSphere);
+                world.obstacles.push_back (&insideBigSphere);
             case outsideSpheresNoBig:
-                Boid::obstacles.push_back (&outsideSphere1);
-                Boid::obstacles.push_back (&outsideSphere2);
-                Boid::obstacles.push_back (&outsideSphere3);
-                Boid::obstacles.push_back (&outsideSphere4);
-                Boid::obstacles.push_back (&outsideSphere5);
-                Boid::obstacles.push_back (&outsideSphere6);
+                world.obstacles.push_back (&outsideSphere1);
+                world.obstacles.push_back (&outsideSphere2);
+                world.obstacles.push_back (&outsideSphere3);
+                world.obstacles.push_back (&outsideSphere4);
+                world.obstacles.push_back (&outsideSphere5);
+                world.obstacles.push_back (&outsideSphere6);
                 break;
             case rectangle:
-                Boid::obstacles.push_back (&insideBigSphere);
-                Boid::obstacles.push_back (&bigRectangle);
+                world.obstacles.push_back (&insideBigSphere);
+                world.obstacles.push_back (&bigRectangle);
             case rectangleNoBig:
-                Boid::obstacles.push_back (&bigRectangle);
+                world.obstacles.push_back (&bigRectangle);
                 break;
             case outsideBox:
-                Boid::obstacles.push_back (&insideBigSphere);
-                Boid::obstacles.push_back (&outsideBigBox);
+                world.obstacles.push_back (&insideBigSphere);
+                world.obstacles.push_back (&outsideBigBox);
                 break;
             case insideBox:
-                Boid::obstacles.push_back (&insideBigBox);
+                world.obstacles.push_back (&insideBigBox);
                 break;
             }
+            world.obstacleIndex.build (world.obstacles);
+
+            // the spheres among them, for the grid engine
+            engineSpheres.clear ();
+            for (ObstacleIterator o = world.obstacles.begin();
+                 o != world.obstacles.end();
+                 o++)
+            {
+                const SphereObstacle* sphere =
+                    dynamic_cast<const SphereObstacle*> (*o);
+                if (sphere) engineSpheres.push_back (sphere);
+            }
+            engine.setObstacles (engineSpheres);
         }
 
 
         void drawObstacles (void)
         {
-            for (ObstacleIterator o = Boid::obstacles.begin();
-                 o != Boid::obstacles.end();
+            for (ObstacleIterator o = world.obstacles.begin();
+                 o != world.obstacles.end();
                  o++)
             {
                 (**o).draw (false, // draw in wireframe
@@ -54,8 +54,10 @@
 #include <iomanip>
 #include <string>
 #include <sstream>
-#include "OpenSteer/SimpleVehicle.h"
+#include "OpenSteer/AsyncJob.h"
+#include "OpenSteer/PlanarVehicle.h"
 #include "OpenSteer/OpenSteerDemo.h"
+#include "OpenSteer/PhaseTimer.h"
 #include "OpenSteer/Color.h"
 
 namespace {
@@ -77,7 +79,7 @@ namespace {
     // common base class: CtfBase which is a specialization of SimpleVehicle.
 
 
-    class CtfBase : public SimpleVehicle
+    class CtfBase : public PlanarVehicle
     {
     public:
         // constructor
@@ -111,6 +113,7 @@ namespace {
         static int obstacleCount;
         static const int maxObstacleCount;
         static SOG allObstacles;
+        static ObstacleIndex obstacleIndex; // over allObstacles
     };
 
 
@@ -130,6 +133,10 @@ namespace {
         // is there a clear path to the goal?
         bool clearPathToGoal (void);
 
+        // the same from the latest finished query made off the frame
+        // thread (see AsyncJob.h), submitting the next one
+        bool plannedClearPathToGoal (void);
+
         Vec3 steeringForSeeker (void);
         void updateState (const float currentTime);
         void draw (void);
@@ -143,6 +150,10 @@ namespace {
         seekerState state;
         bool evading; // xxx store steer sub-state for anotation
         float lastRunningTime; // for auto-reset
+
+        // clear path decisions made off the frame thread, and the latest
+        AsyncPlan<bool> clearPathPlan;
+        bool plannedClearPath;
     };
 
 
@@ -187,6 +198,10 @@ namespace {
     bool enableAttackSeek  = true; // for testing (perhaps retain for UI control?)
     bool enableAttackEvade = true; // for testing (perhaps retain for UI control?)
 
+    // decide whether the path to the goal is clear off the frame thread,
+    // steering on the previous decision meanwhile (toggled by F3)
+    bool gAsyncPlanning = false;
+
     CtfSeeker* gSeeker = NULL;
 
 
@@ -206,6 +221,34 @@ namespace {
     CtfEnemy* ctfEnemies [ctfEnemyCount];
 
 
+    // ----------------------------------------------------------------------------
+    // what CtfSeeker::clearPathToGoal looks at, copied so that the decision
+    // can be made off the frame thread
+
+
+    class ClearPathQuery
+    {
+    public:
+        ClearPathQuery (const CtfSeeker& seeker);
+
+        // are there any enemies along the corridor to the goal?  Annotated
+        // by the seeker given, if any (only on the frame thread)
+        bool evaluate (CtfSeeker* annotating) const;
+        bool operator() (void) const {return evaluate (NULL);}
+
+    private:
+        Vec3 position;
+        Vec3 forward;
+        float radius;
+        bool goalIsAside;
+
+        Vec3 enemyPosition [ctfEnemyCount];
+        Vec3 enemyVelocity [ctfEnemyCount];
+        float enemySpeed [ctfEnemyCount];
+        float enemyRadius [ctfEnemyCount];
+    };
+
+
     // ----------------------------------------------------------------------------
     // reset state
 
@@ -233,6 +276,8 @@ namespace {
         gSeeker = this;
         state = running;
         evading = false;
+        clearPathPlan.cancel ();
+        plannedClearPath = false;
     }
 
 
@@ -261,8 +306,8 @@ namespace {
     {
         // randomize position on a ring between inner and outer radii
         // centered around the home base
-        const float rRadius = frandom2 (gMinStartRadius, gMaxStartRadius);
-        const Vec3 randomOnRing = RandomUnitVectorOnXZPlane () * rRadius;
+        const float rRadius = randomStream().frandom2 (gMinStartRadius, gMaxStartRadius);
+        const Vec3 randomOnRing = RandomUnitVectorOnXZPlane (randomStream ()) * rRadius;
         setPosition (gHomeBaseCenter + randomOnRing);
 
         // are we are too close to an obstacle?
@@ -285,6 +330,8 @@ namespace {
 
     void CtfEnemy::update (const float currentTime, const float elapsedTime)
     {
+        PhaseTimer::Scope timer (PhaseTimer::steeringPhase);
+
         // determine upper bound for pursuit prediction time
         const float seekerToGoalDist = Vec3::distance (gHomeBaseCenter,
                                                        gSeeker->position());
@@ -300,7 +347,7 @@ namespace {
         {
             const Vec3 avoidance =
                 steerToAvoidObstacles (gAvoidancePredictTimeMin,
-                                       (ObstacleGroup&) allObstacles);
+                                       obstacleIndex);
 
             // saved for annotation
             avoiding = (avoidance == Vec3::zero);
@@ -348,34 +395,65 @@ namespace {
 
     bool CtfSeeker::clearPathToGoal (void)
     {
-        const float sideThreshold = radius() * 8.0f;
-        const float behindThreshold = radius() * 2.0f;
+        return ClearPathQuery (*this).evaluate (this);
+    }
+
+
+    bool CtfSeeker::plannedClearPathToGoal (void)
+    {
+        clearPathPlan.take (plannedClearPath);
+        if (! clearPathPlan.isPending ())
+            clearPathPlan.submit (ClearPathQuery (*this));
+        return plannedClearPath;
+    }
+
+
+    ClearPathQuery::ClearPathQuery (const CtfSeeker& seeker)
+        : position (seeker.position ()),
+          forward (seeker.forward ()),
+          radius (seeker.radius ()),
+          goalIsAside (seeker.isAside (gHomeBaseCenter, 0.5))
+    {
+        for (int i = 0; i < ctfEnemyCount; i++)
+        {
+            enemyPosition[i] = ctfEnemies[i]->position ();
+            enemyVelocity[i] = ctfEnemies[i]->velocity ();
+            enemySpeed[i] = ctfEnemies[i]->speed ();
+            enemyRadius[i] = ctfEnemies[i]->radius ();
+        }
+    }
 
-        const Vec3 goalOffset = gHomeBaseCenter - position();
+
+    bool ClearPathQuery::evaluate (CtfSeeker* annotating) const
+    {
+        const float sideThreshold = radius * 8.0f;
+        const float behindThreshold = radius * 2.0f;
+
+        const Vec3 goalOffset = gHomeBaseCenter - position;
         const float goalDistance = goalOffset.length ();
         const Vec3 goalDirection = goalOffset / goalDistance;
 
-        const bool goalIsAside = isAside (gHomeBaseCenter, 0.5);
-
         // for annotation: loop over all and save result, instead of early return 
         bool xxxReturn = true;
 
         // loop over enemies
         for (int i = 0; i < ctfEnemyCount; i++)
         {
-            // short name for this enemy
-            const CtfEnemy& e = *ctfEnemies[i];
-            const float eDistance = Vec3::distance (position(), e.position());
-            const float timeEstimate = 0.3f * eDistance / e.speed(); //xxx
-            const Vec3 eFuture = e.predictFuturePosition (timeEstimate);
-            const Vec3 eOffset = eFuture - position();
+            // where this enemy will be
+            const float eDistance = Vec3::distance (position, enemyPosition[i]);
+            const float timeEstimate = 0.3f * eDistance / enemySpeed[i]; //xxx
+            const Vec3 eFuture =
+                enemyPosition[i] + (enemyVelocity[i] * timeEstimate);
+            const Vec3 eOffset = eFuture - position;
             const float alongCorridor = goalDirection.dot (eOffset);
             const bool inCorridor = ((alongCorridor > -behindThreshold) && 
                                      (alongCorridor < goalDistance));
-            const float eForwardDistance = forward().dot (eOffset);
+            const float eForwardDistance = forward.dot (eOffset);
 
             // xxx temp move this up before the conditionals
-            annotationXZCircle (e.radius(), eFuture, clearPathColor, 20); //xxx
+            if (annotating)
+                annotating->annotationXZCircle (enemyRadius[i], eFuture,
+                                                clearPathColor, 20); //xxx
 
             // consider as potential blocker if within the corridor
             if (inCorridor)
@@ -385,7 +463,7 @@ namespace {
                 if (acrossCorridor < sideThreshold)
                 {
                     // not a blocker if behind us and we are perp to corridor
-                    const float eFront = eForwardDistance + e.radius ();
+                    const float eFront = eForwardDistance + enemyRadius[i];
 
                     //annotationLine (position, forward*eFront, gGreen); // xxx
                     //annotationLine (e.position, forward*eFront, gGreen); // xxx
@@ -404,7 +482,10 @@ namespace {
                     if (! safeToTurnTowardsGoal)
                     {
                         // this enemy blocks the path to the goal, so return false
-                        annotationLine (position(), e.position(), clearPathColor);
+                        if (annotating)
+                            annotating->annotationLine (position,
+                                                        enemyPosition[i],
+                                                        clearPathColor);
                         // return false;
                         xxxReturn = false;
                     }
@@ -416,7 +497,9 @@ namespace {
         // clearPathAnnotation (sideThreshold, behindThreshold, goalDirection);
         // return true;
         //if (xxxReturn)
-            clearPathAnnotation (sideThreshold, behindThreshold, goalDirection);
+        if (annotating)
+            annotating->clearPathAnnotation (sideThreshold, behindThreshold,
+                                             goalDirection);
         return xxxReturn;
     }
 
@@ -545,11 +628,13 @@ namespace {
     Vec3 CtfSeeker::steeringForSeeker (void)
     {
         // determine if obstacle avodiance is needed
-        const bool clearPath = clearPathToGoal ();
+        const bool clearPath = (gAsyncPlanning ?
+                                plannedClearPathToGoal () :
+                                clearPathToGoal ());
         adjustObstacleAvoidanceLookAhead (clearPath);
         const Vec3 obstacleAvoidance =
             steerToAvoidObstacles (gAvoidancePredictTime,
-                                   (ObstacleGroup&) allObstacles);
+                                   obstacleIndex);
 
         // saved for annotation
         avoiding = (obstacleAvoidance != Vec3::zero);
@@ -709,6 +794,8 @@ namespace {
 
     void CtfSeeker::update (const float currentTime, const float elapsedTime)
     {
+        PhaseTimer::Scope timer (PhaseTimer::steeringPhase);
+
         // do behavioral state transitions, as needed
         updateState (currentTime);
 
@@ -741,6 +828,7 @@ namespace {
 
     int CtfBase::obstacleCount = -1; // this value means "uninitialized"
     SOG CtfBase::allObstacles;
+    ObstacleIndex CtfBase::obstacleIndex;
 
 
     #define testOneObstacleOverlap(radius, center)               \
@@ -791,6 +879,7 @@ namespace {
             // add new non-overlapping obstacle to registry
             allObstacles.push_back (new SphereObstacle (r, c));
             obstacleCount++;
+            obstacleIndex.build ((ObstacleGroup&) allObstacles);
         }
     }
 
@@ -814,6 +903,7 @@ namespace {
         {
             obstacleCount--;
             allObstacles.pop_back();
+            obstacleIndex.build ((ObstacleGroup&) allObstacles);
         }
     }
 
@@ -940,6 +1030,7 @@ namespace {
             {
             case 1: CtfBase::addOneObstacle ();    break;
             case 2: CtfBase::removeOneObstacle (); break;
+            case 3: gAsyncPlanning = ! gAsyncPlanning; break;
             }
         }
 
@@ -951,6 +1042,7 @@ namespace {
             OpenSteerDemo::printMessage (message);
             OpenSteerDemo::printMessage ("  F1     add one obstacle.");
             OpenSteerDemo::printMessage ("  F2     remove one obstacle.");
+            OpenSteerDemo::printMessage ("  F3     toggle planning off the frame thread.");
             OpenSteerDemo::printMessage ("");
         }
 
@@ -41,7 +41,7 @@
 
 #include <iomanip>
 #include <sstream>
-#include "OpenSteer/SimpleVehicle.h"
+#include "OpenSteer/PlanarVehicle.h"
 #include "OpenSteer/OpenSteerDemo.h"
 #include "OpenSteer/Color.h"
 
@@ -53,7 +53,7 @@ namespace {
     // ----------------------------------------------------------------------------
 
 
-    class LowSpeedTurn : public SimpleVehicle
+    class LowSpeedTurn : public PlanarVehicle
     {
     public:
 
@@ -53,10 +53,20 @@
 #include <iomanip>
 #include <sstream>
 #include <cassert>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
 #include "OpenSteer/OpenSteerDemo.h"
-#include "OpenSteer/SimpleVehicle.h"
+#include "OpenSteer/PlanarVehicle.h"
+#include "OpenSteer/PhaseTimer.h"
 #include "OpenSteer/Color.h"
 #include "OpenSteer/UnusedParameter.h"
+#include "OpenSteer/WorkerPool.h"
+#include "OpenSteer/TiledHeightfield.h"
+#include "OpenSteer/ContentCache.h"
 
 // Include OpenSteer::PolylineSegmentedPathwaySegmentRadii
 #include "OpenSteer/PolylineSegmentedPathwaySegmentRadii.h"
@@ -375,11 +385,51 @@ namespace {
 
 
     #ifdef OLDTERRAINMAP
+    // index of the lowest (highest) set bit, bits must not be zero
+    inline int lowestSetBit (uint64_t bits)
+    {
+    #if defined (__GNUC__)
+        return __builtin_ctzll (bits);
+    #else
+        int n = 0;
+        while (! (bits & 1)) {bits >>= 1; n++;}
+        return n;
+    #endif
+    }
+
+    inline int highestSetBit (uint64_t bits)
+    {
+    #if defined (__GNUC__)
+        return 63 - __builtin_clzll (bits);
+    #else
+        int n = 63;
+        while (! (bits >> 63)) {bits <<= 1; n--;}
+        return n;
+    #endif
+    }
+
+
+    // Binary obstacle map covering a rectangle of the XZ plane with
+    // resolution x resolution cells.  The cells are packed 64 to a word,
+    // row after row, so the run queries (firstSetCellInRow ...) test a
+    // whole word of cells per operation and the scans built on them visit
+    // each map row a segment or rectangle crosses once instead of sampling
+    // every half cell.
+    //
     // class BinaryTerrainMap : public TerrainMap
     class TerrainMap
     {
     public:
 
+        typedef uint64_t Word;
+        enum {wordBits = 64};
+
+        // the map's storage, charged to terrain memory
+        typedef AccountedVector<Word, MemoryAccount::terrainMemory>::type
+            WordVector;
+        typedef AccountedVector<float, MemoryAccount::terrainMemory>::type
+            FloatVector;
+
         // constructor
         TerrainMap (const Vec3& c, float x, float z, int r)
             : center(c),
@@ -387,9 +437,12 @@ namespace {
               zSize(z),
               resolution(r),
               outsideValue (false),
-			  map(resolution * resolution)
+              wordsPerRow ((r + wordBits - 1) / wordBits),
+              xScale ((float) r / x),
+              zScale ((float) r / z),
+              map (wordsPerRow * r, 0),
+              distanceFieldValid (false)
         {
-            map.reserve (resolution * resolution);
         }
 
         // destructor
@@ -400,37 +453,35 @@ namespace {
         // clear the map (to false)
         void clear (void)
         {
-            for (int i = 0; i < resolution; i++)
-                for (int j = 0; j < resolution; j++)
-                    setMapBit (i, j, 0);
+            std::fill (map.begin(), map.end(), 0);
+            distanceFieldValid = false;
         }
 
 
         // get and set a bit based on 2d integer map index
         bool getMapBit (int i, int j) const
         {
-            return map[mapAddress(i, j)];
+            return ((map[wordAddress (i, j)] >> (i % wordBits)) & 1) != 0;
         }
 
         bool setMapBit (int i, int j, bool value)
         {
-            return map[mapAddress(i, j)] = value;
+            const Word bit = Word (1) << (i % wordBits);
+            Word& word = map[wordAddress (i, j)];
+            word = value ? (word | bit) : (word & ~bit);
+            distanceFieldValid = false;
+            return value;
         }
 
 
         // get a value based on a position in 3d world space
         bool getMapValue (const Vec3& point) const
         {
-            const Vec3 local = point - center;
-            const Vec3 localXZ = local.setYtoZero();
-
-            const float hxs = xSize/2;
-            const float hzs = zSize/2;
+            const float u = cellSpaceX (point);
+            const float v = cellSpaceZ (point);
+            const float r = (float) resolution; // prevent VC7.1 warning
 
-            const float x = localXZ.x;
-            const float z = localXZ.z;
-
-            const bool out = (x > +hxs) || (x < -hxs) || (z > +hzs) || (z < -hzs);
+            const bool out = (u > r) || (u < 0) || (v > r) || (v < 0);
 
             if (out) 
             {
@@ -438,11 +489,236 @@ namespace {
             }
             else
             {
-                const float r = (float) resolution; // prevent VC7.1 warning
-                const int i = (int) remapInterval (x, -hxs, hxs, 0.0f, r);
-                const int j = (int) remapInterval (z, -hzs, hzs, 0.0f, r);
-                return getMapBit (i, j);
+                return getMapBit (cellIndex (u), cellIndex (v));
+            }
+        }
+
+
+        // index of the first (last) set cell among cells [begin, end) of
+        // row j, or -1 if they are all clear
+        int firstSetCellInRow (int j, int begin, int end) const
+        {
+            begin = std::max (begin, 0);
+            end = std::min (end, resolution);
+            if (begin >= end) return -1;
+
+            const Word* row = &map[j * wordsPerRow];
+            const int lastWord = (end - 1) / wordBits;
+            int w = begin / wordBits;
+            Word bits = row[w] & (~Word (0) << (begin % wordBits));
+            while (w < lastWord)
+            {
+                if (bits) return w * wordBits + lowestSetBit (bits);
+                bits = row[++w];
             }
+            bits &= endMask (end);
+            return bits ? (w * wordBits + lowestSetBit (bits)) : -1;
+        }
+
+        int lastSetCellInRow (int j, int begin, int end) const
+        {
+            begin = std::max (begin, 0);
+            end = std::min (end, resolution);
+            if (begin >= end) return -1;
+
+            const Word* row = &map[j * wordsPerRow];
+            const int firstWord = begin / wordBits;
+            int w = (end - 1) / wordBits;
+            Word bits = row[w] & endMask (end);
+            while (w > firstWord)
+            {
+                if (bits) return w * wordBits + highestSetBit (bits);
+                bits = row[--w];
+            }
+            bits &= ~Word (0) << (begin % wordBits);
+            return bits ? (w * wordBits + highestSetBit (bits)) : -1;
+        }
+
+        // true if any cell (i, j) with i in [iBegin, iEnd) and j in
+        // [jBegin, jEnd) is set
+        bool anySetInCells (int iBegin, int iEnd, int jBegin, int jEnd) const
+        {
+            jBegin = std::max (jBegin, 0);
+            jEnd = std::min (jEnd, resolution);
+            for (int j = jBegin; j < jEnd; j++)
+            {
+                if (firstSetCellInRow (j, iBegin, iEnd) >= 0) return true;
+            }
+            return false;
+        }
+
+
+        // Marks as obstacles the cells where a heightfield is too steep to
+        // drive: where its height changes by more than maxStep across the
+        // cell.  Reads only the tiles under the map.
+        void markSteepCells (const TiledHeightfield& field, const float maxStep)
+        {
+            const float cellX = 1 / xScale;
+            const float cellZ = 1 / zScale;
+            const float x0 = center.x - (xSize / 2) + (cellX / 2);
+            const float z0 = center.z - (zSize / 2) + (cellZ / 2);
+            for (int j = 0; j < resolution; j++)
+            {
+                for (int i = 0; i < resolution; i++)
+                {
+                    const float x = x0 + i * cellX;
+                    const float z = z0 + j * cellZ;
+                    const float dx = field.heightAt (x + cellX / 2, z) -
+                                     field.heightAt (x - cellX / 2, z);
+                    const float dz = field.heightAt (x, z + cellZ / 2) -
+                                     field.heightAt (x, z - cellZ / 2);
+                    if ((absXXX (dx) > maxStep) || (absXXX (dz) > maxStep))
+                        setMapBit (i, j, true);
+                }
+            }
+        }
+
+
+        // Builds the signed distance field: for each cell the distance (in
+        // world units) from its center to the center of the nearest set
+        // cell, or minus the distance to the nearest clear cell for set
+        // cells.  Any edit of the map drops it until it is built again.
+        void buildDistanceField (void)
+        {
+            const int r = resolution;
+            const float xs = xSize / (float) r;
+            const float zs = zSize / (float) r;
+            std::vector<float> toSet (r * r);
+            std::vector<float> toClear (r * r);
+            for (int j = 0; j < r; j++)
+            {
+                for (int i = 0; i < r; i++)
+                {
+                    const bool set = getMapBit (i, j);
+                    toSet[i + j * r] = set ? 0 : farSquared ();
+                    toClear[i + j * r] = set ? farSquared () : 0;
+                }
+            }
+            squaredDistanceTransform (toSet, xs, zs);
+            squaredDistanceTransform (toClear, xs, zs);
+
+            distanceField.resize (r * r);
+            for (int k = 0; k < r * r; k++)
+            {
+                distanceField[k] = ((toSet[k] == 0) ?
+                                    -sqrtXXX (toClear[k]) :
+                                    sqrtXXX (toSet[k]));
+            }
+            distanceFieldValid = true;
+        }
+
+        bool hasDistanceField (void) const {return distanceFieldValid;}
+
+        // the packed cells and (when valid) the distance field, as stored
+        // by the map cache, and restoring them: false, changing nothing,
+        // unless their sizes are those of this map (the field may be
+        // missing, count 0)
+        const WordVector& cellWords (void) const {return map;}
+        const FloatVector& distances (void) const {return distanceField;}
+        bool restore (const Word* words, const size_t wordCount,
+                      const float* distances, const size_t distanceCount)
+        {
+            const size_t cells = (size_t) resolution * resolution;
+            if ((wordCount != map.size ()) ||
+                ((distanceCount != 0) && (distanceCount != cells)))
+                return false;
+            std::copy (words, words + wordCount, map.begin ());
+            distanceField.assign (distances, distances + distanceCount);
+            distanceFieldValid = (distanceCount != 0);
+            return true;
+        }
+
+        // Distance from a point to the nearest set cell which the distance
+        // field guarantees: its value for the point's cell less the cell
+        // diagonal.  Zero if the map has no distance field.
+        float clearance (const Vec3& point) const
+        {
+            if (! distanceFieldValid) return 0;
+            const float r = (float) resolution;
+            const float u = clip (cellSpaceX (point), 0, r);
+            const float v = clip (cellSpaceZ (point), 0, r);
+            const float d = distanceField[cellIndex (u) + cellIndex (v) * resolution];
+            return maxXXX (0, d - cellDiagonal ());
+        }
+
+
+        // Finds the first point of the line segment from a to b (projected
+        // on the XZ plane) lying in a set cell, or outside the map when
+        // outsideValue is true.  Returns its parameter t in [0, 1] along the
+        // segment, or -1 if there is none.  Walks the rows the segment
+        // crosses in order and searches the run of cells it covers in each.
+        float firstObstacleOnXZSegment (const Vec3& a, const Vec3& b) const
+        {
+            const float ua = cellSpaceX (a);
+            const float va = cellSpaceZ (a);
+            const float du = cellSpaceX (b) - ua;
+            const float dv = cellSpaceZ (b) - va;
+            const float r = (float) resolution;
+
+            // clip the segment to the map
+            float t0 = 0;
+            float t1 = 1;
+            if (! clipToInterval (ua, du, r, t0, t1) ||
+                ! clipToInterval (va, dv, r, t0, t1))
+            {
+                return outsideValue ? 0.0f : -1.0f;
+            }
+            if (outsideValue && (t0 > 0)) return 0;
+
+            // with a distance field, sphere trace through clear space first
+            if (distanceFieldValid)
+            {
+                const float length = sqrtXXX (square (b.x - a.x) +
+                                              square (b.z - a.z));
+                const float minStep = minSpacing () / 2;
+                while (t0 < t1)
+                {
+                    const float c = clearance (a + ((b - a) * t0));
+                    if (c < minStep) break;
+                    t0 += c / length;
+                }
+                if (t0 >= t1)
+                {
+                    return (outsideValue && (t1 < 1)) ? t1 : -1.0f;
+                }
+            }
+
+            const int jFirst = cellIndex (va + dv * t0);
+            const int jLast = cellIndex (va + dv * t1);
+            const int jStep = (jLast < jFirst) ? -1 : 1;
+            for (int j = jFirst; ; j += jStep)
+            {
+                // part of the segment inside row j
+                float lo = t0;
+                float hi = t1;
+                if (dv != 0)
+                {
+                    const float tA = ((float) j - va) / dv;
+                    const float tB = ((float) (j + 1) - va) / dv;
+                    lo = maxXXX (lo, minXXX (tA, tB));
+                    hi = minXXX (hi, maxXXX (tA, tB));
+                }
+
+                if (lo <= hi)
+                {
+                    const int iLo = cellIndex (ua + du * lo);
+                    const int iHi = cellIndex (ua + du * hi);
+                    const int i = ((du >= 0) ?
+                                   firstSetCellInRow (j, iLo, iHi + 1) :
+                                   lastSetCellInRow (j, iHi, iLo + 1));
+                    if (i >= 0)
+                    {
+                        if (i == iLo) return lo;
+                        const float edge = (float) ((du > 0) ? i : i + 1);
+                        return maxXXX (lo, (edge - ua) / du);
+                    }
+                }
+
+                if (j == jLast) break;
+            }
+
+            // leaving the map counts as an obstacle when outsideValue is set
+            return (outsideValue && (t1 < 1)) ? t1 : -1.0f;
         }
 
 
@@ -495,41 +771,87 @@ namespace {
             return minXXX (xSize, zSize) / (float)resolution;
         }
 
-        // used to detect if vehicle body is on any obstacles
+        // used to detect if vehicle body is on any obstacles: tests the cells
+        // under the rectangle row by row
         bool scanLocalXZRectangle (const AbstractLocalSpace& localSpace,
                                    float xMin, float xMax,
                                    float zMin, float zMax) const
         {
-            const float spacing = minSpacing() / 2;
+            const Vec3 local[4] = {Vec3 (xMin, 0, zMin), Vec3 (xMax, 0, zMin),
+                                   Vec3 (xMax, 0, zMax), Vec3 (xMin, 0, zMax)};
+            const float r = (float) resolution;
+            float u[4], v[4];
+            float vMin = r;
+            float vMax = 0;
+            for (int k = 0; k < 4; k++)
+            {
+                const Vec3 global = localSpace.globalizePosition (local[k]);
+                u[k] = cellSpaceX (global);
+                v[k] = cellSpaceZ (global);
+                const bool out = (u[k] > r) || (u[k] < 0) || (v[k] > r) || (v[k] < 0);
+                if (out && outsideValue) return true;
+                vMin = minXXX (vMin, v[k]);
+                vMax = maxXXX (vMax, v[k]);
+            }
+            if ((vMax < 0) || (vMin > r)) return false;
 
-            for (float x = xMin; x < xMax; x += spacing)
+            const int jFirst = cellIndex (maxXXX (vMin, 0));
+            const int jLast = cellIndex (minXXX (vMax, r));
+            for (int j = jFirst; j <= jLast; j++)
             {
-                for (float z = zMin; z < zMax; z += spacing)
+                // extent along the row of the part of each edge inside row j
+                const float rowMin = (float) j;
+                const float rowMax = (float) (j + 1);
+                float uMin = r;
+                float uMax = 0;
+                for (int k = 0; k < 4; k++)
                 {
-                    const Vec3 sample (x, 0, z);
-                    const Vec3 global = localSpace.globalizePosition (sample);
-                    if (getMapValue (global)) return true;
+                    const int n = (k + 1) % 4;
+                    float t0 = 0;
+                    float t1 = 1;
+                    const float dv = v[n] - v[k];
+                    if (dv == 0)
+                    {
+                        if ((v[k] < rowMin) || (v[k] > rowMax)) continue;
+                    }
+                    else
+                    {
+                        const float tA = (rowMin - v[k]) / dv;
+                        const float tB = (rowMax - v[k]) / dv;
+                        t0 = maxXXX (t0, minXXX (tA, tB));
+                        t1 = minXXX (t1, maxXXX (tA, tB));
+                        if (t0 > t1) continue;
+                    }
+                    const float du = u[n] - u[k];
+                    uMin = minXXX (uMin, minXXX (u[k] + du * t0, u[k] + du * t1));
+                    uMax = maxXXX (uMax, maxXXX (u[k] + du * t0, u[k] + du * t1));
                 }
+                if ((uMin > uMax) || (uMax < 0) || (uMin > r)) continue;
+
+                const int iFirst = cellIndex (maxXXX (uMin, 0));
+                const int iLast = cellIndex (minXXX (uMax, r));
+                if (firstSetCellInRow (j, iFirst, iLast + 1) >= 0) return true;
             }
             return false;
         }
 
-        // Scans along a ray (directed line segment) on the XZ plane, sampling
-        // the map for a "true" cell.  Returns the index of the first sample
-        // that gets a "hit", or zero if no hits found.
+        // Scans along a ray (directed line segment) on the XZ plane, 
+        // sampleCount steps of sampleSpacing long, for a "true" cell.  
+        // Returns the index of the first step ending at or beyond the first
+        // hit, or zero if no hits found.
         int scanXZray (const Vec3& origin,
                        const Vec3& sampleSpacing,
                        const int sampleCount) const
         {
-            Vec3 samplePoint (origin);
+            if (sampleCount <= 0) return 0;
 
-            for (int i = 1; i <= sampleCount; i++)
-            {
-                samplePoint += sampleSpacing;
-                if (getMapValue (samplePoint)) return i;
-            }
+            const float count = (float) sampleCount;
+            const float t = firstObstacleOnXZSegment (origin,
+                                                      origin + (sampleSpacing * count));
+            if (t < 0) return 0;
 
-            return 0;
+            const int i = (int) ceilf (t * count);
+            return std::min (std::max (i, 1), sampleCount);
         }
 
 
@@ -547,9 +869,124 @@ namespace {
 
     private:
 
-        int mapAddress (int i, int j) const {return i + (j * resolution);}
+        int wordAddress (int i, int j) const
+        {
+            return (i / wordBits) + (j * wordsPerRow);
+        }
+
+        // mask of the cells below end in the word holding cell end - 1
+        static Word endMask (int end)
+        {
+            const int bits = end - (((end - 1) / wordBits) * wordBits);
+            return (bits == wordBits) ? ~Word (0) : ((Word (1) << bits) - 1);
+        }
+
+        // position in units of cells from the map's -x (-z) edge
+        float cellSpaceX (const Vec3& point) const
+        {
+            return (point.x - center.x + (xSize / 2)) * xScale;
+        }
+
+        float cellSpaceZ (const Vec3& point) const
+        {
+            return (point.z - center.z + (zSize / 2)) * zScale;
+        }
+
+        // cell containing a cell space coordinate in [0, resolution]
+        int cellIndex (float c) const
+        {
+            const int i = (int) c;
+            return (i < resolution) ? i : resolution - 1;
+        }
+
+        float cellDiagonal (void) const
+        {
+            return sqrtXXX (square (xSize) + square (zSize)) / (float) resolution;
+        }
+
+        // stands in for an infinite squared distance
+        static float farSquared (void) {return 1e20f;}
+
+        // Exact squared Euclidean distance transform (Felzenszwalb &
+        // Huttenlocher) of a resolution x resolution grid with cell spacing
+        // xs by zs, in place: a pass along the rows, then one along the
+        // columns.
+        void squaredDistanceTransform (std::vector<float>& f,
+                                       float xs, float zs) const
+        {
+            const int r = resolution;
+            std::vector<float> line (r);
+            for (int j = 0; j < r; j++)
+            {
+                for (int i = 0; i < r; i++) line[i] = f[i + j * r];
+                squaredDistanceTransform1D (line, xs * xs);
+                for (int i = 0; i < r; i++) f[i + j * r] = line[i];
+            }
+            for (int i = 0; i < r; i++)
+            {
+                for (int j = 0; j < r; j++) line[j] = f[i + j * r];
+                squaredDistanceTransform1D (line, zs * zs);
+                for (int j = 0; j < r; j++) f[i + j * r] = line[j];
+            }
+        }
 
-        std::vector<bool> map;
+        // lower envelope of the parabolas spacing2 * (q - p)^2 + f[p]
+        static void squaredDistanceTransform1D (std::vector<float>& f,
+                                                float spacing2)
+        {
+            const int n = (int) f.size();
+            std::vector<float> d (n);
+            std::vector<int> v (n);
+            std::vector<float> z (n + 1);
+            int k = 0;
+            v[0] = 0;
+            z[0] = -farSquared ();
+            z[1] = farSquared ();
+            for (int q = 1; q < n; q++)
+            {
+                float s;
+                while (true)
+                {
+                    const int p = v[k];
+                    s = (((f[q] + spacing2 * q * q) - (f[p] + spacing2 * p * p))
+                         / (2 * spacing2 * (q - p)));
+                    if ((s > z[k]) || (k == 0)) break;
+                    k--;
+                }
+                if (s <= z[k]) {v[0] = q; z[0] = -farSquared ();}
+                else {k++; v[k] = q; z[k] = s;}
+                z[k + 1] = farSquared ();
+            }
+            k = 0;
+            for (int q = 0; q < n; q++)
+            {
+                while (z[k + 1] < q) k++;
+                const float dq = (float) (q - v[k]);
+                d[q] = spacing2 * dq * dq + f[v[k]];
+            }
+            f.swap (d);
+        }
+
+        // Liang-Barsky clip of the line c + dc * t to [0, r], narrowing the 
+        // parameter range [t0, t1].  Returns false if nothing is left.
+        static bool clipToInterval (float c, float dc, float r,
+                                    float& t0, float& t1)
+        {
+            if (dc == 0) return (c >= 0) && (c <= r);
+            const float tA = (0 - c) / dc;
+            const float tB = (r - c) / dc;
+            t0 = maxXXX (t0, minXXX (tA, tB));
+            t1 = minXXX (t1, maxXXX (tA, tB));
+            return t0 <= t1;
+        }
+
+        int wordsPerRow;
+        float xScale;
+        float zScale;
+        WordVector map;
+
+        FloatVector distanceField;
+        bool distanceFieldValid;
     };
     #endif
 
@@ -739,15 +1176,415 @@ namespace {
 
 
 
+    // ----------------------------------------------------------------------------
+    // The terrain MapDrivers drive on: the obstacle map and the route.  The
+    // PlugIn edits it between frames (regenerate), drivers only read it, so
+    // any number of them can share one world and update concurrently.
+    //
+    // When the environment variable OPENSTEER_TERRAIN names a tiled
+    // heightfield file (see TiledHeightfield.h) it is memory mapped, and its
+    // cells too steep to drive become obstacles in place of the random
+    // rocks.  Only the tiles under the map are read, and they are released
+    // again once the map is built if they exceed the field's memory budget.
+    //
+    // When the environment variable OPENSTEER_MAP_CACHE names a directory,
+    // each regenerated map (its cells and distance field), the route's
+    // segment radii and the random stream left over by the generation are
+    // stored there (see ContentCache.h), keyed by everything regeneration
+    // depends on: the demo settings, the map's size, the random stream,
+    // the current radii and the heightfield file's identity.  A later
+    // regeneration of the same key, in this or another run, maps the file
+    // instead, so batch runs which reset often skip regeneration and
+    // continue exactly as if they had regenerated.
+
+
+    class MapDriveWorld
+    {
+    public:
+
+        // constructor
+        MapDriveWorld (const float worldSize)
+            : map (makeMap (worldSize)),
+              path (makePath (worldSize)),
+              maxTerrainStep (1),
+              terrainFile (getenv ("OPENSTEER_TERRAIN")),
+              cache (ContentCache::fromEnvironment ("OPENSTEER_MAP_CACHE")),
+              cacheHits (0)
+        {
+            if (terrainFile != NULL) terrain.open (terrainFile);
+        }
+
+        // destructor
+        ~MapDriveWorld ()
+        {
+            delete (map);
+            delete (path);
+        }
+
+
+        // random utility, worth moving to Utilities.h?
+        static int irandom2 (int min, int max)
+        {
+            return (int) frandom2 ((float) min, (float) max);
+        }
+
+        // regenerate map for the given demo mode: clear and add random
+        // "rocks", fences and (for path following) new path widths, or
+        // load the result of the same regeneration from the map cache
+        void regenerate (const int demoSelect,
+                         const int pathFollowDirection,
+                         const bool useRandomRocks,
+                         const bool usePathFences,
+                         const bool useDistanceField)
+        {
+            ContentKey key;
+            if (cache.isEnabled ())
+            {
+                makeCacheKey (key, demoSelect, pathFollowDirection,
+                              useRandomRocks, usePathFences, useDistanceField);
+                if (loadFromCache (key)) return;
+            }
+
+            generate (demoSelect, pathFollowDirection,
+                      useRandomRocks, usePathFences, useDistanceField);
+
+            if (cache.isEnabled ()) storeInCache (key);
+        }
+
+        // whether there is a map cache, and the number of regenerations
+        // loaded from it so far
+        bool cacheIsEnabled (void) const {return cache.isEnabled ();}
+        int cacheHitCount (void) const {return cacheHits;}
+
+        void generate (const int demoSelect,
+                       const int pathFollowDirection,
+                       const bool useRandomRocks,
+                       const bool usePathFences,
+                       const bool useDistanceField)
+        {
+            // regenerate map: clear and add random "rocks" (or the steep
+            // parts of the terrain)
+            map->clear();
+            if (terrain.isOpen ())
+            {
+                map->markSteepCells (terrain, maxTerrainStep);
+                terrain.evictColdTiles ();
+            }
+            else if (useRandomRocks) drawRandomClumpsOfRocksOnMap (*map);
+            clearCenterOfMap (*map);
+
+            // draw fences for first two demo modes
+            if (demoSelect < 2) drawBoundaryFencesOnMap (*map);
+
+            // randomize path widths
+            if (demoSelect == 2)
+            {
+                const OpenSteer::size_t count = path->segmentCount();
+                const bool upstream = pathFollowDirection > 0;
+                const OpenSteer::size_t entryIndex = upstream ? 0 : count-1;
+                const OpenSteer::size_t exitIndex  = upstream ? count-1 : 0;
+                const float lastExitRadius = path->segmentRadius( exitIndex );
+                for (OpenSteer::size_t i = 0; i < count; i++)
+                {
+                    path->setSegmentRadius( i, frandom2 (4, 19) );
+                }
+                path->setSegmentRadius( entryIndex, lastExitRadius );
+            }
+
+            // mark path-boundary map cells as obstacles
+            // (when in path following demo and appropriate mode is set)
+            if (usePathFences && (demoSelect == 2))
+                drawPathFencesOnMap (*map, *path);
+
+            // the map is static until the next regeneration
+            if (useDistanceField) map->buildDistanceField ();
+        }
+
+        static void drawRandomClumpsOfRocksOnMap (TerrainMap& map)
+        {
+            const int spread = 4;
+            const int r = map.cellwidth();
+            const int k = irandom2 (50, 150);
+
+            for (int p=0; p<k; p++)
+            {
+                const int i = irandom2 (0, r - spread);
+                const int j = irandom2 (0, r - spread);
+                const int c = irandom2 (0, 10);
+
+                for (int q=0; q<c; q++)
+                {
+                    const int m = irandom2 (0, spread);
+                    const int n = irandom2 (0, spread);
+    #ifdef OLDTERRAINMAP
+                    map.setMapBit (i+m, j+n, 1);
+    #else
+                    map.setType (i+m, j+n, CellData::OBSTACLE);
+    #endif
+                }
+            }
+        }
+
+
+        static void drawBoundaryFencesOnMap (TerrainMap& map)
+        {
+            // QQQ it would make more sense to do this with a "draw line
+            // QQQ on map" primitive, may need that for other things too
+
+            const int cw = map.cellwidth();
+            const int ch = map.cellheight();
+
+            const int r = cw - 1;
+            const int a = cw >> 3;
+            const int b = cw - a;
+            const int o = cw >> 4;
+            const int p = (cw - o) >> 1;
+            const int q = (cw + o) >> 1;
+
+            for (int i = 0; i < cw; i++)
+            {
+                for (int j = 0; j < ch; j++)
+                {
+                    const bool c = i>a && i<b && (i<p || i>q);
+                    if (i==0 || j==0 || i==r || j==r || (c && (i==j || i+j==r))) 
+    #ifdef OLDTERRAINMAP
+                        map.setMapBit (i, j, 1);
+    #else
+                        map.setType (i, j, CellData::IMPASSABLE);
+    #endif
+                }
+            }
+        }
+
+
+        static void clearCenterOfMap (TerrainMap& map)
+        {
+            const int o = map.cellwidth() >> 4;
+            const int p = (map.cellwidth() - o) >> 1;
+            const int q = (map.cellwidth() + o) >> 1;
+            for (int i = p; i <= q; i++)
+                for (int j = p; j <= q; j++)
+    #ifdef OLDTERRAINMAP
+                    map.setMapBit (i, j, 0);
+    #else
+                    map.setType (i, j, CellData::CLEAR);
+    #endif
+        }
+
+
+        static void drawPathFencesOnMap (TerrainMap& map, const GCRoute& path)
+        {
+    #ifdef OLDTERRAINMAP
+            const float xs = map.xSize / (float)map.resolution;
+            const float zs = map.zSize / (float)map.resolution;
+            const Vec3 alongRow (xs, 0, 0);
+            const Vec3 nextRow (-map.xSize, 0, zs);
+            Vec3 g ((map.xSize - xs) / -2, 0, (map.zSize - zs) / -2);
+            for (int j = 0; j < map.resolution; j++)
+            {
+                for (int i = 0; i < map.resolution; i++)
+                {
+                    const float outside = mapPointToOutside( path, g ); // path.howFarOutsidePath (g);
+                    const float wallThickness = 1.0f;
+
+                    // set map cells adjacent to the outside edge of the path
+                    if ((outside > 0) && (outside < wallThickness))
+                        map.setMapBit (i, j, true);
+
+                    // clear all other off-path map cells 
+                    if (outside > wallThickness) map.setMapBit (i, j, false);
+
+                    g += alongRow;
+                }
+                g += nextRow;
+            }
+    #else
+    #endif
+        }
+
+
+        static GCRoute* makePath (const float worldSize)
+        {
+            // a few constants based on world size
+            const float m = worldSize * 0.4f; // main diamond size
+            const float n = worldSize / 8;    // notch size
+            const float o = worldSize * 2;    // outside of the sand
+
+            // construction vectors
+            const Vec3 p (0,   0, m);
+            const Vec3 q (0,   0, m-n);
+            const Vec3 r (-m,  0, 0);
+            const Vec3 s (2*n, 0, 0);
+            const Vec3 t (o,   0, 0);
+            const Vec3 u (-o,  0, 0);
+            const Vec3 v (n,   0, 0);
+            const Vec3 w (0, 0, 0);
+
+
+            // path vertices
+            const Vec3 a (t-p);
+            const Vec3 b (s+v-p);
+            const Vec3 c (s-q);
+            const Vec3 d (s+q);
+            const Vec3 e (s-v+p);
+            const Vec3 f (p-w);
+            const Vec3 g (r-w);
+            const Vec3 h (-p-w);
+            const Vec3 i (u-p);
+
+            // return Path object
+            const int pathPointCount = 9;
+            const Vec3 pathPoints[pathPointCount] = {a, b, c, d, e, f, g, h, i};
+            const float k = 10.0f;
+            const float pathRadii[pathPointCount] = {k, k, k, k, k, k, k, k, k};
+            return new GCRoute (pathPointCount, pathPoints, pathRadii, false);
+        }
+
+
+        static TerrainMap* makeMap (const float worldSize)
+        {
+    #ifdef OLDTERRAINMAP
+            return new TerrainMap (Vec3::zero,
+                                   worldSize,
+                                   worldSize,
+                                   (int)worldSize + 1);
+    #else
+            return new TerrainMap (worldSize, worldSize, 1);
+    #endif
+        }
+
+
+        TerrainMap* map;
+        GCRoute* path;
+
+        // optional heightfield the map's obstacles come from, and the
+        // height change across a map cell too steep to drive
+        TiledHeightfield terrain;
+        float maxTerrainStep;
+
+    private:
+
+        // the inputs of a regeneration: its settings and the map's geometry
+        // (plain data, cleared before it is filled in so its bytes are
+        // all defined), then the random stream it starts from, the route's
+        // current radii (the path following demo keeps the last exit
+        // radius) and the terrain
+        struct CacheKeyRecord
+        {
+            uint32_t format;
+            int demoSelect;
+            int pathFollowDirection;
+            int useRandomRocks;
+            int usePathFences;
+            int useDistanceField;
+            int resolution;
+            float xSize;
+            float zSize;
+            float maxTerrainStep;
+        };
+
+        void makeCacheKey (ContentKey& key,
+                           const int demoSelect,
+                           const int pathFollowDirection,
+                           const bool useRandomRocks,
+                           const bool usePathFences,
+                           const bool useDistanceField) const
+        {
+            CacheKeyRecord record;
+            memset (&record, 0, sizeof (record));
+            record.format = 1;
+            record.demoSelect = demoSelect;
+            record.pathFollowDirection = pathFollowDirection;
+            record.useRandomRocks = useRandomRocks;
+            record.usePathFences = usePathFences;
+            record.useDistanceField = useDistanceField;
+            record.resolution = map->resolution;
+            record.xSize = map->xSize;
+            record.zSize = map->zSize;
+            record.maxTerrainStep = maxTerrainStep;
+            key.add (record);
+            key.add (defaultRandomStream ());
+
+            std::vector<float> radii (path->segmentCount ());
+            for (OpenSteer::size_t i = 0; i < radii.size (); i++)
+                radii[i] = path->segmentRadius (i);
+            key.addArray (radii.empty () ? 0 : &radii[0], radii.size ());
+
+            key.addFileIdentity (terrain.isOpen () ? terrainFile : "");
+        }
+
+        // the sections of a map cache file
+        static CheckpointTag cellsTag (void) {return checkpointTag ("MAPC");}
+        static CheckpointTag distancesTag (void) {return checkpointTag ("MAPD");}
+        static CheckpointTag radiiTag (void) {return checkpointTag ("RADI");}
+        static CheckpointTag randomTag (void) {return checkpointTag ("RAND");}
+
+        bool loadFromCache (const ContentKey& key)
+        {
+            CheckpointReader reader;
+            if (! cache.load ("mapdrive", key, reader)) return false;
+
+            size_t cellCount, distanceCount, radiusCount;
+            const TerrainMap::Word* cells =
+                reader.array<TerrainMap::Word> (cellsTag (), cellCount);
+            const float* distances =
+                reader.array<float> (distancesTag (), distanceCount);
+            const float* radii = reader.array<float> (radiiTag (), radiusCount);
+            RandomStream random;
+            if ((cells == 0) ||
+                (radiusCount != path->segmentCount ()) ||
+                ! reader.record (randomTag (), random) ||
+                ! map->restore (cells, cellCount, distances, distanceCount))
+                return false;
+
+            for (OpenSteer::size_t i = 0; i < radiusCount; i++)
+                path->setSegmentRadius (i, radii[i]);
+            defaultRandomStream () = random;
+            cacheHits++;
+            return true;
+        }
+
+        void storeInCache (const ContentKey& key) const
+        {
+            CheckpointWriter writer ("MapDrive map cache", 0);
+            const TerrainMap::WordVector& cells = map->cellWords ();
+            writer.addArray (cellsTag (), &cells[0], cells.size ());
+            if (map->hasDistanceField ())
+            {
+                const TerrainMap::FloatVector& distances = map->distances ();
+                writer.addArray (distancesTag (), &distances[0],
+                                 distances.size ());
+            }
+            std::vector<float> radii (path->segmentCount ());
+            for (OpenSteer::size_t i = 0; i < radii.size (); i++)
+                radii[i] = path->segmentRadius (i);
+            writer.addArray (radiiTag (), radii.empty () ? 0 : &radii[0],
+                             radii.size ());
+            writer.addRecord (randomTag (), defaultRandomStream ());
+            cache.store ("mapdrive", key, writer);
+        }
+
+        // the heightfield file (if any), the map cache and its use
+        const char* terrainFile;
+        ContentCache cache;
+        int cacheHits;
+
+        // not copyable
+        MapDriveWorld (const MapDriveWorld&);
+        MapDriveWorld& operator= (const MapDriveWorld&);
+    };
+
+
     // ----------------------------------------------------------------------------
 
 
-    class MapDriver : public SimpleVehicle
+    class MapDriver : public PlanarVehicle
     {
     public:
 
         // constructor
-        MapDriver () : map (makeMap ()), path (makePath ())
+        MapDriver (const MapDriveWorld& world)
+            : map (world.map), path (world.path), reportCollisions (true)
         {
             reset ();
 
@@ -775,6 +1612,7 @@ namespace {
             lapsFinished = 0;
             hintGivenCount = 0;
             hintTakenCount = 0;
+            savedNearestWR = savedNearestR = savedNearestL = savedNearestWL = 0;
 
             // follow the path "upstream or downstream" (+1/-1)
             pathFollowDirection = 1;
@@ -790,8 +1628,6 @@ namespace {
         // destructor
         ~MapDriver ()
         {
-            delete (map);
-            delete (path);
         }
 
         // reset state
@@ -861,6 +1697,15 @@ namespace {
 
         // per frame simulation update
         void update (const float currentTime, const float elapsedTime)
+        {
+            PhaseTimer::Scope timer (PhaseTimer::steeringPhase);
+            simulate (currentTime, elapsedTime);
+        }
+
+        // the update without the phase timer, which is not thread safe.
+        // Reads only the shared world, so drivers sharing one world can be
+        // simulated concurrently (with annotation off).
+        void simulate (const float currentTime, const float elapsedTime)
         {
             // take note when current dt is zero (as in paused) for stat counters
             dtZero = (elapsedTime == 0);
@@ -1031,9 +1876,12 @@ namespace {
                 !collisionLastTime &&
                 (timeSinceLastCollision > 1))
             {
-                std::ostringstream message;
-                message << "collision after "<<timeSinceLastCollision<<" seconds";
-                OpenSteerDemo::printMessage (message);
+                if (reportCollisions)
+                {
+                    std::ostringstream message;
+                    message << "collision after "<<timeSinceLastCollision<<" seconds";
+                    OpenSteerDemo::printMessage (message);
+                }
                 sumOfCollisionFreeTimes += timeSinceLastCollision;
                 countOfCollisionFreeTimes++;
                 timeOfLastCollision = currentTime;
@@ -1196,6 +2044,48 @@ namespace {
             // assert loops will terminate
         assert (spacing > 0);
 
+            // see duplicated code at: QQQ draw sensing "wings"
+            // QQQ should be a parameter of this method
+            const int wingScans = 4;
+            const Vec3 wingWidth = side() * wingSlope () * maxForward;
+            const Color beforeColor (0.75f, 0.9f, 0.0f);  // for annotation
+            const Color afterColor  (0.9f,  0.5f, 0.0f);  // for annotation
+
+            // for curved steering scan the whole fan of arcs, corridor pairs
+            // then wing pairs, at once, the loops below read the results
+            std::vector<ArcScan>& arcs = arcScans;
+            arcs.clear ();
+            if (curvedSteering)
+            {
+                Vec3 wingOffset;
+                for (float w = s; w < maxSide; w += spacing)
+                {
+                    wingOffset = side() * w;
+                    arcs.push_back (ArcScan (fOffset + wingOffset, arcAngle,
+                                             maxSamples, 0, gYellow, gRed));
+                    arcs.push_back (ArcScan (fOffset - wingOffset, arcAngle,
+                                             maxSamples, 0, gYellow, gRed));
+                }
+                for (int i=1; i<=wingScans; i++)
+                {
+                    for (int j = -1; j < 2; j+=2)
+                    {
+                        Vec3 start, step;
+                        int raySamples;
+                        float endRadius;
+                        wingScan (i, j, wingScans, fOffset, wingOffset,
+                                  wingWidth, maxForward, spacing, signedRadius,
+                                  start, step, raySamples, endRadius);
+                        arcs.push_back (ArcScan (start, arcAngle, raySamples,
+                                                 endRadius,
+                                                 beforeColor, afterColor));
+                    }
+                }
+                if (! arcs.empty ())
+                    scanObstacleMapArcs (&arcs[0], (int) arcs.size(), center);
+            }
+            int nextArc = 0;
+
             // scan corridor straight ahead of vehicle,
             // keep track of nearest obstacle on left and right sides
             while (s < maxSide)
@@ -1206,27 +2096,18 @@ namespace {
                 const Vec3 rOffset = fOffset - sOffset;
 
                 Vec3 lObsPos, rObsPos;
+                if (curvedSteering)
+                {
+                    lObsPos = arcs[nextArc].obstaclePosition;
+                    rObsPos = arcs[nextArc + 1].obstaclePosition;
+                }
 
                 const int L = (curvedSteering ? 
-                               (int) (scanObstacleMap (lOffset,
-                                                       center,
-                                                       arcAngle,
-                                                       maxSamples,
-                                                       0,
-                                                       gYellow,
-                                                       gRed,
-                                                       lObsPos)
+                               (int) (arcs[nextArc++].obstacleDistance
                                       / spacing) :
                                map.scanXZray (lOffset, step, maxSamples));
                 const int R = (curvedSteering ? 
-                               (int) (scanObstacleMap (rOffset,
-                                                        center,
-                                                       arcAngle,
-                                                       maxSamples,
-                                                       0,
-                                                       gYellow,
-                                                       gRed,
-                                                       rObsPos)
+                               (int) (arcs[nextArc++].obstacleDistance
                                       / spacing) :
                                map.scanXZray (rOffset, step, maxSamples));
 
@@ -1263,43 +2144,19 @@ namespace {
 
             // scan "wings"
             {
-                const int wingScans = 4;
-                // see duplicated code at: QQQ draw sensing "wings"
-                // QQQ should be a parameter of this method
-                const Vec3 wingWidth = side() * wingSlope () * maxForward;
-
-                const Color beforeColor (0.75f, 0.9f, 0.0f);  // for annotation
-                const Color afterColor  (0.9f,  0.5f, 0.0f);  // for annotation
-
                 for (int i=1; i<=wingScans; i++)
                 {
-                    const float fraction = (float)i / (float)wingScans;
-                    const Vec3 endside = sOffset + (wingWidth * fraction);
-                    const Vec3 corridorFront = forward() * maxForward;
-
                     // "loop" from -1 to 1
                     for (int j = -1; j < 2; j+=2)
                     {
-                        float k = (float)j; // prevent VC7.1 warning
-                        const Vec3 start = fOffset + (sOffset * k);
-                        const Vec3 end = fOffset + corridorFront + (endside * k);
-                        const Vec3 ray = end - start;
-                        const float rayLength = ray.length();
-                        const Vec3 step = ray * spacing / rayLength;
-                        const int raySamples = (int) (rayLength / spacing);
-                        const float endRadius =
-                            wingSlope () * maxForward * fraction *
-                            (signedRadius < 0 ? 1 : -1) * (j==1?1:-1);
-                        Vec3 ignore;
+                        Vec3 start, step;
+                        int raySamples;
+                        float endRadius;
+                        wingScan (i, j, wingScans, fOffset, sOffset,
+                                  wingWidth, maxForward, spacing, signedRadius,
+                                  start, step, raySamples, endRadius);
                         const int scan = (curvedSteering ?
-                                          (int) (scanObstacleMap (start,
-                                                                  center,
-                                                                  arcAngle,
-                                                                  raySamples,
-                                                                  endRadius,
-                                                                  beforeColor,
-                                                                  afterColor,
-                                                                  ignore)
+                                          (int) (arcs[nextArc++].obstacleDistance
                                                  / spacing) :
                                           map.scanXZray (start, step, raySamples));
 
@@ -1514,69 +2371,196 @@ namespace {
                                const Color& beforeColor,
                                const Color& afterColor,
                                Vec3& returnObstaclePosition)
+        {
+            ArcScan scan (start, arcAngle, segments, endRadiusChange,
+                          beforeColor, afterColor);
+            scanObstacleMapArcs (&scan, 1, center);
+            returnObstaclePosition = scan.obstaclePosition;
+            return scan.obstacleDistance;
+        }
+
+
+        // one arc of a fan scanned by scanObstacleMapArcs, the arguments
+        // of scanObstacleMap and its results
+        class ArcScan
+        {
+        public:
+            ArcScan (const Vec3& s, float a, int n, float e,
+                     const Color& before, const Color& after)
+                : start (s), arcAngle (a), segments (n), endRadiusChange (e),
+                  beforeColor (before), afterColor (after),
+                  obstacleDistance (0), obstaclePosition (Vec3::zero),
+                  obstacleSegment (n)
+            {}
+
+            Vec3 start;
+            float arcAngle;
+            int segments;
+            float endRadiusChange;
+            Color beforeColor;
+            Color afterColor;
+
+            // distance to, and position of first obstacle (zero if none
+            // found) and the segment it was found on (segments if none)
+            float obstacleDistance;
+            Vec3 obstaclePosition;
+            int obstacleSegment;
+        };
+
+        // use threads for fans of at least this many arcs
+        static const int minParallelArcCount = 32;
+
+        // Scans a fan of arcs around a common center, as scanObstacleMap
+        // does for one.  The scans of wide fans are spread across the
+        // shared worker pool, the annotation is drawn afterwards.
+        void scanObstacleMapArcs (ArcScan arcs[],
+                                  const int count,
+                                  const Vec3& center)
+        {
+            if (count >= minParallelArcCount)
+            {
+                ScanArcs scanArcs (*this, arcs, center);
+                WorkerPool::shared().parallelFor (count, scanArcs);
+            }
+            else
+            {
+                for (int k = 0; k < count; k++) scanArc (arcs[k], center);
+            }
+
+            if (annotationIsOn ())
+            {
+                for (int k = 0; k < count; k++) annotateArcScan (arcs[k], center);
+            }
+        }
+
+        // parallelFor body scanning a range of a fan's arcs
+        class ScanArcs
+        {
+        public:
+            ScanArcs (const MapDriver& d, ArcScan* a, const Vec3& c)
+                : driver (d), arcs (a), center (c) {}
+            void operator() (size_t begin, size_t end) const
+            {
+                for (size_t k = begin; k < end; k++)
+                    driver.scanArc (arcs[k], center);
+            }
+        private:
+            const MapDriver& driver;
+            ArcScan* arcs;
+            const Vec3& center;
+        };
+
+        // scale of the spoke after segment i for spiral "ramps" of changing
+        // radius
+        static float rampAdjust (const ArcScan& arc,
+                                 const int i,
+                                 const float startRadius)
+        {
+            return ((arc.endRadiusChange == 0) ?
+                    1.0f :
+                    interpolate ((float)(i+1) / (float)arc.segments,
+                                 1.0f,
+                                 (maxXXX (0,
+                                          (startRadius +
+                                           arc.endRadiusChange))
+                                  / startRadius)));
+        }
+
+        // scan the chords of one arc up to the first obstacle, without
+        // annotation so fans can be scanned in parallel
+        void scanArc (ArcScan& arc, const Vec3& center) const
         {
             // "spoke" is initially the vector from center to start,
             // which is then rotated step by step around center
-            Vec3 spoke = start - center;
+            Vec3 spoke = arc.start - center;
             // determine the angular step per segment
-            const float step = arcAngle / segments;
-            // store distance to, and position of first obstacle
-            float obstacleDistance = 0;
-            returnObstaclePosition = Vec3::zero;
+            const float step = arc.arcAngle / arc.segments;
             // for spiral "ramps" of changing radius
-            const float startRadius = (endRadiusChange == 0) ? 0 : spoke.length(); 
+            const float startRadius = ((arc.endRadiusChange == 0) ?
+                                       0 :
+                                       spoke.length());
 
             // traverse each segment along arc
             float sin=0, cos=0;
-            Vec3 oldPoint = start;
-            bool obstacleFound = false;
-            for (int i = 0; i < segments; i++)
+            Vec3 oldPoint = arc.start;
+            for (int i = 0; i < arc.segments; i++)
             {
                 // rotate "spoke" to next step around circle
                 // (sin and cos values get filled in on first call)
                 spoke = spoke.rotateAboutGlobalY (step, sin, cos);
 
-                // for spiral "ramps" of changing radius
-                const float adjust = ((endRadiusChange == 0) ?
-                                      1.0f :
-                                      interpolate ((float)(i+1) / (float)segments,
-                                                   1.0f,
-                                                   (maxXXX (0,
-                                                            (startRadius +
-                                                             endRadiusChange))
-                                                    / startRadius)));
-
                 // construct new scan point: center point, offset by rotated
                 // spoke (possibly adjusting the radius if endRadiusChange!=0)
-                const Vec3 newPoint = center + (spoke * adjust);
+                const Vec3 newPoint = center + (spoke *
+                                                rampAdjust (arc, i, startRadius));
 
-                // once an obstacle if found "our work here is done" -- continue
-                // to loop only for the sake of annotation (make that optional?)
-                if (obstacleFound)
-                {
-                    annotationLine (oldPoint, newPoint, afterColor);
-                }
-                else
-                {
-                    // no obstacle found on this scan so far,
-                    // scan map along current segment (a chord of the arc)
-                    const Vec3 offset = newPoint - oldPoint;
-                    const float d2 = offset.length() * 2;
+                // scan map along current segment (a chord of the arc)
+                const Vec3 offset = newPoint - oldPoint;
+                const float d2 = offset.length() * 2;
+                const float hit = map->firstObstacleOnXZSegment (oldPoint,
+                                                                 newPoint);
 
-                    // when obstacle found: set flag, save distance and position
-                    if (! map->isPassable (newPoint))
-                    {
-                        obstacleFound = true;
-                        obstacleDistance = d2 * 0.5f * (i+1);
-                        returnObstaclePosition = newPoint;
-                    }
-                    annotationLine (oldPoint, newPoint, beforeColor);
+                // when obstacle found: save distance and position, done
+                if (hit >= 0)
+                {
+                    arc.obstacleDistance = d2 * 0.5f * (i+1);
+                    arc.obstaclePosition = oldPoint + (offset * hit);
+                    arc.obstacleSegment = i;
+                    return;
                 }
                 // save new point for next time around loop
                 oldPoint = newPoint;
             }
-            // return distance to first obstacle (or zero if none found)
-            return obstacleDistance;
+        }
+
+        // draw the chords of a scanned arc, after its first obstacle in the
+        // "after" color
+        void annotateArcScan (const ArcScan& arc, const Vec3& center)
+        {
+            Vec3 spoke = arc.start - center;
+            const float step = arc.arcAngle / arc.segments;
+            const float startRadius = ((arc.endRadiusChange == 0) ?
+                                       0 :
+                                       spoke.length());
+            float sin=0, cos=0;
+            Vec3 oldPoint = arc.start;
+            for (int i = 0; i < arc.segments; i++)
+            {
+                spoke = spoke.rotateAboutGlobalY (step, sin, cos);
+                const Vec3 newPoint = center + (spoke *
+                                                rampAdjust (arc, i, startRadius));
+                annotationLine (oldPoint, newPoint,
+                                ((i > arc.obstacleSegment) ?
+                                 arc.afterColor :
+                                 arc.beforeColor));
+                oldPoint = newPoint;
+            }
+        }
+
+
+        // start, linear step, sample count and end radius change of the
+        // wing scan i (of wingScans) on side j (-1 or +1), shared by the
+        // linear and the curved scans of steerToAvoidObstaclesOnMap
+        void wingScan (const int i, const int j, const int wingScans,
+                       const Vec3& fOffset, const Vec3& sOffset,
+                       const Vec3& wingWidth, const float maxForward,
+                       const float spacing, const float signedRadius,
+                       Vec3& start, Vec3& step,
+                       int& raySamples, float& endRadius)
+        {
+            const float fraction = (float)i / (float)wingScans;
+            const Vec3 endside = sOffset + (wingWidth * fraction);
+            const Vec3 corridorFront = forward() * maxForward;
+
+            float k = (float)j; // prevent VC7.1 warning
+            start = fOffset + (sOffset * k);
+            const Vec3 end = fOffset + corridorFront + (endside * k);
+            const Vec3 ray = end - start;
+            const float rayLength = ray.length();
+            step = ray * spacing / rayLength;
+            raySamples = (int) (rayLength / spacing);
+            endRadius = (wingSlope () * maxForward * fraction *
+                         (signedRadius < 0 ? 1 : -1) * (j==1?1:-1));
         }
 
 
@@ -1603,7 +2587,35 @@ namespace {
             const float twoPi = 2 * OPENSTEER_M_PI;
             const float circumference = twoPi * arcRadius;
             const Vec3 qqqLift (0, 0.2f, 0);
-            Vec3 ignore;
+            const float bevel = 0.3f;
+
+            // for curved steering scan the fan of arc pairs at once, the
+            // loop below reads the results
+            std::vector<ArcScan>& arcs = arcScans;
+            arcs.clear ();
+            if (curvedSteering)
+            {
+                for (float w = s; w < maxSide; w += spacing)
+                {
+                    const Vec3 sOffset = side() * w;
+                    const float fraction = w / maxSide;
+                    const float scanDist = (halfLength +
+                                            interpolate (fraction,
+                                                         maxForward,
+                                                         maxForward * bevel));
+                    const float angle = (scanDist * twoPi * sign) / circumference;
+                    const int samples = (int) (scanDist / spacing);
+                    arcs.push_back (ArcScan (position () + sOffset + qqqLift,
+                                             angle, samples, 0,
+                                             gMagenta, gCyan));
+                    arcs.push_back (ArcScan (position () - sOffset + qqqLift,
+                                             angle, samples, 0,
+                                             gMagenta, gCyan));
+                }
+                if (! arcs.empty ())
+                    scanObstacleMapArcs (&arcs[0], (int) arcs.size(), center);
+            }
+            int nextArc = 0;
 
             // scan region ahead of vehicle
             while (s < maxSide)
@@ -1611,34 +2623,18 @@ namespace {
                 const Vec3 sOffset = side() * s;
                 const Vec3 lOffset = position () + sOffset;
                 const Vec3 rOffset = position () - sOffset;
-                const float bevel = 0.3f;
                 const float fraction = s / maxSide;
                 const float scanDist = (halfLength +
                                         interpolate (fraction,
                                                      maxForward,
                                                      maxForward * bevel));
-                const float angle = (scanDist * twoPi * sign) / circumference;
                 const int samples = (int) (scanDist / spacing);
                 const int L = (curvedSteering ?
-                               (int) (scanObstacleMap (lOffset + qqqLift,
-                                                       center,
-                                                       angle,
-                                                       samples,
-                                                       0,
-                                                       gMagenta,
-                                                       gCyan,
-                                                       ignore)
+                               (int) (arcs[nextArc++].obstacleDistance
                                       / spacing) :
                                map->scanXZray (lOffset, step, samples));
                 const int R = (curvedSteering ?
-                               (int) (scanObstacleMap (rOffset + qqqLift,
-                                                       center,
-                                                       angle,
-                                                       samples,
-                                                       0,
-                                                       gMagenta,
-                                                       gCyan,
-                                                       ignore)
+                               (int) (arcs[nextArc++].obstacleDistance
                                       / spacing) :
                                map->scanXZray (rOffset, step, samples));
 
@@ -1735,7 +2731,7 @@ namespace {
         //
         Vec3 steerToFollowPath (const int direction,
                                 const float predictionTime,
-                                GCRoute& path)
+                                const GCRoute& path)
         {
             if (curvedSteering)
                 return steerToFollowPathCurve (direction, predictionTime, path);
@@ -1746,7 +2742,7 @@ namespace {
 
         Vec3 steerToFollowPathLinear (const int direction,
                                       const float predictionTime,
-                                      GCRoute& path)
+                                      const GCRoute& path)
         {
             // our goal will be offset from our path distance by this amount
             const float pathDistanceOffset = direction * predictionTime * speed();
@@ -1841,7 +2837,7 @@ namespace {
         //
         Vec3 steerToFollowPathCurve (const int direction,
                                      const float predictionTime,
-                                     GCRoute& path)
+                                     const GCRoute& path)
         {
             // predict our future position (based on current curvature and speed)
             const Vec3 futurePosition = predictFuturePosition (predictionTime);
@@ -2010,52 +3006,38 @@ namespace {
             const Vec3 boundaryOffset = ((onPath - future).normalize() * o);
 
             const Vec3 onPathBoundary = future + boundaryOffset;
-            annotationLine (onPath, onPathBoundary, insidePathColor);
-            annotationLine (onPathBoundary, future, outsidePathColor);
-        }
-
-
-        void drawMap (void)
-        {
-    #ifdef OLDTERRAINMAP
-            const float xs = map->xSize/(float)map->resolution;
-            const float zs = map->zSize/(float)map->resolution;
-            const Vec3 alongRow (xs, 0, 0);
-            const Vec3 nextRow (-map->xSize, 0, zs);
-            Vec3 g ((map->xSize - xs) / -2, 0, (map->zSize - zs) / -2);
-            g += map->center;
-            for (int j = 0; j < map->resolution; j++)
-            {
-                for (int i = 0; i < map->resolution; i++)
-                {
-                    if (map->getMapBit (i, j))
-                    {
-                        // spikes
-                        // const Vec3 spikeTop (0, 5.0f, 0);
-                        // drawLine (g, g+spikeTop, gWhite);
-
-                        // squares
-                        const float rockHeight = 0;
-                        const Vec3 v1 (+xs/2, rockHeight, +zs/2);
-                        const Vec3 v2 (+xs/2, rockHeight, -zs/2);
-                        const Vec3 v3 (-xs/2, rockHeight, -zs/2);
-                        const Vec3 v4 (-xs/2, rockHeight, +zs/2);
-                        // const Vec3 redRockColor (0.6f, 0.1f, 0.0f);
-                        const Color orangeRockColor (0.5f, 0.2f, 0.0f);
-                        drawQuadrangle (g+v1, g+v2, g+v3, g+v4, orangeRockColor);
-
-                        // pyramids
-                        // const Vec3 top (0, xs/2, 0);
-                        // const Vec3 redRockColor (0.6f, 0.1f, 0.0f);
-                        // const Vec3 orangeRockColor (0.5f, 0.2f, 0.0f);
-                        // drawTriangle (g+v1, g+v2, g+top, redRockColor);
-                        // drawTriangle (g+v2, g+v3, g+top, orangeRockColor);
-                        // drawTriangle (g+v3, g+v4, g+top, redRockColor);
-                        // drawTriangle (g+v4, g+v1, g+top, orangeRockColor);
-                    } 
-                    g += alongRow;
+            annotationLine (onPath, onPathBoundary, insidePathColor);
+            annotationLine (onPathBoundary, future, outsidePathColor);
+        }
+
+
+        void drawMap (void)
+        {
+    #ifdef OLDTERRAINMAP
+            const float xs = map->xSize/(float)map->resolution;
+            const float zs = map->zSize/(float)map->resolution;
+            Vec3 rowStart ((map->xSize - xs) / -2, 0, (map->zSize - zs) / -2);
+            rowStart += map->center;
+            const int r = map->resolution;
+            for (int j = 0; j < r; j++)
+            {
+                // jump from set cell to set cell, skipping clear runs
+                for (int i = map->firstSetCellInRow (j, 0, r);
+                     i >= 0;
+                     i = map->firstSetCellInRow (j, i + 1, r))
+                {
+                    const Vec3 g = rowStart + Vec3 (xs * (float) i, 0, 0);
+
+                    // squares
+                    const float rockHeight = 0;
+                    const Vec3 v1 (+xs/2, rockHeight, +zs/2);
+                    const Vec3 v2 (+xs/2, rockHeight, -zs/2);
+                    const Vec3 v3 (-xs/2, rockHeight, -zs/2);
+                    const Vec3 v4 (-xs/2, rockHeight, +zs/2);
+                    const Color orangeRockColor (0.5f, 0.2f, 0.0f);
+                    drawQuadrangle (g+v1, g+v2, g+v3, g+v4, orangeRockColor);
                 }
-                g += nextRow;
+                rowStart.z += zs;
             }
     #else
     #endif
@@ -2092,57 +3074,6 @@ namespace {
         }
 
 
-        GCRoute* makePath (void)
-        {
-            // a few constants based on world size
-            const float m = worldSize * 0.4f; // main diamond size
-            const float n = worldSize / 8;    // notch size
-            const float o = worldSize * 2;    // outside of the sand
-
-            // construction vectors
-            const Vec3 p (0,   0, m);
-            const Vec3 q (0,   0, m-n);
-            const Vec3 r (-m,  0, 0);
-            const Vec3 s (2*n, 0, 0);
-            const Vec3 t (o,   0, 0);
-            const Vec3 u (-o,  0, 0);
-            const Vec3 v (n,   0, 0);
-            const Vec3 w (0, 0, 0);
-
-
-            // path vertices
-            const Vec3 a (t-p);
-            const Vec3 b (s+v-p);
-            const Vec3 c (s-q);
-            const Vec3 d (s+q);
-            const Vec3 e (s-v+p);
-            const Vec3 f (p-w);
-            const Vec3 g (r-w);
-            const Vec3 h (-p-w);
-            const Vec3 i (u-p);
-
-            // return Path object
-            const int pathPointCount = 9;
-            const Vec3 pathPoints[pathPointCount] = {a, b, c, d, e, f, g, h, i};
-            const float k = 10.0f;
-            const float pathRadii[pathPointCount] = {k, k, k, k, k, k, k, k, k};
-            return new GCRoute (pathPointCount, pathPoints, pathRadii, false);
-        }
-
-
-        TerrainMap* makeMap (void)
-        {
-    #ifdef OLDTERRAINMAP
-            return new TerrainMap (Vec3::zero,
-                                   worldSize,
-                                   worldSize,
-                                   (int)worldSize + 1);
-    #else
-            return new TerrainMap (worldSize, worldSize, 1);
-    #endif
-        }
-
-
         bool handleExitFromMap (void)
         {
             if (demoSelect == 2)
@@ -2170,12 +3101,17 @@ namespace {
                     // reset bookeeping to detect stuck cycles
                     resetStuckCycleDetection ();
 
-                    // new camera position and aimpoint to compensate for teleport
-                    OpenSteerDemo::camera.target = position ();
-                    OpenSteerDemo::camera.setPosition (position () + camOffsetBefore);
+                    // new camera position and aimpoint to compensate for
+                    // teleport (only when the camera follows this driver)
+                    if (OpenSteerDemo::selectedVehicle == this)
+                    {
+                        OpenSteerDemo::camera.target = position ();
+                        OpenSteerDemo::camera.setPosition (position () +
+                                                           camOffsetBefore);
 
-                    // make camera jump immediately to new position
-                    OpenSteerDemo::camera.doNotSmoothNextMove ();
+                        // make camera jump immediately to new position
+                        OpenSteerDemo::camera.doNotSmoothNextMove ();
+                    }
 
                     // prevent long streaks due to teleportation 
                     clearTrailHistory ();
@@ -2461,11 +3397,17 @@ namespace {
             }
         }
 
-        // map of obstacles
-        TerrainMap* map;
+        // map of obstacles, owned by the shared world
+        const TerrainMap* map;
 
-        // route for path following (waypoints and legs)
-        GCRoute* path;
+        // fan of arcs scanned together by the curved obstacle scans
+        std::vector<ArcScan> arcScans;
+
+        // route for path following (waypoints and legs), owned by the world
+        const GCRoute* path;
+
+        // print a message on each collision
+        bool reportCollisions;
 
         // follow the path "upstream or downstream" (+1/-1)
         int pathFollowDirection;
@@ -2528,7 +3470,7 @@ namespace {
 
         // save obstacle avoidance stats for annotation
         // (nearest obstacle in each of the four zones)
-        static float savedNearestWR, savedNearestR, savedNearestL, savedNearestWL;
+        float savedNearestWR, savedNearestR, savedNearestL, savedNearestWL;
 
         float annoteMaxRelSpeed, annoteMaxRelSpeedCurve, annoteMaxRelSpeedPath;
 
@@ -2551,10 +3493,6 @@ namespace {
     // int MapDriver::demoSelect = 0;
     int MapDriver::demoSelect = 2;
 
-    float MapDriver::savedNearestWR = 0;
-    float MapDriver::savedNearestR = 0;
-    float MapDriver::savedNearestL = 0;
-    float MapDriver::savedNearestWL = 0;
 
 
     // ----------------------------------------------------------------------------
@@ -2574,8 +3512,9 @@ namespace {
 
         void open (void)
         {
-            // make new MapDriver
-            vehicle = new MapDriver ();
+            // make the world and a new MapDriver in it
+            world = new MapDriveWorld (MapDriver::worldSize);
+            vehicle = new MapDriver (*world);
             vehicles.push_back (vehicle);
             OpenSteerDemo::selectedVehicle = vehicle;
 
@@ -2585,6 +3524,9 @@ namespace {
             // scatter random rock clumps over map
             useRandomRocks = true;
 
+            // trace scans through the map's distance field
+            useDistanceField = true;
+
             // init OpenSteerDemo camera
             initCamDist = 30;
             initCamElev = 15;
@@ -2696,6 +3638,10 @@ namespace {
             status << "\n[F5] prediction: ";
             if (vehicle->curvedSteering)
                 status << "curved"; else status << "linear";
+            status << "\n[F7] distance field: ";
+            if (useDistanceField) status << "on"; else status << "off";
+            if (world->cacheIsEnabled ())
+                status << "\nmaps loaded from cache: " << world->cacheHitCount ();
             if (2 == vehicle->demoSelect)
             {
                 status << "\n\nLap " << vehicle->lapsStarted
@@ -2756,6 +3702,7 @@ namespace {
         {
             vehicles.clear ();
             delete (vehicle);
+            delete (world);
         }
 
         void reset (void)
@@ -2794,9 +3741,11 @@ namespace {
                     const float pathRadii[pathPointCount] = {10, 10};
                     const Vec3 pathPoints[pathPointCount] = {c, d};
                     GCRoute r (pathPointCount, pathPoints, pathRadii, false);
-                    drawPathFencesOnMap (*vehicle->map, r);
+                    MapDriveWorld::drawPathFencesOnMap (*world->map, r);
+                    if (useDistanceField) world->map->buildDistanceField ();
                     break;
                 }
+            case 7: toggleDistanceField (); break;
             }
         }
 
@@ -2811,6 +3760,7 @@ namespace {
             OpenSteerDemo::printMessage ("  F3     toggle path fences.");
             OpenSteerDemo::printMessage ("  F4     toggle random rock clumps.");
             OpenSteerDemo::printMessage ("  F5     toggle curved prediction.");
+            OpenSteerDemo::printMessage ("  F7     toggle map distance field.");
             OpenSteerDemo::printMessage ("");
         }
 
@@ -2832,6 +3782,12 @@ namespace {
             reset ();
         }
 
+        void toggleDistanceField (void)
+        {
+            useDistanceField = ! useDistanceField;
+            reset ();
+        }
+
         void toggleCurvedSteering (void)
         {
             vehicle->curvedSteering = ! vehicle->curvedSteering;
@@ -2864,161 +3820,297 @@ namespace {
             OpenSteerDemo::printMessage (message);
         }
 
-        // random utility, worth moving to Utilities.h?
-        int irandom2 (int min, int max)
+        void regenerateMap (void)
         {
-            return (int) frandom2 ((float) min, (float) max);
+            world->regenerate (vehicle->demoSelect,
+                               vehicle->pathFollowDirection,
+                               useRandomRocks,
+                               usePathFences,
+                               useDistanceField);
         }
 
-	void regenerateMap (void)
-	{
-	    // regenerate map: clear and add random "rocks"
-	    vehicle->map->clear();
-	    drawRandomClumpsOfRocksOnMap (*vehicle->map);
-	    clearCenterOfMap (*vehicle->map);
-
-	    // draw fences for first two demo modes
-	    if (vehicle->demoSelect < 2) drawBoundaryFencesOnMap (*vehicle->map);
-
-	    // randomize path widths
-	    if (vehicle->demoSelect == 2)
-	    {
-		const OpenSteer::size_t count = vehicle->path->segmentCount();
-		const bool upstream = vehicle->pathFollowDirection > 0;
-		const OpenSteer::size_t entryIndex = upstream ? 0 : count-1;
-		const OpenSteer::size_t exitIndex  = upstream ? count-1 : 0;
-		const float lastExitRadius = vehicle->path->segmentRadius( exitIndex );
-		for (OpenSteer::size_t i = 0; i < count; i++)
-		{
-		    vehicle->path->setSegmentRadius( i, frandom2 (4, 19) );
-		}
-		vehicle->path->setSegmentRadius( entryIndex, lastExitRadius );
-	    }
-
-	    // mark path-boundary map cells as obstacles
-	    // (when in path following demo and appropriate mode is set)
-	    if (usePathFences && (vehicle->demoSelect == 2))
-		drawPathFencesOnMap (*vehicle->map, *vehicle->path);
-	}
-
-        void drawRandomClumpsOfRocksOnMap (TerrainMap& map)
-        {
-            if (useRandomRocks)
-            {
-                const int spread = 4;
-                const int r = map.cellwidth();
-                const int k = irandom2 (50, 150);
-
-                for (int p=0; p<k; p++)
-                {
-                    const int i = irandom2 (0, r - spread);
-                    const int j = irandom2 (0, r - spread);
-                    const int c = irandom2 (0, 10);
+        const AVGroup& allVehicles (void) {return (const AVGroup&) vehicles;}
 
-                    for (int q=0; q<c; q++)
-                    {
-                        const int m = irandom2 (0, spread);
-                        const int n = irandom2 (0, spread);
-    #ifdef OLDTERRAINMAP
-                        map.setMapBit (i+m, j+n, 1);
-    #else
-                        map.setType (i+m, j+n, CellData::OBSTACLE);
-    #endif
-                    }
-                }
-            }
+        MapDriveWorld* world;
+        MapDriver* vehicle;
+        std::vector<MapDriver*> vehicles; // for allVehicles
+
+        float initCamDist, initCamElev;
+
+        bool usePathFences;
+        bool useRandomRocks;
+        bool useDistanceField;
+    };
+
+
+    MapDrivePlugIn gMapDrivePlugIn;
+
+
+    // ----------------------------------------------------------------------------
+    // PlugIn for OpenSteerDemo: a fleet of MapDrivers sharing one world.  The
+    // map and route are built once per reset and then only read, so the
+    // drivers are simulated in parallel when parallel update is on.
+
+
+    class MapDriveFleetPlugIn : public PlugIn
+    {
+    public:
+
+        const char* name (void) {return "Fleet driving through a shared map";}
+
+        float selectionOrderSortKey (void) {return 0.071f;}
+
+        // be more "nice" to avoid a compiler warning
+        virtual ~MapDriveFleetPlugIn() {}
+
+        void open (void)
+        {
+            // make the shared world and a default-sized fleet in it
+            world = new MapDriveWorld (MapDriver::worldSize);
+            pathFollowDirection = 1;
+            useRandomRocks = true;
+            updateTime = 0;
+            for (int i = 0; i < 200; i++) addDriver ();
+            OpenSteerDemo::selectedVehicle = fleet.front ();
+
+            // init OpenSteerDemo camera
+            OpenSteerDemo::init2dCamera (*fleet.front (), 30, 15);
+            OpenSteerDemo::camera.lookdownDistance = 50;
+            OpenSteerDemo::camera.fixedPosition.set (145, 145, 145);
+            OpenSteerDemo::camera.fixedTarget.set (40, 0, 40);
+            OpenSteerDemo::camera.fixedUp = Vec3::up;
+            OpenSteerDemo::camera.mode = Camera::cmFixed;
+
+            // reset this plugin
+            reset ();
         }
 
 
-        void drawBoundaryFencesOnMap (TerrainMap& map)
+        // loop body for the parallel update: simulates a range of drivers
+        class Simulate
         {
-            // QQQ it would make more sense to do this with a "draw line
-            // QQQ on map" primitive, may need that for other things too
+        public:
+            Simulate (std::vector<MapDriver*>& f,
+                      const float t,
+                      const float dt)
+                : fleet (f), currentTime (t), elapsedTime (dt) {}
+            void operator() (size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; i++)
+                    fleet[i]->simulate (currentTime, elapsedTime);
+            }
+        private:
+            std::vector<MapDriver*>& fleet;
+            const float currentTime;
+            const float elapsedTime;
+        };
 
-            const int cw = map.cellwidth();
-            const int ch = map.cellheight();
 
-            const int r = cw - 1;
-            const int a = cw >> 3;
-            const int b = cw - a;
-            const int o = cw >> 4;
-            const int p = (cw - o) >> 1;
-            const int q = (cw + o) >> 1;
+        void update (const float currentTime, const float elapsedTime)
+        {
+            const float start = OpenSteerDemo::clock.realTimeSinceFirstClockUpdate ();
 
-            for (int i = 0; i < cw; i++)
+            if (parallelUpdateIsOn ())
             {
-                for (int j = 0; j < ch; j++)
+                // annotation is not thread-safe, so it is off meanwhile
+                const bool annotation = annotationIsOn ();
+                setAnnotationOff ();
+                Simulate simulate (fleet, currentTime, elapsedTime);
                 {
-                    const bool c = i>a && i<b && (i<p || i>q);
-                    if (i==0 || j==0 || i==r || j==r || (c && (i==j || i+j==r))) 
-    #ifdef OLDTERRAINMAP
-                        map.setMapBit (i, j, 1);
-    #else
-                        map.setType (i, j, CellData::IMPASSABLE);
-    #endif
+                    PhaseTimer::Scope timer (PhaseTimer::steeringPhase);
+                    WorkerPool::shared().parallelFor (fleet.size(), simulate);
+                }
+                if (annotation) setAnnotationOn ();
+            }
+            else
+            {
+                for (iterator i = fleet.begin(); i != fleet.end(); i++)
+                    (**i).update (currentTime, elapsedTime);
+            }
+
+            // serially: wrap drivers around the world (the shared map stays
+            // as it is) and restart the stuck ones somewhere else
+            for (iterator i = fleet.begin(); i != fleet.end(); i++)
+            {
+                (**i).handleExitFromMap ();
+                if ((**i).stuck && ((**i).relativeSpeed () < 0.001f))
+                {
+                    (**i).stuckCount++;
+                    placeDriver (**i);
                 }
             }
+
+            // smoothed wall clock milliseconds per update
+            const float ms = 1000 *
+                (OpenSteerDemo::clock.realTimeSinceFirstClockUpdate () - start);
+            blendIntoAccumulator (0.05f, ms, updateTime);
         }
 
 
-        void clearCenterOfMap (TerrainMap& map)
+        void redraw (const float currentTime, const float elapsedTime)
         {
-            const int o = map.cellwidth() >> 4;
-            const int p = (map.cellwidth() - o) >> 1;
-            const int q = (map.cellwidth() + o) >> 1;
-            for (int i = p; i <= q; i++)
-                for (int j = p; j <= q; j++)
-    #ifdef OLDTERRAINMAP
-                    map.setMapBit (i, j, 0);
-    #else
-                    map.setType (i, j, CellData::CLEAR);
-    #endif
+            // update camera, tracking the selected driver
+            AbstractVehicle& selected = *OpenSteerDemo::selectedVehicle;
+            OpenSteerDemo::updateCamera (currentTime, elapsedTime, selected);
+
+            // draw "ground plane"  (make it 4x map size)
+            const float s = MapDriver::worldSize * 2;
+            const float u = -0.2f;
+            drawQuadrangle (Vec3 (+s, u, +s),
+                            Vec3 (+s, u, -s),
+                            Vec3 (-s, u, -s),
+                            Vec3 (-s, u, +s),
+                            Color (0.8f, 0.7f, 0.5f)); // "sand"
+
+            // draw map and path (any driver draws the shared world)
+            fleet.front()->drawMap ();
+            if (MapDriver::demoSelect == 2) fleet.front()->drawPath ();
+
+            // draw the fleet
+            for (iterator i = fleet.begin(); i != fleet.end(); i++)
+                (**i).draw ();
+
+            // display status in the upper left corner of the window
+            int stuckCount = 0;
+            for (iterator i = fleet.begin(); i != fleet.end(); i++)
+                stuckCount += (**i).stuckCount;
+            std::ostringstream status;
+            status << "[F1] ";
+            if (1 == MapDriver::demoSelect) status << "wander, ";
+            if (2 == MapDriver::demoSelect) status << "follow path, ";
+            status << "avoid obstacle";
+            status << "\n[F2/F3] drivers: " << fleet.size();
+            status << "\n[F4] rocks: ";
+            if (useRandomRocks) status << "on"; else status << "off";
+            status << "\n\nupdate: "
+                   << std::setprecision (2) << std::setiosflags (std::ios::fixed)
+                   << updateTime << " ms ("
+                   << (parallelUpdateIsOn () ? "parallel" : "serial") << ")";
+            status << "\nStuck count: " << stuckCount;
+            status << std::ends;
+            const float h = drawGetWindowHeight ();
+            const Vec3 screenLocation (10, h-50, 0);
+            const Color color (0.15f, 0.15f, 0.5f);
+            draw2dTextAt2dLocation (status, screenLocation, color, drawGetWindowWidth(), drawGetWindowHeight());
         }
 
+        void close (void)
+        {
+            while (! fleet.empty ()) removeDriver ();
+            delete (world);
+        }
 
-        void drawPathFencesOnMap (TerrainMap& map, GCRoute& path)
+        void reset (void)
         {
-    #ifdef OLDTERRAINMAP
-            const float xs = map.xSize / (float)map.resolution;
-            const float zs = map.zSize / (float)map.resolution;
-            const Vec3 alongRow (xs, 0, 0);
-            const Vec3 nextRow (-map.xSize, 0, zs);
-            Vec3 g ((map.xSize - xs) / -2, 0, (map.zSize - zs) / -2);
-            for (int j = 0; j < map.resolution; j++)
+            // build the shared world once, then scatter the fleet over it
+            world->regenerate (MapDriver::demoSelect,
+                               pathFollowDirection,
+                               useRandomRocks,
+                               true,
+                               true);
+            for (iterator i = fleet.begin(); i != fleet.end(); i++)
+                placeDriver (**i);
+
+            // make camera jump immediately to new position
+            OpenSteerDemo::camera.doNotSmoothNextMove ();
+        }
+
+        // reset a driver and move it to a random spot: somewhere along the
+        // route when following it, otherwise some clear cell of the map
+        void placeDriver (MapDriver& driver)
+        {
+            driver.pathFollowDirection = pathFollowDirection;
+            driver.reset ();
+            if (MapDriver::demoSelect == 2)
             {
-                for (int i = 0; i < map.resolution; i++)
-                {
-                    const float outside = mapPointToOutside( path, g ); // path.howFarOutsidePath (g);
-                    const float wallThickness = 1.0f;
+                const GCRoute& path = *world->path;
+                const float d = frandom01 () * path.length ();
+                const float ahead = d + (float) pathFollowDirection;
+                const Vec3 p = path.mapPathDistanceToPoint (d);
+                const Vec3 t = path.mapPathDistanceToPoint (ahead) - p;
+                driver.setPosition (p);
+                if (t != Vec3::zero) driver.regenerateOrthonormalBasisUF (t.normalize ());
+            }
+            else
+            {
+                const float r = MapDriver::worldSize * 0.4f;
+                Vec3 p;
+                do p = Vec3 (frandom2 (-r, r), 0, frandom2 (-r, r));
+                while (! world->map->isPassable (p));
+                driver.setPosition (p);
+                driver.randomizeHeadingOnXZPlane ();
+            }
+            driver.clearTrailHistory ();
+        }
 
-                    // set map cells adjacent to the outside edge of the path
-                    if ((outside > 0) && (outside < wallThickness))
-                        map.setMapBit (i, j, true);
+        void addDriver (void)
+        {
+            MapDriver* driver = new MapDriver (*world);
+            driver->reportCollisions = false;
+            placeDriver (*driver);
+            fleet.push_back (driver);
+        }
 
-                    // clear all other off-path map cells 
-                    if (outside > wallThickness) map.setMapBit (i, j, false);
+        void removeDriver (void)
+        {
+            if (! fleet.empty ())
+            {
+                MapDriver* driver = fleet.back ();
+                fleet.pop_back ();
+                if (driver == OpenSteerDemo::selectedVehicle)
+                    OpenSteerDemo::selectedVehicle =
+                        fleet.empty () ? NULL : fleet.front ();
+                delete (driver);
+            }
+        }
 
-                    g += alongRow;
-                }
-                g += nextRow;
+        void handleFunctionKeys (int keyNumber)
+        {
+            switch (keyNumber)
+            {
+            case 1: selectNextDemo (); break;
+            case 2: for (int i = 0; i < 50; i++) addDriver (); break;
+            case 3: for (int i = 0; i < 50 && fleet.size () > 1; i++)
+                        removeDriver ();
+                    break;
+            case 4: useRandomRocks = ! useRandomRocks; reset (); break;
             }
-    #else
-    #endif
         }
 
-        const AVGroup& allVehicles (void) {return (const AVGroup&) vehicles;}
+        void printMiniHelpForFunctionKeys (void)
+        {
+            std::ostringstream message;
+            message << "Function keys handled by ";
+            message << '"' << name() << '"' << ':' << std::ends;
+            OpenSteerDemo::printMessage (message);
+            OpenSteerDemo::printMessage ("  F1     select next driving demo.");
+            OpenSteerDemo::printMessage ("  F2     add 50 drivers to the fleet.");
+            OpenSteerDemo::printMessage ("  F3     remove 50 drivers from the fleet.");
+            OpenSteerDemo::printMessage ("  F4     toggle random rock clumps.");
+            OpenSteerDemo::printMessage ("");
+        }
 
-        MapDriver* vehicle;
-        std::vector<MapDriver*> vehicles; // for allVehicles
+        void selectNextDemo (void)
+        {
+            if (++MapDriver::demoSelect > 2) MapDriver::demoSelect = 0;
+            reset ();
+        }
 
-        float initCamDist, initCamElev;
+        const AVGroup& allVehicles (void) {return (const AVGroup&) fleet;}
 
-        bool usePathFences;
+        MapDriveWorld* world;
+        std::vector<MapDriver*> fleet;
+        typedef std::vector<MapDriver*>::const_iterator iterator;
+
+        int pathFollowDirection;
         bool useRandomRocks;
+
+        // smoothed milliseconds of wall clock time per update
+        float updateTime;
     };
 
 
-    MapDrivePlugIn gMapDrivePlugIn;
+    MapDriveFleetPlugIn gMapDriveFleetPlugIn;
 
 
     // ----------------------------------------------------------------------------
@@ -36,8 +36,9 @@
 // ----------------------------------------------------------------------------
 
 
-#include "OpenSteer/SimpleVehicle.h"
+#include "OpenSteer/PlanarVehicle.h"
 #include "OpenSteer/OpenSteerDemo.h"
+#include "OpenSteer/PhaseTimer.h"
 #include "OpenSteer/Color.h"
 
 namespace {
@@ -50,7 +51,7 @@ namespace {
     // a common base class, MpBase, which is a specialization of SimpleVehicle.
 
 
-    class MpBase : public SimpleVehicle
+    class MpBase : public PlanarVehicle
     {
     public:
 
@@ -97,8 +98,10 @@ namespace {
         // one simulation step
         void update (const float currentTime, const float elapsedTime)
         {
-            const Vec3 wander2d = steerForWander (elapsedTime).setYtoZero ();
-            const Vec3 steer = forward() + (wander2d * 3);
+            PhaseTimer::Scope timer (PhaseTimer::steeringPhase);
+
+            // (PlanarVehicle keeps the wandering on the plane)
+            const Vec3 steer = forward() + (steerForWander (elapsedTime) * 3);
             applySteeringForce (steer, elapsedTime);
 
             // for annotation
@@ -126,6 +129,8 @@ namespace {
         // one simulation step
         void update (const float currentTime, const float elapsedTime)
         {
+            PhaseTimer::Scope timer (PhaseTimer::steeringPhase);
+
             // when pursuer touches quarry ("wanderer"), reset its position
             const float d = Vec3::distance (position(), wanderer->position());
             const float r = radius() + wanderer->radius();
@@ -145,8 +150,8 @@ namespace {
             // centered around the home base
             const float inner = 20;
             const float outer = 30;
-            const float radius = frandom2 (inner, outer);
-            const Vec3 randomOnRing = RandomUnitVectorOnXZPlane () * radius;
+            const float radius = randomStream().frandom2 (inner, outer);
+            const Vec3 randomOnRing = RandomUnitVectorOnXZPlane (randomStream ()) * radius;
             setPosition (wanderer->position() + randomOnRing);
 
             // randomize 2D heading
@@ -37,12 +37,23 @@
 // ----------------------------------------------------------------------------
 
 
+#include <cstring>
 #include <iomanip>
+#include <limits>
 #include <sstream>
 #include "OpenSteer/PolylineSegmentedPathwaySingleRadius.h"
-#include "OpenSteer/SimpleVehicle.h"
+#include "OpenSteer/FlowField.h"
+#include "OpenSteer/PlanarVehicle.h"
+#include "OpenSteer/SimulationSnapshot.h"
+#include "OpenSteer/Checkpoint.h"
 #include "OpenSteer/OpenSteerDemo.h"
+#include "OpenSteer/PhaseTimer.h"
+#include "OpenSteer/WorkerPool.h"
+#include "OpenSteer/ObjectPool.h"
+#include "OpenSteer/SimulationContext.h"
 #include "OpenSteer/Proximity.h"
+#include "OpenSteer/NeighborList.h"
+#include "OpenSteer/UpdateScheduler.h"
 #include "OpenSteer/Color.h"
 
 namespace {
@@ -71,6 +82,10 @@ namespace {
     Vec3 gEndpoint0;
     Vec3 gEndpoint1;
     bool gUseDirectedPathFollowing = true;
+    // the test path mapped to a grid, shared by all path following
+    FlowField gTestPathFlowField;
+    bool gUseFlowField = true;
+    const FlowField& getPathFlowField (void);
     // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
     RectangleObstacle gObstacle3 (7,7);
     // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
@@ -78,26 +93,76 @@ namespace {
     // this was added for debugging tool, but I might as well leave it in
     bool gWanderSwitch = true;
 
+    // how far ahead (in seconds) Pedestrians look for collisions with each
+    // other, reset to the standard one when the PlugIn is opened
+    const float gStandardCollisionAvoidanceLeadTime = 3;
+    float gCollisionAvoidanceLeadTime = gStandardCollisionAvoidanceLeadTime;
+
+    // how often Pedestrians refresh their neighbors (every update for one
+    // slice, otherwise at every Nth update, taking them from their
+    // previous query in between)
+    NeighborRefreshSlices gNeighborRefresh;
+
+
+    // ----------------------------------------------------------------------------
+    // checkpoint sections of the crowd: the SimpleVehicle state of each
+    // Pedestrian and its path following state, the crowd's settings, the
+    // path and the sphere obstacles
+
+
+    const CheckpointTag pedestriansTag = checkpointTag ("PEDS");
+    const CheckpointTag pathFollowingTag = checkpointTag ("PFOL");
+    const CheckpointTag crowdSettingsTag = checkpointTag ("CRWD");
+    const CheckpointTag pathPointsTag = checkpointTag ("PATH");
+    const CheckpointTag obstaclesTag = checkpointTag ("OBST");
+    const CheckpointTag databaseStateTag = checkpointTag ("PDST");
+    const CheckpointTag placementOrderTag = checkpointTag ("PDOR");
+
+    struct PathFollowing
+    {
+        int32_t pathDirection;
+        int32_t hasSegment;
+        uint64_t segmentIndex;
+    };
+
+    struct CrowdSettings
+    {
+        int proximityDatabase;
+        int directedPathFollowing;
+        int wander;
+        int levelOfDetail;
+        float pathRadius;
+        int pathIsCyclic;
+    };
+
 
     // ----------------------------------------------------------------------------
 
 
-    class Pedestrian : public SimpleVehicle
+    class Pedestrian : public PlanarVehicle, public PooledObject<Pedestrian>
     {
     public:
 
+        // Pedestrians live in the plugin's pool (which charges its chunks
+        // to vehicle memory), so they take its new and delete
+        using PooledObject<Pedestrian>::operator new;
+        using PooledObject<Pedestrian>::operator delete;
+
         // type for a group of Pedestrians
         typedef std::vector<Pedestrian*> groupType;
 
-        // constructor
-        Pedestrian (ProximityDatabase& pd)
+        // constructor: the new Pedestrian's token has no position in the
+        // proximity database until the caller gives it one (so a whole
+        // batch of new Pedestrians can be placed at once)
+        Pedestrian (ProximityDatabase& pd, SimulationContexts& c)
+            : contexts (c)
         {
             // allocate a token for this boid in the proximity database
             proximityToken = NULL;
             newPD (pd);
 
             // reset Pedestrian state
-            reset ();
+            resetState ();
         }
 
         // destructor
@@ -109,6 +174,15 @@ namespace {
 
         // reset all instance state
         void reset (void)
+        {
+            resetState ();
+
+            // notify proximity database that our position has changed
+            proximityToken->updateForNewPosition (position());
+        }
+
+        // reset all instance state in place, except for the proximity token
+        void resetState (void)
         {
             // reset the vehicle 
             SimpleVehicle::reset ();
@@ -120,38 +194,58 @@ namespace {
             // initially stopped
             setSpeed (0);
 
+            // no neighbors searched for yet
+            neighborCount = 0;
+
             // size of bounding sphere, for obstacle avoidance, etc.
             setRadius (0.5); // width = 0.7, add 0.3 margin, take half
 
             // set the path for this Pedestrian to follow
             path = getTestPath ();
+            pathCursor.reset ();
 
             // set initial position
             // (random point on path + random horizontal offset)
-            const float d = path->length() * frandom01();
+            const float d = path->length() * randomStream().frandom01 ();
             const float r = path->radius();
-            const Vec3 randomOffset = randomVectorOnUnitRadiusXZDisk () * r;
+            const Vec3 randomOffset = randomVectorOnUnitRadiusXZDisk (randomStream ()) * r;
             setPosition (path->mapPathDistanceToPoint (d) + randomOffset);
 
             // randomize 2D heading
             randomizeHeadingOnXZPlane ();
 
             // pick a random direction for path following (upstream or downstream)
-            pathDirection = (frandom01() > 0.5) ? -1 : +1;
+            pathDirection = (randomStream().frandom01 () > 0.5) ? -1 : +1;
 
             // trail parameters: 3 seconds with 60 points along the trail
             setTrailParameters (3, 60);
+        }
+
+        // per frame simulation update
+        void update (const float currentTime, const float elapsedTime)
+        {
+            computeSteering (contexts.forThisThread (), elapsedTime);
+            applySteering (currentTime, elapsedTime);
 
             // notify proximity database that our position has changed
             proximityToken->updateForNewPosition (position());
         }
 
-        // per frame simulation update
-        void update (const float currentTime, const float elapsedTime)
+        // two-phase update, phase one: determine this frame's steering force
+        // (only reads the other pedestrians, so may run in parallel for the
+        // whole crowd)
+        void computeSteering (SimulationContext& context,
+                              const float elapsedTime)
+        {
+            steering = determineCombinedSteering (context, elapsedTime);
+        }
+
+        // two-phase update, phase two: apply the steering force computed by
+        // computeSteering (the caller then updates the proximity token)
+        void applySteering (const float currentTime, const float elapsedTime)
         {
             // apply steering force to our momentum
-            applySteeringForce (determineCombinedSteering (elapsedTime),
-                                elapsedTime);
+            applySteeringForce (steering, elapsedTime);
 
             // reverse direction when we reach an endpoint
             if (gUseDirectedPathFollowing)
@@ -174,15 +268,15 @@ namespace {
             // annotation
             annotationVelocityAcceleration (5, 0);
             recordTrailVertex (currentTime, position());
-
-            // notify proximity database that our position has changed
-            proximityToken->updateForNewPosition (position());
         }
 
         // compute combined steering force: move forward, avoid obstacles
         // or neighbors if needed, otherwise follow the path and wander
-        Vec3 determineCombinedSteering (const float elapsedTime)
+        Vec3 determineCombinedSteering (SimulationContext& context,
+                                        const float elapsedTime)
         {
+            PhaseTimer::Scope timer (PhaseTimer::steeringPhase);
+
             // move forward
             Vec3 steeringForce = forward();
 
@@ -193,7 +287,7 @@ namespace {
 
             // determine if obstacle avoidance is required
             Vec3 obstacleAvoidance;
-            if (leakThrough < frandom01())
+            if (leakThrough < randomStream().frandom01 ())
             {
                 const float oTime = 6; // minTimeToCollision = 6 seconds
     // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
@@ -214,18 +308,25 @@ namespace {
             {
                 // otherwise consider avoiding collisions with others
                 Vec3 collisionAvoidance;
-                const float caLeadTime = 3;
+                const float caLeadTime = gCollisionAvoidanceLeadTime;
 
                 // find all neighbors within maxRadius using proximity database
                 // (radius is largest distance between vehicles traveling head-on
                 // where a collision is possible within caLeadTime seconds.)
                 const float maxRadius = caLeadTime * maxSpeed() * 2;
+                AVGroup& neighbors = context.neighbors;
                 neighbors.clear();
-                proximityToken->findNeighbors (position(), maxRadius, neighbors);
+                if (gNeighborRefresh.slices () > 1)
+                    neighborList.findNeighbors (gNeighborRefresh, serialNumber,
+                                                *proximityToken,
+                                                position(), maxRadius, neighbors);
+                else
+                    proximityToken->findNeighbors (position(), maxRadius, neighbors);
+                neighborCount = neighbors.size();
 
-                if (leakThrough < frandom01())
+                if (leakThrough < randomStream().frandom01 ())
                     collisionAvoidance =
-                        steerToAvoidNeighbors (caLeadTime, neighbors) * 10;
+                        steerToAvoidNeighbors<Pedestrian> (caLeadTime, neighbors) * 10;
 
                 // if collision avoidance is needed, do it
                 if (collisionAvoidance != Vec3::zero)
@@ -242,16 +343,18 @@ namespace {
                     const float pfLeadTime = 3;
                     const Vec3 pathFollow =
                         (gUseDirectedPathFollowing ?
-                         steerToFollowPath (pathDirection, pfLeadTime, *path) :
-                         steerToStayOnPath (pfLeadTime, *path));
+                         steerToFollowPath (pathDirection, pfLeadTime, *path,
+                                            getPathFlowField (), pathCursor) :
+                         steerToStayOnPath (pfLeadTime, *path,
+                                            getPathFlowField (), pathCursor));
 
                     // add in to steeringForce
                     steeringForce += pathFollow * 0.5;
                 }
             }
 
-            // return steering constrained to global XZ "ground" plane
-            return steeringForce.setYtoZero ();
+            // (PlanarVehicle constrains it to the global XZ "ground" plane)
+            return steeringForce;
         }
 
 
@@ -301,7 +404,9 @@ namespace {
             const Color color = headOn ? red : green;
             const char* string = headOn ? "OUCH!" : "pardon me";
             const Vec3 location = position() + Vec3 (0, 0.5f, 0);
-            if (OpenSteer::annotationIsOn())
+            // (text is drawn right away, so only while drawing: there may be
+            // no graphics context during an update)
+            if (OpenSteer::annotationIsOn() && OpenSteer::drawPhaseActive)
                 draw2dTextAt3dLocation (*string, location, color, drawGetWindowWidth(), drawGetWindowHeight());
         }
 
@@ -352,9 +457,17 @@ namespace {
         // a pointer to this boid's interface object for the proximity database
         ProximityToken* proximityToken;
 
-        // allocate one and share amoung instances just to save memory usage
-        // (change to per-instance allocation to be more MP-safe)
-        static AVGroup neighbors;
+        // this pedestrian's neighbors as of their latest refresh
+        NeighborList neighborList;
+
+        // the crowd's per thread simulation contexts
+        SimulationContexts& contexts;
+
+        // number of neighbors found by this pedestrian's latest search
+        size_t neighborCount;
+
+        // steering force from computeSteering, used by applySteering
+        Vec3 steering;
 
         // path to be followed by this pedestrian
         // XXX Ideally this should be a generic Pathway, but we use the
@@ -363,14 +476,14 @@ namespace {
         // XXX there be a "random position inside path" method on Pathway?
         PolylineSegmentedPathwaySingleRadius* path;
 
+        // where on the path the last path queries found this pedestrian
+        PathCursor pathCursor;
+
         // direction for path following (upstream or downstream)
         int pathDirection;
     };
 
 
-    AVGroup Pedestrian::neighbors;
-
-
     // ----------------------------------------------------------------------------
     // create path for PlugIn 
     //
@@ -459,11 +572,22 @@ namespace {
                                                                   pathPoints,
                                                                   pathRadius,
                                                                   false);
+            gTestPath->setSegmentIndexEnabled (true);
+            gTestPathFlowField.build (*gTestPath, pathRadius / 4);
         }
         return gTestPath;
     }
 
 
+    // the test path's flow field, or (when that is switched off) an empty one,
+    // with which path following maps every point with the path itself
+    const FlowField& getPathFlowField (void)
+    {
+        static const FlowField none;
+        return gUseFlowField ? gTestPathFlowField : none;
+    }
+
+
     // ----------------------------------------------------------------------------
     // OpenSteerDemo PlugIn
 
@@ -476,6 +600,9 @@ namespace {
 
         float selectionOrderSortKey (void) {return 0.02f;}
 
+        PedestrianPlugIn (void)
+            : pedestrianPool (64, MemoryAccount::vehicleMemory) {}
+
         virtual ~PedestrianPlugIn() {}// be more "nice" to avoid a compiler warning
 
         void open (void)
@@ -484,9 +611,15 @@ namespace {
             cyclePD = -1;
             nextPD ();
 
+            // Pedestrians query it at every update until staggered
+            // refresh is switched on
+            gNeighborRefresh.setSlices (1);
+
+            gCollisionAvoidanceLeadTime = gStandardCollisionAvoidanceLeadTime;
+
             // create the specified number of Pedestrians
             population = 0;
-            for (int i = 0; i < gPedestrianStartCount; i++) addPedestrianToCrowd ();
+            addPedestriansToCrowd (gPedestrianStartCount);
 
             // initialize camera and selectedVehicle
             Pedestrian& firstPedestrian = **crowd.begin();
@@ -498,13 +631,102 @@ namespace {
 
         void update (const float currentTime, const float elapsedTime)
         {
-            // update each Pedestrian
-            for (iterator i = crowd.begin(); i != crowd.end(); i++)
+            // between frames: let the proximity database do its upkeep
+            pd->maintain ();
+
+            // give up detail while over the frame time budget
+            scheduler.setBandScale (OpenSteerDemo::degradedBandScale ());
+            gNeighborRefresh.setMinimumSlices
+                (OpenSteerDemo::degradedNeighborSlices ());
+
+            // pick the Pedestrians to update this frame (all of them unless
+            // level of detail scheduling is on)
+            scheduler.clearFoci ();
+            scheduler.addFocus (OpenSteerDemo::cameraPosition ());
+            if (OpenSteerDemo::selectedVehicle)
+                scheduler.addFocus (OpenSteerDemo::selectedVehicle->position ());
+            scheduler.schedule (crowd, elapsedTime);
+            const std::vector<size_t>& due = scheduler.dueAgents ();
+
+            if (parallelUpdateIsOn ())
             {
-                (**i).update (currentTime, elapsedTime);
+                // phase one: every Pedestrian determines its steering from
+                // the crowd's state as of the previous frame, in parallel.
+                // Annotation is not thread-safe, so it is off meanwhile.
+                const bool annotation = annotationIsOn ();
+                setAnnotationOff ();
+                contexts.prepare (WorkerPool::shared());
+                ComputeSteering computeSteering (crowd, due, scheduler,
+                                                 contexts);
+                {
+                    PhaseTimer::Scope timer (PhaseTimer::steeringPhase);
+                    WorkerPool::shared().parallelFor (due.size(),
+                                                      computeSteering);
+                }
+                if (annotation) setAnnotationOn ();
+
+                // phase two: integrate, then update all proximity tokens in
+                // one batch
+                tokens.resize (due.size());
+                positions.resize (due.size());
+                for (size_t i = 0; i < due.size(); i++)
+                {
+                    Pedestrian& pedestrian = *crowd[due[i]];
+                    pedestrian.applySteering (currentTime,
+                                              scheduler.elapsedTime (due[i]));
+                    tokens[i] = pedestrian.proximityToken;
+                    positions[i] = pedestrian.position();
+                }
+                if (! due.empty())
+                    pd->updateForNewPositions (&tokens[0], &positions[0],
+                                               due.size(),
+                                               &WorkerPool::shared());
+            }
+            else
+            {
+                // update each Pedestrian
+                for (size_t i = 0; i < due.size(); i++)
+                {
+                    crowd[due[i]]->update (currentTime,
+                                           scheduler.elapsedTime (due[i]));
+                }
+            }
+
+            // Pedestrians at rest fall asleep (see toggleSleeping)
+            if (scheduler.sleepingIsOn ())
+            {
+                for (size_t i = 0; i < due.size(); i++)
+                {
+                    const Pedestrian& pedestrian = *crowd[due[i]];
+                    scheduler.noteActivity (due[i], pedestrian.speed (),
+                                            pedestrian.steering.length ());
+                }
             }
         }
 
+        // loop body for the parallel phase one of the two-phase update
+        class ComputeSteering
+        {
+        public:
+            ComputeSteering (Pedestrian::groupType& c,
+                             const std::vector<size_t>& d,
+                             const UpdateScheduler& s,
+                             SimulationContexts& x)
+                : crowd (c), due (d), scheduler (s), contexts (x) {}
+            void operator() (size_t begin, size_t end)
+            {
+                SimulationContext& context = contexts.forThisThread ();
+                for (size_t i = begin; i < end; i++)
+                    crowd[due[i]]->computeSteering (context,
+                                                   scheduler.elapsedTime (due[i]));
+            }
+        private:
+            Pedestrian::groupType& crowd;
+            const std::vector<size_t>& due;
+            const UpdateScheduler& scheduler;
+            SimulationContexts& contexts;
+        };
+
         void redraw (const float currentTime, const float elapsedTime)
         {
             // selected Pedestrian (user can mouse click to select another)
@@ -520,8 +742,27 @@ namespace {
             if (OpenSteerDemo::selectedVehicle) gridCenter = selected.position();
             OpenSteerDemo::gridUtility (gridCenter);
 
-            // draw and annotate each Pedestrian
-            for (iterator i = crowd.begin(); i != crowd.end(); i++) (**i).draw (); 
+            // draw and annotate each Pedestrian the camera may see (all
+            // bodies in one batch), found by querying the proximity database
+            // over the part of the ground plane (within the far clipping
+            // distance of the camera) inside the view frustum
+            visiblePedestrians.clear ();
+            if (! crowd.empty ())
+            {
+                const Camera& camera = OpenSteerDemo::camera;
+                const Vec3 reach (camera.farDistance, 0, camera.farDistance);
+                const Vec3 ground = camera.position().setYtoZero ();
+                camera.findVisibleVehicles (*crowd[0]->proximityToken,
+                                            ground - reach, ground + reach,
+                                            crowd[0]->radius (),
+                                            visiblePedestrians);
+            }
+            beginVehicleBatch ();
+            for (AVIterator i = visiblePedestrians.begin();
+                 i != visiblePedestrians.end();
+                 i++)
+                static_cast<Pedestrian*> (*i)->draw ();
+            drawVehicleBatch ();
 
             // draw the path they follow and obstacles they avoid
             drawPathAndObstacles ();
@@ -554,12 +795,15 @@ namespace {
 
             // display status in the upper left corner of the window
             std::ostringstream status;
-            status << "[F1/F2] Crowd size: " << population;
+            status << "[F1/F2] Crowd size: " << population
+                   << " (" << visiblePedestrians.size () << " in view)";
             status << "\n[F3] PD type: ";
             switch (cyclePD)
             {
             case 0: status << "LQ bin lattice"; break;
             case 1: status << "brute force";    break;
+            case 2: status << "flat array grid"; break;
+            case 3: status << "spatial hash";    break;
             }
             status << "\n[F4] ";
             if (gUseDirectedPathFollowing)
@@ -568,6 +812,25 @@ namespace {
                 status << "Stay on the path.";
             status << "\n[F5] Wander: ";
             if (gWanderSwitch) status << "yes"; else status << "no";
+            status << "\n[F6] Update: "
+                   << (parallelUpdateIsOn () ? "parallel two-phase" : "serial");
+            status << "\n[F7] Level of detail: ";
+            if (scheduler.bandCount () == 0)
+                status << "off";
+            else
+                status << scheduler.dueAgents().size() << " updated";
+            status << "\n[F8] Sleeping: ";
+            if (scheduler.sleepingIsOn ())
+                status << scheduler.sleepingCount () << " asleep";
+            else
+                status << "off";
+            status << "\n[F9] Neighbor refresh: ";
+            if (gNeighborRefresh.slices () > 1)
+                status << "every " << gNeighborRefresh.slices () << " updates";
+            else
+                status << "every update";
+            status << "\n[F10] Path flow field: ";
+            if (gUseFlowField) status << "on"; else status << "off";
             status << std::endl;
             const float h = drawGetWindowHeight ();
             const Vec3 screenLocation (10, h-50, 0);
@@ -575,6 +838,20 @@ namespace {
         }
 
 
+        void redrawSnapshot (const SimulationSnapshot& snapshot,
+                             const float /*currentTime*/,
+                             const float /*elapsedTime*/)
+        {
+            // ground plane under the selected Pedestrian, then the path and
+            // obstacles (which the update never changes)
+            const SimulationSnapshot::Vehicle* selected =
+                snapshot.selectedVehicle ();
+            if (selected) gridCenter = selected->position;
+            OpenSteerDemo::gridUtility (gridCenter);
+            drawPathAndObstacles ();
+        }
+
+
         void serialNumberAnnotationUtility (const AbstractVehicle& selected,
                                             const AbstractVehicle& nearMouse)
         {
@@ -641,13 +918,15 @@ namespace {
         void close (void)
         {
             // delete all Pedestrians
-           while (population > 0) removePedestrianFromCrowd ();
+            removePedestriansFromCrowd (population);
         }
 
         void reset (void)
         {
-            // reset each Pedestrian
-            for (iterator i = crowd.begin(); i != crowd.end(); i++) (**i).reset ();
+            // reset each Pedestrian in place, then update their proximity
+            // tokens in one batch
+            for (iterator i = crowd.begin(); i != crowd.end(); i++) (**i).resetState ();
+            placeInDatabase (0, crowd.size());
 
             // reset camera position
             OpenSteerDemo::position2dCamera (*OpenSteerDemo::selectedVehicle);
@@ -665,6 +944,11 @@ namespace {
             case 3:  nextPD ();                                             break;
             case 4: gUseDirectedPathFollowing = !gUseDirectedPathFollowing; break;
             case 5: gWanderSwitch = !gWanderSwitch;                         break;
+            case 6: toggleParallelUpdateState ();                           break;
+            case 7: toggleLevelOfDetail ();                                 break;
+            case 8: toggleSleeping ();                                      break;
+            case 9: nextRefreshSlices ();                                   break;
+            case 10: gUseFlowField = !gUseFlowField;                        break;
             }
         }
 
@@ -680,35 +964,301 @@ namespace {
             OpenSteerDemo::printMessage ("  F3     use next proximity database.");
             OpenSteerDemo::printMessage ("  F4     toggle directed path follow.");
             OpenSteerDemo::printMessage ("  F5     toggle wander component on/off.");
+            OpenSteerDemo::printMessage ("  F6     toggle parallel two-phase update.");
+            OpenSteerDemo::printMessage ("  F7     toggle level of detail update scheduling.");
+            OpenSteerDemo::printMessage ("  F8     toggle sleeping of Pedestrians at rest.");
+            OpenSteerDemo::printMessage ("  F9     next staggered neighbor refresh interval.");
+            OpenSteerDemo::printMessage ("  F10    toggle flow field path following.");
             OpenSteerDemo::printMessage ("");
         }
 
 
+        // level of detail: Pedestrians far from the camera and the
+        // selected one are updated every second or fourth frame, none of
+        // them less than ten times a second
+        void toggleLevelOfDetail (void)
+        {
+            if (scheduler.bandCount () == 0)
+            {
+                scheduler.addBand (15, 1);
+                scheduler.addBand (30, 2);
+                scheduler.addBand (std::numeric_limits<float>::max(), 4);
+                scheduler.setMaxStaleness (0.1f);
+            }
+            else
+            {
+                scheduler.clearBands ();
+            }
+        }
+
+
+        // sleeping: a Pedestrian nearly still and barely steering for a
+        // second of updates is not updated again until another Pedestrian
+        // on the move comes within a few meters
+        void toggleSleeping (void)
+        {
+            if (scheduler.sleepingIsOn ())
+                scheduler.setSleeping (0, 0, 0, 0);
+            else
+                scheduler.setSleeping (0.05f, 0.05f, 60, 3);
+        }
+
+
+        // staggered neighbor refresh: Pedestrians query the proximity
+        // database at every update, or at every 2nd, 4th or 8th one
+        void nextRefreshSlices (void)
+        {
+            const size_t n = gNeighborRefresh.slices ();
+            gNeighborRefresh.setSlices ((n >= 8) ? 1 : n * 2);
+        }
+
+
         void addPedestrianToCrowd (void)
         {
-            population++;
-            Pedestrian* pedestrian = new Pedestrian (*pd);
-            crowd.push_back (pedestrian);
-            if (population == 1) OpenSteerDemo::selectedVehicle = pedestrian;
+            addPedestriansToCrowd (1);
         }
 
 
         void removePedestrianFromCrowd (void)
         {
-            if (population > 0)
+            removePedestriansFromCrowd (1);
+        }
+
+
+        // add count Pedestrians at once: their storage comes from the pool
+        // (in one chunk) and their tokens get their positions in one batch
+        void addPedestriansToCrowd (const int count)
+        {
+            if (count <= 0) return;
+            pedestrianPool.reserve (count);
+            pd->reserveTokens (count);
+            const size_t first = crowd.size();
+            crowd.reserve (first + count);
+            for (int i = 0; i < count; i++)
+                crowd.push_back (new (pedestrianPool) Pedestrian (*pd, contexts));
+            population += count;
+            if (first == 0) OpenSteerDemo::selectedVehicle = crowd[0];
+            placeInDatabase (first, crowd.size());
+        }
+
+
+        // remove the last count Pedestrians (at most the whole crowd) at once
+        void removePedestriansFromCrowd (int count)
+        {
+            if (count > population) count = population;
+            for (int i = 0; i < count; i++)
             {
                 // save pointer to last pedestrian, then remove it from the crowd
                 const Pedestrian* pedestrian = crowd.back();
                 crowd.pop_back();
-                population--;
 
                 // if it is OpenSteerDemo's selected vehicle, unselect it
                 if (pedestrian == OpenSteerDemo::selectedVehicle)
                     OpenSteerDemo::selectedVehicle = NULL;
 
-                // delete the Pedestrian
+                // delete the Pedestrian (its storage goes back to the pool)
                 delete pedestrian;
             }
+            population -= count;
+            gNeighborRefresh.invalidate ();
+        }
+
+
+        // notify the proximity database of the positions of the
+        // Pedestrians in [begin, end) of the crowd, in one batch
+        void placeInDatabase (const size_t begin, const size_t end)
+        {
+            gNeighborRefresh.invalidate ();
+            const size_t count = end - begin;
+            if (count == 0) return;
+            tokens.resize (count);
+            positions.resize (count);
+            for (size_t i = 0; i < count; i++)
+            {
+                tokens[i] = crowd[begin + i]->proximityToken;
+                positions[i] = crowd[begin + i]->position();
+            }
+            pd->updateForNewPositions (&tokens[0], &positions[0], count,
+                                       &WorkerPool::shared());
+        }
+
+        // the same for the Pedestrians with the given indices, in that order
+        void placeInDatabase (const std::vector<size_t>& order)
+        {
+            gNeighborRefresh.invalidate ();
+            const size_t count = order.size();
+            if (count == 0) return;
+            tokens.resize (count);
+            positions.resize (count);
+            for (size_t i = 0; i < count; i++)
+            {
+                tokens[i] = crowd[order[i]]->proximityToken;
+                positions[i] = crowd[order[i]]->position();
+            }
+            pd->updateForNewPositions (&tokens[0], &positions[0], count,
+                                       &WorkerPool::shared());
+        }
+
+
+        // neighbors per Pedestrian found by their latest searches, for the
+        // profiler display of OpenSteerDemo
+        bool neighborStatistics (int& minNeighbors, int& maxNeighbors,
+                                 float& averageNeighbors)
+        {
+            if (crowd.empty()) return false;
+            size_t total = 0;
+            minNeighbors = maxNeighbors = (int) crowd[0]->neighborCount;
+            for (iterator i = crowd.begin(); i != crowd.end(); i++)
+            {
+                const int count = (int) (**i).neighborCount;
+                if (minNeighbors > count) minNeighbors = count;
+                if (maxNeighbors < count) maxNeighbors = count;
+                total += count;
+            }
+            averageNeighbors = ((float) total) / ((float) crowd.size());
+            return true;
+        }
+
+
+        // add or remove pedestrians until the crowd has the given size
+        bool setPopulation (int count)
+        {
+            if (population < count) addPedestriansToCrowd (count - population);
+            if (population > count) removePedestriansFromCrowd (population - count);
+            return true;
+        }
+
+
+        // set a parameter by name: caLeadTime, the collision avoidance
+        // lead time in seconds
+        bool setParameter (const char* name, const float value)
+        {
+            if (strcmp (name, "caLeadTime") != 0) return false;
+            gCollisionAvoidanceLeadTime = value;
+            return true;
+        }
+
+
+        // save the crowd, its settings, path and obstacles
+        bool saveCheckpoint (CheckpointWriter& checkpoint)
+        {
+            const PolylineSegmentedPathwaySingleRadius& path = *getTestPath ();
+            CrowdSettings settings;
+            settings.proximityDatabase = cyclePD;
+            settings.directedPathFollowing = gUseDirectedPathFollowing;
+            settings.wander = gWanderSwitch;
+            settings.levelOfDetail = (scheduler.bandCount () > 0);
+            settings.pathRadius = path.radius ();
+            settings.pathIsCyclic = path.isCyclic ();
+            checkpoint.addRecord (crowdSettingsTag, settings);
+
+            // a cyclic path repeats its first point at the end
+            std::vector<Vec3> points;
+            const size_t pointCount =
+                path.pointCount () - (path.isCyclic () ? 1 : 0);
+            for (size_t i = 0; i < pointCount; i++)
+                points.push_back (path.point (i));
+            checkpoint.addArray (pathPointsTag, &points[0], points.size ());
+
+            const SphereObstacle* spheres[] = {&gObstacle1, &gObstacle2};
+            CheckpointSphere obstacles[2];
+            for (int i = 0; i < 2; i++)
+            {
+                obstacles[i].center = spheres[i]->center;
+                obstacles[i].radius = spheres[i]->radius;
+                obstacles[i].seenFrom = spheres[i]->seenFrom ();
+            }
+            checkpoint.addArray (obstaclesTag, obstacles, 2);
+
+            std::vector<PathFollowing> following (crowd.size ());
+            for (size_t i = 0; i < crowd.size (); i++)
+            {
+                following[i].pathDirection = crowd[i]->pathDirection;
+                following[i].hasSegment = crowd[i]->pathCursor.valid ();
+                following[i].segmentIndex = crowd[i]->pathCursor.segmentIndex ();
+            }
+            checkpoint.addArray (pathFollowingTag,
+                                 following.empty () ? 0 : &following[0],
+                                 following.size ());
+            checkpoint.addVehicles (pedestriansTag, crowd);
+            checkpoint.addProximityDatabase (databaseStateTag,
+                                             placementOrderTag, *pd, crowd);
+            return true;
+        }
+
+        // resize the crowd to the saved one and restore each Pedestrian in
+        // place, then place them all in a new proximity database in one batch
+        bool loadCheckpoint (const CheckpointReader& checkpoint)
+        {
+            CrowdSettings settings;
+            ProximityDatabaseState databaseState;
+            std::vector<size_t> order;
+            size_t count, followingCount, pointCount, obstacleCount;
+            const PathFollowing* following =
+                checkpoint.array<PathFollowing> (pathFollowingTag, followingCount);
+            const Vec3* points =
+                checkpoint.array<Vec3> (pathPointsTag, pointCount);
+            const CheckpointSphere* obstacles =
+                checkpoint.array<CheckpointSphere> (obstaclesTag, obstacleCount);
+            if (! checkpoint.record (crowdSettingsTag, settings) ||
+                ! checkpoint.array<CheckpointVehicle> (pedestriansTag, count) ||
+                ! checkpoint.proximityDatabase (databaseStateTag,
+                                                placementOrderTag, count,
+                                                databaseState, order) ||
+                ! following || (followingCount != count) ||
+                ! points || (pointCount < 2) ||
+                ! obstacles || (obstacleCount != 2) ||
+                (settings.proximityDatabase < 0) ||
+                (settings.proximityDatabase >= totalPD))
+                return false;
+
+            // the path, and the segments the Pedestrians were last found on
+            const size_t segmentCount =
+                pointCount - (settings.pathIsCyclic ? 0 : 1);
+            for (size_t i = 0; i < count; i++)
+                if (following[i].hasSegment &&
+                    (following[i].segmentIndex >= segmentCount))
+                    return false;
+            PolylineSegmentedPathwaySingleRadius& path = *getTestPath ();
+            path.setPathway (pointCount, points, settings.pathRadius,
+                             settings.pathIsCyclic != 0);
+            gEndpoint0 = points[0];
+            gEndpoint1 = points[pointCount - 1];
+
+            SphereObstacle* spheres[] = {&gObstacle1, &gObstacle2};
+            for (int i = 0; i < 2; i++)
+            {
+                spheres[i]->center = obstacles[i].center;
+                spheres[i]->radius = obstacles[i].radius;
+                spheres[i]->setSeenFrom ((Obstacle::seenFromState)
+                                         obstacles[i].seenFrom);
+            }
+
+            gUseDirectedPathFollowing = (settings.directedPathFollowing != 0);
+            gWanderSwitch = (settings.wander != 0);
+            if ((scheduler.bandCount () > 0) != (settings.levelOfDetail != 0))
+                toggleLevelOfDetail ();
+
+            setPopulation ((int) count);
+            checkpoint.restoreVehicles (pedestriansTag, crowd);
+            for (size_t i = 0; i < count; i++)
+            {
+                Pedestrian& pedestrian = *crowd[i];
+                pedestrian.pathDirection = following[i].pathDirection;
+                pedestrian.pathCursor.reset ();
+                if (following[i].hasSegment)
+                    pedestrian.pathCursor.setSegmentIndex
+                        ((size_t) following[i].segmentIndex);
+                pedestrian.clearTrailHistory ();
+            }
+
+            // a new database (whose tokens have no positions yet) in the
+            // saved state
+            cyclePD = settings.proximityDatabase - 1;
+            nextPD ();
+            pd->restoreState (databaseState);
+            placeInDatabase (order);
+            return true;
         }
 
 
@@ -721,7 +1271,6 @@ namespace {
             ProximityDatabase* oldPD = pd;
 
             // allocate new PD
-            const int totalPD = 2;
             switch (cyclePD = (cyclePD + 1) % totalPD)
             {
             case 0:
@@ -732,7 +1281,9 @@ namespace {
                     const float diameter = 80.0f; //XXX need better way to get this
                     const Vec3 dimensions (diameter, diameter, diameter);
                     typedef LQProximityDatabase<AbstractVehicle*> LQPDAV;
-                    pd = new LQPDAV (center, dimensions, divisions);
+                    LQPDAV* lqpd = new LQPDAV (center, dimensions, divisions);
+                    lqpd->setAdaptive (true);
+                    pd = lqpd;
                     break;
                 }
             case 1:
@@ -740,10 +1291,31 @@ namespace {
                     pd = new BruteForceProximityDatabase<AbstractVehicle*> ();
                     break;
                 }
+            case 2:
+                {
+                    const Vec3 center;
+                    const float div = 20.0f;
+                    const Vec3 divisions (div, 1.0f, div);
+                    const float diameter = 80.0f; //XXX need better way to get this
+                    const Vec3 dimensions (diameter, diameter, diameter);
+                    typedef GridProximityDatabase<AbstractVehicle*> GridPDAV;
+                    pd = new GridPDAV (center, dimensions, divisions);
+                    break;
+                }
+            case 3:
+                {
+                    // the same cells as the grids above, but unbounded
+                    const Vec3 cellSize (4.0f, 80.0f, 4.0f);
+                    typedef SpatialHashProximityDatabase<AbstractVehicle*> HashPDAV;
+                    pd = new HashPDAV (cellSize);
+                    break;
+                }
             }
 
             // switch each boid to new PD
+            pd->reserveTokens (crowd.size());
             for (iterator i=crowd.begin(); i!=crowd.end(); i++) (**i).newPD(*pd);
+            gNeighborRefresh.invalidate ();
 
             // delete old PD (if any)
             delete oldPD;
@@ -756,15 +1328,34 @@ namespace {
         Pedestrian::groupType crowd;
         typedef Pedestrian::groupType::const_iterator iterator;
 
+        // the Pedestrians drawn by the last redraw: those the camera may see
+        AVGroup visiblePedestrians;
+
         Vec3 gridCenter;
 
         // pointer to database used to accelerate proximity queries
         ProximityDatabase* pd;
 
+        // per thread neighbor vectors for the crowd's updates
+        SimulationContexts contexts;
+
+        // storage of the Pedestrians of the crowd
+        ObjectPool<Pedestrian> pedestrianPool;
+
+        // tokens and new positions for the batch updates of the parallel
+        // phase two and of new or reset Pedestrians, kept to reuse their
+        // storage between frames
+        std::vector<ProximityToken*> tokens;
+        std::vector<Vec3> positions;
+
+        // which Pedestrians to update each frame
+        UpdateScheduler scheduler;
+
         // keep track of current flock size
         int population;
 
         // which of the various proximity databases is currently in use
+        static const int totalPD = 4;
         int cyclePD;
     };
 
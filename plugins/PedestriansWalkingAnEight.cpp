@@ -40,9 +40,12 @@
 #include <iomanip>
 #include <sstream>
 #include "OpenSteer/PolylineSegmentedPathwaySingleRadius.h"
-#include "OpenSteer/SimpleVehicle.h"
+#include "OpenSteer/FlowField.h"
+#include "OpenSteer/PlanarVehicle.h"
 #include "OpenSteer/OpenSteerDemo.h"
+#include "OpenSteer/PhaseTimer.h"
 #include "OpenSteer/Proximity.h"
+#include "OpenSteer/SimulationContext.h"
 #include "OpenSteer/Color.h"
 
 namespace {
@@ -69,6 +72,10 @@ namespace {
     Vec3 gEndpoint0;
     Vec3 gEndpoint1;
     bool gUseDirectedPathFollowing = true;
+    // the test path mapped to a grid, shared by all path following
+    FlowField gTestPathFlowField;
+    bool gUseFlowField = true;
+    const FlowField& getPathFlowField (void);
     
     // this was added for debugging tool, but I might as well leave it in
     bool gWanderSwitch = true;
@@ -77,7 +84,7 @@ namespace {
     // ----------------------------------------------------------------------------
     
     
-    class Pedestrian : public SimpleVehicle
+    class Pedestrian : public PlanarVehicle
     {
 public:
         
@@ -85,7 +92,8 @@ public:
         typedef std::vector<Pedestrian*> groupType;
         
         // constructor
-        Pedestrian (ProximityDatabase& pd)
+        Pedestrian (ProximityDatabase& pd, SimulationContexts& c)
+            : contexts (c)
         {
             // allocate a token for this boid in the proximity database
             proximityToken = NULL;
@@ -120,10 +128,11 @@ public:
             
             // set the path for this Pedestrian to follow
             path = getTestPath ();
+            pathCursor.reset ();
             
             // set initial position
             // (random point on path + random horizontal offset)
-            const float d = path->length() * frandom01();
+            const float d = path->length() * randomStream().frandom01 ();
             const float r = path->radius();
             const Vec3 randomOffset = randomVectorOnUnitRadiusXZDisk () * r;
             setPosition (path->mapPathDistanceToPoint (d) + randomOffset);
@@ -132,7 +141,7 @@ public:
             randomizeHeadingOnXZPlane ();
             
             // pick a random direction for path following (upstream or downstream)
-            pathDirection = (frandom01() > 0.5) ? -1 : +1;
+            pathDirection = (randomStream().frandom01 () > 0.5) ? -1 : +1;
             
             // trail parameters: 3 seconds with 60 points along the trail
             setTrailParameters (3, 60);
@@ -145,7 +154,8 @@ public:
         void update (const float currentTime, const float elapsedTime)
         {
             // apply steering force to our momentum
-            applySteeringForce (determineCombinedSteering (elapsedTime),
+            applySteeringForce (determineCombinedSteering (contexts.forThisThread (),
+                                                           elapsedTime),
                                 elapsedTime);
             
             // reverse direction when we reach an endpoint
@@ -176,8 +186,11 @@ public:
         
         // compute combined steering force: move forward, avoid obstacles
         // or neighbors if needed, otherwise follow the path and wander
-        Vec3 determineCombinedSteering (const float elapsedTime)
+        Vec3 determineCombinedSteering (SimulationContext& context,
+                                        const float elapsedTime)
         {
+            PhaseTimer::Scope timer (PhaseTimer::steeringPhase);
+
             // move forward
             Vec3 steeringForce = forward();
             
@@ -188,7 +201,7 @@ public:
             
             // determine if obstacle avoidance is required
             Vec3 obstacleAvoidance;
-            if (leakThrough < frandom01())
+            if (leakThrough < randomStream().frandom01 ())
             {
                 const float oTime = 6; // minTimeToCollision = 6 seconds
                                        // ------------------------------------ xxxcwr11-1-04 fixing steerToAvoid
@@ -215,12 +228,13 @@ public:
                 // (radius is largest distance between vehicles traveling head-on
                 // where a collision is possible within caLeadTime seconds.)
                 const float maxRadius = caLeadTime * maxSpeed() * 2;
+                AVGroup& neighbors = context.neighbors;
                 neighbors.clear();
                 proximityToken->findNeighbors (position(), maxRadius, neighbors);
                 
-                if (leakThrough < frandom01())
+                if (leakThrough < randomStream().frandom01 ())
                     collisionAvoidance =
-                        steerToAvoidNeighbors (caLeadTime, neighbors) * 10;
+                        steerToAvoidNeighbors<Pedestrian> (caLeadTime, neighbors) * 10;
                 
                 // if collision avoidance is needed, do it
                 if (collisionAvoidance != Vec3::zero)
@@ -237,16 +251,18 @@ public:
                     const float pfLeadTime = 3;
                     const Vec3 pathFollow =
                         (gUseDirectedPathFollowing ?
-                         steerToFollowPath (pathDirection, pfLeadTime, *path) :
-                         steerToStayOnPath (pfLeadTime, *path));
+                         steerToFollowPath (pathDirection, pfLeadTime, *path,
+                                            getPathFlowField (), pathCursor) :
+                         steerToStayOnPath (pfLeadTime, *path,
+                                            getPathFlowField (), pathCursor));
                     
                     // add in to steeringForce
                     steeringForce += pathFollow * 0.5;
                 }
             }
             
-            // return steering constrained to global XZ "ground" plane
-            return steeringForce.setYtoZero ();
+            // (PlanarVehicle constrains it to the global XZ "ground" plane)
+            return steeringForce;
         }
         
         
@@ -296,7 +312,9 @@ public:
             const Color color = headOn ? red : green;
             const char* string = headOn ? "OUCH!" : "pardon me";
             const Vec3 location = position() + Vec3 (0, 0.5f, 0);
-            if (OpenSteer::annotationIsOn())
+            // (text is drawn right away, so only while drawing: there may be
+            // no graphics context during an update)
+            if (OpenSteer::annotationIsOn() && OpenSteer::drawPhaseActive)
                 draw2dTextAt3dLocation (*string, location, color, drawGetWindowWidth(), drawGetWindowHeight());
                                          }
                                          
@@ -347,9 +365,8 @@ public:
                                          // a pointer to this boid's interface object for the proximity database
                                          ProximityToken* proximityToken;
                                          
-                                         // allocate one and share amoung instances just to save memory usage
-                                         // (change to per-instance allocation to be more MP-safe)
-                                         static AVGroup neighbors;
+                                         // the crowd's per thread simulation contexts
+                                         SimulationContexts& contexts;
                                          
                                          // path to be followed by this pedestrian
                                          // XXX Ideally this should be a generic Pathway, but we use the
@@ -358,13 +375,14 @@ public:
                                          // XXX there be a "random position inside path" method on Pathway?
                                          PolylineSegmentedPathwaySingleRadius* path;
                                          
+                                         // where on the path the last path queries found this pedestrian
+                                         PathCursor pathCursor;
+                                         
                                          // direction for path following (upstream or downstream)
                                          int pathDirection;
     };
 
 
-AVGroup Pedestrian::neighbors;
-
 
 
 /**
@@ -409,11 +427,22 @@ PolylineSegmentedPathwaySingleRadius* getTestPath (void)
                                                               pathPoints,
                                                               pathRadius,
                                                               false);
+        gTestPath->setSegmentIndexEnabled (true);
+        gTestPathFlowField.build (*gTestPath, pathRadius / 4);
     }
     return gTestPath;
 }
 
 
+// the test path's flow field, or (when that is switched off) an empty one,
+// with which path following maps every point with the path itself
+const FlowField& getPathFlowField (void)
+{
+    static const FlowField none;
+    return gUseFlowField ? gTestPathFlowField : none;
+}
+
+
 // ----------------------------------------------------------------------------
 // OpenSteerDemo PlugIn
 
@@ -518,6 +547,8 @@ public:
             status << "Stay on the path.";
         status << "\n[F5] Wander: ";
         if (gWanderSwitch) status << "yes"; else status << "no";
+        status << "\n[F6] Path flow field: ";
+        if (gUseFlowField) status << "on"; else status << "off";
         status << std::endl;
         const float h = drawGetWindowHeight ();
         const Vec3 screenLocation (10, h-50, 0);
@@ -594,6 +625,7 @@ public:
             case 3:  nextPD ();                                             break;
             case 4: gUseDirectedPathFollowing = !gUseDirectedPathFollowing; break;
             case 5: gWanderSwitch = !gWanderSwitch;                         break;
+            case 6: gUseFlowField = !gUseFlowField;                         break;
         }
     }
     
@@ -609,6 +641,7 @@ public:
         OpenSteerDemo::printMessage ("  F3     use next proximity database.");
         OpenSteerDemo::printMessage ("  F4     toggle directed path follow.");
         OpenSteerDemo::printMessage ("  F5     toggle wander component on/off.");
+        OpenSteerDemo::printMessage ("  F6     toggle flow field path following.");
         OpenSteerDemo::printMessage ("");
     }
     
@@ -616,7 +649,7 @@ public:
     void addPedestrianToCrowd (void)
     {
         population++;
-        Pedestrian* pedestrian = new Pedestrian (*pd);
+        Pedestrian* pedestrian = new Pedestrian (*pd, contexts);
         crowd.push_back (pedestrian);
         if (population == 1) OpenSteerDemo::selectedVehicle = pedestrian;
     }
@@ -672,6 +705,7 @@ public:
         }
         
         // switch each boid to new PD
+        pd->reserveTokens (crowd.size());
         for (iterator i=crowd.begin(); i!=crowd.end(); i++) (**i).newPD(*pd);
         
         // delete old PD (if any)
@@ -690,6 +724,9 @@ public:
     // pointer to database used to accelerate proximity queries
     ProximityDatabase* pd;
     
+    // per thread neighbor vectors for the crowd's updates
+    SimulationContexts contexts;
+    
     // keep track of current flock size
     int population;
     
@@ -40,8 +40,10 @@
 
 #include <iomanip>
 #include <sstream>
-#include "OpenSteer/SimpleVehicle.h"
+#include "OpenSteer/PlanarVehicle.h"
+#include "OpenSteer/ContactBroadphase.h"
 #include "OpenSteer/OpenSteerDemo.h"
+#include "OpenSteer/PhaseTimer.h"
 #include "OpenSteer/Draw.h"
 #include "OpenSteer/Color.h"
 #include "OpenSteer/UnusedParameter.h"
@@ -89,7 +91,7 @@ namespace {
     };
 
     // The ball object
-    class Ball : public SimpleVehicle{
+    class Ball : public PlanarVehicle{
     public:
         Ball(AABBox *bbox) : m_bbox(bbox) {reset();}
 
@@ -109,6 +111,8 @@ namespace {
         // per frame simulation update
         void update (const float currentTime, const float elapsedTime)
         {
+            PhaseTimer::Scope timer (PhaseTimer::steeringPhase);
+
             applyBrakingForce(1.5f, elapsedTime);
             applySteeringForce(velocity(), elapsedTime);
             // are we now outside the field?
@@ -144,12 +148,12 @@ namespace {
         AABBox *m_bbox;
     };
 
-    class Player : public SimpleVehicle
+    class Player : public PlanarVehicle
     {
     public:
 
         // constructor
-        Player (std::vector<Player*> others, std::vector<Player*> allplayers, Ball* ball, bool isTeamA, int id) : m_others(others), m_AllPlayers(allplayers), m_Ball(ball), b_ImTeamA(isTeamA), m_MyID(id) {reset ();}
+        Player (std::vector<Player*> others, std::vector<Player*> allplayers, Ball* ball, bool isTeamA, int id) : m_others(others), m_AllPlayers(allplayers), m_Ball(ball), b_ImTeamA(isTeamA), m_MyID(id), m_TouchingBall(false) {reset ();}
 
         // reset state
         void reset (void)
@@ -160,7 +164,7 @@ namespace {
             setMaxSpeed (10);         // velocity is clipped to this magnitude
 
             // Place me on my part of the field, looking at oponnents goal
-            setPosition(b_ImTeamA ? frandom01()*20 : -frandom01()*20, 0, (frandom01()-0.5f)*20);
+            setPosition(b_ImTeamA ? randomStream().frandom01()*20 : -randomStream().frandom01()*20, 0, (randomStream().frandom01()-0.5f)*20);
             if(m_MyID < 9)
                 {
                 if(b_ImTeamA)
@@ -177,11 +181,11 @@ namespace {
         // (parameter names commented out to prevent compiler warning from "-W")
         void update (const float /*currentTime*/, const float elapsedTime)
         {
-            // if I hit the ball, kick it.
+            PhaseTimer::Scope timer (PhaseTimer::steeringPhase);
+
+            // if I hit the ball (found by the PlugIn's contacts), kick it.
 
-            const float distToBall = Vec3::distance (position(), m_Ball->position());
-            const float sumOfRadii = radius() + m_Ball->radius();
-            if (distToBall < sumOfRadii)
+            if (m_TouchingBall)
                 m_Ball->kick((m_Ball->position()-position())*50, elapsedTime);
 
 
@@ -236,6 +240,7 @@ namespace {
         bool	b_ImTeamA;
         int		m_MyID;
         Vec3		m_home;
+        bool	m_TouchingBall;
     };
 
 
@@ -290,10 +295,34 @@ namespace {
             OpenSteerDemo::camera.mode = Camera::cmFixed;
             m_redScore = 0;
             m_blueScore = 0;
+            // everything that can touch: the players and the ball
+            m_ContactGroup.assign (m_AllPlayers.begin(), m_AllPlayers.end());
+            m_ContactGroup.push_back (m_Ball);
+            m_Contacts.clear ();
+        }
+
+        // collision response: a player in contact with the ball kicks it
+        // in its update (the contact group holds only the players and the
+        // ball, so the ball's partner in a contact is a player)
+        static void touchBall (const ContactBroadphase::Contact& contact,
+                               void* clientQueryState)
+        {
+            const Ball* ball = static_cast<const Ball*> (clientQueryState);
+            AbstractVehicle* player = NULL;
+            if (contact.other == ball) player = contact.vehicle;
+            else if (contact.vehicle == ball) player = contact.other;
+            if (player) static_cast<Player*> (player)->m_TouchingBall = true;
         }
 
         void update (const float currentTime, const float elapsedTime)
         {
+            // find contacts (the ball is last in the group, so always the
+            // "other" vehicle of its contacts) before anyone moves
+            for(unsigned int i=0; i < m_AllPlayers.size() ; i++)
+                m_AllPlayers[i]->m_TouchingBall = false;
+            m_Contacts.update (m_ContactGroup);
+            m_Contacts.forEachContact (touchBall, m_Ball);
+
             // update simulation of test vehicle
             for(unsigned int i=0; i < m_PlayerCountA ; i++)
                 TeamA[i]->update (currentTime, elapsedTime);
@@ -335,6 +364,11 @@ namespace {
                 annote << "Blue: "<< m_blueScore;
                 draw2dTextAt3dLocation (annote, Vec3(-23,0,0), Color(0.7f,0.7f,1.0f), drawGetWindowWidth(), drawGetWindowHeight());
             }
+            {
+                std::ostringstream annote;
+                annote << "Contacts: "<< m_Contacts.contactCount();
+                draw2dTextAt3dLocation (annote, Vec3(0,0,12), Color(1.0f,1.0f,0.7f), drawGetWindowWidth(), drawGetWindowHeight());
+            }
 
             // textual annotation (following the test vehicle's screen position)
     if(0)
@@ -362,6 +396,8 @@ namespace {
                 delete TeamB[i];
             TeamB.clear ();
                     m_AllPlayers.clear();
+            m_ContactGroup.clear ();
+            m_Contacts.clear ();
         }
 
         void reset (void)
@@ -381,6 +417,8 @@ namespace {
         std::vector<Player*> TeamA;
         std::vector<Player*> TeamB;
         std::vector<Player*> m_AllPlayers;
+        AVGroup	m_ContactGroup;
+        ContactBroadphase	m_Contacts;
 
         Ball	*m_Ball;
         AABBox	*m_bbox;
@@ -0,0 +1,180 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Annotation
+//
+// Storage for the global annotation switches declared in Annotation.h.  They
+// live in the core library (rather than in OpenSteerDemo.cpp) so that hosts
+// which link OpenSteer without the OpenSteerDemo application, such as the
+// headless runner, still resolve them.  Also the TrailPool which holds the
+// vehicles' trails.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/Annotation.h"
+#include <limits>
+
+
+// ----------------------------------------------------------------------------
+// graphical annotation: master on/off switch
+
+
+bool OpenSteer::enableAnnotation = true;
+
+
+// ----------------------------------------------------------------------------
+// true while the host application is in its draw phase, in which case
+// annotation is drawn immediately rather than deferred.  Kept per thread so
+// a simulation thread's annotation stays deferred while the display draws.
+
+
+thread_local bool OpenSteer::drawPhaseActive = false;
+
+
+// ----------------------------------------------------------------------------
+// by default every drawn vehicle gets a trail, up to a budget of rings
+
+
+OpenSteer::TrailPool::TrailPool (void)
+    : inUse (0),
+      budget (1000),
+      idleFrames (30),
+      frame (0),
+      focusPosition (Vec3::zero),
+      focusRadius (std::numeric_limits<float>::max ()),
+      focusVehicle (NULL)
+{
+}
+
+
+OpenSteer::TrailPool::~TrailPool (void)
+{
+    for (size_t i = 0; i < rings.size (); i++) delete rings[i];
+}
+
+
+OpenSteer::TrailPool&
+OpenSteer::TrailPool::shared (void)
+{
+    static TrailPool* pool = new TrailPool;
+    return *pool;
+}
+
+
+// ----------------------------------------------------------------------------
+// start a frame: a ring its vehicle has not drawn for idleFrames frames is
+// taken back (its vehicle sees the new generation and stops using it)
+
+
+void
+OpenSteer::TrailPool::beginFrame (void)
+{
+    frame++;
+    for (size_t i = 0; i < rings.size (); i++)
+    {
+        Ring& ring = *rings[i];
+        if (ring.inUse && (frame - ring.lastDrawn > idleFrames)) release (&ring);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void
+OpenSteer::TrailPool::setFocus (const Vec3& position,
+                                const float radius,
+                                const void* vehicle)
+{
+    focusPosition = position;
+    focusRadius = radius;
+    focusVehicle = vehicle;
+}
+
+
+bool
+OpenSteer::TrailPool::wantsTrail (const void* vehicle,
+                                  const Vec3& position,
+                                  const bool optIn) const
+{
+    if (optIn || isFocus (vehicle)) return true;
+    if (focusRadius == std::numeric_limits<float>::max ()) return true;
+    return (position - focusPosition).lengthSquared () <
+           focusRadius * focusRadius;
+}
+
+
+// ----------------------------------------------------------------------------
+// hand out a free ring (or a new one), grown to vertexCount
+
+
+OpenSteer::TrailPool::Ring*
+OpenSteer::TrailPool::acquire (const int vertexCount, const bool priority)
+{
+    if (! priority && (inUse >= budget)) return NULL;
+
+    Ring* ring;
+    if (freeRings.empty ())
+    {
+        ring = new Ring;
+        rings.push_back (ring);
+    }
+    else
+    {
+        ring = freeRings.back ();
+        freeRings.pop_back ();
+    }
+
+    if (ring->capacity < vertexCount)
+    {
+        ring->vertices.resize (vertexCount);
+        ring->flags.resize (vertexCount);
+        ring->capacity = vertexCount;
+    }
+    ring->inUse = true;
+    ring->lastDrawn = frame;
+    inUse++;
+    return ring;
+}
+
+
+void
+OpenSteer::TrailPool::release (Ring* ring)
+{
+    if (! ring->inUse) return;
+    ring->inUse = false;
+    ring->generation++;
+    freeRings.push_back (ring);
+    inUse--;
+}
+
+
+// ----------------------------------------------------------------------------
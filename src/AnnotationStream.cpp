@@ -0,0 +1,448 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// AnnotationStream
+//
+// See AnnotationStream.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/AnnotationStream.h"
+
+#include <cstring>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+
+    // start of every stream, followed by nameLength bytes of PlugIn name
+    struct StreamHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t nameLength;
+    };
+
+    const char streamMagic[8] = {'O', 'S', 'T', 'E', 'E', 'R', 'A', 'S'};
+    const uint32_t byteOrderMark = 0x01020304;
+
+    // longest PlugIn name a reader accepts
+    const uint32_t maxNameLength = 4096;
+
+    typedef SimulationSnapshot::Vehicle StreamVehicle;
+
+
+    uint8_t colorByte (const float component)
+    {
+        if (component <= 0) return 0;
+        if (component >= 1) return 255;
+        return (uint8_t) (component * 255 + 0.5f);
+    }
+
+
+    void packColor (const Color& color, uint8_t* bytes)
+    {
+        bytes[0] = colorByte (color.r ());
+        bytes[1] = colorByte (color.g ());
+        bytes[2] = colorByte (color.b ());
+        bytes[3] = colorByte (color.a ());
+    }
+
+
+    Color unpackColor (const uint8_t* bytes)
+    {
+        return Color (bytes[0] / 255.0f, bytes[1] / 255.0f,
+                      bytes[2] / 255.0f, bytes[3] / 255.0f);
+    }
+
+
+    // append a record's bytes to a frame
+    template <class Record>
+    void append (std::vector<unsigned char>& bytes, const Record& record)
+    {
+        const size_t at = bytes.size ();
+        bytes.resize (at + sizeof (Record));
+        memcpy (&bytes[at], &record, sizeof (Record));
+    }
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::AnnotationStreamWriter::AnnotationStreamWriter (void)
+    : file (0),
+      stopping (false),
+      writeFailed (false),
+      queuedBytes (0),
+      queueLimit (64 << 20),
+      frames (0),
+      droppedFrames (0)
+{
+}
+
+
+OpenSteer::AnnotationStreamWriter::~AnnotationStreamWriter ()
+{
+    close ();
+}
+
+
+bool 
+OpenSteer::AnnotationStreamWriter::open (const char* fileName,
+                                         const char* plugInName)
+{
+    close ();
+    std::FILE* stream = std::fopen (fileName, "wb");
+    return stream && start (stream, plugInName);
+}
+
+
+bool 
+OpenSteer::AnnotationStreamWriter::openDescriptor (const int descriptor,
+                                                   const char* plugInName)
+{
+    close ();
+#ifndef _WIN32
+    const int own = dup (descriptor);
+    if (own < 0) return false;
+    std::FILE* stream = fdopen (own, "wb");
+    if (! stream)
+    {
+        ::close (own);
+        return false;
+    }
+    return start (stream, plugInName);
+#else
+    (void) descriptor;
+    (void) plugInName;
+    return false;
+#endif
+}
+
+
+bool 
+OpenSteer::AnnotationStreamWriter::start (std::FILE* stream,
+                                          const char* plugInName)
+{
+    StreamHeader header;
+    memcpy (header.magic, streamMagic, sizeof (streamMagic));
+    header.version = version;
+    header.byteOrder = byteOrderMark;
+    header.nameLength = (uint32_t) strlen (plugInName);
+    if ((std::fwrite (&header, sizeof (header), 1, stream) != 1) ||
+        (std::fwrite (plugInName, 1, header.nameLength, stream) !=
+         header.nameLength) ||
+        (std::fflush (stream) != 0))
+    {
+        std::fclose (stream);
+        return false;
+    }
+
+    file = stream;
+    stopping = false;
+    writeFailed = false;
+    frames = 0;
+    droppedFrames = 0;
+    drainer = std::thread (&AnnotationStreamWriter::drain, this);
+    return true;
+}
+
+
+void 
+OpenSteer::AnnotationStreamWriter::close (void)
+{
+    if (! isOpen ()) return;
+
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+        stopping = true;
+    }
+    wake.notify_one ();
+    drainer.join ();
+
+    std::fclose (file);
+    file = 0;
+    pending.clear ();
+    queuedBytes = 0;
+}
+
+
+void 
+OpenSteer::AnnotationStreamWriter::setQueueLimit (const size_t bytes)
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    queueLimit = bytes;
+}
+
+
+void 
+OpenSteer::AnnotationStreamWriter::writeFrame (const SimulationSnapshot& snapshot)
+{
+    if (! isOpen ()) return;
+    frames++;
+    if (writeFailed)
+    {
+        droppedFrames++;
+        return;
+    }
+
+    AnnotationStreamFrameHeader header;
+    header.currentTime = snapshot.currentTime;
+    header.elapsedTime = snapshot.elapsedTime;
+    header.selected = snapshot.selected;
+    header.vehicleCount = (uint32_t) snapshot.vehicles.size ();
+    header.lineCount = (uint32_t) snapshot.lines.size ();
+    header.circleCount = (uint32_t) snapshot.circles.size ();
+    header.size = (uint32_t)
+        (header.vehicleCount * sizeof (StreamVehicle) +
+         header.lineCount * sizeof (AnnotationStreamLine) +
+         header.circleCount * sizeof (AnnotationStreamCircle));
+
+    frame.clear ();
+    frame.reserve (sizeof (header) + header.size);
+    append (frame, header);
+    if (header.vehicleCount > 0)
+    {
+        const size_t at = frame.size ();
+        const size_t bytes = header.vehicleCount * sizeof (StreamVehicle);
+        frame.resize (at + bytes);
+        memcpy (&frame[at], &snapshot.vehicles[0], bytes);
+    }
+    for (size_t i = 0; i < snapshot.lines.size (); i++)
+    {
+        const SimulationSnapshot::Line& l = snapshot.lines[i];
+        AnnotationStreamLine record;
+        record.startPoint = l.startPoint;
+        record.endPoint = l.endPoint;
+        packColor (l.color, record.color);
+        append (frame, record);
+    }
+    for (size_t i = 0; i < snapshot.circles.size (); i++)
+    {
+        const SimulationSnapshot::CircleOrDisk& c = snapshot.circles[i];
+        AnnotationStreamCircle record;
+        record.radius = c.radius;
+        record.axis = c.axis;
+        record.center = c.center;
+        packColor (c.color, record.color);
+        record.segments = (uint16_t) c.segments;
+        record.flags = (c.filled ? 1 : 0) | (c.in3d ? 2 : 0);
+        record.unused = 0;
+        append (frame, record);
+    }
+
+    // hand the frame over, taking an emptied buffer back for the next one
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+        if (queuedBytes + frame.size () > queueLimit)
+        {
+            droppedFrames++;
+            return;
+        }
+        queuedBytes += frame.size ();
+        pending.push_back (std::vector<unsigned char> ());
+        pending.back().swap (frame);
+        if (! spare.empty ())
+        {
+            frame.swap (spare.back ());
+            spare.pop_back ();
+        }
+    }
+    wake.notify_one ();
+}
+
+
+void 
+OpenSteer::AnnotationStreamWriter::drain (void)
+{
+    std::vector<std::vector<unsigned char> > writing;
+    std::unique_lock<std::mutex> lock (mutex);
+    for (;;)
+    {
+        while (pending.empty () && ! stopping) wake.wait (lock);
+        if (pending.empty ()) return;
+        writing.swap (pending);
+        lock.unlock ();
+
+        size_t written = 0;
+        for (size_t i = 0; i < writing.size (); i++)
+        {
+            if (! writeFailed &&
+                (std::fwrite (&writing[i][0], writing[i].size (), 1, file) != 1))
+                writeFailed = true;
+            written += writing[i].size ();
+        }
+        if (std::fflush (file) != 0) writeFailed = true;
+
+        lock.lock ();
+        queuedBytes -= written;
+        for (size_t i = 0; i < writing.size (); i++)
+        {
+            writing[i].clear ();
+            spare.push_back (std::vector<unsigned char> ());
+            spare.back().swap (writing[i]);
+        }
+        writing.clear ();
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::AnnotationStreamReader::AnnotationStreamReader (void)
+    : file (0), firstFrame (0), frames (0)
+{
+}
+
+
+OpenSteer::AnnotationStreamReader::~AnnotationStreamReader ()
+{
+    close ();
+}
+
+
+bool 
+OpenSteer::AnnotationStreamReader::open (const char* fileName)
+{
+    close ();
+    file = std::fopen (fileName, "rb");
+    if (! file) return false;
+
+    StreamHeader header;
+    if ((std::fread (&header, sizeof (header), 1, file) == 1) &&
+        (memcmp (header.magic, streamMagic, sizeof (streamMagic)) == 0) &&
+        (header.version == AnnotationStreamWriter::version) &&
+        (header.byteOrder == byteOrderMark) &&
+        (header.nameLength <= maxNameLength))
+    {
+        name.resize (header.nameLength);
+        if ((header.nameLength == 0) ||
+            (std::fread (&name[0], 1, header.nameLength, file) ==
+             header.nameLength))
+        {
+            firstFrame = std::ftell (file);
+            return true;
+        }
+    }
+    close ();
+    return false;
+}
+
+
+void 
+OpenSteer::AnnotationStreamReader::close (void)
+{
+    if (file) std::fclose (file);
+    file = 0;
+    name.clear ();
+    frames = 0;
+}
+
+
+void 
+OpenSteer::AnnotationStreamReader::rewind (void)
+{
+    if (! isOpen ()) return;
+    std::clearerr (file);
+    std::fseek (file, firstFrame, SEEK_SET);
+    frames = 0;
+}
+
+
+bool 
+OpenSteer::AnnotationStreamReader::readFrame (SimulationSnapshot& snapshot)
+{
+    if (! isOpen ()) return false;
+
+    // the record counts must add up to the size, so a malformed frame
+    // cannot make the snapshot grow beyond what was read
+    AnnotationStreamFrameHeader header;
+    if (std::fread (&header, sizeof (header), 1, file) != 1) return false;
+    const uint64_t size =
+        (uint64_t) header.vehicleCount * sizeof (StreamVehicle) +
+        (uint64_t) header.lineCount * sizeof (AnnotationStreamLine) +
+        (uint64_t) header.circleCount * sizeof (AnnotationStreamCircle);
+    if ((size != header.size) ||
+        (header.selected < -1) ||
+        ((header.selected >= 0) &&
+         ((uint32_t) header.selected >= header.vehicleCount)))
+        return false;
+    records.resize (header.size);
+    if ((header.size > 0) &&
+        (std::fread (&records[0], header.size, 1, file) != 1))
+        return false;
+
+    snapshot.clear ();
+    const unsigned char* p = records.empty () ? 0 : &records[0];
+    snapshot.vehicles.resize (header.vehicleCount);
+    if (header.vehicleCount > 0)
+    {
+        const size_t bytes = header.vehicleCount * sizeof (StreamVehicle);
+        memcpy (&snapshot.vehicles[0], p, bytes);
+        p += bytes;
+    }
+    for (uint32_t i = 0; i < header.lineCount; i++)
+    {
+        AnnotationStreamLine record;
+        memcpy (&record, p, sizeof (record));
+        p += sizeof (record);
+        snapshot.addLine (record.startPoint, record.endPoint,
+                          unpackColor (record.color));
+    }
+    for (uint32_t i = 0; i < header.circleCount; i++)
+    {
+        AnnotationStreamCircle record;
+        memcpy (&record, p, sizeof (record));
+        p += sizeof (record);
+        snapshot.addCircleOrDisk (record.radius, record.axis, record.center,
+                                  unpackColor (record.color), record.segments,
+                                  (record.flags & 1) != 0,
+                                  (record.flags & 2) != 0);
+    }
+    snapshot.selected = header.selected;
+    snapshot.currentTime = header.currentTime;
+    snapshot.elapsedTime = header.elapsedTime;
+    frames++;
+    return true;
+}
+
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,166 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// AsyncJob
+//
+// See AsyncJob.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/AsyncJob.h"
+
+#include "OpenSteer/Profiler.h"
+
+
+// ----------------------------------------------------------------------------
+// the job running on the calling thread, if any
+
+
+namespace {
+
+    thread_local const OpenSteer::AsyncJobQueue::Job* currentJob = NULL;
+
+} // anonymous namespace
+
+
+bool 
+OpenSteer::AsyncJobQueue::currentJobCancelled (void)
+{
+    return currentJob && currentJob->cancelled;
+}
+
+
+// ----------------------------------------------------------------------------
+// constructor and destructor
+
+
+OpenSteer::AsyncJobQueue::AsyncJobQueue (int threadCount)
+    : running (0),
+      stopping (false)
+{
+    if (threadCount < 1) threadCount = 1;
+    for (int i = 0; i < threadCount; i++)
+        threads.push_back (std::thread (&AsyncJobQueue::threadLoop, this));
+}
+
+
+OpenSteer::AsyncJobQueue::~AsyncJobQueue ()
+{
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+        stopping = true;
+        for (size_t i = 0; i < jobs.size(); i++) jobs[i]->cancelled = true;
+    }
+    wakeThreads.notify_all ();
+    for (size_t i = 0; i < threads.size(); i++) threads[i].join ();
+}
+
+
+// ----------------------------------------------------------------------------
+// shared queue
+
+
+OpenSteer::AsyncJobQueue& 
+OpenSteer::AsyncJobQueue::shared (void)
+{
+    static AsyncJobQueue queue;
+    return queue;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::AsyncJobQueue::submit (const std::shared_ptr<Job>& job)
+{
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+        jobs.push_back (job);
+    }
+    wakeThreads.notify_one ();
+}
+
+
+size_t 
+OpenSteer::AsyncJobQueue::pendingCount (void)
+{
+    std::lock_guard<std::mutex> lock (mutex);
+    return jobs.size() + running;
+}
+
+
+void 
+OpenSteer::AsyncJobQueue::waitUntilIdle (void)
+{
+    std::unique_lock<std::mutex> lock (mutex);
+    while (! jobs.empty() || (running > 0)) idle.wait (lock);
+}
+
+
+// ----------------------------------------------------------------------------
+// body of each thread: take the oldest job, run it unless it was cancelled,
+// mark it done.  On shutdown the remaining (cancelled) jobs are skipped.
+
+
+void 
+OpenSteer::AsyncJobQueue::threadLoop (void)
+{
+    Profiler::setThreadName ("planner");
+
+    std::unique_lock<std::mutex> lock (mutex);
+    for (;;)
+    {
+        while (jobs.empty() && ! stopping) wakeThreads.wait (lock);
+        if (jobs.empty()) return;
+
+        std::shared_ptr<Job> job = jobs.front();
+        jobs.pop_front ();
+        running++;
+        lock.unlock ();
+
+        if (! job->cancelled)
+        {
+            OPENSTEER_PROFILE_SCOPE ("async job");
+            currentJob = job.get();
+            job->run ();
+            currentJob = NULL;
+        }
+        job->done = true;
+
+        lock.lock ();
+        running--;
+        if (jobs.empty() && (running == 0)) idle.notify_all ();
+    }
+}
+
+
+// ----------------------------------------------------------------------------
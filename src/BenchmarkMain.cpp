@@ -0,0 +1,566 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// ----------------------------------------------------------------------------
+//
+//
+// Benchmark: reproducible headless benchmark of the built-in PlugIns
+//
+// Runs each selected PlugIn without a window at a fixed time step, from a
+// fixed random seed (and with vehicle serial numbers, which seed the
+// vehicles' own random streams, counted from zero), at several population
+// sizes (for PlugIns whose population can vary).  Per frame phase timings (see PhaseTimer.h) are
+// written to stdout as one JSON object per run ("JSON lines"), so results
+// can be compared across builds and machines.  Each also reports the live
+// storage per MemoryAccount category at the end of the run, and as a
+// quality metric the number of vehicles in contact (overlapping, found by
+// a ContactBroadphase after each measured frame, outside the phase
+// timings) per frame.
+//
+// usage: OpenSteerBenchmark [--plugin name]... [--sizes n,n,...]
+//                           [--frames n] [--warmup n] [--dt seconds]
+//                           [--seed n] [--parallel] [--threads n]
+//                           [--key n]... [--param name=value]...
+//                           [--accuracy] [--trace file]
+//
+// --key n presses function key Fn once after opening each PlugIn, before
+// its population is set (repeatable, in order).  For example in Boids and
+// Pedestrians each "--key 3" switches to the next proximity database.
+//
+// --param name=value then sets a parameter of each PlugIn by name (see
+// AbstractPlugIn::setParameter), for those which have it (repeatable).
+// For example "--param reorderPeriod=60" has Boids reorder its flock
+// spatially every 60 frames.
+//
+// --accuracy also runs each PlugIn without the --key presses and --param
+// settings and reports how far its vehicles' final positions ended up
+// from those of that reference run (matched by their serial numbers, since
+// PlugIns may reorder their vehicles), as the cost of the approximations
+// the keys (such as staggered neighbor refresh) or parameters switched on.
+// Chaotic simulations diverge from any change, so compare these figures
+// between settings rather than with zero.  The JSON's "approximate_math"
+// tells whether the build uses approximate math (see Utilities.h).
+//
+// --parallel selects the two-phase parallel update (see WorkerPool.h) in
+// the PlugIns which support it.  Phase timings are those of the main
+// thread, so in that mode time spent waiting for the workers is charged to
+// the steering phase.
+//
+// --trace file writes the frames of all runs (the latest Profiler
+// ringCapacity spans of each thread) as a Chrome trace, for builds
+// configured with OPENSTEER_PROFILER (see Profiler.h).
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/OpenSteerDemo.h"
+#include "OpenSteer/Annotation.h"
+#include "OpenSteer/ContactBroadphase.h"
+#include "OpenSteer/MemoryAccount.h"
+#include "OpenSteer/PhaseTimer.h"
+#include "OpenSteer/PlugIn.h"
+#include "OpenSteer/Profiler.h"
+#include "OpenSteer/SimpleVehicle.h"
+#include "OpenSteer/WorkerPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+
+    // ------------------------------------------------------------------------
+    // run settings, from the command line
+
+
+    // PlugIns benchmarked by default
+    const char* defaultPlugIns[] = {"Boids",
+                                    "Pedestrians",
+                                    "Driving through map based obstacles",
+                                    "Capture the Flag",
+                                    "Michael's Simple Soccer",
+                                    "Multiple Pursuit"};
+
+    std::vector<std::string> plugInNames;
+    std::vector<int> populationSizes;
+    int frameCount = 100;
+    int warmupFrameCount = 10;
+    float stepSize = 1.0f / 60.0f;
+    unsigned int seed = 1;
+    std::vector<int> functionKeys;
+    std::vector<std::pair<std::string, float> > parameters;
+    bool measureAccuracy = false;
+    const char* traceFileName = NULL;
+
+
+    // ------------------------------------------------------------------------
+    // per phase statistics over the measured frames of one run
+
+
+    struct PhaseStatistics
+    {
+        PhaseStatistics () : total (0), max (0) {}
+
+        void addFrame (const double seconds)
+        {
+            total += seconds;
+            if (max < seconds) max = seconds;
+        }
+
+        double total;
+        double max;
+    };
+
+
+    // ------------------------------------------------------------------------
+    // write a string as a JSON string literal
+
+
+    std::string jsonString (const char* s)
+    {
+        std::string result ("\"");
+        for (const char* c = s; *c; c++)
+        {
+            if ((*c == '"') || (*c == '\\')) result += '\\';
+            result += *c;
+        }
+        return result + "\"";
+    }
+
+
+    void writePhase (std::ostream& os,
+                     const char* name,
+                     const PhaseStatistics& statistics)
+    {
+        os << jsonString (name) << ":{"
+           << "\"total_ms\":" << statistics.total * 1000 << ","
+           << "\"mean_ms\":" << statistics.total * 1000 / frameCount << ","
+           << "\"max_ms\":" << statistics.max * 1000 << "}";
+    }
+
+
+    // live storage per MemoryAccount category at the end of a run, and per
+    // vehicle that of the vehicles, their tokens, neighbor lists and trails
+
+
+    void writeMemory (std::ostream& os, const int vehicleCount)
+    {
+        typedef MemoryAccount MA;
+        const size_t perVehicle = (MA::liveBytes (MA::vehicleMemory) +
+                                   MA::liveBytes (MA::tokenMemory) +
+                                   MA::liveBytes (MA::neighborMemory) +
+                                   MA::liveBytes (MA::trailMemory));
+        os << ",\"memory\":{\"live_bytes\":" << MA::liveBytes ()
+           << ",\"live_allocations\":" << MA::liveAllocations ()
+           << ",\"bytes_per_vehicle\":"
+           << (vehicleCount ? perVehicle / vehicleCount : 0);
+        for (int i = 0; i < MA::categoryCount; i++)
+        {
+            const MA::Category c = (MA::Category) i;
+            os << "," << jsonString (MA::name (c)) << ":{"
+               << "\"live_bytes\":" << MA::liveBytes (c) << ","
+               << "\"live_allocations\":" << MA::liveAllocations (c) << "}";
+        }
+        os << "}";
+    }
+
+
+    // ------------------------------------------------------------------------
+    // the positions of the selected PlugIn's vehicles, in the order of
+    // their serial numbers (of those which are SimpleVehicles, the others
+    // by their order in allVehicles)
+
+
+    std::vector<Vec3> vehiclePositions (void)
+    {
+        const AVGroup& vehicles = OpenSteerDemo::allVehiclesOfSelectedPlugIn();
+        std::vector<std::pair<int, size_t> > keys (vehicles.size());
+        for (size_t i = 0; i < vehicles.size(); i++)
+        {
+            const SimpleVehicle* simple =
+                dynamic_cast<const SimpleVehicle*> (vehicles[i]);
+            keys[i] = std::make_pair (simple ? simple->serialNumber : (int) i, i);
+        }
+        std::sort (keys.begin(), keys.end());
+
+        std::vector<Vec3> positions;
+        positions.reserve (vehicles.size());
+        for (size_t i = 0; i < keys.size(); i++)
+            positions.push_back (vehicles[keys[i].second]->position());
+        return positions;
+    }
+
+
+    // ------------------------------------------------------------------------
+    // the final positions of a reference run of a PlugIn: the same run,
+    // untimed, without the function key presses
+
+
+    std::vector<Vec3> referencePositions (PlugIn& pi, const int population)
+    {
+        setRandomSeed (seed);
+        SimpleVehicle::serialNumberCounter = 0;
+
+        OpenSteerDemo::selectedPlugIn = &pi;
+        OpenSteerDemo::openSelectedPlugIn ();
+        pi.setPopulation (population);
+
+        float simulationTime = 0;
+        for (int i = 0; i < warmupFrameCount + frameCount; i++)
+        {
+            simulationTime += stepSize;
+            OpenSteerDemo::updateSelectedPlugIn (simulationTime, stepSize);
+        }
+
+        const std::vector<Vec3> positions = vehiclePositions ();
+        OpenSteerDemo::closeSelectedPlugIn ();
+        return positions;
+    }
+
+
+    // ------------------------------------------------------------------------
+    // run one PlugIn at a given population size and report the results.
+    // PlugIns with a fixed population run at their own size, in which case
+    // this returns false.
+
+
+    bool runBenchmark (PlugIn& pi, const int population)
+    {
+        setRandomSeed (seed);
+        SimpleVehicle::serialNumberCounter = 0;
+
+        OpenSteerDemo::selectedPlugIn = &pi;
+        OpenSteerDemo::openSelectedPlugIn ();
+        for (size_t k = 0; k < functionKeys.size(); k++)
+            pi.handleFunctionKeys (functionKeys[k]);
+        for (size_t p = 0; p < parameters.size(); p++)
+            pi.setParameter (parameters[p].first.c_str (), parameters[p].second);
+        const bool variablePopulation = pi.setPopulation (population);
+
+        const int vehicleCount =
+            (int) OpenSteerDemo::allVehiclesOfSelectedPlugIn().size();
+
+        PhaseStatistics phases [PhaseTimer::phaseCount];
+        PhaseStatistics frames;
+        PhaseStatistics contactTime;
+        ContactBroadphase contacts;
+        size_t contactTotal = 0;
+        size_t contactMax = 0;
+
+        float simulationTime = 0;
+        for (int i = 0; i < warmupFrameCount + frameCount; i++)
+        {
+            PhaseTimer::reset ();
+            {
+                OPENSTEER_PROFILE_SCOPE ("frame");
+                PhaseTimer::Scope timer (PhaseTimer::otherUpdatePhase);
+                simulationTime += stepSize;
+                OpenSteerDemo::updateSelectedPlugIn (simulationTime, stepSize);
+            }
+
+            if (i < warmupFrameCount) continue;
+
+            double frameTime = 0;
+            for (int p = 0; p < PhaseTimer::phaseCount; p++)
+            {
+                const double t = PhaseTimer::total ((PhaseTimer::Phase) p);
+                phases[p].addFrame (t);
+                frameTime += t;
+            }
+            frames.addFrame (frameTime);
+
+            // vehicles in contact, a quality metric
+            typedef std::chrono::steady_clock Clock;
+            const Clock::time_point start = Clock::now ();
+            const size_t contactCount =
+                contacts.update (OpenSteerDemo::allVehiclesOfSelectedPlugIn());
+            contactTime.addFrame (std::chrono::duration<double>
+                                  (Clock::now () - start).count ());
+            contactTotal += contactCount;
+            contactMax = std::max (contactMax, contactCount);
+        }
+
+        const std::vector<Vec3> positions = vehiclePositions ();
+        std::ostringstream memory;
+        writeMemory (memory, vehicleCount);
+        OpenSteerDemo::closeSelectedPlugIn ();
+
+        // divergence from the reference run
+        double meanDivergence = 0;
+        double maxDivergence = 0;
+        if (measureAccuracy)
+        {
+            const std::vector<Vec3> reference = referencePositions (pi, population);
+            const size_t count = std::min (positions.size(), reference.size());
+            for (size_t i = 0; i < count; i++)
+            {
+                const double d = Vec3::distance (positions[i], reference[i]);
+                meanDivergence += d;
+                if (maxDivergence < d) maxDivergence = d;
+            }
+            if (count) meanDivergence /= count;
+        }
+
+        std::ostringstream json;
+        json << "{\"plugin\":" << jsonString (pi.name ())
+             << ",\"population\":" << vehicleCount
+             << ",\"seed\":" << seed
+             << ",\"dt\":" << stepSize
+             << ",\"parallel\":" << (parallelUpdateIsOn () ? "true" : "false")
+             << ",\"threads\":" << WorkerPool::shared().threadCount ()
+             << ",\"approximate_math\":" << (approximateMathIsOn () ? "true" : "false")
+             << ",\"keys\":[";
+        for (size_t k = 0; k < functionKeys.size(); k++)
+            json << (k ? "," : "") << functionKeys[k];
+        json << "],\"params\":{";
+        for (size_t p = 0; p < parameters.size(); p++)
+            json << (p ? "," : "") << jsonString (parameters[p].first.c_str ())
+                 << ":" << parameters[p].second;
+        json << "}"
+             << ",\"warmup_frames\":" << warmupFrameCount
+             << ",\"frames\":" << frameCount
+             << ",\"seconds\":" << frames.total
+             << ",\"steps_per_sec\":"
+             << ((frames.total > 0) ? frameCount / frames.total : 0)
+             << ",\"phases\":{";
+        for (int p = 0; p < PhaseTimer::phaseCount; p++)
+        {
+            writePhase (json, PhaseTimer::name ((PhaseTimer::Phase) p),
+                        phases[p]);
+            json << ",";
+        }
+        writePhase (json, "frame", frames);
+        json << "}"
+             << ",\"contacts\":{"
+             << "\"mean\":" << (double) contactTotal / frameCount << ","
+             << "\"max\":" << contactMax << ","
+             << "\"mean_ms\":" << contactTime.total * 1000 / frameCount << "}"
+             << memory.str ();
+        if (measureAccuracy)
+            json << ",\"accuracy\":{"
+                 << "\"mean_divergence\":" << meanDivergence << ","
+                 << "\"max_divergence\":" << maxDivergence << "}";
+        json << "}";
+
+        std::cout << json.str () << std::endl;
+        return variablePopulation;
+    }
+
+
+    // ------------------------------------------------------------------------
+    // parse a comma separated list of population sizes
+
+
+    bool parseSizes (const char* list)
+    {
+        populationSizes.clear ();
+        std::istringstream is (list);
+        std::string item;
+        while (std::getline (is, item, ','))
+        {
+            const int size = atoi (item.c_str ());
+            if (size <= 0) return false;
+            populationSizes.push_back (size);
+        }
+        return ! populationSizes.empty ();
+    }
+
+
+    // parse a name=value parameter setting
+
+
+    bool parseParameter (const char* setting)
+    {
+        const char* equals = strchr (setting, '=');
+        if ((equals == NULL) || (equals == setting) || (equals[1] == 0))
+            return false;
+        parameters.push_back (std::make_pair (std::string (setting, equals),
+                                              (float) atof (equals + 1)));
+        return true;
+    }
+
+
+    void printUsage (const char* programName)
+    {
+        std::cerr << "usage: " << programName
+                  << " [--plugin name]... [--sizes n,n,...] [--frames n]"
+                  << " [--warmup n] [--dt seconds] [--seed n]"
+                  << " [--parallel] [--threads n] [--key n]..."
+                  << " [--param name=value]..."
+                  << " [--accuracy] [--trace file]" << std::endl;
+    }
+
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+int main (int argc, char **argv)
+{
+    populationSizes.push_back (100);
+    populationSizes.push_back (1000);
+    populationSizes.push_back (10000);
+
+    for (int i = 1; i < argc; i++)
+    {
+        const bool hasValue = (i + 1) < argc;
+
+        if (hasValue && (strcmp (argv[i], "--plugin") == 0))
+        {
+            plugInNames.push_back (argv[++i]);
+        }
+        else if (hasValue && (strcmp (argv[i], "--sizes") == 0))
+        {
+            if (! parseSizes (argv[++i]))
+            {
+                std::cerr << "bad population size list" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (hasValue && (strcmp (argv[i], "--frames") == 0))
+        {
+            frameCount = atoi (argv[++i]);
+        }
+        else if (hasValue && (strcmp (argv[i], "--warmup") == 0))
+        {
+            warmupFrameCount = atoi (argv[++i]);
+        }
+        else if (hasValue && (strcmp (argv[i], "--dt") == 0))
+        {
+            stepSize = (float) atof (argv[++i]);
+        }
+        else if (strcmp (argv[i], "--parallel") == 0)
+        {
+            setParallelUpdateOn ();
+        }
+        else if (hasValue && (strcmp (argv[i], "--threads") == 0))
+        {
+            WorkerPool::shared().setThreadCount (atoi (argv[++i]));
+        }
+        else if (hasValue && (strcmp (argv[i], "--key") == 0))
+        {
+            functionKeys.push_back (atoi (argv[++i]));
+        }
+        else if (hasValue && (strcmp (argv[i], "--param") == 0))
+        {
+            if (! parseParameter (argv[++i]))
+            {
+                std::cerr << "bad parameter setting" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (strcmp (argv[i], "--accuracy") == 0)
+        {
+            measureAccuracy = true;
+        }
+        else if (hasValue && (strcmp (argv[i], "--seed") == 0))
+        {
+            seed = (unsigned int) strtoul (argv[++i], NULL, 10);
+        }
+        else if (hasValue && (strcmp (argv[i], "--trace") == 0))
+        {
+            traceFileName = argv[++i];
+        }
+        else
+        {
+            printUsage (argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ((frameCount <= 0) || (warmupFrameCount < 0) || (stepSize <= 0))
+    {
+        std::cerr << "frame counts and time step must be positive" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (plugInNames.empty ())
+    {
+        const int count = sizeof (defaultPlugIns) / sizeof (defaultPlugIns[0]);
+        plugInNames.assign (defaultPlugIns, defaultPlugIns + count);
+    }
+
+    // nothing is drawn, and annotation would distort the timings
+    setAnnotationOff ();
+    PhaseTimer::enabled = true;
+
+    if (traceFileName)
+    {
+#ifndef OPENSTEER_PROFILER
+        std::cerr << "built without OPENSTEER_PROFILER, "
+                  << "the trace will be empty" << std::endl;
+#endif
+        Profiler::enabled = true;
+        Profiler::setThreadName ("main");
+    }
+
+    for (size_t i = 0; i < plugInNames.size (); i++)
+    {
+        PlugIn* pi = PlugIn::findByName (plugInNames[i].c_str ());
+        if (pi == NULL)
+        {
+            std::cerr << "no PlugIn named \"" << plugInNames[i] << "\""
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // PlugIns with a fixed population run only once
+        for (size_t j = 0; j < populationSizes.size (); j++)
+        {
+            if (! runBenchmark (*pi, populationSizes[j])) break;
+        }
+    }
+
+    if (traceFileName)
+    {
+        std::ofstream trace (traceFileName);
+        Profiler::writeChromeTrace (trace);
+        if (! trace)
+        {
+            std::cerr << "cannot write " << traceFileName << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+// ----------------------------------------------------------------------------
@@ -49,11 +49,26 @@
 
 
 OpenSteer::Camera::Camera (void)
+    : fieldOfViewY (45),
+      nearDistance (1),
+      farDistance (400),
+      aspectRatio (1)
 {
     reset ();
 }
 
 
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::ViewFrustum 
+OpenSteer::Camera::viewFrustum (void) const
+{
+    return ViewFrustum (position(), target, up(), fieldOfViewY, aspectRatio,
+                        nearDistance, farDistance);
+}
+
+
 // ----------------------------------------------------------------------------
 // reset all camera state to default values
 
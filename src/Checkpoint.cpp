@@ -0,0 +1,325 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Checkpoint
+//
+// See Checkpoint.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/Checkpoint.h"
+
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+
+    // start of every checkpoint
+    struct FileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+    };
+
+    const char magic[8] = {'O', 'S', 'T', 'E', 'E', 'R', 'C', 'K'};
+    const uint32_t byteOrderMark = 0x01020304;
+
+
+    // start of every section, followed by its records
+    struct SectionHeader
+    {
+        uint32_t tag;
+        uint32_t recordSize;
+        uint64_t count;
+    };
+
+
+    // sections written by the CheckpointWriter constructor
+    const CheckpointTag nameTag = checkpointTag ("NAME");
+    const CheckpointTag timeTag = checkpointTag ("TIME");
+
+
+    // sections start on 8 byte boundaries
+    size_t padded (const size_t size) {return (size + 7) & ~(size_t) 7;}
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::CheckpointWriter::CheckpointWriter (const char* plugInName,
+                                               const float currentTime)
+{
+    FileHeader header;
+    memcpy (header.magic, magic, sizeof (magic));
+    header.version = version;
+    header.byteOrder = byteOrderMark;
+    buffer.resize (sizeof (header));
+    memcpy (&buffer[0], &header, sizeof (header));
+
+    addArray (nameTag, plugInName, strlen (plugInName));
+    addRecord (timeTag, currentTime);
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::CheckpointWriter::addSection (const CheckpointTag tag,
+                                         const size_t recordSize,
+                                         const size_t count,
+                                         const void* records)
+{
+    SectionHeader header;
+    header.tag = tag;
+    header.recordSize = (uint32_t) recordSize;
+    header.count = count;
+
+    const size_t start = buffer.size ();
+    const size_t bytes = recordSize * count;
+    buffer.resize (start + sizeof (header) + padded (bytes), 0);
+    memcpy (&buffer[start], &header, sizeof (header));
+    if (bytes) memcpy (&buffer[start + sizeof (header)], records, bytes);
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+bool 
+OpenSteer::CheckpointWriter::writeFile (const char* fileName) const
+{
+    std::ofstream file (fileName, std::ios::binary);
+    file.write (&buffer[0], buffer.size ());
+    return (bool) file;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::CheckpointReader::CheckpointReader (void)
+    : data (0),
+      size (0),
+      time (0),
+      mapping (0),
+      mappingSize (0)
+{
+}
+
+
+OpenSteer::CheckpointReader::~CheckpointReader (void)
+{
+    close ();
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+bool 
+OpenSteer::CheckpointReader::open (const char* fileName)
+{
+    close ();
+
+#ifndef _WIN32
+    const int file = ::open (fileName, O_RDONLY);
+    if (file < 0) return false;
+    struct stat status;
+    if ((fstat (file, &status) == 0) && (status.st_size > 0))
+    {
+        void* m = mmap (0, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (m != MAP_FAILED)
+        {
+            mapping = m;
+            mappingSize = status.st_size;
+        }
+    }
+    ::close (file);
+    if (mapping == 0) return false;
+    data = (const char*) mapping;
+    size = mappingSize;
+#else
+    std::ifstream file (fileName, std::ios::binary);
+    fileContents.assign (std::istreambuf_iterator<char> (file),
+                         std::istreambuf_iterator<char> ());
+    if (fileContents.empty ()) return false;
+    data = &fileContents[0];
+    size = fileContents.size ();
+#endif
+
+    if (parse ()) return true;
+    close ();
+    return false;
+}
+
+
+bool 
+OpenSteer::CheckpointReader::openMemory (const void* memory,
+                                         const size_t memorySize)
+{
+    close ();
+    data = (const char*) memory;
+    size = memorySize;
+    if (parse ()) return true;
+    close ();
+    return false;
+}
+
+
+void 
+OpenSteer::CheckpointReader::close (void)
+{
+#ifndef _WIN32
+    if (mapping) munmap (mapping, mappingSize);
+#endif
+    mapping = 0;
+    mappingSize = 0;
+    fileContents.clear ();
+    data = 0;
+    size = 0;
+    sections.clear ();
+    name.clear ();
+    time = 0;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+bool 
+OpenSteer::CheckpointReader::parse (void)
+{
+    FileHeader header;
+    if ((data == 0) || (size < sizeof (header))) return false;
+    memcpy (&header, data, sizeof (header));
+    if ((memcmp (header.magic, magic, sizeof (magic)) != 0) ||
+        (header.version != CheckpointWriter::version) ||
+        (header.byteOrder != byteOrderMark))
+        return false;
+
+    size_t offset = sizeof (header);
+    while (offset < size)
+    {
+        SectionHeader sectionHeader;
+        if (size - offset < sizeof (sectionHeader)) return false;
+        memcpy (&sectionHeader, data + offset, sizeof (sectionHeader));
+        offset += sizeof (sectionHeader);
+
+        // refuse sections running past the end (or overflowing size_t)
+        const uint64_t bytes = (uint64_t) sectionHeader.recordSize *
+                               sectionHeader.count;
+        if ((sectionHeader.recordSize &&
+             (sectionHeader.count > (size - offset) / sectionHeader.recordSize)) ||
+            (padded ((size_t) bytes) > size - offset))
+            return false;
+
+        Section s;
+        s.tag = sectionHeader.tag;
+        s.recordSize = sectionHeader.recordSize;
+        s.count = sectionHeader.count;
+        s.offset = offset;
+        sections.push_back (s);
+        offset += padded ((size_t) bytes);
+    }
+
+    size_t nameLength;
+    const char* n = array<char> (nameTag, nameLength);
+    if ((n == 0) || ! record (timeTag, time)) return false;
+    name.assign (n, nameLength);
+    return true;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+const void* 
+OpenSteer::CheckpointReader::section (const CheckpointTag tag,
+                                      const size_t recordSize,
+                                      size_t& count) const
+{
+    for (size_t i = 0; i < sections.size (); i++)
+    {
+        const Section& s = sections[i];
+        if ((s.tag == tag) && (s.recordSize == recordSize))
+        {
+            count = (size_t) s.count;
+            return data + s.offset;
+        }
+    }
+    count = 0;
+    return 0;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+bool 
+OpenSteer::CheckpointReader::proximityDatabase (const CheckpointTag stateTag,
+                                                const CheckpointTag orderTag,
+                                                const size_t groupSize,
+                                                ProximityDatabaseState& state,
+                                                std::vector<size_t>& order) const
+{
+    size_t count;
+    const uint32_t* indices = array<uint32_t> (orderTag, count);
+    if (! record (stateTag, state) || ! indices || (count != groupSize))
+        return false;
+
+    std::vector<bool> placed (count, false);
+    order.resize (count);
+    for (size_t i = 0; i < count; i++)
+    {
+        if ((indices[i] >= count) || placed[indices[i]]) return false;
+        placed[indices[i]] = true;
+        order[i] = indices[i];
+    }
+    return true;
+}
+
+
+// ----------------------------------------------------------------------------
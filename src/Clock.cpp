@@ -119,6 +119,15 @@ OpenSteer::Clock::Clock (void)
     // step) that the CPU is busy).
     smoothedFPS = 0;
     smoothedUsage = 0;
+
+    // no fixed time step and no frame budget
+    fixedTimeStep = 0;
+    maxSubsteps = 1;
+    substeps = 0;
+    stepAccumulator = 0;
+    steppedSimulationTime = 0;
+    droppedSimulationTime = 0;
+    frameBudget = 0;
 }
 
 
@@ -183,6 +192,49 @@ OpenSteer::Clock::update (void)
 
     // reset advance amount
     newAdvanceTime = 0;
+
+    // bank the elapsed time for fixed steps, dropping what the substep
+    // budget cannot take
+    if (fixedTimeStep > 0)
+    {
+        stepAccumulator += elapsedSimulationTime;
+        substeps = (int) (stepAccumulator / fixedTimeStep);
+        if (substeps > maxSubsteps)
+        {
+            const float excess = (substeps - maxSubsteps) * fixedTimeStep;
+            droppedSimulationTime += excess;
+            stepAccumulator -= excess;
+            substeps = maxSubsteps;
+        }
+        stepAccumulator -= substeps * fixedTimeStep;
+        steppedSimulationTime += substeps * fixedTimeStep;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// fixed time step
+
+
+void 
+OpenSteer::Clock::setFixedTimeStep (const float seconds, const int maximum)
+{
+    fixedTimeStep = (seconds > 0) ? seconds : 0;
+    maxSubsteps = (maximum > 0) ? maximum : 1;
+    substeps = 0;
+    stepAccumulator = 0;
+    steppedSimulationTime = totalSimulationTime;
+}
+
+
+void 
+OpenSteer::Clock::dropSubsteps (const int i)
+{
+    if ((i < 0) || (i >= substeps)) return;
+    const float dropped = (substeps - i) * fixedTimeStep;
+    droppedSimulationTime += dropped;
+    steppedSimulationTime -= dropped;
+    substeps = i;
 }
 
 
@@ -0,0 +1,220 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// ContactBroadphase
+//
+// See ContactBroadphase.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/ContactBroadphase.h"
+
+#include <algorithm>
+#include "OpenSteer/Utilities.h"
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+
+    float component (const Vec3& v, const int axis)
+    {
+        return (axis == 0) ? v.x : ((axis == 1) ? v.y : v.z);
+    }
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::ContactBroadphase::ContactBroadphase (void)
+    : _axis (0), _swaps (0), _pairTests (0), _rebuilt (false)
+{
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+size_t
+OpenSteer::ContactBroadphase::update (const AVGroup& vehicles)
+{
+    _rebuilt = (vehicles != _vehicles);
+    if (_rebuilt)
+    {
+        rebuild (vehicles);
+    }
+    else
+    {
+        // refresh the intervals in their sorted order, then repair it
+        for (size_t i = 0; i < _intervals.size (); i++)
+        {
+            Interval& interval = _intervals[i];
+            const AbstractVehicle& v = *_vehicles[interval.vehicle];
+            const float center = component (v.position (), _axis);
+            interval.min = center - v.radius ();
+            interval.max = center + v.radius ();
+        }
+        sort ();
+    }
+    sweep ();
+    return _contacts.size ();
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void
+OpenSteer::ContactBroadphase::forEachContact (contactCallBackFunction func,
+                                              void* clientQueryState) const
+{
+    for (size_t i = 0; i < _contacts.size (); i++)
+        (*func) (_contacts[i], clientQueryState);
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void
+OpenSteer::ContactBroadphase::clear (void)
+{
+    _vehicles.clear ();
+    _intervals.clear ();
+    _contacts.clear ();
+}
+
+
+// ----------------------------------------------------------------------------
+// sweep along the axis in which the vehicles' positions spread furthest,
+// from a full sort
+
+
+void
+OpenSteer::ContactBroadphase::rebuild (const AVGroup& vehicles)
+{
+    _vehicles = vehicles;
+    _intervals.resize (vehicles.size ());
+    _swaps = 0;
+    if (vehicles.empty ()) return;
+
+    Vec3 low = vehicles[0]->position ();
+    Vec3 high = low;
+    for (size_t i = 1; i < vehicles.size (); i++)
+    {
+        const Vec3 p = vehicles[i]->position ();
+        low.set (std::min (low.x, p.x), std::min (low.y, p.y), std::min (low.z, p.z));
+        high.set (std::max (high.x, p.x), std::max (high.y, p.y), std::max (high.z, p.z));
+    }
+    const Vec3 spread = high - low;
+    _axis = ((spread.x >= spread.y) ?
+             ((spread.x >= spread.z) ? 0 : 2) :
+             ((spread.y >= spread.z) ? 1 : 2));
+
+    for (size_t i = 0; i < vehicles.size (); i++)
+    {
+        const float center = component (vehicles[i]->position (), _axis);
+        _intervals[i].min = center - vehicles[i]->radius ();
+        _intervals[i].max = center + vehicles[i]->radius ();
+        _intervals[i].vehicle = i;
+    }
+    std::sort (_intervals.begin (), _intervals.end ());
+}
+
+
+// ----------------------------------------------------------------------------
+// insertion sort by min: nearly linear for an order which is nearly right
+
+
+void
+OpenSteer::ContactBroadphase::sort (void)
+{
+    _swaps = 0;
+    for (size_t i = 1; i < _intervals.size (); i++)
+    {
+        if (! (_intervals[i] < _intervals[i-1])) continue;
+        const Interval moving = _intervals[i];
+        size_t j = i;
+        do
+        {
+            _intervals[j] = _intervals[j-1];
+            j--;
+        }
+        while ((j > 0) && (moving < _intervals[j-1]));
+        _intervals[j] = moving;
+        _swaps += i - j;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// each interval is tested against those after it which start before it
+// ends; spheres overlap when their centers are nearer than the sum of
+// their radii
+
+
+void
+OpenSteer::ContactBroadphase::sweep (void)
+{
+    _contacts.clear ();
+    _pairTests = 0;
+    const size_t n = _intervals.size ();
+    for (size_t i = 0; i < n; i++)
+    {
+        const Interval& a = _intervals[i];
+        AbstractVehicle* const va = _vehicles[a.vehicle];
+        const Vec3 pa = va->position ();
+        const float ra = va->radius ();
+        for (size_t j = i + 1; (j < n) && (_intervals[j].min <= a.max); j++)
+        {
+            const Interval& b = _intervals[j];
+            AbstractVehicle* const vb = _vehicles[b.vehicle];
+            const float sumOfRadii = ra + vb->radius ();
+            const float distanceSquared = (vb->position () - pa).lengthSquared ();
+            _pairTests++;
+            if (distanceSquared < sumOfRadii * sumOfRadii)
+            {
+                Contact contact;
+                const bool inOrder = (a.vehicle < b.vehicle);
+                contact.vehicle = inOrder ? va : vb;
+                contact.other = inOrder ? vb : va;
+                contact.penetration = sumOfRadii - sqrtXXX (distanceSquared);
+                _contacts.push_back (contact);
+            }
+        }
+    }
+}
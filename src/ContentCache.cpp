@@ -0,0 +1,179 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// ContentCache
+//
+// See ContentCache.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/ContentCache.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+
+// ----------------------------------------------------------------------------
+
+
+uint64_t 
+OpenSteer::contentHash (const void* data, const size_t size, uint64_t hash)
+{
+    const unsigned char* bytes = (const unsigned char*) data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::ContentKey::addBytes (const void* data, const size_t size)
+{
+    const char* bytes = (const char*) data;
+    key.insert (key.end (), bytes, bytes + size);
+}
+
+
+void 
+OpenSteer::ContentKey::addString (const char* s)
+{
+    addArray (s, strlen (s));
+}
+
+
+void 
+OpenSteer::ContentKey::addFileIdentity (const char* fileName)
+{
+    struct stat status;
+    int64_t identity[2] = {-1, -1};
+    if (stat (fileName, &status) == 0)
+    {
+        identity[0] = (int64_t) status.st_size;
+        identity[1] = (int64_t) status.st_mtime;
+    }
+    add (identity);
+    addString (fileName);
+}
+
+
+uint64_t 
+OpenSteer::ContentKey::hash (void) const
+{
+    return contentHash (key.empty () ? 0 : &key[0], key.size ());
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::ContentCache::ContentCache (const char* d)
+    : directory (d ? d : "")
+{
+}
+
+
+OpenSteer::ContentCache 
+OpenSteer::ContentCache::fromEnvironment (const char* variable)
+{
+    return ContentCache (getenv (variable));
+}
+
+
+std::string 
+OpenSteer::ContentCache::fileName (const char* kind,
+                                   const ContentKey& key) const
+{
+    char hash[17];
+    snprintf (hash, sizeof (hash), "%016llx",
+              (unsigned long long) key.hash ());
+    return directory + "/" + kind + "-" + hash + ".cache";
+}
+
+
+bool 
+OpenSteer::ContentCache::load (const char* kind,
+                               const ContentKey& key,
+                               CheckpointReader& reader) const
+{
+    if (! isEnabled ()) return false;
+    if (! reader.open (fileName (kind, key).c_str ())) return false;
+
+    // the stored key must be this one, not just hash like it
+    size_t count;
+    const char* stored = reader.array<char> (keyTag (), count);
+    const std::vector<char>& bytes = key.bytes ();
+    if ((stored == 0) || (count != bytes.size ()) ||
+        (count && (memcmp (stored, &bytes[0], count) != 0)))
+    {
+        reader.close ();
+        return false;
+    }
+    return true;
+}
+
+
+bool 
+OpenSteer::ContentCache::store (const char* kind,
+                                const ContentKey& key,
+                                CheckpointWriter& writer) const
+{
+    if (! isEnabled ()) return false;
+    const std::vector<char>& bytes = key.bytes ();
+    writer.addArray (keyTag (), bytes.empty () ? 0 : &bytes[0], bytes.size ());
+
+    // write under a name of this process's own, then move into place
+    const std::string name = fileName (kind, key);
+    std::ostringstream temporary;
+    temporary << name << ".partial";
+#ifndef _WIN32
+    temporary << "." << getpid ();
+#endif
+    if (! writer.writeFile (temporary.str ().c_str ()) ||
+        (std::rename (temporary.str ().c_str (), name.c_str ()) != 0))
+    {
+        std::remove (temporary.str ().c_str ());
+        return false;
+    }
+    return true;
+}
@@ -50,7 +50,9 @@
 #include "OpenSteer/Draw.h"
 
 #include <iomanip>
+#include <list>
 #include <sstream>
+#include <vector>
 
 
 // Include headers for OpenGL (gl.h), OpenGL Utility Library (glu.h)
@@ -76,6 +78,8 @@
 
 
 #include "OpenSteer/Vec3.h"
+#include "OpenSteer/DrawGeometry.h"
+#include "OpenSteer/MemoryAccount.h"
 
 // To include OpenSteer::round.
 #include "OpenSteer/Utilities.h"
@@ -258,7 +262,7 @@ OpenSteer::warnIfInUpdatePhase2 (const char* name)
     message << name;
     message << ")";
     message << std::ends;
-    std::cerr << message;       // send message to cerr, let host app worry about where to redirect it
+    std::cerr << message.str();       // send message to cerr, let host app worry about where to redirect it
 }
 
 
@@ -387,9 +391,8 @@ OpenSteer::drawCircleOrDisk (const float radius,
     // make disks visible (not culled) from both sides 
     if (filled) beginDoubleSidedDrawing ();
 
-    // point to be rotated about the (local) Y axis, angular step size
-    Vec3 pointOnCircle (radius, 0, 0);
-    const float step = (2 * OPENSTEER_M_PI) / segments;
+    // points around the (local) Y axis, "segments" steps apart
+    const Vec3* const circle = UnitCircleTable::points (segments);
 
     // set drawing color
     glColor3f (color.r(), color.g(), color.b());
@@ -400,19 +403,16 @@ OpenSteer::drawCircleOrDisk (const float radius,
     // for the filled case, first emit the center point
     if (filled) iglVertexVec3 (in3d ? ls.position() : center);
 
-    // rotate p around the circle in "segments" steps
-    float sin=0, cos=0;
+    // go around the circle in "segments" steps
     const int vertexCount = filled ? segments+1 : segments;
     for (int i = 0; i < vertexCount; i++)
     {
         // emit next point on circle, either in 3d (globalized out
         // of the local space), or in 2d (offset from the center)
+        const Vec3 pointOnCircle = radius * circle[i];
         iglVertexVec3 (in3d ?
                            ls.globalizePosition (pointOnCircle) :
                            (Vec3) (pointOnCircle + center));
-
-        // rotate point one more step around circle
-        pointOnCircle = pointOnCircle.rotateAboutGlobalY (step, sin, cos);
     }
 
     // close drawing operation
@@ -505,6 +505,218 @@ OpenSteer::drawXZArc (const Vec3& start,
 }
 
 
+// ------------------------------------------------------------------------
+// positions and colors of the vertices of many primitives of one type, drawn
+// with a single glDrawArrays call.  Clearing keeps the storage, so an array
+// refilled every frame stops allocating once it has grown to a frame's size.
+// The storage is charged to MemoryAccount::drawQueueMemory.
+
+
+namespace {
+
+    class ColoredVertexArray
+    {
+    public:
+
+        void clear (void) {vertices.clear (); colors.clear ();}
+        bool empty (void) const {return vertices.empty ();}
+
+        void add (const OpenSteer::Vec3& p, const OpenSteer::Color& c)
+        {
+            vertices.push_back (p.x);
+            vertices.push_back (p.y);
+            vertices.push_back (p.z);
+            colors.push_back (c.r());
+            colors.push_back (c.g());
+            colors.push_back (c.b());
+        }
+
+        void draw (const GLenum mode) const;
+
+    private:
+
+        typedef OpenSteer::AccountedVector<float,
+                    OpenSteer::MemoryAccount::drawQueueMemory>::type
+            FloatVector;
+
+        FloatVector vertices;
+        FloatVector colors;
+    };
+
+
+    void
+    ColoredVertexArray::draw (const GLenum mode) const
+    {
+        if (vertices.empty ()) return;
+
+        glEnableClientState (GL_VERTEX_ARRAY);
+        glEnableClientState (GL_COLOR_ARRAY);
+        glVertexPointer (3, GL_FLOAT, 0, &vertices[0]);
+        glColorPointer (3, GL_FLOAT, 0, &colors[0]);
+        glDrawArrays (mode, 0, (GLsizei) (vertices.size() / 3));
+        glDisableClientState (GL_COLOR_ARRAY);
+        glDisableClientState (GL_VERTEX_ARRAY);
+    }
+
+} // anonymous namespace
+
+
+// ------------------------------------------------------------------------
+// batched vehicle drawing
+//
+// Between beginVehicleBatch and drawVehicleBatch the basic vehicle drawing
+// routines below only record each vehicle's transform, radius and color.
+// drawVehicleBatch then expands the whole batch into vertex arrays and draws
+// every body with one call and every 2d outline with another, instead of
+// issuing a few GL calls per vehicle.
+
+
+namespace {
+
+    class VehicleBatch
+    {
+    public:
+
+        enum Shape {circular2d, spherical3d};
+
+        static bool isOpen (void) {return open;}
+        static void begin (void) {open = true;}
+
+        static void add (const OpenSteer::AbstractVehicle& vehicle,
+                         const OpenSteer::Color& color,
+                         const Shape shape)
+        {
+            Instance i;
+            i.position = vehicle.position();
+            i.forward = vehicle.forward();
+            i.side = vehicle.side();
+            i.up = vehicle.up();
+            i.radius = vehicle.radius();
+            i.color = color;
+            i.shape = shape;
+            instances.push_back (i);
+        }
+
+        // draw and empty the batch, end batching
+        static void draw (void);
+
+    private:
+
+        struct Instance
+        {
+            OpenSteer::Vec3 position, forward, side, up;
+            float radius;
+            OpenSteer::Color color;
+            Shape shape;
+        };
+
+        // segments of a 2d vehicle's outline circle
+        enum {circleSegments = 20};
+
+        static void triangle (const OpenSteer::Vec3& a,
+                              const OpenSteer::Vec3& b,
+                              const OpenSteer::Vec3& c,
+                              const OpenSteer::Color& color)
+        {
+            triangles.add (a, color);
+            triangles.add (b, color);
+            triangles.add (c, color);
+        }
+
+        // the same geometry drawBasic2dCircularVehicle and
+        // drawBasic3dSphericalVehicle draw one vehicle at a time
+        static void expand (void)
+        {
+            using namespace OpenSteer;
+
+            triangles.clear ();
+            lines.clear ();
+
+            // unit outline circle on the XZ plane
+            const Vec3* const circle = UnitCircleTable::points (circleSegments);
+
+            for (size_t n = 0; n < instances.size(); n++)
+            {
+                const Instance& i = instances[n];
+                const float r = i.radius;
+
+                if (i.shape == circular2d)
+                {
+                    // slightly up
+                    const Vec3 c = i.position + Vec3 (0, r * BasicVehicleMesh::liftOf2dBody, 0);
+                    const Vec3* const body = BasicVehicleMesh::flatBody;
+                    triangle (BasicVehicleMesh::place (body[0], r, c, i.side, i.up, i.forward),
+                              BasicVehicleMesh::place (body[1], r, c, i.side, i.up, i.forward),
+                              BasicVehicleMesh::place (body[2], r, c, i.side, i.up, i.forward),
+                              i.color);
+
+                    for (int k = 0; k < circleSegments; k++)
+                    {
+                        lines.add (c + r * circle[k], gWhite);
+                        lines.add (c + r * circle[k + 1], gWhite);
+                    }
+                }
+                else
+                {
+                    const Vec3* body = BasicVehicleMesh::sphericalBody;
+                    for (int t = 0; t < BasicVehicleMesh::sphericalTriangleCount; t++)
+                    {
+                        const Color shade = i.color + BasicVehicleMesh::sphericalShades[t];
+                        for (int v = 0; v < 3; v++, body++)
+                            triangles.add (BasicVehicleMesh::place (*body, r, i.position,
+                                                                    i.side, i.up, i.forward),
+                                           shade);
+                    }
+                }
+            }
+        }
+
+        static OpenSteer::AccountedVector<Instance,
+                   OpenSteer::MemoryAccount::drawQueueMemory>::type instances;
+        static ColoredVertexArray triangles;
+        static ColoredVertexArray lines;
+        static bool open;
+    };
+
+
+    OpenSteer::AccountedVector<VehicleBatch::Instance,
+        OpenSteer::MemoryAccount::drawQueueMemory>::type VehicleBatch::instances;
+    ColoredVertexArray VehicleBatch::triangles;
+    ColoredVertexArray VehicleBatch::lines;
+    bool VehicleBatch::open = false;
+
+
+    void
+    VehicleBatch::draw (void)
+    {
+        expand ();
+        instances.clear ();
+        open = false;
+
+        // the 2d bodies are double sided
+        beginDoubleSidedDrawing ();
+        triangles.draw (GL_TRIANGLES);
+        lines.draw (GL_LINES);
+        endDoubleSidedDrawing ();
+    }
+
+} // anonymous namespace
+
+
+void 
+OpenSteer::beginVehicleBatch (void)
+{
+    VehicleBatch::begin ();
+}
+
+
+void 
+OpenSteer::drawVehicleBatch (void)
+{
+    VehicleBatch::draw ();
+}
+
+
 // ------------------------------------------------------------------------
 // a simple 2d vehicle on the XZ plane
 
@@ -513,30 +725,31 @@ void
 OpenSteer::drawBasic2dCircularVehicle (const AbstractVehicle& vehicle,
                                        const Color& color)
 {
-    // "aspect ratio" of body (as seen from above)
-    const float x = 0.5f;
-    const float y = sqrtXXX (1 - (x * x));
+    if (VehicleBatch::isOpen ())
+    {
+        VehicleBatch::add (vehicle, color, VehicleBatch::circular2d);
+        return;
+    }
 
-    // radius and position of vehicle
+    // radius and position of vehicle, slightly up
     const float r = vehicle.radius();
-    const Vec3& p = vehicle.position();
-
-    // shape of triangular body
-    const Vec3 u = r * 0.05f * Vec3 (0, 1, 0); // slightly up
-    const Vec3 f = r * vehicle.forward();
-    const Vec3 s = r * vehicle.side() * x;
-    const Vec3 b = r * vehicle.forward() * -y;
+    const Vec3 p = vehicle.position() +
+                   Vec3 (0, r * BasicVehicleMesh::liftOf2dBody, 0);
 
     // draw double-sided triangle (that is: no (back) face culling)
+    const Vec3* const body = BasicVehicleMesh::flatBody;
+    const Vec3 s = vehicle.side();
+    const Vec3 u = vehicle.up();
+    const Vec3 f = vehicle.forward();
     beginDoubleSidedDrawing ();
-    iDrawTriangle (p + f + u,
-                   p + b - s + u,
-                   p + b + s + u,
+    iDrawTriangle (BasicVehicleMesh::place (body[0], r, p, s, u, f),
+                   BasicVehicleMesh::place (body[1], r, p, s, u, f),
+                   BasicVehicleMesh::place (body[2], r, p, s, u, f),
                    color);
     endDoubleSidedDrawing ();
 
     // draw the circular collision boundary
-    drawXZCircle (r, p + u, gWhite, 20);
+    drawXZCircle (r, p, gWhite, 20);
 }
 
 
@@ -548,43 +761,14 @@ void
 OpenSteer::drawBasic3dSphericalVehicle (const AbstractVehicle& vehicle,
                                         const Color& color)
 {
-    // "aspect ratio" of body (as seen from above)
-    const float x = 0.5f;
-    const float y = sqrtXXX (1 - (x * x));
-
-    // radius and position of vehicle
-    const float r = vehicle.radius();
-    const Vec3& p = vehicle.position();
-
-    // body shape parameters
-    const Vec3 f = r * vehicle.forward();
-    const Vec3 s = r * vehicle.side() * x;
-    const Vec3 u = r * vehicle.up() * x * 0.5f;
-    const Vec3 b = r * vehicle.forward() * -y;
-
-    // vertex positions
-    const Vec3 nose   = p + f;
-    const Vec3 side1  = p + b - s;
-    const Vec3 side2  = p + b + s;
-    const Vec3 top    = p + b + u;
-    const Vec3 bottom = p + b - u;
-
-    // colors
-    const float j = +0.05f;
-    const float k = -0.05f;
-    const Color color1 = color + Color(j, j, k);
-    const Color color2 = color + Color(j, k, j);
-    const Color color3 = color + Color(k, j, j);
-    const Color color4 = color + Color(k, j, k);
-    const Color color5 = color + Color(k, k, j);
+    if (VehicleBatch::isOpen ())
+    {
+        VehicleBatch::add (vehicle, color, VehicleBatch::spherical3d);
+        return;
+    }
 
     // draw body
-    iDrawTriangle (nose,  side1,  top,    color1);  // top, side 1
-    iDrawTriangle (nose,  top,    side2,  color2);  // top, side 2
-    iDrawTriangle (nose,  bottom, side1,  color3);  // bottom, side 1
-    iDrawTriangle (nose,  side2,  bottom, color4);  // bottom, side 2
-    iDrawTriangle (side1, side2,  top,    color5);  // top back
-    iDrawTriangle (side2, side1,  bottom, color5);  // bottom back
+    drawBasic3dSphericalVehicle (iDrawTriangle, vehicle, color);
 }
 
 
@@ -595,43 +779,20 @@ void
 OpenSteer::drawBasic3dSphericalVehicle (drawTriangleRoutine draw, const AbstractVehicle& vehicle,
                                         const Color& color)
 {
-    // "aspect ratio" of body (as seen from above)
-    const float x = 0.5f;
-    const float y = sqrtXXX (1 - (x * x));
-
-    // radius and position of vehicle
+    // radius, position and basis of vehicle
     const float r = vehicle.radius();
     const Vec3& p = vehicle.position();
-
-    // body shape parameters
-    const Vec3 f = r * vehicle.forward();
-    const Vec3 s = r * vehicle.side() * x;
-    const Vec3 u = r * vehicle.up() * x * 0.5f;
-    const Vec3 b = r * vehicle.forward() * -y;
-
-    // vertex positions
-    const Vec3 nose   = p + f;
-    const Vec3 side1  = p + b - s;
-    const Vec3 side2  = p + b + s;
-    const Vec3 top    = p + b + u;
-    const Vec3 bottom = p + b - u;
-
-    // colors
-    const float j = +0.05f;
-    const float k = -0.05f;
-    const Color color1 = color + Color (j, j, k);
-    const Color color2 = color + Color (j, k, j);
-    const Color color3 = color + Color (k, j, j);
-    const Color color4 = color + Color (k, j, k);
-    const Color color5 = color + Color (k, k, j);
-
-    // draw body
-    draw (nose,  side1,  top,    color1);  // top, side 1
-    draw (nose,  top,    side2,  color2);  // top, side 2
-    draw (nose,  bottom, side1,  color3);  // bottom, side 1
-    draw (nose,  side2,  bottom, color4);  // bottom, side 2
-    draw (side1, side2,  top,    color5);  // top back
-    draw (side2, side1,  bottom, color5);  // bottom back
+    const Vec3 s = vehicle.side();
+    const Vec3 u = vehicle.up();
+    const Vec3 f = vehicle.forward();
+
+    // draw body: each triangle of the mesh placed for the vehicle
+    const Vec3* body = BasicVehicleMesh::sphericalBody;
+    for (int t = 0; t < BasicVehicleMesh::sphericalTriangleCount; t++, body += 3)
+        draw (BasicVehicleMesh::place (body[0], r, p, s, u, f),
+              BasicVehicleMesh::place (body[1], r, p, s, u, f),
+              BasicVehicleMesh::place (body[2], r, p, s, u, f),
+              color + BasicVehicleMesh::sphericalShades[t]);
 }
 
 
@@ -639,43 +800,117 @@ OpenSteer::drawBasic3dSphericalVehicle (drawTriangleRoutine draw, const Abstract
 
 
 // ------------------------------------------------------------------------
-// draw a (filled-in, polygon-based) square checkerboard grid on the XZ
-// (horizontal) plane.
-//
-// ("size" is the length of a side of the overall grid, "subsquares" is the
-// number of subsquares along each edge (for example a standard checkboard
-// has eight), "center" is the 3d position of the center of the grid,
-// color1 and color2 are used for alternating subsquares.)
+// vertex arrays of checkerboard grids centered on the origin, built once for
+// each size, subsquare count and pair of colors drawn (the few most recently
+// drawn are kept) and moved to the grid's center as it is drawn
 
 
-void 
-OpenSteer::drawXZCheckerboardGrid (const float size,
-                                   const int subsquares,
-                                   const Vec3& center,
-                                   const Color& color1,
-                                   const Color& color2)
-{
-    const float half = size/2;
-    const float spacing = size / subsquares;
+namespace {
 
-    beginDoubleSidedDrawing ();
+    class CheckerboardCache
+    {
+    public:
+
+        static const ColoredVertexArray& grid (const float size,
+                                               const int subsquares,
+                                               const OpenSteer::Color& color1,
+                                               const OpenSteer::Color& color2);
+
+    private:
+
+        struct Entry
+        {
+            float size;
+            int subsquares;
+            OpenSteer::Color color1, color2;
+            ColoredVertexArray triangles;
+
+            bool matches (const float s, const int n,
+                          const OpenSteer::Color& c1,
+                          const OpenSteer::Color& c2) const
+            {
+                return (size == s) && (subsquares == n) &&
+                       sameColor (color1, c1) && sameColor (color2, c2);
+            }
+        };
+
+        static bool sameColor (const OpenSteer::Color& a,
+                               const OpenSteer::Color& b)
+        {
+            return (a.r() == b.r()) && (a.g() == b.g()) && (a.b() == b.b());
+        }
+
+        static void build (Entry& entry);
+
+        enum {capacity = 4};
+
+        // most recently drawn first
+        static std::list<Entry> entries;
+    };
+
+
+    std::list<CheckerboardCache::Entry> CheckerboardCache::entries;
+
+
+    const ColoredVertexArray&
+    CheckerboardCache::grid (const float size,
+                             const int subsquares,
+                             const OpenSteer::Color& color1,
+                             const OpenSteer::Color& color2)
+    {
+        typedef std::list<Entry>::iterator iterator;
+        for (iterator i = entries.begin(); i != entries.end(); i++)
+        {
+            if (i->matches (size, subsquares, color1, color2))
+            {
+                entries.splice (entries.begin(), entries, i);
+                return entries.front().triangles;
+            }
+        }
+
+        if (entries.size() >= capacity) entries.pop_back ();
+        entries.push_front (Entry ());
+        Entry& entry = entries.front();
+        entry.size = size;
+        entry.subsquares = subsquares;
+        entry.color1 = color1;
+        entry.color2 = color2;
+        build (entry);
+        return entry.triangles;
+    }
+
+
+    // each subsquare as two triangles, in the order (and with the
+    // alternating colors) drawXZCheckerboardGrid always drew them
+    void
+    CheckerboardCache::build (Entry& entry)
     {
+        using namespace OpenSteer;
+
+        const float half = entry.size/2;
+        const float spacing = entry.size / entry.subsquares;
+
         bool flag1 = false;
         float p = -half;
         Vec3 corner;
-        for (int i = 0; i < subsquares; i++)
+        for (int i = 0; i < entry.subsquares; i++)
         {
             bool flag2 = flag1;
             float q = -half;
-            for (int j = 0; j < subsquares; j++)
+            for (int j = 0; j < entry.subsquares; j++)
             {
                 corner.set (p, 0, q);
-                corner += center;
-                iDrawQuadrangle (corner,
-                                 corner + Vec3 (spacing, 0,       0),
-                                 corner + Vec3 (spacing, 0, spacing),
-                                 corner + Vec3 (0,       0, spacing),
-                                 flag2 ? color1 : color2);
+                const Vec3 a = corner;
+                const Vec3 b = corner + Vec3 (spacing, 0,       0);
+                const Vec3 c = corner + Vec3 (spacing, 0, spacing);
+                const Vec3 d = corner + Vec3 (0,       0, spacing);
+                const Color& color = flag2 ? entry.color1 : entry.color2;
+                entry.triangles.add (a, color);
+                entry.triangles.add (b, color);
+                entry.triangles.add (c, color);
+                entry.triangles.add (a, color);
+                entry.triangles.add (c, color);
+                entry.triangles.add (d, color);
                 flag2 = !flag2;
                 q += spacing;
             }
@@ -683,7 +918,36 @@ OpenSteer::drawXZCheckerboardGrid (const float size,
             p += spacing;
         }
     }
+
+} // anonymous namespace
+
+
+// ------------------------------------------------------------------------
+// draw a (filled-in, polygon-based) square checkerboard grid on the XZ
+// (horizontal) plane.
+//
+// ("size" is the length of a side of the overall grid, "subsquares" is the
+// number of subsquares along each edge (for example a standard checkboard
+// has eight), "center" is the 3d position of the center of the grid,
+// color1 and color2 are used for alternating subsquares.)
+
+
+void 
+OpenSteer::drawXZCheckerboardGrid (const float size,
+                                   const int subsquares,
+                                   const Vec3& center,
+                                   const Color& color1,
+                                   const Color& color2)
+{
+    const ColoredVertexArray& grid =
+        CheckerboardCache::grid (size, subsquares, color1, color2);
+
+    glPushMatrix ();
+    glTranslatef (center.x, center.y, center.z);
+    beginDoubleSidedDrawing ();
+    grid.draw (GL_TRIANGLES);
     endDoubleSidedDrawing ();
+    glPopMatrix ();
 }
 
 
@@ -861,6 +1125,26 @@ OpenSteer::draw2dLine (const Vec3& startPoint,
     end2dDrawing (originalMatrixMode);
 }
 
+
+void 
+OpenSteer::draw2dLines (const Vec3* endPoints,
+                        const Color* colors,
+                        const size_t lineCount,
+                        float w, float h)
+{
+    static ColoredVertexArray lines;
+    lines.clear ();
+    for (size_t i = 0; i < lineCount; i++)
+    {
+        lines.add (endPoints[2*i],   colors[i]);
+        lines.add (endPoints[2*i+1], colors[i]);
+    }
+
+    const GLint originalMatrixMode = begin2dDrawing (w, h);
+    lines.draw (GL_LINES);
+    end2dDrawing (originalMatrixMode);
+}
+
 // ------------------------------------------------------------------------
 // draw a reticle at the center of the window.  Currently it is small
 // crosshair with a gap at the center, drawn in white with black borders
@@ -961,42 +1245,35 @@ namespace {
                                  const OpenSteer::Vec3& e,
                                  const OpenSteer::Color& c)
         {
-            DeferredLine dl;
-            dl.startPoint = s;
-            dl.endPoint = e;
-            dl.color = c;
-
-            lines.push_back (dl);
+            lines.add (s, c);
+            lines.add (e, c);
         }
 
         static void drawAll (void)
         {
-            // draw all deferred lines
-            for (DeferredLines::iterator i = lines.begin();
-                 i < lines.end();
-                 i++)
-            {
-                DeferredLine& dl = *i;
-                iDrawLine (dl.startPoint, dl.endPoint, dl.color);
-            }
-
-            // clear list of deferred lines
+            // draw all deferred lines with one call, then clear the list
+            // (keeping its storage for the next frame)
+            lines.draw (GL_LINES);
             lines.clear ();
         }
 
-        typedef std::vector<DeferredLine> DeferredLines;
-
     private:
 
-        OpenSteer::Vec3 startPoint;
-        OpenSteer::Vec3 endPoint;
-        OpenSteer::Color color;
-
-        static DeferredLines lines;
+        static ColoredVertexArray lines;
     };
 
 
-DeferredLine::DeferredLines DeferredLine::lines;
+ColoredVertexArray DeferredLine::lines;
+
+
+// while set, deferred annotation goes into this snapshot instead (per
+// thread, so the display thread keeps queueing its own annotation)
+
+namespace {
+
+    thread_local OpenSteer::SimulationSnapshot* annotationCapture = NULL;
+
+} // anonymous namespace
 
 
 } // anonymous namespace
@@ -1007,7 +1284,10 @@ OpenSteer::deferredDrawLine (const Vec3& startPoint,
                              const Vec3& endPoint,
                              const Color& color)
 {
-    DeferredLine::addToBuffer (startPoint, endPoint, color);
+    if (annotationCapture)
+        annotationCapture->addLine (startPoint, endPoint, color);
+    else
+        DeferredLine::addToBuffer (startPoint, endPoint, color);
 }
 
 
@@ -1032,6 +1312,9 @@ namespace {
     {
     public:
 
+        // the circle's points go straight into the vertex arrays: line
+        // pairs for circles, triangles for disks (as drawCircleOrDisk
+        // would draw them)
         static void addToBuffer (const float radius,
                                  const OpenSteer::Vec3& axis,
                                  const OpenSteer::Vec3& center,
@@ -1040,50 +1323,74 @@ namespace {
                                  const bool filled,
                                  const bool in3d)
         {
-            DeferredCircle dc;
-            dc.radius   = radius;
-            dc.axis     = axis;
-            dc.center   = center;
-            dc.color    = color;
-            dc.segments = segments;
-            dc.filled   = filled;
-            dc.in3d     = in3d;
-            circles.push_back (dc);
+            using namespace OpenSteer;
+
+            LocalSpace ls;
+            if (in3d)
+            {
+                // define a local space with "axis" as the Y/up direction
+                const Vec3 unitAxis = axis.normalize ();
+                const Vec3 unitPerp = findPerpendicularIn3d (axis).normalize ();
+                ls.setUp (unitAxis);
+                ls.setForward (unitPerp);
+                ls.setPosition (center);
+                ls.setUnitSideFromForwardAndUp ();
+            }
+
+            // points around the (local) Y axis, "segments" steps apart
+            const Vec3* const circle = UnitCircleTable::points (segments);
+
+            Vec3 first, previous;
+            for (int i = 0; i <= segments; i++)
+            {
+                const Vec3 pointOnCircle = radius * circle[i];
+                const Vec3 p = (i == segments) ? first :
+                    (in3d ?
+                     ls.globalizePosition (pointOnCircle) :
+                     (Vec3) (pointOnCircle + center));
+                if (i == 0)
+                {
+                    first = p;
+                }
+                else if (filled)
+                {
+                    disks.add (center, color);
+                    disks.add (previous, color);
+                    disks.add (p, color);
+                }
+                else
+                {
+                    outlines.add (previous, color);
+                    outlines.add (p, color);
+                }
+                previous = p;
+            }
         }
 
         static void drawAll (void)
         {
-            // draw all deferred circles
-            for (DeferredCircles::iterator i = circles.begin();
-                 i < circles.end();
-                 i++)
+            // draw all deferred circles and (double sided) disks with one
+            // call each, then clear the lists (keeping their storage)
+            outlines.draw (GL_LINES);
+            if (! disks.empty ())
             {
-                DeferredCircle& dc = *i;
-                drawCircleOrDisk (dc.radius, dc.axis, dc.center, dc.color,
-                                  dc.segments, dc.filled, dc.in3d);
+                beginDoubleSidedDrawing ();
+                disks.draw (GL_TRIANGLES);
+                endDoubleSidedDrawing ();
             }
-
-            // clear list of deferred circles
-            circles.clear ();
+            outlines.clear ();
+            disks.clear ();
         }
 
-        typedef std::vector<DeferredCircle> DeferredCircles;
-
     private:
 
-        float radius;
-        OpenSteer::Vec3 axis;
-        OpenSteer::Vec3 center;
-        OpenSteer::Color color;
-        int segments;
-        bool filled;
-        bool in3d;
-
-        static DeferredCircles circles;
+        static ColoredVertexArray outlines;
+        static ColoredVertexArray disks;
     };
 
 
-DeferredCircle::DeferredCircles DeferredCircle::circles;
+ColoredVertexArray DeferredCircle::outlines;
+ColoredVertexArray DeferredCircle::disks;
 
 
 } // anonymous namesopace
@@ -1098,8 +1405,12 @@ OpenSteer::deferredDrawCircleOrDisk (const float radius,
                                      const bool filled,
                                      const bool in3d)
 {
-    DeferredCircle::addToBuffer (radius, axis, center, color,
-                                 segments, filled, in3d);
+    if (annotationCapture)
+        annotationCapture->addCircleOrDisk (radius, axis, center, color,
+                                            segments, filled, in3d);
+    else
+        DeferredCircle::addToBuffer (radius, axis, center, color,
+                                     segments, filled, in3d);
 }
 
 
@@ -1110,6 +1421,38 @@ OpenSteer::drawAllDeferredCirclesOrDisks (void)
 }
 
 
+// ----------------------------------------------------------------------------
+// annotation recorded into a snapshot rather than the deferred draw queues
+
+
+OpenSteer::SimulationSnapshot*
+OpenSteer::captureDeferredAnnotation (SimulationSnapshot* snapshot)
+{
+    SimulationSnapshot* const previous = annotationCapture;
+    annotationCapture = snapshot;
+    return previous;
+}
+
+
+void
+OpenSteer::drawSnapshotAnnotation (const SimulationSnapshot& snapshot)
+{
+    for (size_t i = 0; i < snapshot.lines.size(); i++)
+    {
+        const SimulationSnapshot::Line& l = snapshot.lines[i];
+        DeferredLine::addToBuffer (l.startPoint, l.endPoint, l.color);
+    }
+    for (size_t i = 0; i < snapshot.circles.size(); i++)
+    {
+        const SimulationSnapshot::CircleOrDisk& c = snapshot.circles[i];
+        DeferredCircle::addToBuffer (c.radius, c.axis, c.center, c.color,
+                                     c.segments, c.filled, c.in3d);
+    }
+    DeferredLine::drawAll ();
+    DeferredCircle::drawAll ();
+}
+
+
 // ------------------------------------------------------------------------
 // Functions for drawing text (in GLUT's 9x15 bitmap font) in a given
 // color, starting at a location on the screen which can be specified
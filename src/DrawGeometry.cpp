@@ -0,0 +1,178 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// DrawGeometry
+//
+// Cached geometry for the drawing routines.  See DrawGeometry.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/DrawGeometry.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "OpenSteer/MemoryAccount.h"
+#include "OpenSteer/Utilities.h"
+
+
+namespace {
+
+    // the tables of small segment counts are published through atomic
+    // pointers (constant initialized) so lookups need no lock, larger
+    // counts are kept in a map.  Tables are never freed.
+
+    std::atomic<const OpenSteer::Vec3*>
+        lockFreeTables [OpenSteer::UnitCircleTable::maxLockFreeSegments + 1];
+
+    std::mutex& tablesMutex (void)
+    {
+        static std::mutex m;
+        return m;
+    }
+
+    std::map<int, const OpenSteer::Vec3*>& largeTables (void)
+    {
+        static std::map<int, const OpenSteer::Vec3*> tables;
+        return tables;
+    }
+
+    const OpenSteer::Vec3* makeTable (const int segments)
+    {
+        using namespace OpenSteer;
+
+        // each point straight from its angle, so the error does not grow
+        // around the circle as it does with repeated rotation
+        Vec3* const table = new Vec3 [segments + 1];
+        const float step = (2 * OPENSTEER_M_PI) / segments;
+        for (int i = 0; i < segments; i++)
+        {
+            const float angle = step * i;
+            table[i] = Vec3 (cosXXX (angle), 0, -sinXXX (angle));
+        }
+        table[segments] = table[0];
+        MemoryAccount::add (MemoryAccount::drawQueueMemory,
+                            sizeof (Vec3) * (segments + 1));
+        return table;
+    }
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+const OpenSteer::Vec3* 
+OpenSteer::UnitCircleTable::points (const int requestedSegments)
+{
+    const int segments = (requestedSegments < 1) ? 1 : requestedSegments;
+    const bool lockFree = segments <= maxLockFreeSegments;
+    if (lockFree)
+    {
+        const Vec3* const table =
+            lockFreeTables[segments].load (std::memory_order_acquire);
+        if (table) return table;
+    }
+
+    std::lock_guard<std::mutex> lock (tablesMutex ());
+    if (lockFree)
+    {
+        // another thread may have made it while this one waited
+        const Vec3* table =
+            lockFreeTables[segments].load (std::memory_order_relaxed);
+        if (! table)
+        {
+            table = makeTable (segments);
+            lockFreeTables[segments].store (table, std::memory_order_release);
+        }
+        return table;
+    }
+    const Vec3*& table = largeTables ()[segments];
+    if (! table) table = makeTable (segments);
+    return table;
+}
+
+
+// ----------------------------------------------------------------------------
+// the body is a triangle (2d) or a flattened pyramid (3d) with its nose at
+// the front of the vehicle's bounding circle and its back 0.5 to either
+// side, sqrt (1 - 0.5^2) behind the center
+
+
+namespace {
+
+    const float halfWidth = 0.5f;
+    const float back = -0.8660254f;
+    const float halfHeight = halfWidth * 0.5f;
+
+    const OpenSteer::Vec3 nose   (0, 0, 1);
+    const OpenSteer::Vec3 side1  (-halfWidth, 0, back);
+    const OpenSteer::Vec3 side2  (+halfWidth, 0, back);
+    const OpenSteer::Vec3 top    (0, +halfHeight, back);
+    const OpenSteer::Vec3 bottom (0, -halfHeight, back);
+
+    const float j = +0.05f;
+    const float k = -0.05f;
+
+} // anonymous namespace
+
+
+const OpenSteer::Vec3 OpenSteer::BasicVehicleMesh::flatBody [3] =
+{
+    nose, side1, side2
+};
+
+
+const float OpenSteer::BasicVehicleMesh::liftOf2dBody = 0.05f;
+
+
+const OpenSteer::Vec3 OpenSteer::BasicVehicleMesh::sphericalBody
+                      [sphericalTriangleCount * 3] =
+{
+    nose,  side1,  top,     // top, side 1
+    nose,  top,    side2,   // top, side 2
+    nose,  bottom, side1,   // bottom, side 1
+    nose,  side2,  bottom,  // bottom, side 2
+    side1, side2,  top,     // top back
+    side2, side1,  bottom   // bottom back
+};
+
+
+const OpenSteer::Color OpenSteer::BasicVehicleMesh::sphericalShades
+                       [sphericalTriangleCount] =
+{
+    Color (j, j, k),
+    Color (j, k, j),
+    Color (k, j, j),
+    Color (k, j, k),
+    Color (k, k, j),
+    Color (k, k, j)
+};
@@ -0,0 +1,541 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// FlockEngine
+//
+// See FlockEngine.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/FlockEngine.h"
+
+#include <cmath>
+#include "OpenSteer/WorkerPool.h"
+#include "OpenSteer/Utilities.h"
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace {
+
+    // grid cells along the longest axis, at most: the cells grow beyond
+    // the largest flocking radius for a widely spread flock instead
+    const size_t maxCellsPerAxis = 64;
+
+
+    class SteerPass
+    {
+    public:
+        SteerPass (OpenSteer::FlockEngine& e) : engine (e) {}
+
+        void operator() (size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++) engine.steer (i);
+        }
+
+    private:
+        OpenSteer::FlockEngine& engine;
+    };
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::FlockEngine::Parameters::Parameters (void)
+    : separationRadius (5.0f), separationAngle (-0.707f),
+      separationWeight (12.0f),
+      alignmentRadius (7.5f), alignmentAngle (0.7f), alignmentWeight (8.0f),
+      cohesionRadius (9.0f), cohesionAngle (-0.15f), cohesionWeight (8.0f),
+      minTimeToCollision (1.0f),
+      wrapAroundRadius (50.0f),
+      approximation (0), errorSampleStride (0)
+{
+}
+
+
+OpenSteer::FlockEngine::FlockEngine (void)
+    : _population (VehiclePopulation::banking),
+      _cellSize (1),
+      _errorMean (0), _errorMax (0), _errorSamples (0)
+{
+    _cells[0] = _cells[1] = _cells[2] = 0;
+}
+
+
+void 
+OpenSteer::FlockEngine::setObstacles
+    (const std::vector<const SphereObstacle*>& spheres)
+{
+    _obstacleCenter.clear ();
+    _obstacleRadius.clear ();
+    _obstacleSeenFrom.clear ();
+    for (size_t i = 0; i < spheres.size(); i++)
+    {
+        _obstacleCenter.push_back (spheres[i]->center);
+        _obstacleRadius.push_back (spheres[i]->radius);
+        _obstacleSeenFrom.push_back (spheres[i]->seenFrom ());
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::FlockEngine::step (const float elapsedTime, WorkerPool* pool)
+{
+    const size_t n = _population.size ();
+    _steering.resize (n);
+    _neighborCount.resize (n);
+    if (n == 0) return;
+
+    buildGrid ();
+
+    SteerPass steerPass (*this);
+    if (pool)
+        pool->parallelFor (n, steerPass);
+    else
+        steerPass (0, n);
+
+    measureApproximationError ();
+
+    if (pool)
+        _population.applySteeringForces (&_steering[0], elapsedTime, *pool);
+    else
+        _population.applySteeringForces (&_steering[0], elapsedTime);
+
+    // wrap around to contrain boids within the spherical boundary
+    const float r = _parameters.wrapAroundRadius;
+    if (r > 0)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            Vec3 p = _population.position (i);
+            if (p.length () > r)
+                _population.setPosition (i, p.sphericalWrapAround (Vec3::zero,
+                                                                   r));
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// bounds and grid passes: a counting sort of the boids by cell
+
+
+void 
+OpenSteer::FlockEngine::buildGrid (void)
+{
+    const size_t n = _population.size ();
+
+    // bounds
+    Vec3 lo = _population.position (0);
+    Vec3 hi = lo;
+    for (size_t i = 1; i < n; i++)
+    {
+        const Vec3 p = _population.position (i);
+        lo.set (minXXX (lo.x, p.x), minXXX (lo.y, p.y), minXXX (lo.z, p.z));
+        hi.set (maxXXX (hi.x, p.x), maxXXX (hi.y, p.y), maxXXX (hi.z, p.z));
+    }
+
+    // cells at least as wide as the largest flocking radius, so that the
+    // 27 cells around a boid hold all of its neighbors, or when far cells
+    // are aggregated, as wide as the separation radius
+    const Parameters& f = _parameters;
+    const float maxRadius = maxXXX (f.separationRadius,
+                                    maxXXX (f.alignmentRadius,
+                                            f.cohesionRadius));
+    const float cellRadius = ((f.approximation > 0) ?
+                              f.separationRadius : maxRadius);
+    const Vec3 extent = hi - lo;
+    const float longest = maxXXX (extent.x, maxXXX (extent.y, extent.z));
+    _cellSize = maxXXX (cellRadius, longest / maxCellsPerAxis);
+    _origin = lo;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        const float e = (axis == 0) ? extent.x : ((axis == 1) ? extent.y : extent.z);
+        _cells[axis] = minXXX ((size_t) (e / _cellSize) + 1, maxCellsPerAxis);
+    }
+    const size_t cellCount = _cells[0] * _cells[1] * _cells[2];
+
+    // count the boids of each cell (in the slot after it), then turn the
+    // counts into each cell's start by an inclusive prefix sum
+    _cellStart.assign (cellCount + 1, 0);
+    _cellOf.resize (n);
+    size_t cx, cy, cz;
+    for (size_t i = 0; i < n; i++)
+    {
+        _cellOf[i] = cellIndex (_population.position (i), cx, cy, cz);
+        _cellStart[_cellOf[i] + 1]++;
+    }
+    for (size_t c = 1; c <= cellCount; c++) _cellStart[c] += _cellStart[c - 1];
+
+    // scatter into cell order (by index within each cell)
+    _cellFill.assign (_cellStart.begin(), _cellStart.end() - 1);
+    _sortedIndex.resize (n);
+    _sortedX.resize (n); _sortedY.resize (n); _sortedZ.resize (n);
+    _sortedFX.resize (n); _sortedFY.resize (n); _sortedFZ.resize (n);
+    for (size_t i = 0; i < n; i++)
+    {
+        const size_t j = _cellFill[_cellOf[i]]++;
+        const Vec3 p = _population.position (i);
+        const Vec3 forward = _population.forward (i);
+        _sortedIndex[j] = i;
+        _sortedX[j] = p.x; _sortedY[j] = p.y; _sortedZ[j] = p.z;
+        _sortedFX[j] = forward.x; _sortedFY[j] = forward.y; _sortedFZ[j] = forward.z;
+    }
+
+    // aggregates: the sums of the positions and forwards in each cell
+    if (f.approximation > 0)
+    {
+        _cellPX.assign (cellCount, 0); _cellPY.assign (cellCount, 0);
+        _cellPZ.assign (cellCount, 0);
+        _cellFX.assign (cellCount, 0); _cellFY.assign (cellCount, 0);
+        _cellFZ.assign (cellCount, 0);
+        for (size_t c = 0; c < cellCount; c++)
+        {
+            for (size_t j = _cellStart[c]; j < _cellStart[c + 1]; j++)
+            {
+                _cellPX[c] += _sortedX[j]; _cellPY[c] += _sortedY[j];
+                _cellPZ[c] += _sortedZ[j];
+                _cellFX[c] += _sortedFX[j]; _cellFY[c] += _sortedFY[j];
+                _cellFZ[c] += _sortedFZ[j];
+            }
+        }
+    }
+}
+
+
+size_t 
+OpenSteer::FlockEngine::cellIndex (const Vec3& p,
+                                   size_t& cx, size_t& cy, size_t& cz) const
+{
+    const Vec3 local = (p - _origin) / _cellSize;
+    cx = minXXX ((size_t) maxXXX (local.x, 0.0f), _cells[0] - 1);
+    cy = minXXX ((size_t) maxXXX (local.y, 0.0f), _cells[1] - 1);
+    cz = minXXX ((size_t) maxXXX (local.z, 0.0f), _cells[2] - 1);
+    return (cz * _cells[1] + cy) * _cells[0] + cx;
+}
+
+
+// ----------------------------------------------------------------------------
+// steer pass
+
+
+void 
+OpenSteer::FlockEngine::steer (size_t i)
+{
+    // avoid obstacles if needed (leaving the neighbor count as it was, as
+    // Boid::steerToFlock does)
+    const Vec3 avoidance = steerToAvoidObstacles (i);
+    if (avoidance != Vec3::zero)
+    {
+        _steering[i] = avoidance;
+        return;
+    }
+
+    _steering[i] = steerToFlock (i, _parameters.approximation,
+                                 _neighborCount[i]);
+}
+
+
+// separation, alignment and cohesion of boid i, with the far cells of
+// the grid taken as aggregates when approximation is above zero
+
+
+OpenSteer::Vec3 
+OpenSteer::FlockEngine::steerToFlock (size_t i, const float approximation,
+                                      size_t& neighborCount) const
+{
+    const Parameters& f = _parameters;
+    const float maxRadius = maxXXX (f.separationRadius,
+                                    maxXXX (f.alignmentRadius,
+                                            f.cohesionRadius));
+    const float maxRadiusSquared = maxRadius * maxRadius;
+    const Vec3 position = _population.position (i);
+    const Vec3 forward = _population.forward (i);
+    const float minDistance = _population.radius (i) * 3;
+    const float minDistanceSquared = minDistance * minDistance;
+
+    // cells nearer than this may hold boids whose separation (or whose
+    // "inside" rule of inBoidNeighborhood) only counts them one by one
+    const float exactDistance = maxXXX (f.separationRadius, minDistance);
+
+    // sums of the three behaviors over the boids in their neighborhoods,
+    // as in inBoidNeighborhood
+    Vec3 separation, alignment, cohesion;
+    int alignmentNeighbors = 0;
+    int cohesionNeighbors = 0;
+    size_t neighbors = 0;
+
+    // the cells reaching within maxRadius of the boid's cell
+    size_t cx, cy, cz;
+    cellIndex (position, cx, cy, cz);
+    const size_t reach = (size_t) ceilf (maxRadius / _cellSize);
+    const size_t x0 = (cx > reach) ? cx - reach : 0;
+    const size_t y0 = (cy > reach) ? cy - reach : 0;
+    const size_t z0 = (cz > reach) ? cz - reach : 0;
+    const size_t x1 = minXXX (cx + reach, _cells[0] - 1);
+    const size_t y1 = minXXX (cy + reach, _cells[1] - 1);
+    const size_t z1 = minXXX (cz + reach, _cells[2] - 1);
+    for (size_t z = z0; z <= z1; z++)
+    {
+        for (size_t y = y0; y <= y1; y++)
+        {
+            const size_t row = (z * _cells[1] + y) * _cells[0];
+            for (size_t x = x0; x <= x1; x++)
+            {
+                const size_t cell = row + x;
+                const size_t begin = _cellStart[cell];
+                const size_t end = _cellStart[cell + 1];
+                if (begin == end) continue;
+
+                // a far cell counts as one boid of its size at its centroid
+                if (approximation > 0)
+                {
+                    const Vec3 cellLo = _origin + (Vec3 ((float) x,
+                                                         (float) y,
+                                                         (float) z) * _cellSize);
+                    const Vec3 offsetLo = cellLo - position;
+                    const Vec3 offsetHi = offsetLo + Vec3 (_cellSize, _cellSize,
+                                                           _cellSize);
+                    const Vec3 gap (maxXXX (maxXXX (offsetLo.x, -offsetHi.x), 0.0f),
+                                    maxXXX (maxXXX (offsetLo.y, -offsetHi.y), 0.0f),
+                                    maxXXX (maxXXX (offsetLo.z, -offsetHi.z), 0.0f));
+                    const float gap2 = gap.lengthSquared ();
+                    if (gap2 >= maxRadiusSquared) continue;
+
+                    const float count = (float) (end - begin);
+                    const Vec3 offset =
+                        (Vec3 (_cellPX[cell], _cellPY[cell], _cellPZ[cell]) / count)
+                        - position;
+                    const float d2 = offset.lengthSquared ();
+                    if ((gap2 > exactDistance * exactDistance) &&
+                        (_cellSize * _cellSize < approximation * approximation * d2))
+                    {
+                        if (! (d2 < maxRadiusSquared)) continue;
+                        neighbors += end - begin;
+                        const float forwardness = forward.dot (offset / sqrt (d2));
+                        if ((d2 <= f.alignmentRadius * f.alignmentRadius) &&
+                            (forwardness > f.alignmentAngle))
+                        {
+                            alignment += Vec3 (_cellFX[cell], _cellFY[cell],
+                                               _cellFZ[cell]);
+                            alignmentNeighbors += (int) (end - begin);
+                        }
+                        if ((d2 <= f.cohesionRadius * f.cohesionRadius) &&
+                            (forwardness > f.cohesionAngle))
+                        {
+                            cohesion += offset * count;
+                            cohesionNeighbors += (int) (end - begin);
+                        }
+                        continue;
+                    }
+                }
+
+                for (size_t j = begin; j < end; j++)
+                {
+                    const Vec3 offset (_sortedX[j] - position.x,
+                                       _sortedY[j] - position.y,
+                                       _sortedZ[j] - position.z);
+                    const float d2 = offset.lengthSquared ();
+                    if (! (d2 < maxRadiusSquared)) continue;
+                    neighbors++;
+                    if (_sortedIndex[j] == i) continue;
+
+                    const bool inside = d2 < minDistanceSquared;
+                    const float forwardness =
+                        inside ? 0 : forward.dot (offset / sqrt (d2));
+
+                    if (inside ||
+                        ((d2 <= f.separationRadius * f.separationRadius) &&
+                         (forwardness > f.separationAngle)))
+                    {
+                        // opposite of the offset direction, with 1/d falloff
+                        separation += (offset / -d2);
+                    }
+                    if (inside ||
+                        ((d2 <= f.alignmentRadius * f.alignmentRadius) &&
+                         (forwardness > f.alignmentAngle)))
+                    {
+                        // accumulate sum of neighbor's heading
+                        alignment += Vec3 (_sortedFX[j], _sortedFY[j], _sortedFZ[j]);
+                        alignmentNeighbors++;
+                    }
+                    if (inside ||
+                        ((d2 <= f.cohesionRadius * f.cohesionRadius) &&
+                         (forwardness > f.cohesionAngle)))
+                    {
+                        // accumulate sum of offsets to neighbor's positions
+                        cohesion += offset;
+                        cohesionNeighbors++;
+                    }
+                }
+            }
+        }
+    }
+    neighborCount = neighbors;
+
+    separation = separation.normalize ();
+    if (alignmentNeighbors > 0)
+        alignment = ((alignment / (float) alignmentNeighbors) - forward).normalize ();
+    if (cohesionNeighbors > 0)
+        cohesion = (cohesion / (float) cohesionNeighbors).normalize ();
+
+    return ((separation * f.separationWeight) +
+            (alignment * f.alignmentWeight) +
+            (cohesion * f.cohesionWeight));
+}
+
+
+// largest and mean difference of the approximated flocking steering from
+// the exact one, over every errorSampleStride'th boid
+
+
+void 
+OpenSteer::FlockEngine::measureApproximationError (void)
+{
+    _errorMean = _errorMax = 0;
+    _errorSamples = 0;
+    const size_t stride = _parameters.errorSampleStride;
+    if ((_parameters.approximation <= 0) || (stride == 0)) return;
+
+    float total = 0;
+    size_t neighbors;
+    for (size_t i = 0; i < _population.size(); i += stride)
+    {
+        const Vec3 approximate =
+            steerToFlock (i, _parameters.approximation, neighbors);
+        const Vec3 exact = steerToFlock (i, 0, neighbors);
+        const float error = Vec3::distance (approximate, exact);
+        total += error;
+        _errorMax = maxXXX (_errorMax, error);
+        _errorSamples++;
+    }
+    _errorMean = total / _errorSamples;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+// the nearest intersection of boid i's forward path with the spheres, as
+// SphereObstacle::findIntersectionWithVehiclePath finds them, and the
+// lateral steering of PathIntersection::steerToAvoidIfNeeded to avoid it
+
+
+OpenSteer::Vec3 
+OpenSteer::FlockEngine::steerToAvoidObstacles (size_t i) const
+{
+    // only intersections nearer than this can cause steering
+    const float speed = _population.speed (i);
+    const float minDistanceToCollision = _parameters.minTimeToCollision * speed;
+    if ((minDistanceToCollision <= 0) || _obstacleCenter.empty ()) 
+        return Vec3::zero;
+
+    const Vec3 position = _population.position (i);
+    const Vec3 forward = _population.forward (i);
+    const Vec3 side = _population.side (i);
+    const Vec3 up = _population.up (i);
+    const float vehicleRadius = _population.radius (i);
+
+    bool intersect = false;
+    float nearest = 0;
+    Vec3 steerHint;
+    for (size_t k = 0; k < _obstacleCenter.size(); k++)
+    {
+        const Vec3& center = _obstacleCenter[k];
+        const Obstacle::seenFromState seenFrom = _obstacleSeenFrom[k];
+
+        // sphere's center in the boid's local space
+        const Vec3 offset = center - position;
+        const Vec3 lc (offset.dot (side), offset.dot (up), offset.dot (forward));
+        const bool outside = lc.length () > _obstacleRadius[k];
+
+        float distance;
+        Vec3 hint;
+        if (outside && (seenFrom == Obstacle::inside))
+        {
+            // outside a sphere seen from inside: must avoid
+            distance = 0;
+            hint = offset.normalize ();
+        }
+        else
+        {
+            // line-sphere intersection along the local forward axis
+            const float r = _obstacleRadius[k] + vehicleRadius;
+            const float b = -2 * lc.z;
+            const float c = square (lc.x) + square (lc.y) + square (lc.z) - square (r);
+            const float d = (b * b) - (4 * c);
+            if (d < 0) continue;
+            const float s = sqrtXXX (d);
+            const float p = (-b + s) / 2;
+            const float q = (-b - s) / 2;
+            if ((p < 0) && (q < 0)) continue;
+
+            distance =
+                ((p > 0) && (q > 0)) ?
+                ((p < q) ? p : q) :
+                (seenFrom == Obstacle::outside ? 0.0f : ((p > 0) ? p : q));
+            const Vec3 surfacePoint = position + (forward * distance);
+            const Vec3 surfaceNormal = (surfacePoint - center).normalize ();
+            switch (seenFrom)
+            {
+            case Obstacle::outside: hint = surfaceNormal; break;
+            case Obstacle::inside: hint = -surfaceNormal; break;
+            case Obstacle::both:
+                hint = surfaceNormal * (outside ? 1.0f : -1.0f);
+                break;
+            }
+        }
+
+        // of equally near intersections the first sphere's wins
+        if (! intersect || (distance < nearest))
+        {
+            intersect = true;
+            nearest = distance;
+            steerHint = hint;
+        }
+    }
+
+    if (intersect && (nearest < minDistanceToCollision))
+    {
+        const Vec3 lateral = steerHint.perpendicularComponent (forward);
+        return lateral.normalize () * _population.maxForce (i);
+    }
+    return Vec3::zero;
+}
+
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,262 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// FlowField
+//
+// A grid of pathway mappings over the XZ plane.  See FlowField.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/FlowField.h"
+#include "OpenSteer/Pathway.h"
+#include "OpenSteer/PolylineSegmentedPathwaySingleRadius.h"
+#include "OpenSteer/Utilities.h"
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace {
+
+    // how far (as a fraction of the cell size) the mapping continued from
+    // a cell's center may stray from the pathway's at the cell's corners,
+    // and how far the tangents there may turn, for the cell to be exact
+    const float exactTolerance = 0.05f;
+    const float exactTangentDot = 0.999f;
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::FlowField::FlowField (void)
+    : origin (Vec3::zero), size (1), countX (0), countZ (0)
+{
+}
+
+
+void 
+OpenSteer::FlowField::clear (void)
+{
+    cells.clear ();
+    countX = 0;
+    countZ = 0;
+}
+
+
+// ----------------------------------------------------------------------------
+// map each cell's center with the pathway, then check the mapping
+// continued from the center against the pathway's at the four corners
+
+
+void 
+OpenSteer::FlowField::build (const Pathway& path,
+                             const Vec3& minCorner,
+                             const Vec3& maxCorner,
+                             const float cellSize)
+{
+    size = cellSize;
+    origin = minCorner;
+    countX = (int) maxXXX (1, ceil ((maxCorner.x - minCorner.x) / size));
+    countZ = (int) maxXXX (1, ceil ((maxCorner.z - minCorner.z) / size));
+    const float y = (minCorner.y + maxCorner.y) * 0.5f;
+    const float half = size * 0.5f;
+    const float halfDiagonal = half * sqrtXXX (2);
+    const float tolerance = exactTolerance * size;
+
+    cells.resize (countX * countZ);
+    for (int j = 0; j < countZ; j++)
+    {
+        for (int i = 0; i < countX; i++)
+        {
+            Cell& cell = cells[i + (j * countX)];
+            cell.center = Vec3 (origin.x + (i * size) + half,
+                                y,
+                                origin.z + (j * size) + half);
+            cell.onPath = path.mapPointToPath (cell.center,
+                                               cell.tangent,
+                                               cell.outside);
+            cell.pathDistance = path.mapPointToPathDistance (cell.center);
+
+            cell.exact = true;
+            for (int k = 0; (k < 4) && cell.exact; k++)
+            {
+                const Vec3 corner = cell.center +
+                                    Vec3 ((k & 1) ? half : -half,
+                                          0,
+                                          (k & 2) ? half : -half);
+                Vec3 onPath, tangent;
+                float outside, pathDistance;
+                continueMapping (cell, corner,
+                                 onPath, tangent, outside, pathDistance);
+
+                Vec3 exactTangent;
+                float exactOutside;
+                const Vec3 exactOnPath = path.mapPointToPath (corner,
+                                                              exactTangent,
+                                                              exactOutside);
+                const float exactPathDistance =
+                    path.mapPointToPathDistance (corner);
+
+                cell.exact =
+                    ((onPath - exactOnPath).length () < tolerance) &&
+                    (absXXX (outside - exactOutside) < tolerance) &&
+                    (absXXX (pathDistance - exactPathDistance) < tolerance) &&
+                    (tangent.dot (exactTangent) > exactTangentDot);
+            }
+
+            // the distance outside the pathway changes no faster than the
+            // distance moved, so this bounds it over the whole cell
+            cell.interior = cell.exact &&
+                            ((cell.outside + halfDiagonal) < 0);
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// a grid covering the path's points out to its radius, and a cell beyond
+
+
+void 
+OpenSteer::FlowField::build (const PolylineSegmentedPathwaySingleRadius& path,
+                             const float cellSize)
+{
+    Vec3 minCorner = path.point (0);
+    Vec3 maxCorner = path.point (0);
+    for (PolylineSegmentedPathwaySingleRadius::size_type i = 1;
+         i < path.pointCount ();
+         ++i)
+    {
+        const Vec3 p = path.point (i);
+        minCorner = Vec3 (minXXX (minCorner.x, p.x),
+                          minXXX (minCorner.y, p.y),
+                          minXXX (minCorner.z, p.z));
+        maxCorner = Vec3 (maxXXX (maxCorner.x, p.x),
+                          maxXXX (maxCorner.y, p.y),
+                          maxXXX (maxCorner.z, p.z));
+    }
+    const float margin = path.radius () + cellSize;
+    const Vec3 extent (margin, 0, margin);
+    build (path, minCorner - extent, maxCorner + extent, cellSize);
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+const OpenSteer::FlowField::Cell* 
+OpenSteer::FlowField::cellAt (const Vec3& point) const
+{
+    const float x = (point.x - origin.x) / size;
+    const float z = (point.z - origin.z) / size;
+    if ((x < 0) || (z < 0)) return NULL;
+    const int i = (int) x;
+    const int j = (int) z;
+    if ((i >= countX) || (j >= countZ)) return NULL;
+    return &cells[i + (j * countX)];
+}
+
+
+// ----------------------------------------------------------------------------
+// continue the center's mapping to the point (taken at the center's
+// height) along the tangent: its path distance and point on the path move
+// with its offset along the tangent, and its distance outside with the
+// change in its distance from the center line
+
+
+void 
+OpenSteer::FlowField::continueMapping (const Cell& cell,
+                                       const Vec3& point,
+                                       Vec3& onPath,
+                                       Vec3& tangent,
+                                       float& outside,
+                                       float& pathDistance)
+{
+    const Vec3 p (point.x, cell.center.y, point.z);
+    const float along = (p - cell.center).dot (cell.tangent);
+    onPath = cell.onPath + (cell.tangent * along);
+    tangent = cell.tangent;
+    outside = cell.outside + ((p - onPath).length () -
+                              (cell.center - cell.onPath).length ());
+    pathDistance = cell.pathDistance + along;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+bool 
+OpenSteer::FlowField::lookup (const Vec3& point,
+                              Vec3& onPath,
+                              Vec3& tangent,
+                              float& outside,
+                              float& pathDistance) const
+{
+    const Cell* cell = cellAt (point);
+    if ((cell == NULL) || ! cell->exact) return false;
+
+    continueMapping (*cell, point, onPath, tangent, outside, pathDistance);
+    return true;
+}
+
+
+bool 
+OpenSteer::FlowField::lookupPathDistance (const Vec3& point,
+                                          float& pathDistance) const
+{
+    const Cell* cell = cellAt (point);
+    if ((cell == NULL) || ! cell->exact) return false;
+
+    const Vec3 p (point.x, cell->center.y, point.z);
+    pathDistance = cell->pathDistance +
+                   (p - cell->center).dot (cell->tangent);
+    return true;
+}
+
+
+bool 
+OpenSteer::FlowField::interior (const Vec3& point) const
+{
+    const Cell* cell = cellAt (point);
+    return (cell != NULL) && cell->interior;
+}
+
+
+int 
+OpenSteer::FlowField::exactCellCount (void) const
+{
+    int count = 0;
+    for (size_t i = 0; i < cells.size (); i++) if (cells[i].exact) count++;
+    return count;
+}
+
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,167 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// FrameHistory
+//
+// See FrameHistory.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/FrameHistory.h"
+
+#include <algorithm>
+#include "OpenSteer/PhaseTimer.h"
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::FrameSample::FrameSample (void)
+    : hasNeighborStatistics (false),
+      minNeighbors (0),
+      maxNeighbors (0),
+      averageNeighbors (0)
+{
+    for (int i = 0; i < seriesCount; i++) milliseconds[i] = 0;
+}
+
+
+void 
+OpenSteer::FrameSample::setFromPhaseTimer (void)
+{
+    milliseconds[updateSeries] =
+        (float) (1000 * PhaseTimer::total (PhaseTimer::otherUpdatePhase));
+    milliseconds[neighborQuerySeries] =
+        (float) (1000 * PhaseTimer::total (PhaseTimer::neighborQueryPhase));
+    milliseconds[steeringSeries] =
+        (float) (1000 * PhaseTimer::total (PhaseTimer::steeringPhase));
+    milliseconds[applySteeringForceSeries] =
+        (float) (1000 * PhaseTimer::total (PhaseTimer::applySteeringForcePhase));
+    milliseconds[proximityUpdateSeries] =
+        (float) (1000 * PhaseTimer::total (PhaseTimer::proximityUpdatePhase));
+}
+
+
+float 
+OpenSteer::FrameSample::total (void) const
+{
+    float sum = 0;
+    for (int i = 0; i < seriesCount; i++) sum += milliseconds[i];
+    return sum;
+}
+
+
+const char* 
+OpenSteer::FrameSample::name (const Series series)
+{
+    switch (series)
+    {
+    case updateSeries:             return "update";
+    case neighborQuerySeries:      return "neighbor search";
+    case steeringSeries:           return "steering";
+    case applySteeringForceSeries: return "apply steering";
+    case proximityUpdateSeries:    return "proximity update";
+    case drawSeries:               return "draw";
+    case annotationSeries:         return "annotation";
+    default:                       return "unknown";
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::FrameHistory::FrameHistory (const size_t capacity)
+    : samples (std::max<size_t> (capacity, 1)),
+      next (0),
+      count (0)
+{
+}
+
+
+void 
+OpenSteer::FrameHistory::add (const FrameSample& sample)
+{
+    samples[next] = sample;
+    next = (next + 1) % samples.size();
+    if (count < samples.size()) count++;
+}
+
+
+float 
+OpenSteer::FrameHistory::maxTotal (void) const
+{
+    float result = 0;
+    for (size_t i = 0; i < count; i++)
+        result = std::max (result, (*this)[i].total ());
+    return result;
+}
+
+
+OpenSteer::FrameSample 
+OpenSteer::FrameHistory::average (void) const
+{
+    FrameSample result;
+    if (count == 0) return result;
+
+    int neighborSamples = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        const FrameSample& s = (*this)[i];
+        for (int j = 0; j < FrameSample::seriesCount; j++)
+            result.milliseconds[j] += s.milliseconds[j];
+
+        if (s.hasNeighborStatistics)
+        {
+            if (neighborSamples == 0)
+            {
+                result.minNeighbors = s.minNeighbors;
+                result.maxNeighbors = s.maxNeighbors;
+            }
+            result.minNeighbors = std::min (result.minNeighbors, s.minNeighbors);
+            result.maxNeighbors = std::max (result.maxNeighbors, s.maxNeighbors);
+            result.averageNeighbors += s.averageNeighbors;
+            neighborSamples++;
+        }
+    }
+
+    for (int j = 0; j < FrameSample::seriesCount; j++)
+        result.milliseconds[j] /= count;
+    if (neighborSamples > 0)
+    {
+        result.hasNeighborStatistics = true;
+        result.averageNeighbors /= neighborSamples;
+    }
+    return result;
+}
+
+
+// ----------------------------------------------------------------------------
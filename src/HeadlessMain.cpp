@@ -0,0 +1,510 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// ----------------------------------------------------------------------------
+//
+//
+// Headless: runs OpenSteerDemo PlugIns without a window or OpenGL context
+//
+// Steps a registered PlugIn (or every registered PlugIn) at a fixed time
+// step for a given number of frames, as fast as possible, with annotation
+// turned off (unless streamed), then reports simulation throughput as steps
+// per second.
+// PlugIn::redraw is never called and GLUT is never initialized.
+//
+// usage: OpenSteerHeadless [--list] [--all] [--plugin name]
+//                          [--frames n] [--dt seconds]
+//                          [--parallel] [--threads n]
+//                          [--load file] [--save file]
+//                          [--telemetry name]
+//                          [--record file] [--replay file]
+//                          [--annotation file] [--worlds n]
+//
+// --load restores a checkpoint (see Checkpoint.h) into the PlugIn after
+// opening it, and the simulation continues from the checkpoint's time;
+// --save writes one after the last frame.  Both need a PlugIn supporting
+// checkpoints, and neither goes with --all.
+//
+// --telemetry publishes every frame's vehicle states to the shared memory
+// stream of the given name (see Telemetry.h) for other processes to read.
+//
+// --record logs every vehicle's steering forces (see SteeringLog.h) from
+// the PlugIn's opening (or the --load checkpoint) on; --replay plays such
+// a log back in place of the simulation, stopping at its end.  Neither
+// goes with --all.
+//
+// --annotation turns annotation on and writes every frame's annotation and
+// vehicles to an annotation stream (see AnnotationStream.h), which
+// "OpenSteerDemo --play file" shows.  Frames the disk cannot keep up with
+// are dropped, and counted in the report.  It does not go with --all.
+//
+// --worlds runs n independent Worlds of the PlugIn (see World.h) side by
+// side, stepping them concurrently on the worker pool, and reports the
+// steps per second summed over the Worlds.  It goes with none of the
+// options saving, restoring, publishing or streaming a simulation.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/OpenSteerDemo.h"
+#include "OpenSteer/Annotation.h"
+#include "OpenSteer/AnnotationStream.h"
+#include "OpenSteer/Checkpoint.h"
+#include "OpenSteer/Clock.h"
+#include "OpenSteer/PlugIn.h"
+#include "OpenSteer/SteeringLog.h"
+#include "OpenSteer/Telemetry.h"
+#include "OpenSteer/WorkerPool.h"
+#include "OpenSteer/World.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+
+    // ------------------------------------------------------------------------
+    // run settings, from the command line
+
+
+    int frameCount = 1000;
+    float stepSize = 1.0f / 60.0f;
+    const char* loadFileName = NULL;
+    const char* saveFileName = NULL;
+    const char* telemetryName = NULL;
+    const char* recordFileName = NULL;
+    const char* replayFileName = NULL;
+    const char* annotationFileName = NULL;
+    int worldCount = 0;
+
+    // records per telemetry frame; only the pages touched are ever used
+    const size_t telemetryCapacity = 1 << 18;
+
+
+    // ------------------------------------------------------------------------
+    // print command line help
+
+
+    void printUsage (const char* programName)
+    {
+        std::cout << "usage: " << programName
+                  << " [--list] [--all] [--plugin name]"
+                  << " [--frames n] [--dt seconds]"
+                  << " [--parallel] [--threads n]"
+                  << " [--load file] [--save file] [--telemetry name]"
+                  << " [--record file] [--replay file]"
+                  << " [--annotation file] [--worlds n]"
+                  << std::endl
+                  << "  --list         list registered PlugIns and exit"
+                  << std::endl
+                  << "  --all          run every registered PlugIn in turn"
+                  << std::endl
+                  << "  --plugin name  run the named PlugIn (default: the "
+                  << "default PlugIn)" << std::endl
+                  << "  --frames n     number of simulation steps (default "
+                  << frameCount << ")" << std::endl
+                  << "  --dt seconds   fixed simulation time step (default "
+                  << stepSize << ")" << std::endl
+                  << "  --parallel     use the two-phase parallel update"
+                  << std::endl
+                  << "  --threads n    worker pool size (default: one per "
+                  << "hardware thread)" << std::endl
+                  << "  --load file    start from a checkpoint" << std::endl
+                  << "  --save file    write a checkpoint after the last "
+                  << "frame" << std::endl
+                  << "  --telemetry name  publish vehicle states to a shared "
+                  << "memory stream" << std::endl
+                  << "  --record file  log the steering forces of each frame"
+                  << std::endl
+                  << "  --replay file  play a steering log back instead of "
+                  << "simulating" << std::endl
+                  << "  --annotation file  stream annotation to a file"
+                  << std::endl
+                  << "  --worlds n     run n independent Worlds of the PlugIn "
+                  << "concurrently" << std::endl;
+    }
+
+
+    void printPlugInName (PlugIn& pi) {std::cout << " " << pi << std::endl;}
+
+
+    // ------------------------------------------------------------------------
+    // restore the open PlugIn from a checkpoint file, setting the
+    // simulation time to the checkpoint's.  Returns false if that fails.
+
+
+    bool loadCheckpoint (PlugIn& pi, const char* fileName, float& time)
+    {
+        CheckpointReader checkpoint;
+        if (! checkpoint.open (fileName))
+        {
+            std::cerr << "cannot read checkpoint " << fileName << std::endl;
+            return false;
+        }
+        if ((checkpoint.plugInName () != pi.name ()) ||
+            ! pi.loadCheckpoint (checkpoint))
+        {
+            std::cerr << fileName << " is not a checkpoint of " << pi
+                      << std::endl;
+            return false;
+        }
+        time = checkpoint.currentTime ();
+        return true;
+    }
+
+
+    bool saveCheckpoint (PlugIn& pi, const char* fileName, const float time)
+    {
+        CheckpointWriter checkpoint (pi.name (), time);
+        if (! pi.saveCheckpoint (checkpoint))
+        {
+            std::cerr << pi << " does not support checkpoints" << std::endl;
+            return false;
+        }
+        if (! checkpoint.writeFile (fileName))
+        {
+            std::cerr << "cannot write " << fileName << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+
+    // ------------------------------------------------------------------------
+    // open a PlugIn, step it frameCount times at stepSize (or to the end of
+    // the replayed log), close it, and report its throughput.  Returns false
+    // if a checkpoint cannot be loaded or saved, or a steering log or
+    // annotation stream cannot be opened.
+
+
+    bool runPlugIn (PlugIn& pi)
+    {
+        OpenSteerDemo::selectedPlugIn = &pi;
+        OpenSteerDemo::openSelectedPlugIn ();
+
+        float simulationTime = 0;
+        if (loadFileName && ! loadCheckpoint (pi, loadFileName, simulationTime))
+        {
+            OpenSteerDemo::closeSelectedPlugIn ();
+            return false;
+        }
+
+        SteeringRecorder recorder;
+        SteeringReplayer replayer;
+        const AVGroup& vehicles = OpenSteerDemo::allVehiclesOfSelectedPlugIn ();
+        if ((recordFileName && ! recorder.open (recordFileName, vehicles)) ||
+            (replayFileName && ! replayer.open (replayFileName)))
+        {
+            std::cerr << "cannot open steering log "
+                      << (recordFileName ? recordFileName : replayFileName)
+                      << std::endl;
+            OpenSteerDemo::closeSelectedPlugIn ();
+            return false;
+        }
+        if (recordFileName) OpenSteerDemo::setSteeringRecorder (&recorder);
+        if (replayFileName) OpenSteerDemo::setSteeringReplayer (&replayer);
+
+        AnnotationStreamWriter annotation;
+        if (annotationFileName)
+        {
+            if (! annotation.open (annotationFileName, pi.name ()))
+            {
+                std::cerr << "cannot open annotation stream "
+                          << annotationFileName << std::endl;
+                OpenSteerDemo::setSteeringRecorder (NULL);
+                OpenSteerDemo::setSteeringReplayer (NULL);
+                OpenSteerDemo::closeSelectedPlugIn ();
+                return false;
+            }
+            OpenSteerDemo::setAnnotationStreamWriter (&annotation);
+        }
+
+        Clock clock;
+        clock.update ();
+        const float startTime = clock.realTimeSinceFirstClockUpdate ();
+
+        int frames = 0;
+        while ((frames < frameCount) && ! (replayFileName && replayer.atEnd ()))
+        {
+            simulationTime += stepSize;
+            OpenSteerDemo::updateSelectedPlugIn (simulationTime, stepSize);
+            frames++;
+        }
+
+        OpenSteerDemo::setSteeringRecorder (NULL);
+        OpenSteerDemo::setSteeringReplayer (NULL);
+        OpenSteerDemo::setAnnotationStreamWriter (NULL);
+
+        const float wallTime =
+            clock.realTimeSinceFirstClockUpdate () - startTime;
+
+        // (written after the timing, as it is not the simulation's work)
+        annotation.close ();
+        const bool streamed = ! annotationFileName || ! annotation.failed ();
+        if (! streamed)
+            std::cerr << "cannot write annotation stream "
+                      << annotationFileName << std::endl;
+        const int vehicleCount =
+            (int) OpenSteerDemo::allVehiclesOfSelectedPlugIn().size();
+
+        const bool saved =
+            ! saveFileName || saveCheckpoint (pi, saveFileName, simulationTime);
+
+        OpenSteerDemo::closeSelectedPlugIn ();
+
+        std::cout << std::setw (32) << std::left << pi.name () << std::right
+                  << " vehicles: " << std::setw (6) << vehicleCount
+                  << " frames: " << frames
+                  << " seconds: " << std::fixed << std::setprecision (3)
+                  << wallTime
+                  << " steps/sec: " << std::setprecision (1)
+                  << ((wallTime > 0) ? frames / wallTime : 0.0f)
+                  << std::endl;
+        std::cout.unsetf (std::ios::floatfield);
+        if (annotationFileName)
+            std::cout << "annotation frames: " << annotation.frameCount ()
+                      << " dropped: " << annotation.droppedFrameCount ()
+                      << std::endl;
+        return saved && streamed;
+    }
+
+
+    void runEachPlugIn (PlugIn& pi) {runPlugIn (pi);}
+
+
+    // ------------------------------------------------------------------------
+    // run worldCount Worlds of a PlugIn (seeded 0, 1, ...) concurrently for
+    // frameCount steps at stepSize each, and report their throughput.
+    // Returns false if the PlugIn cannot run in Worlds.
+
+
+    bool runWorlds (PlugIn& pi)
+    {
+        std::vector<World*> worlds;
+        WorldScheduler scheduler (WorkerPool::shared ());
+        for (int i = 0; i < worldCount; i++)
+        {
+            worlds.push_back (new World (pi, (uint64_t) i));
+            scheduler.add (*worlds.back());
+        }
+        if (! worlds.front()->isValid ())
+        {
+            std::cerr << pi << " cannot run in Worlds" << std::endl;
+            for (int i = 0; i < worldCount; i++) delete worlds[i];
+            return false;
+        }
+
+        scheduler.openAll ();
+
+        Clock clock;
+        clock.update ();
+        const float startTime = clock.realTimeSinceFirstClockUpdate ();
+        scheduler.step (stepSize, frameCount);
+        const float wallTime =
+            clock.realTimeSinceFirstClockUpdate () - startTime;
+
+        size_t vehicleCount = 0;
+        for (int i = 0; i < worldCount; i++)
+            vehicleCount += worlds[i]->allVehicles().size();
+
+        scheduler.closeAll ();
+        for (int i = 0; i < worldCount; i++) delete worlds[i];
+
+        const double steps = (double) worldCount * frameCount;
+        std::cout << std::setw (32) << std::left << pi.name () << std::right
+                  << " worlds: " << worldCount
+                  << " vehicles: " << std::setw (6) << vehicleCount
+                  << " frames: " << frameCount
+                  << " threads: " << WorkerPool::shared().threadCount ()
+                  << " seconds: " << std::fixed << std::setprecision (3)
+                  << wallTime
+                  << " steps/sec: " << std::setprecision (1)
+                  << ((wallTime > 0) ? steps / wallTime : 0.0)
+                  << std::endl;
+        std::cout.unsetf (std::ios::floatfield);
+        return true;
+    }
+
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+int main (int argc, char **argv)
+{
+    const char* plugInName = NULL;
+    bool runAll = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const bool hasValue = (i + 1) < argc;
+
+        if (strcmp (argv[i], "--list") == 0)
+        {
+            PlugIn::sortBySelectionOrder ();
+            PlugIn::applyToAll (printPlugInName);
+            return EXIT_SUCCESS;
+        }
+        else if (strcmp (argv[i], "--all") == 0)
+        {
+            runAll = true;
+        }
+        else if (hasValue && (strcmp (argv[i], "--plugin") == 0))
+        {
+            plugInName = argv[++i];
+        }
+        else if (hasValue && (strcmp (argv[i], "--frames") == 0))
+        {
+            frameCount = atoi (argv[++i]);
+        }
+        else if (strcmp (argv[i], "--parallel") == 0)
+        {
+            setParallelUpdateOn ();
+        }
+        else if (hasValue && (strcmp (argv[i], "--threads") == 0))
+        {
+            WorkerPool::shared().setThreadCount (atoi (argv[++i]));
+        }
+        else if (hasValue && (strcmp (argv[i], "--dt") == 0))
+        {
+            stepSize = (float) atof (argv[++i]);
+        }
+        else if (hasValue && (strcmp (argv[i], "--load") == 0))
+        {
+            loadFileName = argv[++i];
+        }
+        else if (hasValue && (strcmp (argv[i], "--save") == 0))
+        {
+            saveFileName = argv[++i];
+        }
+        else if (hasValue && (strcmp (argv[i], "--telemetry") == 0))
+        {
+            telemetryName = argv[++i];
+        }
+        else if (hasValue && (strcmp (argv[i], "--record") == 0))
+        {
+            recordFileName = argv[++i];
+        }
+        else if (hasValue && (strcmp (argv[i], "--replay") == 0))
+        {
+            replayFileName = argv[++i];
+        }
+        else if (hasValue && (strcmp (argv[i], "--annotation") == 0))
+        {
+            annotationFileName = argv[++i];
+        }
+        else if (hasValue && (strcmp (argv[i], "--worlds") == 0))
+        {
+            worldCount = atoi (argv[++i]);
+            if (worldCount <= 0)
+            {
+                std::cerr << "world count must be positive" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else
+        {
+            printUsage (argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ((frameCount <= 0) || (stepSize <= 0))
+    {
+        std::cerr << "frame count and time step must be positive" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if ((worldCount > 0) &&
+        (runAll || loadFileName || saveFileName || telemetryName ||
+         recordFileName || replayFileName || annotationFileName))
+    {
+        std::cerr << "--worlds goes with none of --all, --load, --save, "
+                  << "--telemetry, --record, --replay and --annotation"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // the headless runner never draws, so annotation would be wasted work
+    // unless it is streamed
+    if (annotationFileName)
+        setAnnotationOn ();
+    else
+        setAnnotationOff ();
+
+    PlugIn::sortBySelectionOrder ();
+
+    TelemetryWriter telemetry;
+    if (telemetryName)
+    {
+        if (! telemetry.open (telemetryName, telemetryCapacity))
+        {
+            std::cerr << "cannot create telemetry stream " << telemetryName
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+        OpenSteerDemo::setTelemetryWriter (&telemetry);
+    }
+
+    if (runAll)
+    {
+        if (loadFileName || saveFileName || recordFileName ||
+            replayFileName || annotationFileName)
+        {
+            std::cerr << "--load, --save, --record, --replay and --annotation "
+                      << "need a single PlugIn" << std::endl;
+            return EXIT_FAILURE;
+        }
+        PlugIn::applyToAll (runEachPlugIn);
+        return EXIT_SUCCESS;
+    }
+
+    PlugIn* pi = plugInName ? PlugIn::findByName (plugInName)
+                            : PlugIn::findDefault ();
+    if (pi == NULL)
+    {
+        std::cerr << "no PlugIn named \"" << (plugInName ? plugInName : "")
+                  << "\", use --list to see registered PlugIns" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (worldCount > 0) return runWorlds (*pi) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    return runPlugIn (*pi) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,143 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// MemoryAccount
+//
+// Per subsystem heap accounting.  See MemoryAccount.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/MemoryAccount.h"
+
+#include <atomic>
+
+
+namespace {
+
+    // constant initialized, so usable during static construction and
+    // destruction of the charged objects
+
+    std::atomic<size_t> bytesOf [OpenSteer::MemoryAccount::categoryCount];
+    std::atomic<size_t> blocksOf [OpenSteer::MemoryAccount::categoryCount];
+    std::atomic<size_t> allocationsOf [OpenSteer::MemoryAccount::categoryCount];
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::MemoryAccount::add (const Category category, const size_t bytes)
+{
+    bytesOf[category].fetch_add (bytes, std::memory_order_relaxed);
+    blocksOf[category].fetch_add (1, std::memory_order_relaxed);
+    allocationsOf[category].fetch_add (1, std::memory_order_relaxed);
+}
+
+
+void 
+OpenSteer::MemoryAccount::remove (const Category category, const size_t bytes)
+{
+    bytesOf[category].fetch_sub (bytes, std::memory_order_relaxed);
+    blocksOf[category].fetch_sub (1, std::memory_order_relaxed);
+}
+
+
+size_t 
+OpenSteer::MemoryAccount::liveBytes (const Category category)
+{
+    return bytesOf[category].load (std::memory_order_relaxed);
+}
+
+
+size_t 
+OpenSteer::MemoryAccount::liveAllocations (const Category category)
+{
+    return blocksOf[category].load (std::memory_order_relaxed);
+}
+
+
+size_t 
+OpenSteer::MemoryAccount::totalAllocations (const Category category)
+{
+    return allocationsOf[category].load (std::memory_order_relaxed);
+}
+
+
+size_t 
+OpenSteer::MemoryAccount::liveBytes (void)
+{
+    size_t total = 0;
+    for (int i = 0; i < categoryCount; i++) total += liveBytes ((Category) i);
+    return total;
+}
+
+
+size_t 
+OpenSteer::MemoryAccount::liveAllocations (void)
+{
+    size_t total = 0;
+    for (int i = 0; i < categoryCount; i++)
+        total += liveAllocations ((Category) i);
+    return total;
+}
+
+
+const char* 
+OpenSteer::MemoryAccount::name (const Category category)
+{
+    switch (category)
+    {
+    case vehicleMemory:   return "vehicles";
+    case tokenMemory:     return "tokens";
+    case neighborMemory:  return "neighbors";
+    case trailMemory:     return "trails";
+    case pathMemory:      return "paths";
+    case obstacleMemory:  return "obstacles";
+    case drawQueueMemory: return "draw_queues";
+    case terrainMemory:   return "terrain";
+    case otherMemory:     return "other";
+    default:              return "unknown";
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// storage restated by its owner
+
+
+void 
+OpenSteer::MemoryAccount::Charge::set (const size_t newBytes)
+{
+    if (newBytes == bytes) return;
+    if (bytes != 0) remove (category, bytes);
+    if (newBytes != 0) add (category, newBytes);
+    bytes = newBytes;
+}
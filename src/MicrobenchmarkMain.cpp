@@ -0,0 +1,914 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// ----------------------------------------------------------------------------
+//
+//
+// Microbenchmark: timings of the primitives the PlugIns are built on
+//
+// Measures, one operation at a time, the lq bin lattice functions
+// (lqUpdateForNewLocation, lqMapOverAllObjectsInLocality,
+// lqFindNearestNeighborWithinRadius and the 7 nearest by
+// lqFindKNearestNeighborsWithinRadius), both findNeighbors forms of each
+// proximity database, mapPointToPath and mapPathDistanceToPoint on paths
+// of many sizes, the sphere and box obstacle intersection tests, and the
+// Vec3 operations and angle tests which have approximate math (see
+// Utilities.h) in the build's math mode.  Each runs for every population (or
+// path) size over three distributions of points: uniform in a 100 unit box
+// (the databases' extent), clustered in a few dense balls, and out of
+// bounds, most of them outside the box.  Results are written to stdout as
+// one JSON object per measurement ("JSON lines"): the mean time per
+// operation and, for queries, the mean number of objects found.  In builds
+// with approximate math each of those operations also has a line of its
+// accuracy against the exact one: the largest and mean relative error of
+// its results, or for the angle tests the fraction of results which
+// differ.
+//
+// usage: OpenSteerMicrobenchmark [--sizes n,n,...] [--path-sizes n,n,...]
+//                                [--min-time seconds] [--seed n]
+//                                [--filter text]
+//
+// --sizes are the numbers of objects in the databases and of vehicles
+// tested against the obstacles, --path-sizes the numbers of path points.
+// Each measurement repeats its operation for at least --min-time seconds.
+// --filter runs only the benchmarks whose name contains the text.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/lq.h"
+#include "OpenSteer/Obstacle.h"
+#include "OpenSteer/PolylineSegmentedPathwaySingleRadius.h"
+#include "OpenSteer/Proximity.h"
+#include "OpenSteer/Random.h"
+#include "OpenSteer/SimpleVehicle.h"
+#include "OpenSteer/UnusedParameter.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+
+    // ------------------------------------------------------------------------
+    // run settings, from the command line
+
+
+    std::vector<size_t> sizes;
+    std::vector<size_t> pathSizes;
+    double minSeconds = 0.2;
+    uint64_t seed = 1;
+    std::string filter;
+
+
+    // the box (centered at the origin) the databases cover, and the radius
+    // of neighborhood queries
+    const float worldSize = 100;
+    const float queryRadius = 5;
+
+
+    // ------------------------------------------------------------------------
+    // point distributions
+
+
+    enum Distribution {uniform, clustered, outOfBounds, distributionCount};
+
+    const char* distributionName (const Distribution d)
+    {
+        switch (d)
+        {
+        case uniform:     return "uniform";
+        case clustered:   return "clustered";
+        default:          return "out_of_bounds";
+        }
+    }
+
+    Vec3 randomPointInBox (RandomStream& random, const float size)
+    {
+        const float h = size / 2;
+        return Vec3 (random.frandom2 (-h, h),
+                     random.frandom2 (-h, h),
+                     random.frandom2 (-h, h));
+    }
+
+    // count points of the given distribution: uniform in the box, in
+    // sixteen balls of radius 4, or uniform in a box three times as large
+    // (so 26 of 27 points are outside the databases' extent)
+    void makePoints (const Distribution d,
+                     const size_t count,
+                     RandomStream& random,
+                     std::vector<Vec3>& points)
+    {
+        points.resize (count);
+        const int clusterCount = 16;
+        Vec3 clusters [clusterCount];
+        for (int c = 0; c < clusterCount; c++)
+            clusters[c] = randomPointInBox (random, worldSize * 0.8f);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            switch (d)
+            {
+            case uniform:
+                points[i] = randomPointInBox (random, worldSize);
+                break;
+            case clustered:
+                points[i] = (clusters[i % clusterCount] +
+                             RandomVectorInUnitRadiusSphere (random) * 4);
+                break;
+            default:
+                points[i] = randomPointInBox (random, worldSize * 3);
+                break;
+            }
+        }
+    }
+
+
+    // ------------------------------------------------------------------------
+    // one operation under measurement: run (i) performs it on the ith of
+    // the benchmark's inputs, adding any objects it finds to found
+
+
+    class Operation
+    {
+    public:
+        Operation (void) : found (0) {}
+        virtual ~Operation () {}
+        virtual void run (const size_t i) = 0;
+        double found;
+    };
+
+
+    bool selected (const char* name)
+    {
+        return filter.empty () || (std::string (name).find (filter) !=
+                                   std::string::npos);
+    }
+
+
+    // repeat an operation over its inputs 0 .. inputCount-1 (cycling) for
+    // at least minSeconds, then report the mean time per operation
+    void measure (const char* name,
+                  const Distribution d,
+                  const size_t size,
+                  Operation& operation,
+                  const size_t inputCount)
+    {
+        typedef std::chrono::steady_clock Clock;
+        const size_t batch = 64;
+        const Clock::time_point start = Clock::now ();
+        size_t ops = 0;
+        double seconds = 0;
+        do
+        {
+            for (size_t k = 0; k < batch; k++, ops++)
+                operation.run (ops % inputCount);
+            seconds = std::chrono::duration<double> (Clock::now () - start).count ();
+        }
+        while (seconds < minSeconds);
+
+        std::cout << "{\"benchmark\":\"" << name << "\""
+                  << ",\"distribution\":\"" << distributionName (d) << "\""
+                  << ",\"size\":" << size
+                  << ",\"ops\":" << ops
+                  << ",\"ns_per_op\":" << seconds * 1e9 / ops
+                  << ",\"found_per_op\":" << operation.found / ops
+                  << "}" << std::endl;
+    }
+
+
+    // ------------------------------------------------------------------------
+    // the lq bin lattice, used directly: objects at points, with ten bins
+    // along each axis of the box
+
+
+    class LqBenchmark
+    {
+    public:
+        LqBenchmark (const std::vector<Vec3>& p)
+            : points (p), proxies (p.size ())
+        {
+            const float h = worldSize / 2;
+            lq = lqCreateDatabase (-h, -h, -h, worldSize, worldSize, worldSize,
+                                   10, 10, 10);
+            for (size_t i = 0; i < points.size (); i++)
+            {
+                lqInitClientProxy (&proxies[i], (void*) &points[i]);
+                lqUpdateForNewLocation (lq, &proxies[i],
+                                        points[i].x, points[i].y, points[i].z);
+            }
+        }
+
+        ~LqBenchmark () {lqDeleteDatabase (lq);}
+
+        lqDB* lq;
+        const std::vector<Vec3>& points;
+        std::vector<lqClientProxy> proxies;
+
+    private:
+        LqBenchmark (const LqBenchmark&);
+        LqBenchmark& operator= (const LqBenchmark&);
+    };
+
+
+    // moves each object back and forth between its point and one up to a
+    // unit away, so some of the moves change bins
+    class LqUpdate : public Operation
+    {
+    public:
+        LqUpdate (LqBenchmark& b, RandomStream& random)
+            : lq (b), flips (b.points.size (), 0)
+        {
+            for (size_t i = 0; i < lq.points.size (); i++)
+                moved.push_back (lq.points[i] +
+                                 RandomVectorInUnitRadiusSphere (random));
+        }
+        void run (const size_t i)
+        {
+            const Vec3& p = ((flips[i] ^= 1) ? moved[i] : lq.points[i]);
+            lqUpdateForNewLocation (lq.lq, &lq.proxies[i], p.x, p.y, p.z);
+        }
+        LqBenchmark& lq;
+        std::vector<Vec3> moved;
+        std::vector<char> flips;
+    };
+
+
+    void countObject (void* clientObject, float distanceSquared, void* count)
+    {
+        OPENSTEER_UNUSED_PARAMETER (clientObject);
+        OPENSTEER_UNUSED_PARAMETER (distanceSquared);
+        ++*(double*) count;
+    }
+
+    class LqLocality : public Operation
+    {
+    public:
+        LqLocality (LqBenchmark& b) : lq (b) {}
+        void run (const size_t i)
+        {
+            const Vec3& p = lq.points[i];
+            lqMapOverAllObjectsInLocality (lq.lq, p.x, p.y, p.z, queryRadius,
+                                           countObject, &found);
+        }
+        LqBenchmark& lq;
+    };
+
+    class LqNearest : public Operation
+    {
+    public:
+        LqNearest (LqBenchmark& b) : lq (b) {}
+        void run (const size_t i)
+        {
+            const Vec3& p = lq.points[i];
+            if (lqFindNearestNeighborWithinRadius (lq.lq, p.x, p.y, p.z,
+                                                   queryRadius,
+                                                   (void*) &lq.points[i]))
+                found++;
+        }
+        LqBenchmark& lq;
+    };
+
+    class LqKNearest : public Operation
+    {
+    public:
+        LqKNearest (LqBenchmark& b) : lq (b) {}
+        void run (const size_t i)
+        {
+            const Vec3& p = lq.points[i];
+            void* objects[nearestCount];
+            float distancesSquared[nearestCount];
+            found += lqFindKNearestNeighborsWithinRadius (lq.lq, p.x, p.y, p.z,
+                                                          queryRadius,
+                                                          (void*) &lq.points[i],
+                                                          nearestCount,
+                                                          objects,
+                                                          distancesSquared);
+        }
+        static const int nearestCount = 7;
+        LqBenchmark& lq;
+    };
+
+
+    void benchmarkLq (const Distribution d,
+                      const std::vector<Vec3>& points,
+                      RandomStream& random)
+    {
+        LqBenchmark lq (points);
+        if (selected ("lqUpdateForNewLocation"))
+        {
+            LqUpdate update (lq, random);
+            measure ("lqUpdateForNewLocation", d, points.size (),
+                     update, points.size ());
+        }
+        if (selected ("lqMapOverAllObjectsInLocality"))
+        {
+            LqLocality locality (lq);
+            measure ("lqMapOverAllObjectsInLocality", d, points.size (),
+                     locality, points.size ());
+        }
+        if (selected ("lqFindNearestNeighborWithinRadius"))
+        {
+            LqNearest nearest (lq);
+            measure ("lqFindNearestNeighborWithinRadius", d, points.size (),
+                     nearest, points.size ());
+        }
+        if (selected ("lqFindKNearestNeighborsWithinRadius"))
+        {
+            LqKNearest nearest (lq);
+            measure ("lqFindKNearestNeighborsWithinRadius", d, points.size (),
+                     nearest, points.size ());
+        }
+    }
+
+
+    // ------------------------------------------------------------------------
+    // the proximity databases: findNeighbors into objects and into
+    // neighbor records, centered on each object
+
+
+    typedef AbstractProximityDatabase<Vec3*> Database;
+    typedef AbstractTokenForProximityDatabase<Vec3*> Token;
+
+    class FindNeighbors : public Operation
+    {
+    public:
+        FindNeighbors (Database& database, std::vector<Vec3>& p)
+            : points (p)
+        {
+            for (size_t i = 0; i < points.size (); i++)
+            {
+                tokens.push_back (database.allocateToken (&points[i]));
+                tokens.back()->updateForNewPosition (points[i]);
+            }
+            database.maintain ();
+        }
+        ~FindNeighbors ()
+        {
+            for (size_t i = 0; i < tokens.size (); i++) delete tokens[i];
+        }
+        void run (const size_t i)
+        {
+            results.clear ();
+            tokens[i]->findNeighbors (points[i], queryRadius, results);
+            found += results.size ();
+        }
+        std::vector<Vec3>& points;
+        std::vector<Token*> tokens;
+        std::vector<Vec3*> results;
+    };
+
+    class FindNeighborRecords : public FindNeighbors
+    {
+    public:
+        FindNeighborRecords (Database& database, std::vector<Vec3>& p)
+            : FindNeighbors (database, p) {}
+        void run (const size_t i)
+        {
+            records.clear ();
+            tokens[i]->findNeighbors (points[i], queryRadius, records);
+            found += records.size ();
+        }
+        std::vector<NeighborRecord<Vec3*> > records;
+    };
+
+
+    void benchmarkDatabase (const char* databaseName,
+                            Database& database,
+                            const Distribution d,
+                            std::vector<Vec3>& points)
+    {
+        const std::string plain = std::string ("findNeighbors/") + databaseName;
+        const std::string records = plain + "/records";
+        if (selected (plain.c_str ()))
+        {
+            FindNeighbors find (database, points);
+            measure (plain.c_str (), d, points.size (), find, points.size ());
+        }
+        if (selected (records.c_str ()))
+        {
+            FindNeighborRecords find (database, points);
+            measure (records.c_str (), d, points.size (), find, points.size ());
+        }
+    }
+
+
+    void benchmarkDatabases (const Distribution d,
+                             std::vector<Vec3>& points)
+    {
+        const Vec3 center;
+        const Vec3 dimensions (worldSize, worldSize, worldSize);
+        const Vec3 divisions (10, 10, 10);
+        {
+            BruteForceProximityDatabase<Vec3*> database;
+            benchmarkDatabase ("brute_force", database, d, points);
+        }
+        {
+            LQProximityDatabase<Vec3*> database (center, dimensions,
+                                                       divisions);
+            benchmarkDatabase ("lq_bin_lattice", database, d, points);
+        }
+        {
+            GridProximityDatabase<Vec3*> database (center, dimensions,
+                                                         divisions);
+            benchmarkDatabase ("flat_array_grid", database, d, points);
+        }
+        {
+            SpatialHashProximityDatabase<Vec3*> database (queryRadius);
+            benchmarkDatabase ("spatial_hash", database, d, points);
+        }
+    }
+
+
+    // ------------------------------------------------------------------------
+    // paths: a closed Lissajous curve through the box, sampled at a given
+    // number of points, queried at points of each distribution and at path
+    // distances spread likewise along (and, out of bounds, beyond) it
+
+
+    class MapPointToPath : public Operation
+    {
+    public:
+        MapPointToPath (const PolylineSegmentedPathwaySingleRadius& p, const std::vector<Vec3>& q)
+            : path (p), points (q), sink (0) {}
+        void run (const size_t i)
+        {
+            Vec3 tangent;
+            float outside;
+            const Vec3 onPath = path.mapPointToPath (points[i], tangent, outside);
+            if (outside < 0) found++;
+            sink += onPath.x;
+        }
+        const PolylineSegmentedPathwaySingleRadius& path;
+        const std::vector<Vec3>& points;
+        float sink;
+    };
+
+    class MapPathDistanceToPoint : public Operation
+    {
+    public:
+        MapPathDistanceToPoint (const PolylineSegmentedPathwaySingleRadius& p, const std::vector<float>& d)
+            : path (p), distances (d), sink (0) {}
+        void run (const size_t i)
+        {
+            sink += path.mapPathDistanceToPoint (distances[i]).x;
+        }
+        const PolylineSegmentedPathwaySingleRadius& path;
+        const std::vector<float>& distances;
+        float sink;
+    };
+
+
+    void benchmarkPath (const Distribution d,
+                        const size_t pointCount,
+                        RandomStream& random)
+    {
+        std::vector<Vec3> vertices (pointCount);
+        const float h = worldSize * 0.45f;
+        for (size_t i = 0; i < pointCount; i++)
+        {
+            const float t = (2 * OPENSTEER_M_PI * i) / pointCount;
+            vertices[i] = Vec3 (h * sinf (3 * t), 0, h * sinf (4 * t + 0.5f));
+        }
+        const PolylineSegmentedPathwaySingleRadius path (pointCount,
+                                                         &vertices[0],
+                                                         2, true);
+
+        const size_t queryCount = 4096;
+        std::vector<Vec3> points;
+        makePoints (d, queryCount, random, points);
+        std::vector<float> distances (queryCount);
+        const float length = path.length ();
+        for (size_t i = 0; i < queryCount; i++)
+        {
+            switch (d)
+            {
+            case uniform:
+                distances[i] = random.frandom2 (0, length);
+                break;
+            case clustered:
+                distances[i] = (length * (float) (i % 16) / 16 +
+                                random.frandom2 (0, length / 100));
+                break;
+            default:
+                distances[i] = random.frandom2 (-length, 2 * length);
+                break;
+            }
+        }
+
+        if (selected ("mapPointToPath"))
+        {
+            MapPointToPath map (path, points);
+            measure ("mapPointToPath", d, pointCount, map, queryCount);
+        }
+        if (selected ("mapPathDistanceToPoint"))
+        {
+            MapPathDistanceToPoint map (path, distances);
+            measure ("mapPathDistanceToPoint", d, pointCount, map, queryCount);
+        }
+    }
+
+
+    // ------------------------------------------------------------------------
+    // obstacles: a sphere and a box of 20 units at the origin, tested
+    // against vehicles at points of each distribution, heading roughly
+    // toward the origin
+
+
+    class TestVehicle : public SimpleVehicle
+    {
+    public:
+        void update (const float, const float) {}
+    };
+
+    class IntersectObstacle : public Operation
+    {
+    public:
+        IntersectObstacle (const AbstractObstacle& o,
+                           const std::vector<TestVehicle>& v)
+            : obstacle (o), vehicles (v) {}
+        void run (const size_t i)
+        {
+            AbstractObstacle::PathIntersection pi;
+            obstacle.findIntersectionWithVehiclePath (vehicles[i], pi);
+            if (pi.intersect) found++;
+        }
+        const AbstractObstacle& obstacle;
+        const std::vector<TestVehicle>& vehicles;
+    };
+
+
+    void benchmarkObstacles (const Distribution d,
+                             const std::vector<Vec3>& points,
+                             RandomStream& random)
+    {
+        std::vector<TestVehicle> vehicles (points.size ());
+        for (size_t i = 0; i < points.size (); i++)
+        {
+            vehicles[i].setPosition (points[i]);
+            const Vec3 toCenter = (RandomVectorInUnitRadiusSphere (random) * 20 -
+                                   points[i]);
+            vehicles[i].regenerateOrthonormalBasisUF (toCenter.length () > 0 ?
+                                                      toCenter.normalize () :
+                                                      Vec3::forward);
+            vehicles[i].setSpeed (1);
+        }
+
+        if (selected ("SphereObstacle::findIntersectionWithVehiclePath"))
+        {
+            const SphereObstacle sphere (10, Vec3::zero);
+            IntersectObstacle intersect (sphere, vehicles);
+            measure ("SphereObstacle::findIntersectionWithVehiclePath", d,
+                     points.size (), intersect, points.size ());
+        }
+        if (selected ("BoxObstacle::findIntersectionWithVehiclePath"))
+        {
+            const BoxObstacle box (20, 20, 20);
+            IntersectObstacle intersect (box, vehicles);
+            measure ("BoxObstacle::findIntersectionWithVehiclePath", d,
+                     points.size (), intersect, points.size ());
+        }
+    }
+
+
+    // ------------------------------------------------------------------------
+    // the operations with approximate math, on vehicles at points of each
+    // distribution with random headings: the vehicle's position is the
+    // vector operated on and the next vehicle the target or neighbor
+
+
+    enum MathKind {lengthMath, normalizeMath, truncateLengthMath,
+                   rotateMath, deviationMath, isAheadMath,
+                   neighborhoodMath, mathKindCount};
+
+    const char* mathKindName (const MathKind k)
+    {
+        switch (k)
+        {
+        case lengthMath:         return "Vec3::length";
+        case normalizeMath:      return "Vec3::normalize";
+        case truncateLengthMath: return "Vec3::truncateLength";
+        case rotateMath:         return "Vec3::rotateAboutGlobalY";
+        case deviationMath:      return "limitMaxDeviationAngle";
+        case isAheadMath:        return "SteerLibrary::isAhead";
+        default:                 return "SteerLibrary::inBoidNeighborhood";
+        }
+    }
+
+    // results of the angle tests are 0 or 1
+    bool isAngleTest (const MathKind k)
+    {
+        return (k == isAheadMath) || (k == neighborhoodMath);
+    }
+
+
+    // the exact forms of the operations, whatever the build's math mode
+
+    Vec3 exactNormalize (const Vec3& v)
+    {
+        const float length = sqrtXXX (v.lengthSquared ());
+        return (length > 0) ? v / length : v;
+    }
+
+    // as vecLimitDeviationAngleUtility, inside the cone
+    Vec3 exactLimitMaxDeviationAngle (const Vec3& source,
+                                      const float cosineOfConeAngle,
+                                      const Vec3& basis)
+    {
+        const float sourceLength = sqrtXXX (source.lengthSquared ());
+        if (sourceLength == 0) return source;
+        if ((source / sourceLength).dot (basis) >= cosineOfConeAngle)
+            return source;
+        const Vec3 unitPerp =
+            exactNormalize (source.perpendicularComponent (basis));
+        const float perpDist =
+            sqrtXXX (1 - (cosineOfConeAngle * cosineOfConeAngle));
+        return ((basis * cosineOfConeAngle) + (unitPerp * perpDist)) *
+               sourceLength;
+    }
+
+
+    class MathOperation : public Operation
+    {
+    public:
+        MathOperation (const MathKind k,
+                       std::vector<TestVehicle>& v,
+                       const std::vector<float>& a)
+            : kind (k), vehicles (v), angles (a), sink (0) {}
+        void run (const size_t i)
+        {
+            sink += evaluate (i).x;
+        }
+        Vec3 evaluate (const size_t i)
+        {
+            TestVehicle& vehicle = vehicles[i];
+            const TestVehicle& next = vehicles[(i + 1) % vehicles.size ()];
+            const Vec3& p = vehicle.position ();
+            switch (kind)
+            {
+            case lengthMath:
+                return Vec3 (p.length (), 0, 0);
+            case normalizeMath:
+                return p.normalize ();
+            case truncateLengthMath:
+                return p.truncateLength (worldSize / 4);
+            case rotateMath:
+                return p.rotateAboutGlobalY (angles[i]);
+            case deviationMath:
+                return limitMaxDeviationAngle (p, 0.7f, vehicle.forward ());
+            case isAheadMath:
+                return Vec3 (vehicle.isAhead (next.position ()) ? 1.0f : 0, 0, 0);
+            default:
+                return Vec3 (vehicle.inBoidNeighborhood (next, 1, worldSize / 2,
+                                                         0.2f) ? 1.0f : 0,
+                             0, 0);
+            }
+        }
+        // what evaluate gives with exact math
+        Vec3 exact (const size_t i) const
+        {
+            const TestVehicle& vehicle = vehicles[i];
+            const TestVehicle& next = vehicles[(i + 1) % vehicles.size ()];
+            const Vec3& p = vehicle.position ();
+            const Vec3 offset = next.position () - p;
+            switch (kind)
+            {
+            case lengthMath:
+                return Vec3 (sqrtXXX (p.lengthSquared ()), 0, 0);
+            case normalizeMath:
+                return exactNormalize (p);
+            case truncateLengthMath:
+            {
+                const float maxLength = worldSize / 4;
+                const float lengthSquared = p.lengthSquared ();
+                if (lengthSquared <= maxLength * maxLength) return p;
+                return p * (maxLength / sqrtXXX (lengthSquared));
+            }
+            case rotateMath:
+            {
+                const float s = sinXXX (angles[i]);
+                const float c = cosXXX (angles[i]);
+                return Vec3 ((p.x * c) + (p.z * s), p.y, (p.z * c) - (p.x * s));
+            }
+            case deviationMath:
+                return exactLimitMaxDeviationAngle (p, 0.7f,
+                                                    vehicle.forward ());
+            case isAheadMath:
+                return Vec3 ((vehicle.forward ().dot (exactNormalize (offset)) >
+                              0.707f) ? 1.0f : 0,
+                             0, 0);
+            default:
+            {
+                const float maxDistance = worldSize / 2;
+                const float distanceSquared = offset.lengthSquared ();
+                bool inside;
+                if (&next == &vehicle) inside = false;
+                else if (distanceSquared < 1) inside = true;
+                else if (distanceSquared > maxDistance * maxDistance)
+                    inside = false;
+                else inside = (vehicle.forward ().dot
+                               (offset / sqrtXXX (distanceSquared)) > 0.2f);
+                return Vec3 (inside ? 1.0f : 0, 0, 0);
+            }
+            }
+        }
+        const MathKind kind;
+        std::vector<TestVehicle>& vehicles;
+        const std::vector<float>& angles;
+        float sink;
+    };
+
+
+    void benchmarkMath (const Distribution d,
+                        const std::vector<Vec3>& points,
+                        RandomStream& random)
+    {
+        std::vector<TestVehicle> vehicles (points.size ());
+        std::vector<float> angles (points.size ());
+        for (size_t i = 0; i < points.size (); i++)
+        {
+            vehicles[i].setPosition (points[i]);
+            vehicles[i].regenerateOrthonormalBasisUF
+                (RandomUnitVectorOnXZPlane (random));
+            angles[i] = random.frandom2 (-10, 10);
+        }
+
+        for (int k = 0; k < mathKindCount; k++)
+        {
+            const MathKind kind = (MathKind) k;
+            if (! selected (mathKindName (kind))) continue;
+            MathOperation operation (kind, vehicles, angles);
+
+            const std::string name = (std::string (mathKindName (kind)) +
+                                      (approximateMathIsOn () ?
+                                       "/approximate" : "/exact"));
+            measure (name.c_str (), d, points.size (),
+                     operation, points.size ());
+            if (! approximateMathIsOn ()) continue;
+
+            // compare the approximate results with the exact ones
+            double maxError = 0;
+            double totalError = 0;
+            size_t compared = 0;
+            for (size_t i = 0; i < points.size (); i++)
+            {
+                const Vec3 exact = operation.exact (i);
+                const Vec3 approximate = operation.evaluate (i);
+                const double e = sqrtXXX (exact.lengthSquared ());
+                if (! isAngleTest (kind) && (e == 0)) continue;
+                const double error = (sqrtXXX ((approximate -
+                                                exact).lengthSquared ()) /
+                                      (isAngleTest (kind) ? 1 : e));
+                totalError += error;
+                if (maxError < error) maxError = error;
+                compared++;
+            }
+
+            std::cout << "{\"accuracy\":\"" << mathKindName (kind) << "\""
+                      << ",\"distribution\":\"" << distributionName (d) << "\""
+                      << ",\"size\":" << points.size ();
+            if (isAngleTest (kind))
+                std::cout << ",\"mismatch_rate\":"
+                          << (compared ? totalError / compared : 0);
+            else
+                std::cout << ",\"max_relative_error\":" << maxError
+                          << ",\"mean_relative_error\":"
+                          << (compared ? totalError / compared : 0);
+            std::cout << "}" << std::endl;
+        }
+    }
+
+
+    // ------------------------------------------------------------------------
+    // parse a comma separated list of sizes
+
+
+    bool parseSizes (const char* list, std::vector<size_t>& result)
+    {
+        result.clear ();
+        std::istringstream is (list);
+        std::string item;
+        while (std::getline (is, item, ','))
+        {
+            const int size = atoi (item.c_str ());
+            if (size <= 0) return false;
+            result.push_back ((size_t) size);
+        }
+        return ! result.empty ();
+    }
+
+
+    void printUsage (const char* programName)
+    {
+        std::cerr << "usage: " << programName
+                  << " [--sizes n,n,...] [--path-sizes n,n,...]"
+                  << " [--min-time seconds] [--seed n] [--filter text]"
+                  << std::endl;
+    }
+
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+int main (int argc, char **argv)
+{
+    parseSizes ("1000,10000,100000", sizes);
+    parseSizes ("10,100,1000,10000,100000", pathSizes);
+
+    for (int i = 1; i < argc; i++)
+    {
+        const bool hasValue = (i + 1) < argc;
+
+        if (hasValue && (strcmp (argv[i], "--sizes") == 0))
+        {
+            if (! parseSizes (argv[++i], sizes))
+            {
+                std::cerr << "bad size list" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (hasValue && (strcmp (argv[i], "--path-sizes") == 0))
+        {
+            if (! parseSizes (argv[++i], pathSizes))
+            {
+                std::cerr << "bad path size list" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (hasValue && (strcmp (argv[i], "--min-time") == 0))
+        {
+            minSeconds = atof (argv[++i]);
+        }
+        else if (hasValue && (strcmp (argv[i], "--seed") == 0))
+        {
+            seed = strtoull (argv[++i], NULL, 10);
+        }
+        else if (hasValue && (strcmp (argv[i], "--filter") == 0))
+        {
+            filter = argv[++i];
+        }
+        else
+        {
+            printUsage (argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (int d = 0; d < distributionCount; d++)
+    {
+        const Distribution distribution = (Distribution) d;
+        for (size_t s = 0; s < sizes.size (); s++)
+        {
+            RandomStream random (seed, d);
+            std::vector<Vec3> points;
+            makePoints (distribution, sizes[s], random, points);
+            benchmarkLq (distribution, points, random);
+            benchmarkDatabases (distribution, points);
+            benchmarkObstacles (distribution, points, random);
+            benchmarkMath (distribution, points, random);
+        }
+        for (size_t s = 0; s < pathSizes.size (); s++)
+        {
+            RandomStream random (seed, d);
+            benchmarkPath (distribution, pathSizes[s], random);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,202 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// NeighborList
+//
+// See NeighborList.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/NeighborList.h"
+
+
+// ----------------------------------------------------------------------------
+// the first frame rebuilds
+
+
+OpenSteer::NeighborListSkin::NeighborListSkin (const float skin)
+    : _skin (skin),
+      generation (1),
+      rebuildPending (true),
+      maxDisplacementSquared (0),
+      maxStepSquared (0)
+{
+}
+
+
+void 
+OpenSteer::NeighborListSkin::beginFrame (const Vec3* positions,
+                                         const size_t count)
+{
+    beginFrame (count);
+    for (size_t i = 0; i < count; i++) noteVehicle (i, positions[i]);
+    endFrame ();
+}
+
+
+void 
+OpenSteer::NeighborListSkin::beginFrame (const size_t count)
+{
+    if (count != rebuildPositions.size())
+    {
+        rebuildPositions.resize (count);
+        previousPositions.resize (count);
+        invalidate ();
+    }
+    maxDisplacementSquared = 0;
+    maxStepSquared = 0;
+}
+
+
+void 
+OpenSteer::NeighborListSkin::noteVehicle (const size_t i,
+                                          const Vec3& position)
+{
+    const float d2 = (position - rebuildPositions[i]).lengthSquared ();
+    const float s2 = (position - previousPositions[i]).lengthSquared ();
+    if (d2 > maxDisplacementSquared) maxDisplacementSquared = d2;
+    if (s2 > maxStepSquared) maxStepSquared = s2;
+    previousPositions[i] = position;
+}
+
+
+void 
+OpenSteer::NeighborListSkin::endFrame (void)
+{
+    // any two vehicles may have closed in by twice the largest
+    // displacement, plus a step each during this frame's updates
+    const float bound = 2 * (sqrtXXX (maxDisplacementSquared) +
+                             sqrtXXX (maxStepSquared));
+    if (rebuildPending || (bound > _skin))
+    {
+        rebuildPositions = previousPositions;
+        if (! rebuildPending) generation++;
+        rebuildPending = false;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::NeighborList::findNeighbors (const NeighborListSkin& skin,
+                                        AbstractTokenForProximityDatabase<AbstractVehicle*>& token,
+                                        const Vec3& center,
+                                        const float radius,
+                                        AVNeighborGroup& results)
+{
+    if ((generation != skin.currentGeneration ()) ||
+        (radius + skin.skin () > builtRadius))
+    {
+        cached.clear ();
+        builtRadius = radius + skin.skin ();
+        token.findNeighbors (center, builtRadius, cached);
+        storage.set (cached.capacity () * sizeof (AVNeighbor));
+        generation = skin.currentGeneration ();
+    }
+
+    const float r2 = radius * radius;
+    for (AVNeighborIterator i = cached.begin(); i != cached.end(); ++i)
+    {
+        const Vec3 offset = i->object->position () - center;
+        const float d2 = offset.lengthSquared ();
+        if (d2 < r2) results.push_back (AVNeighbor (i->object, d2, offset));
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// refresh the list when its turn has come: after an invalidation (or a
+// change of radius) all lists are refreshed at once, and their next turns
+// staggered by phase
+
+
+void 
+OpenSteer::NeighborList::refresh (const NeighborRefreshSlices& slices,
+                                  const size_t phase,
+                                  AbstractTokenForProximityDatabase<AbstractVehicle*>& token,
+                                  const Vec3& center,
+                                  const float radius)
+{
+    const size_t n = slices.slices ();
+    if ((generation != slices.currentGeneration ()) || (radius != builtRadius))
+    {
+        age = phase % n;
+    }
+    else
+    {
+        if (++age < n) return;
+        age = 0;
+    }
+    cached.clear ();
+    builtRadius = radius;
+    token.findNeighbors (center, radius, cached);
+    storage.set (cached.capacity () * sizeof (AVNeighbor));
+    generation = slices.currentGeneration ();
+}
+
+
+void 
+OpenSteer::NeighborList::findNeighbors (const NeighborRefreshSlices& slices,
+                                        const size_t phase,
+                                        AbstractTokenForProximityDatabase<AbstractVehicle*>& token,
+                                        const Vec3& center,
+                                        const float radius,
+                                        AVNeighborGroup& results)
+{
+    refresh (slices, phase, token, center, radius);
+    const float r2 = radius * radius;
+    for (AVNeighborIterator i = cached.begin(); i != cached.end(); ++i)
+    {
+        const Vec3 offset = i->object->position () - center;
+        const float d2 = offset.lengthSquared ();
+        if (d2 < r2) results.push_back (AVNeighbor (i->object, d2, offset));
+    }
+}
+
+
+void 
+OpenSteer::NeighborList::findNeighbors (const NeighborRefreshSlices& slices,
+                                        const size_t phase,
+                                        AbstractTokenForProximityDatabase<AbstractVehicle*>& token,
+                                        const Vec3& center,
+                                        const float radius,
+                                        AVGroup& results)
+{
+    refresh (slices, phase, token, center, radius);
+    const float r2 = radius * radius;
+    for (AVNeighborIterator i = cached.begin(); i != cached.end(); ++i)
+    {
+        const Vec3 offset = i->object->position () - center;
+        if (offset.lengthSquared () < r2) results.push_back (i->object);
+    }
+}
@@ -39,6 +39,9 @@
 #include "OpenSteer/Obstacle.h"
 
 
+#include <algorithm>
+
+
 // ----------------------------------------------------------------------------
 // Obstacle
 // compute steering for a vehicle to avoid this obstacle, if needed 
@@ -174,6 +177,7 @@ findIntersectionWithVehiclePath (const AbstractVehicle& vehicle,
 	if (pi.vehicleOutside && (seenFrom () == inside))
 	{
 		pi.intersect = true;
+		pi.obstacle = this;
 		pi.distance = 0.0f;
 		pi.steerHint = (center - vehicle.position()).normalize();
 		return;
@@ -353,3 +357,361 @@ xyPointInsideShape (const Vec3& point, float radius) const
 
 
 // ----------------------------------------------------------------------------
+// SphereObstacle, BoxObstacle, RectangleObstacle
+// bounding spheres for ObstacleIndex
+
+
+bool 
+OpenSteer::
+SphereObstacle::
+getBoundingSphere (Vec3& c, float& r) const
+{
+    if (seenFrom () == inside) return false;
+    c = center;
+    r = radius;
+    return true;
+}
+
+
+bool 
+OpenSteer::
+BoxObstacle::
+getBoundingSphere (Vec3& c, float& r) const
+{
+    c = position ();
+    r = 0.5f * sqrtXXX (square (width) + square (height) + square (depth));
+    return true;
+}
+
+
+bool 
+OpenSteer::
+RectangleObstacle::
+getBoundingSphere (Vec3& c, float& r) const
+{
+    c = position ();
+    r = 0.5f * sqrtXXX (square (width) + square (height));
+    return true;
+}
+
+
+// ----------------------------------------------------------------------------
+// ObstacleIndex
+
+
+namespace {
+
+    // orders obstacle indices by the center of their bounds along one axis
+    class CenterLess
+    {
+    public:
+        CenterLess (const std::vector<OpenSteer::Vec3>& c, const int a)
+            : centers (c), axis (a) {}
+        bool operator() (const int a, const int b) const
+        {
+            return component (centers[a]) < component (centers[b]);
+        }
+    private:
+        float component (const OpenSteer::Vec3& v) const
+        {
+            return (axis == 0) ? v.x : ((axis == 1) ? v.y : v.z);
+        }
+        const std::vector<OpenSteer::Vec3>& centers;
+        const int axis;
+    };
+
+
+    // does the segment from o along unit direction d, for t in [0, length],
+    // meet the box [lo, hi]?
+    bool segmentMeetsBox (const OpenSteer::Vec3& o,
+                          const OpenSteer::Vec3& d,
+                          const float length,
+                          const OpenSteer::Vec3& lo,
+                          const OpenSteer::Vec3& hi)
+    {
+        const float origin[3] = {o.x, o.y, o.z};
+        const float direction[3] = {d.x, d.y, d.z};
+        const float low[3] = {lo.x, lo.y, lo.z};
+        const float high[3] = {hi.x, hi.y, hi.z};
+        float tmin = 0;
+        float tmax = length;
+        for (int a = 0; a < 3; a++)
+        {
+            if (fabsf (direction[a]) < 1e-8f)
+            {
+                if ((origin[a] < low[a]) || (origin[a] > high[a])) return false;
+            }
+            else
+            {
+                const float inverse = 1.0f / direction[a];
+                float t1 = (low[a] - origin[a]) * inverse;
+                float t2 = (high[a] - origin[a]) * inverse;
+                if (t1 > t2) std::swap (t1, t2);
+                if (t1 > tmin) tmin = t1;
+                if (t2 < tmax) tmax = t2;
+                if (tmin > tmax) return false;
+            }
+        }
+        return true;
+    }
+
+} // anonymous namespace
+
+
+void 
+OpenSteer::ObstacleIndex::build (const ObstacleGroup& group)
+{
+    obstacles.assign (group.begin(), group.end());
+    nodes.clear ();
+    leafObstacles.clear ();
+    unbounded.clear ();
+    leafOfObstacle.assign (obstacles.size(), -1);
+
+    std::vector<Vec3> centers (obstacles.size());
+    for (size_t i = 0; i < obstacles.size(); i++)
+    {
+        float r;
+        if (obstacles[i]->getBoundingSphere (centers[i], r))
+            leafObstacles.push_back ((int) i);
+        else
+            unbounded.push_back ((int) i);
+    }
+
+    if (! leafObstacles.empty ())
+        buildNode (-1, 0, (int) leafObstacles.size(), centers);
+}
+
+
+// build the subtree over count entries of leafObstacles from first,
+// splitting at the median center along the axis of widest spread
+
+
+int 
+OpenSteer::ObstacleIndex::buildNode (const int parent,
+                                     const int first,
+                                     const int count,
+                                     const std::vector<Vec3>& centers)
+{
+    const int maxLeafCount = 4;
+
+    const int n = (int) nodes.size();
+    nodes.push_back (Node ());
+    nodes[n].parent = parent;
+    nodes[n].left = nodes[n].right = -1;
+    nodes[n].first = first;
+    nodes[n].count = count;
+
+    if (count <= maxLeafCount)
+    {
+        for (int i = first; i < first + count; i++)
+            leafOfObstacle[leafObstacles[i]] = n;
+        refitLeaf (n);
+        return n;
+    }
+
+    // spread of the obstacles' centers
+    Vec3 lo (FLT_MAX, FLT_MAX, FLT_MAX);
+    Vec3 hi (-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (int i = first; i < first + count; i++)
+    {
+        const Vec3& c = centers[leafObstacles[i]];
+        lo = Vec3 (minXXX (lo.x, c.x), minXXX (lo.y, c.y), minXXX (lo.z, c.z));
+        hi = Vec3 (maxXXX (hi.x, c.x), maxXXX (hi.y, c.y), maxXXX (hi.z, c.z));
+    }
+    const Vec3 spread = hi - lo;
+    const int axis = ((spread.x >= spread.y) && (spread.x >= spread.z)) ? 0 :
+                     ((spread.y >= spread.z) ? 1 : 2);
+
+    const int half = count / 2;
+    std::nth_element (leafObstacles.begin() + first,
+                      leafObstacles.begin() + first + half,
+                      leafObstacles.begin() + first + count,
+                      CenterLess (centers, axis));
+
+    const int left = buildNode (n, first, half, centers);
+    const int right = buildNode (n, first + half, count - half, centers);
+    nodes[n].left = left;
+    nodes[n].right = right;
+    nodes[n].lo = Vec3 (minXXX (nodes[left].lo.x, nodes[right].lo.x),
+                        minXXX (nodes[left].lo.y, nodes[right].lo.y),
+                        minXXX (nodes[left].lo.z, nodes[right].lo.z));
+    nodes[n].hi = Vec3 (maxXXX (nodes[left].hi.x, nodes[right].hi.x),
+                        maxXXX (nodes[left].hi.y, nodes[right].hi.y),
+                        maxXXX (nodes[left].hi.z, nodes[right].hi.z));
+    return n;
+}
+
+
+void 
+OpenSteer::ObstacleIndex::boundsOfObstacle (const size_t i,
+                                            Vec3& lo,
+                                            Vec3& hi) const
+{
+    Vec3 c;
+    float r;
+    obstacles[i]->getBoundingSphere (c, r);
+    lo = c - Vec3 (r, r, r);
+    hi = c + Vec3 (r, r, r);
+}
+
+
+// recompute a leaf's box from its obstacles, then its ancestors' boxes
+
+
+void 
+OpenSteer::ObstacleIndex::refitLeaf (const int leaf)
+{
+    Node& node = nodes[leaf];
+    node.lo = Vec3 (FLT_MAX, FLT_MAX, FLT_MAX);
+    node.hi = Vec3 (-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (int i = node.first; i < node.first + node.count; i++)
+    {
+        Vec3 lo, hi;
+        boundsOfObstacle (leafObstacles[i], lo, hi);
+        node.lo = Vec3 (minXXX (node.lo.x, lo.x),
+                        minXXX (node.lo.y, lo.y),
+                        minXXX (node.lo.z, lo.z));
+        node.hi = Vec3 (maxXXX (node.hi.x, hi.x),
+                        maxXXX (node.hi.y, hi.y),
+                        maxXXX (node.hi.z, hi.z));
+    }
+
+    // ancestors (incomplete ones, while building, are done by buildNode)
+    for (int n = node.parent; n >= 0; n = nodes[n].parent)
+    {
+        if ((nodes[n].left < 0) || (nodes[n].right < 0)) break;
+        const Node& l = nodes[nodes[n].left];
+        const Node& r = nodes[nodes[n].right];
+        nodes[n].lo = Vec3 (minXXX (l.lo.x, r.lo.x),
+                            minXXX (l.lo.y, r.lo.y),
+                            minXXX (l.lo.z, r.lo.z));
+        nodes[n].hi = Vec3 (maxXXX (l.hi.x, r.hi.x),
+                            maxXXX (l.hi.y, r.hi.y),
+                            maxXXX (l.hi.z, r.hi.z));
+    }
+}
+
+
+void 
+OpenSteer::ObstacleIndex::refit (const size_t obstacleIndex)
+{
+    const int leaf = leafOfObstacle[obstacleIndex];
+    if (leaf >= 0) refitLeaf (leaf);
+}
+
+
+void 
+OpenSteer::ObstacleIndex::refit (void)
+{
+    // children always follow their parent, so a reverse pass visits
+    // every node after both of its children
+    for (int n = (int) nodes.size() - 1; n >= 0; n--)
+    {
+        Node& node = nodes[n];
+        if (node.left < 0)
+        {
+            node.lo = Vec3 (FLT_MAX, FLT_MAX, FLT_MAX);
+            node.hi = Vec3 (-FLT_MAX, -FLT_MAX, -FLT_MAX);
+            for (int i = node.first; i < node.first + node.count; i++)
+            {
+                Vec3 lo, hi;
+                boundsOfObstacle (leafObstacles[i], lo, hi);
+                node.lo = Vec3 (minXXX (node.lo.x, lo.x),
+                                minXXX (node.lo.y, lo.y),
+                                minXXX (node.lo.z, lo.z));
+                node.hi = Vec3 (maxXXX (node.hi.x, hi.x),
+                                maxXXX (node.hi.y, hi.y),
+                                maxXXX (node.hi.z, hi.z));
+            }
+        }
+        else
+        {
+            const Node& l = nodes[node.left];
+            const Node& r = nodes[node.right];
+            node.lo = Vec3 (minXXX (l.lo.x, r.lo.x),
+                            minXXX (l.lo.y, r.lo.y),
+                            minXXX (l.lo.z, r.lo.z));
+            node.hi = Vec3 (maxXXX (l.hi.x, r.hi.x),
+                            maxXXX (l.hi.y, r.hi.y),
+                            maxXXX (l.hi.z, r.hi.z));
+        }
+    }
+}
+
+
+OpenSteer::Vec3 
+OpenSteer::ObstacleIndex::
+steerToAvoidObstacles (const AbstractVehicle& vehicle,
+                       const float minTimeToCollision) const
+{
+    // only intersections nearer than this can cause steering
+    const float minDistanceToCollision = minTimeToCollision * vehicle.speed();
+    if (minDistanceToCollision <= 0) return Vec3::zero;
+
+    AbstractObstacle::PathIntersection nearest, next;
+    firstPathIntersection (vehicle, minDistanceToCollision, nearest, next);
+    return nearest.steerToAvoidIfNeeded (vehicle, minTimeToCollision);
+}
+
+
+void 
+OpenSteer::ObstacleIndex::
+firstPathIntersection (const AbstractVehicle& vehicle,
+                       const float maxDistance,
+                       AbstractObstacle::PathIntersection& nearest,
+                       AbstractObstacle::PathIntersection& next) const
+{
+    next.intersect = false;
+    nearest.intersect = false;
+
+    // as in firstPathIntersectionWithObstacleGroup, of equally near
+    // intersections the one of the obstacle first in the group wins
+    int nearestIndex = -1;
+    static thread_local std::vector<int> candidates;
+    candidates.assign (unbounded.begin(), unbounded.end());
+
+    // collect bounded obstacles whose box, grown by the margin
+    // getBoundingSphere allows for, meets the path
+    if (! nodes.empty ())
+    {
+        const float m = 2 * vehicle.radius();
+        const Vec3 margin (m, m, m);
+        int stack[64];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0)
+        {
+            const Node& node = nodes[stack[--top]];
+            if (! segmentMeetsBox (vehicle.position(), vehicle.forward(),
+                                   maxDistance,
+                                   node.lo - margin, node.hi + margin))
+                continue;
+            if (node.left < 0)
+            {
+                for (int i = node.first; i < node.first + node.count; i++)
+                    candidates.push_back (leafObstacles[i]);
+            }
+            else
+            {
+                stack[top++] = node.left;
+                stack[top++] = node.right;
+            }
+        }
+    }
+
+    for (size_t c = 0; c < candidates.size(); c++)
+    {
+        const int i = candidates[c];
+        obstacles[i]->findIntersectionWithVehiclePath (vehicle, next);
+        const bool firstFound = !nearest.intersect;
+        const bool nearestFound = (next.intersect &&
+                                   ((next.distance < nearest.distance) ||
+                                    ((next.distance == nearest.distance) &&
+                                     (i < nearestIndex))));
+        if (firstFound || nearestFound)
+        {
+            nearest = next;
+            nearestIndex = i;
+        }
+    }
+}
@@ -0,0 +1,275 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// See ObstacleBatch.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/ObstacleBatch.h"
+
+#include <typeinfo>
+
+
+// ----------------------------------------------------------------------------
+// Packet
+
+
+void 
+OpenSteer::ObstacleBatch::Packet::clear (void)
+{
+    obstacles.clear ();
+    indices.clear ();
+    centers.clear ();
+    radii.clear ();
+}
+
+
+void 
+OpenSteer::ObstacleBatch::Packet::add (const AbstractObstacle* o,
+                                       const int index)
+{
+    Vec3 c;
+    float r;
+    o->getBoundingSphere (c, r);
+    obstacles.push_back (o);
+    indices.push_back (index);
+    centers.push_back (c);
+    radii.push_back (r);
+}
+
+
+size_t 
+OpenSteer::ObstacleBatch::Packet::bytes (void) const
+{
+    return (obstacles.capacity() * sizeof (const AbstractObstacle*) +
+            indices.capacity() * sizeof (int) +
+            centers.capacity() * 3 * sizeof (float) +
+            radii.capacity() * sizeof (float));
+}
+
+
+void 
+OpenSteer::ObstacleBatch::Packet::refit (void)
+{
+    for (size_t i = 0; i < obstacles.size(); i++)
+    {
+        Vec3 c;
+        obstacles[i]->getBoundingSphere (c, radii[i]);
+        centers.set (i, c);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// screening and testing of packets
+
+
+namespace {
+
+    using namespace OpenSteer;
+    typedef AbstractObstacle::PathIntersection PathIntersection;
+
+
+    // the nearest intersection so far and the group index of its obstacle:
+    // as in firstPathIntersectionWithObstacleGroup, of equally near
+    // intersections the one of the obstacle first in the group wins
+    class Nearest
+    {
+    public:
+        Nearest (PathIntersection& n, PathIntersection& x)
+            : nearest (n), next (x), index (-1)
+        {
+            nearest.intersect = false;
+            next.intersect = false;
+        }
+
+        void offer (const int i)
+        {
+            const bool firstFound = !nearest.intersect;
+            const bool nearestFound = (next.intersect &&
+                                       ((next.distance < nearest.distance) ||
+                                        ((next.distance == nearest.distance) &&
+                                         (i < index))));
+            if (firstFound || nearestFound)
+            {
+                nearest = next;
+                index = i;
+            }
+        }
+
+        PathIntersection& nearest;
+        PathIntersection& next;
+        int index;
+    };
+
+
+    // Screen every obstacle of a packet, all of concrete type ObstacleType,
+    // against the vehicle's path line, then test the survivors.  With o the
+    // offset from the vehicle to a bounding sphere's center, a the length
+    // of o along the vehicle's forward axis and R the sphere's radius
+    // grown by the given multiple of the vehicle's radius, the path can
+    // only meet the sphere when |o|^2 - a^2 <= R^2, and only ahead of the
+    // vehicle (and nearer than maxDistance) when -R <= a <= maxDistance + R.
+    // The screen allows for the rounding of |o|^2 - a^2.
+    template <class ObstacleType>
+    void testPacket (const std::vector<const AbstractObstacle*>& obstacles,
+                     const std::vector<int>& indices,
+                     const Vec3Batch& centers,
+                     const std::vector<float>& radii,
+                     const float radiusMultiple,
+                     const AbstractVehicle& vehicle,
+                     const float maxDistance,
+                     Nearest& nearest)
+    {
+        const size_t n = obstacles.size();
+        if (n == 0) return;
+
+        static thread_local std::vector<float> d2;
+        static thread_local std::vector<float> along;
+        if (d2.size() < n)
+        {
+            d2.resize (n);
+            along.resize (n);
+        }
+
+        const Vec3 p = vehicle.position ();
+        const Vec3 f = vehicle.forward ();
+        centers.distanceSquared (p, &d2[0]);
+        centers.dot (f, &along[0]);
+
+        const float fp = f.dot (p);
+        const float margin = radiusMultiple * vehicle.radius ();
+        const float rounding = 1.0e-5f;
+
+        for (size_t i = 0; i < n; i++)
+        {
+            const float a = along[i] - fp;
+            const float r = radii[i] + margin;
+            const float slack = rounding * (d2[i] + r * r) + rounding;
+            if ((d2[i] - (a * a) <= (r * r) + slack) &&
+                (a >= -r - slack) &&
+                (a <= maxDistance + r + slack))
+            {
+                const ObstacleType& o = *static_cast<const ObstacleType*> (obstacles[i]);
+                o.ObstacleType::findIntersectionWithVehiclePath (vehicle, nearest.next);
+                nearest.offer (indices[i]);
+            }
+        }
+    }
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+// ObstacleBatch
+
+
+void 
+OpenSteer::ObstacleBatch::build (const ObstacleGroup& obstacles)
+{
+    group = obstacles;
+    spheres.clear ();
+    boxes.clear ();
+    rectangles.clear ();
+    others.clear ();
+
+    for (size_t i = 0; i < group.size(); i++)
+    {
+        const AbstractObstacle* o = group[i];
+        const std::type_info& type = typeid (*o);
+        if ((type == typeid (SphereObstacle)) && (o->seenFrom () != AbstractObstacle::inside))
+            spheres.add (o, (int) i);
+        else if (type == typeid (BoxObstacle))
+            boxes.add (o, (int) i);
+        else if (type == typeid (RectangleObstacle))
+            rectangles.add (o, (int) i);
+        else
+            others.push_back ((int) i);
+    }
+
+    storage.set (group.capacity() * sizeof (AbstractObstacle*) +
+                 spheres.bytes () + boxes.bytes () + rectangles.bytes () +
+                 others.capacity() * sizeof (int));
+}
+
+
+void 
+OpenSteer::ObstacleBatch::refit (void)
+{
+    spheres.refit ();
+    boxes.refit ();
+    rectangles.refit ();
+}
+
+
+OpenSteer::Vec3 
+OpenSteer::ObstacleBatch::
+steerToAvoidObstacles (const AbstractVehicle& vehicle,
+                       const float minTimeToCollision) const
+{
+    // only intersections nearer than this can cause steering
+    const float minDistanceToCollision = minTimeToCollision * vehicle.speed();
+    if (minDistanceToCollision <= 0) return Vec3::zero;
+
+    AbstractObstacle::PathIntersection nearest, next;
+    firstPathIntersection (vehicle, nearest, next, minDistanceToCollision);
+    return nearest.steerToAvoidIfNeeded (vehicle, minTimeToCollision);
+}
+
+
+void 
+OpenSteer::ObstacleBatch::
+firstPathIntersection (const AbstractVehicle& vehicle,
+                       AbstractObstacle::PathIntersection& nearest,
+                       AbstractObstacle::PathIntersection& next,
+                       const float maxDistance) const
+{
+    Nearest n (nearest, next);
+
+    // a sphere's intersections lie within its radius grown by the
+    // vehicle's, those of boxes and rectangles within twice that (see
+    // AbstractObstacle::getBoundingSphere)
+    testPacket<SphereObstacle> (spheres.obstacles, spheres.indices,
+                                spheres.centers, spheres.radii, 1,
+                                vehicle, maxDistance, n);
+    testPacket<BoxObstacle> (boxes.obstacles, boxes.indices,
+                             boxes.centers, boxes.radii, 2,
+                             vehicle, maxDistance, n);
+    testPacket<RectangleObstacle> (rectangles.obstacles, rectangles.indices,
+                                   rectangles.centers, rectangles.radii, 2,
+                                   vehicle, maxDistance, n);
+
+    for (size_t i = 0; i < others.size(); i++)
+    {
+        group[others[i]]->findIntersectionWithVehiclePath (vehicle, next);
+        n.offer (others[i]);
+    }
+}
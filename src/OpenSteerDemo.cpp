@@ -43,13 +43,26 @@
 
 #include "OpenSteer/OpenSteerDemo.h"
 #include "OpenSteer/Annotation.h"
+#include "OpenSteer/AnnotationStream.h"
 #include "OpenSteer/Color.h"
 #include "OpenSteer/Vec3.h"
+#include "OpenSteer/SimpleVehicle.h"
+#include "OpenSteer/SimulationSnapshot.h"
+#include "OpenSteer/Profiler.h"
+#include "OpenSteer/PhaseTimer.h"
+#include "OpenSteer/FrameHistory.h"
+#include "OpenSteer/MemoryAccount.h"
+#include "OpenSteer/SteeringLog.h"
+#include "OpenSteer/Telemetry.h"
 
 #include <algorithm>
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
 
 // Include headers for OpenGL (gl.h), OpenGL Utility Library (glu.h) and
 // OpenGL Utility Toolkit (glut.h).
@@ -69,6 +82,13 @@
 OpenSteer::Clock OpenSteer::OpenSteerDemo::clock;
 
 
+// ----------------------------------------------------------------------------
+// paces the display while a decoupled simulation thread uses "clock"
+
+
+OpenSteer::Clock OpenSteer::OpenSteerDemo::displayClock;
+
+
 // ----------------------------------------------------------------------------
 // camera automatically tracks selected vehicle
 
@@ -96,14 +116,7 @@ OpenSteer::AbstractVehicle* OpenSteer::OpenSteerDemo::selectedVehicle = NULL;
 // phase: identifies current phase of the per-frame update cycle
 
 
-int OpenSteer::OpenSteerDemo::phase = OpenSteer::OpenSteerDemo::overheadPhase;
-
-
-// ----------------------------------------------------------------------------
-// graphical annotation: master on/off switch
-
-
-bool OpenSteer::enableAnnotation = true;
+thread_local int OpenSteer::OpenSteerDemo::phase = OpenSteer::OpenSteerDemo::overheadPhase;
 
 
 // ----------------------------------------------------------------------------
@@ -151,6 +164,334 @@ OpenSteer::OpenSteerDemo::initialize (void)
 }
 
 
+// ----------------------------------------------------------------------------
+// state of the decoupled simulation thread (see setDecoupledSimulation)
+
+
+namespace {
+
+    OpenSteer::SnapshotTripleBuffer gSnapshots;
+
+    // heap allocated so it is never destroyed while running, even by exit
+    std::thread* gSimulationThread = NULL;
+    std::atomic<bool> gStopSimulation (false);
+
+    std::mutex gSimulationMutex;
+
+    // SimulationLocks waiting for gSimulationMutex, which the simulation
+    // thread lets go first, and the number held by this thread
+    std::atomic<int> gLocksWaiting (0);
+    thread_local int tLocksHeld = 0;
+
+    // the camera position as of the last drawn snapshot, for cameraPosition
+    std::mutex gCameraPositionMutex;
+    OpenSteer::Vec3 gCameraPosition;
+
+    // stands in for a snapshot's vehicles when drawing them
+    class SnapshotVehicle : public OpenSteer::SimpleVehicle
+    {
+    public:
+        void update (const float, const float) {}
+    };
+
+    OpenSteer::SimpleVehicle& snapshotVehicle (void)
+    {
+        static SnapshotVehicle stand;
+        return stand;
+    }
+
+    void setFromSnapshot (OpenSteer::SimpleVehicle& v,
+                          const OpenSteer::SimulationSnapshot::Vehicle& record)
+    {
+        v.setSide (record.side);
+        v.setUp (record.up);
+        v.setForward (record.forward);
+        v.setPosition (record.position);
+        v.setRadius (record.radius);
+        v.setSpeed (record.speed);
+    }
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+// state of the profiler display (see setProfilerDisplay)
+
+
+namespace {
+
+    bool gProfilerDisplay = false;
+    OpenSteer::FrameHistory gFrameHistory;
+
+    // milliseconds spent drawing annotation during the latest redraw
+    float gAnnotationDrawTime = 0;
+
+    typedef std::chrono::steady_clock ProfilerClock;
+
+    float millisecondsSince (const ProfilerClock::time_point start)
+    {
+        return std::chrono::duration<float, std::milli>
+            (ProfilerClock::now () - start).count ();
+    }
+
+    // set a sample's update series and neighbor counts from the step just
+    // taken (PhaseTimer having been reset before it)
+    void sampleUpdate (OpenSteer::FrameSample& sample)
+    {
+        sample.setFromPhaseTimer ();
+        OpenSteer::PlugIn* plugIn = OpenSteer::OpenSteerDemo::selectedPlugIn;
+        sample.hasNeighborStatistics =
+            plugIn && plugIn->neighborStatistics (sample.minNeighbors,
+                                                  sample.maxNeighbors,
+                                                  sample.averageNeighbors);
+    }
+
+    // complete a sample with the redraw begun at drawStart and keep it
+    void recordFrame (OpenSteer::FrameSample sample,
+                      const ProfilerClock::time_point drawStart)
+    {
+        sample.milliseconds[OpenSteer::FrameSample::drawSeries] =
+            millisecondsSince (drawStart) - gAnnotationDrawTime;
+        sample.milliseconds[OpenSteer::FrameSample::annotationSeries] =
+            gAnnotationDrawTime;
+        gFrameHistory.add (sample);
+    }
+
+} // anonymous namespace
+
+
+void 
+OpenSteer::OpenSteerDemo::setProfilerDisplay (bool on)
+{
+    gProfilerDisplay = on;
+    PhaseTimer::enabled = on;
+    gFrameHistory.clear ();
+}
+
+
+bool 
+OpenSteer::OpenSteerDemo::profilerDisplayIsOn (void)
+{
+    return gProfilerDisplay;
+}
+
+
+const OpenSteer::FrameHistory& 
+OpenSteer::OpenSteerDemo::frameHistory (void)
+{
+    return gFrameHistory;
+}
+
+
+// ----------------------------------------------------------------------------
+// telemetry export at the end of each update (see setTelemetryWriter)
+
+
+namespace {
+
+    OpenSteer::TelemetryWriter* gTelemetryWriter = NULL;
+
+} // anonymous namespace
+
+
+void 
+OpenSteer::OpenSteerDemo::setTelemetryWriter (TelemetryWriter* writer)
+{
+    gTelemetryWriter = writer;
+}
+
+
+// ----------------------------------------------------------------------------
+// steering recording and replay (see setSteeringRecorder)
+
+
+namespace {
+
+    OpenSteer::SteeringRecorder* gSteeringRecorder = NULL;
+    OpenSteer::SteeringReplayer* gSteeringReplayer = NULL;
+
+} // anonymous namespace
+
+
+void 
+OpenSteer::OpenSteerDemo::setSteeringRecorder (SteeringRecorder* recorder)
+{
+    gSteeringRecorder = recorder;
+}
+
+
+void 
+OpenSteer::OpenSteerDemo::setSteeringReplayer (SteeringReplayer* replayer)
+{
+    gSteeringReplayer = replayer;
+}
+
+
+// ----------------------------------------------------------------------------
+// annotation streaming and playback (see setAnnotationStreamWriter)
+
+
+namespace {
+
+    OpenSteer::AnnotationStreamWriter* gAnnotationStreamWriter = NULL;
+    OpenSteer::SimulationSnapshot gStreamFrame;
+
+    // playback: the frame shown and the one after it, and the real time
+    // at which the stream's time zero was shown
+    OpenSteer::AnnotationStreamReader* gAnnotationPlayback = NULL;
+    const OpenSteer::PlugIn* gPlaybackPlugIn = NULL;
+    OpenSteer::SimulationSnapshot gPlaybackFrame;
+    OpenSteer::SimulationSnapshot gPlaybackNext;
+    bool gPlaybackStarted = false;
+    bool gPlaybackHasNext = false;
+    float gPlaybackOrigin = 0;
+
+
+    // show the latest recorded frame due at a given real time
+    void advanceAnnotationPlayback (const float realTime)
+    {
+        OpenSteer::AnnotationStreamReader& reader = *gAnnotationPlayback;
+
+        // (re)start from the beginning of the stream
+        if (! gPlaybackStarted)
+        {
+            reader.rewind ();
+            if (! reader.readFrame (gPlaybackFrame)) return;
+            gPlaybackHasNext = reader.readFrame (gPlaybackNext);
+            gPlaybackOrigin = realTime - gPlaybackFrame.currentTime;
+            gPlaybackStarted = true;
+        }
+
+        const float streamTime = realTime - gPlaybackOrigin;
+        while (gPlaybackHasNext && (gPlaybackNext.currentTime <= streamTime))
+        {
+            std::swap (gPlaybackFrame, gPlaybackNext);
+            gPlaybackHasNext = reader.readFrame (gPlaybackNext);
+        }
+
+        // loop once the last frame has had its step's time on screen
+        if (! gPlaybackHasNext &&
+            (streamTime >= gPlaybackFrame.currentTime +
+                           gPlaybackFrame.elapsedTime))
+            gPlaybackStarted = false;
+    }
+
+} // anonymous namespace
+
+
+void 
+OpenSteer::OpenSteerDemo::setAnnotationStreamWriter (AnnotationStreamWriter* writer)
+{
+    gAnnotationStreamWriter = writer;
+}
+
+
+bool 
+OpenSteer::OpenSteerDemo::setAnnotationPlayback (AnnotationStreamReader* reader)
+{
+    gAnnotationPlayback = NULL;
+    gPlaybackStarted = false;
+    if (! reader) return true;
+
+    PlugIn* pi = PlugIn::findByName (reader->plugInName().c_str ());
+    if (! pi) return false;
+    if (pi != selectedPlugIn)
+    {
+        closeSelectedPlugIn ();
+        selectedPlugIn = pi;
+        openSelectedPlugIn ();
+    }
+
+    gAnnotationPlayback = reader;
+    gPlaybackPlugIn = pi;
+    return true;
+}
+
+
+// ----------------------------------------------------------------------------
+// degradation under a frame time budget (see degradationLevel)
+
+
+namespace {
+
+    std::atomic<int> gDegradationLevel (0);
+    int gCalmFrames = 0;
+
+    // frames within half the budget before a level is restored
+    const int calmFramesToRestore = 60;
+
+
+    // one level more for a frame over budget, one less after a run of
+    // frames well within it
+    void noteFrameTime (const float used, const float budget)
+    {
+        if (budget <= 0)
+        {
+            gDegradationLevel = OpenSteer::OpenSteerDemo::fullQuality;
+            gCalmFrames = 0;
+        }
+        else if (used > budget)
+        {
+            if (gDegradationLevel < OpenSteer::OpenSteerDemo::slowNeighborRefresh)
+                gDegradationLevel++;
+            gCalmFrames = 0;
+        }
+        else if (used < budget / 2)
+        {
+            if (++gCalmFrames >= calmFramesToRestore)
+            {
+                if (gDegradationLevel > OpenSteer::OpenSteerDemo::fullQuality)
+                    gDegradationLevel--;
+                gCalmFrames = 0;
+            }
+        }
+        else
+        {
+            gCalmFrames = 0;
+        }
+    }
+
+
+    // annotation is off for the lifetime of one of these once degraded
+    class DegradedAnnotation
+    {
+    public:
+        DegradedAnnotation (void)
+            : restore (OpenSteer::annotationIsOn () &&
+                       (gDegradationLevel >=
+                        OpenSteer::OpenSteerDemo::skipAnnotation))
+        {
+            if (restore) OpenSteer::setAnnotationOff ();
+        }
+        ~DegradedAnnotation () {if (restore) OpenSteer::setAnnotationOn ();}
+    private:
+        const bool restore;
+    };
+
+} // anonymous namespace
+
+
+int 
+OpenSteer::OpenSteerDemo::degradationLevel (void)
+{
+    return gDegradationLevel;
+}
+
+
+float 
+OpenSteer::OpenSteerDemo::degradedBandScale (void)
+{
+    return (gDegradationLevel >= widenDetailBands) ? 0.5f : 1;
+}
+
+
+size_t 
+OpenSteer::OpenSteerDemo::degradedNeighborSlices (void)
+{
+    return (gDegradationLevel >= slowNeighborRefresh) ? 4 : 1;
+}
+
+
 // ----------------------------------------------------------------------------
 // main update function: step simulation forward and redraw scene
 
@@ -158,6 +499,43 @@ OpenSteer::OpenSteerDemo::initialize (void)
 void 
 OpenSteer::OpenSteerDemo::updateSimulationAndRedraw (void)
 {
+    // when playing an annotation stream back, just draw its current frame
+    // (the scenery of any other PlugIn selected meanwhile)
+    if (gAnnotationPlayback)
+    {
+        displayClock.update ();
+        initPhaseTimers ();
+        advanceAnnotationPlayback (displayClock.getTotalRealTime ());
+        gPlaybackFrame.plugIn = gPlaybackPlugIn;
+        redrawSnapshotOfSelectedPlugIn (gPlaybackFrame,
+                                        displayClock.getTotalRealTime (),
+                                        displayClock.getElapsedRealTime ());
+        return;
+    }
+
+    // with the simulation on its own thread, just draw its latest step
+    if (decoupledSimulationIsOn ())
+    {
+        displayClock.update ();
+        initPhaseTimers ();
+        const bool newStep = gSnapshots.acquire ();
+        const ProfilerClock::time_point drawStart = ProfilerClock::now ();
+        redrawSnapshotOfSelectedPlugIn (displayedSnapshot (),
+                                        displayClock.getTotalRealTime (),
+                                        displayClock.getElapsedRealTime ());
+
+        // a step redrawn again took no update time this frame
+        if (gProfilerDisplay)
+        {
+            FrameSample sample = displayedSnapshot ().frameSample;
+            if (! newStep)
+                for (int i = 0; i < FrameSample::drawSeries; i++)
+                    sample.milliseconds[i] = 0;
+            recordFrame (sample, drawStart);
+        }
+        return;
+    }
+
     // update global simulation clock
     clock.update ();
 
@@ -167,12 +545,197 @@ OpenSteer::OpenSteerDemo::updateSimulationAndRedraw (void)
     initPhaseTimers ();
 
     // run selected PlugIn (with simulation's current time and step size)
-    updateSelectedPlugIn (clock.getTotalSimulationTime (),
-                          clock.getElapsedSimulationTime ());
+    FrameSample sample;
+    if (gProfilerDisplay) PhaseTimer::reset ();
+    stepSelectedPlugIn ();
+    if (gProfilerDisplay) sampleUpdate (sample);
 
     // redraw selected PlugIn (based on real time)
+    const ProfilerClock::time_point drawStart = ProfilerClock::now ();
     redrawSelectedPlugIn (clock.getTotalRealTime (),
                           clock.getElapsedRealTime ());
+    if (gProfilerDisplay) recordFrame (sample, drawStart);
+
+    noteFrameTime (clock.getFrameTimeUsed (), clock.getFrameBudget ());
+}
+
+
+// ----------------------------------------------------------------------------
+// decoupled simulation: a thread steps the selected PlugIn and publishes a
+// snapshot of each step, the GLUT thread draws the latest one.  Input
+// handlers wait for the simulation between steps (see SimulationLock).
+
+
+OpenSteer::OpenSteerDemo::SimulationLock::SimulationLock (void)
+    : locked (gSimulationThread && (tLocksHeld == 0))
+{
+    if (locked)
+    {
+        gLocksWaiting++;
+        gSimulationMutex.lock ();
+        gLocksWaiting--;
+    }
+    tLocksHeld++;
+}
+
+
+OpenSteer::OpenSteerDemo::SimulationLock::~SimulationLock ()
+{
+    tLocksHeld--;
+    if (locked) gSimulationMutex.unlock ();
+}
+
+
+void 
+OpenSteer::OpenSteerDemo::setDecoupledSimulation (bool on)
+{
+    if (on == decoupledSimulationIsOn ()) return;
+
+    if (on)
+    {
+        // the display runs at a fixed 60fps, the simulation at clock's rate
+        displayClock.setFixedFrameRate (60);
+        displayClock.setAnimationMode (false);
+        displayClock.setVariableFrameRateMode (false);
+
+        gStopSimulation = false;
+        gSimulationThread = new std::thread (&runSimulationThread);
+    }
+    else
+    {
+        gStopSimulation = true;
+        gSimulationThread->join ();
+        delete gSimulationThread;
+        gSimulationThread = NULL;
+    }
+}
+
+
+bool 
+OpenSteer::OpenSteerDemo::decoupledSimulationIsOn (void)
+{
+    return gSimulationThread != NULL;
+}
+
+
+const OpenSteer::SimulationSnapshot& 
+OpenSteer::OpenSteerDemo::displayedSnapshot (void)
+{
+    return gSnapshots.front ();
+}
+
+
+OpenSteer::Vec3 
+OpenSteer::OpenSteerDemo::cameraPosition (void)
+{
+    if (! gSimulationThread) return camera.position ();
+
+    std::lock_guard<std::mutex> lock (gCameraPositionMutex);
+    return gCameraPosition;
+}
+
+
+void 
+OpenSteer::OpenSteerDemo::runSimulationThread (void)
+{
+    Profiler::setThreadName ("simulation");
+
+    while (! gStopSimulation)
+    {
+        // let waiting input handlers in between steps
+        while (gLocksWaiting > 0) std::this_thread::yield ();
+
+        {
+            std::lock_guard<std::mutex> lock (gSimulationMutex);
+            tLocksHeld++;
+            updateSelectedPlugInIntoSnapshot (gSnapshots.back ());
+            tLocksHeld--;
+        }
+        gSnapshots.publish ();
+    }
+}
+
+
+void 
+OpenSteer::OpenSteerDemo::updateSelectedPlugInIntoSnapshot (SimulationSnapshot& snapshot)
+{
+    clock.update ();
+    initPhaseTimers ();
+
+    // step the simulation, recording its annotation
+    snapshot.clear ();
+    captureDeferredAnnotation (&snapshot);
+    if (gProfilerDisplay) PhaseTimer::reset ();
+    stepSelectedPlugIn ();
+    snapshot.frameSample = FrameSample ();
+    if (gProfilerDisplay) sampleUpdate (snapshot.frameSample);
+    captureDeferredAnnotation (NULL);
+    noteFrameTime (clock.getFrameTimeUsed (), clock.getFrameBudget ());
+
+    // then the vehicles as the step left them
+    snapshot.captureVehicles (allVehiclesOfSelectedPlugIn (), selectedVehicle);
+    snapshot.plugIn = selectedPlugIn;
+    snapshot.currentTime = clock.getTotalSimulationTime ();
+    snapshot.elapsedTime = clock.getElapsedSimulationTime ();
+    snapshot.updateTime = phaseTimerUpdate ();
+    snapshot.stepsPerSecond = clock.getSmoothedFPS ();
+    snapshot.paused = clock.getPausedState ();
+}
+
+
+void 
+OpenSteer::OpenSteerDemo::redrawSnapshotOfSelectedPlugIn (const SimulationSnapshot& snapshot,
+                                                          const float currentTime,
+                                                          const float elapsedTime)
+{
+    OPENSTEER_PROFILE_SCOPE ("redrawSnapshotOfSelectedPlugIn");
+
+    // switch to Draw phase
+    pushPhase (drawPhase);
+    gAnnotationDrawTime = 0;
+
+    // until the first step of a newly selected PlugIn only its scenery
+    const bool current = (snapshot.plugIn == selectedPlugIn);
+    const SimulationSnapshot::Vehicle* selected =
+        current ? snapshot.selectedVehicle () : NULL;
+    SimpleVehicle& stand = snapshotVehicle ();
+
+    // camera follows the selected vehicle's recorded state
+    if (selected)
+    {
+        setFromSnapshot (stand, *selected);
+        updateCamera (currentTime, elapsedTime, stand);
+    }
+    {
+        std::lock_guard<std::mutex> lock (gCameraPositionMutex);
+        gCameraPosition = camera.position ();
+    }
+
+    selectedPlugIn->redrawSnapshot (snapshot, currentTime, elapsedTime);
+
+    if (current)
+    {
+        beginVehicleBatch ();
+        for (size_t i = 0; i < snapshot.vehicles.size(); i++)
+        {
+            setFromSnapshot (stand, snapshot.vehicles[i]);
+            drawBasic3dSphericalVehicle (stand, gGray70);
+        }
+        drawVehicleBatch ();
+
+        if (selected)
+        {
+            setFromSnapshot (stand, *selected);
+            circleHighlightVehicleUtility (stand);
+        }
+
+        const ProfilerClock::time_point annotationStart = ProfilerClock::now ();
+        drawSnapshotAnnotation (snapshot);
+        gAnnotationDrawTime = millisecondsSince (annotationStart);
+    }
+
+    // return to previous phase
+    popPhase ();
 }
 
 
@@ -194,6 +757,10 @@ OpenSteer::OpenSteerDemo::errorExit (const char* message)
 void 
 OpenSteer::OpenSteerDemo::exit (int exitCode)
 {
+    // keep a decoupled simulation from stepping during static destruction
+    // (the lock is never released)
+    if (decoupledSimulationIsOn () && (tLocksHeld == 0))
+        gSimulationMutex.lock ();
     ::exit (exitCode);
 }
 
@@ -258,6 +825,42 @@ OpenSteer::OpenSteerDemo::openSelectedPlugIn (void)
 }
 
 
+// ----------------------------------------------------------------------------
+// do this frame's simulation updates for the currently selected plug-in
+
+
+void 
+OpenSteer::OpenSteerDemo::stepSelectedPlugIn (void)
+{
+    if (clock.getFixedTimeStep () <= 0)
+    {
+        updateSelectedPlugIn (clock.getTotalSimulationTime (),
+                              clock.getElapsedSimulationTime ());
+        return;
+    }
+
+    // fixed steps: annotate only the last one (the one drawn), and give up
+    // the rest once out of frame time
+    const int steps = clock.getSubsteps ();
+    const bool annotation = annotationIsOn ();
+    for (int i = 0; i < steps; i++)
+    {
+        if ((i > 0) && clock.frameBudgetExceeded ())
+        {
+            clock.dropSubsteps (i);
+            break;
+        }
+        if (annotation && (i < steps - 1))
+            setAnnotationOff ();
+        else if (annotation)
+            setAnnotationOn ();
+        updateSelectedPlugIn (clock.getSubstepTime (i),
+                              clock.getFixedTimeStep ());
+    }
+    if (annotation) setAnnotationOn ();
+}
+
+
 // ----------------------------------------------------------------------------
 // do a simulation update for the currently selected plug-in
 
@@ -266,6 +869,8 @@ void
 OpenSteer::OpenSteerDemo::updateSelectedPlugIn (const float currentTime,
                                                 const float elapsedTime)
 {
+    OPENSTEER_PROFILE_SCOPE ("updateSelectedPlugIn");
+
     // switch to Update phase
     pushPhase (updatePhase);
 
@@ -279,14 +884,82 @@ OpenSteer::OpenSteerDemo::updateSelectedPlugIn (const float currentTime,
         if (vehicles.size() > 0) selectedVehicle = vehicles.front();
     }
 
-    // invoke selected PlugIn's Update method
-    selectedPlugIn->update (currentTime, elapsedTime);
+    // record the update's annotation for the stream, if any
+    SimulationSnapshot* outerCapture = NULL;
+    if (gAnnotationStreamWriter)
+    {
+        gStreamFrame.clear ();
+        outerCapture = captureDeferredAnnotation (&gStreamFrame);
+    }
+
+    // invoke selected PlugIn's Update method, unless a replay moves the
+    // vehicles instead
+    if (! (gSteeringReplayer &&
+           gSteeringReplayer->replayFrame (allVehiclesOfSelectedPlugIn ())))
+    {
+        DegradedAnnotation degraded;
+        OPENSTEER_PROFILE_SCOPE (selectedPlugIn->name ());
+        PhaseTimer::Scope timer (PhaseTimer::otherUpdatePhase);
+        selectedPlugIn->update (currentTime, elapsedTime);
+    }
+
+    if (gSteeringRecorder)
+        gSteeringRecorder->recordFrame (allVehiclesOfSelectedPlugIn (),
+                                        currentTime);
+
+    // export the step's vehicle states, if anyone listens
+    if (gTelemetryWriter)
+    {
+        OPENSTEER_PROFILE_SCOPE ("telemetry");
+        gTelemetryWriter->publish (allVehiclesOfSelectedPlugIn (), currentTime);
+    }
+
+    // stream the step's annotation and vehicles, handing the annotation on
+    // to a decoupled display too
+    if (gAnnotationStreamWriter)
+    {
+        OPENSTEER_PROFILE_SCOPE ("annotation stream");
+        captureDeferredAnnotation (outerCapture);
+        if (outerCapture)
+        {
+            for (size_t i = 0; i < gStreamFrame.lines.size(); i++)
+            {
+                const SimulationSnapshot::Line& l = gStreamFrame.lines[i];
+                outerCapture->addLine (l.startPoint, l.endPoint, l.color);
+            }
+            for (size_t i = 0; i < gStreamFrame.circles.size(); i++)
+            {
+                const SimulationSnapshot::CircleOrDisk& c =
+                    gStreamFrame.circles[i];
+                outerCapture->addCircleOrDisk (c.radius, c.axis, c.center,
+                                               c.color, c.segments,
+                                               c.filled, c.in3d);
+            }
+        }
+        gStreamFrame.captureVehicles (allVehiclesOfSelectedPlugIn (),
+                                      selectedVehicle);
+        gStreamFrame.currentTime = currentTime;
+        gStreamFrame.elapsedTime = elapsedTime;
+        gAnnotationStreamWriter->writeFrame (gStreamFrame);
+    }
 
     // return to previous phase
     popPhase ();
 }
 
 
+// ----------------------------------------------------------------------------
+// vehicles within this distance of the camera get annotation trails (from
+// TrailPool, up to its budget), as does the selected vehicle
+
+
+namespace {
+
+    const float gTrailFocusRadius = 200;
+
+} // anonymous namespace
+
+
 // ----------------------------------------------------------------------------
 // redraw graphics for the currently selected plug-in
 
@@ -295,15 +968,28 @@ void
 OpenSteer::OpenSteerDemo::redrawSelectedPlugIn (const float currentTime,
                                                 const float elapsedTime)
 {
+    OPENSTEER_PROFILE_SCOPE ("redrawSelectedPlugIn");
+
     // switch to Draw phase
     pushPhase (drawPhase);
 
+    // trails are kept for the selected vehicle and those near the camera
+    TrailPool& trails = TrailPool::shared ();
+    trails.beginFrame ();
+    trails.setFocus (camera.position (), gTrailFocusRadius,
+                     dynamic_cast<const void*> (selectedVehicle));
+
     // invoke selected PlugIn's Draw method
-    selectedPlugIn->redraw (currentTime, elapsedTime);
+    {
+        DegradedAnnotation degraded;
+        selectedPlugIn->redraw (currentTime, elapsedTime);
+    }
 
     // draw any annotation queued up during selected PlugIn's Update method
+    const ProfilerClock::time_point annotationStart = ProfilerClock::now ();
     drawAllDeferredLines ();
     drawAllDeferredCirclesOrDisks ();
+    gAnnotationDrawTime = millisecondsSince (annotationStart);
 
     // return to previous phase
     popPhase ();
@@ -737,6 +1423,8 @@ OpenSteer::OpenSteerDemo::keyboardMiniHelp (void)
     printMessage ("  Tab    select next PlugIn.");
     printMessage ("  a      toggle annotation on/off.");
     printMessage ("  Space  toggle between Run and Pause.");
+    printMessage ("  d      toggle simulation on its own thread.");
+    printMessage ("  p      toggle profiler display.");
     printMessage ("  ->     step forward one frame.");
     printMessage ("  Esc    exit.");
     printMessage ("");
@@ -750,13 +1438,12 @@ OpenSteer::OpenSteerDemo::keyboardMiniHelp (void)
 // manage OpenSteerDemo phase transitions (xxx and maintain phase timers)
 
 
-int OpenSteer::OpenSteerDemo::phaseStackIndex = 0;
+thread_local int OpenSteer::OpenSteerDemo::phaseStackIndex = 0;
 const int OpenSteer::OpenSteerDemo::phaseStackSize = 5;
-int OpenSteer::OpenSteerDemo::phaseStack [OpenSteer::OpenSteerDemo::phaseStackSize];
+thread_local int OpenSteer::OpenSteerDemo::phaseStack [OpenSteer::OpenSteerDemo::phaseStackSize];
 
 namespace OpenSteer {
-bool updatePhaseActive = false;
-bool drawPhaseActive = false;
+thread_local bool updatePhaseActive = false;
 }
 
 void 
@@ -795,8 +1482,8 @@ OpenSteer::OpenSteerDemo::popPhase (void)
 // ----------------------------------------------------------------------------
 
 
-float OpenSteer::OpenSteerDemo::phaseTimerBase = 0;
-float OpenSteer::OpenSteerDemo::phaseTimers [drawPhase+1];
+thread_local float OpenSteer::OpenSteerDemo::phaseTimerBase = 0;
+thread_local float OpenSteer::OpenSteerDemo::phaseTimers [drawPhase+1];
 
 
 void 
@@ -890,11 +1577,10 @@ namespace {
         glLoadIdentity ();
         const GLfloat w = width;
         const GLfloat h = height;
-        const GLfloat aspectRatio = (height == 0) ? 1 : w/h;
-        const GLfloat fieldOfViewY = 45;
-        const GLfloat hither = 1;  // put this on Camera so PlugIns can frob it
-        const GLfloat yon = 400;   // put this on Camera so PlugIns can frob it
-        gluPerspective (fieldOfViewY, aspectRatio, hither, yon);
+        OpenSteer::Camera& camera = OpenSteer::OpenSteerDemo::camera;
+        camera.aspectRatio = (height == 0) ? 1 : w/h;
+        gluPerspective (camera.fieldOfViewY, camera.aspectRatio,
+                        camera.nearDistance, camera.farDistance);
 
         // leave in modelview mode
         glMatrixMode(GL_MODELVIEW);
@@ -938,6 +1624,7 @@ namespace {
             // mouse-left (with no modifiers): select vehicle
             if (modNone && mouseL)
             {
+                OpenSteer::OpenSteerDemo::SimulationLock lock;
                 OpenSteer::OpenSteerDemo::selectVehicleNearestScreenPosition (x, y);
             }
 
@@ -1107,6 +1794,32 @@ namespace {
     // something like displayClockStatus, and that it should be part of
     // OpenSteerDemo instead of Draw  (cwr 11-23-04)
 
+    // while the simulation runs on its own thread: its stepping rate and
+    // update time (from the displayed snapshot) next to the display's rate
+
+    void
+    drawDisplaySimulationThreadStatus (void)
+    {
+        const OpenSteer::SimulationSnapshot& snapshot =
+            OpenSteer::OpenSteerDemo::displayedSnapshot ();
+        const OpenSteer::Vec3 screenLocation (10, 10 + 16, 0);
+
+        std::ostringstream status;
+        status << std::setiosflags (std::ios::fixed);
+        status << "Clock: simulation thread "
+               << std::setprecision (0) << snapshot.stepsPerSecond
+               << " steps/s (update "
+               << std::setprecision (2) << 1000 * snapshot.updateTime
+               << " ms), display "
+               << std::setprecision (0)
+               << OpenSteer::OpenSteerDemo::displayClock.getSmoothedFPS ()
+               << " fps";
+        if (snapshot.paused) status << " [paused]";
+        status << std::ends;
+        draw2dTextAt2dLocation (status, screenLocation, OpenSteer::gWhite, OpenSteer::drawGetWindowWidth(), OpenSteer::drawGetWindowHeight());
+    }
+
+
     float gSmoothedTimerDraw = 0;
     float gSmoothedTimerUpdate = 0;
     float gSmoothedTimerOverhead = 0;
@@ -1114,6 +1827,13 @@ namespace {
     void
     drawDisplayFPS (void)
     {
+        // the simulation thread has a status line of its own
+        if (OpenSteer::OpenSteerDemo::decoupledSimulationIsOn ())
+        {
+            drawDisplaySimulationThreadStatus ();
+            return;
+        }
+
         // skip several frames to allow frame rate to settle
         static int skipCount = 10;
         if (skipCount > 0)
@@ -1208,6 +1928,172 @@ namespace {
     }
 
 
+    // ------------------------------------------------------------------------
+    // memory status above the timers: live bytes (and blocks) per
+    // MemoryAccount category, and the storage per vehicle of the selected
+    // PlugIn (its vehicles, their tokens, neighbor lists and trails)
+
+
+    void
+    writeBytesToStream (const size_t bytes, std::ostringstream& stream)
+    {
+        stream << std::setprecision (1) << std::setiosflags (std::ios::fixed);
+        if (bytes >= 1024 * 1024) stream << bytes / (1024.0f * 1024) << " MB";
+        else if (bytes >= 1024)   stream << bytes / 1024.0f << " KB";
+        else                      stream << bytes << " B";
+    }
+
+
+    void
+    drawDisplayMemoryStatus (void)
+    {
+        typedef OpenSteer::MemoryAccount MA;
+        const int lh = 16; // xxx line height
+        const OpenSteer::Vec3 screenLocation (10, 10 + lh * 9, 0);
+
+        // (while the simulation runs on its own thread, count the vehicles
+        // of the displayed snapshot instead of the PlugIn's group)
+        const size_t vehicleCount =
+            OpenSteer::OpenSteerDemo::decoupledSimulationIsOn () ?
+            OpenSteer::OpenSteerDemo::displayedSnapshot ().vehicles.size () :
+            OpenSteer::OpenSteerDemo::allVehiclesOfSelectedPlugIn ().size ();
+        const size_t perVehicle = (MA::liveBytes (MA::vehicleMemory) +
+                                   MA::liveBytes (MA::tokenMemory) +
+                                   MA::liveBytes (MA::neighborMemory) +
+                                   MA::liveBytes (MA::trailMemory));
+
+        std::ostringstream status;
+        status << "Memory: ";
+        writeBytesToStream (MA::liveBytes (), status);
+        status << " in " << MA::liveAllocations () << " blocks";
+        if (vehicleCount > 0)
+        {
+            status << ", ";
+            writeBytesToStream (perVehicle / vehicleCount, status);
+            status << " per vehicle";
+        }
+        for (int i = 0; i < MA::categoryCount; i++)
+        {
+            const MA::Category c = (MA::Category) i;
+            status << ((i % 3) == 0 ? "\n  " : ", ") << MA::name (c) << " ";
+            writeBytesToStream (MA::liveBytes (c), status);
+            status << " (" << MA::liveAllocations (c) << ")";
+        }
+        status << std::ends;
+        draw2dTextAt2dLocation (status, screenLocation, OpenSteer::gGray80, OpenSteer::drawGetWindowWidth(), OpenSteer::drawGetWindowHeight());
+    }
+
+
+    // ------------------------------------------------------------------------
+    // profiler display in the upper right corner: a bar per recent frame,
+    // stacked from the frame's phase times, above a legend of each phase's
+    // average and the selected PlugIn's neighbors per agent
+
+
+    const OpenSteer::Color& seriesColor (const OpenSteer::FrameSample::Series s)
+    {
+        switch (s)
+        {
+        case OpenSteer::FrameSample::neighborQuerySeries:      return OpenSteer::gCyan;
+        case OpenSteer::FrameSample::steeringSeries:           return OpenSteer::gYellow;
+        case OpenSteer::FrameSample::applySteeringForceSeries: return OpenSteer::gOrange;
+        case OpenSteer::FrameSample::proximityUpdateSeries:    return OpenSteer::gMagenta;
+        case OpenSteer::FrameSample::drawSeries:               return OpenSteer::gGreen;
+        case OpenSteer::FrameSample::annotationSeries:         return OpenSteer::gRed;
+        default:                                               return OpenSteer::gGray50;
+        }
+    }
+
+
+    void
+    drawProfilerDisplay (void)
+    {
+        if (! OpenSteer::OpenSteerDemo::profilerDisplayIsOn ()) return;
+
+        const OpenSteer::FrameHistory& history =
+            OpenSteer::OpenSteerDemo::frameHistory ();
+        const float w = OpenSteer::drawGetWindowWidth ();
+        const float h = OpenSteer::drawGetWindowHeight ();
+        const int lh = 16; // xxx line height
+
+        // graph: one pixel per frame the history can hold, scaled to the
+        // next 1, 2, 5 times a power of ten milliseconds above its peak
+        const float graphWidth = (float) history.capacity ();
+        const float graphHeight = 100;
+        const float left = w - 10 - graphWidth;
+        const float bottom = h - 30 - graphHeight;
+        float scale = 1;
+        for (int i = 0; scale < history.maxTotal (); i++)
+            scale *= ((i % 3) == 1) ? 2.5f : 2;
+        const float pixelsPerMs = graphHeight / scale;
+
+        static std::vector<OpenSteer::Vec3> endPoints;
+        static std::vector<OpenSteer::Color> colors;
+        endPoints.clear ();
+        colors.clear ();
+
+        // the axis and the full scale gridline
+        endPoints.push_back (OpenSteer::Vec3 (left, bottom, 0));
+        endPoints.push_back (OpenSteer::Vec3 (left + graphWidth, bottom, 0));
+        endPoints.push_back (OpenSteer::Vec3 (left, bottom + graphHeight, 0));
+        endPoints.push_back (OpenSteer::Vec3 (left + graphWidth, bottom + graphHeight, 0));
+        colors.push_back (OpenSteer::gGray50);
+        colors.push_back (OpenSteer::gGray50);
+
+        // stacked bars, newest at the right
+        const float first = left + graphWidth - history.size ();
+        for (size_t i = 0; i < history.size (); i++)
+        {
+            const OpenSteer::FrameSample& sample = history[i];
+            const float x = first + i + 0.5f;
+            float y = bottom;
+            for (int j = 0; j < OpenSteer::FrameSample::seriesCount; j++)
+            {
+                const float top = y + sample.milliseconds[j] * pixelsPerMs;
+                if (top > y)
+                {
+                    endPoints.push_back (OpenSteer::Vec3 (x, y, 0));
+                    endPoints.push_back (OpenSteer::Vec3 (x, top, 0));
+                    colors.push_back
+                        (seriesColor ((OpenSteer::FrameSample::Series) j));
+                }
+                y = top;
+            }
+        }
+        OpenSteer::draw2dLines (&endPoints[0], &colors[0], colors.size (), w, h);
+
+        std::ostringstream scaleLabel;
+        scaleLabel << scale << " ms" << std::ends;
+        const OpenSteer::Vec3 scaleLocation (left, bottom + graphHeight + 4, 0);
+        draw2dTextAt2dLocation (scaleLabel, scaleLocation, OpenSteer::gGray50, w, h);
+
+        // legend: average milliseconds per phase, then neighbors
+        const OpenSteer::FrameSample average = history.average ();
+        OpenSteer::Vec3 legendLocation (left, bottom - lh, 0);
+        for (int j = 0; j < OpenSteer::FrameSample::seriesCount; j++)
+        {
+            const OpenSteer::FrameSample::Series series =
+                (OpenSteer::FrameSample::Series) j;
+            std::ostringstream line;
+            line << std::setprecision (2) << std::setiosflags (std::ios::fixed)
+                 << std::setw (6) << average.milliseconds[j] << " ms  "
+                 << OpenSteer::FrameSample::name (series) << std::ends;
+            draw2dTextAt2dLocation (line, legendLocation, seriesColor (series), w, h);
+            legendLocation.y -= lh;
+        }
+        if (average.hasNeighborStatistics)
+        {
+            std::ostringstream line;
+            line << "neighbors min " << average.minNeighbors
+                 << ", average " << std::setprecision (1)
+                 << std::setiosflags (std::ios::fixed)
+                 << average.averageNeighbors
+                 << ", max " << average.maxNeighbors << std::ends;
+            draw2dTextAt2dLocation (line, legendLocation, OpenSteer::gWhite, w, h);
+        }
+    }
+
+
     // ------------------------------------------------------------------------
     // cycle through frame rate presets  (XXX move this to OpenSteerDemo)
 
@@ -1263,6 +2149,21 @@ namespace {
     {
         std::ostringstream message;
 
+        // start or stop the simulation thread (which needs the lock free)
+        if (key == 'd')
+        {
+            OpenSteer::OpenSteerDemo::setDecoupledSimulation
+                (! OpenSteer::OpenSteerDemo::decoupledSimulationIsOn ());
+            OpenSteer::OpenSteerDemo::printMessage
+                (OpenSteer::OpenSteerDemo::decoupledSimulationIsOn () ?
+                 "simulation on its own thread" :
+                 "simulation on the display thread");
+            return;
+        }
+
+        // every other command may touch the simulation
+        OpenSteer::OpenSteerDemo::SimulationLock lock;
+
         // ascii codes
         const int tab = 9;
         const int space = 32;
@@ -1308,6 +2209,15 @@ namespace {
                                                     "annotation ON" : "annotation OFF");
             break;
 
+        // toggle the profiler display
+        case 'p':
+            OpenSteer::OpenSteerDemo::setProfilerDisplay
+                (! OpenSteer::OpenSteerDemo::profilerDisplayIsOn ());
+            OpenSteer::OpenSteerDemo::printMessage
+                (OpenSteer::OpenSteerDemo::profilerDisplayIsOn () ?
+                 "profiler display ON" : "profiler display OFF");
+            break;
+
         // toggle run/pause state
         case space:
             OpenSteer::OpenSteerDemo::printMessage (OpenSteer::OpenSteerDemo::clock.togglePausedState () ?
@@ -1366,6 +2276,7 @@ namespace {
     specialFunc (int key, int /*x*/, int /*y*/)
     {
         std::ostringstream message;
+        OpenSteer::OpenSteerDemo::SimulationLock lock;
 
         switch (key)
         {
@@ -1411,6 +2322,12 @@ namespace {
         // draw text showing (smoothed, rounded) "frames per second" rate
         drawDisplayFPS ();
 
+        // draw the live memory per subsystem
+        drawDisplayMemoryStatus ();
+
+        // draw the phase times of recent frames, if turned on
+        drawProfilerDisplay ();
+
         // draw the name of the selected PlugIn
         drawDisplayPlugInName ();
 
@@ -27,11 +27,50 @@
  */
 #include "OpenSteer/Path.h"
 
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OPENSTEER_UNUSED_PARAMETER
+#include "OpenSteer/UnusedParameter.h"
+
 OpenSteer::Path::~Path()
 {
     // Nothing to do.
 }
 
+
+
+OpenSteer::Vec3 
+OpenSteer::Path::mapPointToPath (const Vec3& point,
+                                 Vec3& tangent,
+                                 float& outside,
+                                 PathCursor& cursor) const
+{
+    OPENSTEER_UNUSED_PARAMETER(cursor);
+    return mapPointToPath (point, tangent, outside);
+}
+
+
+
+OpenSteer::Vec3 
+OpenSteer::Path::mapPathDistanceToPoint (float pathDistance,
+                                         PathCursor& cursor) const
+{
+    OPENSTEER_UNUSED_PARAMETER(cursor);
+    return mapPathDistanceToPoint (pathDistance);
+}
+
+
+
+float 
+OpenSteer::Path::mapPointToPathDistance (const Vec3& point,
+                                         PathCursor& cursor) const
+{
+    OPENSTEER_UNUSED_PARAMETER(cursor);
+    return mapPointToPathDistance (point);
+}
+
+
 /*
 OpenSteer::Path& OpenSteer::Path::operator=( Path const& )
 {
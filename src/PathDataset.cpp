@@ -0,0 +1,408 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+//
+// PathDataset
+//
+// See PathDataset.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/PathDataset.h"
+
+#include <cassert>
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+
+    // name in the checkpoint header
+    const char datasetName[] = "PathDataset";
+
+    // sections
+    const CheckpointTag entryTag = checkpointTag ("PDIR");
+    const CheckpointTag pointTag = checkpointTag ("PPNT");
+    const CheckpointTag tangentTag = checkpointTag ("PTAN");
+    const CheckpointTag lengthTag = checkpointTag ("PLEN");
+    const CheckpointTag startDistanceTag = checkpointTag ("PDST");
+    const CheckpointTag radiusTag = checkpointTag ("PRAD");
+    const CheckpointTag nodeTag = checkpointTag ("PNOD");
+    const CheckpointTag orderTag = checkpointTag ("PORD");
+
+
+    // true if count elements starting at first lie inside total
+    bool inside (const uint64_t first, const uint64_t count, const size_t total)
+    {
+        return (first <= total) && (count <= total - first);
+    }
+
+
+    // the points of a path without the repeated first point of a cycle
+    template <class PathAlike>
+    void copyPoints (const PathAlike& path, std::vector<Vec3>& points)
+    {
+        const size_t count = path.pointCount () - (path.isCyclic () ? 1 : 0);
+        points.resize (count);
+        for (size_t i = 0; i < count; i++) points[i] = path.point (i);
+    }
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::PathDatasetWriter::PathDatasetWriter (void)
+{
+}
+
+
+size_t 
+OpenSteer::PathDatasetWriter::addPath (const SegmentedPath& path,
+                                       const bool segmentIndex)
+{
+    assert (path.isValid () && "Only valid paths can be stored.");
+    std::vector<Vec3> pathPoints;
+    copyPoints (path, pathPoints);
+    const std::vector<float> pathRadii (path.segmentCount (), 0.0f);
+    return add (pathPoints, path.isCyclic (), pathRadii, segmentIndex);
+}
+
+
+size_t 
+OpenSteer::PathDatasetWriter::addPathway (const SegmentedPathway& pathway,
+                                          const bool segmentIndex)
+{
+    assert (pathway.isValid () && "Only valid pathways can be stored.");
+    std::vector<Vec3> pathPoints;
+    copyPoints (pathway, pathPoints);
+    std::vector<float> pathRadii (pathway.segmentCount ());
+    for (size_t i = 0; i < pathRadii.size (); i++)
+        pathRadii[i] = pathway.mapSegmentDistanceToRadius (i, 0.0f);
+    return add (pathPoints, pathway.isCyclic (), pathRadii, segmentIndex);
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+size_t 
+OpenSteer::PathDatasetWriter::add (const std::vector<Vec3>& pathPoints,
+                                   const bool cyclic,
+                                   const std::vector<float>& pathRadii,
+                                   const bool segmentIndex)
+{
+    // Rebuild the path, so the stored segment data is exactly what
+    // PolylineSegmentedPath computes for these points.
+    const PolylineSegmentedPath path (pathPoints.size (), &pathPoints[0], cyclic);
+    const PolylineSegmentedPath::View data = path.view ();
+    const size_t segments = data.pointCount - 1;
+
+    PathDatasetEntry entry;
+    entry.firstPoint = points.size ();
+    entry.firstSegment = tangents.size ();
+    entry.firstNode = nodes.size ();
+    entry.pointCount = (uint32_t) data.pointCount;
+    entry.nodeCount = 0;
+    entry.cyclic = cyclic;
+    entry.singleRadius = 1;
+    for (size_t i = 1; i < segments; i++)
+        if (pathRadii[i] != pathRadii[0]) entry.singleRadius = 0;
+    entry.indexSlack = 0;
+    entry.unused = 0;
+
+    points.insert (points.end (), data.points, data.points + data.pointCount);
+    startDistances.insert (startDistances.end (),
+                           data.segmentStartDistances,
+                           data.segmentStartDistances + data.pointCount);
+    tangents.insert (tangents.end (),
+                     data.segmentTangents,
+                     data.segmentTangents + segments);
+    lengths.insert (lengths.end (),
+                    data.segmentLengths,
+                    data.segmentLengths + segments);
+    radii.insert (radii.end (), pathRadii.begin (), pathRadii.end ());
+
+    if (segmentIndex)
+    {
+        SegmentedPathIndex index;
+        index.build (path, &pathRadii[0]);
+        const SegmentedPathIndex::View tree = index.view ();
+        entry.nodeCount = (uint32_t) tree.nodeCount;
+        entry.indexSlack = tree.slack;
+        nodes.insert (nodes.end (), tree.nodes, tree.nodes + tree.nodeCount);
+        order.insert (order.end (), tree.order, tree.order + segments);
+    }
+    else
+    {
+        // keep order entries aligned with the segments
+        order.resize (order.size () + segments, 0);
+    }
+
+    entries.push_back (entry);
+    return entries.size () - 1;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::CheckpointWriter 
+OpenSteer::PathDatasetWriter::checkpoint (void) const
+{
+    CheckpointWriter writer (datasetName, 0);
+    writer.addArray (entryTag, entries.empty () ? 0 : &entries[0], entries.size ());
+    writer.addArray (pointTag, points.empty () ? 0 : &points[0], points.size ());
+    writer.addArray (tangentTag, tangents.empty () ? 0 : &tangents[0], tangents.size ());
+    writer.addArray (lengthTag, lengths.empty () ? 0 : &lengths[0], lengths.size ());
+    writer.addArray (startDistanceTag,
+                     startDistances.empty () ? 0 : &startDistances[0],
+                     startDistances.size ());
+    writer.addArray (radiusTag, radii.empty () ? 0 : &radii[0], radii.size ());
+    writer.addArray (nodeTag, nodes.empty () ? 0 : &nodes[0], nodes.size ());
+    writer.addArray (orderTag, order.empty () ? 0 : &order[0], order.size ());
+    return writer;
+}
+
+
+std::vector<char> 
+OpenSteer::PathDatasetWriter::bytes (void) const
+{
+    return checkpoint ().bytes ();
+}
+
+
+bool 
+OpenSteer::PathDatasetWriter::writeFile (const char* fileName) const
+{
+    return checkpoint ().writeFile (fileName);
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::PathDatasetReader::PathDatasetReader (void)
+{
+    close ();
+}
+
+
+bool 
+OpenSteer::PathDatasetReader::open (const char* fileName)
+{
+    close ();
+    if (reader.open (fileName) && validDirectory ()) return true;
+    close ();
+    return false;
+}
+
+
+bool 
+OpenSteer::PathDatasetReader::openMemory (const void* data, const size_t size)
+{
+    close ();
+    if (reader.openMemory (data, size) && validDirectory ()) return true;
+    close ();
+    return false;
+}
+
+
+void 
+OpenSteer::PathDatasetReader::close (void)
+{
+    reader.close ();
+    entries = 0;
+    entryCount = 0;
+    points = 0;
+    pointTotal = 0;
+    tangents = 0;
+    tangentTotal = 0;
+    lengths = 0;
+    lengthTotal = 0;
+    startDistances = 0;
+    startDistanceTotal = 0;
+    radii = 0;
+    radiusTotal = 0;
+    nodes = 0;
+    nodeTotal = 0;
+    order = 0;
+    orderTotal = 0;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+bool 
+OpenSteer::PathDatasetReader::validDirectory (void)
+{
+    if (reader.plugInName () != datasetName) return false;
+
+    entries = reader.array<PathDatasetEntry> (entryTag, entryCount);
+    points = reader.array<Vec3> (pointTag, pointTotal);
+    tangents = reader.array<Vec3> (tangentTag, tangentTotal);
+    lengths = reader.array<float> (lengthTag, lengthTotal);
+    startDistances = reader.array<float> (startDistanceTag, startDistanceTotal);
+    radii = reader.array<float> (radiusTag, radiusTotal);
+    nodes = reader.array<SegmentedPathIndex::Node> (nodeTag, nodeTotal);
+    order = reader.array<unsigned int> (orderTag, orderTotal);
+    if (! entries || ! points || ! tangents || ! lengths || ! startDistances ||
+        ! radii || ! nodes || ! order)
+        return false;
+
+    // The records themselves are trusted like those of a checkpoint.
+    for (size_t i = 0; i < entryCount; i++)
+    {
+        const PathDatasetEntry& e = entries[i];
+        const uint64_t segments = (uint64_t) e.pointCount - 1;
+        if ((e.pointCount < 2) ||
+            ! inside (e.firstPoint, e.pointCount, pointTotal) ||
+            ! inside (e.firstPoint, e.pointCount, startDistanceTotal) ||
+            ! inside (e.firstSegment, segments, tangentTotal) ||
+            ! inside (e.firstSegment, segments, lengthTotal) ||
+            ! inside (e.firstSegment, segments, radiusTotal) ||
+            ! inside (e.firstSegment, segments, orderTotal) ||
+            ! inside (e.firstNode, e.nodeCount, nodeTotal))
+            return false;
+    }
+    return true;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+size_t 
+OpenSteer::PathDatasetReader::pointCount (const size_t i) const
+{
+    assert (i < entryCount && "Path index out of range.");
+    return entries[i].pointCount;
+}
+
+
+bool 
+OpenSteer::PathDatasetReader::isCyclic (const size_t i) const
+{
+    assert (i < entryCount && "Path index out of range.");
+    return entries[i].cyclic != 0;
+}
+
+
+bool 
+OpenSteer::PathDatasetReader::hasSingleRadius (const size_t i) const
+{
+    assert (i < entryCount && "Path index out of range.");
+    return entries[i].singleRadius != 0;
+}
+
+
+bool 
+OpenSteer::PathDatasetReader::hasSegmentIndex (const size_t i) const
+{
+    assert (i < entryCount && "Path index out of range.");
+    return entries[i].nodeCount != 0;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::PathDatasetReader::view (const size_t i,
+                                    PolylineSegmentedPath& path) const
+{
+    // The index accounts for the radii, which only loosens its bounds for
+    // the path itself.
+    path.setView (pathView (i), isCyclic (i), indexView (i));
+}
+
+
+bool 
+OpenSteer::PathDatasetReader::view (const size_t i,
+                                    PolylineSegmentedPathwaySingleRadius& pathway) const
+{
+    if (! hasSingleRadius (i)) return false;
+    pathway.setView (pathView (i),
+                     isCyclic (i),
+                     radii[entries[i].firstSegment],
+                     indexView (i));
+    return true;
+}
+
+
+void 
+OpenSteer::PathDatasetReader::view (const size_t i,
+                                    PolylineSegmentedPathwaySegmentRadii& pathway) const
+{
+    pathway.setView (pathView (i),
+                     isCyclic (i),
+                     radii + entries[i].firstSegment,
+                     indexView (i));
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::PolylineSegmentedPath::View 
+OpenSteer::PathDatasetReader::pathView (const size_t i) const
+{
+    assert (i < entryCount && "Path index out of range.");
+    const PathDatasetEntry& e = entries[i];
+    PolylineSegmentedPath::View v;
+    v.points = points + e.firstPoint;
+    v.segmentTangents = tangents + e.firstSegment;
+    v.segmentLengths = lengths + e.firstSegment;
+    v.segmentStartDistances = startDistances + e.firstPoint;
+    v.pointCount = e.pointCount;
+    return v;
+}
+
+
+OpenSteer::SegmentedPathIndex::View 
+OpenSteer::PathDatasetReader::indexView (const size_t i) const
+{
+    assert (i < entryCount && "Path index out of range.");
+    const PathDatasetEntry& e = entries[i];
+    SegmentedPathIndex::View v;
+    v.nodes = nodes + e.firstNode;
+    v.nodeCount = e.nodeCount;
+    v.order = order + e.firstSegment;
+    v.segmentCount = e.pointCount - 1;
+    v.slack = e.indexSlack;
+    return v;
+}
+
+
+// ----------------------------------------------------------------------------
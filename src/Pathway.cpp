@@ -27,11 +27,50 @@
  */
 #include "OpenSteer/Pathway.h"
 
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OPENSTEER_UNUSED_PARAMETER
+#include "OpenSteer/UnusedParameter.h"
+
 OpenSteer::Pathway::~Pathway()
 {
     // Nothing to do.
 }
 
+
+
+OpenSteer::Vec3 
+OpenSteer::Pathway::mapPointToPath (const Vec3& point,
+                                    Vec3& tangent,
+                                    float& outside,
+                                    PathCursor& cursor) const
+{
+    OPENSTEER_UNUSED_PARAMETER(cursor);
+    return mapPointToPath (point, tangent, outside);
+}
+
+
+
+OpenSteer::Vec3 
+OpenSteer::Pathway::mapPathDistanceToPoint (float pathDistance,
+                                            PathCursor& cursor) const
+{
+    OPENSTEER_UNUSED_PARAMETER(cursor);
+    return mapPathDistanceToPoint (pathDistance);
+}
+
+
+
+float 
+OpenSteer::Pathway::mapPointToPathDistance (const Vec3& point,
+                                            PathCursor& cursor) const
+{
+    OPENSTEER_UNUSED_PARAMETER(cursor);
+    return mapPointToPathDistance (point);
+}
+
+
 /*
 OpenSteer::Pathway& OpenSteer::Pathway::operator=( Pathway const& )
 {
@@ -0,0 +1,151 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// PhaseTimer
+//
+// Nested, exclusive per-phase timers.  See PhaseTimer.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/PhaseTimer.h"
+
+#include <chrono>
+
+
+namespace {
+
+    typedef std::chrono::steady_clock timerClock;
+
+    // maximum nesting depth, deeper Scopes are not timed
+    const int phaseStackSize = 16;
+
+    // each thread keeps its own phase stack and totals
+
+    thread_local OpenSteer::PhaseTimer::Phase phaseStack [phaseStackSize];
+    thread_local int phaseStackIndex = 0;
+    thread_local int phaseStackOverflow = 0;
+
+    // time of the most recent push or pop
+    thread_local timerClock::time_point phaseBase;
+
+    thread_local double phaseTotals [OpenSteer::PhaseTimer::phaseCount];
+
+
+    // charge time since the last push or pop to the current (innermost)
+    // phase, if any, and restart the timer
+    void chargeCurrentPhase (void)
+    {
+        const timerClock::time_point now = timerClock::now ();
+        if (phaseStackIndex > 0)
+        {
+            const std::chrono::duration<double> elapsed = now - phaseBase;
+            phaseTotals[phaseStack[phaseStackIndex-1]] += elapsed.count ();
+        }
+        phaseBase = now;
+    }
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+// master on/off switch
+
+
+bool OpenSteer::PhaseTimer::enabled = false;
+
+
+// ----------------------------------------------------------------------------
+
+
+double 
+OpenSteer::PhaseTimer::total (const Phase phase)
+{
+    return phaseTotals[phase];
+}
+
+
+void 
+OpenSteer::PhaseTimer::reset (void)
+{
+    for (int i = 0; i < phaseCount; i++) phaseTotals[i] = 0;
+}
+
+
+const char* 
+OpenSteer::PhaseTimer::name (const Phase phase)
+{
+    switch (phase)
+    {
+    case otherUpdatePhase:        return "other";
+    case neighborQueryPhase:      return "neighbor_query";
+    case steeringPhase:           return "steering";
+    case applySteeringForcePhase: return "apply_steering_force";
+    case proximityUpdatePhase:    return "proximity_update";
+    default:                      return "unknown";
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// enter and leave a phase
+
+
+void 
+OpenSteer::PhaseTimer::push (const Phase phase)
+{
+    if (phaseStackIndex < phaseStackSize)
+    {
+        chargeCurrentPhase ();
+        phaseStack[phaseStackIndex++] = phase;
+    }
+    else
+    {
+        phaseStackOverflow++;
+    }
+}
+
+
+void 
+OpenSteer::PhaseTimer::pop (void)
+{
+    if (phaseStackOverflow > 0)
+    {
+        phaseStackOverflow--;
+    }
+    else if (phaseStackIndex > 0)
+    {
+        chargeCurrentPhase ();
+        phaseStackIndex--;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
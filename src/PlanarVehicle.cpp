@@ -0,0 +1,112 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// PlanarVehicle
+//
+// A SimpleVehicle confined to the XZ plane.  See PlanarVehicle.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/PlanarVehicle.h"
+
+
+// ----------------------------------------------------------------------------
+
+
+float 
+OpenSteer::PlanarVehicle::heading (void) const
+{
+    return atan2 (forward().x, forward().z);
+}
+
+
+void 
+OpenSteer::PlanarVehicle::setHeading (const float angle)
+{
+    setPlanarBasis (sinXXX (angle), cosXXX (angle));
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::PlanarVehicle::regenerateOrthonormalBasisUF (const Vec3& newForward)
+{
+    const float length = mathSqrt ((newForward.x * newForward.x) +
+                                   (newForward.z * newForward.z));
+    if (length > 0) setPlanarBasis (newForward.x / length,
+                                    newForward.z / length);
+}
+
+
+// ----------------------------------------------------------------------------
+// the velocity is on the plane (its force was), so its X and Z over the
+// speed are already a unit heading
+//
+// parameter names commented out to prevent compiler warning from "-W"
+
+
+void 
+OpenSteer::PlanarVehicle::regenerateLocalSpace (const Vec3& newVelocity,
+                                                const float /* elapsedTime */)
+{
+    if (speed() > 0) setPlanarBasis (newVelocity.x / speed(),
+                                     newVelocity.z / speed());
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::Vec3 
+OpenSteer::PlanarVehicle::adjustRawSteeringForce (const Vec3& force,
+                                                  const float deltaTime)
+{
+    return SimpleVehicle::adjustRawSteeringForce (force.setYtoZero (),
+                                                  deltaTime);
+}
+
+
+// ----------------------------------------------------------------------------
+// side is forward turned a quarter turn about up (the cross product of
+// forward and up, or of up and forward when left handed)
+
+
+void 
+OpenSteer::PlanarVehicle::setPlanarBasis (const float x, const float z)
+{
+    const Vec3 newForward (x, 0, z);
+    setUp (Vec3::up);
+    setSide (localRotateForwardToSide (newForward));
+    setForward (newForward);
+}
+
+
+// ----------------------------------------------------------------------------
@@ -55,13 +55,16 @@ OpenSteer::PlugIn* OpenSteer::PlugIn::registry [totalSizeOfRegistry];
 // constructor
 
 
-OpenSteer::PlugIn::PlugIn (void)
+OpenSteer::PlugIn::PlugIn (void) : registered (true)
 {
     // save this new instance in the registry
     addToRegistry ();
 }
 
 
+OpenSteer::PlugIn::PlugIn (WorldInstanceTag) : registered (false) {}
+
+
 // ----------------------------------------------------------------------------
 // destructor
 
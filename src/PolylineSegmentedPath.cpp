@@ -27,10 +27,7 @@
  */
 #include "OpenSteer/PolylineSegmentedPath.h"
 
-// Include std::accumulate
-#include <numeric>
-
-// Include std::swap, std::adjacent_find
+// Include std::swap, std::adjacent_find, std::lower_bound
 #include <algorithm>
 
 // Include assert
@@ -58,8 +55,8 @@
 namespace {
     
     typedef OpenSteer::SegmentedPath::size_type size_type;
-    typedef std::vector< OpenSteer::Vec3 > Vec3Container;
-    typedef std::vector< float > FloatContainer;
+    typedef OpenSteer::AccountedVector< OpenSteer::Vec3, OpenSteer::MemoryAccount::pathMemory >::type Vec3Container;
+    typedef OpenSteer::AccountedVector< float, OpenSteer::MemoryAccount::pathMemory >::type FloatContainer;
     
     /**
      * Recalculates the segment tangent and length for segment @a segmentIndex.
@@ -100,18 +97,21 @@ namespace {
      *                        tangents. Must have the right size.
      * @param segmentLengths container to store the calculated segment lengths.
      *                       Must have the right size.
-     * @param firstChangedPointIndex the first point that changed. Segments have 
+     * @param firstPointIndex the first point of the path, the points before
+     *        it have been removed.
+     * @param firstChangedPointIndex the first point that changed. Segments have
      *        to be updated starting with it.
-     * @param numOfPoints number of points that changed beginning with 
+     * @param numOfPoints number of points that changed beginning with
      *        @a startIndex.
      * @param isCyclic Is the path cyclic or not.
      *
      */
-    void 
-    updateTangentsAndLengths( Vec3Container const& points , 
-                              Vec3Container& segmentTangents, 
-                              FloatContainer& segmentLengths, 
-                              size_type firstChangedPointIndex, 
+    void
+    updateTangentsAndLengths( Vec3Container const& points ,
+                              Vec3Container& segmentTangents,
+                              FloatContainer& segmentLengths,
+                              size_type firstPointIndex,
+                              size_type firstChangedPointIndex,
                               size_type numOfPoints,
                               bool isCyclic )
     {
@@ -128,7 +128,7 @@ namespace {
         // The segment with end point @a firstChangedPointIndex has also 
         // changed. Beware from range underflow by subtraction.      
         size_type firstSegmentIndex = firstChangedPointIndex;
-        if ( 0 < firstSegmentIndex ) {
+        if ( firstPointIndex < firstSegmentIndex ) {
             firstSegmentIndex -= 1;
         }
         
@@ -147,7 +147,7 @@ namespace {
         // If path is cyclic and the first point changed and the cycle closing
         // segment hasn't been updated update it now.
         if ( isCyclic && 
-             ( 0 == firstSegmentIndex ) && 
+             ( firstPointIndex == firstSegmentIndex ) &&
              ! ( lastSegmentIndex == segmentTangents.size() ) ) {
             
             updateSegmentTangentAndLength( segmentTangents.size() - 1, 
@@ -159,6 +159,29 @@ namespace {
     }
     
     
+    /**
+     * Recalculates the distances from the path start to the segment starts 
+     * beginning with segment @a firstSegmentIndex, and the path length 
+     * stored behind them. Sums the lengths in order, like 
+     * @c PointToPathAlikeMapping does, so both agree exactly.
+     *
+     * @attention @a segmentStartDistances must have one element more than
+     *            @a segmentLengths.
+     */
+    void
+    updateSegmentStartDistances( FloatContainer const& segmentLengths,
+                                 FloatContainer& segmentStartDistances,
+                                 size_type firstSegmentIndex )
+    {
+        assert( segmentStartDistances.size() == segmentLengths.size() + 1 && 
+                "There must be one start distance per segment and the path length." );
+        
+        for ( size_type i = firstSegmentIndex; i < segmentLengths.size(); ++i ) {
+            segmentStartDistances[ i + 1 ] = segmentStartDistances[ i ] + segmentLengths[ i ];
+        }
+    }
+    
+    
     /**
      * Checks that no adjacent points are equal. Checks the first and last
      * point if the path is cyclic, too.
@@ -193,25 +216,29 @@ namespace {
 
 
 OpenSteer::PolylineSegmentedPath::PolylineSegmentedPath()
-    : points_( 0 ), segmentTangents_( 0 ), segmentLengths_( 0 ), closedCycle_( false )
+    : points_( 0 ), segmentTangents_( 0 ), segmentLengths_( 0 ), segmentStartDistances_( 0 ), closedCycle_( false ), segmentIndex_(), segmentIndexEnabled_( false ), view_(), isView_( false ), firstPoint_( 0 ), originDistance_( 0.0f )
 {
-    
+    updateView();
 }
 
 
 OpenSteer::PolylineSegmentedPath::PolylineSegmentedPath( size_type numOfPoints,
                                                          Vec3 const newPoints[],
                                                          bool closedCycle )
-    : points_( 0 ), segmentTangents_( 0 ), segmentLengths_( 0 ), closedCycle_( closedCycle )
+    : points_( 0 ), segmentTangents_( 0 ), segmentLengths_( 0 ), segmentStartDistances_( 0 ), closedCycle_( closedCycle ), segmentIndex_(), segmentIndexEnabled_( false ), view_(), isView_( false ), firstPoint_( 0 ), originDistance_( 0.0f )
 {
         setPath( numOfPoints, newPoints, closedCycle );
 }
 
 
 OpenSteer::PolylineSegmentedPath::PolylineSegmentedPath( PolylineSegmentedPath const& other )
-    : SegmentedPath( other ), points_( other.points_ ), segmentTangents_( other.segmentTangents_ ), segmentLengths_( other.segmentLengths_ ), closedCycle_( other.closedCycle_ )
+    : SegmentedPath( other ), points_( other.points_ ), segmentTangents_( other.segmentTangents_ ), segmentLengths_( other.segmentLengths_ ), segmentStartDistances_( other.segmentStartDistances_ ), closedCycle_( other.closedCycle_ ), segmentIndex_( other.segmentIndex_ ), segmentIndexEnabled_( other.segmentIndexEnabled_ ), view_( other.view_ ), isView_( other.isView_ ), firstPoint_( other.firstPoint_ ), originDistance_( other.originDistance_ )
 {
-    // Nothing to do.
+    // A copy of a view shares the arrays, a copy of own storage uses its 
+    // own copy.
+    if ( ! isView_ ) {
+        updateView();
+    }
 }
 
 
@@ -238,7 +265,16 @@ OpenSteer::PolylineSegmentedPath::swap( PolylineSegmentedPath& other )
     points_.swap( other.points_ );
     segmentTangents_.swap( other.segmentTangents_ );
     segmentLengths_.swap( other.segmentLengths_ );
+    segmentStartDistances_.swap( other.segmentStartDistances_ );
     std::swap( closedCycle_, other.closedCycle_ );
+    segmentIndex_.swap( other.segmentIndex_ );
+    std::swap( segmentIndexEnabled_, other.segmentIndexEnabled_ );
+    
+    // Swapping containers keeps their storage, so the views stay valid.
+    std::swap( view_, other.view_ );
+    std::swap( isView_, other.isView_ );
+    std::swap( firstPoint_, other.firstPoint_ );
+    std::swap( originDistance_, other.originDistance_ );
 }
 
 
@@ -265,6 +301,7 @@ OpenSteer::PolylineSegmentedPath::setPath( size_type numOfPoints,
     points_.reserve( numberOfPoints );
     segmentTangents_.resize( numberOfPoints - 1 );
     segmentLengths_.resize( numberOfPoints - 1 );
+    segmentStartDistances_.assign( numberOfPoints, 0.0f );
     
     points_.assign( newPoints, newPoints + numOfPoints );
     
@@ -274,14 +311,26 @@ OpenSteer::PolylineSegmentedPath::setPath( size_type numOfPoints,
     
     updateTangentsAndLengths( points_ , 
                               segmentTangents_, 
-                              segmentLengths_, 
-                              0, 
+                              segmentLengths_,
+                              0,
+                              0,
                               numOfPoints,
                               closedCycle_ );
+    updateSegmentStartDistances( segmentLengths_, segmentStartDistances_, 0 );
     
     shrinkToFit( points_ );
     shrinkToFit( segmentTangents_ );
     shrinkToFit( segmentLengths_ );
+    shrinkToFit( segmentStartDistances_ );
+    
+    isView_ = false;
+    firstPoint_ = 0;
+    originDistance_ = 0.0f;
+    updateView();
+    
+    if ( segmentIndexEnabled_ ) {
+        segmentIndex_.build( *this );
+    }
 }
 
 
@@ -295,11 +344,12 @@ OpenSteer::PolylineSegmentedPath::movePoints( size_type startIndex,
             "startIndex must be inside index range." );
     assert( ( ( startIndex + numOfPoints ) <= ( pointCount() - ( isCyclic() ? 1 : 0 ) ) ) && 
             "The max. index of a point to set must be inside the index range." ); 
+    assert( ! isView_ && "A view can't be changed." );
     
     // Update the point positions.
     // @todo Remove this line size_type const pathPointCount = pointCount();
     for ( size_type i = 0; i < numOfPoints; ++i ) {
-        points_[ startIndex + i ] = newPoints[ i ];
+        points_[ firstPoint_ + startIndex + i ] = newPoints[ i ];
     }
     
     // If the first point is changed and the path is cyclic also change the
@@ -312,12 +362,242 @@ OpenSteer::PolylineSegmentedPath::movePoints( size_type startIndex,
     updateTangentsAndLengths( points_, 
                               segmentTangents_, 
                               segmentLengths_, 
-                              startIndex, 
+                              firstPoint_,
+                              firstPoint_ + startIndex, 
                               numOfPoints, 
                               isCyclic() );
     
+    // Start distances change from the segment ending at the first moved 
+    // point on.
+    updateSegmentStartDistances( segmentLengths_, 
+                                 segmentStartDistances_, 
+                                 firstPoint_ + ( ( 0 < startIndex ) ? ( startIndex - 1 ) : 0 ) );
+    
+    segmentIndex_.pointsMoved( *this, startIndex, numOfPoints );
     
-    assert( adjacentPathPointsDifferent( points_.begin(), points_.end(), isCyclic() ) && "Adjacent path points must be different." );
+    assert( adjacentPathPointsDifferent( points_.begin() + firstPoint_, points_.end(), isCyclic() ) && "Adjacent path points must be different." );
+}
+
+
+
+void 
+OpenSteer::PolylineSegmentedPath::appendPoints( size_type numOfPoints,
+                                                Vec3 const newPoints[] )
+{
+    assert( isValid() && "Points can only be appended to a valid path." );
+    assert( ! isCyclic() && "Points can't be appended to a cyclic path." );
+    assert( ! isView_ && "A view can't be changed." );
+    
+    for ( size_type i = 0; i < numOfPoints; ++i ) {
+        points_.push_back( newPoints[ i ] );
+        segmentTangents_.push_back( Vec3() );
+        segmentLengths_.push_back( 0.0f );
+        segmentStartDistances_.push_back( 0.0f );
+        
+        size_type const segmentIndex = segmentTangents_.size() - 1;
+        updateSegmentTangentAndLength( segmentIndex, points_, segmentTangents_, segmentLengths_ );
+        segmentStartDistances_[ segmentIndex + 1 ] = segmentStartDistances_[ segmentIndex ] + segmentLengths_[ segmentIndex ];
+    }
+    
+    updateView();
+    segmentIndex_.segmentsInserted( *this, numOfPoints, false, 0.0f );
+}
+
+
+
+void 
+OpenSteer::PolylineSegmentedPath::prependPoints( size_type numOfPoints,
+                                                 Vec3 const newPoints[] )
+{
+    assert( isValid() && "Points can only be prepended to a valid path." );
+    assert( ! isCyclic() && "Points can't be prepended to a cyclic path." );
+    assert( ! isView_ && "A view can't be changed." );
+    
+    if ( firstPoint_ < numOfPoints ) {
+        makeRoomAtFront( numOfPoints );
+    }
+    
+    size_type const oldFirstPoint = firstPoint_;
+    firstPoint_ -= numOfPoints;
+    std::copy( newPoints, newPoints + numOfPoints, points_.begin() + firstPoint_ );
+    
+    // Walk backwards from the old start, the start distances decrease and 
+    // may become negative.
+    for ( size_type segmentIndex = oldFirstPoint; firstPoint_ < segmentIndex; --segmentIndex ) {
+        updateSegmentTangentAndLength( segmentIndex - 1, points_, segmentTangents_, segmentLengths_ );
+        segmentStartDistances_[ segmentIndex - 1 ] = segmentStartDistances_[ segmentIndex ] - segmentLengths_[ segmentIndex - 1 ];
+    }
+    
+    updateView();
+    segmentIndex_.segmentsInserted( *this, numOfPoints, true, 0.0f );
+}
+
+
+
+void 
+OpenSteer::PolylineSegmentedPath::removeFirstPoints( size_type numOfPoints )
+{
+    assert( numOfPoints + 2 <= pointCount() && "A path keeps at least two points." );
+    assert( ! isCyclic() && "Points can't be removed from a cyclic path." );
+    assert( ! isView_ && "A view can't be changed." );
+    
+    firstPoint_ += numOfPoints;
+    
+    // Drop the removed points once they outnumber the remaining ones and 
+    // rebase the stored start distances to keep their precision.
+    if ( firstPoint_ > ( points_.size() - firstPoint_ ) ) {
+        float const base = segmentStartDistances_[ firstPoint_ ];
+        points_.erase( points_.begin(), points_.begin() + firstPoint_ );
+        segmentTangents_.erase( segmentTangents_.begin(), segmentTangents_.begin() + firstPoint_ );
+        segmentLengths_.erase( segmentLengths_.begin(), segmentLengths_.begin() + firstPoint_ );
+        segmentStartDistances_.erase( segmentStartDistances_.begin(), segmentStartDistances_.begin() + firstPoint_ );
+        for ( size_type i = 0; i < segmentStartDistances_.size(); ++i ) {
+            segmentStartDistances_[ i ] -= base;
+        }
+        originDistance_ += base;
+        firstPoint_ = 0;
+    }
+    
+    updateView();
+    segmentIndex_.segmentsRemoved( *this, numOfPoints, true );
+}
+
+
+
+void 
+OpenSteer::PolylineSegmentedPath::removeLastPoints( size_type numOfPoints )
+{
+    assert( numOfPoints + 2 <= pointCount() && "A path keeps at least two points." );
+    assert( ! isCyclic() && "Points can't be removed from a cyclic path." );
+    assert( ! isView_ && "A view can't be changed." );
+    
+    points_.resize( points_.size() - numOfPoints );
+    segmentTangents_.resize( segmentTangents_.size() - numOfPoints );
+    segmentLengths_.resize( segmentLengths_.size() - numOfPoints );
+    segmentStartDistances_.resize( segmentStartDistances_.size() - numOfPoints );
+    
+    updateView();
+    segmentIndex_.segmentsRemoved( *this, numOfPoints, false );
+}
+
+
+
+float 
+OpenSteer::PolylineSegmentedPath::startDistance() const
+{
+    return ( 0 == view_.pointCount ) ? 0.0f : ( originDistance_ + view_.segmentStartDistances[ 0 ] );
+}
+
+
+void 
+OpenSteer::PolylineSegmentedPath::setSegmentIndexEnabled( bool enabled )
+{
+    segmentIndexEnabled_ = enabled;
+    if ( segmentIndexEnabled_ && isValid() ) {
+        segmentIndex_.build( *this );
+    } else {
+        segmentIndex_.clear();
+    }
+}
+
+
+
+bool 
+OpenSteer::PolylineSegmentedPath::segmentIndexEnabled() const
+{
+    return segmentIndexEnabled_;
+}
+
+
+
+OpenSteer::SegmentedPathIndex const& 
+OpenSteer::PolylineSegmentedPath::segmentIndex() const
+{
+    return segmentIndex_;
+}
+
+
+
+OpenSteer::PolylineSegmentedPath::View 
+OpenSteer::PolylineSegmentedPath::view() const
+{
+    return view_;
+}
+
+
+
+void 
+OpenSteer::PolylineSegmentedPath::setView( View const& view, 
+                                           bool closedCycle, 
+                                           SegmentedPathIndex::View const& index )
+{
+    assert( 1 < view.pointCount && "Path must have at least two distinct points." );
+    assert( ( ( 0 == index.nodeCount ) || ( index.segmentCount + 1 == view.pointCount ) ) && "The index must cover the segments of the path." );
+    
+    // Release the own storage.
+    Vec3Container().swap( points_ );
+    Vec3Container().swap( segmentTangents_ );
+    FloatContainer().swap( segmentLengths_ );
+    FloatContainer().swap( segmentStartDistances_ );
+    
+    closedCycle_ = closedCycle;
+    view_ = view;
+    isView_ = true;
+    firstPoint_ = 0;
+    originDistance_ = 0.0f;
+    
+    segmentIndexEnabled_ = 0 < index.nodeCount;
+    if ( segmentIndexEnabled_ ) {
+        segmentIndex_.setView( index );
+    } else {
+        segmentIndex_.clear();
+    }
+}
+
+
+
+bool 
+OpenSteer::PolylineSegmentedPath::isView() const
+{
+    return isView_;
+}
+
+
+
+void 
+OpenSteer::PolylineSegmentedPath::updateView()
+{
+    view_.points = points_.empty() ? 0 : &points_[ firstPoint_ ];
+    view_.segmentTangents = segmentTangents_.empty() ? 0 : &segmentTangents_[ firstPoint_ ];
+    view_.segmentLengths = segmentLengths_.empty() ? 0 : &segmentLengths_[ firstPoint_ ];
+    view_.segmentStartDistances = segmentStartDistances_.empty() ? 0 : &segmentStartDistances_[ firstPoint_ ];
+    view_.pointCount = points_.size() - firstPoint_;
+}
+
+
+
+void 
+OpenSteer::PolylineSegmentedPath::makeRoomAtFront( size_type numOfPoints )
+{
+    // Leave room for at least as many points as the path has so prepending
+    // point by point only copies the path now and then.
+    size_type const livePoints = points_.size() - firstPoint_;
+    size_type const room = std::max( numOfPoints, livePoints );
+    
+    Vec3Container points( room + livePoints );
+    Vec3Container segmentTangents( room + livePoints - 1 );
+    FloatContainer segmentLengths( room + livePoints - 1 );
+    FloatContainer segmentStartDistances( room + livePoints, 0.0f );
+    std::copy( points_.begin() + firstPoint_, points_.end(), points.begin() + room );
+    std::copy( segmentTangents_.begin() + firstPoint_, segmentTangents_.end(), segmentTangents.begin() + room );
+    std::copy( segmentLengths_.begin() + firstPoint_, segmentLengths_.end(), segmentLengths.begin() + room );
+    std::copy( segmentStartDistances_.begin() + firstPoint_, segmentStartDistances_.end(), segmentStartDistances.begin() + room );
+    
+    points_.swap( points );
+    segmentTangents_.swap( segmentTangents );
+    segmentLengths_.swap( segmentLengths );
+    segmentStartDistances_.swap( segmentStartDistances );
+    firstPoint_ = room;
 }
 
 
@@ -335,7 +615,7 @@ OpenSteer::PolylineSegmentedPath::mapPointToPath (const Vec3& point,
                                                   float& outside) const
 {
     PointToPathMapping mapping;
-    mapPointToPathAlike( *this, point, mapping );
+    mapPointToPathAlike( *this, segmentIndex_, point, mapping );
     tangent = mapping.tangent;
     outside = mapping.distancePointToPath;
     return mapping.pointOnPathCenterLine;
@@ -344,19 +624,55 @@ OpenSteer::PolylineSegmentedPath::mapPointToPath (const Vec3& point,
 
 OpenSteer::Vec3 
 OpenSteer::PolylineSegmentedPath::mapPathDistanceToPoint (float pathDistance) const
+{
+    PathCursor cursor;
+    return mapPathDistanceToPoint( pathDistance, cursor );
+}
+
+
+float 
+OpenSteer::PolylineSegmentedPath::mapPointToPathDistance (const Vec3& point) const
+{
+    PointToPathDistanceMapping mapping;
+    mapPointToPathAlike( *this, segmentIndex_, point, mapping );
+    return startDistance() + mapping.distanceOnPath;
+}
+
+
+
+OpenSteer::Vec3 
+OpenSteer::PolylineSegmentedPath::mapPointToPath (const Vec3& point,
+                                                  Vec3& tangent,
+                                                  float& outside,
+                                                  PathCursor& cursor) const
+{
+    PointToPathMapping mapping;
+    mapPointToPathAlike( *this, segmentIndex_, point, mapping, cursor );
+    tangent = mapping.tangent;
+    outside = mapping.distancePointToPath;
+    return mapping.pointOnPathCenterLine;
+}
+
+
+
+OpenSteer::Vec3 
+OpenSteer::PolylineSegmentedPath::mapPathDistanceToPoint (float pathDistance,
+                                                          PathCursor& cursor) const
 {
     PathDistanceToPointMapping mapping;
-    mapDistanceToPathAlike( *this, pathDistance, mapping );
+    mapDistanceToPathAlike( *this, pathDistance - startDistance(), mapping, cursor );
     return mapping.pointOnPathCenterLine;
 }
 
 
+
 float 
-OpenSteer::PolylineSegmentedPath::mapPointToPathDistance (const Vec3& point) const
+OpenSteer::PolylineSegmentedPath::mapPointToPathDistance (const Vec3& point,
+                                                          PathCursor& cursor) const
 {
     PointToPathDistanceMapping mapping;
-    mapPointToPathAlike( *this, point, mapping );
-    return mapping.distanceOnPath;
+    mapPointToPathAlike( *this, segmentIndex_, point, mapping, cursor );
+    return startDistance() + mapping.distanceOnPath;
 }
 
 
@@ -370,14 +686,14 @@ OpenSteer::PolylineSegmentedPath::isCyclic() const
 float 
 OpenSteer::PolylineSegmentedPath::length() const
 {
-    return std::accumulate( segmentLengths_.begin(), segmentLengths_.end(), 0.0f );
+    return ( 0 == view_.pointCount ) ? 0.0f : ( view_.segmentStartDistances[ view_.pointCount - 1 ] - view_.segmentStartDistances[ 0 ] );
 }
 
 
 OpenSteer::SegmentedPath::size_type 
 OpenSteer::PolylineSegmentedPath::pointCount() const
 {
-    return points_.size();
+    return view_.pointCount;
 }
 
 
@@ -386,7 +702,7 @@ OpenSteer::Vec3
 OpenSteer::PolylineSegmentedPath::point( size_type pointIndex ) const
 {
     assert( pointIndex < pointCount() && "pointIndex out of range." );
-    return points_[ pointIndex ];
+    return view_.points[ pointIndex ];
 }
 
 
@@ -395,7 +711,7 @@ OpenSteer::PolylineSegmentedPath::point( size_type pointIndex ) const
 OpenSteer::PolylineSegmentedPath::size_type 
 OpenSteer::PolylineSegmentedPath::segmentCount() const
 {
-    return segmentTangents_.size();
+    return ( 0 == view_.pointCount ) ? 0 : ( view_.pointCount - 1 );
 }
 
 
@@ -403,7 +719,7 @@ float
 OpenSteer::PolylineSegmentedPath::segmentLength( size_type segmentIndex ) const
 {
     assert( segmentIndex < segmentCount() && "segmentIndex out of range." );
-    return segmentLengths_[ segmentIndex ];
+    return view_.segmentLengths[ segmentIndex ];
 }
 
 
@@ -412,7 +728,7 @@ OpenSteer::PolylineSegmentedPath::segmentStart( size_type segmentIndex ) const
 {
     assert( segmentIndex < segmentCount() && "segmentIndex out of range." );
     assert( segmentIndex < pointCount() && "The max. index of a point must be inside range." );
-    return points_[ segmentIndex ];
+    return view_.points[ segmentIndex ];
 }
 
 
@@ -422,7 +738,7 @@ OpenSteer::PolylineSegmentedPath::segmentEnd( size_type segmentIndex ) const
     assert( segmentIndex < segmentCount() && "segmentIndex out of range." );
     assert( segmentIndex + 1< pointCount() && "The max. index of a point must be inside range." );
 
-    return points_[ segmentIndex + 1 ];
+    return view_.points[ segmentIndex + 1 ];
 }
 
 
@@ -432,10 +748,10 @@ OpenSteer::PolylineSegmentedPath::mapPointToSegmentDistance( size_type segmentIn
 {
     assert( segmentIndex < segmentCount() && "segmentIndex is out of range." );
     
-    Vec3 const segmentStartToPoint( point - points_[ segmentIndex ] );
-    float const distance = segmentStartToPoint.dot( segmentTangents_[ segmentIndex ] );
+    Vec3 const segmentStartToPoint( point - view_.points[ segmentIndex ] );
+    float const distance = segmentStartToPoint.dot( view_.segmentTangents[ segmentIndex ] );
     
-    return clamp( distance, 0.0f, segmentLengths_[ segmentIndex ] );
+    return clamp( distance, 0.0f, view_.segmentLengths[ segmentIndex ] );
 }
 
 
@@ -445,7 +761,7 @@ OpenSteer::PolylineSegmentedPath::mapSegmentDistanceToPoint( size_type segmentIn
 {
     assert( segmentIndex < segmentCount() && "segmentIndex is out of range." );
     
-    float const segmentLength = segmentLengths_[ segmentIndex ];
+    float const segmentLength = view_.segmentLengths[ segmentIndex ];
     /*
      * bk: remove behavior that treats negative numbers as distances beginning 
      * from the end of the segment
@@ -455,7 +771,7 @@ OpenSteer::PolylineSegmentedPath::mapSegmentDistanceToPoint( size_type segmentIn
     */
     segmentDistance = clamp( segmentDistance, 0.0f, segmentLength );
     
-    return segmentTangents_[ segmentIndex ] * segmentDistance + points_[ segmentIndex ];
+    return view_.segmentTangents[ segmentIndex ] * segmentDistance + view_.points[ segmentIndex ];
 }
 
 
@@ -464,7 +780,7 @@ OpenSteer::PolylineSegmentedPath::mapSegmentDistanceToTangent( size_type segment
                                                                float ) const
 {
     assert( segmentIndex < segmentCount() && "segmentIndex is out of range." );
-    return segmentTangents_[ segmentIndex ];
+    return view_.segmentTangents[ segmentIndex ];
 }
 
 
@@ -476,7 +792,7 @@ OpenSteer::PolylineSegmentedPath::mapDistanceToSegmentPointAndTangent( size_type
 {
     assert( segmentIndex < segmentCount() && "segmentIndex is out of range." );
     
-    float const segmentLength = segmentLengths_[ segmentIndex ];
+    float const segmentLength = view_.segmentLengths[ segmentIndex ];
     
     /* 
      * bk: remove behavior that treats negative numbers as distances beginning 
@@ -487,8 +803,8 @@ OpenSteer::PolylineSegmentedPath::mapDistanceToSegmentPointAndTangent( size_type
     */
     segmentDistance = clamp( segmentDistance, 0.0f, segmentLength );
     
-    pointOnPath = segmentTangents_[ segmentIndex ] * segmentDistance + points_[ segmentIndex ];
-    tangent = segmentTangents_[ segmentIndex ];
+    pointOnPath = view_.segmentTangents[ segmentIndex ] * segmentDistance + view_.points[ segmentIndex ];
+    tangent = view_.segmentTangents[ segmentIndex ];
 }
 
 
@@ -501,14 +817,48 @@ OpenSteer::PolylineSegmentedPath::mapPointToSegmentDistanceAndPointAndTangent( s
 {
     assert( segmentIndex < segmentCount() && "segmentIndex is out of range." );
     
-    Vec3 const segmentStartPoint = points_[ segmentIndex ];
+    Vec3 const segmentStartPoint = view_.points[ segmentIndex ];
     Vec3 const segmentStartToPoint( point - segmentStartPoint );
-    tangent = segmentTangents_[ segmentIndex ];
+    tangent = view_.segmentTangents[ segmentIndex ];
     distance = segmentStartToPoint.dot( tangent );
-    distance =  clamp( distance, 0.0f, segmentLengths_[ segmentIndex ] );
+    distance =  clamp( distance, 0.0f, view_.segmentLengths[ segmentIndex ] );
     pointOnPath = tangent * distance + segmentStartPoint;
 }
 
 
 
+float 
+OpenSteer::PolylineSegmentedPath::segmentStartDistance( size_type segmentIndex ) const
+{
+    assert( segmentIndex < segmentCount() && "segmentIndex out of range." );
+    return view_.segmentStartDistances[ segmentIndex ] - view_.segmentStartDistances[ 0 ];
+}
+
+
 
+OpenSteer::PolylineSegmentedPath::size_type 
+OpenSteer::PolylineSegmentedPath::segmentIndexAtDistance( float distance, size_type hint ) const
+{
+    assert( 0 < segmentCount() && "The path has no segments." );
+    
+    size_type const lastSegmentIndex = segmentCount() - 1;
+    
+    // The stored start distances only begin at zero until the path slides.
+    distance += view_.segmentStartDistances[ 0 ];
+    
+    if ( lastSegmentIndex < hint ) {
+        // Only the ends of all but the last segment need to be searched, the
+        // last segment also takes distances beyond the path end.
+        float const* const firstEnd = view_.segmentStartDistances + 1;
+        return std::lower_bound( firstEnd, firstEnd + lastSegmentIndex, distance ) - firstEnd;
+    }
+    
+    size_type segmentIndex = hint;
+    while ( ( 0 < segmentIndex ) && ( distance <= view_.segmentStartDistances[ segmentIndex ] ) ) {
+        --segmentIndex;
+    }
+    while ( ( segmentIndex < lastSegmentIndex ) && ( distance > view_.segmentStartDistances[ segmentIndex + 1 ] ) ) {
+        ++segmentIndex;
+    }
+    return segmentIndex;
+}
@@ -82,7 +82,7 @@ namespace {
      * Returns @c true if all radii are greater or equal to @c 0, @c false
      * otherwise.
      */
-    bool allRadiiNonNegative( std::vector< float > const& radii ) {
+    bool allRadiiNonNegative( OpenSteer::AccountedVector< float, OpenSteer::MemoryAccount::pathMemory >::type const& radii ) {
         return allRadiiNonNegative( radii.begin(), radii.end() );
     }
     
@@ -95,7 +95,7 @@ namespace {
 
 
 OpenSteer::PolylineSegmentedPathwaySegmentRadii::PolylineSegmentedPathwaySegmentRadii()
-    : path_(), segmentRadii_( 0 )
+    : path_(), segmentRadii_( 0 ), radii_( 0 ), segmentIndex_(), segmentIndexEnabled_( false )
 {
     
 }
@@ -107,7 +107,7 @@ OpenSteer::PolylineSegmentedPathwaySegmentRadii::PolylineSegmentedPathwaySegment
                                                                                        Vec3 const points[],
                                                                                        float const radii[],
                                                                                        bool closedCycle )
-    : path_( numOfPoints, points, closedCycle ), segmentRadii_( radii, radii + radiiCount( numOfPoints, closedCycle ) )
+    : path_( numOfPoints, points, closedCycle ), segmentRadii_( radii, radii + radiiCount( numOfPoints, closedCycle ) ), radii_( &segmentRadii_[ 0 ] ), segmentIndex_(), segmentIndexEnabled_( false )
 {
     assert( allRadiiNonNegative( segmentRadii_ ) && "All radii must be positive or zero." );
 }
@@ -116,9 +116,15 @@ OpenSteer::PolylineSegmentedPathwaySegmentRadii::PolylineSegmentedPathwaySegment
 
 
 OpenSteer::PolylineSegmentedPathwaySegmentRadii::PolylineSegmentedPathwaySegmentRadii( PolylineSegmentedPathwaySegmentRadii const& other )
-    : SegmentedPathway( other ), path_( other.path_ ), segmentRadii_( other.segmentRadii_ )
+    : SegmentedPathway( other ), path_( other.path_ ), segmentRadii_( other.segmentRadii_ ), radii_( other.radii_ ), segmentIndex_( other.segmentIndex_ ), segmentIndexEnabled_( other.segmentIndexEnabled_ )
 {
-    assert( allRadiiNonNegative( segmentRadii_ ) && "All radii must be positive or zero." );    
+    assert( allRadiiNonNegative( segmentRadii_ ) && "All radii must be positive or zero." );
+    
+    // A copy of a view shares the radii, a copy of own storage uses its own
+    // copy.
+    if ( ! other.isView() ) {
+        radii_ = segmentRadii_.empty() ? 0 : &segmentRadii_[ 0 ];
+    }
 }
 
 
@@ -148,6 +154,9 @@ OpenSteer::PolylineSegmentedPathwaySegmentRadii::swap( PolylineSegmentedPathwayS
 {
     path_.swap( other.path_ );
     segmentRadii_.swap( other.segmentRadii_ );
+    std::swap( radii_, other.radii_ );
+    segmentIndex_.swap( other.segmentIndex_ );
+    std::swap( segmentIndexEnabled_, other.segmentIndexEnabled_ );
 }
 
 
@@ -160,6 +169,7 @@ OpenSteer::PolylineSegmentedPathwaySegmentRadii::movePoints( size_type startInde
                                                              Vec3 const points[] )
 {
     path_.movePoints( startIndex, numOfPoints, points );
+    segmentIndex_.pointsMoved( path_, startIndex, numOfPoints );
 }
 
 
@@ -175,7 +185,11 @@ OpenSteer::PolylineSegmentedPathwaySegmentRadii::setPathway( size_type numOfPoin
     path_.setPath( numOfPoints, points, closedCycle );
     segmentRadii_.assign( radii, radii + radiiCount( numOfPoints, closedCycle ) );
     shrinkToFit( segmentRadii_ );
+    radii_ = &segmentRadii_[ 0 ];
     
+    if ( segmentIndexEnabled_ ) {
+        segmentIndex_.build( path_, radii_ );
+    }
 }
 
 
@@ -186,7 +200,7 @@ float
 OpenSteer::PolylineSegmentedPathwaySegmentRadii::segmentRadius( size_type segmentIndex ) const
 {
     assert( segmentIndex < segmentCount() && "segmentIndex out of range." );
-    return segmentRadii_[ segmentIndex ];
+    return radii_[ segmentIndex ];
 }
 
 
@@ -196,8 +210,10 @@ OpenSteer::PolylineSegmentedPathwaySegmentRadii::setSegmentRadius( size_type seg
 {
     assert( segmentIndex < segmentCount() && "segmentIndex out of range." );
     assert( 0.0f <= r && "No negative radii allowed." );
+    assert( ! isView() && "A view can't be changed." );
     
     segmentRadii_[ segmentIndex ] = r;
+    segmentIndex_.setSegmentRadii( segmentIndex, 1, &r );
 }
 
 
@@ -210,8 +226,61 @@ OpenSteer::PolylineSegmentedPathwaySegmentRadii::setSegmentRadii( size_type star
     assert( startIndex < segmentCount() && "startIndex out of range." );
     assert( startIndex + numOfRadii <= segmentCount() && "Too many radii to set." );
     assert( allRadiiNonNegative( radii, radii + numOfRadii ) && "All radii must be positive or zero." );
+    assert( ! isView() && "A view can't be changed." );
     
     std::copy( radii, radii + numOfRadii, segmentRadii_.begin() + startIndex );
+    segmentIndex_.setSegmentRadii( startIndex, numOfRadii, radii );
+}
+
+
+void 
+OpenSteer::PolylineSegmentedPathwaySegmentRadii::setSegmentIndexEnabled( bool enabled )
+{
+    segmentIndexEnabled_ = enabled;
+    if ( segmentIndexEnabled_ && isValid() ) {
+        segmentIndex_.build( path_, radii_ );
+    } else {
+        segmentIndex_.clear();
+    }
+}
+
+
+
+bool 
+OpenSteer::PolylineSegmentedPathwaySegmentRadii::segmentIndexEnabled() const
+{
+    return segmentIndexEnabled_;
+}
+
+
+
+void 
+OpenSteer::PolylineSegmentedPathwaySegmentRadii::setView( PolylineSegmentedPath::View const& path,
+                                                          bool closedCycle,
+                                                          float const radii[],
+                                                          SegmentedPathIndex::View const& index )
+{
+    assert( allRadiiNonNegative( radii, radii + path.pointCount - 1 ) && "All radii must be positive or zero." );
+    assert( ( ( 0 == index.nodeCount ) || ( index.segmentCount + 1 == path.pointCount ) ) && "The index must cover the segments of the path." );
+    
+    path_.setView( path, closedCycle, SegmentedPathIndex::View() );
+    AccountedVector< float, MemoryAccount::pathMemory >::type().swap( segmentRadii_ );
+    radii_ = radii;
+    
+    segmentIndexEnabled_ = 0 < index.nodeCount;
+    if ( segmentIndexEnabled_ ) {
+        segmentIndex_.setView( index );
+    } else {
+        segmentIndex_.clear();
+    }
+}
+
+
+
+bool 
+OpenSteer::PolylineSegmentedPathwaySegmentRadii::isView() const
+{
+    return path_.isView();
 }
 
 
@@ -230,7 +299,7 @@ OpenSteer::PolylineSegmentedPathwaySegmentRadii::mapPointToPath (const Vec3& poi
                                                                  float& outside) const
 {
     PointToPathMapping mapping;
-    mapPointToPathAlike( *this, point, mapping );
+    mapPointToPathAlike( *this, segmentIndex_, point, mapping );
     tangent = mapping.tangent;
     outside = mapping.distancePointToPath;
     return mapping.pointOnPathCenterLine;    
@@ -241,9 +310,8 @@ OpenSteer::PolylineSegmentedPathwaySegmentRadii::mapPointToPath (const Vec3& poi
 OpenSteer::Vec3 
 OpenSteer::PolylineSegmentedPathwaySegmentRadii::mapPathDistanceToPoint (float pathDistance) const
 {
-    PathDistanceToPointMapping mapping;
-    mapDistanceToPathAlike( *this, pathDistance, mapping );
-    return mapping.pointOnPathCenterLine;    
+    PathCursor cursor;
+    return mapPathDistanceToPoint( pathDistance, cursor );    
 }
 
 
@@ -252,12 +320,66 @@ float
 OpenSteer::PolylineSegmentedPathwaySegmentRadii::mapPointToPathDistance (const Vec3& point) const
 {
     PointToPathDistanceMapping mapping;
-    mapPointToPathAlike( *this, point, mapping );
+    mapPointToPathAlike( *this, segmentIndex_, point, mapping );
     return mapping.distanceOnPath;    
 }
 
 
 
+OpenSteer::Vec3 
+OpenSteer::PolylineSegmentedPathwaySegmentRadii::mapPointToPath (const Vec3& point,
+                                                                 Vec3& tangent,
+                                                                 float& outside,
+                                                                 PathCursor& cursor) const
+{
+    PointToPathMapping mapping;
+    mapPointToPathAlike( *this, segmentIndex_, point, mapping, cursor );
+    tangent = mapping.tangent;
+    outside = mapping.distancePointToPath;
+    return mapping.pointOnPathCenterLine;
+}
+
+
+
+OpenSteer::Vec3 
+OpenSteer::PolylineSegmentedPathwaySegmentRadii::mapPathDistanceToPoint (float pathDistance,
+                                                                         PathCursor& cursor) const
+{
+    PathDistanceToPointMapping mapping;
+    mapDistanceToPathAlike( *this, pathDistance, mapping, cursor );
+    return mapping.pointOnPathCenterLine;
+}
+
+
+
+float 
+OpenSteer::PolylineSegmentedPathwaySegmentRadii::mapPointToPathDistance (const Vec3& point,
+                                                                         PathCursor& cursor) const
+{
+    PointToPathDistanceMapping mapping;
+    mapPointToPathAlike( *this, segmentIndex_, point, mapping, cursor );
+    return mapping.distanceOnPath;
+}
+
+
+
+OpenSteer::Vec3 
+OpenSteer::PolylineSegmentedPathwaySegmentRadii::mapPointToPathAndDistance( Vec3 const& point,
+                                                                            Vec3& tangent,
+                                                                            float& outside,
+                                                                            float& pathDistance,
+                                                                            PathCursor& cursor ) const
+{
+    PointToPathAndDistanceMapping mapping;
+    mapPointToPathAlike( *this, segmentIndex_, point, mapping, cursor );
+    tangent = mapping.tangent;
+    outside = mapping.distancePointToPath;
+    pathDistance = mapping.distanceOnPath;
+    return mapping.pointOnPathCenterLine;
+}
+
+
+
 bool 
 OpenSteer::PolylineSegmentedPathwaySegmentRadii::isCyclic() const
 {
@@ -345,7 +467,7 @@ OpenSteer::PolylineSegmentedPathwaySegmentRadii::mapSegmentDistanceToRadius( siz
 {
     OPENSTEER_UNUSED_PARAMETER(distanceOnSegment);
     assert( segmentIndex < segmentCount() && "segmentIndex out of range." );
-    return segmentRadii_[ segmentIndex ];
+    return radii_[ segmentIndex ];
 }
 
 
@@ -369,7 +491,7 @@ OpenSteer::PolylineSegmentedPathwaySegmentRadii::mapDistanceToSegmentPointAndTan
 {
     assert( segmentIndex < segmentCount() && "segmentIndex out of range." );
     path_.mapDistanceToSegmentPointAndTangent( segmentIndex, distance, pointOnPath, tangent );
-    radius = segmentRadii_[ segmentIndex ];
+    radius = radii_[ segmentIndex ];
 }
 
 
@@ -384,7 +506,21 @@ OpenSteer::PolylineSegmentedPathwaySegmentRadii::mapPointToSegmentDistanceAndPoi
                                                                                                        float& radius) const
 {
     path_.mapPointToSegmentDistanceAndPointAndTangent( segmentIndex, point, distance, pointOnPath, tangent );
-    radius = segmentRadii_[ segmentIndex ];
+    radius = radii_[ segmentIndex ];
 }
 
 
+
+float 
+OpenSteer::PolylineSegmentedPathwaySegmentRadii::segmentStartDistance( size_type segmentIndex ) const
+{
+    return path_.segmentStartDistance( segmentIndex );
+}
+
+
+
+OpenSteer::PolylineSegmentedPathwaySegmentRadii::size_type 
+OpenSteer::PolylineSegmentedPathwaySegmentRadii::segmentIndexAtDistance( float distance, size_type hint ) const
+{
+    return path_.segmentIndexAtDistance( distance, hint );
+}
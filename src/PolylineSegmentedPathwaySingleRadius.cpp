@@ -46,7 +46,7 @@
 
 
 OpenSteer::PolylineSegmentedPathwaySingleRadius::PolylineSegmentedPathwaySingleRadius()
-    : path_(), radius_ ( 0.0f )
+    : path_(), radius_ ( 0.0f ), segmentIndex_(), segmentIndexEnabled_( false )
 {
     
 }
@@ -54,7 +54,7 @@ OpenSteer::PolylineSegmentedPathwaySingleRadius::PolylineSegmentedPathwaySingleR
 
 
 OpenSteer::PolylineSegmentedPathwaySingleRadius::PolylineSegmentedPathwaySingleRadius( float r )
-    : path_(), radius_( r )
+    : path_(), radius_( r ), segmentIndex_(), segmentIndexEnabled_( false )
 {
     
 }
@@ -65,7 +65,7 @@ OpenSteer::PolylineSegmentedPathwaySingleRadius::PolylineSegmentedPathwaySingleR
                                                                                        Vec3 const points[],
                                                                                        float r,
                                                                                        bool closeCycle )
-    : path_( numOfPoints, points, closeCycle ), radius_( r )
+    : path_( numOfPoints, points, closeCycle ), radius_( r ), segmentIndex_(), segmentIndexEnabled_( false )
 {
     
 }
@@ -73,7 +73,7 @@ OpenSteer::PolylineSegmentedPathwaySingleRadius::PolylineSegmentedPathwaySingleR
 
 
 OpenSteer::PolylineSegmentedPathwaySingleRadius::PolylineSegmentedPathwaySingleRadius( PolylineSegmentedPathwaySingleRadius const& other )
-    : SegmentedPathway( other ), path_( other.path_ ), radius_( other.radius_ )
+    : SegmentedPathway( other ), path_( other.path_ ), radius_( other.radius_ ), segmentIndex_( other.segmentIndex_ ), segmentIndexEnabled_( other.segmentIndexEnabled_ )
 {
     
 }
@@ -102,6 +102,8 @@ OpenSteer::PolylineSegmentedPathwaySingleRadius::swap( PolylineSegmentedPathwayS
 {
     path_.swap( other.path_ );
     std::swap( radius_, other.radius_ );
+    segmentIndex_.swap( other.segmentIndex_ );
+    std::swap( segmentIndexEnabled_, other.segmentIndexEnabled_ );
 }
 
 
@@ -113,6 +115,53 @@ OpenSteer::PolylineSegmentedPathwaySingleRadius::movePoints( size_type startInde
                                                              Vec3 const newPointValues[] )
 {
     path_.movePoints( startIndex, numOfPoints, newPointValues );
+    segmentIndex_.pointsMoved( path_, startIndex, numOfPoints );
+}
+
+
+
+void 
+OpenSteer::PolylineSegmentedPathwaySingleRadius::appendPoints( size_type numOfPoints,
+                                                               Vec3 const newPoints[] )
+{
+    path_.appendPoints( numOfPoints, newPoints );
+    segmentIndex_.segmentsInserted( path_, numOfPoints, false, radius_ );
+}
+
+
+
+void 
+OpenSteer::PolylineSegmentedPathwaySingleRadius::prependPoints( size_type numOfPoints,
+                                                                Vec3 const newPoints[] )
+{
+    path_.prependPoints( numOfPoints, newPoints );
+    segmentIndex_.segmentsInserted( path_, numOfPoints, true, radius_ );
+}
+
+
+
+void 
+OpenSteer::PolylineSegmentedPathwaySingleRadius::removeFirstPoints( size_type numOfPoints )
+{
+    path_.removeFirstPoints( numOfPoints );
+    segmentIndex_.segmentsRemoved( path_, numOfPoints, true );
+}
+
+
+
+void 
+OpenSteer::PolylineSegmentedPathwaySingleRadius::removeLastPoints( size_type numOfPoints )
+{
+    path_.removeLastPoints( numOfPoints );
+    segmentIndex_.segmentsRemoved( path_, numOfPoints, false );
+}
+
+
+
+float 
+OpenSteer::PolylineSegmentedPathwaySingleRadius::startDistance() const
+{
+    return path_.startDistance();
 }
 
 
@@ -125,7 +174,11 @@ OpenSteer::PolylineSegmentedPathwaySingleRadius::setPathway( size_type numOfPoin
                                                              bool closedCycle )
 {
     path_.setPath( numOfPoints, points, closedCycle );
-    setRadius( r );
+    radius_ = r;
+    
+    if ( segmentIndexEnabled_ ) {
+        segmentIndex_.build( path_, radius_ );
+    }
 }
 
 
@@ -135,6 +188,13 @@ void
 OpenSteer::PolylineSegmentedPathwaySingleRadius::setRadius( float r )
 {
     radius_ = r;
+    
+    // A mapped index can't be refitted, build an own one.
+    if ( segmentIndex_.isView() ) {
+        segmentIndex_.build( path_, radius_ );
+    } else {
+        segmentIndex_.setRadius( radius_ );
+    }
 }
 
 
@@ -146,6 +206,55 @@ OpenSteer::PolylineSegmentedPathwaySingleRadius::radius() const
 }
 
 
+void 
+OpenSteer::PolylineSegmentedPathwaySingleRadius::setSegmentIndexEnabled( bool enabled )
+{
+    segmentIndexEnabled_ = enabled;
+    if ( segmentIndexEnabled_ && isValid() ) {
+        segmentIndex_.build( path_, radius_ );
+    } else {
+        segmentIndex_.clear();
+    }
+}
+
+
+
+bool 
+OpenSteer::PolylineSegmentedPathwaySingleRadius::segmentIndexEnabled() const
+{
+    return segmentIndexEnabled_;
+}
+
+
+
+void 
+OpenSteer::PolylineSegmentedPathwaySingleRadius::setView( PolylineSegmentedPath::View const& path,
+                                                          bool closedCycle,
+                                                          float r,
+                                                          SegmentedPathIndex::View const& index )
+{
+    assert( ( ( 0 == index.nodeCount ) || ( index.segmentCount + 1 == path.pointCount ) ) && "The index must cover the segments of the path." );
+    
+    path_.setView( path, closedCycle, SegmentedPathIndex::View() );
+    radius_ = r;
+    
+    segmentIndexEnabled_ = 0 < index.nodeCount;
+    if ( segmentIndexEnabled_ ) {
+        segmentIndex_.setView( index );
+    } else {
+        segmentIndex_.clear();
+    }
+}
+
+
+
+bool 
+OpenSteer::PolylineSegmentedPathwaySingleRadius::isView() const
+{
+    return path_.isView();
+}
+
+
 
 bool
 OpenSteer::PolylineSegmentedPathwaySingleRadius::isValid() const 
@@ -161,7 +270,7 @@ OpenSteer::PolylineSegmentedPathwaySingleRadius::mapPointToPath (const Vec3& poi
                                                                  float& outside) const
 {
     PointToPathMapping mapping;
-    mapPointToPathAlike( *this, point, mapping );
+    mapPointToPathAlike( *this, segmentIndex_, point, mapping );
     tangent = mapping.tangent;
     outside = mapping.distancePointToPath;
     return mapping.pointOnPathCenterLine;
@@ -171,20 +280,73 @@ OpenSteer::PolylineSegmentedPathwaySingleRadius::mapPointToPath (const Vec3& poi
 
 OpenSteer::Vec3 
 OpenSteer::PolylineSegmentedPathwaySingleRadius::mapPathDistanceToPoint (float pathDistance) const
+{
+    PathCursor cursor;
+    return mapPathDistanceToPoint( pathDistance, cursor );
+}
+
+
+
+float 
+OpenSteer::PolylineSegmentedPathwaySingleRadius::mapPointToPathDistance (const Vec3& point) const
+{
+    PointToPathDistanceMapping mapping;
+    mapPointToPathAlike( *this, segmentIndex_, point, mapping );
+    return path_.startDistance() + mapping.distanceOnPath;
+}
+
+
+
+OpenSteer::Vec3 
+OpenSteer::PolylineSegmentedPathwaySingleRadius::mapPointToPath (const Vec3& point,
+                                                                 Vec3& tangent,
+                                                                 float& outside,
+                                                                 PathCursor& cursor) const
+{
+    PointToPathMapping mapping;
+    mapPointToPathAlike( *this, segmentIndex_, point, mapping, cursor );
+    tangent = mapping.tangent;
+    outside = mapping.distancePointToPath;
+    return mapping.pointOnPathCenterLine;
+}
+
+
+
+OpenSteer::Vec3 
+OpenSteer::PolylineSegmentedPathwaySingleRadius::mapPathDistanceToPoint (float pathDistance,
+                                                                         PathCursor& cursor) const
 {
     PathDistanceToPointMapping mapping;
-    mapDistanceToPathAlike( *this, pathDistance, mapping );
+    mapDistanceToPathAlike( *this, pathDistance - path_.startDistance(), mapping, cursor );
     return mapping.pointOnPathCenterLine;
 }
 
 
 
 float 
-OpenSteer::PolylineSegmentedPathwaySingleRadius::mapPointToPathDistance (const Vec3& point) const
+OpenSteer::PolylineSegmentedPathwaySingleRadius::mapPointToPathDistance (const Vec3& point,
+                                                                         PathCursor& cursor) const
 {
     PointToPathDistanceMapping mapping;
-    mapPointToPathAlike( *this, point, mapping );
-    return mapping.distanceOnPath;
+    mapPointToPathAlike( *this, segmentIndex_, point, mapping, cursor );
+    return path_.startDistance() + mapping.distanceOnPath;
+}
+
+
+
+OpenSteer::Vec3 
+OpenSteer::PolylineSegmentedPathwaySingleRadius::mapPointToPathAndDistance( Vec3 const& point,
+                                                                            Vec3& tangent,
+                                                                            float& outside,
+                                                                            float& pathDistance,
+                                                                            PathCursor& cursor ) const
+{
+    PointToPathAndDistanceMapping mapping;
+    mapPointToPathAlike( *this, segmentIndex_, point, mapping, cursor );
+    tangent = mapping.tangent;
+    outside = mapping.distancePointToPath;
+    pathDistance = path_.startDistance() + mapping.distanceOnPath;
+    return mapping.pointOnPathCenterLine;
 }
 
 
@@ -318,3 +480,17 @@ OpenSteer::PolylineSegmentedPathwaySingleRadius::mapPointToSegmentDistanceAndPoi
 }
 
 
+
+float 
+OpenSteer::PolylineSegmentedPathwaySingleRadius::segmentStartDistance( size_type segmentIndex ) const
+{
+    return path_.segmentStartDistance( segmentIndex );
+}
+
+
+
+OpenSteer::PolylineSegmentedPathwaySingleRadius::size_type 
+OpenSteer::PolylineSegmentedPathwaySingleRadius::segmentIndexAtDistance( float distance, size_type hint ) const
+{
+    return path_.segmentIndexAtDistance( distance, hint );
+}
@@ -0,0 +1,277 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Profiler
+//
+// Per-thread ring buffers of spans and Chrome trace export.  See Profiler.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/Profiler.h"
+
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+
+namespace {
+
+    typedef std::chrono::steady_clock profileClock;
+
+    // span times are kept in nanoseconds since this point
+    const profileClock::time_point profileEpoch = profileClock::now ();
+
+    long long nanosecondsNow (void)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>
+            (profileClock::now () - profileEpoch).count ();
+    }
+
+
+    // maximum nesting depth, deeper Scopes are not recorded
+    const int spanStackSize = 64;
+
+
+    class Span
+    {
+    public:
+        const char* name;
+        long long begin;
+        long long end;
+    };
+
+
+    // one thread's recorded spans and its stack of open ones
+    class ThreadBuffer
+    {
+    public:
+        ThreadBuffer (const int t, const size_t capacity)
+            : tid (t), name (NULL), spans (capacity > 0 ? capacity : 1),
+              next (0), count (0), depth (0), overflow (0) {}
+
+        void add (const Span& span)
+        {
+            spans[next] = span;
+            next = (next + 1) % spans.size();
+            if (count < spans.size()) count++;
+        }
+
+        // the i-th oldest span
+        const Span& oldest (const size_t i) const
+        {
+            return spans[(next + spans.size() - count + i) % spans.size()];
+        }
+
+        const int tid;
+        const char* name;
+        std::vector<Span> spans;
+        size_t next;
+        size_t count;
+
+        Span open [spanStackSize];
+        int depth;
+        int overflow;
+    };
+
+
+    // all threads' buffers, which outlive their threads so spans of
+    // finished threads (such as resized WorkerPools) can still be exported
+    std::mutex registryMutex;
+    std::vector<ThreadBuffer*> registry;
+
+    thread_local ThreadBuffer* threadBuffer = NULL;
+
+    // the calling thread's name, until its buffer is made
+    thread_local const char* threadName = NULL;
+
+    ThreadBuffer& currentThreadBuffer (void)
+    {
+        if (threadBuffer == NULL)
+        {
+            std::lock_guard<std::mutex> lock (registryMutex);
+            threadBuffer = new ThreadBuffer ((int) registry.size() + 1,
+                                             OpenSteer::Profiler::ringCapacity);
+            threadBuffer->name = threadName;
+            registry.push_back (threadBuffer);
+        }
+        return *threadBuffer;
+    }
+
+
+    // write a string as a JSON string literal
+    void writeJSONString (std::ostream& os, const char* s)
+    {
+        os << '"';
+        for (; *s; s++)
+        {
+            if ((*s == '"') || (*s == '\\')) os << '\\' << *s;
+            else if ((unsigned char) *s < 0x20) os << ' ';
+            else os << *s;
+        }
+        os << '"';
+    }
+
+    // write nanoseconds as (fractional) microseconds, the trace time unit
+    void writeMicroseconds (std::ostream& os, const long long ns)
+    {
+        const long long fraction = ns % 1000;
+        os << ns / 1000 << '.'
+           << (char) ('0' + fraction / 100)
+           << (char) ('0' + (fraction / 10) % 10)
+           << (char) ('0' + fraction % 10);
+    }
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+bool OpenSteer::Profiler::enabled = false;
+size_t OpenSteer::Profiler::ringCapacity = 65536;
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::Profiler::setThreadName (const char* name)
+{
+    // the buffer is only made once the thread records
+    threadName = name;
+    if (threadBuffer) threadBuffer->name = name;
+}
+
+
+void 
+OpenSteer::Profiler::clear (void)
+{
+    std::lock_guard<std::mutex> lock (registryMutex);
+    for (size_t i = 0; i < registry.size(); i++)
+    {
+        registry[i]->next = 0;
+        registry[i]->count = 0;
+    }
+}
+
+
+size_t 
+OpenSteer::Profiler::spanCount (void)
+{
+    std::lock_guard<std::mutex> lock (registryMutex);
+    size_t total = 0;
+    for (size_t i = 0; i < registry.size(); i++) total += registry[i]->count;
+    return total;
+}
+
+
+// ----------------------------------------------------------------------------
+// Chrome trace event format: one complete ("X") event per span, plus a
+// thread name ("M") event per thread
+
+
+void 
+OpenSteer::Profiler::writeChromeTrace (std::ostream& os)
+{
+    std::lock_guard<std::mutex> lock (registryMutex);
+
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (size_t t = 0; t < registry.size(); t++)
+    {
+        const ThreadBuffer& buffer = *registry[t];
+
+        if (! first) os << ',';
+        first = false;
+        os << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+           << buffer.tid << ",\"args\":{\"name\":";
+        if (buffer.name)
+            writeJSONString (os, buffer.name);
+        else
+            os << "\"thread " << buffer.tid << '"';
+        os << "}}";
+
+        for (size_t i = 0; i < buffer.count; i++)
+        {
+            const Span& span = buffer.oldest (i);
+            os << ",\n{\"name\":";
+            writeJSONString (os, span.name);
+            os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer.tid
+               << ",\"ts\":";
+            writeMicroseconds (os, span.begin);
+            os << ",\"dur\":";
+            writeMicroseconds (os, span.end - span.begin);
+            os << '}';
+        }
+    }
+    os << "\n]}" << std::endl;
+}
+
+
+// ----------------------------------------------------------------------------
+// open and close a span
+
+
+void 
+OpenSteer::Profiler::begin (const char* name)
+{
+    ThreadBuffer& buffer = currentThreadBuffer ();
+    if (buffer.depth < spanStackSize)
+    {
+        Span& span = buffer.open[buffer.depth++];
+        span.name = name;
+        span.begin = nanosecondsNow ();
+    }
+    else
+    {
+        buffer.overflow++;
+    }
+}
+
+
+void 
+OpenSteer::Profiler::end (void)
+{
+    ThreadBuffer& buffer = currentThreadBuffer ();
+    if (buffer.overflow > 0)
+    {
+        buffer.overflow--;
+    }
+    else if (buffer.depth > 0)
+    {
+        Span& span = buffer.open[--buffer.depth];
+        span.end = nanosecondsNow ();
+        buffer.add (span);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
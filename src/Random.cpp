@@ -0,0 +1,126 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Random
+//
+// Global random seed and per-thread default streams.  See Random.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/Random.h"
+
+#include <atomic>
+#include <cstddef>
+
+
+namespace {
+
+    // stream numbers of the threads' default streams, kept clear of the
+    // vehicles' stream numbers (their serial numbers)
+    const uint64_t firstThreadStream = 1ULL << 62;
+
+    std::atomic<uint64_t> globalSeed (OpenSteer::RandomStream::defaultSeed);
+    std::atomic<uint64_t> threadStreamCounter (0);
+
+    // the first use on a thread seeds its default stream with the next
+    // thread stream number
+    class ThreadStream
+    {
+    public:
+        ThreadStream (void)
+            : stream (globalSeed.load (),
+                      firstThreadStream + threadStreamCounter++) {}
+        OpenSteer::RandomStream stream;
+    };
+
+    thread_local ThreadStream threadStream;
+
+    // the calling thread's innermost RandomScope
+    thread_local OpenSteer::RandomScope* currentScope = NULL;
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+void
+OpenSteer::setRandomSeed (const uint64_t seed)
+{
+    globalSeed = seed;
+    threadStream.stream.seed (seed, firstThreadStream);
+}
+
+
+uint64_t
+OpenSteer::randomSeed (void)
+{
+    return globalSeed.load ();
+}
+
+
+OpenSteer::RandomStream&
+OpenSteer::defaultRandomStream (void)
+{
+    return currentScope ? currentScope->stream : threadStream.stream;
+}
+
+
+void
+OpenSteer::seedVehicleRandomStream (RandomStream& stream,
+                                    const int serialNumber)
+{
+    if (currentScope)
+        stream.seed (currentScope->seed, currentScope->vehicleCount++);
+    else
+        stream.seed (globalSeed.load (), serialNumber);
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::RandomScope::RandomScope (RandomStream& s,
+                                     const uint64_t sd,
+                                     uint64_t& count)
+    : stream (s), seed (sd), vehicleCount (count), outer (currentScope)
+{
+    currentScope = this;
+}
+
+
+OpenSteer::RandomScope::~RandomScope ()
+{
+    currentScope = outer;
+}
+
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,335 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// RegionPartition
+//
+// See RegionPartition.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/RegionPartition.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include "OpenSteer/Utilities.h"
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::RegionPartition::RegionPartition (const Vec3& lo, const Vec3& hi,
+                                             const int columns,
+                                             const int rows)
+    : _lo (lo), _hi (hi),
+      _columns (std::max (columns, 1)), _rows (std::max (rows, 1))
+{
+    _columnWidth = (hi.x - lo.x) / _columns;
+    _rowDepth = (hi.z - lo.z) / _rows;
+}
+
+
+int 
+OpenSteer::RegionPartition::regionOf (const Vec3& position) const
+{
+    const int column = (int) ((position.x - _lo.x) / _columnWidth);
+    const int row = (int) ((position.z - _lo.z) / _rowDepth);
+    return ((std::max (std::min (row, _rows - 1), 0) * _columns) +
+            std::max (std::min (column, _columns - 1), 0));
+}
+
+
+void 
+OpenSteer::RegionPartition::bounds (const int region, Vec3& lo, Vec3& hi) const
+{
+    const int column = region % _columns;
+    const int row = region / _columns;
+    lo.set (_lo.x + column * _columnWidth, _lo.y, _lo.z + row * _rowDepth);
+    hi.set (lo.x + _columnWidth, _hi.y, lo.z + _rowDepth);
+
+    // the outer regions also hold everything beyond the bounds
+    const float far = std::numeric_limits<float>::max ();
+    if (column == 0) lo.x = -far;
+    if (row == 0) lo.z = -far;
+    if (column == _columns - 1) hi.x = far;
+    if (row == _rows - 1) hi.z = far;
+}
+
+
+void 
+OpenSteer::RegionPartition::regionsNear (const Vec3& position,
+                                         const float radius,
+                                         const int exclude,
+                                         std::vector<int>& regions) const
+{
+    regions.clear ();
+    Vec3 lo, hi;
+    for (int r = 0; r < regionCount (); r++)
+    {
+        if (r == exclude) continue;
+        bounds (r, lo, hi);
+        const float dx = maxXXX (maxXXX (lo.x - position.x, position.x - hi.x), 0.0f);
+        const float dz = maxXXX (maxXXX (lo.z - position.z, position.z - hi.z), 0.0f);
+        if ((dx * dx) + (dz * dz) <= (radius * radius)) regions.push_back (r);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::LocalRegionTransport::LocalRegionTransport (const int nodeCount)
+    : _nodeCount (nodeCount),
+      _queues (nodeCount * nodeCount)
+{
+}
+
+
+void 
+OpenSteer::LocalRegionTransport::send (const int from, const int to,
+                                       const std::vector<char>& message)
+{
+    {
+        std::lock_guard<std::mutex> lock (_mutex);
+        _queues[(from * _nodeCount) + to].push_back (message);
+    }
+    _arrived.notify_all ();
+}
+
+
+void 
+OpenSteer::LocalRegionTransport::receive (const int from, const int to,
+                                          std::vector<char>& message)
+{
+    std::deque<std::vector<char> >& queue = _queues[(from * _nodeCount) + to];
+    std::unique_lock<std::mutex> lock (_mutex);
+    while (queue.empty ()) _arrived.wait (lock);
+    message.swap (queue.front ());
+    queue.pop_front ();
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace {
+
+    // message header: the counts of the ghost and migrant records which
+    // follow it
+    struct RegionMessageHeader
+    {
+        uint32_t ghosts;
+        uint32_t migrants;
+    };
+
+} // anonymous namespace
+
+
+OpenSteer::RegionNode::RegionNode (const RegionPartition& partition,
+                                   const int rank,
+                                   RegionTransport& transport,
+                                   const float ghostRadius)
+    : _partition (partition),
+      _rank (rank),
+      _transport (transport),
+      _ghostRadius (ghostRadius),
+      _pd (NULL),
+      _outGhosts (partition.regionCount ()),
+      _outMigrants (partition.regionCount ())
+{
+}
+
+
+OpenSteer::RegionNode::~RegionNode ()
+{
+    setProximityDatabase (NULL);
+    for (size_t i = 0; i < _ghosts.size(); i++) delete _ghosts[i];
+}
+
+
+void 
+OpenSteer::RegionNode::setProximityDatabase (ProximityDatabase* pd)
+{
+    for (size_t i = 0; i < _tokens.size(); i++) delete _tokens[i];
+    _tokens.clear ();
+    _pd = pd;
+    if (_pd)
+    {
+        for (size_t i = 0; i < _ghostGroup.size(); i++)
+            _tokens.push_back (_pd->allocateToken (_ghostGroup[i]));
+        placeGhosts ();
+    }
+}
+
+
+void 
+OpenSteer::RegionNode::send (const AVGroup& owned,
+                             std::vector<size_t>& emigrated)
+{
+    const int regions = _partition.regionCount ();
+    for (int r = 0; r < regions; r++)
+    {
+        _outGhosts[r].clear ();
+        _outMigrants[r].clear ();
+    }
+    _keptGhosts.clear ();
+    emigrated.clear ();
+
+    CheckpointVehicle record;
+    for (size_t i = 0; i < owned.size(); i++)
+    {
+        const SimpleVehicle& vehicle = static_cast<const SimpleVehicle&> (*owned[i]);
+        const Vec3 position = vehicle.position ();
+        const int region = _partition.regionOf (position);
+        _partition.regionsNear (position, _ghostRadius, region, _near);
+        if ((region == _rank) && _near.empty ()) continue;
+
+        vehicle.saveState (record);
+        if (region != _rank)
+        {
+            _outMigrants[region].push_back (record);
+            emigrated.push_back (i);
+        }
+        for (size_t n = 0; n < _near.size(); n++)
+        {
+            // an emigrant near this region stays here as a ghost
+            if (_near[n] == _rank)
+                _keptGhosts.push_back (record);
+            else
+                _outGhosts[_near[n]].push_back (record);
+        }
+    }
+
+    for (int r = 0; r < regions; r++)
+    {
+        if (r == _rank) continue;
+        writeMessage (r, _message);
+        _transport.send (_rank, r, _message);
+    }
+}
+
+
+void 
+OpenSteer::RegionNode::receive (void)
+{
+    _inGhosts.swap (_keptGhosts);
+    _immigrants.clear ();
+    for (int r = 0; r < _partition.regionCount (); r++)
+    {
+        if (r == _rank) continue;
+        _transport.receive (r, _rank, _message);
+        readMessage (_message);
+    }
+
+    // as many ghost vehicles (and tokens) as ghosts, reusing earlier ones
+    const size_t count = _inGhosts.size ();
+    while (_ghosts.size() < count) _ghosts.push_back (new GhostVehicle);
+    _ghostGroup.resize (count);
+    for (size_t i = 0; i < count; i++)
+    {
+        _ghosts[i]->restoreState (_inGhosts[i]);
+        _ghostGroup[i] = _ghosts[i];
+    }
+    if (_pd)
+    {
+        while (_tokens.size() > count)
+        {
+            delete _tokens.back ();
+            _tokens.pop_back ();
+        }
+        while (_tokens.size() < count)
+            _tokens.push_back (_pd->allocateToken (_ghosts[_tokens.size()]));
+        placeGhosts ();
+    }
+}
+
+
+void 
+OpenSteer::RegionNode::placeGhosts (void)
+{
+    const size_t count = _tokens.size ();
+    if (count == 0) return;
+    _positions.resize (count);
+    for (size_t i = 0; i < count; i++)
+        _positions[i] = _ghostGroup[i]->position ();
+    _pd->updateForNewPositions (&_tokens[0], &_positions[0], count, NULL);
+}
+
+
+void 
+OpenSteer::RegionNode::writeMessage (const int to,
+                                     std::vector<char>& message) const
+{
+    const std::vector<CheckpointVehicle>& ghosts = _outGhosts[to];
+    const std::vector<CheckpointVehicle>& migrants = _outMigrants[to];
+    RegionMessageHeader header;
+    header.ghosts = (uint32_t) ghosts.size ();
+    header.migrants = (uint32_t) migrants.size ();
+
+    const size_t record = sizeof (CheckpointVehicle);
+    message.resize (sizeof (header) + (record * (ghosts.size() + migrants.size())));
+    char* p = &message[0];
+    std::memcpy (p, &header, sizeof (header));
+    p += sizeof (header);
+    if (! ghosts.empty ())
+        std::memcpy (p, &ghosts[0], record * ghosts.size ());
+    p += record * ghosts.size ();
+    if (! migrants.empty ())
+        std::memcpy (p, &migrants[0], record * migrants.size ());
+}
+
+
+void 
+OpenSteer::RegionNode::readMessage (const std::vector<char>& message)
+{
+    RegionMessageHeader header;
+    if (message.size() < sizeof (header)) return;
+    std::memcpy (&header, &message[0], sizeof (header));
+
+    const size_t record = sizeof (CheckpointVehicle);
+    if (message.size() != sizeof (header) + (record * ((size_t) header.ghosts +
+                                                       header.migrants)))
+        return;
+
+    const char* p = &message[sizeof (header)];
+    const size_t ghosts = _inGhosts.size ();
+    _inGhosts.resize (ghosts + header.ghosts);
+    if (header.ghosts)
+        std::memcpy (&_inGhosts[ghosts], p, record * header.ghosts);
+    p += record * header.ghosts;
+    const size_t migrants = _immigrants.size ();
+    _immigrants.resize (migrants + header.migrants);
+    if (header.migrants)
+        std::memcpy (&_immigrants[migrants], p, record * header.migrants);
+}
+
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,574 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ * @file
+ */
+#include "OpenSteer/SegmentedPathIndex.h"
+
+// Include std::nth_element, std::fill, std::copy, std::max
+#include <algorithm>
+
+
+
+namespace {
+    
+    typedef OpenSteer::SegmentedPath::size_type size_type;
+    
+    /**
+     * Maximal number of segments stored in a leaf.
+     */
+    unsigned int const maxLeafSegments = 4;
+    
+    
+    /**
+     * Orders segment indices by the coordinate @a axis of their centers.
+     */
+    class CenterLess {
+    public:
+        CenterLess( std::vector< OpenSteer::Vec3 > const& centers, int axis ) 
+            : centers_( centers ), axis_( axis ) {}
+        
+        bool operator()( unsigned int lhs, unsigned int rhs ) const {
+            return coordinate( centers_[ lhs ] ) < coordinate( centers_[ rhs ] );
+        }
+        
+    private:
+        float coordinate( OpenSteer::Vec3 const& v ) const {
+            return ( 0 == axis_ ) ? v.x : ( ( 1 == axis_ ) ? v.y : v.z );
+        }
+        
+        std::vector< OpenSteer::Vec3 > const& centers_;
+        int axis_;
+    }; // class CenterLess
+    
+    
+} // anonymous namespace
+
+
+
+OpenSteer::SegmentedPathIndex::SegmentedPathIndex()
+    : nodes_(), order_(), leafOfSegment_(), segmentStarts_(), segmentEnds_(), segmentRadii_(), slack_( 0.0f ), view_(), isView_( false ), insertedFront_( 0 ), insertedBack_( 0 ), removedFront_( 0 ), removedBack_( 0 ), insertedRadius_( 0.0f )
+{
+    updateView();
+}
+
+
+
+OpenSteer::SegmentedPathIndex::SegmentedPathIndex( SegmentedPathIndex const& other )
+    : nodes_( other.nodes_ ), order_( other.order_ ), leafOfSegment_( other.leafOfSegment_ ), segmentStarts_( other.segmentStarts_ ), segmentEnds_( other.segmentEnds_ ), segmentRadii_( other.segmentRadii_ ), slack_( other.slack_ ), view_( other.view_ ), isView_( other.isView_ ), insertedFront_( other.insertedFront_ ), insertedBack_( other.insertedBack_ ), removedFront_( other.removedFront_ ), removedBack_( other.removedBack_ ), insertedRadius_( other.insertedRadius_ )
+{
+    // A copy of a view shares the arrays, a copy of own storage uses its 
+    // own copy.
+    if ( ! isView_ ) {
+        updateView();
+    }
+}
+
+
+
+OpenSteer::SegmentedPathIndex& 
+OpenSteer::SegmentedPathIndex::operator=( SegmentedPathIndex other )
+{
+    swap( other );
+    return *this;
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndex::swap( SegmentedPathIndex& other )
+{
+    // Swapping vectors keeps their storage, so the views stay valid.
+    nodes_.swap( other.nodes_ );
+    order_.swap( other.order_ );
+    leafOfSegment_.swap( other.leafOfSegment_ );
+    segmentStarts_.swap( other.segmentStarts_ );
+    segmentEnds_.swap( other.segmentEnds_ );
+    segmentRadii_.swap( other.segmentRadii_ );
+    std::swap( slack_, other.slack_ );
+    std::swap( view_, other.view_ );
+    std::swap( isView_, other.isView_ );
+    std::swap( insertedFront_, other.insertedFront_ );
+    std::swap( insertedBack_, other.insertedBack_ );
+    std::swap( removedFront_, other.removedFront_ );
+    std::swap( removedBack_, other.removedBack_ );
+    std::swap( insertedRadius_, other.insertedRadius_ );
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndex::clear()
+{
+    SegmentedPathIndex empty;
+    swap( empty );
+}
+
+
+
+bool 
+OpenSteer::SegmentedPathIndex::empty() const
+{
+    return 0 == view_.nodeCount;
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndex::build( SegmentedPath const& path, float radius )
+{
+    isView_ = false;
+    segmentRadii_.assign( path.segmentCount(), radius );
+    buildTree( path );
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndex::build( SegmentedPath const& path, float const radii[] )
+{
+    isView_ = false;
+    segmentRadii_.assign( radii, radii + path.segmentCount() );
+    buildTree( path );
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndex::pointsMoved( SegmentedPath const& path, 
+                                            size_type startIndex, 
+                                            size_type numOfPoints )
+{
+    if ( empty() || ( 0 == numOfPoints ) ) {
+        return;
+    }
+    
+    assert( path.segmentCount() == segmentCount() && "The index must have been built for path." );
+    assert( ! isView_ && "A view can't be refitted." );
+    
+    // The same segments as those whose tangents and lengths the path
+    // recalculates: the one ending at the first moved point up to the one 
+    // starting at the last, and the cycle closing one if the first point 
+    // moved.
+    size_type const segments = segmentCount();
+    size_type const firstSegment = ( 0 < startIndex ) ? ( startIndex - 1 ) : 0;
+    size_type const lastSegment = std::min( startIndex + numOfPoints, segments );
+    bool const closingSegment = path.isCyclic() && ( 0 == firstSegment ) && ( lastSegment != segments );
+    
+    // Segments inserted since the tree was built are read from the path
+    // by the queries anyway.
+    size_type treeSegment = 0;
+    for ( size_type i = firstSegment; i < lastSegment; ++i ) {
+        if ( treeIndex( i, treeSegment ) ) {
+            segmentStarts_[ treeSegment ] = path.segmentStart( i );
+            segmentEnds_[ treeSegment ] = path.segmentEnd( i );
+        }
+    }
+    if ( closingSegment && treeIndex( segments - 1, treeSegment ) ) {
+        segmentStarts_[ treeSegment ] = path.segmentStart( segments - 1 );
+        segmentEnds_[ treeSegment ] = path.segmentEnd( segments - 1 );
+    }
+    
+    // Refitting leaf by leaf pays off only for a few moved points.
+    if ( ( lastSegment - firstSegment ) * 8 > view_.segmentCount ) {
+        refitAll();
+    } else {
+        for ( size_type i = firstSegment; i < lastSegment; ++i ) {
+            if ( treeIndex( i, treeSegment ) ) {
+                fitLeaf( leafOfSegment_[ treeSegment ] );
+                refitAncestors( leafOfSegment_[ treeSegment ] );
+            }
+        }
+        if ( closingSegment && treeIndex( segments - 1, treeSegment ) ) {
+            fitLeaf( leafOfSegment_[ treeSegment ] );
+            refitAncestors( leafOfSegment_[ treeSegment ] );
+        }
+    }
+    
+    updateSlack();
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndex::setRadius( float radius )
+{
+    if ( empty() ) {
+        return;
+    }
+    
+    assert( ! isView_ && "A view can't be refitted." );
+    std::fill( segmentRadii_.begin(), segmentRadii_.end(), radius );
+    insertedRadius_ = radius;
+    refitAll();
+    updateSlack();
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndex::setSegmentRadii( size_type startIndex, 
+                                                size_type numOfRadii, 
+                                                float const radii[] )
+{
+    if ( empty() ) {
+        return;
+    }
+    
+    assert( startIndex + numOfRadii <= segmentCount() && "Too many radii to set." );
+    assert( ! isView_ && "A view can't be refitted." );
+    
+    size_type treeSegment = 0;
+    for ( size_type i = 0; i < numOfRadii; ++i ) {
+        if ( treeIndex( startIndex + i, treeSegment ) ) {
+            segmentRadii_[ treeSegment ] = radii[ i ];
+        }
+    }
+    
+    if ( numOfRadii * 8 > view_.segmentCount ) {
+        refitAll();
+    } else {
+        for ( size_type i = startIndex; i < startIndex + numOfRadii; ++i ) {
+            if ( treeIndex( i, treeSegment ) ) {
+                fitLeaf( leafOfSegment_[ treeSegment ] );
+                refitAncestors( leafOfSegment_[ treeSegment ] );
+            }
+        }
+    }
+    updateSlack();
+}
+
+
+
+OpenSteer::SegmentedPathIndex::size_type 
+OpenSteer::SegmentedPathIndex::segmentCount() const
+{
+    return insertedFront_ + ( view_.segmentCount - removedFront_ - removedBack_ ) + insertedBack_;
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndex::segmentsInserted( SegmentedPath const& path,
+                                                 size_type numOfSegments,
+                                                 bool atFront,
+                                                 float radius )
+{
+    if ( empty() || ( 0 == numOfSegments ) ) {
+        return;
+    }
+    
+    assert( ! isView_ && "A view can't be refitted." );
+    
+    if ( atFront ) {
+        insertedFront_ += numOfSegments;
+    } else {
+        insertedBack_ += numOfSegments;
+    }
+    insertedRadius_ = radius;
+    
+    assert( path.segmentCount() == segmentCount() && "The index must have been built for path." );
+    rebuildIfStale( path );
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndex::segmentsRemoved( SegmentedPath const& path,
+                                                size_type numOfSegments,
+                                                bool atFront )
+{
+    if ( empty() || ( 0 == numOfSegments ) ) {
+        return;
+    }
+    
+    assert( ! isView_ && "A view can't be refitted." );
+    assert( numOfSegments <= segmentCount() && "Can't remove more segments than indexed." );
+    
+    // Remove inserted segments at that end first, then tree segments, then 
+    // inserted segments at the other end.
+    size_type& nearInserted = atFront ? insertedFront_ : insertedBack_;
+    size_type& farInserted = atFront ? insertedBack_ : insertedFront_;
+    size_type& removed = atFront ? removedFront_ : removedBack_;
+    
+    size_type remaining = numOfSegments;
+    size_type const fromNear = std::min( remaining, nearInserted );
+    nearInserted -= fromNear;
+    remaining -= fromNear;
+    
+    size_type const fromTree = std::min( remaining, view_.segmentCount - removedFront_ - removedBack_ );
+    removed += fromTree;
+    remaining -= fromTree;
+    
+    farInserted -= remaining;
+    
+    assert( path.segmentCount() == segmentCount() && "The index must have been built for path." );
+    rebuildIfStale( path );
+}
+
+
+
+OpenSteer::SegmentedPathIndex::View 
+OpenSteer::SegmentedPathIndex::view() const
+{
+    return view_;
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndex::setView( View const& view )
+{
+    assert( ( ( 0 == view.nodeCount ) || ( ( 0 != view.nodes ) && ( 0 != view.order ) ) ) && "A view with nodes needs node and order arrays." );
+    
+    clear();
+    view_ = view;
+    isView_ = true;
+}
+
+
+
+bool 
+OpenSteer::SegmentedPathIndex::isView() const
+{
+    return isView_;
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndex::buildTree( SegmentedPath const& path )
+{
+    size_type const segments = path.segmentCount();
+    
+    insertedFront_ = 0;
+    insertedBack_ = 0;
+    removedFront_ = 0;
+    removedBack_ = 0;
+    
+    nodes_.clear();
+    order_.resize( segments );
+    leafOfSegment_.resize( segments );
+    segmentStarts_.resize( segments );
+    segmentEnds_.resize( segments );
+    
+    if ( 0 == segments ) {
+        clear();
+        return;
+    }
+    
+    std::vector< Vec3 > centers( segments );
+    for ( size_type i = 0; i < segments; ++i ) {
+        segmentStarts_[ i ] = path.segmentStart( i );
+        segmentEnds_[ i ] = path.segmentEnd( i );
+        centers[ i ] = ( segmentStarts_[ i ] + segmentEnds_[ i ] ) * 0.5f;
+        order_[ i ] = static_cast< unsigned int >( i );
+    }
+    
+    nodes_.reserve( 2 * ( segments / maxLeafSegments + 1 ) );
+    nodes_.push_back( Node() );
+    nodes_[ 0 ].parent = -1;
+    distribute( centers, 0, 0, static_cast< unsigned int >( segments ) );
+    
+    updateSlack();
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndex::distribute( std::vector< Vec3 >& centers, int node, unsigned int first, unsigned int count )
+{
+    if ( count <= maxLeafSegments ) {
+        nodes_[ node ].firstChild = -1;
+        nodes_[ node ].first = first;
+        nodes_[ node ].count = count;
+        for ( unsigned int i = first; i < first + count; ++i ) {
+            leafOfSegment_[ order_[ i ] ] = node;
+        }
+        fitLeaf( node );
+        return;
+    }
+    
+    // Split at the median center along the axis the centers spread most.
+    Vec3 low = centers[ order_[ first ] ];
+    Vec3 high = low;
+    for ( unsigned int i = first + 1; i < first + count; ++i ) {
+        Vec3 const& c = centers[ order_[ i ] ];
+        low.set( std::min( low.x, c.x ), std::min( low.y, c.y ), std::min( low.z, c.z ) );
+        high.set( std::max( high.x, c.x ), std::max( high.y, c.y ), std::max( high.z, c.z ) );
+    }
+    Vec3 const spread = high - low;
+    int const axis = ( ( spread.x >= spread.y ) && ( spread.x >= spread.z ) ) ? 0 : ( ( spread.y >= spread.z ) ? 1 : 2 );
+    
+    unsigned int const half = count / 2;
+    std::nth_element( order_.begin() + first, 
+                      order_.begin() + first + half, 
+                      order_.begin() + first + count, 
+                      CenterLess( centers, axis ) );
+    
+    int const child = static_cast< int >( nodes_.size() );
+    nodes_.push_back( Node() );
+    nodes_.push_back( Node() );
+    nodes_[ node ].firstChild = child;
+    nodes_[ node ].first = first;
+    nodes_[ node ].count = count;
+    nodes_[ child ].parent = node;
+    nodes_[ child + 1 ].parent = node;
+    
+    distribute( centers, child, first, half );
+    distribute( centers, child + 1, first + half, count - half );
+    fitInner( node );
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndex::fitLeaf( int node )
+{
+    Node& leaf = nodes_[ node ];
+    unsigned int const segment = order_[ leaf.first ];
+    leaf.minimum = segmentStarts_[ segment ];
+    leaf.maximum = segmentStarts_[ segment ];
+    leaf.radius = segmentRadii_[ segment ];
+    
+    for ( unsigned int i = leaf.first; i < leaf.first + leaf.count; ++i ) {
+        unsigned int const s = order_[ i ];
+        Vec3 const& a = segmentStarts_[ s ];
+        Vec3 const& b = segmentEnds_[ s ];
+        leaf.minimum.set( std::min( leaf.minimum.x, std::min( a.x, b.x ) ),
+                          std::min( leaf.minimum.y, std::min( a.y, b.y ) ),
+                          std::min( leaf.minimum.z, std::min( a.z, b.z ) ) );
+        leaf.maximum.set( std::max( leaf.maximum.x, std::max( a.x, b.x ) ),
+                          std::max( leaf.maximum.y, std::max( a.y, b.y ) ),
+                          std::max( leaf.maximum.z, std::max( a.z, b.z ) ) );
+        leaf.radius = std::max( leaf.radius, segmentRadii_[ s ] );
+    }
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndex::fitInner( int node )
+{
+    Node& inner = nodes_[ node ];
+    Node const& a = nodes_[ inner.firstChild ];
+    Node const& b = nodes_[ inner.firstChild + 1 ];
+    inner.minimum.set( std::min( a.minimum.x, b.minimum.x ),
+                       std::min( a.minimum.y, b.minimum.y ),
+                       std::min( a.minimum.z, b.minimum.z ) );
+    inner.maximum.set( std::max( a.maximum.x, b.maximum.x ),
+                       std::max( a.maximum.y, b.maximum.y ),
+                       std::max( a.maximum.z, b.maximum.z ) );
+    inner.radius = std::max( a.radius, b.radius );
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndex::refitAncestors( int node )
+{
+    for ( int parent = nodes_[ node ].parent; 0 <= parent; parent = nodes_[ parent ].parent ) {
+        fitInner( parent );
+    }
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndex::refitAll()
+{
+    // Children are always stored behind their parent.
+    for ( size_type i = nodes_.size(); 0 < i; --i ) {
+        int const node = static_cast< int >( i - 1 );
+        if ( nodes_[ node ].firstChild < 0 ) {
+            fitLeaf( node );
+        } else {
+            fitInner( node );
+        }
+    }
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndex::updateSlack()
+{
+    Node const& root = nodes_[ 0 ];
+    float const magnitude = std::abs( root.minimum.x ) + std::abs( root.minimum.y ) + std::abs( root.minimum.z ) +
+                            std::abs( root.maximum.x ) + std::abs( root.maximum.y ) + std::abs( root.maximum.z ) +
+                            std::abs( root.radius );
+    slack_ = 1.0e-5f * ( 1.0f + magnitude );
+    updateView();
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndex::updateView()
+{
+    view_.nodes = nodes_.empty() ? 0 : &nodes_[ 0 ];
+    view_.nodeCount = nodes_.size();
+    view_.order = order_.empty() ? 0 : &order_[ 0 ];
+    view_.segmentCount = segmentStarts_.size();
+    view_.slack = slack_;
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndex::rebuildIfStale( SegmentedPath const& path )
+{
+    // Inserted segments cost every query a test, removed ones only loosen
+    // the boxes.
+    size_type const treeSegments = view_.segmentCount;
+    if ( ( insertedFront_ + insertedBack_ <= 8 + treeSegments / 16 ) &&
+         ( removedFront_ + removedBack_ <= treeSegments / 2 ) ) {
+        return;
+    }
+    
+    std::vector< float > radii( path.segmentCount(), insertedRadius_ );
+    size_type treeSegment = 0;
+    for ( size_type i = 0; i < radii.size(); ++i ) {
+        if ( treeIndex( i, treeSegment ) ) {
+            radii[ i ] = segmentRadii_[ treeSegment ];
+        }
+    }
+    build( path, &radii[ 0 ] );
+}
+
+
+
+bool 
+OpenSteer::SegmentedPathIndex::treeIndex( size_type segmentIndex, size_type& treeSegment ) const
+{
+    size_type const treeSegments = view_.segmentCount - removedFront_ - removedBack_;
+    if ( ( segmentIndex < insertedFront_ ) || ( segmentIndex >= insertedFront_ + treeSegments ) ) {
+        return false;
+    }
+    
+    treeSegment = segmentIndex - insertedFront_ + removedFront_;
+    return true;
+}
@@ -61,6 +61,8 @@
 
 
 #include "OpenSteer/SimpleVehicle.h"
+#include "OpenSteer/Checkpoint.h"
+#include "OpenSteer/PhaseTimer.h"
 #include <algorithm>
 
 
@@ -68,7 +70,7 @@
 // serial numbers  (XXX should this be part of a "OpenSteerDemo vehicle mixin"?)
 
 
-int OpenSteer::SimpleVehicle::serialNumberCounter = 0;
+std::atomic<int> OpenSteer::SimpleVehicle::serialNumberCounter (0);
 
 
 // ----------------------------------------------------------------------------
@@ -82,6 +84,9 @@ OpenSteer::SimpleVehicle::SimpleVehicle (void)
 
     // maintain unique serial numbers
     serialNumber = serialNumberCounter++;
+
+    // each vehicle draws from its own stream of random numbers
+    seedVehicleRandomStream (randomStream(), serialNumber);
 }
 
 
@@ -166,6 +171,11 @@ void
 OpenSteer::SimpleVehicle::applySteeringForce (const Vec3& force,
                                               const float elapsedTime)
 {
+    PhaseTimer::Scope timer (PhaseTimer::applySteeringForcePhase);
+
+    _appliedSteering = force;
+    _appliedSteeringTime = elapsedTime;
+    _steeringApplied = true;
 
     const Vec3 adjustedForce = adjustRawSteeringForce (force, elapsedTime);
 
@@ -290,26 +300,6 @@ OpenSteer::SimpleVehicle::measurePathCurvature (const float elapsedTime)
 }
 
 
-// ----------------------------------------------------------------------------
-// draw lines from vehicle's position showing its velocity and acceleration
-
-
-void 
-OpenSteer::SimpleVehicle::annotationVelocityAcceleration (float maxLengthA, 
-                                                          float maxLengthV)
-{
-    const float desat = 0.4f;
-    const float aScale = maxLengthA / maxForce ();
-    const float vScale = maxLengthV / maxSpeed ();
-    const Vec3& p = position();
-    const Color aColor (desat, desat, 1); // bluish
-    const Color vColor (    1, desat, 1); // pinkish
-
-    annotationLine (p, p + (velocity ()           * vScale), vColor);
-    annotationLine (p, p + (_smoothedAcceleration * aScale), aColor);
-}
-
-
 // ----------------------------------------------------------------------------
 // predict position of this vehicle at some time in the future
 // (assumes velocity remains constant, hence path is a straight line)
@@ -327,4 +317,66 @@ OpenSteer::SimpleVehicle::predictFuturePosition (const float predictionTime) con
 }
 
 
+// ----------------------------------------------------------------------------
+// copy this vehicle's simulation state to/from a checkpoint record
+
+
+void 
+OpenSteer::SimpleVehicle::saveState (CheckpointVehicle& record) const
+{
+    record.side = side ();
+    record.up = up ();
+    record.forward = forward ();
+#ifdef OPENSTEER_COMPACT_LOCAL_SPACE
+    rotation (record.rotation);
+#endif
+    record.position = position ();
+    record.mass = _mass;
+    record.radius = _radius;
+    record.speed = _speed;
+    record.maxForce = _maxForce;
+    record.maxSpeed = _maxSpeed;
+    record.curvature = _curvature;
+    record.smoothedCurvature = _smoothedCurvature;
+    record.lastForward = _lastForward;
+    record.lastPosition = _lastPosition;
+    record.smoothedPosition = _smoothedPosition;
+    record.smoothedAcceleration = _smoothedAcceleration;
+    record.wanderSide = WanderSide;
+    record.wanderUp = WanderUp;
+    record.randomStream = randomStream ();
+}
+
+
+void 
+OpenSteer::SimpleVehicle::restoreState (const CheckpointVehicle& record)
+{
+    // the basis exactly as saved: CompactLocalSpaceMixin from its
+    // rotation, in one set (turning it onto each vector in turn would not
+    // give it back to the bit), LocalSpaceMixin from the vectors it stores
+#ifdef OPENSTEER_COMPACT_LOCAL_SPACE
+    setRotation (record.rotation);
+#else
+    setSide (record.side);
+    setUp (record.up);
+    setForward (record.forward);
+#endif
+    setPosition (record.position);
+    _mass = record.mass;
+    _radius = record.radius;
+    setSpeed (record.speed);
+    _maxForce = record.maxForce;
+    _maxSpeed = record.maxSpeed;
+    _curvature = record.curvature;
+    _smoothedCurvature = record.smoothedCurvature;
+    _lastForward = record.lastForward;
+    _lastPosition = record.lastPosition;
+    _smoothedPosition = record.smoothedPosition;
+    _smoothedAcceleration = record.smoothedAcceleration;
+    WanderSide = record.wanderSide;
+    WanderUp = record.wanderUp;
+    randomStream () = record.randomStream;
+}
+
+
 // ----------------------------------------------------------------------------
@@ -0,0 +1,161 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// SimulationSnapshot
+//
+// See SimulationSnapshot.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/SimulationSnapshot.h"
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::SimulationSnapshot::SimulationSnapshot (void)
+    : selected (-1),
+      plugIn (0),
+      currentTime (0),
+      elapsedTime (0),
+      updateTime (0),
+      stepsPerSecond (0),
+      paused (false),
+      serialNumber (0)
+{
+}
+
+
+void
+OpenSteer::SimulationSnapshot::clear (void)
+{
+    vehicles.clear ();
+    lines.clear ();
+    circles.clear ();
+    selected = -1;
+}
+
+
+void
+OpenSteer::SimulationSnapshot::captureVehicles (const AVGroup& group,
+                                                const AbstractVehicle* selectedVehicle)
+{
+    selected = -1;
+    vehicles.resize (group.size ());
+    for (size_t i = 0; i < group.size (); i++)
+    {
+        const AbstractVehicle& v = *group[i];
+        Vehicle& record = vehicles[i];
+        record.side = v.side ();
+        record.up = v.up ();
+        record.forward = v.forward ();
+        record.position = v.position ();
+        record.radius = v.radius ();
+        record.speed = v.speed ();
+        if (&v == selectedVehicle) selected = (int) i;
+    }
+}
+
+
+void
+OpenSteer::SimulationSnapshot::addLine (const Vec3& startPoint,
+                                        const Vec3& endPoint,
+                                        const Color& color)
+{
+    lines.push_back (Line ());
+    Line& line = lines.back ();
+    line.startPoint = startPoint;
+    line.endPoint = endPoint;
+    line.color = color;
+}
+
+
+void
+OpenSteer::SimulationSnapshot::addCircleOrDisk (const float radius,
+                                                const Vec3& axis,
+                                                const Vec3& center,
+                                                const Color& color,
+                                                const int segments,
+                                                const bool filled,
+                                                const bool in3d)
+{
+    circles.push_back (CircleOrDisk ());
+    CircleOrDisk& circle = circles.back ();
+    circle.radius = radius;
+    circle.axis = axis;
+    circle.center = center;
+    circle.color = color;
+    circle.segments = segments;
+    circle.filled = filled;
+    circle.in3d = in3d;
+}
+
+
+// ----------------------------------------------------------------------------
+// the three buffers change roles by swapping indices: the writer owns
+// back, the reader owns front, and "middle" holds the third one's index
+// plus a flag telling whether it is newer than the reader's
+
+
+const int OpenSteer::SnapshotTripleBuffer::fresh;
+
+
+OpenSteer::SnapshotTripleBuffer::SnapshotTripleBuffer (void)
+    : backIndex (0),
+      frontIndex (1),
+      middle (2),
+      published (0)
+{
+}
+
+
+void
+OpenSteer::SnapshotTripleBuffer::publish (void)
+{
+    buffers[backIndex].serialNumber = ++published;
+    const int previous = middle.exchange (backIndex | fresh,
+                                          std::memory_order_acq_rel);
+    backIndex = previous & ~fresh;
+}
+
+
+bool
+OpenSteer::SnapshotTripleBuffer::acquire (void)
+{
+    if (! (middle.load (std::memory_order_relaxed) & fresh)) return false;
+    const int previous = middle.exchange (frontIndex,
+                                          std::memory_order_acq_rel);
+    frontIndex = previous & ~fresh;
+    return true;
+}
+
+
+// ----------------------------------------------------------------------------
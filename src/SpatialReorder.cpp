@@ -0,0 +1,214 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// SpatialReorder
+//
+// See SpatialReorder.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/SpatialReorder.h"
+
+#include <algorithm>
+
+
+// ----------------------------------------------------------------------------
+// Morton codes
+
+
+namespace {
+
+    // spread the low 21 bits of x to every third bit
+    uint64_t spreadBits (uint64_t x)
+    {
+        x &= 0x1fffff;
+        x = (x | (x << 32)) & 0x1f00000000ffffULL;
+        x = (x | (x << 16)) & 0x1f0000ff0000ffULL;
+        x = (x | (x << 8))  & 0x100f00f00f00f00fULL;
+        x = (x | (x << 4))  & 0x10c30c30c30c30c3ULL;
+        x = (x | (x << 2))  & 0x1249249249249249ULL;
+        return x;
+    }
+
+    // a coordinate quantized to 21 bits over [low, high]: the range is
+    // split into 2^21 equal cells, the high end falling in the last one
+    uint64_t quantize (const float value, const float low, const float high)
+    {
+        const float cells = 2097152.0f;
+        if (! (high > low)) return 0;
+        const float t = (value - low) / (high - low) * cells;
+        if (! (t > 0)) return 0;
+        if (t >= cells - 1) return 0x1fffff;
+        return (uint64_t) t;
+    }
+
+} // anonymous namespace
+
+
+uint64_t 
+OpenSteer::mortonCode (const Vec3& point,
+                       const Vec3& minCorner,
+                       const Vec3& maxCorner)
+{
+    return ((spreadBits (quantize (point.x, minCorner.x, maxCorner.x))) |
+            (spreadBits (quantize (point.y, minCorner.y, maxCorner.y)) << 1) |
+            (spreadBits (quantize (point.z, minCorner.z, maxCorner.z)) << 2));
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::SpatialReorder::SpatialReorder (void)
+    : _period (0),
+      _passFrames (1),
+      framesSincePass (0),
+      inProgress (false),
+      nextIndex (0),
+      perFrame (0),
+      passes (0),
+      exchangesSoFar (0)
+{
+}
+
+
+void 
+OpenSteer::SpatialReorder::setSchedule (const int period, const int passFrames)
+{
+    _period = (period > 0) ? period : 0;
+    _passFrames = (passFrames > 0) ? passFrames : 1;
+    framesSincePass = 0;
+}
+
+
+bool 
+OpenSteer::SpatialReorder::beginFrame (const size_t count)
+{
+    planned.clear ();
+    if (inProgress && (count != order.size()))
+    {
+        // the frame the population changed is not counted toward the next
+        // pass, which is then one full period later
+        cancel ();
+        return false;
+    }
+
+    if (inProgress)
+    {
+        planExchanges ();
+        return false;
+    }
+
+    if (_period == 0) return false;
+    return (++framesSincePass >= _period) && (count > 1);
+}
+
+
+void 
+OpenSteer::SpatialReorder::beginPass (const Vec3* positions, const size_t count)
+{
+    planned.clear ();
+    framesSincePass = 0;
+    if (count < 2) return;
+
+    // the positions' bounding box
+    Vec3 minCorner = positions[0];
+    Vec3 maxCorner = positions[0];
+    for (size_t i = 1; i < count; i++)
+    {
+        const Vec3& p = positions[i];
+        minCorner.set (minXXX (minCorner.x, p.x), minXXX (minCorner.y, p.y),
+                       minXXX (minCorner.z, p.z));
+        maxCorner.set (maxXXX (maxCorner.x, p.x), maxXXX (maxCorner.y, p.y),
+                       maxXXX (maxCorner.z, p.z));
+    }
+
+    // sorted by code, ties in their current order
+    std::vector<std::pair<uint64_t, size_t> > keys (count);
+    for (size_t i = 0; i < count; i++)
+        keys[i] = std::make_pair (mortonCode (positions[i], minCorner, maxCorner), i);
+    std::sort (keys.begin(), keys.end());
+
+    order.resize (count);
+    vehicleAt.resize (count);
+    indexOf.resize (count);
+    for (size_t i = 0; i < count; i++)
+    {
+        order[i] = keys[i].second;
+        vehicleAt[i] = i;
+        indexOf[i] = i;
+    }
+    nextIndex = 0;
+    perFrame = (count + _passFrames - 1) / _passFrames;
+    inProgress = true;
+    planExchanges ();
+}
+
+
+void 
+OpenSteer::SpatialReorder::cancel (void)
+{
+    inProgress = false;
+    framesSincePass = 0;
+    planned.clear ();
+}
+
+
+// settle the next perFrame indices, each by at most one exchange
+
+
+void 
+OpenSteer::SpatialReorder::planExchanges (void)
+{
+    const size_t end = std::min (nextIndex + perFrame, order.size());
+    for (size_t k = nextIndex; k < end; k++)
+    {
+        const size_t vehicle = order[k];
+        const size_t j = indexOf[vehicle];
+        if (j == k) continue;
+
+        // the vehicle at k moves to j
+        const size_t displaced = vehicleAt[k];
+        vehicleAt[k] = vehicle;
+        vehicleAt[j] = displaced;
+        indexOf[vehicle] = k;
+        indexOf[displaced] = j;
+        planned.push_back (Exchange (k, j));
+    }
+    exchangesSoFar += planned.size();
+    nextIndex = end;
+
+    if (nextIndex == order.size())
+    {
+        inProgress = false;
+        passes++;
+    }
+}
@@ -0,0 +1,365 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// SteeringLog
+//
+// See SteeringLog.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/SteeringLog.h"
+#include "OpenSteer/SimpleVehicle.h"
+
+#include <cstring>
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+
+    // start of every log
+    struct LogHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+    };
+
+    const char logMagic[8] = {'O', 'S', 'T', 'E', 'E', 'R', 'S', 'L'};
+    const uint32_t byteOrderMark = 0x01020304;
+
+
+    // start of every chunk, followed by "size" bytes
+    struct ChunkHeader
+    {
+        uint32_t kind;
+        uint32_t vehicleCount;
+        float currentTime;
+        uint32_t size;
+    };
+
+    const uint32_t frameChunk = 1;
+    const uint32_t keyframeChunk = 2;
+
+    // bit of a frame chunk's per vehicle flag byte
+    const unsigned char steeringApplied = 1;
+
+
+    uint32_t floatBits (const float f)
+    {
+        uint32_t bits;
+        memcpy (&bits, &f, sizeof (bits));
+        return bits;
+    }
+
+
+    float bitsFloat (const uint32_t bits)
+    {
+        float f;
+        memcpy (&f, &bits, sizeof (f));
+        return f;
+    }
+
+
+    // 7 bits per byte, lowest first, high bit set on all but the last
+    void appendVarint (std::vector<unsigned char>& bytes, uint32_t value)
+    {
+        while (value >= 0x80)
+        {
+            bytes.push_back ((unsigned char) (value | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back ((unsigned char) value);
+    }
+
+
+    bool readVarint (const unsigned char*& p,
+                     const unsigned char* end,
+                     uint32_t& value)
+    {
+        value = 0;
+        for (int shift = 0; (shift < 35) && (p < end); shift += 7)
+        {
+            const unsigned char byte = *p++;
+            value |= (uint32_t) (byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+
+    // XOR the float bits with those of the previous values and update them
+    void encodeDelta (std::vector<unsigned char>& bytes,
+                      uint32_t* previous,
+                      const float* values)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            const uint32_t bits = floatBits (values[i]);
+            appendVarint (bytes, bits ^ previous[i]);
+            previous[i] = bits;
+        }
+    }
+
+
+    bool decodeDelta (const unsigned char*& p,
+                      const unsigned char* end,
+                      uint32_t* previous,
+                      float* values)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            uint32_t delta;
+            if (! readVarint (p, end, delta)) return false;
+            previous[i] ^= delta;
+            values[i] = bitsFloat (previous[i]);
+        }
+        return true;
+    }
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::SteeringRecorder::SteeringRecorder (void)
+    : keyframeInterval (0), frames (0)
+{
+}
+
+
+bool 
+OpenSteer::SteeringRecorder::open (const char* fileName,
+                                   const AVGroup& vehicles,
+                                   const size_t interval)
+{
+    close ();
+    file.open (fileName, std::ios::binary | std::ios::trunc);
+    if (! file) return false;
+
+    LogHeader header;
+    memcpy (header.magic, logMagic, sizeof (logMagic));
+    header.version = version;
+    header.byteOrder = byteOrderMark;
+    file.write ((const char*) &header, sizeof (header));
+
+    keyframeInterval = interval;
+    frames = 0;
+    if (writeKeyframe (vehicles, 0)) return true;
+    close ();
+    return false;
+}
+
+
+void 
+OpenSteer::SteeringRecorder::close (void)
+{
+    if (file.is_open ()) file.close ();
+    file.clear ();
+    previous.clear ();
+}
+
+
+bool 
+OpenSteer::SteeringRecorder::recordFrame (const AVGroup& vehicles,
+                                          const float currentTime)
+{
+    if (! isOpen ()) return false;
+    frames++;
+
+    // a new population: its forces could not be replayed from the old
+    // one's state, so record where it ended up instead
+    if (vehicles.size () * 4 != previous.size ())
+        return writeKeyframe (vehicles, currentTime);
+
+    chunk.clear ();
+    for (size_t i = 0; i < vehicles.size (); i++)
+    {
+        SimpleVehicle* v = dynamic_cast<SimpleVehicle*> (vehicles[i]);
+        Vec3 force;
+        float elapsedTime;
+        if (v && v->takeAppliedSteering (force, elapsedTime))
+        {
+            const float values[4] = {force.x, force.y, force.z, elapsedTime};
+            chunk.push_back (steeringApplied);
+            encodeDelta (chunk, &previous[i * 4], values);
+        }
+        else
+        {
+            chunk.push_back (0);
+        }
+    }
+
+    ChunkHeader header = {frameChunk, (uint32_t) vehicles.size (),
+                          currentTime, (uint32_t) chunk.size ()};
+    file.write ((const char*) &header, sizeof (header));
+    if (! chunk.empty ()) file.write ((const char*) &chunk[0], chunk.size ());
+
+    if ((keyframeInterval > 0) && (frames % keyframeInterval == 0))
+        return writeKeyframe (vehicles, currentTime);
+    return file.good ();
+}
+
+
+bool 
+OpenSteer::SteeringRecorder::writeKeyframe (const AVGroup& vehicles,
+                                            const float currentTime)
+{
+    states.resize (vehicles.size ());
+    for (size_t i = 0; i < vehicles.size (); i++)
+    {
+        SimpleVehicle* v = dynamic_cast<SimpleVehicle*> (vehicles[i]);
+        if (v)
+        {
+            v->saveState (states[i]);
+
+            // forces applied before the keyframe are part of its state
+            Vec3 force;
+            float elapsedTime;
+            v->takeAppliedSteering (force, elapsedTime);
+        }
+        else
+        {
+            states[i] = CheckpointVehicle ();
+        }
+    }
+
+    // deltas start over at each keyframe
+    previous.assign (vehicles.size () * 4, 0);
+
+    const uint32_t size = (uint32_t) (states.size () * sizeof (CheckpointVehicle));
+    ChunkHeader header = {keyframeChunk, (uint32_t) states.size (),
+                          currentTime, size};
+    file.write ((const char*) &header, sizeof (header));
+    if (size > 0) file.write ((const char*) &states[0], size);
+    return file.good ();
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::SteeringReplayer::SteeringReplayer (void)
+    : time (0), frames (0)
+{
+}
+
+
+bool 
+OpenSteer::SteeringReplayer::open (const char* fileName)
+{
+    close ();
+    file.open (fileName, std::ios::binary);
+    LogHeader header;
+    if (file.read ((char*) &header, sizeof (header)) &&
+        (memcmp (header.magic, logMagic, sizeof (logMagic)) == 0) &&
+        (header.version == SteeringRecorder::version) &&
+        (header.byteOrder == byteOrderMark))
+        return true;
+    close ();
+    return false;
+}
+
+
+void 
+OpenSteer::SteeringReplayer::close (void)
+{
+    if (file.is_open ()) file.close ();
+    file.clear ();
+    time = 0;
+    frames = 0;
+    previous.clear ();
+}
+
+
+bool 
+OpenSteer::SteeringReplayer::atEnd (void)
+{
+    return ! isOpen () || (file.peek () == std::ifstream::traits_type::eof ());
+}
+
+
+bool 
+OpenSteer::SteeringReplayer::replayFrame (const AVGroup& vehicles)
+{
+    if (! isOpen ()) return false;
+
+    for (;;)
+    {
+        ChunkHeader header;
+        if (! file.read ((char*) &header, sizeof (header))) return false;
+        if (header.vehicleCount != vehicles.size ()) return false;
+        chunk.resize (header.size);
+        if ((header.size > 0) && ! file.read ((char*) &chunk[0], header.size))
+            return false;
+
+        if (header.kind == keyframeChunk)
+        {
+            if (header.size != vehicles.size () * sizeof (CheckpointVehicle))
+                return false;
+            states.resize (vehicles.size ());
+            if (header.size > 0) memcpy (&states[0], &chunk[0], header.size);
+            for (size_t i = 0; i < vehicles.size (); i++)
+            {
+                SimpleVehicle* v = dynamic_cast<SimpleVehicle*> (vehicles[i]);
+                if (v) v->restoreState (states[i]);
+            }
+            previous.assign (vehicles.size () * 4, 0);
+            time = header.currentTime;
+            continue;
+        }
+
+        if ((header.kind != frameChunk) ||
+            (previous.size () != vehicles.size () * 4))
+            return false;
+
+        const unsigned char* p = chunk.empty () ? 0 : &chunk[0];
+        const unsigned char* end = p + chunk.size ();
+        for (size_t i = 0; i < vehicles.size (); i++)
+        {
+            if (p >= end) return false;
+            if ((*p++ & steeringApplied) == 0) continue;
+            float values[4];
+            if (! decodeDelta (p, end, &previous[i * 4], values)) return false;
+            SimpleVehicle* v = dynamic_cast<SimpleVehicle*> (vehicles[i]);
+            if (v) v->applySteeringForce (Vec3 (values[0], values[1], values[2]),
+                                          values[3]);
+        }
+        time = header.currentTime;
+        frames++;
+        return true;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
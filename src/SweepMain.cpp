@@ -0,0 +1,596 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// ----------------------------------------------------------------------------
+//
+//
+// Sweep: runs a PlugIn headless over a grid of parameter settings
+//
+// Each combination of the given parameter values (see
+// AbstractPlugIn::setParameter) and population sizes is one run: the
+// PlugIn is opened from a fixed random seed, given the run's parameters
+// and population, and stepped for a number of frames at a fixed time
+// step.  Every run starts from the same seed, so runs differ only in
+// their settings.  Results are written one line per run, as CSV (with a
+// header line) or as JSON objects ("JSON lines"):
+//
+//   seconds          wall time of the run's steps
+//   steps_per_sec    frames over that
+//   neighbors_*      neighbors per vehicle (see neighborStatistics): the
+//                    least and most in any frame, and the mean over frames
+//                    of the per frame average, for PlugIns counting them
+//   collisions       pairs of vehicles closer than the sum of their radii
+//                    after a step, summed over the frames (so a pair
+//                    overlapping for ten frames counts ten)
+//
+// PlugIns which can run in Worlds (see World.h) have every run in a World
+// of its own, the runs spread over the worker pool one at a time, so the
+// wall times of concurrent runs share the machine.  Other PlugIns run one
+// after another as OpenSteerDemo's selected PlugIn.  PlugIns with a fixed
+// population run at their own size whatever the sizes asked for.
+//
+// usage: OpenSteerSweep --plugin name [--param name=v,v,...]...
+//                       [--sizes n,n,...] [--frames n] [--dt seconds]
+//                       [--seed n] [--threads n] [--format csv|json]
+//                       [--output file]
+//
+// for example:
+//
+//   OpenSteerSweep --plugin Boids --param separationWeight=6,12,24
+//                  --param cohesionRadius=6,9 --sizes 200,1000
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/OpenSteerDemo.h"
+#include "OpenSteer/Annotation.h"
+#include "OpenSteer/Clock.h"
+#include "OpenSteer/PlugIn.h"
+#include "OpenSteer/SimpleVehicle.h"
+#include "OpenSteer/WorkerPool.h"
+#include "OpenSteer/World.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+
+    // ------------------------------------------------------------------------
+    // sweep settings, from the command line
+
+
+    // a parameter and the values it takes
+    struct SweptParameter
+    {
+        std::string name;
+        std::vector<float> values;
+    };
+
+    const char* plugInName = NULL;
+    std::vector<SweptParameter> parameters;
+    std::vector<int> populationSizes;
+    int frameCount = 100;
+    float stepSize = 1.0f / 60.0f;
+    unsigned int seed = 1;
+    bool writeJson = false;
+    const char* outputFileName = NULL;
+
+
+    // ------------------------------------------------------------------------
+    // one combination of settings, and what running it measured
+
+
+    struct Run
+    {
+        Run (void)
+            : population (0), unknownParameter (-1), vehicleCount (0),
+              seconds (0), countsNeighbors (false),
+              minNeighbors (0), maxNeighbors (0), meanNeighbors (0),
+              collisions (0) {}
+
+        // a value of each swept parameter, and the population (zero: the
+        // PlugIn's own)
+        std::vector<float> values;
+        int population;
+
+        // index of a parameter the PlugIn does not have, or -1
+        int unknownParameter;
+
+        size_t vehicleCount;
+        double seconds;
+        bool countsNeighbors;
+        int minNeighbors;
+        int maxNeighbors;
+        double meanNeighbors;
+        size_t collisions;
+    };
+
+
+    // every combination of the swept values and population sizes, the
+    // first parameter varying slowest and the population fastest
+
+
+    std::vector<Run> allRuns (void)
+    {
+        std::vector<Run> runs;
+        std::vector<size_t> digits (parameters.size(), 0);
+        for (;;)
+        {
+            Run run;
+            for (size_t p = 0; p < parameters.size(); p++)
+                run.values.push_back (parameters[p].values[digits[p]]);
+            for (size_t s = 0; s < populationSizes.size(); s++)
+            {
+                run.population = populationSizes[s];
+                runs.push_back (run);
+            }
+            if (populationSizes.empty ()) runs.push_back (run);
+
+            // next combination, counting the digits from the last
+            size_t p = parameters.size();
+            while ((p > 0) &&
+                   (++digits[p - 1] == parameters[p - 1].values.size()))
+                digits[--p] = 0;
+            if (p == 0) return runs;
+        }
+    }
+
+
+    // ------------------------------------------------------------------------
+    // number of pairs of vehicles closer than the sum of their radii: sweep
+    // along x, comparing each vehicle only with those after it within the
+    // largest such sum
+
+
+    struct Disc
+    {
+        Vec3 center;
+        float radius;
+        bool operator< (const Disc& other) const
+            {return center.x < other.center.x;}
+    };
+
+
+    size_t countCollisions (const AVGroup& vehicles)
+    {
+        std::vector<Disc> discs (vehicles.size());
+        float maxRadius = 0;
+        for (size_t i = 0; i < vehicles.size(); i++)
+        {
+            discs[i].center = vehicles[i]->position ();
+            discs[i].radius = vehicles[i]->radius ();
+            maxRadius = std::max (maxRadius, discs[i].radius);
+        }
+        std::sort (discs.begin(), discs.end());
+
+        size_t collisions = 0;
+        for (size_t i = 0; i < discs.size(); i++)
+        {
+            const float reach = discs[i].center.x + discs[i].radius + maxRadius;
+            for (size_t j = i + 1; (j < discs.size()) && (discs[j].center.x < reach); j++)
+            {
+                const float r = discs[i].radius + discs[j].radius;
+                if ((discs[j].center - discs[i].center).lengthSquared () < r * r)
+                    collisions++;
+            }
+        }
+        return collisions;
+    }
+
+
+    // ------------------------------------------------------------------------
+    // OpenSteerDemo's selected PlugIn, seen as a World (for PlugIns which
+    // cannot run in one)
+
+
+    class SelectedPlugIn
+    {
+    public:
+        SelectedPlugIn (PlugIn& p) : pi (p), time (0) {}
+
+        void open (void)
+        {
+            setRandomSeed (seed);
+            SimpleVehicle::serialNumberCounter = 0;
+            OpenSteerDemo::selectedPlugIn = &pi;
+            OpenSteerDemo::openSelectedPlugIn ();
+            time = 0;
+        }
+
+        void step (const float elapsedTime)
+        {
+            time += elapsedTime;
+            OpenSteerDemo::updateSelectedPlugIn (time, elapsedTime);
+        }
+
+        void close (void) {OpenSteerDemo::closeSelectedPlugIn ();}
+
+        bool setPopulation (const int count) {return pi.setPopulation (count);}
+        bool setParameter (const char* name, const float value)
+            {return pi.setParameter (name, value);}
+
+        AbstractPlugIn& plugIn (void) {return pi;}
+        const AVGroup& allVehicles (void) {return pi.allVehicles ();}
+
+    private:
+        PlugIn& pi;
+        float time;
+    };
+
+
+    // ------------------------------------------------------------------------
+    // open a simulation (a World or a SelectedPlugIn), apply a run's
+    // settings, step it while measuring, and close it
+
+
+    template <class Simulation>
+    void measure (Simulation& simulation, Run& run)
+    {
+        simulation.open ();
+        for (size_t p = 0; p < parameters.size(); p++)
+        {
+            if (! simulation.setParameter (parameters[p].name.c_str (),
+                                           run.values[p]))
+            {
+                run.unknownParameter = (int) p;
+                simulation.close ();
+                return;
+            }
+        }
+        if (run.population > 0) simulation.setPopulation (run.population);
+
+        Clock clock;
+        double neighborTotal = 0;
+        for (int i = 0; i < frameCount; i++)
+        {
+            const float start = clock.realTimeSinceFirstClockUpdate ();
+            simulation.step (stepSize);
+            run.seconds += clock.realTimeSinceFirstClockUpdate () - start;
+
+            int minimum, maximum;
+            float average;
+            if (simulation.plugIn().neighborStatistics (minimum, maximum,
+                                                        average))
+            {
+                if (! run.countsNeighbors || (run.minNeighbors > minimum))
+                    run.minNeighbors = minimum;
+                if (! run.countsNeighbors || (run.maxNeighbors < maximum))
+                    run.maxNeighbors = maximum;
+                run.countsNeighbors = true;
+                neighborTotal += average;
+            }
+
+            run.collisions += countCollisions (simulation.allVehicles ());
+        }
+        run.meanNeighbors = neighborTotal / frameCount;
+        run.vehicleCount = simulation.allVehicles().size();
+        simulation.close ();
+    }
+
+
+    // loop body running runs in Worlds of their own
+
+
+    class WorldRuns
+    {
+    public:
+        WorldRuns (PlugIn& p, std::vector<Run>& r) : pi (p), runs (r) {}
+
+        void operator() (size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                World world (pi, seed);
+                measure (world, runs[i]);
+            }
+        }
+
+    private:
+        PlugIn& pi;
+        std::vector<Run>& runs;
+    };
+
+
+    // ------------------------------------------------------------------------
+    // write a string as a JSON string literal
+
+
+    std::string jsonString (const char* s)
+    {
+        std::string result ("\"");
+        for (const char* c = s; *c; c++)
+        {
+            if ((*c == '"') || (*c == '\\')) result += '\\';
+            result += *c;
+        }
+        return result + "\"";
+    }
+
+
+    void writeCsvHeader (std::ostream& os)
+    {
+        os << "plugin";
+        for (size_t p = 0; p < parameters.size(); p++)
+            os << "," << parameters[p].name;
+        os << ",vehicles,seed,dt,frames,seconds,steps_per_sec"
+           << ",neighbors_min,neighbors_max,neighbors_mean,collisions"
+           << std::endl;
+    }
+
+
+    void writeRun (std::ostream& os, const Run& run)
+    {
+        const double stepsPerSecond =
+            (run.seconds > 0) ? frameCount / run.seconds : 0;
+
+        if (! writeJson)
+        {
+            os << plugInName;
+            for (size_t p = 0; p < parameters.size(); p++)
+                os << "," << run.values[p];
+            os << "," << run.vehicleCount
+               << "," << seed
+               << "," << stepSize
+               << "," << frameCount
+               << "," << run.seconds
+               << "," << stepsPerSecond;
+            if (run.countsNeighbors)
+                os << "," << run.minNeighbors
+                   << "," << run.maxNeighbors
+                   << "," << run.meanNeighbors;
+            else
+                os << ",,,";
+            os << "," << run.collisions << std::endl;
+            return;
+        }
+
+        os << "{\"plugin\":" << jsonString (plugInName)
+           << ",\"parameters\":{";
+        for (size_t p = 0; p < parameters.size(); p++)
+            os << (p ? "," : "") << jsonString (parameters[p].name.c_str ())
+               << ":" << run.values[p];
+        os << "}"
+           << ",\"vehicles\":" << run.vehicleCount
+           << ",\"seed\":" << seed
+           << ",\"dt\":" << stepSize
+           << ",\"frames\":" << frameCount
+           << ",\"seconds\":" << run.seconds
+           << ",\"steps_per_sec\":" << stepsPerSecond;
+        if (run.countsNeighbors)
+            os << ",\"neighbors_min\":" << run.minNeighbors
+               << ",\"neighbors_max\":" << run.maxNeighbors
+               << ",\"neighbors_mean\":" << run.meanNeighbors;
+        os << ",\"collisions\":" << run.collisions << "}" << std::endl;
+    }
+
+
+    // ------------------------------------------------------------------------
+    // parse "name=v,v,..." and a comma separated list of population sizes
+
+
+    bool parseParameter (const char* setting)
+    {
+        const char* equals = strchr (setting, '=');
+        if ((equals == NULL) || (equals == setting)) return false;
+
+        SweptParameter parameter;
+        parameter.name.assign (setting, equals);
+        std::istringstream is (equals + 1);
+        std::string item;
+        while (std::getline (is, item, ','))
+        {
+            char* end;
+            const float value = strtof (item.c_str (), &end);
+            if (item.empty () || (*end != 0)) return false;
+            parameter.values.push_back (value);
+        }
+        if (parameter.values.empty ()) return false;
+        parameters.push_back (parameter);
+        return true;
+    }
+
+
+    bool parseSizes (const char* list)
+    {
+        populationSizes.clear ();
+        std::istringstream is (list);
+        std::string item;
+        while (std::getline (is, item, ','))
+        {
+            const int size = atoi (item.c_str ());
+            if (size <= 0) return false;
+            populationSizes.push_back (size);
+        }
+        return ! populationSizes.empty ();
+    }
+
+
+    void printUsage (const char* programName)
+    {
+        std::cerr << "usage: " << programName
+                  << " --plugin name [--param name=v,v,...]..."
+                  << " [--sizes n,n,...] [--frames n] [--dt seconds]"
+                  << " [--seed n] [--threads n] [--format csv|json]"
+                  << " [--output file]" << std::endl;
+    }
+
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+int main (int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const bool hasValue = (i + 1) < argc;
+
+        if (hasValue && (strcmp (argv[i], "--plugin") == 0))
+        {
+            plugInName = argv[++i];
+        }
+        else if (hasValue && (strcmp (argv[i], "--param") == 0))
+        {
+            if (! parseParameter (argv[++i]))
+            {
+                std::cerr << "bad parameter setting " << argv[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (hasValue && (strcmp (argv[i], "--sizes") == 0))
+        {
+            if (! parseSizes (argv[++i]))
+            {
+                std::cerr << "bad population size list" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (hasValue && (strcmp (argv[i], "--frames") == 0))
+        {
+            frameCount = atoi (argv[++i]);
+        }
+        else if (hasValue && (strcmp (argv[i], "--dt") == 0))
+        {
+            stepSize = (float) atof (argv[++i]);
+        }
+        else if (hasValue && (strcmp (argv[i], "--seed") == 0))
+        {
+            seed = (unsigned int) strtoul (argv[++i], NULL, 10);
+        }
+        else if (hasValue && (strcmp (argv[i], "--threads") == 0))
+        {
+            WorkerPool::shared().setThreadCount (atoi (argv[++i]));
+        }
+        else if (hasValue && (strcmp (argv[i], "--format") == 0))
+        {
+            const char* format = argv[++i];
+            if (strcmp (format, "json") == 0)
+                writeJson = true;
+            else if (strcmp (format, "csv") == 0)
+                writeJson = false;
+            else
+            {
+                printUsage (argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (hasValue && (strcmp (argv[i], "--output") == 0))
+        {
+            outputFileName = argv[++i];
+        }
+        else
+        {
+            printUsage (argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (plugInName == NULL)
+    {
+        printUsage (argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if ((frameCount <= 0) || (stepSize <= 0))
+    {
+        std::cerr << "frame count and time step must be positive" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    PlugIn* pi = PlugIn::findByName (plugInName);
+    if (pi == NULL)
+    {
+        std::cerr << "no PlugIn named \"" << plugInName << "\"" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // nothing is drawn; annotation would distort the timings (and is not
+    // thread-safe)
+    setAnnotationOff ();
+
+    // the clock's base time, before the runs read it concurrently
+    Clock clock;
+    const float startTime = clock.realTimeSinceFirstClockUpdate ();
+
+    std::vector<Run> runs = allRuns ();
+    const World probe (*pi, seed);
+    if (probe.isValid ())
+    {
+        WorldRuns body (*pi, runs);
+        WorkerPool::shared().parallelFor (runs.size(), body, 1);
+    }
+    else
+    {
+        SelectedPlugIn selected (*pi);
+        for (size_t i = 0; i < runs.size(); i++) measure (selected, runs[i]);
+    }
+
+    const float wallTime = clock.realTimeSinceFirstClockUpdate () - startTime;
+
+    for (size_t i = 0; i < runs.size(); i++)
+    {
+        if (runs[i].unknownParameter >= 0)
+        {
+            std::cerr << *pi << " has no parameter named \""
+                      << parameters[runs[i].unknownParameter].name << "\""
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::ofstream file;
+    if (outputFileName) file.open (outputFileName);
+    std::ostream& os = outputFileName ? file : std::cout;
+    if (! writeJson) writeCsvHeader (os);
+    for (size_t i = 0; i < runs.size(); i++) writeRun (os, runs[i]);
+    if (outputFileName && ! file)
+    {
+        std::cerr << "cannot write " << outputFileName << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cerr << runs.size () << " runs on "
+              << WorkerPool::shared().threadCount () << " threads in "
+              << wallTime << " seconds" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,298 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Telemetry
+//
+// See Telemetry.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/Telemetry.h"
+
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+
+    const char telemetryMagic[8] = {'O', 'S', 'T', 'E', 'E', 'R', 'T', 'M'};
+
+
+    // shared memory object names start with a slash
+    std::string sharedMemoryName (const char* name)
+    {
+        return (name[0] == '/') ? std::string (name) : "/" + std::string (name);
+    }
+
+
+    // slots start on cache line boundaries
+    uint64_t slotSizeFor (const size_t capacity)
+    {
+        const uint64_t bytes = sizeof (TelemetrySlot) +
+                               capacity * sizeof (TelemetryRecord);
+        return (bytes + 63) & ~(uint64_t) 63;
+    }
+
+
+    TelemetrySlot* slotOf (const TelemetryHeader* header, const uint64_t frame)
+    {
+        char* slots = (char*) header + sizeof (TelemetryHeader);
+        return (TelemetrySlot*)
+            (slots + (frame % header->slotCount) * header->slotSize);
+    }
+
+
+    TelemetryRecord* recordsOf (TelemetrySlot* slot)
+    {
+        return (TelemetryRecord*) ((char*) slot + sizeof (TelemetrySlot));
+    }
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::TelemetryWriter::TelemetryWriter (void)
+    : header (0), mappedSize (0), frames (0)
+{
+}
+
+
+OpenSteer::TelemetryWriter::~TelemetryWriter ()
+{
+    close ();
+}
+
+
+bool 
+OpenSteer::TelemetryWriter::open (const char* streamName,
+                                  const size_t capacity,
+                                  const size_t slotCount)
+{
+    close ();
+    if ((capacity == 0) || (slotCount == 0)) return false;
+
+#ifndef _WIN32
+    const std::string shmName = sharedMemoryName (streamName);
+    const uint64_t slotSize = slotSizeFor (capacity);
+    const size_t size = sizeof (TelemetryHeader) + slotCount * slotSize;
+
+    // a new object each time, so readers of an older stream of the same
+    // name keep their own mapping of it
+    shm_unlink (shmName.c_str ());
+    const int object = shm_open (shmName.c_str (), O_CREAT | O_EXCL | O_RDWR,
+                                 0644);
+    if (object < 0) return false;
+    void* m = MAP_FAILED;
+    if (ftruncate (object, size) == 0)
+        m = mmap (0, size, PROT_READ | PROT_WRITE, MAP_SHARED, object, 0);
+    ::close (object);
+    if (m == MAP_FAILED)
+    {
+        shm_unlink (shmName.c_str ());
+        return false;
+    }
+
+    // the object starts zero filled: every slot's sequence number is 0 and
+    // latestFrame is 0.  The magic goes in last, readers check it first.
+    header = (TelemetryHeader*) m;
+    mappedSize = size;
+    name = shmName;
+    frames = 0;
+    header->version = version;
+    header->slotCount = (uint32_t) slotCount;
+    header->capacity = (uint32_t) capacity;
+    header->recordSize = sizeof (TelemetryRecord);
+    header->slotSize = slotSize;
+    std::atomic_thread_fence (std::memory_order_release);
+    memcpy (header->magic, telemetryMagic, sizeof (telemetryMagic));
+    return true;
+#else
+    (void) streamName;
+    return false;
+#endif
+}
+
+
+void 
+OpenSteer::TelemetryWriter::close (void)
+{
+#ifndef _WIN32
+    if (header == 0) return;
+    munmap (header, mappedSize);
+    shm_unlink (name.c_str ());
+    header = 0;
+    mappedSize = 0;
+    name.clear ();
+#endif
+}
+
+
+void 
+OpenSteer::TelemetryWriter::publish (const AVGroup& vehicles,
+                                     const float currentTime)
+{
+    if (header == 0) return;
+
+    const uint64_t frame = ++frames;
+    TelemetrySlot* slot = slotOf (header, frame);
+
+    // odd while the slot is being written, see TelemetryReader::readFrame
+    slot->sequence.store (2 * frame - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_release);
+
+    const size_t count = (vehicles.size () < header->capacity) ?
+                         vehicles.size () : header->capacity;
+    TelemetryRecord* records = recordsOf (slot);
+    for (size_t i = 0; i < count; i++)
+    {
+        const AbstractVehicle& v = *vehicles[i];
+        records[i].position = v.position ();
+        records[i].velocity = v.velocity ();
+        records[i].forward = v.forward ();
+    }
+    slot->vehicleCount = (uint32_t) count;
+    slot->currentTime = currentTime;
+
+    slot->sequence.store (2 * frame, std::memory_order_release);
+    header->latestFrame.store (frame, std::memory_order_release);
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::TelemetryReader::TelemetryReader (void)
+    : header (0), mappedSize (0)
+{
+}
+
+
+OpenSteer::TelemetryReader::~TelemetryReader ()
+{
+    close ();
+}
+
+
+bool 
+OpenSteer::TelemetryReader::open (const char* streamName)
+{
+    close ();
+
+#ifndef _WIN32
+    const std::string shmName = sharedMemoryName (streamName);
+    const int object = shm_open (shmName.c_str (), O_RDONLY, 0);
+    if (object < 0) return false;
+    struct stat status;
+    void* m = MAP_FAILED;
+    if ((fstat (object, &status) == 0) &&
+        ((size_t) status.st_size >= sizeof (TelemetryHeader)))
+        m = mmap (0, status.st_size, PROT_READ, MAP_SHARED, object, 0);
+    ::close (object);
+    if (m == MAP_FAILED) return false;
+
+    header = (const TelemetryHeader*) m;
+    mappedSize = status.st_size;
+
+    const bool valid =
+        (memcmp (header->magic, telemetryMagic, sizeof (telemetryMagic)) == 0);
+    std::atomic_thread_fence (std::memory_order_acquire);
+    if (valid &&
+        (header->version == TelemetryWriter::version) &&
+        (header->recordSize == sizeof (TelemetryRecord)) &&
+        (header->slotCount > 0) &&
+        (header->slotSize >= slotSizeFor (header->capacity)) &&
+        (sizeof (TelemetryHeader) + header->slotCount * header->slotSize <=
+         mappedSize))
+        return true;
+    close ();
+    return false;
+#else
+    (void) streamName;
+    return false;
+#endif
+}
+
+
+void 
+OpenSteer::TelemetryReader::close (void)
+{
+#ifndef _WIN32
+    if (header == 0) return;
+    munmap ((void*) header, mappedSize);
+    header = 0;
+    mappedSize = 0;
+#endif
+}
+
+
+uint64_t 
+OpenSteer::TelemetryReader::latestFrame (void) const
+{
+    return header ? header->latestFrame.load (std::memory_order_acquire) : 0;
+}
+
+
+bool 
+OpenSteer::TelemetryReader::readFrame (const uint64_t frame,
+                                       std::vector<TelemetryRecord>& records,
+                                       float& currentTime) const
+{
+    if ((header == 0) || (frame == 0)) return false;
+
+    TelemetrySlot* slot = slotOf (header, frame);
+    const uint64_t sequence = slot->sequence.load (std::memory_order_acquire);
+    if (sequence != 2 * frame) return false;
+
+    const size_t count = (slot->vehicleCount < header->capacity) ?
+                         slot->vehicleCount : header->capacity;
+    records.resize (count);
+    if (count > 0)
+        memcpy (&records[0], recordsOf (slot), count * sizeof (TelemetryRecord));
+    currentTime = slot->currentTime;
+
+    // the writer started on a later frame while this one was copied
+    std::atomic_thread_fence (std::memory_order_acquire);
+    return slot->sequence.load (std::memory_order_relaxed) == sequence;
+}
+
+
+// ----------------------------------------------------------------------------
@@ -27,10 +27,11 @@
 #include <cstdlib>
 #include <cmath>
 #include <memory.h>
+#include <algorithm>
 
 
-// To include OpenSteer::maxXXX instead of using __max
-#include "OpenSteer/Utilities.h"
+// For the tiled, memory mapped terrain
+#include "OpenSteer/TiledHeightfield.h"
 
 
 using namespace std;
@@ -40,7 +41,7 @@ using namespace std;
 
 
 
-RayTester::RayTester() : data(NULL) {
+RayTester::RayTester() : width(0), height(0), data(NULL), tiles(NULL), treeBaseLevel(0) {
 }
 
 
@@ -56,13 +57,31 @@ void RayTester::LoadData( char *fname,	TRTScalar xMin, TRTScalar xMax,
 										TRTScalar zMin, TRTScalar zMax ) {
 	FILE *inf=fopen(fname,"rb");
 
-	fread(&width,sizeof(width),1,inf);
-	fread(&height,sizeof(height),1,inf);
+	int w,h;
+	fread(&w,sizeof(w),1,inf);
+	fread(&h,sizeof(h),1,inf);
 
+	std::vector<float> verts( 3*w*h );
+	fread(&verts[0],sizeof(float),verts.size(),inf);
+
+	fclose(inf);
+
+	SetData( w, h, &verts[0], xMin, xMax, yMin, yMax, zMin, zMax );
+}
+
+
+void RayTester::SetData( int w, int h, const float *verts,	TRTScalar xMin, TRTScalar xMax,
+															TRTScalar yMin, TRTScalar yMax,
+															TRTScalar zMin, TRTScalar zMax ) {
+	tiles=NULL;
+	width=w;
+	height=h;
+
+	if( data!=NULL )
+		free( data );
 	data = (GridCell *)calloc( width*height, sizeof(GridCell) );
 
 	int x,y,curVert;
-	float tempVert[3];
 
 	maxx=-TRT_INFINITY;
 	minx=TRT_INFINITY;
@@ -73,7 +92,7 @@ void RayTester::LoadData( char *fname,	TRTScalar xMin, TRTScalar xMax,
 
 	for(y=0, curVert=0; y<height; y++)
 		for(x=0; x<width; x++, curVert++){
-			fread(tempVert,sizeof(float),3,inf);
+			const float *tempVert = verts+3*curVert;
 			data[curVert].pos[0]=(TRTScalar)tempVert[0];
 			data[curVert].pos[1]=(TRTScalar)tempVert[1];
 			data[curVert].pos[2]=(TRTScalar)tempVert[2];
@@ -92,8 +111,6 @@ void RayTester::LoadData( char *fname,	TRTScalar xMin, TRTScalar xMax,
 				maxz=data[curVert].pos[2];
 		}
 
-	fclose(inf);
-
 	xrange=maxx-minx;
 	yrange=maxy-miny;
 	zrange=maxz-minz;
@@ -105,7 +122,6 @@ void RayTester::LoadData( char *fname,	TRTScalar xMin, TRTScalar xMax,
 			TRTScalar zNewRange = zMax-zMin;
 			for(y=0, curVert=0; y<height; y++)
 				for(x=0; x<width; x++, curVert++){
-					fread(tempVert,sizeof(float),3,inf);
 					data[curVert].pos[0] = xNewRange*((data[curVert].pos[0]-minx)/xrange)+xMin;
 					data[curVert].pos[1] = yNewRange*((data[curVert].pos[1]-miny)/yrange)+yMin;
 					data[curVert].pos[2] = zNewRange*((data[curVert].pos[2]-minz)/zrange)+zMin;
@@ -136,8 +152,8 @@ void RayTester::LoadData( char *fname,	TRTScalar xMin, TRTScalar xMax,
 	for(y=0, curVert=0; y<height; y++)
 		for(x=0; x<width; x++, curVert++)
 			if( x<width-1 && y<height-1) {
-				data[curVert].maxy = OpenSteer::maxXXX( OpenSteer::maxXXX( data[curVert].pos[1], data[curVert+1].pos[1] ), 
-											OpenSteer::maxXXX( data[curVert+width].pos[1], data[curVert+width+1].pos[1] ) );
+				data[curVert].maxy = std::max( std::max( data[curVert].pos[1], data[curVert+1].pos[1] ), 
+											std::max( data[curVert+width].pos[1], data[curVert+width+1].pos[1] ) );
 
 				#ifdef TRT_PRECOMPUTE_NORMALS
 					GetNormal( data[curVert].upLeftNorm, data[curVert].pos, data[curVert+width].pos, data[curVert+1].pos );
@@ -148,6 +164,125 @@ void RayTester::LoadData( char *fname,	TRTScalar xMin, TRTScalar xMax,
 				#endif
 			}
 
+	BuildMaxTree();
+}
+
+
+void RayTester::SetTiles( const OpenSteer::TiledHeightfield *field ) {
+	if( data!=NULL )
+		free( data );
+	data=NULL;
+
+	tiles=field;
+	width=field->width();
+	height=field->height();
+
+	// the tiles are queried in their own coordinates
+	transformData=false;
+	minx=field->originX();
+	maxx=minx+field->spacingX()*(width-1);
+	miny=field->minHeight();
+	maxy=field->maxHeight();
+	minz=field->originZ();
+	maxz=minz+field->spacingZ()*(height-1);
+	xrange=maxx-minx;
+	yrange=maxy-miny;
+	zrange=maxz-minz;
+	xstep=field->spacingX();
+	zstep=field->spacingZ();
+
+	BuildMaxTree();
+}
+
+
+void RayTester::BuildMaxTree() {
+	levelOffset.clear();
+	levelWidth.clear();
+	levelHeight.clear();
+	maxTree.clear();
+
+	// the size of each level, from one node per cell up to the root
+	int w=width-1, h=height-1;
+	levelWidth.push_back( w );
+	levelHeight.push_back( h );
+	while( w>1 || h>1 ) {
+		w=(w+1)/2;
+		h=(h+1)/2;
+		levelWidth.push_back( w );
+		levelHeight.push_back( h );
+	}
+	const int rootLevel=(int)levelWidth.size()-1;
+
+	// the lowest level kept here: the cells, or with tiles one node per tile
+	if( tiles==NULL ) {
+		treeBaseLevel=0;
+		for(int y=0; y<height-1; y++)
+			for(int x=0; x<width-1; x++)
+				maxTree.push_back( data[x+y*width].maxy );
+	} else {
+		treeBaseLevel=tiles->tileLog2();
+		if( treeBaseLevel>rootLevel )			// the whole grid fits one tile
+			return;
+		for(int z=0; z<tiles->tilesZ(); z++)
+			for(int x=0; x<tiles->tilesX(); x++)
+				maxTree.push_back( tiles->tileMaxHeight( x, z ) );
+	}
+	levelOffset.push_back( 0 );
+
+	// each level above: the max of the (up to) 2x2 nodes below
+	for(int level=treeBaseLevel+1; level<=rootLevel; level++) {
+		const int below=levelOffset.back();
+		const int belowW=levelWidth[level-1], belowH=levelHeight[level-1];
+		levelOffset.push_back( (int)maxTree.size() );
+		for(int y=0; y<levelHeight[level]; y++)
+			for(int x=0; x<levelWidth[level]; x++) {
+				TRTScalar m=-TRT_INFINITY;
+				for(int b=2*y; b<2*y+2 && b<belowH; b++)
+					for(int a=2*x; a<2*x+2 && a<belowW; a++)
+						m = std::max( m, maxTree[below+a+b*belowW] );
+				maxTree.push_back( m );
+			}
+	}
+}
+
+
+TRTScalar RayTester::NodeMax( int level, int x, int z ) const {
+	if( level<treeBaseLevel )
+		return (TRTScalar)tiles->nodeMaxHeight( level, x, z );
+	return maxTree[levelOffset[level-treeBaseLevel]+x+z*levelWidth[level]];
+}
+
+
+TRTScalar RayTester::VertexX( int i ) const {
+	return tiles ? (TRTScalar)tiles->originX()+i*(TRTScalar)tiles->spacingX() : data[i].pos[0];
+}
+
+
+TRTScalar RayTester::VertexZ( int j ) const {
+	return tiles ? (TRTScalar)tiles->originZ()+j*(TRTScalar)tiles->spacingZ() : data[j*width].pos[2];
+}
+
+
+void RayTester::GetCellVertex( TRTScalar *v, int i, int j ) const {
+	v[0]=VertexX( i );
+	v[1]=(TRTScalar)tiles->vertexHeight( i, j );
+	v[2]=VertexZ( j );
+}
+
+
+// Clips the ray parameter interval [t0,t1] to the slab lo<=o+t*d<=hi of one axis, returns
+//	false if nothing is left
+
+static inline bool ClipToSlab( TRTScalar o, TRTScalar d, TRTScalar lo, TRTScalar hi, TRTScalar &t0, TRTScalar &t1 ) {
+	if( d==0 )
+		return ( o>=lo && o<=hi );
+	TRTScalar ta=(lo-o)/d, tb=(hi-o)/d;
+	if( ta>tb ) {
+		TRTScalar swap=ta; ta=tb; tb=swap;
+	}
+	if( ta>t0 ) t0=ta;
+	if( tb<t1 ) t1=tb;
+	return t0<=t1;
 }
 
 
@@ -175,456 +310,153 @@ void RayTester::RayCast( RayTestInfo &results, const TRTScalar *eyePos, const TR
 			realViewNorm[2]=viewNorm[2];
 		}
 
-	// find the initial grid cell
-	int xidx=(int)((realEyePos[0]-minx)/xstep);
-	int zidx=(int)((realEyePos[2]-minz)/zstep);
-
-	// need starting point of trace for intersection test
-	TRTScalar lasty=realEyePos[1];
-	TRTScalar newLasty=lasty;
-
-	int idx = xidx+zidx*width;			// the current grid cell
-	TRTScalar tval,tval1=-1,tval2=-1;	// t parameter values for intersection
-	bool mustTest;						// flag for whether or not we test against triangles
-
-	// for speed, perform computations according to quadrant
-
-	if( realViewNorm[0]>0 ) {				// Moving to the right
-		if( realViewNorm[2]>0 ) {			// ... and moving downwards
-
-			// Out-of-bounds check
-			if( xidx<0 || zidx<0 ) {
-				tval1=( minx-realEyePos[0] )/realViewNorm[0];
-				tval2=( minz-realEyePos[2] )/realViewNorm[2];
+	CastLocalRay( results, realEyePos, realViewNorm, maxt );
+	if( results.hitOccurred )
+		RectifyResults( results );
+}
 
-				if( tval1 > tval2 ){		// Hits left edge of terrain
-					tval=tval1;
-					xidx=0;
-					zidx=(int)((realEyePos[2]+tval*realViewNorm[2]-minz)/zstep);
-				} else {					// Hits top edge of terrain
-					tval=tval2;
-					xidx=(int)((realEyePos[0]+tval*realViewNorm[0]-minx)/xstep);
-					zidx=0;
-				}
 
-				if( tval>maxt || tval<0 ) {		// Check if maxt value surpassed
-					results.hitOccurred=false;
-					return;
-				}
+void RayTester::TestRays( RayTestInfo *results, const TRTScalar *eyePos, const TRTScalar *viewNorm,
+							int count, const TRTScalar *maxt ) const {
+	for(int i=0; i<count; i++)
+		RayCast( results[i], eyePos+3*i, viewNorm+3*i, maxt ? maxt[i] : TRT_INFINITY );
+}
 
-				lasty = realEyePos[1]+tval*realViewNorm[1];
-				idx = xidx+zidx*width;
-			}
 
-			while( xidx<width-1 && zidx<height-1 ) {
+// Walks the max height quadtree front to back from the root, skipping every node the ray
+//	passes above, and tests the triangles of the cells it reaches. The nearest hit so far
+//	shortens the ray, so nodes behind it are skipped too.
 
-				// only compute intersection if we have to -- we may have to test triangles anyway
-				if( !( mustTest=(lasty<data[idx].maxy) ) ) {
-					tval1=( data[idx+width+1].pos[0]-realEyePos[0] )/realViewNorm[0];
-					tval2=( data[idx+width+1].pos[2]-realEyePos[2] )/realViewNorm[2];
+void RayTester::CastLocalRay( RayTestInfo &results, const TRTScalar *eyePos, const TRTScalar *viewNorm, TRTScalar maxt ) const {
 
-					if( tval1 < tval2 ){		// Hits right edge
-						xidx++;
-						tval=tval1;
-					} else {					// Hits bottom edge
-						zidx++;
-						tval=tval2;
-					}
+	results.hitOccurred=false;
+	if( ( data==NULL && tiles==NULL ) || width<2 || height<2 )
+		return;
+	if( viewNorm[0]==0 && viewNorm[1]==0 && viewNorm[2]==0 )
+		return;
 
-					if( tval>maxt ) {		// Check if maxt value surpassed
-						results.hitOccurred=false;
-						return;
-					}
+	// clip the ray to the terrain's bounding box
+	TRTScalar t0=0, t1=maxt;
+	if( !ClipToSlab( eyePos[0], viewNorm[0], minx, maxx, t0, t1 ) ||
+		!ClipToSlab( eyePos[1], viewNorm[1], miny, maxy, t0, t1 ) ||
+		!ClipToSlab( eyePos[2], viewNorm[2], minz, maxz, t0, t1 ) )
+		return;
 
-					newLasty=realEyePos[1]+tval*realViewNorm[1];
-					mustTest=( newLasty<data[idx].maxy );
-				}
+	struct Node {
+		int level, x, z;
+		TRTScalar entry;		// t where the ray enters the node
+	};
+
+	const int cellsW=width-1, cellsH=height-1;
+	const int rootLevel=(int)levelWidth.size()-1;
+
+	// stack of nodes still to visit, nearest on top: each level pushes at most 4 nodes and
+	//	pops 1, and there are fewer than 32 levels
+	Node stack[32*3+1];
+	int top=0;
+
+	Node children[4];
+	int childCount;
+
+	RayTestInfo hit;
+	TRTScalar best=t1;
+
+	#define TRT_TRY_NODE(LEVEL,X,Z,LIST,COUNT) \
+		{ \
+			const int c0=(X)<<(LEVEL), c1=std::min( ((X)+1)<<(LEVEL), cellsW ); \
+			const int r0=(Z)<<(LEVEL), r1=std::min( ((Z)+1)<<(LEVEL), cellsH ); \
+			const TRTScalar xa=VertexX( c0 ), xb=VertexX( c1 ); \
+			const TRTScalar za=VertexZ( r0 ), zb=VertexZ( r1 ); \
+			TRTScalar ta=t0, tb=best; \
+			if( ClipToSlab( eyePos[0], viewNorm[0], std::min( xa, xb ), std::max( xa, xb ), ta, tb ) && \
+				ClipToSlab( eyePos[2], viewNorm[2], std::min( za, zb ), std::max( za, zb ), ta, tb ) ) { \
+				const TRTScalar lowy=eyePos[1]+viewNorm[1]*( viewNorm[1]<0 ? tb : ta ); \
+				if( lowy<=NodeMax( (LEVEL), (X), (Z) ) ) { \
+					(LIST)[(COUNT)].level=(LEVEL); \
+					(LIST)[(COUNT)].x=(X); \
+					(LIST)[(COUNT)].z=(Z); \
+					(LIST)[(COUNT)].entry=ta; \
+					(COUNT)++; \
+				} \
+			} \
+		}
 
-				// if the mustTest is true, the ray intersects the y-bounds of the cell
-				if( mustTest ) {
-					RayCastTriangle( results, realEyePos, realViewNorm, data[idx].pos, data[idx+width].pos, data[idx+1].pos );
-					if( results.hitOccurred ){
-						if( results.t>maxt ) {		// Check if maxt value surpassed
-							results.hitOccurred=false;
-							return;
-						}
-						#ifdef TRT_PRECOMPUTE_NORMALS
-							memcpy( results.norm, data[idx].upLeftNorm, sizeof(TRTScalar)*3 );
-						#endif
-						RectifyResults( results );
-						return;
-					}
-
-					RayCastTriangle( results, realEyePos, realViewNorm, data[idx+width+1].pos, data[idx+1].pos, data[idx+width].pos );
-					if( results.hitOccurred ){
-						if( results.t>maxt ) {		// Check if maxt value surpassed
-							results.hitOccurred=false;
-							return;
-						}
-						#ifdef TRT_PRECOMPUTE_NORMALS
-							memcpy( results.norm, data[idx].lowRightNorm, sizeof(TRTScalar)*3 );
-						#endif
-						RectifyResults( results );
-						return;
-					}
+	TRT_TRY_NODE( rootLevel, 0, 0, stack, top );
+
+	while( top>0 ) {
+		const Node node=stack[--top];
+		if( node.entry>best )
+			continue;
+
+		if( node.level==0 ) {
+			// a cell the ray may touch: test its two triangles (the same ones as before)
+			const int idx=node.x+node.z*width;
+
+			if( tiles ) {
+				// vertices (and normals) from the tile the cell lies in
+				TRTScalar v00[3], v10[3], v01[3], v11[3];
+				GetCellVertex( v00, node.x, node.z );
+				GetCellVertex( v10, node.x+1, node.z );
+				GetCellVertex( v01, node.x, node.z+1 );
+				GetCellVertex( v11, node.x+1, node.z+1 );
+
+				RayCastTriangle( hit, eyePos, viewNorm, v00, v01, v10 );
+				if( hit.hitOccurred && hit.t>=0 && hit.t<=best ) {
+					GetNormal( hit.norm, v00, v01, v10 );
+					Normalize( hit.norm );
+					results=hit;
+					best=hit.t;
 				}
 
-				// we didn't intersect -- so update the index
-				if( lasty<data[idx].maxy ) {	// in this case, we haven't updated xidx or zidx yet
-					tval1=( data[idx+width+1].pos[0]-realEyePos[0] )/realViewNorm[0];
-					tval2=( data[idx+width+1].pos[2]-realEyePos[2] )/realViewNorm[2];
-
-					if( tval1 < tval2 ){		// Hits right edge
-						xidx++;
-						tval=tval1;
-					} else {					// Hits bottom edge
-						zidx++;
-						tval=tval2;
-					}
-
-					if( tval>maxt ) {		// Check if maxt value surpassed
-						results.hitOccurred=false;
-						return;
-					}
-
-					newLasty=realEyePos[1]+tval*realViewNorm[1];
-					mustTest=( newLasty<data[idx].maxy );
+				RayCastTriangle( hit, eyePos, viewNorm, v11, v10, v01 );
+				if( hit.hitOccurred && hit.t>=0 && hit.t<=best ) {
+					GetNormal( hit.norm, v11, v10, v01 );
+					Normalize( hit.norm );
+					results=hit;
+					best=hit.t;
 				}
-				idx = xidx+zidx*width;
-				lasty=newLasty;
-
+				continue;
 			}
 
-		} else {						// ... else moving upwards
-
-			// Out-of-bounds check
-			if( xidx<0 || zidx>=height-1 ) {
-				tval1=( minx-realEyePos[0] )/realViewNorm[0];
-				if( realViewNorm[2]!=0 )
-					tval2=( maxz-realEyePos[2] )/realViewNorm[2];
-
-				if( realViewNorm[2]==0 || tval1 > tval2 ){		// Hits left edge of terrain
-					tval=tval1;
-					xidx=0;
-					zidx=(int)((realEyePos[2]+tval*realViewNorm[2]-minz)/zstep);
-				} else {					// Hits bottom edge of terrain
-					tval=tval2;
-					xidx=(int)((realEyePos[0]+tval*realViewNorm[0]-minx)/xstep);
-					zidx=height-1;
-				}
-
-				if( tval>maxt || tval<0 ) {		// Check if maxt value surpassed
-					results.hitOccurred=false;
-					return;
-				}
-
-				lasty = realEyePos[1]+tval*realViewNorm[1];
-				idx = xidx+zidx*width;
+			RayCastTriangle( hit, eyePos, viewNorm, data[idx].pos, data[idx+width].pos, data[idx+1].pos );
+			if( hit.hitOccurred && hit.t>=0 && hit.t<=best ) {
+				#ifdef TRT_PRECOMPUTE_NORMALS
+					memcpy( hit.norm, data[idx].upLeftNorm, sizeof(TRTScalar)*3 );
+				#endif
+				results=hit;
+				best=hit.t;
 			}
 
-			while( xidx<width-1 && zidx>=0 ) {
-
-				// only compute intersection if we have to -- we may have to test triangles anyway
-				if( !( mustTest=(lasty<data[idx].maxy) ) ) {
-					tval1 = ( data[idx+1].pos[0]-realEyePos[0] )/realViewNorm[0];
-					if( realViewNorm[2]!=0 )
-						tval2 = ( data[idx+1].pos[2]-realEyePos[2] )/realViewNorm[2];
-
-					if( realViewNorm[2]==0 || tval1 < tval2 ){		// Hits right edge
-						xidx++;
-						tval=tval1;
-					} else {					// Hits bottom edge
-						zidx--;
-						tval=tval2;
-					}
-
-					if( tval>maxt ) {		// Check if maxt value surpassed
-						results.hitOccurred=false;
-						return;
-					}
-
-					newLasty=realEyePos[1]+tval*realViewNorm[1];
-					mustTest=( newLasty<data[idx].maxy );
-				}
-
-				// if the mustTest is true, the ray intersects the y-bounds of the cell
-				if( mustTest ) {
-					RayCastTriangle( results, realEyePos, realViewNorm, data[idx].pos, data[idx+width].pos, data[idx+1].pos );
-					if( results.hitOccurred ){
-						if( results.t>maxt ) {		// Check if maxt value surpassed
-							results.hitOccurred=false;
-							return;
-						}
-						#ifdef TRT_PRECOMPUTE_NORMALS
-							memcpy( results.norm, data[idx].upLeftNorm, sizeof(TRTScalar)*3 );
-						#endif
-						RectifyResults( results );
-						return;
-					}
-
-					RayCastTriangle( results, realEyePos, realViewNorm, data[idx+width+1].pos, data[idx+1].pos, data[idx+width].pos );
-					if( results.hitOccurred ){
-						if( results.t>maxt ) {		// Check if maxt value surpassed
-							results.hitOccurred=false;
-							return;
-						}
-						#ifdef TRT_PRECOMPUTE_NORMALS
-							memcpy( results.norm, data[idx].lowRightNorm, sizeof(TRTScalar)*3 );
-						#endif
-						RectifyResults( results );
-						return;
-					}
-				}
-
-				// we didn't intersect -- so update the index
-				if( lasty<data[idx].maxy ) {	// in this case, we haven't updated xidx or zidx yet
-					tval1 = ( data[idx+1].pos[0]-realEyePos[0] )/realViewNorm[0];
-					if( realViewNorm[2]!=0 )
-						tval2 = ( data[idx+1].pos[2]-realEyePos[2] )/realViewNorm[2];
-
-					if( realViewNorm[2]==0 || tval1 < tval2 ){		// Hits right edge
-						xidx++;
-						tval=tval1;
-					} else {					// Hits bottom edge
-						zidx--;
-						tval=tval2;
-					}
-
-					if( tval>maxt ) {		// Check if maxt value surpassed
-						results.hitOccurred=false;
-						return;
-					}
-
-					newLasty=realEyePos[1]+tval*realViewNorm[1];
-					mustTest=( newLasty<data[idx].maxy );
-				}
-				idx = xidx+zidx*width;
-				lasty=newLasty;
+			RayCastTriangle( hit, eyePos, viewNorm, data[idx+width+1].pos, data[idx+1].pos, data[idx+width].pos );
+			if( hit.hitOccurred && hit.t>=0 && hit.t<=best ) {
+				#ifdef TRT_PRECOMPUTE_NORMALS
+					memcpy( hit.norm, data[idx].lowRightNorm, sizeof(TRTScalar)*3 );
+				#endif
+				results=hit;
+				best=hit.t;
 			}
+			continue;
 		}
-	} else {							// else moving to the left
-		if( realViewNorm[2]>0 ) {			// ... and moving downwards
-
-			// Out-of-bounds check
-			if( xidx>=width-1 || zidx<0 ) {
-				if( realViewNorm[0]!=0 )
-					tval1=( maxx-realEyePos[0] )/realViewNorm[0];
-				tval2=( minz-realEyePos[2] )/realViewNorm[2];
-
-				if( realViewNorm[0]!=0 && tval1 > tval2 ){		// Hits right edge of terrain
-					tval=tval1;
-					xidx=width-1;
-					zidx=(int)((realEyePos[2]+tval*realViewNorm[2]-minz)/zstep);
-				} else {					// Hits top edge of terrain
-					tval=tval2;
-					xidx=(int)((realEyePos[0]+tval*realViewNorm[0]-minx)/xstep);
-					zidx=0;
-				}
-
-				if( tval>maxt || tval<0 ) {		// Check if maxt value surpassed
-					results.hitOccurred=false;
-					return;
-				}
-
-				lasty = realEyePos[1]+tval*realViewNorm[1];
-				idx = xidx+zidx*width;
-			}
-
-			while( xidx>=0 && zidx<height-1 ) {
-
-				// only compute intersection if we have to -- we may have to test triangles anyway
-				if( !( mustTest=(lasty<data[idx].maxy) ) ) {
-					if( realViewNorm[0]!=0 )
-						tval1 = ( data[idx+width].pos[0]-realEyePos[0] )/realViewNorm[0];
-					tval2 = ( data[idx+width].pos[2]-realEyePos[2] )/realViewNorm[2];
-
-					if( realViewNorm[0]!=0 && tval1 < tval2 ){		// Hits right edge
-						xidx--;
-						tval=tval1;
-					} else {					// Hits bottom edge
-						zidx++;
-						tval=tval2;
-					}
-
-					if( tval>maxt ) {		// Check if maxt value surpassed
-						results.hitOccurred=false;
-						return;
-					}
-
-					newLasty=realEyePos[1]+tval*realViewNorm[1];
-					mustTest=( newLasty<data[idx].maxy );
-				}
-
-				// if the mustTest is true, the ray intersects the y-bounds of the cell
-				if( mustTest ) {
-					RayCastTriangle( results, realEyePos, realViewNorm, data[idx].pos, data[idx+width].pos, data[idx+1].pos );
-					if( results.hitOccurred ){
-						if( results.t>maxt ) {		// Check if maxt value surpassed
-							results.hitOccurred=false;
-							return;
-						}
-						#ifdef TRT_PRECOMPUTE_NORMALS
-							memcpy( results.norm, data[idx].upLeftNorm, sizeof(TRTScalar)*3 );
-						#endif
-						RectifyResults( results );
-						return;
-					}
-
-					RayCastTriangle( results, realEyePos, realViewNorm, data[idx+width+1].pos, data[idx+1].pos, data[idx+width].pos );
-					if( results.hitOccurred ){
-						if( results.t>maxt ) {		// Check if maxt value surpassed
-							results.hitOccurred=false;
-							return;
-						}
-						#ifdef TRT_PRECOMPUTE_NORMALS
-							memcpy( results.norm, data[idx].lowRightNorm, sizeof(TRTScalar)*3 );
-						#endif
-						RectifyResults( results );
-						return;
-					}
-				}
 
-				// we didn't intersect -- so update the index
-				if( lasty<data[idx].maxy ) {	// in this case, we haven't updated xidx or zidx yet
-					if( realViewNorm[0]!=0 )
-						tval1 = ( data[idx+width].pos[0]-realEyePos[0] )/realViewNorm[0];
-					tval2 = ( data[idx+width].pos[2]-realEyePos[2] )/realViewNorm[2];
-
-					if( realViewNorm[0]!=0 && tval1 < tval2 ){		// Hits right edge
-						xidx--;
-						tval=tval1;
-					} else {					// Hits bottom edge
-						zidx++;
-						tval=tval2;
-					}
-
-					if( tval>maxt ) {		// Check if maxt value surpassed
-						results.hitOccurred=false;
-						return;
-					}
-
-					newLasty=realEyePos[1]+tval*realViewNorm[1];
-					mustTest=( newLasty<data[idx].maxy );
-				}
-				idx = xidx+zidx*width;
-				lasty=newLasty;
-			}
-		} else{							// ... else moving upwards
-
-			// Out-of-bounds check
-			if( xidx>=width-1 || zidx>=height-1 ) {
-				if( realViewNorm[0]!=0 )
-					tval1=( maxx-realEyePos[0] )/realViewNorm[0];
-				if( realViewNorm[2]!=0 )
-					tval2=( maxz-realEyePos[2] )/realViewNorm[2];
-
-				if( realViewNorm[2]==0 || ( realViewNorm[0]!=0 && tval1 > tval2 ) ){		// Hits right edge of terrain
-					tval=tval1;
-					xidx=width-1;
-					zidx=(int)((realEyePos[2]+tval*realViewNorm[2]-minz)/zstep);
-				} else {					// Hits bottom edge of terrain
-					tval=tval2;
-					xidx=(int)((realEyePos[0]+tval*realViewNorm[0]-minx)/xstep);
-					zidx=height-1;
-				}
-
-				if( tval>maxt || tval<0 ) {		// Check if maxt value surpassed
-					results.hitOccurred=false;
-					return;
-				}
-
-				lasty = realEyePos[1]+tval*realViewNorm[1];
-				idx = xidx+zidx*width;
+		// the children the ray may touch, pushed farthest first so the nearest is visited next
+		const int level=node.level-1;
+		childCount=0;
+		for(int b=0; b<2; b++)
+			for(int a=0; a<2; a++) {
+				const int x=2*node.x+a, z=2*node.z+b;
+				if( x<levelWidth[level] && z<levelHeight[level] )
+					TRT_TRY_NODE( level, x, z, children, childCount );
 			}
 
-			while( xidx>=0 && zidx>=0 ) {
-
-				// only compute intersection if we have to -- we may have to test triangles anyway
-				if( realViewNorm[0]==0 && realViewNorm[2]==0 )
-					mustTest=true;
-                else if( !( mustTest=(lasty<data[idx].maxy) ) ) {
-					if( realViewNorm[0]!=0 )
-						tval1 = ( data[idx].pos[0]-realEyePos[0] )/realViewNorm[0];
-					if( realViewNorm[2]!=0 )
-						tval2 = ( data[idx].pos[2]-realEyePos[2] )/realViewNorm[2];
-
-					if( realViewNorm[2]==0 || ( realViewNorm[0]!=0 && tval1 < tval2 ) ){		// Hits right edge
-						xidx--;
-						tval=tval1;
-					} else {					// Hits bottom edge
-						zidx--;
-						tval=tval2;
-					}
-
-					if( tval>maxt ) {		// Check if maxt value surpassed
-						results.hitOccurred=false;
-						return;
-					}
-
-					newLasty=realEyePos[1]+tval*realViewNorm[1];
-					mustTest=( newLasty<data[idx].maxy );
-				}
-
-				// if the mustTest is true, the ray intersects the y-bounds of the cell
-				if( mustTest ) {
-					RayCastTriangle( results, realEyePos, realViewNorm, data[idx].pos, data[idx+width].pos, data[idx+1].pos );
-					if( results.hitOccurred ){
-						if( results.t>maxt ) {		// Check if maxt value surpassed
-							results.hitOccurred=false;
-							return;
-						}
-						#ifdef TRT_PRECOMPUTE_NORMALS
-							memcpy( results.norm, data[idx].upLeftNorm, sizeof(TRTScalar)*3 );
-						#endif
-						RectifyResults( results );
-						return;
-					}
-
-					RayCastTriangle( results, realEyePos, realViewNorm, data[idx+width+1].pos, data[idx+1].pos, data[idx+width].pos );
-					if( results.hitOccurred ){
-						if( results.t>maxt ) {		// Check if maxt value surpassed
-							results.hitOccurred=false;
-							return;
-						}
-						#ifdef TRT_PRECOMPUTE_NORMALS
-							memcpy( results.norm, data[idx].lowRightNorm, sizeof(TRTScalar)*3 );
-						#endif
-						RectifyResults( results );
-						return;
-					}
-
-					if( realViewNorm[0]==0 && realViewNorm[2]==0 )
-						return;
-				}
-
-				// we didn't intersect -- so update the index
-				if( lasty<data[idx].maxy ) {	// in this case, we haven't updated xidx or zidx yet
-					tval1 = ( data[idx].pos[0]-realEyePos[0] )/realViewNorm[0];
-					tval2 = ( data[idx].pos[2]-realEyePos[2] )/realViewNorm[2];
-
-					if( realViewNorm[2]==0 || ( realViewNorm[0]!=0 && tval1 < tval2 ) ){		// Hits right edge
-						xidx--;
-						tval=tval1;
-					} else {					// Hits bottom edge
-						zidx--;
-						tval=tval2;
-					}
-
-					if( tval>maxt ) {		// Check if maxt value surpassed
-						results.hitOccurred=false;
-						return;
-					}
-
-					newLasty=realEyePos[1]+tval*realViewNorm[1];
-					mustTest=( newLasty<data[idx].maxy );
-				}
-				idx = xidx+zidx*width;
-				lasty=newLasty;
+		for(int i=1; i<childCount; i++)			// insertion sort, by decreasing entry
+			for(int j=i; j>0 && children[j-1].entry<children[j].entry; j--) {
+				const Node swap=children[j]; children[j]=children[j-1]; children[j-1]=swap;
 			}
-		}
+		for(int i=0; i<childCount; i++)
+			stack[top++]=children[i];
 	}
 
-	results.hitOccurred = false;
+	#undef TRT_TRY_NODE
 }
 
 
@@ -721,7 +553,7 @@ void RayTester::RectifyResults( RayTestInfo &results ) const {
 
 
 void RayTester::GetNormal( TRTScalar *r, const TRTScalar *u, const TRTScalar *v, const TRTScalar *w) const {
-	static TRTScalar vx,vy,vz,wx,wy,wz;
+	TRTScalar vx,vy,vz,wx,wy,wz;
 
 	vx=v[0]-u[0];
 	wx=w[0]-u[0];
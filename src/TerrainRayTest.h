@@ -29,9 +29,13 @@
 #endif
 
 
-// This is so that everything can be changed to double precision if needed:
+// This is so that everything can be changed to double precision if needed. Double is the
+//	default; define TRT_SINGLE_PRECISION (e.g. on the compiler command line) for the float
+//	path, which halves the memory traffic of the height tree and lets the ray batch vectorize:
 
-#define TRT_DOUBLE_PRECISION
+#if !defined(TRT_SINGLE_PRECISION) && !defined(TRT_DOUBLE_PRECISION)
+	#define TRT_DOUBLE_PRECISION
+#endif
 
 
 // This controls whether or not the data set is transformed or just the query values are transformed
@@ -42,10 +46,12 @@
 
 
 // You may want to get better performance by precomputing normals, at the expense of a little
-//	extra computation time at load and more memory consumption. If you want the normals pre-computed,
-//	define the following:
+//	extra computation time at load and more memory consumption. The normals are pre-computed
+//	unless TRT_NO_PRECOMPUTE_NORMALS is defined:
 
-#define TRT_PRECOMPUTE_NORMALS
+#ifndef TRT_NO_PRECOMPUTE_NORMALS
+	#define TRT_PRECOMPUTE_NORMALS
+#endif
 
 
 // If you do not precompute the normals, you may not want the tester to normalize the collision
@@ -57,6 +63,7 @@
 
 // Set up the typedef for floating point values
 #include <float.h>
+#include <vector>
 #ifdef TRT_DOUBLE_PRECISION
 	typedef double TRTScalar;
 	#define	TRT_INFINITY	DBL_MAX
@@ -66,6 +73,9 @@
 #endif
 
 
+namespace OpenSteer { class TiledHeightfield; }
+
+
 // The structure for raytest results
 struct RayTestInfo {
 	bool hitOccurred;				// Infinite ray test collission
@@ -87,8 +97,22 @@ public:
 								TRTScalar yMin=0, TRTScalar yMax=0,
 								TRTScalar zMin=0, TRTScalar zMax=0 );
 
+	// same as LoadData, from width*height vertices (x,y,z floats, row by row) already in memory
+	void SetData( int w, int h, const float *verts,	TRTScalar xMin=0, TRTScalar xMax=0,
+													TRTScalar yMin=0, TRTScalar yMax=0,
+													TRTScalar zMin=0, TRTScalar zMax=0 );
+
+	// casts against a memory mapped tiled heightfield instead of loaded data: only the tiles
+	//	the rays reach are read. The field is not copied and must stay open while in use.
+	void SetTiles( const OpenSteer::TiledHeightfield *field );
+
 	void RayCast( RayTestInfo &results, const TRTScalar *eyePos, const TRTScalar *viewNorm, TRTScalar maxt=TRT_INFINITY ) const;
 
+	// casts count rays at once: eyePos and viewNorm hold count xyz triples, maxt holds count
+	//	limits (or is 0 for no limit)
+	void TestRays( RayTestInfo *results, const TRTScalar *eyePos, const TRTScalar *viewNorm,
+					int count, const TRTScalar *maxt=0 ) const;
+
 private:
 
 	int width, height;
@@ -105,6 +129,17 @@ private:
 
 	GridCell *data;
 
+	// ... or the tiled heightfield used instead
+	const OpenSteer::TiledHeightfield *tiles;
+
+	// Max height quadtree over the cells: level 0 holds each cell's maxy, each level above
+	//	holds the max of (up to) 2x2 nodes below it, up to a single root. A ray skips a node
+	//	(and all its cells) when it passes above the node's max height. With tiles, the levels
+	//	below treeBaseLevel (within a tile) are read from the tiles.
+	std::vector<TRTScalar> maxTree;
+	std::vector<int> levelOffset, levelWidth, levelHeight;
+	int treeBaseLevel;
+
 	bool transformData;
 
 	TRTScalar minx,maxx,xrange,xstep;
@@ -117,6 +152,15 @@ private:
 		TRTScalar _zMin,_zRange;
 	#endif
 
+	void BuildMaxTree();
+
+	TRTScalar NodeMax( int level, int x, int z ) const;
+	TRTScalar VertexX( int i ) const;
+	TRTScalar VertexZ( int j ) const;
+	void GetCellVertex( TRTScalar *v, int i, int j ) const;
+
+	void CastLocalRay( RayTestInfo &results, const TRTScalar *eyePos, const TRTScalar *viewNorm, TRTScalar maxt ) const;
+
 	void RayCastTriangle( RayTestInfo &results, const TRTScalar *eyePos, const TRTScalar *viewNorm, 
 							const TRTScalar *vert0, const TRTScalar *vert1, const TRTScalar *vert2 ) const;
 
@@ -0,0 +1,474 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// TiledHeightfield
+//
+// See TiledHeightfield.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/TiledHeightfield.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+
+namespace {
+
+    const int version = 1;
+
+    // tiles start on this boundary, so each spans whole pages
+    const size_t tileAlignment = 4096;
+
+    size_t roundUp (const size_t n, const size_t alignment)
+    {
+        return ((n + alignment - 1) / alignment) * alignment;
+    }
+
+    int clampIndex (const int i, const int count)
+    {
+        return (i < 0) ? 0 : ((i >= count) ? count - 1 : i);
+    }
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+// constructor and destructor
+
+
+OpenSteer::TiledHeightfield::TiledHeightfield ()
+    : base (NULL),
+      fileBytes (0),
+      directory (NULL),
+      tilesOffset (0),
+      tileBytes (0),
+      fieldMin (0),
+      fieldMax (0),
+      useClock (0),
+      residentCount (0),
+      residentStorage (MemoryAccount::terrainMemory),
+      budget (256 * 1024 * 1024)
+{
+    memset (&header, 0, sizeof (header));
+}
+
+
+OpenSteer::TiledHeightfield::~TiledHeightfield ()
+{
+    close ();
+}
+
+
+// ----------------------------------------------------------------------------
+// tile layout: (2^k + 1)^2 vertex heights, then the quadtree levels of
+// (2^k)^2, (2^(k-1))^2 ... 1 cell maxima
+
+
+size_t
+OpenSteer::TiledHeightfield::tileFloatCount (const int tileLog2)
+{
+    const size_t vertices = (size_t) ((1 << tileLog2) + 1);
+    size_t count = vertices * vertices;
+    for (int level = 0; level <= tileLog2; level++)
+    {
+        const size_t side = (size_t) 1 << (tileLog2 - level);
+        count += side * side;
+    }
+    return count;
+}
+
+
+size_t
+OpenSteer::TiledHeightfield::levelOffset (const int tileLog2, const int level)
+{
+    const size_t vertices = (size_t) ((1 << tileLog2) + 1);
+    size_t offset = vertices * vertices;
+    for (int l = 0; l < level; l++)
+    {
+        const size_t side = (size_t) 1 << (tileLog2 - l);
+        offset += side * side;
+    }
+    return offset;
+}
+
+
+// ----------------------------------------------------------------------------
+// write a tiled file
+
+
+bool
+OpenSteer::TiledHeightfield::write (const char* path,
+                                    const int width, const int height,
+                                    const float* heights,
+                                    const float originX, const float originZ,
+                                    const float spacingX, const float spacingZ,
+                                    const int tileLog2)
+{
+    if ((width < 2) || (height < 2) || (tileLog2 < 0) || (tileLog2 > 12))
+        return false;
+
+    FILE* file = fopen (path, "wb");
+    if (file == NULL) return false;
+
+    const int t = 1 << tileLog2;
+    Header h;
+    memset (&h, 0, sizeof (h));
+    memcpy (h.magic, "OSTH", 4);
+    h.version = version;
+    h.width = width;
+    h.height = height;
+    h.tileLog2 = tileLog2;
+    h.originX = originX;
+    h.originZ = originZ;
+    h.spacingX = spacingX;
+    h.spacingZ = spacingZ;
+    h.tilesX = (width - 1 + t - 1) / t;
+    h.tilesZ = (height - 1 + t - 1) / t;
+
+    const size_t tileCount = (size_t) h.tilesX * h.tilesZ;
+    const size_t floatCount = tileFloatCount (tileLog2);
+    const size_t bytes = roundUp (floatCount * sizeof (float), tileAlignment);
+    std::vector<float> directory (2 * tileCount);
+
+    // header, then room for the directory (written last), then the tiles
+    const size_t tilesOffset =
+        roundUp (sizeof (h) + directory.size () * sizeof (float), tileAlignment);
+    std::vector<char> padding (tilesOffset - sizeof (h), 0);
+    bool ok = (fwrite (&h, sizeof (h), 1, file) == 1);
+    ok = ok && (fwrite (&padding[0], 1, padding.size (), file) == padding.size ());
+
+    // build and write one tile (heights and quadtree) at a time, noting its
+    // range in the directory
+    std::vector<float> d (bytes / sizeof (float));
+    for (int tz = 0; ok && (tz < h.tilesZ); tz++)
+    {
+        for (int tx = 0; ok && (tx < h.tilesX); tx++)
+        {
+            std::fill (d.begin (), d.end (), 0.0f);
+
+            // vertex heights, repeating the last row or column past the grid
+            float low = heights[0], high = heights[0];
+            for (int j = 0; j <= t; j++)
+            {
+                const int gj = clampIndex (tz * t + j, height);
+                for (int i = 0; i <= t; i++)
+                {
+                    const int gi = clampIndex (tx * t + i, width);
+                    const float y = heights[gi + gj * width];
+                    d[i + j * (t + 1)] = y;
+                    if ((i == 0) && (j == 0)) low = high = y;
+                    low = std::min (low, y);
+                    high = std::max (high, y);
+                }
+            }
+
+            // cell maxima, then each level the max of 2x2 below
+            size_t below = (size_t) (t + 1) * (t + 1);
+            size_t level = below;
+            for (int j = 0; j < t; j++)
+            {
+                for (int i = 0; i < t; i++)
+                {
+                    const float* v = &d[i + j * (t + 1)];
+                    d[level + i + j * t] = std::max (std::max (v[0], v[1]),
+                                                     std::max (v[t + 1], v[t + 2]));
+                }
+            }
+            for (int side = t / 2; side >= 1; side /= 2)
+            {
+                below = level;
+                level += (size_t) (2 * side) * (2 * side);
+                for (int j = 0; j < side; j++)
+                {
+                    for (int i = 0; i < side; i++)
+                    {
+                        const float* b = &d[below + 2 * i + 2 * j * (2 * side)];
+                        d[level + i + j * side] =
+                            std::max (std::max (b[0], b[1]),
+                                      std::max (b[2 * side], b[2 * side + 1]));
+                    }
+                }
+            }
+
+            directory[2 * (tx + tz * h.tilesX)] = low;
+            directory[2 * (tx + tz * h.tilesX) + 1] = high;
+            ok = (fwrite (&d[0], 1, bytes, file) == bytes);
+        }
+    }
+
+    ok = ok && (fseek (file, (long) sizeof (h), SEEK_SET) == 0);
+    ok = ok && (fwrite (&directory[0], sizeof (float), directory.size (), file) ==
+                directory.size ());
+    return (fclose (file) == 0) && ok;
+}
+
+
+// ----------------------------------------------------------------------------
+// open and close (POSIX: memory mapped, elsewhere: read into memory)
+
+
+bool
+OpenSteer::TiledHeightfield::open (const char* path)
+{
+    close ();
+
+    Header h;
+    FILE* file = fopen (path, "rb");
+    if (file == NULL) return false;
+    const bool readHeader = (fread (&h, sizeof (h), 1, file) == 1);
+    fseek (file, 0, SEEK_END);
+    const long size = ftell (file);
+    fclose (file);
+
+    if (! readHeader || (memcmp (h.magic, "OSTH", 4) != 0) ||
+        (h.version != version) || (h.tileLog2 < 0) || (h.tileLog2 > 12) ||
+        (h.width < 2) || (h.height < 2))
+        return false;
+
+    const size_t tileCount = (size_t) h.tilesX * h.tilesZ;
+    const size_t bytes =
+        roundUp (tileFloatCount (h.tileLog2) * sizeof (float), tileAlignment);
+    const size_t offset =
+        roundUp (sizeof (h) + 2 * tileCount * sizeof (float), tileAlignment);
+    if ((size < 0) || ((size_t) size < offset + tileCount * bytes)) return false;
+
+#ifndef _WIN32
+    const int fd = ::open (path, O_RDONLY);
+    if (fd < 0) return false;
+    void* mapped = mmap (NULL, (size_t) size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close (fd);
+    if (mapped == MAP_FAILED) return false;
+    base = (const char*) mapped;
+#else
+    char* buffer = (char*) malloc ((size_t) size);
+    file = fopen (path, "rb");
+    const bool readAll = (buffer != NULL) && (file != NULL) &&
+                         (fread (buffer, 1, (size_t) size, file) == (size_t) size);
+    if (file != NULL) fclose (file);
+    if (! readAll) {free (buffer); return false;}
+    base = buffer;
+#endif
+
+    header = h;
+    fileBytes = (size_t) size;
+    directory = (const float*) (base + sizeof (h));
+    tilesOffset = offset;
+    tileBytes = bytes;
+
+    fieldMin = directory[0];
+    fieldMax = directory[1];
+    for (size_t i = 1; i < tileCount; i++)
+    {
+        fieldMin = std::min (fieldMin, directory[2 * i]);
+        fieldMax = std::max (fieldMax, directory[2 * i + 1]);
+    }
+
+    levelOffsets.clear ();
+    for (int level = 0; level <= h.tileLog2; level++)
+        levelOffsets.push_back (levelOffset (h.tileLog2, level));
+
+    lastUse.assign (tileCount, 0);
+    useClock = 0;
+    residentCount = 0;
+    return true;
+}
+
+
+void
+OpenSteer::TiledHeightfield::close (void)
+{
+    if (base != NULL)
+    {
+#ifndef _WIN32
+        munmap ((void*) base, fileBytes);
+#else
+        free ((void*) base);
+#endif
+    }
+    base = NULL;
+    directory = NULL;
+    fileBytes = 0;
+    lastUse.clear ();
+    residentCount = 0;
+    residentStorage.set (0);
+    memset (&header, 0, sizeof (header));
+}
+
+
+// ----------------------------------------------------------------------------
+// queries
+
+
+const float*
+OpenSteer::TiledHeightfield::tile (const int tx, const int tz) const
+{
+    const size_t index = (size_t) tx + (size_t) tz * header.tilesX;
+    if (lastUse[index] == 0)
+    {
+        residentCount++;
+        residentStorage.set (residentBytes ());
+    }
+    lastUse[index] = ++useClock;
+    return (const float*) (base + tilesOffset + index * tileBytes);
+}
+
+
+float
+OpenSteer::TiledHeightfield::vertexHeight (const int i, const int j) const
+{
+    const int k = header.tileLog2;
+    const int t = 1 << k;
+
+    // the last row and column of vertices belong to the tiles before them
+    const int tx = std::min (i >> k, header.tilesX - 1);
+    const int tz = std::min (j >> k, header.tilesZ - 1);
+    return tile (tx, tz) [(i - tx * t) + (j - tz * t) * (t + 1)];
+}
+
+
+float
+OpenSteer::TiledHeightfield::heightAt (const float x, const float z) const
+{
+    // cell containing the point and the position within it
+    const float u = (x - header.originX) / header.spacingX;
+    const float v = (z - header.originZ) / header.spacingZ;
+    const float uc = std::max (0.0f, std::min (u, (float) (header.width - 1)));
+    const float vc = std::max (0.0f, std::min (v, (float) (header.height - 1)));
+    const int i = std::min ((int) uc, header.width - 2);
+    const int j = std::min ((int) vc, header.height - 2);
+    const float fu = uc - i;
+    const float fv = vc - j;
+
+    const int k = header.tileLog2;
+    const int t = 1 << k;
+    const int tx = i >> k;
+    const int tz = j >> k;
+    const float* c = tile (tx, tz) + (i - tx * t) + (j - tz * t) * (t + 1);
+    const float h00 = c[0];
+    const float h10 = c[1];
+    const float h01 = c[t + 1];
+    const float h11 = c[t + 2];
+
+    // split along the diagonal from (i+1, j) to (i, j+1)
+    if (fu + fv <= 1)
+        return h00 + fu * (h10 - h00) + fv * (h01 - h00);
+    else
+        return h11 + (1 - fu) * (h01 - h11) + (1 - fv) * (h10 - h11);
+}
+
+
+float
+OpenSteer::TiledHeightfield::nodeMaxHeight (const int level,
+                                            const int x,
+                                            const int z) const
+{
+    const int k = header.tileLog2;
+    const int shift = k - level;
+    const int side = 1 << shift;
+    const int tx = x >> shift;
+    const int tz = z >> shift;
+    const int lx = x - tx * side;
+    const int lz = z - tz * side;
+    return tile (tx, tz) [levelOffsets[level] + lx + lz * side];
+}
+
+
+// ----------------------------------------------------------------------------
+// residency
+
+
+void
+OpenSteer::TiledHeightfield::prefetch (const float x,
+                                       const float z,
+                                       const float radius) const
+{
+    if (base == NULL) return;
+    const float tileX = header.spacingX * (1 << header.tileLog2);
+    const float tileZ = header.spacingZ * (1 << header.tileLog2);
+    const int x0 = clampIndex ((int) ((x - radius - header.originX) / tileX), header.tilesX);
+    const int x1 = clampIndex ((int) ((x + radius - header.originX) / tileX), header.tilesX);
+    const int z0 = clampIndex ((int) ((z - radius - header.originZ) / tileZ), header.tilesZ);
+    const int z1 = clampIndex ((int) ((z + radius - header.originZ) / tileZ), header.tilesZ);
+    for (int tz = z0; tz <= z1; tz++)
+    {
+        for (int tx = x0; tx <= x1; tx++)
+        {
+            const float* data = tile (tx, tz);
+#ifndef _WIN32
+            madvise ((void*) data, tileBytes, MADV_WILLNEED);
+#else
+            (void) data;
+#endif
+        }
+    }
+}
+
+
+int
+OpenSteer::TiledHeightfield::evictColdTiles (void)
+{
+    if (residentBytes () <= budget) return 0;
+
+    // resident tiles, least recently used first
+    std::vector<std::pair<unsigned long, size_t> > resident;
+    resident.reserve (residentCount);
+    for (size_t i = 0; i < lastUse.size (); i++)
+        if (lastUse[i] != 0) resident.push_back (std::make_pair (lastUse[i], i));
+    std::sort (resident.begin (), resident.end ());
+
+    int released = 0;
+    for (size_t r = 0; (r < resident.size ()) && (residentBytes () > budget); r++)
+    {
+        const size_t index = resident[r].second;
+#ifndef _WIN32
+        madvise ((void*) (base + tilesOffset + index * tileBytes),
+                 tileBytes, MADV_DONTNEED);
+#endif
+        lastUse[index] = 0;
+        residentCount--;
+        released++;
+    }
+    residentStorage.set (residentBytes ());
+    return released;
+}
+
+
+// ----------------------------------------------------------------------------
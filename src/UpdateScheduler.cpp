@@ -0,0 +1,354 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// UpdateScheduler
+//
+// See UpdateScheduler.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/UpdateScheduler.h"
+
+#include <algorithm>
+#include <limits>
+#include "OpenSteer/Proximity.h"
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::UpdateScheduler::UpdateScheduler (void)
+    : bandScale (1),
+      maxStaleness (0),
+      sleepMaxSpeed (0),
+      sleepMaxSteering (0),
+      sleepQuietUpdates (0),
+      sleepWakeRadius (0),
+      frame (0),
+      frameElapsedTime (0)
+{
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::UpdateScheduler::clearBands (void)
+{
+    bands.clear();
+}
+
+
+namespace {
+
+    // orders bands by distance
+    class NearerBand
+    {
+    public:
+        template <class Band>
+        bool operator() (const Band& a, const Band& b) const
+        {
+            return a.maxDistanceSquared < b.maxDistanceSquared;
+        }
+    };
+
+} // anonymous namespace
+
+
+void 
+OpenSteer::UpdateScheduler::addBand (const float maxDistance, const int period)
+{
+    bands.push_back (Band (maxDistance, std::max (period, 1)));
+    std::stable_sort (bands.begin(), bands.end(), NearerBand ());
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::UpdateScheduler::schedule (const Vec3* positions,
+                                      const size_t count,
+                                      const float elapsedTime)
+{
+    beginFrame (count, elapsedTime);
+    for (size_t i = 0; i < count; i++) scheduleAgent (i, positions[i]);
+    endFrame ();
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::UpdateScheduler::beginFrame (const size_t count,
+                                        const float elapsedTime)
+{
+    // new agents start out with nothing accumulated, so are due right
+    // away only on their phase
+    accumulated.resize (count, 0);
+    elapsed.resize (count);
+    due.resize (count);
+    agentBand.resize (count);
+    quietUpdates.resize (count, 0);
+    asleep.resize (count, 0);
+    active.resize (count, 1);
+    dueList.clear();
+    sleepers.clear();
+    sleeperPositions.clear();
+    wakers.clear();
+    frameElapsedTime = elapsedTime;
+}
+
+
+void 
+OpenSteer::UpdateScheduler::scheduleAgent (const size_t i,
+                                           const Vec3& position)
+{
+    // sleeping agents are at rest: not due, nothing accumulated
+    if (asleep[i])
+    {
+        due[i] = 0;
+        elapsed[i] = 0;
+        accumulated[i] = 0;
+        agentBand[i] = 0;
+        sleepers.push_back (i);
+        sleeperPositions.push_back (position);
+        return;
+    }
+    if (active[i] && (sleepWakeRadius > 0)) wakers.push_back (position);
+
+    const float total = accumulated[i] + frameElapsedTime;
+
+    // find the agent's band and its period
+    int b = 0;
+    int period = 1;
+    if (! bands.empty())
+    {
+        const float d2 = foci.empty() ? 0 : distanceSquaredToFoci (position);
+        const float scale2 = bandScale * bandScale;
+        const int last = (int) bands.size() - 1;
+        while ((b < last) && (d2 >= bands[b].maxDistanceSquared * scale2)) b++;
+        period = bands[b].period;
+    }
+    agentBand[i] = b;
+
+    // due on its phase of the band's period, or when it would get too stale
+    const bool onPhase = ((frame + i) % period) == 0;
+    const bool tooStale = (maxStaleness > 0) && (total >= maxStaleness);
+
+    if (onPhase || tooStale)
+    {
+        due[i] = 1;
+        elapsed[i] = total;
+        accumulated[i] = 0;
+        dueList.push_back (i);
+    }
+    else
+    {
+        due[i] = 0;
+        elapsed[i] = 0;
+        accumulated[i] = total;
+    }
+}
+
+
+// called for each sleeping agent near an active one
+
+
+class OpenSteer::UpdateScheduler::WakeSink
+{
+public:
+    WakeSink (UpdateScheduler& s) : scheduler (s), woken (false) {}
+    void operator() (const size_t i, float, const Vec3&)
+    {
+        if (! scheduler.asleep[i]) return;
+        scheduler.wakeNow (i);
+        woken = true;
+    }
+    UpdateScheduler& scheduler;
+    bool woken;
+};
+
+
+void 
+OpenSteer::UpdateScheduler::endFrame (void)
+{
+    // wake the sleeping agents near active ones, hashed in cells of the
+    // wake radius
+    if (! sleepers.empty() && ! wakers.empty())
+    {
+        const float r = sleepWakeRadius;
+        SpatialHashIndex<size_t> index (Vec3 (r, r, r));
+        index.build (sleepers, sleeperPositions);
+        WakeSink sink (*this);
+        for (size_t w = 0; w < wakers.size(); w++)
+            index.scan (wakers[w], r, sink);
+        if (sink.woken) std::sort (dueList.begin(), dueList.end());
+    }
+
+    frame++;
+}
+
+
+void 
+OpenSteer::UpdateScheduler::wakeNow (const size_t i)
+{
+    asleep[i] = 0;
+    quietUpdates[i] = 0;
+    active[i] = 1;
+    due[i] = 1;
+    elapsed[i] = frameElapsedTime;
+    dueList.push_back (i);
+}
+
+
+// ----------------------------------------------------------------------------
+// sleeping
+
+
+void 
+OpenSteer::UpdateScheduler::setSleeping (const float maxSpeed,
+                                         const float maxSteering,
+                                         const int quietUpdates,
+                                         const float wakeRadius)
+{
+    sleepMaxSpeed = maxSpeed;
+    sleepMaxSteering = maxSteering;
+    sleepQuietUpdates = std::max (quietUpdates, 0);
+    sleepWakeRadius = wakeRadius;
+    if (sleepQuietUpdates == 0)
+        for (size_t i = 0; i < asleep.size(); i++) wake (i);
+}
+
+
+void 
+OpenSteer::UpdateScheduler::noteActivity (const size_t i,
+                                          const float speed,
+                                          const float steering)
+{
+    if ((sleepQuietUpdates == 0) || (i >= asleep.size())) return;
+
+    const bool quiet = (speed <= sleepMaxSpeed) && (steering <= sleepMaxSteering);
+    active[i] = ! quiet;
+    if (! quiet)
+        quietUpdates[i] = 0;
+    else if (++quietUpdates[i] >= sleepQuietUpdates)
+        asleep[i] = 1;
+}
+
+
+void 
+OpenSteer::UpdateScheduler::wake (const size_t i)
+{
+    if (i >= asleep.size()) return;
+    asleep[i] = 0;
+    quietUpdates[i] = 0;
+    active[i] = 1;
+}
+
+
+size_t 
+OpenSteer::UpdateScheduler::sleepingCount (void) const
+{
+    return std::count (asleep.begin(), asleep.end(), 1);
+}
+
+
+// ----------------------------------------------------------------------------
+// reordering: the per agent state of agents not yet scheduled (past the end
+// of the state vectors) stays as it is
+
+
+namespace {
+
+    template <class T>
+    void swapElements (std::vector<T>& v, const size_t i, const size_t j)
+    {
+        if ((i < v.size()) && (j < v.size())) std::swap (v[i], v[j]);
+    }
+
+    template <class T>
+    void permuteElements (std::vector<T>& v, const std::vector<size_t>& order)
+    {
+        if (v.size() != order.size()) return;
+        std::vector<T> permuted (v.size());
+        for (size_t i = 0; i < order.size(); i++) permuted[i] = v[order[i]];
+        v.swap (permuted);
+    }
+
+} // anonymous namespace
+
+
+void 
+OpenSteer::UpdateScheduler::swapAgents (const size_t i, const size_t j)
+{
+    swapElements (accumulated, i, j);
+    swapElements (elapsed, i, j);
+    swapElements (due, i, j);
+    swapElements (agentBand, i, j);
+    swapElements (quietUpdates, i, j);
+    swapElements (asleep, i, j);
+    swapElements (active, i, j);
+}
+
+
+void 
+OpenSteer::UpdateScheduler::reorderAgents (const std::vector<size_t>& order)
+{
+    permuteElements (accumulated, order);
+    permuteElements (elapsed, order);
+    permuteElements (due, order);
+    permuteElements (agentBand, order);
+    permuteElements (quietUpdates, order);
+    permuteElements (asleep, order);
+    permuteElements (active, order);
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+float 
+OpenSteer::UpdateScheduler::distanceSquaredToFoci (const Vec3& position) const
+{
+    float nearest = std::numeric_limits<float>::max();
+    for (std::vector<Vec3>::const_iterator i = foci.begin(); i != foci.end(); i++)
+    {
+        const float d2 = (*i - position).lengthSquared ();
+        if (d2 < nearest) nearest = d2;
+    }
+    return nearest;
+}
+
+
+// ----------------------------------------------------------------------------
@@ -74,15 +74,15 @@ const OpenSteer::Vec3 OpenSteer::Vec3::side    (-1, 0, 0);
 
 
 OpenSteer::Vec3 
-OpenSteer::RandomVectorInUnitRadiusSphere (void)
+OpenSteer::RandomVectorInUnitRadiusSphere (RandomStream& random)
 {
     Vec3 v;
 
     do
     {
-        v.set ((frandom01()*2) - 1,
-               (frandom01()*2) - 1,
-               (frandom01()*2) - 1);
+        v.set ((random.frandom01()*2) - 1,
+               (random.frandom01()*2) - 1,
+               (random.frandom01()*2) - 1);
     }
     while (v.length() >= 1);
 
@@ -97,15 +97,15 @@ OpenSteer::RandomVectorInUnitRadiusSphere (void)
 
 
 OpenSteer::Vec3 
-OpenSteer::randomVectorOnUnitRadiusXZDisk (void)
+OpenSteer::randomVectorOnUnitRadiusXZDisk (RandomStream& random)
 {
     Vec3 v;
 
     do
     {
-        v.set ((frandom01()*2) - 1,
+        v.set ((random.frandom01()*2) - 1,
                0,
-               (frandom01()*2) - 1);
+               (random.frandom01()*2) - 1);
     }
     while (v.length() >= 1);
 
@@ -159,7 +159,7 @@ OpenSteer::vecLimitDeviationAngleUtility (const bool insideOrOutside,
     // and lies on the intersection of a plane (formed the source and
     // basis vectors) and a cone (whose axis is "basis" and whose
     // angle corresponds to cosineOfConeAngle)
-    float perpDist = sqrtXXX (1 - (cosineOfConeAngle * cosineOfConeAngle));
+    float perpDist = mathSqrt (1 - (cosineOfConeAngle * cosineOfConeAngle));
     const Vec3 c0 = basis * cosineOfConeAngle;
     const Vec3 c1 = unitPerp * perpDist;
     return (c0 + c1) * sourceLength;
@@ -0,0 +1,372 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Vec3Batch
+//
+// See Vec3Batch.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/Vec3Batch.h"
+
+#include <cmath>
+
+#if defined (__AVX2__)
+    #include <immintrin.h>
+    #define OPENSTEER_VEC3BATCH_AVX2
+#elif defined (__SSE2__) || defined (_M_X64)
+    #include <emmintrin.h>
+    #define OPENSTEER_VEC3BATCH_SSE2
+#elif defined (__ARM_NEON) && defined (__aarch64__)
+    #include <arm_neon.h>
+    #define OPENSTEER_VEC3BATCH_NEON
+#endif
+
+
+// ----------------------------------------------------------------------------
+// A minimal set of lane-wise operations for the selected instruction set.
+// Each batch operation below is written once in terms of these.
+
+
+namespace {
+
+
+#if defined (OPENSTEER_VEC3BATCH_AVX2)
+
+    const char* const instructionSetName = "AVX2";
+    const size_t laneCount = 8;
+    typedef __m256 Lanes;
+
+    inline Lanes load (const float* p) {return _mm256_loadu_ps (p);}
+    inline void store (float* p, Lanes a) {_mm256_storeu_ps (p, a);}
+    inline Lanes splat (float s) {return _mm256_set1_ps (s);}
+    inline Lanes add (Lanes a, Lanes b) {return _mm256_add_ps (a, b);}
+    inline Lanes sub (Lanes a, Lanes b) {return _mm256_sub_ps (a, b);}
+    inline Lanes mul (Lanes a, Lanes b) {return _mm256_mul_ps (a, b);}
+    inline Lanes div (Lanes a, Lanes b) {return _mm256_div_ps (a, b);}
+    inline Lanes squareRoot (Lanes a) {return _mm256_sqrt_ps (a);}
+
+    // per lane: (test > 0) ? a : b
+    inline Lanes selectPositive (Lanes test, Lanes a, Lanes b)
+    {
+        const Lanes mask = _mm256_cmp_ps (test, _mm256_setzero_ps (), _CMP_GT_OQ);
+        return _mm256_blendv_ps (b, a, mask);
+    }
+
+#elif defined (OPENSTEER_VEC3BATCH_SSE2)
+
+    const char* const instructionSetName = "SSE2";
+    const size_t laneCount = 4;
+    typedef __m128 Lanes;
+
+    inline Lanes load (const float* p) {return _mm_loadu_ps (p);}
+    inline void store (float* p, Lanes a) {_mm_storeu_ps (p, a);}
+    inline Lanes splat (float s) {return _mm_set1_ps (s);}
+    inline Lanes add (Lanes a, Lanes b) {return _mm_add_ps (a, b);}
+    inline Lanes sub (Lanes a, Lanes b) {return _mm_sub_ps (a, b);}
+    inline Lanes mul (Lanes a, Lanes b) {return _mm_mul_ps (a, b);}
+    inline Lanes div (Lanes a, Lanes b) {return _mm_div_ps (a, b);}
+    inline Lanes squareRoot (Lanes a) {return _mm_sqrt_ps (a);}
+
+    inline Lanes selectPositive (Lanes test, Lanes a, Lanes b)
+    {
+        const Lanes mask = _mm_cmpgt_ps (test, _mm_setzero_ps ());
+        return _mm_or_ps (_mm_and_ps (mask, a), _mm_andnot_ps (mask, b));
+    }
+
+#elif defined (OPENSTEER_VEC3BATCH_NEON)
+
+    const char* const instructionSetName = "NEON";
+    const size_t laneCount = 4;
+    typedef float32x4_t Lanes;
+
+    inline Lanes load (const float* p) {return vld1q_f32 (p);}
+    inline void store (float* p, Lanes a) {vst1q_f32 (p, a);}
+    inline Lanes splat (float s) {return vdupq_n_f32 (s);}
+    inline Lanes add (Lanes a, Lanes b) {return vaddq_f32 (a, b);}
+    inline Lanes sub (Lanes a, Lanes b) {return vsubq_f32 (a, b);}
+    inline Lanes mul (Lanes a, Lanes b) {return vmulq_f32 (a, b);}
+    inline Lanes div (Lanes a, Lanes b) {return vdivq_f32 (a, b);}
+    inline Lanes squareRoot (Lanes a) {return vsqrtq_f32 (a);}
+
+    inline Lanes selectPositive (Lanes test, Lanes a, Lanes b)
+    {
+        return vbslq_f32 (vcgtq_f32 (test, vdupq_n_f32 (0)), a, b);
+    }
+
+#else
+
+    const char* const instructionSetName = "scalar";
+
+#endif
+
+
+    // sum of the lanes of a
+#if defined (OPENSTEER_VEC3BATCH_AVX2) || defined (OPENSTEER_VEC3BATCH_SSE2) || defined (OPENSTEER_VEC3BATCH_NEON)
+    inline float sumLanes (Lanes a)
+    {
+        float lanes [laneCount];
+        store (lanes, a);
+        float sum = 0;
+        for (size_t i = 0; i < laneCount; i++) sum += lanes[i];
+        return sum;
+    }
+    #define OPENSTEER_VEC3BATCH_SIMD
+#endif
+
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+const char* 
+OpenSteer::vec3BatchInstructionSet (void)
+{
+    return instructionSetName;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::distanceSquaredMany (const Vec3& point,
+                                const float* x, const float* y, const float* z,
+                                size_t count,
+                                float* result)
+{
+    size_t i = 0;
+
+#if defined (OPENSTEER_VEC3BATCH_SIMD)
+    const Lanes px = splat (point.x);
+    const Lanes py = splat (point.y);
+    const Lanes pz = splat (point.z);
+    for (; i + laneCount <= count; i += laneCount)
+    {
+        const Lanes dx = sub (load (x + i), px);
+        const Lanes dy = sub (load (y + i), py);
+        const Lanes dz = sub (load (z + i), pz);
+        store (result + i, add (add (mul (dx, dx), mul (dy, dy)), mul (dz, dz)));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        const float dx = x[i] - point.x;
+        const float dy = y[i] - point.y;
+        const float dz = z[i] - point.z;
+        result[i] = (dx * dx) + (dy * dy) + (dz * dz);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::dotMany (const Vec3& v,
+                    const float* x, const float* y, const float* z,
+                    size_t count,
+                    float* result)
+{
+    size_t i = 0;
+
+#if defined (OPENSTEER_VEC3BATCH_SIMD)
+    const Lanes vx = splat (v.x);
+    const Lanes vy = splat (v.y);
+    const Lanes vz = splat (v.z);
+    for (; i + laneCount <= count; i += laneCount)
+    {
+        store (result + i, add (add (mul (vx, load (x + i)),
+                                     mul (vy, load (y + i))),
+                                mul (vz, load (z + i))));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        result[i] = (v.x * x[i]) + (v.y * y[i]) + (v.z * z[i]);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::normalizeMany (float* x, float* y, float* z, size_t count)
+{
+    size_t i = 0;
+
+#if defined (OPENSTEER_VEC3BATCH_SIMD)
+    for (; i + laneCount <= count; i += laneCount)
+    {
+        const Lanes vx = load (x + i);
+        const Lanes vy = load (y + i);
+        const Lanes vz = load (z + i);
+        const Lanes len = squareRoot (add (add (mul (vx, vx), mul (vy, vy)),
+                                           mul (vz, vz)));
+        // divide by one where the length is zero, leaving the vector as is
+        const Lanes divisor = selectPositive (len, len, splat (1));
+        store (x + i, div (vx, divisor));
+        store (y + i, div (vy, divisor));
+        store (z + i, div (vz, divisor));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        const float len = std::sqrt ((x[i] * x[i]) + (y[i] * y[i]) + (z[i] * z[i]));
+        if (len > 0)
+        {
+            x[i] /= len;
+            y[i] /= len;
+            z[i] /= len;
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::Vec3 
+OpenSteer::sumOfOffsets (const Vec3& point,
+                         const float* x, const float* y, const float* z,
+                         size_t count)
+{
+    size_t i = 0;
+    Vec3 sum;
+
+#if defined (OPENSTEER_VEC3BATCH_SIMD)
+    const Lanes px = splat (point.x);
+    const Lanes py = splat (point.y);
+    const Lanes pz = splat (point.z);
+    Lanes sx = splat (0);
+    Lanes sy = splat (0);
+    Lanes sz = splat (0);
+    for (; i + laneCount <= count; i += laneCount)
+    {
+        sx = add (sx, sub (load (x + i), px));
+        sy = add (sy, sub (load (y + i), py));
+        sz = add (sz, sub (load (z + i), pz));
+    }
+    sum = Vec3 (sumLanes (sx), sumLanes (sy), sumLanes (sz));
+#endif
+
+    for (; i < count; i++)
+    {
+        sum.x += x[i] - point.x;
+        sum.y += y[i] - point.y;
+        sum.z += z[i] - point.z;
+    }
+
+    return sum;
+}
+
+
+// ----------------------------------------------------------------------------
+// the order of operations is that of the scalar Vec3 expressions in
+// predictNearestApproachTime and computeNearestApproachPositions
+
+
+void 
+OpenSteer::nearestApproachMany (const Vec3& position, const Vec3& velocity,
+                                const float* px, const float* py, const float* pz,
+                                const float* vx, const float* vy, const float* vz,
+                                size_t count,
+                                float* time, float* distance)
+{
+    size_t i = 0;
+
+#if defined (OPENSTEER_VEC3BATCH_SIMD)
+    const Lanes ox = splat (position.x);
+    const Lanes oy = splat (position.y);
+    const Lanes oz = splat (position.z);
+    const Lanes wx = splat (velocity.x);
+    const Lanes wy = splat (velocity.y);
+    const Lanes wz = splat (velocity.z);
+    const Lanes zero = splat (0);
+    for (; i + laneCount <= count; i += laneCount)
+    {
+        const Lanes hx = load (px + i);
+        const Lanes hy = load (py + i);
+        const Lanes hz = load (pz + i);
+        const Lanes ux = load (vx + i);
+        const Lanes uy = load (vy + i);
+        const Lanes uz = load (vz + i);
+
+        // relative velocity and speed of the other vehicle
+        const Lanes rx = sub (ux, wx);
+        const Lanes ry = sub (uy, wy);
+        const Lanes rz = sub (uz, wz);
+        const Lanes speed = squareRoot (add (add (mul (rx, rx), mul (ry, ry)),
+                                             mul (rz, rz)));
+
+        // projection of the relative position on the relative path (lanes
+        // of zero relative speed are replaced by zero below)
+        const Lanes projection =
+            add (add (mul (div (rx, speed), sub (ox, hx)),
+                      mul (div (ry, speed), sub (oy, hy))),
+                 mul (div (rz, speed), sub (oz, hz)));
+        const Lanes t = selectPositive (speed, div (projection, speed), zero);
+        store (time + i, t);
+
+        const Lanes dx = sub (add (ox, mul (wx, t)), add (hx, mul (ux, t)));
+        const Lanes dy = sub (add (oy, mul (wy, t)), add (hy, mul (uy, t)));
+        const Lanes dz = sub (add (oz, mul (wz, t)), add (hz, mul (uz, t)));
+        store (distance + i,
+               squareRoot (add (add (mul (dx, dx), mul (dy, dy)), mul (dz, dz))));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        const Vec3 otherPosition (px[i], py[i], pz[i]);
+        const Vec3 otherVelocity (vx[i], vy[i], vz[i]);
+        const Vec3 relVelocity = otherVelocity - velocity;
+        const float relSpeed = relVelocity.length ();
+        float t = 0;
+        if (relSpeed != 0)
+        {
+            const Vec3 relTangent = relVelocity / relSpeed;
+            t = relTangent.dot (position - otherPosition) / relSpeed;
+        }
+        time[i] = t;
+        distance[i] = Vec3::distance (position + (velocity * t),
+                                      otherPosition + (otherVelocity * t));
+    }
+}
+
+
+// ----------------------------------------------------------------------------
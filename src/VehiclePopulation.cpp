@@ -0,0 +1,497 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// VehiclePopulation
+//
+// See VehiclePopulation.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/VehiclePopulation.h"
+
+#include <cmath>
+#include "OpenSteer/SimpleVehicle.h"
+#include "OpenSteer/WorkerPool.h"
+#include "OpenSteer/Utilities.h"
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::VehiclePopulation::VehiclePopulation (LocalSpaceMode mode)
+    : _mode (mode)
+{
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::VehiclePopulation::clear (void)
+{
+    _position.clear ();
+    _forward.clear ();
+    _side.clear ();
+    _up.clear ();
+    _smoothedAcceleration.clear ();
+    _smoothedPosition.clear ();
+    _speed.clear ();
+    _mass.clear ();
+    _maxForce.clear ();
+    _maxSpeed.clear ();
+    _radius.clear ();
+}
+
+
+void 
+OpenSteer::VehiclePopulation::reserve (size_t n)
+{
+    _position.reserve (n);
+    _forward.reserve (n);
+    _side.reserve (n);
+    _up.reserve (n);
+    _smoothedAcceleration.reserve (n);
+    _smoothedPosition.reserve (n);
+    _speed.reserve (n);
+    _mass.reserve (n);
+    _maxForce.reserve (n);
+    _maxSpeed.reserve (n);
+    _radius.reserve (n);
+}
+
+
+// ----------------------------------------------------------------------------
+// the values set by SimpleVehicle::reset
+
+
+size_t 
+OpenSteer::VehiclePopulation::add (void)
+{
+    _position.push_back (Vec3::zero);
+    _forward.push_back (Vec3::forward);
+    _side.push_back (Vec3 (-1, 0, 0));
+    _up.push_back (Vec3::up);
+    _smoothedAcceleration.push_back (Vec3::zero);
+    _smoothedPosition.push_back (Vec3::zero);
+    _speed.push_back (0);
+    _mass.push_back (1);
+    _maxForce.push_back (0.1f);
+    _maxSpeed.push_back (1.0f);
+    _radius.push_back (0.5f);
+    return size () - 1;
+}
+
+
+size_t 
+OpenSteer::VehiclePopulation::add (const SimpleVehicle& vehicle)
+{
+    const size_t i = add ();
+    load (i, vehicle);
+    return i;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::VehiclePopulation::remove (size_t i)
+{
+    const size_t last = size () - 1;
+    if (i != last)
+    {
+        _position.set (i, _position.get (last));
+        _forward.set (i, _forward.get (last));
+        _side.set (i, _side.get (last));
+        _up.set (i, _up.get (last));
+        _smoothedAcceleration.set (i, _smoothedAcceleration.get (last));
+        _smoothedPosition.set (i, _smoothedPosition.get (last));
+        _speed[i] = _speed[last];
+        _mass[i] = _mass[last];
+        _maxForce[i] = _maxForce[last];
+        _maxSpeed[i] = _maxSpeed[last];
+        _radius[i] = _radius[last];
+    }
+    _position.pop_back ();
+    _forward.pop_back ();
+    _side.pop_back ();
+    _up.pop_back ();
+    _smoothedAcceleration.pop_back ();
+    _smoothedPosition.pop_back ();
+    _speed.pop_back ();
+    _mass.pop_back ();
+    _maxForce.pop_back ();
+    _maxSpeed.pop_back ();
+    _radius.pop_back ();
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::VehiclePopulation::load (size_t i, const SimpleVehicle& vehicle)
+{
+    _position.set (i, vehicle.position ());
+    _forward.set (i, vehicle.forward ());
+    _side.set (i, vehicle.side ());
+    _up.set (i, vehicle.up ());
+    _smoothedAcceleration.set (i, vehicle.smoothedAcceleration ());
+    _smoothedPosition.set (i, vehicle.smoothedPosition ());
+    _speed[i] = vehicle.speed ();
+    _mass[i] = vehicle.mass ();
+    _maxForce[i] = vehicle.maxForce ();
+    _maxSpeed[i] = vehicle.maxSpeed ();
+    _radius[i] = vehicle.radius ();
+}
+
+
+void 
+OpenSteer::VehiclePopulation::store (size_t i, SimpleVehicle& vehicle) const
+{
+    vehicle.setPosition (position (i));
+    vehicle.setForward (forward (i));
+    vehicle.setSide (side (i));
+    vehicle.setUp (up (i));
+    vehicle.resetSmoothedAcceleration (smoothedAcceleration (i));
+    vehicle.resetSmoothedPosition (smoothedPosition (i));
+    vehicle.setSpeed (_speed[i]);
+    vehicle.setMass (_mass[i]);
+    vehicle.setMaxForce (_maxForce[i]);
+    vehicle.setMaxSpeed (_maxSpeed[i]);
+    vehicle.setRadius (_radius[i]);
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::VehiclePopulation::setForward (size_t i, const Vec3& newUnitForward)
+{
+    const Vec3 s = crossProduct (newUnitForward, up (i)).normalize ();
+    _forward.set (i, newUnitForward);
+    _side.set (i, s);
+    _up.set (i, crossProduct (s, newUnitForward));
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::VehiclePopulation::applySteeringForces (const Vec3* forces,
+                                                   const float elapsedTime)
+{
+    applySteeringForces (forces, elapsedTime, 0, size ());
+}
+
+
+// ----------------------------------------------------------------------------
+// The loop below is SimpleVehicle::applySteeringForce with the default
+// adjustRawSteeringForce and either regenerateLocalSpace or
+// regenerateLocalSpaceForBanking, written out over the component arrays.
+// Values which are the same for every vehicle are hoisted out of the loop.
+
+
+void 
+OpenSteer::VehiclePopulation::applySteeringForces (const Vec3* forces,
+                                                   const float elapsedTime,
+                                                   size_t begin,
+                                                   size_t end)
+{
+    if (_mode == planar)
+    {
+        applyPlanarSteeringForces (forces, elapsedTime, begin, end);
+        return;
+    }
+
+    float* const px = &_position.x[0];
+    float* const py = &_position.y[0];
+    float* const pz = &_position.z[0];
+    float* const fx = &_forward.x[0];
+    float* const fy = &_forward.y[0];
+    float* const fz = &_forward.z[0];
+    float* const sx = &_side.x[0];
+    float* const sy = &_side.y[0];
+    float* const sz = &_side.z[0];
+    float* const ux = &_up.x[0];
+    float* const uy = &_up.y[0];
+    float* const uz = &_up.z[0];
+    float* const ax = &_smoothedAcceleration.x[0];
+    float* const ay = &_smoothedAcceleration.y[0];
+    float* const az = &_smoothedAcceleration.z[0];
+    float* const qx = &_smoothedPosition.x[0];
+    float* const qy = &_smoothedPosition.y[0];
+    float* const qz = &_smoothedPosition.z[0];
+    float* const speed = &_speed[0];
+    const float* const mass = &_mass[0];
+    const float* const maxForce = &_maxForce[0];
+    const float* const maxSpeed = &_maxSpeed[0];
+
+    const bool smoothAcceleration = elapsedTime > 0;
+    const float accelerationRate = clip (clip (9 * elapsedTime, 0.15f, 0.4f),
+                                         0, 1);
+    const float positionRate = clip (elapsedTime * 0.06f, 0, 1);
+    const float bankRate = clip (elapsedTime * 3, 0, 1);
+    const bool bank = (_mode == banking);
+
+    for (size_t i = begin; i < end; i++)
+    {
+        // default adjustRawSteeringForce: no backward-facing steering at
+        // low speed
+        Vec3 force = forces[i];
+        const float maxAdjustedSpeed = 0.2f * maxSpeed[i];
+        if ((speed[i] <= maxAdjustedSpeed) && (force != Vec3::zero))
+        {
+            const float range = speed[i] / maxAdjustedSpeed;
+            const float cosine = interpolate (pow (range, 20), 1.0f, -1.0f);
+            force = limitMaxDeviationAngle (force, cosine,
+                                            Vec3 (fx[i], fy[i], fz[i]));
+        }
+
+        // enforce limit on magnitude of steering force, then acceleration
+        force = force.truncateLength (maxForce[i]);
+        const float nax = force.x / mass[i];
+        const float nay = force.y / mass[i];
+        const float naz = force.z / mass[i];
+
+        // damp out abrupt changes and oscillations in steering acceleration
+        if (smoothAcceleration)
+        {
+            ax[i] += (nax - ax[i]) * accelerationRate;
+            ay[i] += (nay - ay[i]) * accelerationRate;
+            az[i] += (naz - az[i]) * accelerationRate;
+        }
+
+        // Euler integrate acceleration into velocity, enforce speed limit
+        float vx = (fx[i] * speed[i]) + (ax[i] * elapsedTime);
+        float vy = (fy[i] * speed[i]) + (ay[i] * elapsedTime);
+        float vz = (fz[i] * speed[i]) + (az[i] * elapsedTime);
+        const float v2 = (vx * vx) + (vy * vy) + (vz * vz);
+        const float ms = maxSpeed[i];
+        if (v2 > ms * ms)
+        {
+            const float scale = ms / sqrtXXX (v2);
+            vx *= scale;
+            vy *= scale;
+            vz *= scale;
+        }
+        const float s = sqrtXXX ((vx * vx) + (vy * vy) + (vz * vz));
+        speed[i] = s;
+
+        // Euler integrate velocity into position
+        px[i] += vx * elapsedTime;
+        py[i] += vy * elapsedTime;
+        pz[i] += vz * elapsedTime;
+
+        // banking: blend turning acceleration plus a global up into UP
+        if (bank)
+        {
+            const float bx = ax[i] * 0.05f;
+            const float by = (ay[i] * 0.05f) + 0.2f;
+            const float bz = az[i] * 0.05f;
+            float tx = ux[i] + ((bx - ux[i]) * bankRate);
+            float ty = uy[i] + ((by - uy[i]) * bankRate);
+            float tz = uz[i] + ((bz - uz[i]) * bankRate);
+            const float tl = sqrtXXX ((tx * tx) + (ty * ty) + (tz * tz));
+            if (tl > 0) {tx /= tl; ty /= tl; tz /= tl;}
+            ux[i] = tx;
+            uy[i] = ty;
+            uz[i] = tz;
+        }
+
+        // align forward with the new velocity, side from new forward and
+        // old up, then up from side and forward (right handed)
+        if (s > 0)
+        {
+            const float nfx = vx / s;
+            const float nfy = vy / s;
+            const float nfz = vz / s;
+            float nsx = (nfy * uz[i]) - (nfz * uy[i]);
+            float nsy = (nfz * ux[i]) - (nfx * uz[i]);
+            float nsz = (nfx * uy[i]) - (nfy * ux[i]);
+            const float sl = sqrtXXX ((nsx * nsx) + (nsy * nsy) + (nsz * nsz));
+            if (sl > 0) {nsx /= sl; nsy /= sl; nsz /= sl;}
+            fx[i] = nfx;
+            fy[i] = nfy;
+            fz[i] = nfz;
+            sx[i] = nsx;
+            sy[i] = nsy;
+            sz[i] = nsz;
+            ux[i] = (nsy * nfz) - (nsz * nfy);
+            uy[i] = (nsz * nfx) - (nsx * nfz);
+            uz[i] = (nsx * nfy) - (nsy * nfx);
+        }
+
+        // running average of recent positions
+        qx[i] += (px[i] - qx[i]) * positionRate;
+        qy[i] += (py[i] - qy[i]) * positionRate;
+        qz[i] += (pz[i] - qz[i]) * positionRate;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// The loop above for PlanarVehicle: forces, accelerations and velocities
+// have no Y, so neither do the integration and the new forward, and side
+// is forward turned a quarter turn (right handed) about the unchanged up.
+
+
+void 
+OpenSteer::VehiclePopulation::applyPlanarSteeringForces (const Vec3* forces,
+                                                         const float elapsedTime,
+                                                         size_t begin,
+                                                         size_t end)
+{
+    float* const px = &_position.x[0];
+    float* const py = &_position.y[0];
+    float* const pz = &_position.z[0];
+    float* const fx = &_forward.x[0];
+    float* const fz = &_forward.z[0];
+    float* const sx = &_side.x[0];
+    float* const sz = &_side.z[0];
+    float* const ax = &_smoothedAcceleration.x[0];
+    float* const az = &_smoothedAcceleration.z[0];
+    float* const qx = &_smoothedPosition.x[0];
+    float* const qy = &_smoothedPosition.y[0];
+    float* const qz = &_smoothedPosition.z[0];
+    float* const speed = &_speed[0];
+    const float* const mass = &_mass[0];
+    const float* const maxForce = &_maxForce[0];
+    const float* const maxSpeed = &_maxSpeed[0];
+
+    const bool smoothAcceleration = elapsedTime > 0;
+    const float accelerationRate = clip (clip (9 * elapsedTime, 0.15f, 0.4f),
+                                         0, 1);
+    const float positionRate = clip (elapsedTime * 0.06f, 0, 1);
+
+    for (size_t i = begin; i < end; i++)
+    {
+        // the force on the plane, with the default adjustRawSteeringForce
+        Vec3 force (forces[i].x, 0, forces[i].z);
+        const float maxAdjustedSpeed = 0.2f * maxSpeed[i];
+        if ((speed[i] <= maxAdjustedSpeed) && (force != Vec3::zero))
+        {
+            const float range = speed[i] / maxAdjustedSpeed;
+            const float cosine = interpolate (pow (range, 20), 1.0f, -1.0f);
+            force = limitMaxDeviationAngle (force, cosine,
+                                            Vec3 (fx[i], 0, fz[i]));
+        }
+
+        // enforce limit on magnitude of steering force, then acceleration
+        const float f2 = (force.x * force.x) + (force.z * force.z);
+        const float mf = maxForce[i];
+        const float forceScale = (f2 > mf * mf) ? mf / sqrtXXX (f2) : 1;
+        const float nax = (force.x * forceScale) / mass[i];
+        const float naz = (force.z * forceScale) / mass[i];
+
+        // damp out abrupt changes and oscillations in steering acceleration
+        if (smoothAcceleration)
+        {
+            ax[i] += (nax - ax[i]) * accelerationRate;
+            az[i] += (naz - az[i]) * accelerationRate;
+        }
+
+        // Euler integrate acceleration into velocity, enforce speed limit
+        float vx = (fx[i] * speed[i]) + (ax[i] * elapsedTime);
+        float vz = (fz[i] * speed[i]) + (az[i] * elapsedTime);
+        const float v2 = (vx * vx) + (vz * vz);
+        const float ms = maxSpeed[i];
+        if (v2 > ms * ms)
+        {
+            const float scale = ms / sqrtXXX (v2);
+            vx *= scale;
+            vz *= scale;
+        }
+        const float s = sqrtXXX ((vx * vx) + (vz * vz));
+        speed[i] = s;
+
+        // Euler integrate velocity into position
+        px[i] += vx * elapsedTime;
+        pz[i] += vz * elapsedTime;
+
+        // align forward with the new velocity, side a quarter turn from it
+        if (s > 0)
+        {
+            fx[i] = vx / s;
+            fz[i] = vz / s;
+            sx[i] = -fz[i];
+            sz[i] = fx[i];
+        }
+
+        // running average of recent positions
+        qx[i] += (px[i] - qx[i]) * positionRate;
+        qy[i] += (py[i] - qy[i]) * positionRate;
+        qz[i] += (pz[i] - qz[i]) * positionRate;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+namespace {
+
+    class ApplySteeringForces
+    {
+    public:
+        ApplySteeringForces (OpenSteer::VehiclePopulation& p,
+                             const OpenSteer::Vec3* f,
+                             const float dt)
+            : population (p), forces (f), elapsedTime (dt) {}
+
+        void operator() (size_t begin, size_t end)
+        {
+            population.applySteeringForces (forces, elapsedTime, begin, end);
+        }
+
+    private:
+        OpenSteer::VehiclePopulation& population;
+        const OpenSteer::Vec3* forces;
+        const float elapsedTime;
+    };
+
+} // anonymous namespace
+
+
+void 
+OpenSteer::VehiclePopulation::applySteeringForces (const Vec3* forces,
+                                                   const float elapsedTime,
+                                                   WorkerPool& pool)
+{
+    ApplySteeringForces body (*this, forces, elapsedTime);
+    pool.parallelFor (size (), body);
+}
+
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,278 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// ViewFrustum
+//
+// See ViewFrustum.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/ViewFrustum.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "OpenSteer/Utilities.h"
+
+
+namespace {
+
+    using OpenSteer::Vec3;
+
+    // points of one shape this close outside the other still count as
+    // inside, against rounding in the clipping below
+    const float tolerance = 1e-3f;
+
+    // corner i of a box: at hi along axis k if bit k of i is set
+    Vec3 boxCorner (const Vec3& lo, const Vec3& hi, const int i)
+    {
+        return Vec3 ((i & 1) ? hi.x : lo.x,
+                     (i & 2) ? hi.y : lo.y,
+                     (i & 4) ? hi.z : lo.z);
+    }
+
+    float component (const Vec3& v, const int axis)
+    {
+        return (axis == 0) ? v.x : ((axis == 1) ? v.y : v.z);
+    }
+
+    bool insideBox (const Vec3& lo, const Vec3& hi, const Vec3& p)
+    {
+        return ((p.x >= lo.x - tolerance) && (p.x <= hi.x + tolerance) &&
+                (p.y >= lo.y - tolerance) && (p.y <= hi.y + tolerance) &&
+                (p.z >= lo.z - tolerance) && (p.z <= hi.z + tolerance));
+    }
+
+    // the 12 edges of a box or frustum whose corners are numbered by three
+    // bits: pairs of corners differing in one bit
+    void edge (const int e, int& a, int& b)
+    {
+        const int bit = 1 << (e / 4);
+        const int rest = e % 4;
+        // spread the two remaining bits around the edge's bit
+        const int low = rest & (bit - 1);
+        a = low | ((rest & ~(bit - 1)) << 1);
+        b = a | bit;
+    }
+
+    // accumulates the bounds of a set of points
+    class Bounds
+    {
+    public:
+        Bounds (void) : empty (true) {}
+        void add (const Vec3& p)
+        {
+            if (empty) {lo = hi = p; empty = false; return;}
+            lo = Vec3 (std::min (lo.x, p.x), std::min (lo.y, p.y), std::min (lo.z, p.z));
+            hi = Vec3 (std::max (hi.x, p.x), std::max (hi.y, p.y), std::max (hi.z, p.z));
+        }
+        bool empty;
+        Vec3 lo, hi;
+    };
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::ViewFrustum::ViewFrustum (const Vec3& eye,
+                                     const Vec3& target,
+                                     const Vec3& up,
+                                     const float fieldOfViewY,
+                                     const float aspectRatio,
+                                     const float nearDistance,
+                                     const float farDistance)
+{
+    // orthonormal view basis, as gluLookAt makes it
+    const Vec3 forward = (target - eye).normalize ();
+    const Vec3 side = crossProduct (forward, up).normalize ();
+    const Vec3 trueUp = crossProduct (side, forward);
+
+    const float slope = std::tan (fieldOfViewY * 0.5f * OPENSTEER_M_PI / 180);
+    for (int i = 0; i < 8; i++)
+    {
+        const float d = (i & 4) ? farDistance : nearDistance;
+        const float h = d * slope;
+        const float w = h * aspectRatio;
+        corners[i] = (eye + (forward * d) +
+                      (side * ((i & 1) ? w : -w)) +
+                      (trueUp * ((i & 2) ? h : -h)));
+    }
+
+    // a plane through three corners of each face, turned to face the
+    // frustum's center
+    Vec3 center;
+    for (int i = 0; i < 8; i++) center += corners[i];
+    center /= 8;
+    for (int p = 0; p < 6; p++)
+    {
+        const int bit = 1 << (p / 2);
+        const int set = (p & 1) ? bit : 0;
+        int face [4];
+        int n = 0;
+        for (int i = 0; i < 8; i++) if ((i & bit) == set) face[n++] = i;
+        // (the first, second and last of a face's corners are never on
+        // one line)
+        const Vec3& a = corners[face[0]];
+        const Vec3& b = corners[face[1]];
+        const Vec3& c = corners[face[3]];
+        Vec3 normal = crossProduct (b - a, c - a).normalize ();
+        float offset = -normal.dot (a);
+        if (normal.dot (center) + offset < 0)
+        {
+            normal = -normal;
+            offset = -offset;
+        }
+        normals[p] = normal;
+        offsets[p] = offset;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+bool 
+OpenSteer::ViewFrustum::intersectsSphere (const Vec3& center,
+                                          const float radius) const
+{
+    for (int p = 0; p < 6; p++)
+        if (planeDistance (p, center) < -radius) return false;
+    return true;
+}
+
+
+bool 
+OpenSteer::ViewFrustum::contains (const Vec3& point,
+                                  const float slack) const
+{
+    for (int p = 0; p < 6; p++)
+        if (planeDistance (p, point) < -slack) return false;
+    return true;
+}
+
+
+// ----------------------------------------------------------------------------
+// the intersection of the frustum and the box is a convex polyhedron whose
+// corners are corners of either shape inside the other, or crossings of an
+// edge of one with a face of the other: bound those
+
+
+bool 
+OpenSteer::ViewFrustum::boundingSphereWithin (const Vec3& lo,
+                                              const Vec3& hi,
+                                              Vec3& center,
+                                              float& radius) const
+{
+    Bounds bounds;
+
+    for (int i = 0; i < 8; i++)
+    {
+        if (insideBox (lo, hi, corners[i])) bounds.add (corners[i]);
+        const Vec3 c = boxCorner (lo, hi, i);
+        if (contains (c, tolerance)) bounds.add (c);
+    }
+
+    for (int e = 0; e < 12; e++)
+    {
+        int i, j;
+        edge (e, i, j);
+
+        // frustum edge against the box's faces
+        const Vec3& a = corners[i];
+        const Vec3& b = corners[j];
+        for (int axis = 0; axis < 3; axis++)
+        {
+            const float pa = component (a, axis);
+            const float pb = component (b, axis);
+            for (int side = 0; side < 2; side++)
+            {
+                const float v = component (side ? hi : lo, axis);
+                if ((pa - v) * (pb - v) < 0)
+                {
+                    const Vec3 p = interpolate ((v - pa) / (pb - pa), a, b);
+                    if (insideBox (lo, hi, p)) bounds.add (p);
+                }
+            }
+        }
+
+        // box edge against the frustum's planes
+        const Vec3 c = boxCorner (lo, hi, i);
+        const Vec3 d = boxCorner (lo, hi, j);
+        for (int p = 0; p < 6; p++)
+        {
+            const float dc = planeDistance (p, c);
+            const float dd = planeDistance (p, d);
+            if (dc * dd < 0)
+            {
+                const Vec3 q = interpolate (dc / (dc - dd), c, d);
+                if (contains (q, tolerance)) bounds.add (q);
+            }
+        }
+    }
+
+    if (bounds.empty) return false;
+    center = (bounds.lo + bounds.hi) / 2;
+    radius = (bounds.hi - bounds.lo).length () / 2;
+    return true;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::ViewFrustum::findVisibleVehicles (AbstractTokenForProximityDatabase<AbstractVehicle*>& token,
+                                             const Vec3& lo,
+                                             const Vec3& hi,
+                                             const float maxRadius,
+                                             AVGroup& results) const
+{
+    // any visible point of a vehicle lies within the box grown by its
+    // radius, so within the sphere bounding that box's visible part
+    const Vec3 margin (maxRadius, maxRadius, maxRadius);
+    Vec3 center;
+    float radius;
+    if (! boundingSphereWithin (lo - margin, hi + margin, center, radius))
+        return;
+
+    const size_t first = results.size ();
+    token.findNeighbors (center, radius + maxRadius, results);
+
+    // keep those intersecting the frustum
+    size_t kept = first;
+    for (size_t i = first; i < results.size (); i++)
+    {
+        AbstractVehicle* const v = results[i];
+        if (intersectsSphere (v->position (), v->radius ()))
+            results[kept++] = v;
+    }
+    results.resize (kept);
+}
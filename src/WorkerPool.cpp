@@ -0,0 +1,253 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// WorkerPool
+//
+// See WorkerPool.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/WorkerPool.h"
+
+#include <algorithm>
+#include "OpenSteer/Profiler.h"
+
+
+// ----------------------------------------------------------------------------
+// two-phase parallel PlugIn update: master on/off switch
+
+
+bool OpenSteer::enableParallelUpdate = false;
+
+
+// ----------------------------------------------------------------------------
+// index of the calling thread within its pool, zero outside workers
+
+
+namespace {
+
+    thread_local int workerThreadIndex = 0;
+
+} // anonymous namespace
+
+
+int 
+OpenSteer::WorkerPool::currentThreadIndex (void)
+{
+    return workerThreadIndex;
+}
+
+
+// ----------------------------------------------------------------------------
+// constructor and destructor
+
+
+OpenSteer::WorkerPool::WorkerPool (int threadCount)
+    : jobFunction (NULL),
+      jobBody (NULL),
+      jobCount (0),
+      jobGrainSize (1),
+      nextIndex (0),
+      jobGeneration (0),
+      busyWorkers (0),
+      stopping (false),
+      running (false)
+{
+    startWorkers (threadCount);
+}
+
+
+OpenSteer::WorkerPool::~WorkerPool ()
+{
+    stopWorkers ();
+}
+
+
+// ----------------------------------------------------------------------------
+// shared pool sized to the hardware
+
+
+OpenSteer::WorkerPool& 
+OpenSteer::WorkerPool::shared (void)
+{
+    static WorkerPool pool;
+    return pool;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::WorkerPool::setThreadCount (int threadCount)
+{
+    stopWorkers ();
+    startWorkers (threadCount);
+}
+
+
+void 
+OpenSteer::WorkerPool::startWorkers (int threadCount)
+{
+    if (threadCount <= 0)
+    {
+        threadCount = (int) std::thread::hardware_concurrency ();
+        if (threadCount <= 0) threadCount = 1;
+    }
+
+    stopping = false;
+    for (int i = 1; i < threadCount; i++)
+    {
+        workers.push_back (std::thread (&WorkerPool::workerLoop,
+                                        this,
+                                        i,
+                                        jobGeneration));
+    }
+}
+
+
+void 
+OpenSteer::WorkerPool::stopWorkers (void)
+{
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+        stopping = true;
+    }
+    wakeWorkers.notify_all ();
+    for (size_t i = 0; i < workers.size(); i++) workers[i].join ();
+    workers.clear ();
+}
+
+
+// ----------------------------------------------------------------------------
+// run one parallel loop: publish the job, wake the workers, help with the
+// work, then wait until no worker is still inside it
+
+
+void 
+OpenSteer::WorkerPool::run (size_t count,
+                            size_t grainSize,
+                            rangeCallBackFunction f,
+                            void* body)
+{
+    if (count == 0) return;
+
+    OPENSTEER_PROFILE_SCOPE ("parallelFor");
+
+    // by default aim for several chunks per thread, for load balance
+    if (grainSize == 0)
+    {
+        const size_t chunks = 4 * threadCount ();
+        grainSize = std::max<size_t> (1, (count + chunks - 1) / chunks);
+    }
+
+    // no workers, a single chunk, or the pool is already running a loop
+    // (this one is nested in its body or called from another thread): just
+    // do it on this thread, still in ranges of at most grainSize
+    if (workers.empty() || (count <= grainSize) || running.exchange (true))
+    {
+        for (size_t begin = 0; begin < count; begin += grainSize)
+            f (body, begin, std::min (begin + grainSize, count));
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+        jobFunction = f;
+        jobBody = body;
+        jobCount = count;
+        jobGrainSize = grainSize;
+        nextIndex = 0;
+        busyWorkers = (int) workers.size();
+        jobGeneration++;
+    }
+    wakeWorkers.notify_all ();
+
+    claimChunks ();
+
+    std::unique_lock<std::mutex> lock (mutex);
+    while (busyWorkers > 0) jobDone.wait (lock);
+    running = false;
+}
+
+
+// ----------------------------------------------------------------------------
+// claim and run chunks of the current job until none are left
+
+
+void 
+OpenSteer::WorkerPool::claimChunks (void)
+{
+    for (;;)
+    {
+        const size_t begin = nextIndex.fetch_add (jobGrainSize);
+        if (begin >= jobCount) return;
+        const size_t end = std::min (begin + jobGrainSize, jobCount);
+        OPENSTEER_PROFILE_SCOPE ("chunk");
+        jobFunction (jobBody, begin, end);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// body of each worker thread: wait for a job newer than seenGeneration (or
+// for shutdown), help with it, report completion
+
+
+void 
+OpenSteer::WorkerPool::workerLoop (int threadIndex,
+                                   unsigned long seenGeneration)
+{
+    Profiler::setThreadName ("worker");
+    workerThreadIndex = threadIndex;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock (mutex);
+            while (!stopping && (jobGeneration == seenGeneration))
+                wakeWorkers.wait (lock);
+            if (stopping) return;
+            seenGeneration = jobGeneration;
+        }
+
+        claimChunks ();
+
+        {
+            std::lock_guard<std::mutex> lock (mutex);
+            busyWorkers--;
+        }
+        jobDone.notify_one ();
+    }
+}
+
+
+// ----------------------------------------------------------------------------
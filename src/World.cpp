@@ -0,0 +1,201 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+// World
+//
+// Independent simulations in one process.  See World.h
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/World.h"
+
+#include "OpenSteer/Annotation.h"
+#include "OpenSteer/WorkerPool.h"
+
+
+namespace {
+
+    // stream number of a World's default stream, clear of the stream
+    // numbers of its vehicles (which count up from zero)
+    const uint64_t worldStream = 1ULL << 62;
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::World::World (AbstractPlugIn& prototype, const uint64_t seed)
+    : instance (prototype.newWorldInstance ()),
+      worldSeed (seed),
+      random (seed, worldStream),
+      vehicleCount (0),
+      time (0),
+      steps (0),
+      opened (false)
+{
+}
+
+
+OpenSteer::World::~World ()
+{
+    if (opened) close ();
+    delete instance;
+}
+
+
+void 
+OpenSteer::World::open (void)
+{
+    if (opened) return;
+    RandomScope scope (random, worldSeed, vehicleCount);
+    instance->open ();
+    time = 0;
+    steps = 0;
+    opened = true;
+}
+
+
+void 
+OpenSteer::World::step (const float elapsedTime)
+{
+    if (! opened) return;
+    RandomScope scope (random, worldSeed, vehicleCount);
+    time += elapsedTime;
+    instance->update (time, elapsedTime);
+    steps++;
+}
+
+
+void 
+OpenSteer::World::close (void)
+{
+    if (! opened) return;
+    RandomScope scope (random, worldSeed, vehicleCount);
+    instance->close ();
+    opened = false;
+}
+
+
+bool 
+OpenSteer::World::setPopulation (const int count)
+{
+    if (! opened) return false;
+    RandomScope scope (random, worldSeed, vehicleCount);
+    return instance->setPopulation (count);
+}
+
+
+bool 
+OpenSteer::World::setParameter (const char* name, const float value)
+{
+    if (! opened) return false;
+    RandomScope scope (random, worldSeed, vehicleCount);
+    return instance->setParameter (name, value);
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+// loop body handing the Worlds to the pool's threads
+
+
+class OpenSteer::WorldScheduler::ActionBody
+{
+public:
+    ActionBody (std::vector<World*>& w,
+                const Action a,
+                const float e,
+                const int s)
+        : worlds (w), action (a), elapsedTime (e), stepCount (s) {}
+
+    void operator() (size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            World& world = *worlds[i];
+            switch (action)
+            {
+            case openAction: world.open (); break;
+            case stepAction:
+                for (int s = 0; s < stepCount; s++) world.step (elapsedTime);
+                break;
+            case closeAction: world.close (); break;
+            }
+        }
+    }
+
+private:
+    std::vector<World*>& worlds;
+    const Action action;
+    const float elapsedTime;
+    const int stepCount;
+};
+
+
+OpenSteer::WorldScheduler::WorldScheduler (WorkerPool& p) : pool (p) {}
+
+
+void 
+OpenSteer::WorldScheduler::openAll (void)
+{
+    runAll (openAction, 0, 0);
+}
+
+
+void 
+OpenSteer::WorldScheduler::closeAll (void)
+{
+    runAll (closeAction, 0, 0);
+}
+
+
+void 
+OpenSteer::WorldScheduler::step (const float elapsedTime, const int stepCount)
+{
+    runAll (stepAction, elapsedTime, stepCount);
+}
+
+
+void 
+OpenSteer::WorldScheduler::runAll (const Action action,
+                                   const float elapsedTime,
+                                   const int stepCount)
+{
+    // annotation is not thread-safe, so it is off meanwhile
+    const bool annotation = annotationIsOn ();
+    setAnnotationOff ();
+
+    // one World at a time per thread
+    ActionBody body (worlds, action, elapsedTime, stepCount);
+    pool.parallelFor (worlds.size(), body, 1);
+
+    if (annotation) setAnnotationOn ();
+}
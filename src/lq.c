@@ -59,6 +59,8 @@
 /*           definitions: lqFindNearestHelper lqFindNearestState      */
 /*           Add lqMapOverAllObjects and lqRemoveAllObjects (plus:    */
 /*           lqMapOverAllObjectsInBin and lqRemoveAllObjectsInBin)    */
+/*           (since replaced by the shell search of                   */
+/*           lqFindKNearestNeighborsWithinRadius)                     */
 /*                                                                    */
 /* ------------------------------------------------------------------ */
 
@@ -104,9 +106,25 @@ typedef struct lqInternalDB
     /* extra bin for "everything else" (points outside super-brick) */
     lqClientProxy* other;
 
+    /* scratch space for lqUpdateManyForNewLocations: the proxies which
+       change bins during one batch update, and its allocated length */
+    struct lqBinMove* moves;
+    int movesCapacity;
+
 } lqInternalDB;
 
 
+/* one proxy changing bins in a batch update: its index in the batch
+   and its destination bin */
+typedef struct lqBinMove
+{
+    int binIndex;
+    int batchIndex;
+    lqClientProxy* proxy;
+
+} lqBinMove;
+
+
 /* ------------------------------------------------------------------ */
 /* Allocate and initialize an LQ database, return a pointer to it.
    The application needs to call this before using the LQ facility.
@@ -139,6 +157,7 @@ lqInternalDB* lqCreateDatabase (float originx, float originy, float originz,
 
 void lqDeleteDatabase(lqDB* lq)
 {
+    free (lq->moves);
     free (lq->bins);
     free (lq);
 }
@@ -172,6 +191,8 @@ void lqInitDatabase (lqInternalDB* lq,
 	for (i=0; i<bincount; i++) lq->bins[i] = NULL;
     }
     lq->other = NULL;
+    lq->moves = NULL;
+    lq->movesCapacity = 0;
 }
 
 
@@ -215,6 +236,57 @@ lqClientProxy** lqBinForLocation (lqInternalDB* lq,
 }
 
 
+/* ------------------------------------------------------------------ */
+/* Change the number of sub-brick divisions of an existing database:
+   allocate the new bin array and relink each object of the old one
+   into its new bin (which takes no more than one pass over the objects
+   and bins).  Objects in the "other" bin stay there. */
+
+
+void lqResizeBins (lqInternalDB* lq, int divx, int divy, int divz)
+{
+    lqClientProxy** oldBins = lq->bins;
+    int oldBincount = lq->divx * lq->divy * lq->divz;
+    int i;
+
+    lq->divx = divx;
+    lq->divy = divy;
+    lq->divz = divz;
+    {
+	int bincount = divx * divy * divz;
+	int arraysize = sizeof (lqClientProxy*) * bincount;
+	lq->bins = (lqClientProxy**) malloc (arraysize);
+	for (i=0; i<bincount; i++) lq->bins[i] = NULL;
+    }
+
+    for (i=0; i<oldBincount; i++)
+    {
+	lqClientProxy* object = oldBins[i];
+	while (object != NULL)
+	{
+	    lqClientProxy* next = object->next;
+	    lqAddToBin (object,
+			lqBinForLocation (lq, object->x, object->y, object->z));
+	    object = next;
+	}
+    }
+    free (oldBins);
+}
+
+
+/* ------------------------------------------------------------------ */
+/* Find the linear index of the bin for a location, -1 for the "other"
+   bin, by the same rule as lqBinForLocation. */
+
+
+int lqBinIndexForLocation (lqInternalDB* lq, float x, float y, float z)
+{
+    lqClientProxy** bin = lqBinForLocation (lq, x, y, z);
+
+    return (bin == &(lq->other)) ? -1 : (int) (bin - lq->bins);
+}
+
+
 /* ------------------------------------------------------------------ */
 /* The application needs to call this once on each lqClientProxy at
    setup time to initialize its list pointers and associate the proxy
@@ -315,12 +387,96 @@ void lqUpdateForNewLocation  (lqInternalDB* lq,
 
 
 /* ------------------------------------------------------------------ */
-/* Given a bin's list of client proxies, traverse the list and invoke
-   the given lqCallBackFunction on each object that falls within the
-   search radius.  */
+/* Batch form of lqUpdateForNewLocation for count proxies at once.  The
+   locations of all proxies are stored first.  Then the proxies whose
+   bin changed are moved between bin lists in order of destination
+   bin, which keeps bin list writes together.  binIndices, if not NULL,
+   holds each proxy's new bin as given by lqBinIndexForLocation (so the
+   caller may compute those concurrently beforehand); otherwise the
+   bins are found here.  */
+
+
+int lqCompareBinMoves (const void* a, const void* b);
+
+int lqCompareBinMoves (const void* a, const void* b)
+{
+    const lqBinMove* ma = (const lqBinMove*) a;
+    const lqBinMove* mb = (const lqBinMove*) b;
+
+    /* order by destination bin, then by position in the batch */
+    if (ma->binIndex != mb->binIndex)
+	return (ma->binIndex < mb->binIndex) ? -1 : 1;
+    return (ma->batchIndex < mb->batchIndex) ? -1 :
+	((ma->batchIndex > mb->batchIndex) ? 1 : 0);
+}
+
+
+int lqUpdateManyForNewLocations (lqInternalDB* lq,
+				 lqClientProxy** proxies,
+				 const float* x, const float* y, const float* z,
+				 const int* binIndices,
+				 int count)
+{
+    int i;
+    int moveCount = 0;
+
+    /* make sure the scratch space can hold a move for every proxy */
+    if (lq->movesCapacity < count)
+    {
+	free (lq->moves);
+	lq->moves = (lqBinMove*) malloc (sizeof (lqBinMove) * count);
+	lq->movesCapacity = count;
+    }
+
+    /* store new locations, note which proxies change bins */
+    for (i = 0; i < count; i++)
+    {
+	lqClientProxy* object = proxies[i];
+	const int binIndex = (binIndices != NULL) ?
+	    binIndices[i] :
+	    lqBinIndexForLocation (lq, x[i], y[i], z[i]);
+	lqClientProxy** newBin = (binIndex < 0) ?
+	    &(lq->other) :
+	    &(lq->bins[binIndex]);
+
+	object->x = x[i];
+	object->y = y[i];
+	object->z = z[i];
+
+	if (newBin != object->bin)
+	{
+	    lq->moves[moveCount].binIndex = binIndex;
+	    lq->moves[moveCount].batchIndex = i;
+	    lq->moves[moveCount].proxy = object;
+	    moveCount++;
+	}
+    }
+
+    /* migrate the movers in order of destination bin */
+    qsort (lq->moves, moveCount, sizeof (lqBinMove), lqCompareBinMoves);
+    for (i = 0; i < moveCount; i++)
+    {
+	const lqBinMove* move = &(lq->moves[i]);
+	lqRemoveFromBin (move->proxy);
+	lqAddToBin (move->proxy,
+		    (move->binIndex < 0) ?
+		    &(lq->other) :
+		    &(lq->bins[move->binIndex]));
+    }
+    return moveCount;
+}
+
+
+/* ------------------------------------------------------------------ */
+/* Given a bin's list of client proxies, traverse the list and make
+   the given call (of an lqCallBackFunction or lqOffsetCallBackFunction,
+   given the object, distanceSquared and the offset dx, dy, dz from it
+   to the center) for each object that falls within the search radius,
+   counting the objects tested and accepted.  */
 
 
-#define lqTraverseBinClientObjectList(co, radiusSquared, func, state) \
+#define lqTraverseBinClientObjectList(co, radiusSquared, call,        \
+				      tested, accepted)               \
     while (co != NULL)                                                \
     {                                                                 \
 	/* compute distance (squared) from this client   */           \
@@ -329,22 +485,105 @@ void lqUpdateForNewLocation  (lqInternalDB* lq,
 	float dy = y - co->y;                                         \
 	float dz = z - co->z;                                         \
 	float distanceSquared = (dx * dx) + (dy * dy) + (dz * dz);    \
+	tested++;                                                     \
                                                                       \
 	/* apply function if client object within sphere */           \
 	if (distanceSquared < radiusSquared)                          \
-	    (*func) (co->object, distanceSquared, state);             \
+	{                                                             \
+	    call;                                                     \
+	    accepted++;                                               \
+	}                                                             \
                                                                       \
 	/* consider next client object in bin list */                 \
 	co = co->next;                                                \
     }
 
 
+/* ------------------------------------------------------------------ */
+/* Traverse the bins from (minBinX, minBinY, minBinZ) to (maxBinX,
+   maxBinY, maxBinZ), making the given call for each object within the
+   radius (see lqTraverseBinClientObjectList).  */
+
+
+#ifdef BOIDS_LQ_DEBUG
+#define lqDebugDrawBin(lq, bin) if (lqAnnoteEnable) drawBin (lq, bin)
+#else
+#define lqDebugDrawBin(lq, bin)
+#endif
+
+
+#define lqTraverseBinRange(call)                                      \
+    /* loop for x bins across diameter of sphere */                   \
+    iindex = istart;                                                  \
+    for (i = minBinX; i <= maxBinX; i++)                              \
+    {                                                                 \
+	/* loop for y bins across diameter of sphere */               \
+	jindex = jstart;                                              \
+	for (j = minBinY; j <= maxBinY; j++)                          \
+	{                                                             \
+	    /* loop for z bins across diameter of sphere */           \
+	    kindex = kstart;                                          \
+	    for (k = minBinZ; k <= maxBinZ; k++)                      \
+	    {                                                         \
+		/* traverse current bin's client object list */       \
+		co = lq->bins[iindex + jindex + kindex];              \
+		lqDebugDrawBin (lq, &lq->bins[iindex + jindex + kindex]); \
+		lqTraverseBinClientObjectList (co, radiusSquared,     \
+					       call, tested, accepted); \
+		kindex += 1;                                          \
+	    }                                                         \
+	    jindex += row;                                            \
+	}                                                             \
+	iindex += slab;                                               \
+    }
+
+
+/* ------------------------------------------------------------------ */
+/* Declarations and bookkeeping shared by the clipped traversals: the
+   incremental bin indices and the per-query counts.  */
+
+
+#define lqClippedTraversalLocals                                      \
+    int i, j, k;                                                      \
+    int iindex, jindex, kindex;                                       \
+    int slab = lq->divy * lq->divz;                                   \
+    int row = lq->divz;                                               \
+    int istart = minBinX * slab;                                      \
+    int jstart = minBinY * row;                                       \
+    int kstart = minBinZ;                                             \
+    lqClientProxy* co;                                                \
+    float radiusSquared = radius * radius;                            \
+    int tested = 0;                                                   \
+    int accepted = 0
+
+
+#define lqAddClippedQueryCounts(counts)                               \
+    if (counts != NULL)                                               \
+    {                                                                 \
+	counts->binsVisited += ((maxBinX - minBinX + 1) *             \
+				(maxBinY - minBinY + 1) *             \
+				(maxBinZ - minBinZ + 1));             \
+	counts->candidatesTested += tested;                           \
+	counts->candidatesAccepted += accepted;                       \
+    }
+
+
+#define lqAddOutsideQueryCounts(counts)                               \
+    if (counts != NULL)                                               \
+    {                                                                 \
+	counts->binsVisited += 1;                                     \
+	counts->candidatesTested += tested;                           \
+	counts->candidatesAccepted += accepted;                       \
+	counts->outsideCandidates += tested;                          \
+    }
+
+
 /* ------------------------------------------------------------------ */
 /* This subroutine of lqMapOverAllObjectsInLocality efficiently
    traverses of subset of bins specified by max and min bin
    coordinates. */
 
-void lqMapOverAllObjectsInLocalityClipped (lqInternalDB* lq, 
+static void lqMapOverAllObjectsInLocalityClipped (lqInternalDB* lq, 
                                            float x, float y, float z,
                                            float radius,
                                            lqCallBackFunction func,
@@ -354,9 +593,10 @@ void lqMapOverAllObjectsInLocalityClipped (lqInternalDB* lq,
                                            int minBinZ,
                                            int maxBinX,
                                            int maxBinY,
-                                           int maxBinZ);
+                                           int maxBinZ,
+                                           lqQueryCounts* counts);
 
-void lqMapOverAllObjectsInLocalityClipped (lqInternalDB* lq, 
+static void lqMapOverAllObjectsInLocalityClipped (lqInternalDB* lq, 
 					   float x, float y, float z,
 					   float radius,
 					   lqCallBackFunction func,
@@ -366,53 +606,63 @@ void lqMapOverAllObjectsInLocalityClipped (lqInternalDB* lq,
 					   int minBinZ,
 					   int maxBinX,
 					   int maxBinY,
-					   int maxBinZ)
-{
-    int i, j, k;
-    int iindex, jindex, kindex;
-    int slab = lq->divy * lq->divz;
-    int row = lq->divz;
-    int istart = minBinX * slab;
-    int jstart = minBinY * row;
-    int kstart = minBinZ;
-    lqClientProxy* co;
-    lqClientProxy** bin;
-    float radiusSquared = radius * radius;
+					   int maxBinZ,
+					   lqQueryCounts* counts)
+{
+    lqClippedTraversalLocals;
 
 #ifdef BOIDS_LQ_DEBUG
     if (lqAnnoteEnable) drawBallGL (x, y, z, radius);
 #endif
 
-    /* loop for x bins across diameter of sphere */
-    iindex = istart;
-    for (i = minBinX; i <= maxBinX; i++)
-    {
-	/* loop for y bins across diameter of sphere */
-	jindex = jstart;
-	for (j = minBinY; j <= maxBinY; j++)
-	{
-	    /* loop for z bins across diameter of sphere */
-	    kindex = kstart;
-	    for (k = minBinZ; k <= maxBinZ; k++)
-	    {
-		/* get current bin's client object list */
-		bin = &lq->bins[iindex + jindex + kindex];
-		co = *bin;
+    lqTraverseBinRange ((*func) (co->object, distanceSquared,
+				 clientQueryState));
+
+    lqAddClippedQueryCounts (counts);
+}
+
+
+/* ------------------------------------------------------------------ */
+/* The same traversal for lqMapOverAllObjectsInLocalityWithOffsets,
+   also passing each object's offset to the callback. */
+
+static void lqMapOverAllObjectsInLocalityClippedWithOffsets (lqInternalDB* lq, 
+                                                      float x, float y, float z,
+                                                      float radius,
+                                                      lqOffsetCallBackFunction func,
+                                                      void* clientQueryState,
+                                                      int minBinX,
+                                                      int minBinY, 
+                                                      int minBinZ,
+                                                      int maxBinX,
+                                                      int maxBinY,
+                                                      int maxBinZ,
+                                                      lqQueryCounts* counts);
+
+static void lqMapOverAllObjectsInLocalityClippedWithOffsets (lqInternalDB* lq, 
+						      float x, float y, float z,
+						      float radius,
+						      lqOffsetCallBackFunction func,
+						      void* clientQueryState,
+						      int minBinX,
+						      int minBinY, 
+						      int minBinZ,
+						      int maxBinX,
+						      int maxBinY,
+						      int maxBinZ,
+						      lqQueryCounts* counts)
+{
+    lqClippedTraversalLocals;
 
 #ifdef BOIDS_LQ_DEBUG
-		if (lqAnnoteEnable) drawBin (lq, bin);
+    if (lqAnnoteEnable) drawBallGL (x, y, z, radius);
 #endif
-		/* traverse current bin's client object list */
-		lqTraverseBinClientObjectList (co,
-					       radiusSquared,
-					       func,
-					       clientQueryState);
-		kindex += 1;
-	    }
-	    jindex += row;
-	}
-	iindex += slab;
-    }
+
+    lqTraverseBinRange ((*func) (co->object, distanceSquared,
+				 -dx, -dy, -dz,
+				 clientQueryState));
+
+    lqAddClippedQueryCounts (counts);
 }
 
 
@@ -421,26 +671,113 @@ void lqMapOverAllObjectsInLocalityClipped (lqInternalDB* lq,
    we need to check for objects in the catch-all "other" bin which
    holds any object which are not inside the regular sub-bricks  */
 
-void lqMapOverAllOutsideObjects (lqInternalDB* lq, 
+static void lqMapOverAllOutsideObjects (lqInternalDB* lq, 
                                  float x, float y, float z,
                                  float radius,
                                  lqCallBackFunction func,
-                                 void* clientQueryState);
+                                 void* clientQueryState,
+                                 lqQueryCounts* counts);
 
-void lqMapOverAllOutsideObjects (lqInternalDB* lq, 
+static void lqMapOverAllOutsideObjects (lqInternalDB* lq, 
 				 float x, float y, float z,
 				 float radius,
 				 lqCallBackFunction func,
-				 void* clientQueryState)
+				 void* clientQueryState,
+				 lqQueryCounts* counts)
+{
+    lqClientProxy* co = lq->other;
+    float radiusSquared = radius * radius;
+    int tested = 0;
+    int accepted = 0;
+
+    /* traverse the "other" bin's client object list */
+    lqTraverseBinClientObjectList (co, radiusSquared,
+				   (*func) (co->object, distanceSquared,
+					    clientQueryState),
+				   tested, accepted);
+
+    lqAddOutsideQueryCounts (counts);
+}
+
+
+static void lqMapOverAllOutsideObjectsWithOffsets (lqInternalDB* lq, 
+                                            float x, float y, float z,
+                                            float radius,
+                                            lqOffsetCallBackFunction func,
+                                            void* clientQueryState,
+                                            lqQueryCounts* counts);
+
+static void lqMapOverAllOutsideObjectsWithOffsets (lqInternalDB* lq, 
+					    float x, float y, float z,
+					    float radius,
+					    lqOffsetCallBackFunction func,
+					    void* clientQueryState,
+					    lqQueryCounts* counts)
 {
     lqClientProxy* co = lq->other;
     float radiusSquared = radius * radius;
+    int tested = 0;
+    int accepted = 0;
 
     /* traverse the "other" bin's client object list */
-    lqTraverseBinClientObjectList (co,
-				   radiusSquared,
-				   func,
-				   clientQueryState);
+    lqTraverseBinClientObjectList (co, radiusSquared,
+				   (*func) (co->object, distanceSquared,
+					    -dx, -dy, -dz,
+					    clientQueryState),
+				   tested, accepted);
+
+    lqAddOutsideQueryCounts (counts);
+}
+
+
+/* ------------------------------------------------------------------ */
+/* Find the range of bins overlapped by a locality sphere, clipped to
+   the "super brick".  Returns nonzero when the sphere lies completely
+   outside the super brick (leaving the bin range unset), and sets
+   *partlyOut when clipping was needed, in which case the "other" bin
+   must be searched too. */
+
+
+static inline int lqLocalityBinRange (lqInternalDB* lq, 
+                        float x, float y, float z,
+                        float radius,
+                        int* minBinX, int* minBinY, int* minBinZ,
+                        int* maxBinX, int* maxBinY, int* maxBinZ,
+                        int* partlyOut);
+
+static inline int lqLocalityBinRange (lqInternalDB* lq, 
+			float x, float y, float z,
+			float radius,
+			int* minBinX, int* minBinY, int* minBinZ,
+			int* maxBinX, int* maxBinY, int* maxBinZ,
+			int* partlyOut)
+{
+    /* is the sphere completely outside the "super brick"? */
+    if (((x + radius) < lq->originx) ||
+	((y + radius) < lq->originy) ||
+	((z + radius) < lq->originz) ||
+	((x - radius) >= lq->originx + lq->sizex) ||
+	((y - radius) >= lq->originy + lq->sizey) ||
+	((z - radius) >= lq->originz + lq->sizez))
+	return 1;
+
+    /* compute min and max bin coordinates for each dimension */
+    *minBinX = (int) ((((x - radius) - lq->originx) / lq->sizex) * lq->divx);
+    *minBinY = (int) ((((y - radius) - lq->originy) / lq->sizey) * lq->divy);
+    *minBinZ = (int) ((((z - radius) - lq->originz) / lq->sizez) * lq->divz);
+    *maxBinX = (int) ((((x + radius) - lq->originx) / lq->sizex) * lq->divx);
+    *maxBinY = (int) ((((y + radius) - lq->originy) / lq->sizey) * lq->divy);
+    *maxBinZ = (int) ((((z + radius) - lq->originz) / lq->sizez) * lq->divz);
+
+    /* clip bin coordinates */
+    *partlyOut = 0;
+    if (*minBinX < 0)         {*partlyOut = 1; *minBinX = 0;}
+    if (*minBinY < 0)         {*partlyOut = 1; *minBinY = 0;}
+    if (*minBinZ < 0)         {*partlyOut = 1; *minBinZ = 0;}
+    if (*maxBinX >= lq->divx) {*partlyOut = 1; *maxBinX = lq->divx - 1;}
+    if (*maxBinY >= lq->divy) {*partlyOut = 1; *maxBinY = lq->divy - 1;}
+    if (*maxBinZ >= lq->divz) {*partlyOut = 1; *maxBinZ = lq->divz - 1;}
+    return 0;
 }
 
 
@@ -464,50 +801,37 @@ void lqMapOverAllOutsideObjects (lqInternalDB* lq,
    bins of interest. */
 
 
-void lqMapOverAllObjectsInLocality (lqInternalDB* lq, 
-				    float x, float y, float z,
-				    float radius,
-				    lqCallBackFunction func,
-				    void* clientQueryState)
+static inline void lqMapOverLocality (lqInternalDB* lq, 
+                               float x, float y, float z,
+                               float radius,
+                               lqCallBackFunction func,
+                               void* clientQueryState,
+                               lqQueryCounts* counts);
+
+static inline void lqMapOverLocality (lqInternalDB* lq, 
+			       float x, float y, float z,
+			       float radius,
+			       lqCallBackFunction func,
+			       void* clientQueryState,
+			       lqQueryCounts* counts)
 {
-    int partlyOut = 0;
-    int completelyOutside = 
-	(((x + radius) < lq->originx) ||
-	 ((y + radius) < lq->originy) ||
-	 ((z + radius) < lq->originz) ||
-	 ((x - radius) >= lq->originx + lq->sizex) ||
-	 ((y - radius) >= lq->originy + lq->sizey) ||
-	 ((z - radius) >= lq->originz + lq->sizez));
     int minBinX, minBinY, minBinZ, maxBinX, maxBinY, maxBinZ;
+    int partlyOut;
 
     /* is the sphere completely outside the "super brick"? */
-    if (completelyOutside)
+    if (lqLocalityBinRange (lq, x, y, z, radius,
+			    &minBinX, &minBinY, &minBinZ,
+			    &maxBinX, &maxBinY, &maxBinZ, &partlyOut))
     {
 	lqMapOverAllOutsideObjects (lq, x, y, z, radius, func,
-				    clientQueryState);
+				    clientQueryState, counts);
 	return;
     }
 
-    /* compute min and max bin coordinates for each dimension */
-    minBinX = (int) ((((x - radius) - lq->originx) / lq->sizex) * lq->divx);
-    minBinY = (int) ((((y - radius) - lq->originy) / lq->sizey) * lq->divy);
-    minBinZ = (int) ((((z - radius) - lq->originz) / lq->sizez) * lq->divz);
-    maxBinX = (int) ((((x + radius) - lq->originx) / lq->sizex) * lq->divx);
-    maxBinY = (int) ((((y + radius) - lq->originy) / lq->sizey) * lq->divy);
-    maxBinZ = (int) ((((z + radius) - lq->originz) / lq->sizez) * lq->divz);
-
-    /* clip bin coordinates */
-    if (minBinX < 0)         {partlyOut = 1; minBinX = 0;}
-    if (minBinY < 0)         {partlyOut = 1; minBinY = 0;}
-    if (minBinZ < 0)         {partlyOut = 1; minBinZ = 0;}
-    if (maxBinX >= lq->divx) {partlyOut = 1; maxBinX = lq->divx - 1;}
-    if (maxBinY >= lq->divy) {partlyOut = 1; maxBinY = lq->divy - 1;}
-    if (maxBinZ >= lq->divz) {partlyOut = 1; maxBinZ = lq->divz - 1;}
-
     /* map function over outside objects if necessary (if clipped) */
     if (partlyOut) 
 	lqMapOverAllOutsideObjects (lq, x, y, z, radius, func,
-				    clientQueryState);
+				    clientQueryState, counts);
     
     /* map function over objects in bins */
     lqMapOverAllObjectsInLocalityClipped (lq,
@@ -516,43 +840,344 @@ void lqMapOverAllObjectsInLocality (lqInternalDB* lq,
 					  func,
 					  clientQueryState,
 					  minBinX, minBinY, minBinZ,
-					  maxBinX, maxBinY, maxBinZ);
+					  maxBinX, maxBinY, maxBinZ,
+					  counts);
+}
+
+
+/* lqMapOverLocality is inlined into both entry points, so the
+   uncounted one (counts == NULL) drops the counting altogether */
+
+
+void lqMapOverAllObjectsInLocality (lqInternalDB* lq, 
+				    float x, float y, float z,
+				    float radius,
+				    lqCallBackFunction func,
+				    void* clientQueryState)
+{
+    lqMapOverLocality (lq, x, y, z, radius, func, clientQueryState, NULL);
+}
+
+
+void lqMapOverAllObjectsInLocalityCounted (lqInternalDB* lq, 
+					   float x, float y, float z,
+					   float radius,
+					   lqCallBackFunction func,
+					   void* clientQueryState,
+					   lqQueryCounts* counts)
+{
+    lqMapOverLocality (lq, x, y, z, radius, func, clientQueryState, counts);
 }
 
 
 /* ------------------------------------------------------------------ */
-/* internal helper function */
+/* As lqMapOverAllObjectsInLocality, for an lqOffsetCallBackFunction
+   which is also given the offset from each object to the center. */
+
+
+void lqMapOverAllObjectsInLocalityWithOffsetsCounted (lqInternalDB* lq, 
+						      float x, float y, float z,
+						      float radius,
+						      lqOffsetCallBackFunction func,
+						      void* clientQueryState,
+						      lqQueryCounts* counts)
+{
+    int minBinX, minBinY, minBinZ, maxBinX, maxBinY, maxBinZ;
+    int partlyOut;
+
+    /* is the sphere completely outside the "super brick"? */
+    if (lqLocalityBinRange (lq, x, y, z, radius,
+			    &minBinX, &minBinY, &minBinZ,
+			    &maxBinX, &maxBinY, &maxBinZ, &partlyOut))
+    {
+	lqMapOverAllOutsideObjectsWithOffsets (lq, x, y, z, radius, func,
+					       clientQueryState, counts);
+	return;
+    }
+
+    /* map function over outside objects if necessary (if clipped) */
+    if (partlyOut) 
+	lqMapOverAllOutsideObjectsWithOffsets (lq, x, y, z, radius, func,
+					       clientQueryState, counts);
+    
+    /* map function over objects in bins */
+    lqMapOverAllObjectsInLocalityClippedWithOffsets (lq,
+						     x, y, z,
+						     radius,
+						     func,
+						     clientQueryState,
+						     minBinX, minBinY, minBinZ,
+						     maxBinX, maxBinY, maxBinZ,
+						     counts);
+}
+
+
+void lqMapOverAllObjectsInLocalityWithOffsets (lqInternalDB* lq, 
+					       float x, float y, float z,
+					       float radius,
+					       lqOffsetCallBackFunction func,
+					       void* clientQueryState)
+{
+    lqMapOverAllObjectsInLocalityWithOffsetsCounted (lq, x, y, z, radius,
+						     func, clientQueryState,
+						     NULL);
+}
+
+
+/* ------------------------------------------------------------------ */
+/* internal state of a search for the k nearest objects: the objects
+   kept so far, nearest first, and the squared distance a candidate
+   must be under to be kept (the search radius squared until k objects
+   are kept, then the k-th nearest distance squared) */
 
 
-typedef struct lqFindNearestState
+typedef struct lqKNearestState
 {
+    float x, y, z;
     void* ignoreObject;
-    void* nearestObject;
-    float minDistanceSquared;
+    void** objects;
+    float* distancesSquared;
+    int k;
+    int count;
+    float limitSquared;
+    int tested;
 
-} lqFindNearestState;
+} lqKNearestState;
 
 
-void lqFindNearestHelper (void* clientObject,
-                          float distanceSquared,
-                          void* clientQueryState);
+/* ------------------------------------------------------------------ */
+/* Offer each object of a bin's list to a k nearest search */
 
-void lqFindNearestHelper (void* clientObject,
-			  float distanceSquared,
-			  void* clientQueryState)
+
+void lqKNearestTraverseBin (lqKNearestState* s, lqClientProxy* co);
+
+void lqKNearestTraverseBin (lqKNearestState* s, lqClientProxy* co)
 {
-    lqFindNearestState* fns = (lqFindNearestState*) clientQueryState;
+    while (co != NULL)
+    {
+	float dx = s->x - co->x;
+	float dy = s->y - co->y;
+	float dz = s->z - co->z;
+	float distanceSquared = (dx * dx) + (dy * dy) + (dz * dz);
+	s->tested++;
+
+	if ((distanceSquared < s->limitSquared) &&
+	    (co->object != s->ignoreObject))
+	{
+	    /* find the insertion point from the far end, dropping the
+	       farthest kept object when already full */
+	    int i = s->count;
+	    if (s->count < s->k) s->count++; else i--;
+	    while ((i > 0) && (distanceSquared < s->distancesSquared[i-1]))
+	    {
+		s->objects[i] = s->objects[i-1];
+		s->distancesSquared[i] = s->distancesSquared[i-1];
+		i--;
+	    }
+	    s->objects[i] = co->object;
+	    s->distancesSquared[i] = distanceSquared;
+	    if (s->count == s->k)
+		s->limitSquared = s->distancesSquared[s->k - 1];
+	}
+	co = co->next;
+    }
+}
+
+
+/* ------------------------------------------------------------------ */
+/* The bin coordinate of a location along one axis, clipped to the
+   super-brick's bins, and the distance from the location to the
+   nearer face of that bin (zero outside the super-brick) */
 
-    /* do nothing if this is the "ignoreObject" */
-    if (fns->ignoreObject != clientObject)
+
+int lqClippedBinCoordinate (float position, float origin, float size,
+			    int divisions, float* faceDistance);
+
+int lqClippedBinCoordinate (float position, float origin, float size,
+			    int divisions, float* faceDistance)
+{
+    float cells = ((position - origin) / size) * divisions;
+    float fraction;
+    int i;
+
+    if (cells < 0) cells = 0;
+    if (cells > divisions) cells = (float) divisions;
+    i = (int) cells;
+    if (i >= divisions) i = divisions - 1;
+    fraction = cells - i;
+    if (fraction > 1 - fraction) fraction = 1 - fraction;
+    *faceDistance = fraction * (size / divisions);
+    return i;
+}
+
+
+/* ------------------------------------------------------------------ */
+/* Search the database for the (at most) k objects nearest to a given
+   location within a given radius, visiting bins in expanding cubic
+   shells around the location's bin.  Once the nearest possible object
+   of the next shell is farther than the k-th nearest object found so
+   far (or the radius), no further shell is visited.  */
+
+
+int lqFindKNearestNeighborsWithinRadius (lqInternalDB* lq, 
+					 float x, float y, float z,
+					 float radius,
+					 void* ignoreObject,
+					 int k,
+					 void** objects,
+					 float* distancesSquared)
+{
+    return lqFindKNearestNeighborsWithinRadiusCounted (lq, x, y, z, radius,
+						       ignoreObject, k,
+						       objects,
+						       distancesSquared,
+						       NULL);
+}
+
+
+int lqFindKNearestNeighborsWithinRadiusCounted (lqInternalDB* lq, 
+						float x, float y, float z,
+						float radius,
+						void* ignoreObject,
+						int k,
+						void** objects,
+						float* distancesSquared,
+						lqQueryCounts* counts)
+{
+    lqKNearestState s;
+    int binsVisited = 0;
+    int outsideTested = 0;
+    int minBinX, minBinY, minBinZ, maxBinX, maxBinY, maxBinZ;
+    int cx, cy, cz, i, j, ring, maxRing;
+    float facex, facey, facez;
+
+    if (k <= 0) return 0;
+
+    /* initialize search state */
+    s.x = x;
+    s.y = y;
+    s.z = z;
+    s.ignoreObject = ignoreObject;
+    s.objects = objects;
+    s.distancesSquared = distancesSquared;
+    s.k = k;
+    s.count = 0;
+    s.limitSquared = radius * radius;
+    s.tested = 0;
+
+    /* objects outside the super-brick, if the sphere reaches them */
+    if (((x - radius) < lq->originx) ||
+	((y - radius) < lq->originy) ||
+	((z - radius) < lq->originz) ||
+	((x + radius) >= lq->originx + lq->sizex) ||
+	((y + radius) >= lq->originy + lq->sizey) ||
+	((z + radius) >= lq->originz + lq->sizez))
+    {
+	lqKNearestTraverseBin (&s, lq->other);
+	outsideTested = s.tested;
+	binsVisited++;
+    }
+
+    /* unless the sphere misses the super-brick: bins it overlaps, and
+       the (clipped) bin of its center with the distances to its faces */
+    if (! (((x + radius) < lq->originx) ||
+	   ((y + radius) < lq->originy) ||
+	   ((z + radius) < lq->originz) ||
+	   ((x - radius) >= lq->originx + lq->sizex) ||
+	   ((y - radius) >= lq->originy + lq->sizey) ||
+	   ((z - radius) >= lq->originz + lq->sizez)))
     {
-	/* record this object if it is the nearest one so far */
-	if (fns->minDistanceSquared > distanceSquared)
+	float unused;
+	minBinX = lqClippedBinCoordinate (x - radius, lq->originx, lq->sizex,
+					  lq->divx, &unused);
+	minBinY = lqClippedBinCoordinate (y - radius, lq->originy, lq->sizey,
+					  lq->divy, &unused);
+	minBinZ = lqClippedBinCoordinate (z - radius, lq->originz, lq->sizez,
+					  lq->divz, &unused);
+	maxBinX = lqClippedBinCoordinate (x + radius, lq->originx, lq->sizex,
+					  lq->divx, &unused);
+	maxBinY = lqClippedBinCoordinate (y + radius, lq->originy, lq->sizey,
+					  lq->divy, &unused);
+	maxBinZ = lqClippedBinCoordinate (z + radius, lq->originz, lq->sizez,
+					  lq->divz, &unused);
+	cx = lqClippedBinCoordinate (x, lq->originx, lq->sizex, lq->divx,
+				     &facex);
+	cy = lqClippedBinCoordinate (y, lq->originy, lq->sizey, lq->divy,
+				     &facey);
+	cz = lqClippedBinCoordinate (z, lq->originz, lq->sizez, lq->divz,
+				     &facez);
+
+	/* the shell reaching the farthest overlapped bin */
+	maxRing = cx - minBinX;
+	if (maxRing < maxBinX - cx) maxRing = maxBinX - cx;
+	if (maxRing < cy - minBinY) maxRing = cy - minBinY;
+	if (maxRing < maxBinY - cy) maxRing = maxBinY - cy;
+	if (maxRing < cz - minBinZ) maxRing = cz - minBinZ;
+	if (maxRing < maxBinZ - cz) maxRing = maxBinZ - cz;
+
+	for (ring = 0; ring <= maxRing; ring++)
 	{
-	    fns->nearestObject = clientObject;
-	    fns->minDistanceSquared = distanceSquared;
+	    int ilo = (cx - ring < minBinX) ? minBinX : cx - ring;
+	    int ihi = (cx + ring > maxBinX) ? maxBinX : cx + ring;
+	    int jlo = (cy - ring < minBinY) ? minBinY : cy - ring;
+	    int jhi = (cy + ring > maxBinY) ? maxBinY : cy + ring;
+	    int klo = (cz - ring < minBinZ) ? minBinZ : cz - ring;
+	    int khi = (cz + ring > maxBinZ) ? maxBinZ : cz + ring;
+	    float next, nextY, nextZ;
+
+	    /* visit the bins of this shell: whole rows along z where x
+	       or y are on the shell, otherwise only its two ends */
+	    for (i = ilo; i <= ihi; i++)
+	    {
+		for (j = jlo; j <= jhi; j++)
+		{
+		    int row = lqBinCoordsToBinIndex (lq, i, j, 0);
+		    if ((i == cx - ring) || (i == cx + ring) ||
+			(j == cy - ring) || (j == cy + ring))
+		    {
+			int kk;
+			for (kk = klo; kk <= khi; kk++)
+			{
+			    lqKNearestTraverseBin (&s, lq->bins[row + kk]);
+			    binsVisited++;
+			}
+		    }
+		    else
+		    {
+			if (cz - ring >= minBinZ)
+			{
+			    lqKNearestTraverseBin (&s, lq->bins[row + cz - ring]);
+			    binsVisited++;
+			}
+			if (cz + ring <= maxBinZ)
+			{
+			    lqKNearestTraverseBin (&s, lq->bins[row + cz + ring]);
+			    binsVisited++;
+			}
+		    }
+		}
+	    }
+
+	    /* stop once every bin of the next shell is out of reach: they
+	       are at least ring whole bins and the distance to the center
+	       bin's nearer face away along some axis */
+	    next = ring * (lq->sizex / lq->divx) + facex;
+	    nextY = ring * (lq->sizey / lq->divy) + facey;
+	    nextZ = ring * (lq->sizez / lq->divz) + facez;
+	    if (next > nextY) next = nextY;
+	    if (next > nextZ) next = nextZ;
+	    if ((next * next) >= s.limitSquared) break;
 	}
     }
+
+    if (counts != NULL)
+    {
+	counts->binsVisited += binsVisited;
+	counts->candidatesTested += s.tested;
+	counts->candidatesAccepted += s.count;
+	counts->outsideCandidates += outsideTested;
+    }
+    return s.count;
 }
 
 
@@ -573,21 +1198,12 @@ void* lqFindNearestNeighborWithinRadius (lqInternalDB* lq,
 					 float radius,
 					 void* ignoreObject)
 {
-    /* initialize search state */
-    lqFindNearestState lqFNS;
-    lqFNS.nearestObject = NULL;
-    lqFNS.ignoreObject = ignoreObject;
-    lqFNS.minDistanceSquared = FLT_MAX;
+    void* nearestObject = NULL;
+    float distanceSquared;
 
-    /* map search helper function over all objects within radius */
-    lqMapOverAllObjectsInLocality (lq, 
-				   x, y, z,
-				   radius,
-				   lqFindNearestHelper,
-				   &lqFNS);
-
-    /* return nearest object found, if any */
-    return lqFNS.nearestObject;
+    lqFindKNearestNeighborsWithinRadius (lq, x, y, z, radius, ignoreObject,
+					 1, &nearestObject, &distanceSquared);
+    return nearestObject;
 }
 
 
@@ -628,6 +1244,40 @@ void lqMapOverAllObjects (lqInternalDB* lq,
     lqMapOverAllObjectsInBin (lq->other, func, clientQueryState);
 }
 
+/* ------------------------------------------------------------------ */
+/* Apply a user-supplied function to all objects in the database and
+   their locations, regardless of locality */
+
+void lqMapOverAllObjectsInBinWithLocations (lqClientProxy* binProxyList, 
+                                            lqLocationCallBackFunction func,
+                                            void* clientQueryState);
+
+void lqMapOverAllObjectsInBinWithLocations (lqClientProxy* binProxyList, 
+                                            lqLocationCallBackFunction func,
+                                            void* clientQueryState)
+{
+    while (binProxyList != NULL)
+    {
+	(*func) (binProxyList->object,
+		 binProxyList->x, binProxyList->y, binProxyList->z,
+		 clientQueryState);
+	binProxyList = binProxyList->next;
+    }
+}
+
+void lqMapOverAllObjectsWithLocations (lqInternalDB* lq, 
+				       lqLocationCallBackFunction func,
+				       void* clientQueryState)
+{
+    int i;
+    int bincount = lq->divx * lq->divy * lq->divz;
+    for (i=0; i<bincount; i++)
+    {
+	lqMapOverAllObjectsInBinWithLocations (lq->bins[i], func, clientQueryState);
+    }
+    lqMapOverAllObjectsInBinWithLocations (lq->other, func, clientQueryState);
+}
+
 /* ------------------------------------------------------------------ */
 /* looks at all bins (except "other") finding the min and max bin
    populations and the average of NON-EMPTY bin populations.  (The
@@ -685,6 +1335,37 @@ void lqGetBinPopulationStats (lqInternalDB* lq,
 #endif /* NO_LQ_BIN_STATS */
 
 
+/* ------------------------------------------------------------------ */
+/* Histogram of bin populations, and the population of the "other"
+   bin  */
+
+
+int lqGetBinPopulationHistogram (lqInternalDB* lq,
+				 int* histogram,
+				 int histogramSize)
+{
+    int bincount = lq->divx * lq->divy * lq->divz;
+    int outside = 0;
+    int i;
+    lqClientProxy* co;
+
+    for (i=0; i<histogramSize; i++) histogram[i] = 0;
+    if (histogramSize < 1) return 0;
+
+    for (i=0; i<bincount; i++)
+    {
+	int objectCount = 0;
+	for (co = lq->bins[i]; co != NULL; co = co->next) objectCount++;
+	histogram[(objectCount < histogramSize) ?
+		  objectCount :
+		  (histogramSize - 1)]++;
+    }
+
+    for (co = lq->other; co != NULL; co = co->next) outside++;
+    return outside;
+}
+
+
 /* ------------------------------------------------------------------ */
 /* internal helper function */
 
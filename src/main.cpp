@@ -38,9 +38,12 @@
 
 #include "OpenSteer/OpenSteerDemo.h"        // OpenSteerDemo application
 #include "OpenSteer/Draw.h"                 // OpenSteerDemo graphics
+#include "OpenSteer/AnnotationStream.h"     // --play
 
 // To include EXIT_SUCCESS
 #include <cstdlib>
+#include <cstring>
+#include <iostream>
 
 
 int main (int argc, char **argv) 
@@ -51,6 +54,40 @@ int main (int argc, char **argv)
     // initialize graphics
     OpenSteer::initializeGraphics (argc, argv);
 
+    // optionally step the simulation at a fixed rate (up to four steps a
+    // frame), and degrade it when frames take longer than a budget
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (std::strcmp (argv[i], "--fixed-step") == 0)
+        {
+            const float rate = (float) std::atof (argv[i + 1]);
+            if (rate > 0)
+                OpenSteer::OpenSteerDemo::clock.setFixedTimeStep (1 / rate, 4);
+        }
+        else if (std::strcmp (argv[i], "--frame-budget") == 0)
+            OpenSteer::OpenSteerDemo::clock.setFrameBudget
+                ((float) std::atof (argv[i + 1]) / 1000);
+    }
+
+    // optionally run the simulation on a thread of its own from the start
+    for (int i = 1; i < argc; i++)
+        if (std::strcmp (argv[i], "--decoupled") == 0)
+            OpenSteer::OpenSteerDemo::setDecoupledSimulation (true);
+
+    // optionally show a recorded annotation stream instead of simulating
+    static OpenSteer::AnnotationStreamReader playback;
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (std::strcmp (argv[i], "--play") != 0) continue;
+        if (! playback.open (argv[i + 1]) ||
+            ! OpenSteer::OpenSteerDemo::setAnnotationPlayback (&playback))
+        {
+            std::cerr << "cannot play annotation stream " << argv[i + 1]
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
     // run the main event processing loop
     OpenSteer::runGraphics ();  
     return EXIT_SUCCESS;
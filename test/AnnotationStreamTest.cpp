@@ -0,0 +1,273 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::AnnotationStreamWriter and
+ * @c OpenSteer::AnnotationStreamReader.
+ */
+#include "AnnotationStreamTest.h"
+
+
+// Include std::abs
+#include <cmath>
+
+// Include std::remove, std::fopen
+#include <cstdio>
+
+// Include std::ofstream
+#include <fstream>
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::AnnotationStreamWriter, OpenSteer::AnnotationStreamReader
+#include "OpenSteer/AnnotationStream.h"
+
+// Include OpenSteer::SimpleVehicle
+#include "OpenSteer/SimpleVehicle.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::AnnotationStreamTest );
+
+
+
+namespace {
+    
+    char const* const fileName = "AnnotationStreamTest.annotation";
+    
+    
+    /**
+     * @c SimpleVehicle is abstract.
+     */
+    class TestVehicle : public OpenSteer::SimpleVehicle {
+    public:
+        virtual void update( float const /* currentTime */, float const /* elapsedTime */ ) {
+            // Nothing to do.
+        }
+    }; // class TestVehicle
+    
+    
+    /**
+     * Fills @a snapshot with @a vehicleCount vehicles, the second
+     * selected, and primitives depending on @a frame.
+     */
+    void makeFrame( OpenSteer::SimulationSnapshot& snapshot,
+                    int frame,
+                    std::vector< TestVehicle >& vehicles )
+    {
+        using namespace OpenSteer;
+        
+        AVGroup group;
+        for ( size_t i = 0; i < vehicles.size(); ++i ) {
+            vehicles[ i ].setPosition( Vec3( float( i ), float( frame ), 0.0f ) );
+            vehicles[ i ].setSpeed( float( frame ) );
+            group.push_back( &vehicles[ i ] );
+        }
+        
+        snapshot.clear();
+        snapshot.captureVehicles( group, group.size() > 1 ? group[ 1 ] : 0 );
+        for ( int i = 0; i < frame; ++i ) {
+            snapshot.addLine( Vec3( float( i ), 0.0f, 0.0f ),
+                              Vec3( 0.0f, float( i ), 0.0f ),
+                              Color( 0.25f, 0.5f, 1.0f, 0.1f ) );
+        }
+        snapshot.addCircleOrDisk( float( frame ), Vec3::up, Vec3( 1.0f, 2.0f, 3.0f ),
+                                  gRed, 12 + frame, frame % 2 == 0, true );
+        snapshot.currentTime = frame * 0.5f;
+        snapshot.elapsedTime = 0.5f;
+    }
+    
+    
+    bool closeColor( OpenSteer::Color const& lhs, OpenSteer::Color const& rhs )
+    {
+        float const tolerance = 1.0f / 255.0f;
+        return std::abs( lhs.r() - rhs.r() ) <= tolerance &&
+               std::abs( lhs.g() - rhs.g() ) <= tolerance &&
+               std::abs( lhs.b() - rhs.b() ) <= tolerance &&
+               std::abs( lhs.a() - rhs.a() ) <= tolerance;
+    }
+    
+} // anonymous namespace
+
+
+
+OpenSteer::AnnotationStreamTest::AnnotationStreamTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::AnnotationStreamTest::~AnnotationStreamTest()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::AnnotationStreamTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::AnnotationStreamTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::AnnotationStreamTest::testRoundTrip()
+{
+    int const frameCount = 5;
+    std::vector< TestVehicle > vehicles( 3 );
+    SimulationSnapshot written;
+    
+    AnnotationStreamWriter writer;
+    CPPUNIT_ASSERT( writer.open( fileName, "Test PlugIn" ) );
+    for ( int frame = 0; frame < frameCount; ++frame ) {
+        makeFrame( written, frame, vehicles );
+        writer.writeFrame( written );
+    }
+    writer.close();
+    CPPUNIT_ASSERT( ! writer.failed() );
+    CPPUNIT_ASSERT_EQUAL( size_t( frameCount ), writer.frameCount() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), writer.droppedFrameCount() );
+    
+    AnnotationStreamReader reader;
+    CPPUNIT_ASSERT( reader.open( fileName ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "Test PlugIn" ), reader.plugInName() );
+    
+    SimulationSnapshot read;
+    for ( int pass = 0; pass < 2; ++pass ) {
+        for ( int frame = 0; frame < frameCount; ++frame ) {
+            makeFrame( written, frame, vehicles );
+            CPPUNIT_ASSERT( reader.readFrame( read ) );
+            
+            CPPUNIT_ASSERT_EQUAL( written.currentTime, read.currentTime );
+            CPPUNIT_ASSERT_EQUAL( written.elapsedTime, read.elapsedTime );
+            CPPUNIT_ASSERT_EQUAL( 1, read.selected );
+            CPPUNIT_ASSERT_EQUAL( written.vehicles.size(), read.vehicles.size() );
+            for ( size_t i = 0; i < read.vehicles.size(); ++i ) {
+                CPPUNIT_ASSERT( Vec3( written.vehicles[ i ].position ) == read.vehicles[ i ].position );
+                CPPUNIT_ASSERT( Vec3( written.vehicles[ i ].forward ) == read.vehicles[ i ].forward );
+                CPPUNIT_ASSERT_EQUAL( written.vehicles[ i ].speed, read.vehicles[ i ].speed );
+            }
+            
+            CPPUNIT_ASSERT_EQUAL( written.lines.size(), read.lines.size() );
+            for ( size_t i = 0; i < read.lines.size(); ++i ) {
+                CPPUNIT_ASSERT( written.lines[ i ].startPoint == read.lines[ i ].startPoint );
+                CPPUNIT_ASSERT( written.lines[ i ].endPoint == read.lines[ i ].endPoint );
+                CPPUNIT_ASSERT( closeColor( written.lines[ i ].color, read.lines[ i ].color ) );
+            }
+            
+            CPPUNIT_ASSERT_EQUAL( size_t( 1 ), read.circles.size() );
+            SimulationSnapshot::CircleOrDisk const& circle = read.circles[ 0 ];
+            CPPUNIT_ASSERT_EQUAL( float( frame ), circle.radius );
+            CPPUNIT_ASSERT( circle.axis == Vec3::up );
+            CPPUNIT_ASSERT( circle.center == Vec3( 1.0f, 2.0f, 3.0f ) );
+            CPPUNIT_ASSERT( closeColor( gRed, circle.color ) );
+            CPPUNIT_ASSERT_EQUAL( 12 + frame, circle.segments );
+            CPPUNIT_ASSERT_EQUAL( frame % 2 == 0, circle.filled );
+            CPPUNIT_ASSERT( circle.in3d );
+        }
+        CPPUNIT_ASSERT( ! reader.readFrame( read ) );
+        CPPUNIT_ASSERT_EQUAL( size_t( frameCount ), reader.frameCount() );
+        reader.rewind();
+    }
+    
+    reader.close();
+    std::remove( fileName );
+}
+
+
+
+void 
+OpenSteer::AnnotationStreamTest::testDroppedFrames()
+{
+    std::vector< TestVehicle > vehicles( 2 );
+    SimulationSnapshot frame;
+    makeFrame( frame, 3, vehicles );
+    
+    AnnotationStreamWriter writer;
+    writer.setQueueLimit( 0 );
+    CPPUNIT_ASSERT( writer.open( fileName, "Test PlugIn" ) );
+    for ( int i = 0; i < 10; ++i ) {
+        writer.writeFrame( frame );
+    }
+    writer.close();
+    CPPUNIT_ASSERT_EQUAL( size_t( 10 ), writer.frameCount() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 10 ), writer.droppedFrameCount() );
+    
+    AnnotationStreamReader reader;
+    CPPUNIT_ASSERT( reader.open( fileName ) );
+    CPPUNIT_ASSERT( ! reader.readFrame( frame ) );
+    
+    reader.close();
+    std::remove( fileName );
+}
+
+
+
+void 
+OpenSteer::AnnotationStreamTest::testMalformed()
+{
+    AnnotationStreamReader reader;
+    SimulationSnapshot frame;
+    
+    {
+        std::ofstream other( fileName, std::ios::binary | std::ios::trunc );
+        other << "not an annotation stream";
+    }
+    CPPUNIT_ASSERT( ! reader.open( fileName ) );
+    CPPUNIT_ASSERT( ! reader.isOpen() );
+    
+    AnnotationStreamWriter writer;
+    CPPUNIT_ASSERT( writer.open( fileName, "Test PlugIn" ) );
+    writer.close();
+    {
+        // a frame claiming more lines than its size holds
+        AnnotationStreamFrameHeader header = AnnotationStreamFrameHeader();
+        header.size = 0;
+        header.selected = -1;
+        header.lineCount = 1000000;
+        std::ofstream other( fileName, std::ios::binary | std::ios::app );
+        other.write( reinterpret_cast< char const* >( &header ), sizeof( header ) );
+    }
+    CPPUNIT_ASSERT( reader.open( fileName ) );
+    CPPUNIT_ASSERT( ! reader.readFrame( frame ) );
+    
+    reader.close();
+    std::remove( fileName );
+}
@@ -0,0 +1,224 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::AnnotationMixin, 
+ * @c OpenSteer::NullAnnotationMixin and @c OpenSteer::TrailPool.
+ */
+#include "AnnotationTest.h"
+
+
+// Include OpenSteer::LocalSpaceMixin
+#include "OpenSteer/LocalSpace.h"
+
+// Include OpenSteer::SimpleVehicle
+#include "OpenSteer/SimpleVehicle.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::AnnotationTest );
+
+
+
+OpenSteer::AnnotationTest::AnnotationTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::AnnotationTest::~AnnotationTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::AnnotationTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::AnnotationTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    
+    typedef OpenSteer::LocalSpaceMixin< OpenSteer::AbstractVehicle > Base;
+    
+    
+    /**
+     * Counts the close neighbor annotations its steering asks for.
+     */
+    class CountingVehicle : public OpenSteer::SimpleVehicle {
+    public:
+        CountingVehicle() : annotations( 0 ) {}
+        
+        void update( float const, float const ) {}
+        
+        void annotateAvoidCloseNeighbor( OpenSteer::AbstractVehicle const&,
+                                         float const ) 
+        {
+            ++annotations;
+        }
+        
+        int annotations;
+    };
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::AnnotationTest::testNullPolicyHasNoState()
+{
+    CPPUNIT_ASSERT_EQUAL( sizeof( Base ), sizeof( NullAnnotationMixin< Base > ) );
+    CPPUNIT_ASSERT( sizeof( Base ) < sizeof( AnnotationMixin< Base > ) );
+    
+    CPPUNIT_ASSERT( ! NullAnnotationMixin< Base >::hasAnnotation );
+    CPPUNIT_ASSERT( AnnotationMixin< Base >::hasAnnotation );
+}
+
+
+
+void 
+OpenSteer::AnnotationTest::testSimpleVehiclePolicy()
+{
+#ifdef OPENSTEER_NULL_ANNOTATION
+    bool const expected = false;
+#else
+    bool const expected = true;
+#endif
+    CPPUNIT_ASSERT_EQUAL( expected, bool( SimpleVehicle::hasAnnotation ) );
+    
+    // two overlapping vehicles: steering apart is annotated, if at all
+    CountingVehicle a;
+    CountingVehicle b;
+    b.setPosition( Vec3( 0.5f, 0.0f, 0.0f ) );
+    AVGroup others;
+    others.push_back( &b );
+    
+    Vec3 const steering = a.steerToAvoidCloseNeighbors( 0.0f, others );
+    CPPUNIT_ASSERT( Vec3::zero != steering );
+    CPPUNIT_ASSERT_EQUAL( expected ? 1 : 0, a.annotations );
+}
+
+
+
+void 
+OpenSteer::AnnotationTest::testTrailsAreAllocatedLazily()
+{
+    size_t const allocated = TrailPool::shared().ringsAllocated();
+    
+    CountingVehicle vehicle;
+    vehicle.setTrailParameters( 3.0f, 60 );
+    for ( int i = 0; i < 10; ++i ) {
+        vehicle.setPosition( Vec3( float( i ), 0.0f, 0.0f ) );
+        vehicle.recordTrailVertex( 0.1f * i, vehicle.position() );
+    }
+    vehicle.clearTrailHistory();
+    
+    CPPUNIT_ASSERT( ! vehicle.hasTrail() );
+    CPPUNIT_ASSERT_EQUAL( allocated, TrailPool::shared().ringsAllocated() );
+}
+
+
+
+void 
+OpenSteer::AnnotationTest::testTrailPoolRecyclesIdleRings()
+{
+    TrailPool pool;
+    pool.setIdleFrames( 2 );
+    
+    TrailPool::Ring* ring = pool.acquire( 50, false );
+    CPPUNIT_ASSERT( 0 != ring );
+    CPPUNIT_ASSERT( ring->capacity >= 50 );
+    unsigned const generation = ring->generation;
+    
+    // drawn every frame: kept
+    for ( int i = 0; i < 5; ++i ) {
+        pool.beginFrame();
+        pool.touch( *ring );
+    }
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), pool.ringsInUse() );
+    CPPUNIT_ASSERT_EQUAL( generation, ring->generation );
+    
+    // no longer drawn: recycled
+    for ( int i = 0; i < 3; ++i ) {
+        pool.beginFrame();
+    }
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), pool.ringsInUse() );
+    CPPUNIT_ASSERT( generation != ring->generation );
+    
+    // and reused, grown as needed
+    TrailPool::Ring* const reused = pool.acquire( 80, false );
+    CPPUNIT_ASSERT( ring == reused );
+    CPPUNIT_ASSERT( reused->capacity >= 80 );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), pool.ringsAllocated() );
+    
+    pool.release( reused );
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), pool.ringsInUse() );
+}
+
+
+
+void 
+OpenSteer::AnnotationTest::testTrailPoolFocusAndBudget()
+{
+    TrailPool pool;
+    int selected = 0;
+    int other = 0;
+    
+    // without a focus every vehicle wants a trail
+    CPPUNIT_ASSERT( pool.wantsTrail( &other, Vec3( 1000.0f, 0.0f, 0.0f ), false ) );
+    
+    pool.setFocus( Vec3::zero, 10.0f, &selected );
+    CPPUNIT_ASSERT( pool.wantsTrail( &other, Vec3( 5.0f, 0.0f, 0.0f ), false ) );
+    CPPUNIT_ASSERT( ! pool.wantsTrail( &other, Vec3( 50.0f, 0.0f, 0.0f ), false ) );
+    CPPUNIT_ASSERT( pool.wantsTrail( &other, Vec3( 50.0f, 0.0f, 0.0f ), true ) );
+    CPPUNIT_ASSERT( pool.wantsTrail( &selected, Vec3( 50.0f, 0.0f, 0.0f ), false ) );
+    CPPUNIT_ASSERT( pool.isFocus( &selected ) );
+    CPPUNIT_ASSERT( ! pool.isFocus( &other ) );
+    
+    pool.setBudget( 1 );
+    TrailPool::Ring* const first = pool.acquire( 10, false );
+    CPPUNIT_ASSERT( 0 != first );
+    CPPUNIT_ASSERT( 0 == pool.acquire( 10, false ) );
+    TrailPool::Ring* const priority = pool.acquire( 10, true );
+    CPPUNIT_ASSERT( 0 != priority );
+    CPPUNIT_ASSERT_EQUAL( size_t( 2 ), pool.ringsInUse() );
+}
@@ -0,0 +1,118 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::AnnotationMixin, 
+ * @c OpenSteer::NullAnnotationMixin and @c OpenSteer::TrailPool.
+ */
+#ifndef OPENSTEER_ANNOTATIONTEST_H
+#define OPENSTEER_ANNOTATIONTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::AnnotationMixin, OpenSteer::NullAnnotationMixin, 
+// OpenSteer::TrailPool
+#include "OpenSteer/Annotation.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class AnnotationTest : public CppUnit::TestFixture {
+    public:
+        AnnotationTest();
+        virtual ~AnnotationTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(AnnotationTest);
+        CPPUNIT_TEST(testNullPolicyHasNoState);
+        CPPUNIT_TEST(testSimpleVehiclePolicy);
+        CPPUNIT_TEST(testTrailsAreAllocatedLazily);
+        CPPUNIT_TEST(testTrailPoolRecyclesIdleRings);
+        CPPUNIT_TEST(testTrailPoolFocusAndBudget);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        AnnotationTest( AnnotationTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        AnnotationTest& operator=( AnnotationTest const& );
+        
+    private:
+        /**
+         * Tests that the null policy adds no members (no trail buffers) to
+         * the class it is layered on, while @c AnnotationMixin does.
+         */
+        void testNullPolicyHasNoState();
+        
+        /**
+         * Tests that @c SimpleVehicle's policy follows the
+         * @c OPENSTEER_NULL_ANNOTATION build option, and that its
+         * steering calls the annotation hooks only when it annotates.
+         */
+        void testSimpleVehiclePolicy();
+        
+        /**
+         * Tests that a vehicle has no trail storage before its trail is
+         * drawn, and that recording trail vertices without storage only
+         * tracks the position.
+         */
+        void testTrailsAreAllocatedLazily();
+        
+        /**
+         * Tests that rings not drawn for the idle frames go back to the
+         * pool with a new generation and are reused.
+         */
+        void testTrailPoolRecyclesIdleRings();
+        
+        /**
+         * Tests which vehicles want trails for a focus, and that the
+         * budget limits all but priority requests.
+         */
+        void testTrailPoolFocusAndBudget();
+        
+    }; // AnnotationTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_ANNOTATIONTEST_H
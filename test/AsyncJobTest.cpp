@@ -0,0 +1,233 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::AsyncJobQueue and @c OpenSteer::AsyncPlan.
+ */
+#include "AsyncJobTest.h"
+
+
+// Include std::atomic
+#include <atomic>
+
+// Include std::this_thread::yield
+#include <thread>
+
+// Include OpenSteer::AsyncJobQueue, OpenSteer::AsyncPlan
+#include "OpenSteer/AsyncJob.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::AsyncJobTest );
+
+
+
+namespace {
+    
+    /**
+     * Counts its runs and returns @c value.
+     */
+    class CountingQuery {
+    public:
+        CountingQuery( int value, std::atomic< int >& runs )
+            : value_( value ), runs_( &runs ) {}
+        
+        int operator()() const {
+            ++*runs_;
+            return value_;
+        }
+        
+    private:
+        int value_;
+        std::atomic< int >* runs_;
+    }; // class CountingQuery
+    
+    
+    /**
+     * Keeps its thread busy until released or cancelled, then returns
+     * whether it was cancelled.
+     */
+    class BlockingQuery {
+    public:
+        BlockingQuery( std::atomic< bool >& release, std::atomic< bool >& started )
+            : release_( &release ), started_( &started ) {}
+        
+        bool operator()() const {
+            *started_ = true;
+            while ( ! *release_ ) {
+                if ( OpenSteer::AsyncJobQueue::currentJobCancelled() ) {
+                    return true;
+                }
+                std::this_thread::yield();
+            }
+            return false;
+        }
+        
+    private:
+        std::atomic< bool >* release_;
+        std::atomic< bool >* started_;
+    }; // class BlockingQuery
+    
+    
+    void waitUntil( std::atomic< bool > const& flag )
+    {
+        while ( ! flag ) {
+            std::this_thread::yield();
+        }
+    }
+    
+} // anonymous namespace
+
+
+
+OpenSteer::AsyncJobTest::AsyncJobTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::AsyncJobTest::~AsyncJobTest()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::AsyncJobTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::AsyncJobTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::AsyncJobTest::testTakeResult()
+{
+    AsyncJobQueue queue( 2 );
+    std::atomic< int > runs( 0 );
+    AsyncPlan< int > plan;
+    int result = 0;
+    
+    CPPUNIT_ASSERT( ! plan.isPending() );
+    CPPUNIT_ASSERT( ! plan.take( result ) );
+    
+    plan.submit( CountingQuery( 42, runs ), queue );
+    CPPUNIT_ASSERT( plan.isPending() );
+    queue.waitUntilIdle();
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 0 ), queue.pendingCount() );
+    CPPUNIT_ASSERT( plan.isReady() );
+    CPPUNIT_ASSERT( plan.take( result ) );
+    CPPUNIT_ASSERT_EQUAL( 42, result );
+    CPPUNIT_ASSERT_EQUAL( 1, int( runs ) );
+    
+    CPPUNIT_ASSERT( ! plan.isPending() );
+    CPPUNIT_ASSERT( ! plan.take( result ) );
+}
+
+
+
+void 
+OpenSteer::AsyncJobTest::testCancelBeforeStart()
+{
+    AsyncJobQueue queue( 1 );
+    std::atomic< bool > release( false );
+    std::atomic< bool > started( false );
+    AsyncPlan< bool > blocker;
+    blocker.submit( BlockingQuery( release, started ), queue );
+    waitUntil( started );
+    
+    // queued behind the blocker, then cancelled
+    std::atomic< int > runs( 0 );
+    AsyncPlan< int > plan;
+    plan.submit( CountingQuery( 1, runs ), queue );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 2 ), queue.pendingCount() );
+    plan.cancel();
+    CPPUNIT_ASSERT( ! plan.isPending() );
+    
+    release = true;
+    queue.waitUntilIdle();
+    CPPUNIT_ASSERT_EQUAL( 0, int( runs ) );
+    
+    bool cancelled = true;
+    CPPUNIT_ASSERT( blocker.take( cancelled ) );
+    CPPUNIT_ASSERT( ! cancelled );
+}
+
+
+
+void 
+OpenSteer::AsyncJobTest::testCancelWhileRunning()
+{
+    AsyncJobQueue queue( 1 );
+    std::atomic< bool > release( false );
+    std::atomic< bool > started( false );
+    {
+        AsyncPlan< bool > plan;
+        plan.submit( BlockingQuery( release, started ), queue );
+        waitUntil( started );
+        
+        // going out of scope cancels it, so it stops without being released
+    }
+    queue.waitUntilIdle();
+    CPPUNIT_ASSERT( ! release );
+}
+
+
+
+void 
+OpenSteer::AsyncJobTest::testSubmitReplacesPending()
+{
+    AsyncJobQueue queue( 1 );
+    std::atomic< bool > release( false );
+    std::atomic< bool > started( false );
+    AsyncPlan< bool > blocker;
+    blocker.submit( BlockingQuery( release, started ), queue );
+    waitUntil( started );
+    
+    std::atomic< int > firstRuns( 0 );
+    std::atomic< int > secondRuns( 0 );
+    AsyncPlan< int > plan;
+    plan.submit( CountingQuery( 1, firstRuns ), queue );
+    plan.submit( CountingQuery( 2, secondRuns ), queue );
+    
+    release = true;
+    queue.waitUntilIdle();
+    int result = 0;
+    CPPUNIT_ASSERT( plan.take( result ) );
+    CPPUNIT_ASSERT_EQUAL( 2, result );
+    CPPUNIT_ASSERT_EQUAL( 0, int( firstRuns ) );
+    CPPUNIT_ASSERT_EQUAL( 1, int( secondRuns ) );
+}
@@ -0,0 +1,100 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::AsyncJobQueue and @c OpenSteer::AsyncPlan.
+ */
+#ifndef OPENSTEER_ASYNCJOBTEST_H
+#define OPENSTEER_ASYNCJOBTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class AsyncJobTest : public CppUnit::TestFixture {
+    public:
+        AsyncJobTest();
+        virtual ~AsyncJobTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(AsyncJobTest);
+        CPPUNIT_TEST(testTakeResult);
+        CPPUNIT_TEST(testCancelBeforeStart);
+        CPPUNIT_TEST(testCancelWhileRunning);
+        CPPUNIT_TEST(testSubmitReplacesPending);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        AsyncJobTest( AsyncJobTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        AsyncJobTest& operator=( AsyncJobTest const& );
+        
+    private:
+        /**
+         * Tests that a query's result is taken once, after it finished.
+         */
+        void testTakeResult();
+        
+        /**
+         * Tests that a query cancelled while queued never runs.
+         */
+        void testCancelBeforeStart();
+        
+        /**
+         * Tests that a running query sees its cancellation and that its
+         * result is dropped.
+         */
+        void testCancelWhileRunning();
+        
+        /**
+         * Tests that submitting a query cancels the pending one.
+         */
+        void testSubmitReplacesPending();
+        
+    }; // AsyncJobTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_ASYNCJOBTEST_H
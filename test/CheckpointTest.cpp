@@ -0,0 +1,271 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::CheckpointWriter and 
+ * @c OpenSteer::CheckpointReader.
+ */
+#include "CheckpointTest.h"
+
+
+// Include std::remove
+#include <cstdio>
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::CheckpointWriter, OpenSteer::CheckpointReader
+#include "OpenSteer/Checkpoint.h"
+
+// Include OpenSteer::SimpleVehicle
+#include "OpenSteer/SimpleVehicle.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::CheckpointTest );
+
+
+
+OpenSteer::CheckpointTest::CheckpointTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::CheckpointTest::~CheckpointTest()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::CheckpointTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::CheckpointTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    
+    /**
+     * @c SimpleVehicle is abstract.
+     */
+    class TestVehicle : public SimpleVehicle {
+    public:
+        virtual void update( float const /* currentTime */, float const elapsedTime ) {
+            applySteeringForce( steerForWander( elapsedTime ), elapsedTime );
+        }
+    }; // class TestVehicle
+    
+    
+    struct Settings {
+        int mode;
+        float scale;
+    };
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::CheckpointTest::testSections()
+{
+    Settings settings = { 3, 0.25f };
+    Vec3 const points[] = { Vec3( 1, 2, 3 ), Vec3( 4, 5, 6 ) };
+    char const odd[] = { 'a', 'b', 'c' };
+    
+    CheckpointWriter writer( "Test", 12.5f );
+    writer.addArray( checkpointTag( "ODD_" ), odd, 3 );
+    writer.addRecord( checkpointTag( "SETS" ), settings );
+    writer.addArray( checkpointTag( "PNTS" ), points, 2 );
+    writer.addArray< Vec3 >( checkpointTag( "NONE" ), 0, 0 );
+    
+    CheckpointReader reader;
+    CPPUNIT_ASSERT( reader.openMemory( &writer.bytes()[ 0 ], writer.bytes().size() ) );
+    CPPUNIT_ASSERT( reader.isOpen() );
+    CPPUNIT_ASSERT( "Test" == reader.plugInName() );
+    CPPUNIT_ASSERT_EQUAL( 12.5f, reader.currentTime() );
+    
+    Settings readSettings = { 0, 0 };
+    CPPUNIT_ASSERT( reader.record( checkpointTag( "SETS" ), readSettings ) );
+    CPPUNIT_ASSERT_EQUAL( 3, readSettings.mode );
+    CPPUNIT_ASSERT_EQUAL( 0.25f, readSettings.scale );
+    
+    // Sections follow the odd sized one aligned, records are read in place.
+    size_t count = 0;
+    Vec3 const* readPoints = reader.array< Vec3 >( checkpointTag( "PNTS" ), count );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 2 ), count );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 0 ), reinterpret_cast< size_t >( readPoints ) % 4 );
+    CPPUNIT_ASSERT( points[ 0 ] == readPoints[ 0 ] );
+    CPPUNIT_ASSERT( points[ 1 ] == readPoints[ 1 ] );
+    
+    CPPUNIT_ASSERT( 0 != reader.array< Vec3 >( checkpointTag( "NONE" ), count ) );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 0 ), count );
+    
+    // Missing sections and records of another size are not found.
+    CPPUNIT_ASSERT( 0 == reader.array< Vec3 >( checkpointTag( "MISS" ), count ) );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 0 ), count );
+    CPPUNIT_ASSERT( 0 == reader.array< float >( checkpointTag( "PNTS" ), count ) );
+    
+    reader.close();
+    CPPUNIT_ASSERT( ! reader.isOpen() );
+    CPPUNIT_ASSERT( reader.plugInName().empty() );
+}
+
+
+
+void 
+OpenSteer::CheckpointTest::testMalformed()
+{
+    CheckpointWriter writer( "Test", 1.0f );
+    writer.addRecord( checkpointTag( "SETS" ), 42 );
+    std::vector< char > bytes( writer.bytes() );
+    
+    CheckpointReader reader;
+    CPPUNIT_ASSERT( reader.openMemory( &bytes[ 0 ], bytes.size() ) );
+    
+    // Cut into the last section.
+    CPPUNIT_ASSERT( ! reader.openMemory( &bytes[ 0 ], bytes.size() - 8 ) );
+    CPPUNIT_ASSERT( ! reader.isOpen() );
+    
+    // Too short for a header.
+    CPPUNIT_ASSERT( ! reader.openMemory( &bytes[ 0 ], 4 ) );
+    
+    // Another format version, as stored after the eight magic bytes.
+    ++bytes[ 8 ];
+    CPPUNIT_ASSERT( ! reader.openMemory( &bytes[ 0 ], bytes.size() ) );
+    --bytes[ 8 ];
+    
+    // Other magic bytes.
+    bytes[ 0 ] = 'X';
+    CPPUNIT_ASSERT( ! reader.openMemory( &bytes[ 0 ], bytes.size() ) );
+    
+    CPPUNIT_ASSERT( ! reader.open( "no/such/checkpoint/file" ) );
+}
+
+
+
+void 
+OpenSteer::CheckpointTest::testVehicleState()
+{
+    float const elapsedTime = 1.0f / 60.0f;
+    
+    std::vector< TestVehicle* > vehicles;
+    vehicles.push_back( new TestVehicle() );
+    vehicles.push_back( new TestVehicle() );
+    for ( size_t i = 0; i < vehicles.size(); ++i ) {
+        vehicles[ i ]->setMaxForce( 5 );
+        vehicles[ i ]->setMaxSpeed( 3 );
+        vehicles[ i ]->setSpeed( 1 );
+        for ( int frame = 0; frame < 30; ++frame ) {
+            vehicles[ i ]->update( 0, elapsedTime );
+        }
+    }
+    
+    CheckpointWriter writer( "Test", 0.5f );
+    writer.addVehicles( checkpointTag( "VEHS" ), vehicles );
+    
+    CheckpointReader reader;
+    CPPUNIT_ASSERT( reader.openMemory( &writer.bytes()[ 0 ], writer.bytes().size() ) );
+    
+    std::vector< TestVehicle* > restored;
+    restored.push_back( new TestVehicle() );
+    
+    // Restoring needs a vehicle per record.
+    CPPUNIT_ASSERT( ! reader.restoreVehicles( checkpointTag( "VEHS" ), restored ) );
+    restored.push_back( new TestVehicle() );
+    CPPUNIT_ASSERT( reader.restoreVehicles( checkpointTag( "VEHS" ), restored ) );
+    
+    for ( size_t i = 0; i < vehicles.size(); ++i ) {
+        CPPUNIT_ASSERT( vehicles[ i ]->position() == restored[ i ]->position() );
+        CPPUNIT_ASSERT( vehicles[ i ]->forward() == restored[ i ]->forward() );
+        CPPUNIT_ASSERT_EQUAL( vehicles[ i ]->speed(), restored[ i ]->speed() );
+        CPPUNIT_ASSERT( vehicles[ i ]->randomStream() == restored[ i ]->randomStream() );
+        
+        // Both continue identically.
+        for ( int frame = 0; frame < 30; ++frame ) {
+            vehicles[ i ]->update( 0, elapsedTime );
+            restored[ i ]->update( 0, elapsedTime );
+        }
+        CPPUNIT_ASSERT( vehicles[ i ]->position() == restored[ i ]->position() );
+        CPPUNIT_ASSERT( vehicles[ i ]->side() == restored[ i ]->side() );
+        CPPUNIT_ASSERT( vehicles[ i ]->up() == restored[ i ]->up() );
+        CPPUNIT_ASSERT( vehicles[ i ]->smoothedAcceleration() == restored[ i ]->smoothedAcceleration() );
+        CPPUNIT_ASSERT_EQUAL( vehicles[ i ]->WanderSide, restored[ i ]->WanderSide );
+    }
+    
+    for ( size_t i = 0; i < vehicles.size(); ++i ) {
+        delete vehicles[ i ];
+        delete restored[ i ];
+    }
+}
+
+
+
+void 
+OpenSteer::CheckpointTest::testFile()
+{
+    char const* const fileName = "CheckpointTest.checkpoint";
+    Vec3 const points[] = { Vec3( 1, 2, 3 ), Vec3( 4, 5, 6 ), Vec3( 7, 8, 9 ) };
+    
+    CheckpointWriter writer( "File", 2.0f );
+    writer.addArray( checkpointTag( "PNTS" ), points, 3 );
+    CPPUNIT_ASSERT( writer.writeFile( fileName ) );
+    
+    {
+        CheckpointReader reader;
+        CPPUNIT_ASSERT( reader.open( fileName ) );
+        CPPUNIT_ASSERT( "File" == reader.plugInName() );
+        CPPUNIT_ASSERT_EQUAL( 2.0f, reader.currentTime() );
+        
+        size_t count = 0;
+        Vec3 const* readPoints = reader.array< Vec3 >( checkpointTag( "PNTS" ), count );
+        CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 3 ), count );
+        CPPUNIT_ASSERT( points[ 2 ] == readPoints[ 2 ] );
+    }
+    
+    std::remove( fileName );
+}
+
+
+
+
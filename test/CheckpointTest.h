@@ -0,0 +1,105 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::CheckpointWriter and 
+ * @c OpenSteer::CheckpointReader.
+ */
+#ifndef OPENSTEER_CHECKPOINTTEST_H
+#define OPENSTEER_CHECKPOINTTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class CheckpointTest : public CppUnit::TestFixture {
+    public:
+        CheckpointTest();
+        virtual ~CheckpointTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(CheckpointTest);
+        CPPUNIT_TEST(testSections);
+        CPPUNIT_TEST(testMalformed);
+        CPPUNIT_TEST(testVehicleState);
+        CPPUNIT_TEST(testFile);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        CheckpointTest( CheckpointTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        CheckpointTest& operator=( CheckpointTest const& );
+        
+    private:
+        /**
+         * Tests that the header and the sections added to a checkpoint are
+         * read back, and that sections are aligned and typed by record size.
+         */
+        void testSections();
+        
+        /**
+         * Tests that truncated checkpoints and ones of another version are
+         * rejected.
+         */
+        void testMalformed();
+        
+        /**
+         * Tests that a restored vehicle continues exactly like the saved
+         * one, including its random numbers.
+         */
+        void testVehicleState();
+        
+        /**
+         * Tests writing a checkpoint file and mapping it back.
+         */
+        void testFile();
+        
+    }; // CheckpointTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_CHECKPOINTTEST_H
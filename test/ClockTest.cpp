@@ -0,0 +1,178 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::Clock.
+ */
+#include "ClockTest.h"
+
+
+// Include std::abs
+#include <cmath>
+
+// Include FLT_MAX
+#include <cfloat>
+
+// Include OpenSteer::Clock
+#include "OpenSteer/Clock.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::ClockTest );
+
+
+
+namespace {
+    
+    /**
+     * Sets @a clock to advance simulation time by 1/60 second per update,
+     * whatever the real time.
+     */
+    void makeAnimationClock( OpenSteer::Clock& clock )
+    {
+        clock.setAnimationMode( true );
+        clock.setVariableFrameRateMode( false );
+        clock.setFixedFrameRate( 60 );
+    }
+    
+    
+    float const tolerance = 1.0e-4f;
+    
+} // anonymous namespace
+
+
+
+OpenSteer::ClockTest::ClockTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::ClockTest::~ClockTest()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::ClockTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::ClockTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::ClockTest::testFixedTimeStep()
+{
+    Clock clock;
+    makeAnimationClock( clock );
+    float const step = 1.0f / 240.0f;
+    clock.setFixedTimeStep( step, 8 );
+    
+    int steps = 0;
+    float previous = 0.0f;
+    int const frames = 30;
+    for ( int frame = 0; frame < frames; ++frame ) {
+        clock.update();
+        CPPUNIT_ASSERT( clock.getSubsteps() >= 3 );
+        CPPUNIT_ASSERT( clock.getSubsteps() <= 5 );
+        for ( int i = 0; i < clock.getSubsteps(); ++i ) {
+            CPPUNIT_ASSERT( std::abs( clock.getSubstepTime( i ) - previous - step ) < tolerance );
+            previous = clock.getSubstepTime( i );
+            ++steps;
+        }
+        CPPUNIT_ASSERT( clock.getStepInterpolation() >= 0.0f );
+        CPPUNIT_ASSERT( clock.getStepInterpolation() < 1.0f );
+    }
+    
+    CPPUNIT_ASSERT( std::abs( steps - frames * 4 ) <= 1 );
+    CPPUNIT_ASSERT_EQUAL( 0.0f, clock.getDroppedSimulationTime() );
+}
+
+
+
+void 
+OpenSteer::ClockTest::testMaxSubsteps()
+{
+    // ten steps are due per update, four taken
+    Clock clock;
+    makeAnimationClock( clock );
+    float const step = 1.0f / 600.0f;
+    clock.setFixedTimeStep( step, 4 );
+    
+    int const frames = 10;
+    for ( int frame = 0; frame < frames; ++frame ) {
+        clock.update();
+        CPPUNIT_ASSERT_EQUAL( 4, clock.getSubsteps() );
+    }
+    CPPUNIT_ASSERT( std::abs( clock.getDroppedSimulationTime() - frames * 6 * step ) < tolerance );
+    CPPUNIT_ASSERT( std::abs( clock.getSubstepTime( 3 ) - frames * 4 * step ) < tolerance );
+    
+    // giving up all but the first step of a frame drops the others
+    float const dropped = clock.getDroppedSimulationTime();
+    float const first = clock.getSubstepTime( 0 );
+    clock.dropSubsteps( 1 );
+    CPPUNIT_ASSERT_EQUAL( 1, clock.getSubsteps() );
+    CPPUNIT_ASSERT( std::abs( clock.getSubstepTime( 0 ) - first ) < tolerance );
+    CPPUNIT_ASSERT( std::abs( clock.getDroppedSimulationTime() - dropped - 3 * step ) < tolerance );
+    
+    clock.update();
+    CPPUNIT_ASSERT( std::abs( clock.getSubstepTime( 0 ) - first - step ) < tolerance );
+}
+
+
+
+void 
+OpenSteer::ClockTest::testFrameBudget()
+{
+    Clock clock;
+    clock.update();
+    CPPUNIT_ASSERT_EQUAL( FLT_MAX, clock.getFrameTimeLeft() );
+    CPPUNIT_ASSERT( ! clock.frameBudgetExceeded() );
+    
+    clock.setFrameBudget( 1000.0f );
+    CPPUNIT_ASSERT( clock.getFrameTimeLeft() > 0.0f );
+    CPPUNIT_ASSERT( clock.getFrameTimeLeft() <= 1000.0f );
+    CPPUNIT_ASSERT( ! clock.frameBudgetExceeded() );
+    
+    clock.setFrameBudget( 1.0e-6f );
+    while ( clock.getFrameTimeUsed() <= 1.0e-5f ) {
+        // Wait past the budget.
+    }
+    CPPUNIT_ASSERT( clock.getFrameTimeLeft() < 0.0f );
+    CPPUNIT_ASSERT( clock.frameBudgetExceeded() );
+}
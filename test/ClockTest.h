@@ -0,0 +1,95 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::Clock.
+ */
+#ifndef OPENSTEER_CLOCKTEST_H
+#define OPENSTEER_CLOCKTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class ClockTest : public CppUnit::TestFixture {
+    public:
+        ClockTest();
+        virtual ~ClockTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(ClockTest);
+        CPPUNIT_TEST(testFixedTimeStep);
+        CPPUNIT_TEST(testMaxSubsteps);
+        CPPUNIT_TEST(testFrameBudget);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ClockTest( ClockTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ClockTest& operator=( ClockTest const& );
+        
+    private:
+        /**
+         * Tests that the fixed steps taken add up to the simulation time
+         * elapsed, one step apart.
+         */
+        void testFixedTimeStep();
+        
+        /**
+         * Tests that steps beyond the substep budget, or given up, are
+         * dropped rather than carried over.
+         */
+        void testMaxSubsteps();
+        
+        /**
+         * Tests the time left of a frame budget, and its absence.
+         */
+        void testFrameBudget();
+        
+    }; // ClockTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_CLOCKTEST_H
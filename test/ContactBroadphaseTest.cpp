@@ -0,0 +1,252 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::ContactBroadphase.
+ */
+#include "ContactBroadphaseTest.h"
+
+
+// Include std::sort
+#include <algorithm>
+
+// Include std::pair
+#include <utility>
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::ContactBroadphase
+#include "OpenSteer/ContactBroadphase.h"
+
+// Include OpenSteer::RandomStream
+#include "OpenSteer/Random.h"
+
+// Include OpenSteer::SimpleVehicle
+#include "OpenSteer/SimpleVehicle.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::ContactBroadphaseTest );
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    class TestVehicle : public SimpleVehicle {
+    public:
+        virtual void update( float const /* currentTime */, float const /* elapsedTime */ ) {
+            // Nothing to do.
+        }
+    }; // class TestVehicle
+    
+    typedef std::vector< std::pair< AbstractVehicle*, AbstractVehicle* > > Pairs;
+    
+    /**
+     * The overlapping pairs of @a group, each in group order.
+     */
+    Pairs bruteForceContacts( AVGroup const& group ) {
+        Pairs result;
+        for ( size_t i = 0; i < group.size(); ++i ) {
+            for ( size_t j = i + 1; j < group.size(); ++j ) {
+                float const sumOfRadii = group[ i ]->radius() + group[ j ]->radius();
+                if ( ( group[ j ]->position() - group[ i ]->position() ).lengthSquared() < sumOfRadii * sumOfRadii ) {
+                    result.push_back( std::make_pair( group[ i ], group[ j ] ) );
+                }
+            }
+        }
+        std::sort( result.begin(), result.end() );
+        return result;
+    }
+    
+    Pairs contactPairs( ContactBroadphase const& broadphase ) {
+        Pairs result;
+        for ( size_t i = 0; i < broadphase.contacts().size(); ++i ) {
+            ContactBroadphase::Contact const& contact = broadphase.contacts()[ i ];
+            result.push_back( std::make_pair( contact.vehicle, contact.other ) );
+        }
+        std::sort( result.begin(), result.end() );
+        return result;
+    }
+    
+    /**
+     * @a count vehicles of radius 0.5 to 1.5 in a 20 x 4 x 20 box.
+     */
+    void scatter( std::vector< TestVehicle >& vehicles, AVGroup& group, size_t count, RandomStream& random ) {
+        vehicles.resize( count );
+        group.clear();
+        for ( size_t i = 0; i < count; ++i ) {
+            vehicles[ i ].setRadius( 0.5f + random.frandom01() );
+            vehicles[ i ].setPosition( Vec3( random.frandom2( -10.0f, 10.0f ),
+                                             random.frandom2( -2.0f, 2.0f ),
+                                             random.frandom2( -10.0f, 10.0f ) ) );
+            group.push_back( &vehicles[ i ] );
+        }
+    }
+    
+    void countContact( ContactBroadphase::Contact const& contact, void* clientQueryState ) {
+        std::vector< float >& penetrations = *static_cast< std::vector< float >* >( clientQueryState );
+        penetrations.push_back( contact.penetration );
+    }
+    
+} // anonymous namespace
+
+
+
+OpenSteer::ContactBroadphaseTest::ContactBroadphaseTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::ContactBroadphaseTest::~ContactBroadphaseTest()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::ContactBroadphaseTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::ContactBroadphaseTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::ContactBroadphaseTest::testMatchesBruteForce()
+{
+    RandomStream random( 3 );
+    std::vector< TestVehicle > vehicles;
+    AVGroup group;
+    scatter( vehicles, group, 200, random );
+    
+    ContactBroadphase broadphase;
+    for ( int frame = 0; frame < 50; ++frame ) {
+        size_t const count = broadphase.update( group );
+        CPPUNIT_ASSERT_EQUAL( frame == 0, broadphase.rebuilt() );
+        Pairs const expected = bruteForceContacts( group );
+        CPPUNIT_ASSERT( ! expected.empty() );
+        CPPUNIT_ASSERT_EQUAL( expected.size(), count );
+        CPPUNIT_ASSERT( expected == contactPairs( broadphase ) );
+        CPPUNIT_ASSERT( broadphase.pairTestCount() < group.size() * ( group.size() - 1 ) / 2 );
+        
+        for ( size_t i = 0; i < vehicles.size(); ++i ) {
+            vehicles[ i ].setPosition( vehicles[ i ].position() + RandomVectorInUnitRadiusSphere( random ) * 0.2f );
+        }
+    }
+    
+    // The x and z spread is wider than the y spread.
+    CPPUNIT_ASSERT( broadphase.sweepAxis() != 1 );
+}
+
+
+
+void 
+OpenSteer::ContactBroadphaseTest::testGroupChange()
+{
+    RandomStream random( 5 );
+    std::vector< TestVehicle > vehicles;
+    AVGroup group;
+    scatter( vehicles, group, 100, random );
+    
+    ContactBroadphase broadphase;
+    broadphase.update( group );
+    CPPUNIT_ASSERT( broadphase.rebuilt() );
+    
+    group.pop_back();
+    std::swap( group[ 0 ], group[ 1 ] );
+    broadphase.update( group );
+    CPPUNIT_ASSERT( broadphase.rebuilt() );
+    CPPUNIT_ASSERT( bruteForceContacts( group ) == contactPairs( broadphase ) );
+    
+    broadphase.update( group );
+    CPPUNIT_ASSERT( ! broadphase.rebuilt() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), broadphase.swapCount() );
+    
+    broadphase.clear();
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), broadphase.contactCount() );
+    broadphase.update( group );
+    CPPUNIT_ASSERT( broadphase.rebuilt() );
+    
+    AVGroup const empty;
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), broadphase.update( empty ) );
+}
+
+
+
+void 
+OpenSteer::ContactBroadphaseTest::testTouching()
+{
+    std::vector< TestVehicle > vehicles( 3 );
+    AVGroup group;
+    for ( size_t i = 0; i < vehicles.size(); ++i ) {
+        vehicles[ i ].setRadius( 1.0f );
+        group.push_back( &vehicles[ i ] );
+    }
+    vehicles[ 1 ].setPosition( Vec3( 2.0f, 0.0f, 0.0f ) );
+    vehicles[ 2 ].setPosition( Vec3( 3.5f, 0.0f, 0.0f ) );
+    
+    ContactBroadphase broadphase;
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), broadphase.update( group ) );
+    ContactBroadphase::Contact const& contact = broadphase.contacts()[ 0 ];
+    CPPUNIT_ASSERT( &vehicles[ 1 ] == contact.vehicle );
+    CPPUNIT_ASSERT( &vehicles[ 2 ] == contact.other );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.5f, contact.penetration, 1.0e-6f );
+}
+
+
+
+void 
+OpenSteer::ContactBroadphaseTest::testForEachContact()
+{
+    RandomStream random( 7 );
+    std::vector< TestVehicle > vehicles;
+    AVGroup group;
+    scatter( vehicles, group, 100, random );
+    
+    ContactBroadphase broadphase;
+    broadphase.update( group );
+    std::vector< float > penetrations;
+    broadphase.forEachContact( countContact, &penetrations );
+    CPPUNIT_ASSERT_EQUAL( broadphase.contactCount(), penetrations.size() );
+    for ( size_t i = 0; i < penetrations.size(); ++i ) {
+        CPPUNIT_ASSERT( penetrations[ i ] > 0.0f );
+        CPPUNIT_ASSERT( penetrations[ i ] <= 3.0f );
+    }
+}
@@ -0,0 +1,101 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::ContactBroadphase.
+ */
+#ifndef OPENSTEER_CONTACTBROADPHASETEST_H
+#define OPENSTEER_CONTACTBROADPHASETEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class ContactBroadphaseTest : public CppUnit::TestFixture {
+    public:
+        ContactBroadphaseTest();
+        virtual ~ContactBroadphaseTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(ContactBroadphaseTest);
+        CPPUNIT_TEST(testMatchesBruteForce);
+        CPPUNIT_TEST(testGroupChange);
+        CPPUNIT_TEST(testTouching);
+        CPPUNIT_TEST(testForEachContact);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ContactBroadphaseTest( ContactBroadphaseTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ContactBroadphaseTest& operator=( ContactBroadphaseTest const& );
+        
+    private:
+        /**
+         * Tests that the contacts of moving vehicles are those found by
+         * testing every pair, and that the order is repaired rather than
+         * rebuilt while the group stays the same.
+         */
+        void testMatchesBruteForce();
+        
+        /**
+         * Tests that a changed group of vehicles rebuilds the order.
+         */
+        void testGroupChange();
+        
+        /**
+         * Tests that spheres which only touch are not in contact.
+         */
+        void testTouching();
+        
+        /**
+         * Tests that forEachContact applies a function to each contact.
+         */
+        void testForEachContact();
+        
+    }; // ContactBroadphaseTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_CONTACTBROADPHASETEST_H
@@ -0,0 +1,181 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::ContentCache and @c OpenSteer::ContentKey.
+ */
+#include "ContentCacheTest.h"
+
+
+// Include std::remove, std::rename
+#include <cstdio>
+
+// Include std::string
+#include <string>
+
+// Include OpenSteer::ContentCache, OpenSteer::ContentKey
+#include "OpenSteer/ContentCache.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::ContentCacheTest );
+
+
+
+OpenSteer::ContentCacheTest::ContentCacheTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::ContentCacheTest::~ContentCacheTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::ContentCacheTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::ContentCacheTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    char const* const kind = "ContentCacheTest";
+    OpenSteer::CheckpointTag const valuesTag = OpenSteer::checkpointTag( "VALS" );
+    
+    /**
+     * The key of a generation with the given parameters.
+     */
+    OpenSteer::ContentKey makeKey( int size, float spacing ) {
+        OpenSteer::ContentKey key;
+        key.add( size );
+        key.add( spacing );
+        key.addString( "generator" );
+        return key;
+    }
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::ContentCacheTest::testKeys()
+{
+    ContentCache const cache( "." );
+    CPPUNIT_ASSERT( makeKey( 3, 0.5f ).bytes() == makeKey( 3, 0.5f ).bytes() );
+    CPPUNIT_ASSERT_EQUAL( makeKey( 3, 0.5f ).hash(), makeKey( 3, 0.5f ).hash() );
+    CPPUNIT_ASSERT( makeKey( 3, 0.5f ).hash() != makeKey( 4, 0.5f ).hash() );
+    CPPUNIT_ASSERT( makeKey( 3, 0.5f ).hash() != makeKey( 3, 0.25f ).hash() );
+    CPPUNIT_ASSERT( cache.fileName( kind, makeKey( 3, 0.5f ) ) == cache.fileName( kind, makeKey( 3, 0.5f ) ) );
+    CPPUNIT_ASSERT( cache.fileName( kind, makeKey( 3, 0.5f ) ) != cache.fileName( kind, makeKey( 4, 0.5f ) ) );
+    
+    // the known FNV-1a hash of "a"
+    CPPUNIT_ASSERT_EQUAL( static_cast< uint64_t >( 0xaf63dc4c8601ec8cULL ), contentHash( "a", 1 ) );
+}
+
+
+
+void 
+OpenSteer::ContentCacheTest::testStoreAndLoad()
+{
+    ContentCache const cache( "." );
+    ContentKey const key = makeKey( 3, 0.5f );
+    float const values[] = { 1.0f, 2.0f, 3.0f };
+    
+    {
+        CheckpointReader reader;
+        std::remove( cache.fileName( kind, key ).c_str() );
+        CPPUNIT_ASSERT( ! cache.load( kind, key, reader ) );
+    }
+    
+    CheckpointWriter writer( kind, 0.0f );
+    writer.addArray( valuesTag, values, 3 );
+    CPPUNIT_ASSERT( cache.store( kind, key, writer ) );
+    
+    {
+        CheckpointReader reader;
+        CPPUNIT_ASSERT( cache.load( kind, key, reader ) );
+        std::size_t count = 0;
+        float const* loaded = reader.array< float >( valuesTag, count );
+        CPPUNIT_ASSERT_EQUAL( static_cast< std::size_t >( 3 ), count );
+        CPPUNIT_ASSERT_EQUAL( 3.0f, loaded[ 2 ] );
+    }
+    
+    std::remove( cache.fileName( kind, key ).c_str() );
+}
+
+
+
+void 
+OpenSteer::ContentCacheTest::testOtherKeyMisses()
+{
+    ContentCache const cache( "." );
+    ContentKey const stored = makeKey( 3, 0.5f );
+    ContentKey const wanted = makeKey( 4, 0.5f );
+    float const values[] = { 1.0f };
+    
+    CheckpointWriter writer( kind, 0.0f );
+    writer.addArray( valuesTag, values, 1 );
+    CPPUNIT_ASSERT( cache.store( kind, stored, writer ) );
+    std::string const name = cache.fileName( kind, wanted );
+    CPPUNIT_ASSERT( 0 == std::rename( cache.fileName( kind, stored ).c_str(), name.c_str() ) );
+    
+    CheckpointReader reader;
+    CPPUNIT_ASSERT( ! cache.load( kind, wanted, reader ) );
+    CPPUNIT_ASSERT( ! reader.isOpen() );
+    
+    std::remove( name.c_str() );
+}
+
+
+
+void 
+OpenSteer::ContentCacheTest::testDisabled()
+{
+    ContentCache const cache;
+    ContentKey const key = makeKey( 3, 0.5f );
+    CPPUNIT_ASSERT( ! cache.isEnabled() );
+    
+    CheckpointWriter writer( kind, 0.0f );
+    CPPUNIT_ASSERT( ! cache.store( kind, key, writer ) );
+    CheckpointReader reader;
+    CPPUNIT_ASSERT( ! cache.load( kind, key, reader ) );
+}
@@ -0,0 +1,98 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::ContentCache and @c OpenSteer::ContentKey.
+ */
+#ifndef OPENSTEER_CONTENTCACHETEST_H
+#define OPENSTEER_CONTENTCACHETEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class ContentCacheTest : public CppUnit::TestFixture {
+    public:
+        ContentCacheTest();
+        virtual ~ContentCacheTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(ContentCacheTest);
+        CPPUNIT_TEST(testKeys);
+        CPPUNIT_TEST(testStoreAndLoad);
+        CPPUNIT_TEST(testOtherKeyMisses);
+        CPPUNIT_TEST(testDisabled);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ContentCacheTest( ContentCacheTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ContentCacheTest& operator=( ContentCacheTest const& );
+        
+    private:
+        /**
+         * Tests that equal inputs give equal keys and file names, and
+         * different inputs different ones.
+         */
+        void testKeys();
+        
+        /**
+         * Tests that stored sections are loaded back in place.
+         */
+        void testStoreAndLoad();
+        
+        /**
+         * Tests that a file holding the results of another key is rejected
+         * even under this key's name.
+         */
+        void testOtherKeyMisses();
+        
+        /**
+         * Tests that a cache without a directory neither stores nor loads.
+         */
+        void testDisabled();
+        
+    }; // class ContentCacheTest
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_CONTENTCACHETEST_H
@@ -0,0 +1,137 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::UnitCircleTable and @c OpenSteer::BasicVehicleMesh.
+ */
+#include "DrawGeometryTest.h"
+
+
+// Include OpenSteer::UnitCircleTable, OpenSteer::BasicVehicleMesh
+#include "OpenSteer/DrawGeometry.h"
+
+// Include OPENSTEER_M_PI
+#include "OpenSteer/Utilities.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::DrawGeometryTest );
+
+
+
+OpenSteer::DrawGeometryTest::DrawGeometryTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::DrawGeometryTest::~DrawGeometryTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::DrawGeometryTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::DrawGeometryTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::DrawGeometryTest::testUnitCircleTable()
+{
+    int const segments = 20;
+    Vec3 const* const circle = UnitCircleTable::points( segments );
+    
+    Vec3 pointOnCircle( 1.0f, 0.0f, 0.0f );
+    float const step = ( 2.0f * OPENSTEER_M_PI ) / segments;
+    for ( int i = 0; i < segments; ++i ) {
+        CPPUNIT_ASSERT( ( circle[ i ] - pointOnCircle ).length() < 1e-5f );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0f, circle[ i ].length(), 1e-6f );
+        CPPUNIT_ASSERT_EQUAL( 0.0f, circle[ i ].y );
+        pointOnCircle = pointOnCircle.rotateAboutGlobalY( step );
+    }
+    CPPUNIT_ASSERT( circle[ segments ] == circle[ 0 ] );
+}
+
+
+
+void 
+OpenSteer::DrawGeometryTest::testUnitCircleTablesAreKept()
+{
+    int const large = UnitCircleTable::maxLockFreeSegments + 100;
+    
+    Vec3 const* const small = UnitCircleTable::points( 12 );
+    Vec3 const* const big = UnitCircleTable::points( large );
+    CPPUNIT_ASSERT( small != big );
+    CPPUNIT_ASSERT( UnitCircleTable::points( 12 ) == small );
+    CPPUNIT_ASSERT( UnitCircleTable::points( large ) == big );
+    CPPUNIT_ASSERT( UnitCircleTable::points( 13 ) != small );
+    CPPUNIT_ASSERT( big[ large ] == big[ 0 ] );
+    
+    // no segments at all count as one
+    CPPUNIT_ASSERT( UnitCircleTable::points( 0 ) == UnitCircleTable::points( 1 ) );
+}
+
+
+
+void 
+OpenSteer::DrawGeometryTest::testBasicVehicleMeshPlacement()
+{
+    Vec3 const position( 3.0f, 1.0f, -2.0f );
+    Vec3 const side( 0.0f, 0.0f, 1.0f );
+    Vec3 const up( 0.0f, 1.0f, 0.0f );
+    Vec3 const forward( -1.0f, 0.0f, 0.0f );
+    float const radius = 2.0f;
+    
+    Vec3 const nose = BasicVehicleMesh::place( BasicVehicleMesh::flatBody[ 0 ],
+                                               radius, position, side, up, forward );
+    CPPUNIT_ASSERT( ( nose - ( position + forward * radius ) ).length() < 1e-6f );
+    
+    for ( int i = 0; i < BasicVehicleMesh::sphericalTriangleCount * 3; ++i ) {
+        Vec3 const p = BasicVehicleMesh::place( BasicVehicleMesh::sphericalBody[ i ],
+                                                radius, position, side, up, forward );
+        CPPUNIT_ASSERT( ( p - position ).length() <= radius * 1.0001f );
+    }
+    for ( int i = 0; i < 3; ++i ) {
+        Vec3 const p = BasicVehicleMesh::place( BasicVehicleMesh::flatBody[ i ],
+                                                radius, position, side, up, forward );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( position.y, p.y, 1e-6f );
+    }
+}
@@ -0,0 +1,93 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::UnitCircleTable and @c OpenSteer::BasicVehicleMesh.
+ */
+#ifndef OPENSTEER_DRAWGEOMETRYTEST_H
+#define OPENSTEER_DRAWGEOMETRYTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class DrawGeometryTest : public CppUnit::TestFixture {
+    public:
+        DrawGeometryTest();
+        virtual ~DrawGeometryTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(DrawGeometryTest);
+        CPPUNIT_TEST(testUnitCircleTable);
+        CPPUNIT_TEST(testUnitCircleTablesAreKept);
+        CPPUNIT_TEST(testBasicVehicleMeshPlacement);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        DrawGeometryTest( DrawGeometryTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        DrawGeometryTest& operator=( DrawGeometryTest const& );
+        
+    private:
+        /**
+         * Tests that a table holds the points the rotation about the Y
+         * axis reaches step by step, closing on its first point.
+         */
+        void testUnitCircleTable();
+        
+        /**
+         * Tests that each segment count, small or large, gets one table
+         * which later calls return again.
+         */
+        void testUnitCircleTablesAreKept();
+        
+        /**
+         * Tests that the meshes placed for a vehicle put the nose at the
+         * front of its bounding circle and stay within it.
+         */
+        void testBasicVehicleMeshPlacement();
+        
+    }; // class DrawGeometryTest
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_DRAWGEOMETRYTEST_H
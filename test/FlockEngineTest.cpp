@@ -0,0 +1,312 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::FlockEngine.
+ */
+#include "FlockEngineTest.h"
+
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::FlockEngine
+#include "OpenSteer/FlockEngine.h"
+
+// Include OpenSteer::SimpleVehicle
+#include "OpenSteer/SimpleVehicle.h"
+
+// Include OpenSteer::WorkerPool
+#include "OpenSteer/WorkerPool.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::FlockEngineTest );
+
+
+
+OpenSteer::FlockEngineTest::FlockEngineTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::FlockEngineTest::~FlockEngineTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::FlockEngineTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::FlockEngineTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    /**
+     * A vehicle with the banking local space of a boid.
+     */
+    class TestBoid : public SimpleVehicle {
+    public:
+        void update( float const, float const ) {}
+        void regenerateLocalSpace( Vec3 const& newVelocity, float const elapsedTime ) {
+            regenerateLocalSpaceForBanking( newVelocity, elapsedTime );
+        }
+    };
+    
+    /**
+     * Gives @a flock @a count boids with a boid's limits, random headings
+     * and positions within @a radius of the origin.
+     */
+    void makeFlock( std::vector< TestBoid >& flock, size_t count, float radius, float speed ) 
+    {
+        RandomStream random( 7 );
+        flock.resize( count );
+        for ( size_t i = 0; i < count; ++i ) {
+            TestBoid& boid = flock[ i ];
+            boid.setMaxForce( 27.0f );
+            boid.setMaxSpeed( 9.0f );
+            boid.setSpeed( speed );
+            boid.regenerateOrthonormalBasisUF( RandomUnitVector( random ) );
+            boid.setPosition( RandomVectorInUnitRadiusSphere( random ) * radius );
+        }
+    }
+    
+    /**
+     * Boid::steerToFlock, with the neighbors found by brute force.
+     */
+    Vec3 steerToFlock( TestBoid& boid, std::vector< TestBoid >& flock, ObstacleIndex const& obstacles )
+    {
+        Vec3 const avoidance = boid.steerToAvoidObstacles( 1.0f, obstacles );
+        if ( avoidance != Vec3::zero ) {
+            return avoidance;
+        }
+        
+        AVNeighborGroup neighbors;
+        for ( size_t j = 0; j < flock.size(); ++j ) {
+            Vec3 const offset = flock[ j ].position() - boid.position();
+            float const d2 = offset.lengthSquared();
+            if ( d2 < 81.0f ) {
+                neighbors.push_back( AVNeighbor( &flock[ j ], d2, offset ) );
+            }
+        }
+        
+        Vec3 const separation = boid.steerForSeparation< TestBoid >( 5.0f, -0.707f, neighbors );
+        Vec3 const alignment = boid.steerForAlignment< TestBoid >( 7.5f, 0.7f, neighbors );
+        Vec3 const cohesion = boid.steerForCohesion< TestBoid >( 9.0f, -0.15f, neighbors );
+        return separation * 12.0f + alignment * 8.0f + cohesion * 8.0f;
+    }
+    
+    void assertNear( Vec3 const& expected, Vec3 const& actual, float tolerance )
+    {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.x, actual.x, tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.y, actual.y, tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.z, actual.z, tolerance );
+    }
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::FlockEngineTest::testStepMatchesVehicleUpdate()
+{
+    std::vector< TestBoid > flock;
+    makeFlock( flock, 300, 20.0f, 2.7f );
+    ObstacleIndex const noObstacles;
+    
+    FlockEngine engine;
+    for ( size_t i = 0; i < flock.size(); ++i ) {
+        engine.population().add( flock[ i ] );
+    }
+    
+    float const elapsedTime = 1.0f / 60.0f;
+    for ( int frame = 0; frame < 3; ++frame ) {
+        std::vector< Vec3 > steering( flock.size() );
+        for ( size_t i = 0; i < flock.size(); ++i ) {
+            steering[ i ] = steerToFlock( flock[ i ], flock, noObstacles );
+        }
+        
+        engine.step( elapsedTime );
+        
+        for ( size_t i = 0; i < flock.size(); ++i ) {
+            assertNear( steering[ i ], engine.steering( i ), 0.001f );
+            flock[ i ].applySteeringForce( steering[ i ], elapsedTime );
+            Vec3 p = flock[ i ].position();
+            if ( p.length() > 50.0f ) {
+                flock[ i ].setPosition( p.sphericalWrapAround( Vec3::zero, 50.0f ) );
+            }
+            assertNear( flock[ i ].position(), engine.population().position( i ), 0.001f );
+            assertNear( flock[ i ].forward(), engine.population().forward( i ), 0.001f );
+        }
+    }
+}
+
+
+
+void 
+OpenSteer::FlockEngineTest::testSphereAvoidanceMatchesObstacleIndex()
+{
+    std::vector< TestBoid > flock;
+    makeFlock( flock, 400, 60.0f, 9.0f );
+    
+    SphereObstacle big( 50.0f, Vec3::zero );
+    big.setSeenFrom( Obstacle::inside );
+    SphereObstacle small( 15.0f, Vec3( 10.0f, 0.0f, 0.0f ) );
+    SphereObstacle hollow( 8.0f, Vec3( -20.0f, 5.0f, 0.0f ) );
+    hollow.setSeenFrom( Obstacle::both );
+    
+    ObstacleGroup group;
+    group.push_back( &big );
+    group.push_back( &small );
+    group.push_back( &hollow );
+    ObstacleIndex const index( group );
+    
+    std::vector< SphereObstacle const* > spheres;
+    spheres.push_back( &big );
+    spheres.push_back( &small );
+    spheres.push_back( &hollow );
+    
+    FlockEngine engine;
+    engine.setObstacles( spheres );
+    for ( size_t i = 0; i < flock.size(); ++i ) {
+        engine.population().add( flock[ i ] );
+    }
+    engine.step( 1.0f / 60.0f );
+    
+    size_t avoiding = 0;
+    for ( size_t i = 0; i < flock.size(); ++i ) {
+        Vec3 const avoidance = flock[ i ].steerToAvoidObstacles( 1.0f, index );
+        if ( avoidance != Vec3::zero ) {
+            assertNear( avoidance, engine.steering( i ), 0.0001f );
+            ++avoiding;
+        }
+    }
+    CPPUNIT_ASSERT( avoiding > 0 );
+}
+
+
+
+void 
+OpenSteer::FlockEngineTest::testStepIndependentOfPool()
+{
+    std::vector< TestBoid > flock;
+    makeFlock( flock, 500, 2000.0f, 9.0f );
+    
+    FlockEngine::Parameters parameters;
+    parameters.wrapAroundRadius = 0.0f;
+    FlockEngine serial;
+    FlockEngine parallel;
+    serial.setParameters( parameters );
+    parallel.setParameters( parameters );
+    for ( size_t i = 0; i < flock.size(); ++i ) {
+        serial.population().add( flock[ i ] );
+        parallel.population().add( flock[ i ] );
+    }
+    
+    WorkerPool pool( 4 );
+    for ( int frame = 0; frame < 5; ++frame ) {
+        serial.step( 0.1f );
+        parallel.step( 0.1f, &pool );
+    }
+    
+    for ( int axis = 0; axis < 3; ++axis ) {
+        CPPUNIT_ASSERT( serial.gridCells( axis ) <= 64 );
+    }
+    for ( size_t i = 0; i < flock.size(); ++i ) {
+        CPPUNIT_ASSERT( serial.population().position( i ) == parallel.population().position( i ) );
+        CPPUNIT_ASSERT( serial.population().forward( i ) == parallel.population().forward( i ) );
+        CPPUNIT_ASSERT_EQUAL( serial.neighborCount( i ), parallel.neighborCount( i ) );
+    }
+}
+
+
+
+void 
+OpenSteer::FlockEngineTest::testApproximationError()
+{
+    std::vector< TestBoid > flock;
+    makeFlock( flock, 600, 25.0f, 2.7f );
+    
+    FlockEngine::Parameters parameters;
+    parameters.alignmentRadius = 20.0f;
+    parameters.cohesionRadius = 30.0f;
+    parameters.errorSampleStride = 1;
+    
+    float const thresholds[] = { 0.000001f, 0.5f, 1.0f };
+    float means[ 3 ];
+    FlockEngine exact;
+    exact.setParameters( parameters );
+    for ( size_t i = 0; i < flock.size(); ++i ) {
+        exact.population().add( flock[ i ] );
+    }
+    exact.step( 0.1f );
+    
+    for ( int t = 0; t < 3; ++t ) {
+        parameters.approximation = thresholds[ t ];
+        FlockEngine engine;
+        engine.setParameters( parameters );
+        for ( size_t i = 0; i < flock.size(); ++i ) {
+            engine.population().add( flock[ i ] );
+        }
+        engine.step( 0.1f );
+        
+        CPPUNIT_ASSERT_EQUAL( flock.size(), engine.approximationErrorSamples() );
+        CPPUNIT_ASSERT( engine.approximationErrorMax() >= engine.approximationErrorMean() );
+        means[ t ] = engine.approximationErrorMean();
+        
+        // the reported error is against the exact steering
+        float total = 0.0f;
+        for ( size_t i = 0; i < flock.size(); ++i ) {
+            total += Vec3::distance( engine.steering( i ), exact.steering( i ) );
+        }
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( total / flock.size(), means[ t ], 0.001f );
+    }
+    
+    CPPUNIT_ASSERT( means[ 0 ] < 0.001f );
+    CPPUNIT_ASSERT( means[ 1 ] > 0.0f );
+    CPPUNIT_ASSERT( means[ 1 ] < means[ 2 ] );
+    CPPUNIT_ASSERT( means[ 2 ] < 2.0f );
+}
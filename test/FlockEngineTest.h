@@ -0,0 +1,108 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::FlockEngine.
+ */
+#ifndef OPENSTEER_FLOCKENGINETEST_H
+#define OPENSTEER_FLOCKENGINETEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class FlockEngineTest : public CppUnit::TestFixture {
+    public:
+        FlockEngineTest();
+        virtual ~FlockEngineTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(FlockEngineTest);
+        CPPUNIT_TEST(testStepMatchesVehicleUpdate);
+        CPPUNIT_TEST(testSphereAvoidanceMatchesObstacleIndex);
+        CPPUNIT_TEST(testStepIndependentOfPool);
+        CPPUNIT_TEST(testApproximationError);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        FlockEngineTest( FlockEngineTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        FlockEngineTest& operator=( FlockEngineTest const& );
+        
+    private:
+        /**
+         * Tests that the steering and integration of a step match, within
+         * float tolerance, those of flocking vehicles using brute force
+         * neighbor groups and @c applySteeringForce.
+         */
+        void testStepMatchesVehicleUpdate();
+        
+        /**
+         * Tests that the avoidance of sphere obstacles matches
+         * @c ObstacleIndex::steerToAvoidObstacles.
+         */
+        void testSphereAvoidanceMatchesObstacleIndex();
+        
+        /**
+         * Tests that steps spread over a worker pool give exactly the
+         * result of serial steps, also for a flock wider than the grid's
+         * cell limit.
+         */
+        void testStepIndependentOfPool();
+        
+        /**
+         * Tests that aggregating far cells approximates the exact steering
+         * of wide flocking radii, more closely for a smaller threshold,
+         * and not at all for a tiny one.
+         */
+        void testApproximationError();
+        
+    }; // FlockEngineTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_FLOCKENGINETEST_H
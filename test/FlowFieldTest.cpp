@@ -0,0 +1,259 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::FlowField.
+ */
+#include "FlowFieldTest.h"
+
+
+
+
+#include <cmath>
+
+
+// Include OpenSteer::FlowField
+#include "OpenSteer/FlowField.h"
+
+// Include OpenSteer::PolylineSegmentedPathwaySingleRadius
+#include "OpenSteer/PolylineSegmentedPathwaySingleRadius.h"
+
+// Include OpenSteer::RandomStream
+#include "OpenSteer/Random.h"
+
+// Include OpenSteer::SimpleVehicle
+#include "OpenSteer/SimpleVehicle.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::FlowFieldTest );
+
+
+
+OpenSteer::FlowFieldTest::FlowFieldTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::FlowFieldTest::~FlowFieldTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::FlowFieldTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::FlowFieldTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    float const tolerance = 0.001f;
+    float const cellSize = 0.5f;
+    int const sampleCount = 2000;
+    
+    class TestVehicle : public SimpleVehicle {
+    public:
+        void update( float const, float const ) {}
+    };
+    
+    
+    /**
+     * The Pedestrian PlugIn's path: bends both ways, an acute turn and a
+     * crossing.
+     */
+    PolylineSegmentedPathwaySingleRadius makeTestPath()
+    {
+        Vec3 const points[] = { Vec3( -23.5f, 0.0f, -59.5f ),
+                                Vec3( 36.5f, 0.0f, 60.5f ),
+                                Vec3( 66.5f, 0.0f, 30.5f ),
+                                Vec3( 36.5f, 0.0f, 0.5f ),
+                                Vec3( 0.5f, 0.0f, 0.5f ),
+                                Vec3( 0.5f, 0.0f, 60.5f ),
+                                Vec3( 36.5f, 0.0f, 30.5f ) };
+        return PolylineSegmentedPathwaySingleRadius( 7, points, 2.0f, false );
+    }
+    
+    
+    /**
+     * A point on the plane within @a spread of the path's center line.
+     */
+    Vec3 pointNearPath( PolylineSegmentedPathwaySingleRadius const& path,
+                        RandomStream& random,
+                        float const spread )
+    {
+        Vec3 const onPath = path.mapPathDistanceToPoint( random.frandom01() * path.length() );
+        return onPath + Vec3( random.frandom2( -spread, spread ),
+                              0.0f,
+                              random.frandom2( -spread, spread ) );
+    }
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::FlowFieldTest::testLookupMatchesPathway()
+{
+    PolylineSegmentedPathwaySingleRadius const path = makeTestPath();
+    FlowField field;
+    field.build( path, cellSize );
+    CPPUNIT_ASSERT( 0 < field.exactCellCount() );
+    
+    RandomStream random( 1 );
+    int inside = 0;
+    int found = 0;
+    for ( int i = 0; i < sampleCount; ++i ) {
+        Vec3 const point = pointNearPath( path, random, 3.0f );
+        
+        Vec3 tangent;
+        float outside;
+        float pathDistance;
+        PathCursor cursor;
+        Vec3 const onPath = path.mapPointToPathAndDistance( point, tangent, outside, pathDistance, cursor );
+        if ( outside < 0.0f ) {
+            ++inside;
+        }
+        
+        Vec3 fieldOnPath;
+        Vec3 fieldTangent;
+        float fieldOutside;
+        float fieldPathDistance;
+        if ( field.lookup( point, fieldOnPath, fieldTangent, fieldOutside, fieldPathDistance ) ) {
+            ++found;
+            CPPUNIT_ASSERT( ( onPath - fieldOnPath ).length() < tolerance * 10.0f );
+            CPPUNIT_ASSERT( ( tangent - fieldTangent ).length() < tolerance );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( outside, fieldOutside, tolerance * 10.0f );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( pathDistance, fieldPathDistance, tolerance * 10.0f );
+            
+            float distanceOnly;
+            CPPUNIT_ASSERT( field.lookupPathDistance( point, distanceOnly ) );
+            CPPUNIT_ASSERT_EQUAL( fieldPathDistance, distanceOnly );
+        }
+    }
+    
+    // all but the cells about the bends, ends and crossing
+    CPPUNIT_ASSERT( found > inside / 2 );
+    
+    Vec3 onPath;
+    Vec3 tangent;
+    float outside;
+    float pathDistance;
+    CPPUNIT_ASSERT( ! field.lookup( Vec3( -1000.0f, 0.0f, 0.0f ), onPath, tangent, outside, pathDistance ) );
+    CPPUNIT_ASSERT( ! field.lookup( Vec3( 0.0f, 0.0f, 1000.0f ), onPath, tangent, outside, pathDistance ) );
+    
+    FlowField const empty;
+    CPPUNIT_ASSERT( ! empty.lookup( path.point( 0 ), onPath, tangent, outside, pathDistance ) );
+    CPPUNIT_ASSERT( ! empty.interior( path.point( 0 ) ) );
+}
+
+
+
+void 
+OpenSteer::FlowFieldTest::testInteriorIsInsidePathway()
+{
+    PolylineSegmentedPathwaySingleRadius const path = makeTestPath();
+    FlowField field;
+    field.build( path, cellSize );
+    
+    RandomStream random( 2 );
+    int wellInside = 0;
+    int interior = 0;
+    for ( int i = 0; i < sampleCount; ++i ) {
+        Vec3 const point = pointNearPath( path, random, 3.0f );
+        
+        Vec3 tangent;
+        float outside;
+        path.mapPointToPath( point, tangent, outside );
+        if ( outside < -2.0f * cellSize ) {
+            ++wellInside;
+        }
+        if ( field.interior( point ) ) {
+            ++interior;
+            CPPUNIT_ASSERT( outside < 0.0f );
+        }
+    }
+    CPPUNIT_ASSERT( interior > wellInside / 2 );
+    CPPUNIT_ASSERT( 0 < interior );
+}
+
+
+
+void 
+OpenSteer::FlowFieldTest::testSteeringMatchesPathway()
+{
+    PolylineSegmentedPathwaySingleRadius const path = makeTestPath();
+    FlowField field;
+    field.build( path, cellSize );
+    
+    RandomStream random( 3 );
+    int steering = 0;
+    for ( int i = 0; i < sampleCount; ++i ) {
+        TestVehicle v;
+        v.setMaxForce( 0.3f );
+        v.setMaxSpeed( 2.0f );
+        v.setPosition( pointNearPath( path, random, 2.5f ) );
+        float const angle = random.frandom2( -OPENSTEER_M_PI, OPENSTEER_M_PI );
+        v.regenerateOrthonormalBasisUF( Vec3( std::sin( angle ), 0.0f, std::cos( angle ) ) );
+        v.setSpeed( random.frandom2( 0.5f, 2.0f ) );
+        
+        for ( int direction = -1; direction <= 1; direction += 2 ) {
+            PathCursor cursor;
+            PathCursor fieldCursor;
+            Vec3 const follow = v.steerToFollowPath( direction, 3.0f, path, cursor );
+            Vec3 const fieldFollow = v.steerToFollowPath( direction, 3.0f, path, field, fieldCursor );
+            CPPUNIT_ASSERT( ( follow - fieldFollow ).length() < tolerance * 10.0f );
+            if ( Vec3::zero != follow ) {
+                ++steering;
+            }
+        }
+        
+        PathCursor cursor;
+        PathCursor fieldCursor;
+        Vec3 const stay = v.steerToStayOnPath( 3.0f, path, cursor );
+        Vec3 const fieldStay = v.steerToStayOnPath( 3.0f, path, field, fieldCursor );
+        CPPUNIT_ASSERT( ( stay - fieldStay ).length() < tolerance * 10.0f );
+    }
+    CPPUNIT_ASSERT( 0 < steering );
+}
@@ -0,0 +1,94 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::FlowField.
+ */
+#ifndef OPENSTEER_FLOWFIELDTEST_H
+#define OPENSTEER_FLOWFIELDTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class FlowFieldTest : public CppUnit::TestFixture {
+    public:
+        FlowFieldTest();
+        virtual ~FlowFieldTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(FlowFieldTest);
+        CPPUNIT_TEST(testLookupMatchesPathway);
+        CPPUNIT_TEST(testInteriorIsInsidePathway);
+        CPPUNIT_TEST(testSteeringMatchesPathway);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        FlowFieldTest( FlowFieldTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        FlowFieldTest& operator=( FlowFieldTest const& );
+        
+    private:
+        /**
+         * Tests that wherever a lookup succeeds it maps the point like the
+         * pathway, that it succeeds for most points inside the pathway, and
+         * that it fails off the grid.
+         */
+        void testLookupMatchesPathway();
+        
+        /**
+         * Tests that points of interior cells are inside the pathway and
+         * that points near the boundary are not in interior cells.
+         */
+        void testInteriorIsInsidePathway();
+        
+        /**
+         * Tests that path following with the field steers like path
+         * following with the pathway alone.
+         */
+        void testSteeringMatchesPathway();
+        
+    }; // class FlowFieldTest
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_FLOWFIELDTEST_H
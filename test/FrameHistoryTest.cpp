@@ -0,0 +1,159 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::FrameHistory.
+ */
+#include "FrameHistoryTest.h"
+
+
+// Include OpenSteer::FrameHistory, OpenSteer::FrameSample
+#include "OpenSteer/FrameHistory.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::FrameHistoryTest );
+
+
+
+OpenSteer::FrameHistoryTest::FrameHistoryTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::FrameHistoryTest::~FrameHistoryTest()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::FrameHistoryTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::FrameHistoryTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    
+    /**
+     * A sample spending @a draw milliseconds drawing.
+     */
+    OpenSteer::FrameSample makeSample( float draw )
+    {
+        OpenSteer::FrameSample sample;
+        sample.milliseconds[ OpenSteer::FrameSample::drawSeries ] = draw;
+        return sample;
+    }
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::FrameHistoryTest::testRingKeepsLatest()
+{
+    FrameHistory history( 3 );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 0 ), history.size() );
+    
+    for ( int i = 1; i <= 5; ++i ) {
+        history.add( makeSample( float( i ) ) );
+    }
+    
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 3 ), history.size() );
+    CPPUNIT_ASSERT_EQUAL( 3.0f, history[ 0 ].milliseconds[ FrameSample::drawSeries ] );
+    CPPUNIT_ASSERT_EQUAL( 4.0f, history[ 1 ].milliseconds[ FrameSample::drawSeries ] );
+    CPPUNIT_ASSERT_EQUAL( 5.0f, history[ 2 ].milliseconds[ FrameSample::drawSeries ] );
+    
+    history.clear();
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 0 ), history.size() );
+    history.add( makeSample( 7.0f ) );
+    CPPUNIT_ASSERT_EQUAL( 7.0f, history[ 0 ].milliseconds[ FrameSample::drawSeries ] );
+}
+
+
+
+void 
+OpenSteer::FrameHistoryTest::testTotals()
+{
+    FrameSample sample = makeSample( 2.0f );
+    sample.milliseconds[ FrameSample::steeringSeries ] = 1.5f;
+    sample.milliseconds[ FrameSample::annotationSeries ] = 0.5f;
+    CPPUNIT_ASSERT_EQUAL( 4.0f, sample.total() );
+    
+    FrameHistory history;
+    CPPUNIT_ASSERT_EQUAL( 0.0f, history.maxTotal() );
+    history.add( makeSample( 1.0f ) );
+    history.add( sample );
+    history.add( makeSample( 3.0f ) );
+    CPPUNIT_ASSERT_EQUAL( 4.0f, history.maxTotal() );
+}
+
+
+
+void 
+OpenSteer::FrameHistoryTest::testAverage()
+{
+    FrameHistory history;
+    history.add( makeSample( 1.0f ) );
+    
+    FrameSample withNeighbors = makeSample( 3.0f );
+    withNeighbors.hasNeighborStatistics = true;
+    withNeighbors.minNeighbors = 2;
+    withNeighbors.maxNeighbors = 6;
+    withNeighbors.averageNeighbors = 4.0f;
+    history.add( withNeighbors );
+    
+    withNeighbors.minNeighbors = 1;
+    withNeighbors.maxNeighbors = 5;
+    withNeighbors.averageNeighbors = 2.0f;
+    history.add( withNeighbors );
+    
+    FrameSample const average = history.average();
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 7.0f / 3.0f,
+                                  average.milliseconds[ FrameSample::drawSeries ],
+                                  1e-6f );
+    CPPUNIT_ASSERT( average.hasNeighborStatistics );
+    CPPUNIT_ASSERT_EQUAL( 1, average.minNeighbors );
+    CPPUNIT_ASSERT_EQUAL( 6, average.maxNeighbors );
+    CPPUNIT_ASSERT_EQUAL( 3.0f, average.averageNeighbors );
+}
@@ -0,0 +1,97 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::FrameHistory.
+ */
+#ifndef OPENSTEER_FRAMEHISTORYTEST_H
+#define OPENSTEER_FRAMEHISTORYTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class FrameHistoryTest : public CppUnit::TestFixture {
+    public:
+        FrameHistoryTest();
+        virtual ~FrameHistoryTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(FrameHistoryTest);
+        CPPUNIT_TEST(testRingKeepsLatest);
+        CPPUNIT_TEST(testTotals);
+        CPPUNIT_TEST(testAverage);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        FrameHistoryTest( FrameHistoryTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        FrameHistoryTest& operator=( FrameHistoryTest const& );
+        
+    private:
+        /**
+         * Tests that a full history drops its oldest samples and indexes
+         * the rest oldest first.
+         */
+        void testRingKeepsLatest();
+        
+        /**
+         * Tests sample totals and the largest total of a history.
+         */
+        void testTotals();
+        
+        /**
+         * Tests that averages only count neighbor statistics of the
+         * samples which have them.
+         */
+        void testAverage();
+        
+    }; // FrameHistoryTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_FRAMEHISTORYTEST_H
@@ -0,0 +1,238 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::CompactLocalSpaceMixin.
+ */
+#include "LocalSpaceTest.h"
+
+
+// Include OpenSteer::LocalSpace, OpenSteer::CompactLocalSpace
+#include "OpenSteer/LocalSpace.h"
+
+// Include OpenSteer::RandomStream
+#include "OpenSteer/Random.h"
+
+// Include OpenSteer::Vec3, OpenSteer::RandomUnitVector
+#include "OpenSteer/Vec3.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::LocalSpaceTest );
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    float const tolerance = 1.0e-4f;
+    
+    bool near( Vec3 const& lhs, Vec3 const& rhs ) {
+        return ( lhs - rhs ).length() < tolerance;
+    }
+    
+    bool sameBasis( AbstractLocalSpace const& lhs, AbstractLocalSpace const& rhs ) {
+        return near( lhs.side(), rhs.side() ) &&
+               near( lhs.up(), rhs.up() ) &&
+               near( lhs.forward(), rhs.forward() ) &&
+               near( lhs.position(), rhs.position() );
+    }
+    
+    /**
+     * A random orthonormal basis in @a space, set as LocalSpace sets it.
+     */
+    void randomBasis( LocalSpace& space, RandomStream& random ) {
+        space.setUp( RandomUnitVector( random ) );
+        space.regenerateOrthonormalBasis( RandomUnitVector( random ) );
+        space.setPosition( RandomVectorInUnitRadiusSphere( random ) * 10.0f );
+    }
+    
+} // anonymous namespace
+
+
+
+OpenSteer::LocalSpaceTest::LocalSpaceTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::LocalSpaceTest::~LocalSpaceTest()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::LocalSpaceTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::LocalSpaceTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::LocalSpaceTest::testIdentity()
+{
+    LocalSpace expected;
+    CompactLocalSpace space;
+    CPPUNIT_ASSERT( sameBasis( expected, space ) );
+    
+    space.regenerateOrthonormalBasis( Vec3( 1.0f, 2.0f, 3.0f ) );
+    space.setPosition( 1.0f, 2.0f, 3.0f );
+    space.resetLocalSpace();
+    CPPUNIT_ASSERT( sameBasis( expected, space ) );
+    
+    CompactLocalSpace const constructed( Vec3::up, Vec3::forward, Vec3::zero );
+    CPPUNIT_ASSERT( sameBasis( expected, constructed ) );
+}
+
+
+
+void 
+OpenSteer::LocalSpaceTest::testSetBasisVectors()
+{
+    RandomStream random( 7 );
+    for ( int i = 0; i < 100; ++i ) {
+        LocalSpace expected;
+        randomBasis( expected, random );
+        
+        CompactLocalSpace space;
+        space.setPosition( expected.position() );
+        if ( i % 2 ) {
+            space.setForward( expected.forward() );
+            space.setSide( expected.side() );
+            space.setUp( expected.up() );
+        } else {
+            space.setUp( expected.up() );
+            space.setSide( expected.side() );
+            space.setForward( expected.forward() );
+        }
+        CPPUNIT_ASSERT( sameBasis( expected, space ) );
+        
+        // Half turns.
+        space.setForward( -expected.forward() );
+        CPPUNIT_ASSERT( near( -expected.forward(), space.forward() ) );
+        space.setUp( -space.up() );
+        CPPUNIT_ASSERT( near( -expected.forward(), space.forward() ) );
+        CPPUNIT_ASSERT( near( expected.side(), space.side() ) );
+        
+        CompactLocalSpace const constructed( expected.side(), expected.up(), expected.forward(), expected.position() );
+        CPPUNIT_ASSERT( sameBasis( expected, constructed ) );
+    }
+}
+
+
+
+void 
+OpenSteer::LocalSpaceTest::testRegenerateBasis()
+{
+    RandomStream random( 11 );
+    LocalSpace expected;
+    CompactLocalSpace space;
+    for ( int i = 0; i < 1000; ++i ) {
+        // Small turns, as from a vehicle's velocity, banking at times.
+        Vec3 const forward = ( expected.forward() + RandomVectorInUnitRadiusSphere( random ) * 0.2f ).normalize();
+        if ( i % 3 ) {
+            expected.regenerateOrthonormalBasisUF( forward );
+            space.regenerateOrthonormalBasisUF( forward );
+        } else {
+            Vec3 const up = ( expected.up() + Vec3::up * 0.1f ).normalize();
+            expected.setUp( up );
+            expected.regenerateOrthonormalBasisUF( forward );
+            space.setUp( up );
+            space.regenerateOrthonormalBasisUF( forward );
+        }
+        CPPUNIT_ASSERT( sameBasis( expected, space ) );
+    }
+    
+    Vec3 const up = Vec3( 0.3f, 1.0f, 0.0f );
+    expected.regenerateOrthonormalBasis( Vec3( 2.0f, 0.0f, 1.0f ), up );
+    space.regenerateOrthonormalBasis( Vec3( 2.0f, 0.0f, 1.0f ), up );
+    CPPUNIT_ASSERT( sameBasis( expected, space ) );
+}
+
+
+
+void 
+OpenSteer::LocalSpaceTest::testTransforms()
+{
+    RandomStream random( 13 );
+    for ( int i = 0; i < 100; ++i ) {
+        LocalSpace expected;
+        randomBasis( expected, random );
+        CompactLocalSpace const space( expected.side(), expected.up(), expected.forward(), expected.position() );
+        
+        Vec3 const v = RandomVectorInUnitRadiusSphere( random ) * 5.0f;
+        CPPUNIT_ASSERT( near( expected.localizeDirection( v ), space.localizeDirection( v ) ) );
+        CPPUNIT_ASSERT( near( expected.localizePosition( v ), space.localizePosition( v ) ) );
+        CPPUNIT_ASSERT( near( expected.globalizeDirection( v ), space.globalizeDirection( v ) ) );
+        CPPUNIT_ASSERT( near( expected.globalizePosition( v ), space.globalizePosition( v ) ) );
+        CPPUNIT_ASSERT( near( v, space.localizePosition( space.globalizePosition( v ) ) ) );
+        CPPUNIT_ASSERT( near( expected.globalRotateForwardToSide( v ), space.globalRotateForwardToSide( v ) ) );
+    }
+}
+
+
+
+void 
+OpenSteer::LocalSpaceTest::testRotationRoundTrip()
+{
+    RandomStream random( 17 );
+    for ( int i = 0; i < 100; ++i ) {
+        CompactLocalSpace space;
+        space.setUp( RandomUnitVector( random ) );
+        space.regenerateOrthonormalBasis( RandomUnitVector( random ) );
+        space.setSide( RandomUnitVector( random ) );
+        
+        float q[ 4 ];
+        space.rotation( q );
+        CompactLocalSpace restored;
+        restored.setRotation( q );
+        CPPUNIT_ASSERT( space.side() == restored.side() );
+        CPPUNIT_ASSERT( space.up() == restored.up() );
+        CPPUNIT_ASSERT( space.forward() == restored.forward() );
+    }
+}
+
+
+
+void 
+OpenSteer::LocalSpaceTest::testSize()
+{
+    CPPUNIT_ASSERT( sizeof( CompactLocalSpace ) < sizeof( LocalSpace ) );
+}
@@ -0,0 +1,117 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::CompactLocalSpaceMixin.
+ */
+#ifndef OPENSTEER_LOCALSPACETEST_H
+#define OPENSTEER_LOCALSPACETEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class LocalSpaceTest : public CppUnit::TestFixture {
+    public:
+        LocalSpaceTest();
+        virtual ~LocalSpaceTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(LocalSpaceTest);
+        CPPUNIT_TEST(testIdentity);
+        CPPUNIT_TEST(testSetBasisVectors);
+        CPPUNIT_TEST(testRegenerateBasis);
+        CPPUNIT_TEST(testTransforms);
+        CPPUNIT_TEST(testRotationRoundTrip);
+        CPPUNIT_TEST(testSize);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        LocalSpaceTest( LocalSpaceTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        LocalSpaceTest& operator=( LocalSpaceTest const& );
+        
+    private:
+        /**
+         * Tests that a reset compact local space has the identity basis of
+         * a @c LocalSpace.
+         */
+        void testIdentity();
+        
+        /**
+         * Tests that setting the three vectors of an orthonormal basis in
+         * turn, in any order, gives that basis, also when a vector is
+         * turned around.
+         */
+        void testSetBasisVectors();
+        
+        /**
+         * Tests that regenerating the basis from new forwards (and ups)
+         * follows a @c LocalSpace doing the same.
+         */
+        void testRegenerateBasis();
+        
+        /**
+         * Tests that localizing and globalizing positions and directions
+         * agree with a @c LocalSpace of the same basis.
+         */
+        void testTransforms();
+        
+        /**
+         * Tests that saving and restoring the rotation gives back the
+         * basis exactly.
+         */
+        void testRotationRoundTrip();
+        
+        /**
+         * Tests that the compact form is smaller than the basis vectors.
+         */
+        void testSize();
+        
+    }; // LocalSpaceTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_LOCALSPACETEST_H
@@ -0,0 +1,175 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for the approximate math mode of @c OpenSteer::Vec3 (see Utilities.h).
+ */
+#include "MathModeTest.h"
+
+
+
+#include <cmath>
+
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+// Include OpenSteer::approximateMathIsOn and the approximations
+#include "OpenSteer/Utilities.h"
+
+// Include OpenSteer::RandomStream
+#include "OpenSteer/Random.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::MathModeTest );
+
+
+
+OpenSteer::MathModeTest::MathModeTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::MathModeTest::~MathModeTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::MathModeTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::MathModeTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    int const sampleCount = 10000;
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::MathModeTest::testExactModeByDefault()
+{
+    CPPUNIT_ASSERT( ! approximateMathIsOn() );
+    
+    RandomStream random( 1 );
+    for ( int i = 0; i < sampleCount; ++i ) {
+        Vec3 const v( random.frandom2( -50.0f, 50.0f ),
+                      random.frandom2( -50.0f, 50.0f ),
+                      random.frandom2( -50.0f, 50.0f ) );
+        float const angle = random.frandom2( -10.0f, 10.0f );
+        float const length = std::sqrt( v.lengthSquared() );
+        
+        CPPUNIT_ASSERT_EQUAL( length, v.length() );
+        CPPUNIT_ASSERT( v / length == v.normalize() );
+        CPPUNIT_ASSERT( ( length > 5.0f ? v * ( 5.0f / length ) : v ) == v.truncateLength( 5.0f ) );
+        CPPUNIT_ASSERT( Vec3( v.x * std::cos( angle ) + v.z * std::sin( angle ),
+                              v.y,
+                              v.z * std::cos( angle ) - v.x * std::sin( angle ) ) ==
+                        v.rotateAboutGlobalY( angle ) );
+    }
+}
+
+
+
+void 
+OpenSteer::MathModeTest::testApproximationBounds()
+{
+    RandomStream random( 2 );
+    for ( int i = 0; i < sampleCount; ++i ) {
+        float const x = std::exp( random.frandom2( -20.0f, 20.0f ) );
+        float const exact = 1.0f / std::sqrt( x );
+        CPPUNIT_ASSERT( std::fabs( approximateInverseSqrt( x ) - exact ) < 0.002f * exact );
+        
+        float const angle = random.frandom2( -100.0f, 100.0f );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( std::sin( angle ), approximateSin( angle ), 4e-5 );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( std::cos( angle ), approximateCos( angle ), 4e-5 );
+    }
+    CPPUNIT_ASSERT_EQUAL( 0.0f, approximateSqrt( 0.0f ) );
+    
+    // as Vec3's length and normalize use them in approximate builds
+    RandomStream vectors( 3 );
+    for ( int i = 0; i < sampleCount; ++i ) {
+        Vec3 const v( vectors.frandom2( -50.0f, 50.0f ),
+                      vectors.frandom2( -50.0f, 50.0f ),
+                      vectors.frandom2( -50.0f, 50.0f ) );
+        float const length = std::sqrt( v.lengthSquared() );
+        CPPUNIT_ASSERT( std::fabs( approximateSqrt( v.lengthSquared() ) - length ) < 0.002f * length );
+        CPPUNIT_ASSERT( ( v * approximateInverseSqrt( v.lengthSquared() ) - v / length ).length() < 0.002f );
+    }
+}
+
+
+
+void 
+OpenSteer::MathModeTest::testCosineExceeds()
+{
+    RandomStream random( 4 );
+    int checked = 0;
+    for ( int i = 0; i < sampleCount; ++i ) {
+        Vec3 const unit = RandomUnitVector( random );
+        Vec3 const offset = RandomVectorInUnitRadiusSphere( random ) * 20.0f;
+        float const cosine = random.frandom2( -1.0f, 1.0f );
+        
+        float const dot = unit.dot( offset );
+        float const lengthSquared = offset.lengthSquared();
+        double const exactCosine = dot / std::sqrt( double( lengthSquared ) );
+        
+        // leave out near ties, where rounding decides
+        if ( std::fabs( exactCosine - cosine ) < 1e-4 ) {
+            continue;
+        }
+        CPPUNIT_ASSERT_EQUAL( exactCosine > cosine, cosineExceeds( dot, lengthSquared, cosine ) );
+        ++checked;
+    }
+    CPPUNIT_ASSERT( checked > sampleCount / 2 );
+    
+    // a zero offset has cosine zero
+    CPPUNIT_ASSERT( cosineExceeds( 0.0f, 0.0f, -0.5f ) );
+    CPPUNIT_ASSERT( ! cosineExceeds( 0.0f, 0.0f, 0.5f ) );
+}
+
@@ -0,0 +1,91 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for the approximate math mode of @c OpenSteer::Vec3 (see Utilities.h).
+ */
+#ifndef OPENSTEER_MATHMODETEST_H
+#define OPENSTEER_MATHMODETEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class MathModeTest : public CppUnit::TestFixture {
+    public:
+        MathModeTest();
+        virtual ~MathModeTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(MathModeTest);
+        CPPUNIT_TEST(testExactModeByDefault);
+        CPPUNIT_TEST(testApproximationBounds);
+        CPPUNIT_TEST(testCosineExceeds);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        MathModeTest( MathModeTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        MathModeTest& operator=( MathModeTest const& );
+        
+    private:
+        /**
+         * Tests that the tests are built in exact mode, in which the Vec3
+         * operations give the results of the exact functions.
+         */
+        void testExactModeByDefault();
+        
+        /**
+         * Tests the approximations' errors against their stated bounds.
+         */
+        void testApproximationBounds();
+        
+        /**
+         * Tests that comparing squares agrees with comparing the cosine.
+         */
+        void testCosineExceeds();
+        
+    }; // class MathModeTest
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_MATHMODETEST_H
@@ -0,0 +1,219 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::MemoryAccount and its charging facilities.
+ */
+#include "MemoryAccountTest.h"
+
+
+// Include OpenSteer::MemoryAccount, OpenSteer::AccountedObject, OpenSteer::AccountedVector
+#include "OpenSteer/MemoryAccount.h"
+
+// Include OpenSteer::ObjectPool
+#include "OpenSteer/ObjectPool.h"
+
+// Include OpenSteer::SimpleVehicle
+#include "OpenSteer/SimpleVehicle.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::MemoryAccountTest );
+
+
+
+OpenSteer::MemoryAccountTest::MemoryAccountTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::MemoryAccountTest::~MemoryAccountTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::MemoryAccountTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::MemoryAccountTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    typedef OpenSteer::MemoryAccount MemoryAccount;
+    
+    
+    class Base : public OpenSteer::AccountedObject< MemoryAccount::otherMemory > {
+    public:
+        virtual ~Base() {}
+    };
+    
+    
+    class Derived : public Base {
+    public:
+        double payload[ 16 ];
+    };
+    
+    
+    class TestVehicle : public OpenSteer::SimpleVehicle {
+    public:
+        void update( float const, float const ) {}
+    };
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::MemoryAccountTest::testAccountedObject()
+{
+    std::size_t const bytes = MemoryAccount::liveBytes( MemoryAccount::otherMemory );
+    std::size_t const blocks = MemoryAccount::liveAllocations( MemoryAccount::otherMemory );
+    std::size_t const total = MemoryAccount::totalAllocations( MemoryAccount::otherMemory );
+    
+    Base* const object = new Derived;
+    CPPUNIT_ASSERT_EQUAL( bytes + sizeof( Derived ), MemoryAccount::liveBytes( MemoryAccount::otherMemory ) );
+    CPPUNIT_ASSERT_EQUAL( blocks + 1, MemoryAccount::liveAllocations( MemoryAccount::otherMemory ) );
+    CPPUNIT_ASSERT_EQUAL( total + 1, MemoryAccount::totalAllocations( MemoryAccount::otherMemory ) );
+    
+    {
+        Derived local;
+        CPPUNIT_ASSERT_EQUAL( bytes + sizeof( Derived ), MemoryAccount::liveBytes( MemoryAccount::otherMemory ) );
+    }
+    
+    delete object;
+    CPPUNIT_ASSERT_EQUAL( bytes, MemoryAccount::liveBytes( MemoryAccount::otherMemory ) );
+    CPPUNIT_ASSERT_EQUAL( blocks, MemoryAccount::liveAllocations( MemoryAccount::otherMemory ) );
+    CPPUNIT_ASSERT_EQUAL( total + 1, MemoryAccount::totalAllocations( MemoryAccount::otherMemory ) );
+}
+
+
+
+void 
+OpenSteer::MemoryAccountTest::testAllocator()
+{
+    std::size_t const bytes = MemoryAccount::liveBytes( MemoryAccount::otherMemory );
+    std::size_t const blocks = MemoryAccount::liveAllocations( MemoryAccount::otherMemory );
+    
+    {
+        AccountedVector< double, MemoryAccount::otherMemory >::type values;
+        values.reserve( 100 );
+        CPPUNIT_ASSERT_EQUAL( bytes + 100 * sizeof( double ), MemoryAccount::liveBytes( MemoryAccount::otherMemory ) );
+        CPPUNIT_ASSERT_EQUAL( blocks + 1, MemoryAccount::liveAllocations( MemoryAccount::otherMemory ) );
+        
+        values.assign( 10, 1.0 );
+        AccountedVector< double, MemoryAccount::otherMemory >::type copy( values );
+        CPPUNIT_ASSERT_EQUAL( bytes + ( 100 + copy.capacity() ) * sizeof( double ), MemoryAccount::liveBytes( MemoryAccount::otherMemory ) );
+        CPPUNIT_ASSERT_EQUAL( blocks + 2, MemoryAccount::liveAllocations( MemoryAccount::otherMemory ) );
+    }
+    
+    CPPUNIT_ASSERT_EQUAL( bytes, MemoryAccount::liveBytes( MemoryAccount::otherMemory ) );
+    CPPUNIT_ASSERT_EQUAL( blocks, MemoryAccount::liveAllocations( MemoryAccount::otherMemory ) );
+}
+
+
+
+void 
+OpenSteer::MemoryAccountTest::testCharge()
+{
+    std::size_t const bytes = MemoryAccount::liveBytes( MemoryAccount::otherMemory );
+    std::size_t const blocks = MemoryAccount::liveAllocations( MemoryAccount::otherMemory );
+    
+    {
+        MemoryAccount::Charge charge( MemoryAccount::otherMemory );
+        charge.set( 1000 );
+        charge.set( 400 );
+        CPPUNIT_ASSERT_EQUAL( std::size_t( 400 ), charge.charged() );
+        CPPUNIT_ASSERT_EQUAL( bytes + 400, MemoryAccount::liveBytes( MemoryAccount::otherMemory ) );
+        CPPUNIT_ASSERT_EQUAL( blocks + 1, MemoryAccount::liveAllocations( MemoryAccount::otherMemory ) );
+        
+        MemoryAccount::Charge const copy( charge );
+        CPPUNIT_ASSERT_EQUAL( std::size_t( 0 ), copy.charged() );
+        CPPUNIT_ASSERT_EQUAL( bytes + 400, MemoryAccount::liveBytes( MemoryAccount::otherMemory ) );
+        
+        charge.set( 0 );
+        CPPUNIT_ASSERT_EQUAL( blocks, MemoryAccount::liveAllocations( MemoryAccount::otherMemory ) );
+        charge.set( 50 );
+    }
+    
+    CPPUNIT_ASSERT_EQUAL( bytes, MemoryAccount::liveBytes( MemoryAccount::otherMemory ) );
+    CPPUNIT_ASSERT_EQUAL( blocks, MemoryAccount::liveAllocations( MemoryAccount::otherMemory ) );
+}
+
+
+
+void 
+OpenSteer::MemoryAccountTest::testObjectPool()
+{
+    std::size_t const bytes = MemoryAccount::liveBytes( MemoryAccount::tokenMemory );
+    std::size_t const blocks = MemoryAccount::liveAllocations( MemoryAccount::tokenMemory );
+    
+    {
+        ObjectPool< double > pool( 4, MemoryAccount::tokenMemory );
+        CPPUNIT_ASSERT_EQUAL( bytes, MemoryAccount::liveBytes( MemoryAccount::tokenMemory ) );
+        
+        pool.reserve( 10 );
+        void* const first = pool.allocate();
+        CPPUNIT_ASSERT_EQUAL( blocks + 1, MemoryAccount::liveAllocations( MemoryAccount::tokenMemory ) );
+        CPPUNIT_ASSERT( MemoryAccount::liveBytes( MemoryAccount::tokenMemory ) >= bytes + 10 * sizeof( double ) );
+        
+        ObjectPool< double >::release( first );
+        CPPUNIT_ASSERT_EQUAL( blocks + 1, MemoryAccount::liveAllocations( MemoryAccount::tokenMemory ) );
+    }
+    
+    CPPUNIT_ASSERT_EQUAL( bytes, MemoryAccount::liveBytes( MemoryAccount::tokenMemory ) );
+    CPPUNIT_ASSERT_EQUAL( blocks, MemoryAccount::liveAllocations( MemoryAccount::tokenMemory ) );
+}
+
+
+
+void 
+OpenSteer::MemoryAccountTest::testVehicles()
+{
+    std::size_t const bytes = MemoryAccount::liveBytes( MemoryAccount::vehicleMemory );
+    
+    AbstractVehicle* const vehicle = new TestVehicle;
+    CPPUNIT_ASSERT_EQUAL( bytes + sizeof( TestVehicle ), MemoryAccount::liveBytes( MemoryAccount::vehicleMemory ) );
+    
+    delete vehicle;
+    CPPUNIT_ASSERT_EQUAL( bytes, MemoryAccount::liveBytes( MemoryAccount::vehicleMemory ) );
+}
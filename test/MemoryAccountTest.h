@@ -0,0 +1,106 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::MemoryAccount and its charging facilities.
+ */
+#ifndef OPENSTEER_MEMORYACCOUNTTEST_H
+#define OPENSTEER_MEMORYACCOUNTTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class MemoryAccountTest : public CppUnit::TestFixture {
+    public:
+        MemoryAccountTest();
+        virtual ~MemoryAccountTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(MemoryAccountTest);
+        CPPUNIT_TEST(testAccountedObject);
+        CPPUNIT_TEST(testAllocator);
+        CPPUNIT_TEST(testCharge);
+        CPPUNIT_TEST(testObjectPool);
+        CPPUNIT_TEST(testVehicles);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        MemoryAccountTest( MemoryAccountTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        MemoryAccountTest& operator=( MemoryAccountTest const& );
+        
+    private:
+        /**
+         * Tests that an object created with new is charged with the size of
+         * its most derived class, also when deleted through a base pointer,
+         * and that objects not created with new are not charged.
+         */
+        void testAccountedObject();
+        
+        /**
+         * Tests that a container using the accounting allocator is charged
+         * with its capacity, as one block per allocation.
+         */
+        void testAllocator();
+        
+        /**
+         * Tests that a charge holds the bytes last set, that a copy starts
+         * out empty and that destruction releases the bytes.
+         */
+        void testCharge();
+        
+        /**
+         * Tests that a pool charges its chunks to its category.
+         */
+        void testObjectPool();
+        
+        /**
+         * Tests that vehicles created with new are charged to vehicle memory.
+         */
+        void testVehicles();
+        
+    }; // class MemoryAccountTest
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_MEMORYACCOUNTTEST_H
@@ -0,0 +1,330 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::NeighborList.
+ */
+#include "NeighborListTest.h"
+
+
+// Include std::vector
+#include <vector>
+
+// Include std::sort
+#include <algorithm>
+
+// Include OpenSteer::NeighborList, OpenSteer::NeighborListSkin
+#include "OpenSteer/NeighborList.h"
+
+// Include OpenSteer::BruteForceProximityDatabase
+#include "OpenSteer/Proximity.h"
+
+// Include OpenSteer::SimpleVehicle
+#include "OpenSteer/SimpleVehicle.h"
+
+// Include OpenSteer::RandomStream
+#include "OpenSteer/Random.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::NeighborListTest );
+
+
+
+OpenSteer::NeighborListTest::NeighborListTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::NeighborListTest::~NeighborListTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::NeighborListTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::NeighborListTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    typedef OpenSteer::AbstractVehicle* Vehicle;
+    typedef OpenSteer::AbstractProximityDatabase< Vehicle > Database;
+    typedef OpenSteer::AbstractTokenForProximityDatabase< Vehicle > Token;
+    
+    
+    class TestVehicle : public OpenSteer::SimpleVehicle {
+    public:
+        void update( float const, float const ) {}
+    };
+    
+    
+    /**
+     * A crowd of vehicles scattered in a box, each with its token in a
+     * brute force database.
+     */
+    class Crowd {
+    public:
+        Crowd( Database& database, std::size_t count ) : vehicles_( count ), tokens_( count ) {
+            OpenSteer::RandomStream random( 7 );
+            for ( std::size_t i = 0; i < count; ++i ) {
+                vehicles_[ i ].setPosition( OpenSteer::Vec3( random.frandom01() * 20.0f,
+                                                             random.frandom01() * 20.0f,
+                                                             random.frandom01() * 20.0f ) );
+                tokens_[ i ] = database.allocateToken( &vehicles_[ i ] );
+                tokens_[ i ]->updateForNewPosition( vehicles_[ i ].position() );
+            }
+        }
+        
+        ~Crowd() {
+            for ( std::size_t i = 0; i < tokens_.size(); ++i ) {
+                delete tokens_[ i ];
+            }
+        }
+        
+        /**
+         * Moves each vehicle by a random offset of at most @a step along
+         * each axis.
+         */
+        void wander( OpenSteer::RandomStream& random, float step ) {
+            for ( std::size_t i = 0; i < vehicles_.size(); ++i ) {
+                OpenSteer::Vec3 const offset( random.frandom2( -step, step ),
+                                              random.frandom2( -step, step ),
+                                              random.frandom2( -step, step ) );
+                vehicles_[ i ].setPosition( vehicles_[ i ].position() + offset );
+                tokens_[ i ]->updateForNewPosition( vehicles_[ i ].position() );
+            }
+        }
+        
+        std::vector< OpenSteer::AbstractVehicle* > group() {
+            std::vector< OpenSteer::AbstractVehicle* > result;
+            for ( std::size_t i = 0; i < vehicles_.size(); ++i ) {
+                result.push_back( &vehicles_[ i ] );
+            }
+            return result;
+        }
+        
+        std::vector< TestVehicle > vehicles_;
+        std::vector< Token* > tokens_;
+        
+    private:
+        Crowd( Crowd const& );
+        Crowd& operator=( Crowd const& );
+    };
+    
+    
+    /**
+     * Orders neighbor records by their vehicle's address.
+     */
+    struct ByObject {
+        bool operator()( OpenSteer::AVNeighbor const& lhs, OpenSteer::AVNeighbor const& rhs ) const {
+            return lhs.object < rhs.object;
+        }
+    };
+    
+    /**
+     * @a records sorted by their vehicle's address.
+     */
+    OpenSteer::AVNeighborGroup sorted( OpenSteer::AVNeighborGroup records ) {
+        std::sort( records.begin(), records.end(), ByObject() );
+        return records;
+    }
+    
+    
+    float const radius = 3.0f;
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::NeighborListTest::testMatchesFreshQueries()
+{
+    BruteForceProximityDatabase< Vehicle > database;
+    Crowd crowd( database, 200 );
+    std::vector< AbstractVehicle* > const group = crowd.group();
+    NeighborListSkin skin( 1.0f );
+    std::vector< NeighborList > lists( group.size() );
+    RandomStream random( 11 );
+    
+    std::size_t found = 0;
+    for ( int frame = 0; frame < 50; ++frame ) {
+        skin.beginFrame( group );
+        for ( std::size_t i = 0; i < group.size(); ++i ) {
+            Vec3 const center = group[ i ]->position();
+            AVNeighborGroup cached;
+            lists[ i ].findNeighbors( skin, *crowd.tokens_[ i ], center, radius, cached );
+            AVNeighborGroup fresh;
+            crowd.tokens_[ i ]->findNeighbors( center, radius, fresh );
+            
+            cached = sorted( cached );
+            fresh = sorted( fresh );
+            CPPUNIT_ASSERT_EQUAL( fresh.size(), cached.size() );
+            for ( std::size_t j = 0; j < fresh.size(); ++j ) {
+                CPPUNIT_ASSERT( fresh[ j ].object == cached[ j ].object );
+                CPPUNIT_ASSERT_DOUBLES_EQUAL( fresh[ j ].distanceSquared, cached[ j ].distanceSquared, 1.0e-4f );
+            }
+            found += fresh.size();
+        }
+        crowd.wander( random, 0.1f );
+    }
+    
+    // the vehicles did meet, and the lists were rebuilt along the way
+    CPPUNIT_ASSERT( found > group.size() * 50 );
+    CPPUNIT_ASSERT( skin.rebuildCount() > 2 );
+    CPPUNIT_ASSERT( skin.rebuildCount() < 50 );
+}
+
+
+
+void 
+OpenSteer::NeighborListTest::testRebuildsOnlyWhenNeeded()
+{
+    BruteForceProximityDatabase< Vehicle > database;
+    Crowd crowd( database, 20 );
+    std::vector< AbstractVehicle* > const group = crowd.group();
+    NeighborListSkin skin( 1.0f );
+    
+    // standing still: one rebuild, for the first frame
+    skin.beginFrame( group );
+    unsigned long const first = skin.rebuildCount();
+    for ( int frame = 0; frame < 5; ++frame ) {
+        skin.beginFrame( group );
+    }
+    CPPUNIT_ASSERT_EQUAL( first, skin.rebuildCount() );
+    
+    // an explicit invalidation rebuilds once
+    skin.invalidate();
+    skin.beginFrame( group );
+    skin.beginFrame( group );
+    CPPUNIT_ASSERT_EQUAL( first + 1, skin.rebuildCount() );
+    
+    // one vehicle moving by 0.15 each frame: twice its displacement
+    // plus its step is 0.6, then 0.9, and crosses the skin in the third
+    // frame
+    for ( int frame = 0; frame < 2; ++frame ) {
+        crowd.vehicles_[ 0 ].setPosition( crowd.vehicles_[ 0 ].position() + Vec3( 0.15f, 0.0f, 0.0f ) );
+        skin.beginFrame( group );
+    }
+    CPPUNIT_ASSERT_EQUAL( first + 1, skin.rebuildCount() );
+    crowd.vehicles_[ 0 ].setPosition( crowd.vehicles_[ 0 ].position() + Vec3( 0.15f, 0.0f, 0.0f ) );
+    skin.beginFrame( group );
+    CPPUNIT_ASSERT_EQUAL( first + 2, skin.rebuildCount() );
+    
+    // a vehicle less rebuilds too
+    std::vector< AbstractVehicle* > fewer( group.begin(), group.end() - 1 );
+    skin.beginFrame( fewer );
+    CPPUNIT_ASSERT_EQUAL( first + 3, skin.rebuildCount() );
+}
+
+
+
+
+void 
+OpenSteer::NeighborListTest::testStaggeredRefresh()
+{
+    BruteForceProximityDatabase< Vehicle > database;
+    Crowd crowd( database, 100 );
+    std::vector< AbstractVehicle* > const group = crowd.group();
+    std::size_t const slices = 4;
+    NeighborRefreshSlices refresh( slices );
+    std::vector< NeighborList > lists( group.size() );
+    RandomStream random( 13 );
+    
+    std::size_t stale = 0;
+    for ( std::size_t frame = 0; frame < 12; ++frame ) {
+        for ( std::size_t i = 0; i < group.size(); ++i ) {
+            Vec3 const center = group[ i ]->position();
+            AVNeighborGroup reused;
+            lists[ i ].findNeighbors( refresh, i, *crowd.tokens_[ i ], center, radius, reused );
+            AVNeighborGroup fresh;
+            crowd.tokens_[ i ]->findNeighbors( center, radius, fresh );
+            
+            // all at the first query, then in turns every slices queries
+            bool const refreshed = ( frame == 0 ) || ( ( frame + i ) % slices == 0 );
+            reused = sorted( reused );
+            fresh = sorted( fresh );
+            if ( refreshed ) {
+                CPPUNIT_ASSERT_EQUAL( fresh.size(), reused.size() );
+            }
+            stale += fresh.size() - reused.size();
+            
+            // never a vehicle outside the radius
+            CPPUNIT_ASSERT( std::includes( fresh.begin(), fresh.end(),
+                                           reused.begin(), reused.end(),
+                                           ByObject() ) );
+        }
+        crowd.wander( random, 0.2f );
+    }
+    
+    // in between some arrivals were missed
+    CPPUNIT_ASSERT( stale > 0 );
+}
+
+
+
+void 
+OpenSteer::NeighborListTest::testMinimumSlices()
+{
+    NeighborRefreshSlices refresh( 2 );
+    unsigned long generation = refresh.currentGeneration();
+    
+    refresh.setMinimumSlices( 4 );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 4 ), refresh.slices() );
+    CPPUNIT_ASSERT( refresh.currentGeneration() != generation );
+    
+    // fewer slices set meanwhile do not count until the minimum is lifted
+    refresh.setSlices( 1 );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 4 ), refresh.slices() );
+    generation = refresh.currentGeneration();
+    refresh.setMinimumSlices( 2 );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 2 ), refresh.slices() );
+    CPPUNIT_ASSERT( refresh.currentGeneration() != generation );
+    
+    // nor does a minimum below the slices set
+    refresh.setSlices( 8 );
+    generation = refresh.currentGeneration();
+    refresh.setMinimumSlices( 1 );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 8 ), refresh.slices() );
+    CPPUNIT_ASSERT_EQUAL( generation, refresh.currentGeneration() );
+}
@@ -0,0 +1,101 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::NeighborList.
+ */
+#ifndef OPENSTEER_NEIGHBORLISTTEST_H
+#define OPENSTEER_NEIGHBORLISTTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class NeighborListTest : public CppUnit::TestFixture {
+    public:
+        NeighborListTest();
+        virtual ~NeighborListTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(NeighborListTest);
+        CPPUNIT_TEST(testMatchesFreshQueries);
+        CPPUNIT_TEST(testRebuildsOnlyWhenNeeded);
+        CPPUNIT_TEST(testStaggeredRefresh);
+        CPPUNIT_TEST(testMinimumSlices);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        NeighborListTest( NeighborListTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        NeighborListTest& operator=( NeighborListTest const& );
+        
+    private:
+        /**
+         * Tests that while vehicles wander the lists find the same
+         * neighbors, with the same distances, as fresh queries.
+         */
+        void testMatchesFreshQueries();
+        
+        /**
+         * Tests that the lists are rebuilt when vehicles may have crossed
+         * the skin or are invalidated, and not while they stand still.
+         */
+        void testRebuildsOnlyWhenNeeded();
+        
+        /**
+         * Tests that with refresh slices each list is refreshed at every
+         * Nth query, in turns, and finds a subset of the true neighbors in
+         * between.
+         */
+        void testStaggeredRefresh();
+        
+        /**
+         * Tests that a minimum number of slices overrides fewer slices set,
+         * and that changing the effective number refreshes all lists.
+         */
+        void testMinimumSlices();
+        
+    }; // class NeighborListTest
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_NEIGHBORLISTTEST_H
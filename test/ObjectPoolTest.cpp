@@ -0,0 +1,184 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::ObjectPool.
+ */
+#include "ObjectPoolTest.h"
+
+
+// Include OpenSteer::ObjectPool, OpenSteer::PooledObject
+#include "OpenSteer/ObjectPool.h"
+
+#include <vector>
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::ObjectPoolTest );
+
+
+
+OpenSteer::ObjectPoolTest::ObjectPoolTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::ObjectPoolTest::~ObjectPoolTest()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::ObjectPoolTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::ObjectPoolTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    
+    /**
+     * Base class with a virtual destructor, as proximity tokens have.
+     */
+    class Base {
+    public:
+        virtual ~Base() {}
+    }; // class Base
+    
+    
+    /**
+     * Counts its live instances.
+     */
+    class Pooled : public Base, public PooledObject< Pooled > {
+    public:
+        explicit Pooled( int& liveCount ) : liveCount_( liveCount ) { ++liveCount_; }
+        virtual ~Pooled() { --liveCount_; }
+        
+    private:
+        int& liveCount_;
+    }; // class Pooled
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::ObjectPoolTest::testReuse()
+{
+    ObjectPool< double > pool( 4 );
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), pool.capacity() );
+    
+    std::vector< double* > objects;
+    for ( int i = 0; i < 10; ++i ) {
+        objects.push_back( new ( pool.allocate() ) double( i ) );
+    }
+    CPPUNIT_ASSERT_EQUAL( size_t( 10 ), pool.size() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 12 ), pool.capacity() );
+    for ( int i = 0; i < 10; ++i ) {
+        CPPUNIT_ASSERT_EQUAL( double( i ), *objects[ i ] );
+    }
+    
+    void* const released = objects[ 3 ];
+    ObjectPool< double >::release( released );
+    CPPUNIT_ASSERT_EQUAL( size_t( 9 ), pool.size() );
+    CPPUNIT_ASSERT( released == pool.allocate() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 12 ), pool.capacity() );
+    
+    for ( int i = 0; i < 10; ++i ) {
+        ObjectPool< double >::release( objects[ i ] );
+    }
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), pool.size() );
+}
+
+
+
+void 
+OpenSteer::ObjectPoolTest::testReserve()
+{
+    ObjectPool< double > pool( 4 );
+    pool.allocate();
+    CPPUNIT_ASSERT_EQUAL( size_t( 4 ), pool.capacity() );
+    
+    // Three slots are free already, the rest come in one chunk.
+    pool.reserve( 100 );
+    CPPUNIT_ASSERT_EQUAL( size_t( 101 ), pool.capacity() );
+    
+    // Enough room already.
+    pool.reserve( 50 );
+    CPPUNIT_ASSERT_EQUAL( size_t( 101 ), pool.capacity() );
+    
+    for ( int i = 0; i < 100; ++i ) {
+        pool.allocate();
+    }
+    CPPUNIT_ASSERT_EQUAL( size_t( 101 ), pool.capacity() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 101 ), pool.size() );
+}
+
+
+
+void 
+OpenSteer::ObjectPoolTest::testPooledObject()
+{
+    ObjectPool< Pooled > first;
+    ObjectPool< Pooled > second;
+    int liveCount = 0;
+    
+    Base* const a = new ( first ) Pooled( liveCount );
+    Base* const b = new ( second ) Pooled( liveCount );
+    Base* const c = new ( first ) Pooled( liveCount );
+    CPPUNIT_ASSERT_EQUAL( 3, liveCount );
+    CPPUNIT_ASSERT_EQUAL( size_t( 2 ), first.size() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), second.size() );
+    
+    delete a;
+    delete b;
+    CPPUNIT_ASSERT_EQUAL( 1, liveCount );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), first.size() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), second.size() );
+    
+    delete c;
+    CPPUNIT_ASSERT_EQUAL( 0, liveCount );
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), first.size() );
+}
@@ -0,0 +1,277 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::ObstacleBatch.
+ */
+#include "ObstacleBatchTest.h"
+
+
+#include <vector>
+
+
+// Include OpenSteer::ObstacleBatch
+#include "OpenSteer/ObstacleBatch.h"
+
+// Include OpenSteer::SimpleVehicle
+#include "OpenSteer/SimpleVehicle.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::ObstacleBatchTest );
+
+
+
+
+OpenSteer::ObstacleBatchTest::ObstacleBatchTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::ObstacleBatchTest::~ObstacleBatchTest()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::ObstacleBatchTest::setUp()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::ObstacleBatchTest::tearDown()
+{
+    // Nothing to do.
+}
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    
+    /**
+     * @c SimpleVehicle is abstract.
+     */
+    class TestVehicle : public SimpleVehicle {
+    public:
+        virtual void update( float const /* currentTime */, float const /* elapsedTime */ ) {
+            // Nothing to do.
+        }
+    }; // class TestVehicle
+    
+    
+    /**
+     * A sphere type the batch does not know, which must still be tested
+     * through its own (here unchanged) intersection routine.
+     */
+    class DerivedSphere : public SphereObstacle {
+    public:
+        DerivedSphere( float r, Vec3 c ) : SphereObstacle( r, c ) {}
+    }; // class DerivedSphere
+    
+    
+    /**
+     * A small deterministic generator, independent of OpenSteer's global
+     * random number state.
+     */
+    class Random {
+    public:
+        Random() : state_( 54321u ) {}
+        float next( float low, float high ) {
+            state_ = state_ * 1664525u + 1013904223u;
+            return low + ( high - low ) * float( state_ >> 8 ) / float( 1u << 24 );
+        }
+        Vec3 position() {
+            return Vec3( next( -60.0f, 60.0f ), next( -8.0f, 8.0f ), next( -60.0f, 60.0f ) );
+        }
+        Vec3 direction() {
+            Vec3 const d( next( -1.0f, 1.0f ), next( -0.4f, 0.4f ), next( -1.0f, 1.0f ) );
+            return ( d.lengthSquared() > 0.0f ) ? d.normalize() : Vec3::forward;
+        }
+    private:
+        unsigned int state_;
+    }; // class Random
+    
+    
+    /**
+     * Obstacles of every kind, interleaved in the group, and vehicles
+     * scattered among them.
+     */
+    class Scene {
+    public:
+        Scene() : insideSphere_( 90.0f, Vec3::zero ), plane_( Vec3::side, Vec3::up, Vec3::forward, Vec3( 0.0f, 0.0f, -55.0f ) ) {
+            Random random;
+            for ( int i = 0; i < 120; ++i ) {
+                spheres_.push_back( SphereObstacle( random.next( 0.5f, 4.0f ), random.position() ) );
+                if ( i % 3 == 0 ) {
+                    spheres_.back().setSeenFrom( AbstractObstacle::both );
+                }
+            }
+            for ( int i = 0; i < 30; ++i ) {
+                BoxObstacle box( random.next( 1.0f, 6.0f ), random.next( 1.0f, 6.0f ), random.next( 1.0f, 6.0f ) );
+                box.setPosition( random.position() );
+                box.regenerateOrthonormalBasisUF( random.direction() );
+                boxes_.push_back( box );
+                
+                RectangleObstacle rectangle( random.next( 1.0f, 8.0f ), random.next( 1.0f, 8.0f ) );
+                rectangle.setPosition( random.position() );
+                rectangle.regenerateOrthonormalBasisUF( random.direction() );
+                rectangle.setSeenFrom( AbstractObstacle::both );
+                rectangles_.push_back( rectangle );
+                
+                derived_.push_back( DerivedSphere( random.next( 0.5f, 3.0f ), random.position() ) );
+            }
+            insideSphere_.setSeenFrom( AbstractObstacle::inside );
+            
+            // Interleave the kinds so group order differs from packet order.
+            for ( size_t i = 0; i < spheres_.size(); ++i ) {
+                group_.push_back( &spheres_[ i ] );
+                if ( i < boxes_.size() ) {
+                    group_.push_back( &rectangles_[ i ] );
+                    group_.push_back( &boxes_[ i ] );
+                    group_.push_back( &derived_[ i ] );
+                }
+                if ( i == 60 ) {
+                    group_.push_back( &insideSphere_ );
+                    group_.push_back( &plane_ );
+                }
+            }
+            
+            vehicles_.resize( 400 );
+            for ( size_t i = 0; i < vehicles_.size(); ++i ) {
+                vehicles_[ i ].reset();
+                vehicles_[ i ].setPosition( random.position() );
+                vehicles_[ i ].regenerateOrthonormalBasisUF( random.direction() );
+                vehicles_[ i ].setSpeed( random.next( 0.0f, 10.0f ) );
+                vehicles_[ i ].setRadius( random.next( 0.1f, 2.0f ) );
+            }
+            // One vehicle outside the hollow sphere, and one inside a solid one.
+            vehicles_[ 0 ].setPosition( Vec3( 120.0f, 0.0f, 0.0f ) );
+            vehicles_[ 1 ].setPosition( spheres_[ 5 ].center );
+        }
+        
+        ObstacleGroup const& group() const { return group_; }
+        std::vector< TestVehicle > const& vehicles() const { return vehicles_; }
+        std::vector< SphereObstacle >& spheres() { return spheres_; }
+        std::vector< BoxObstacle >& boxes() { return boxes_; }
+        
+    private:
+        std::vector< SphereObstacle > spheres_;
+        std::vector< BoxObstacle > boxes_;
+        std::vector< RectangleObstacle > rectangles_;
+        std::vector< DerivedSphere > derived_;
+        SphereObstacle insideSphere_;
+        PlaneObstacle plane_;
+        ObstacleGroup group_;
+        std::vector< TestVehicle > vehicles_;
+    }; // class Scene
+    
+    
+    void checkFirstPathIntersection( Scene const& scene, ObstacleBatch const& batch ) {
+        size_t intersections = 0;
+        for ( size_t i = 0; i < scene.vehicles().size(); ++i ) {
+            TestVehicle const& vehicle = scene.vehicles()[ i ];
+            AbstractObstacle::PathIntersection expected, found, next;
+            Obstacle::firstPathIntersectionWithObstacleGroup( vehicle, scene.group(), expected, next );
+            batch.firstPathIntersection( vehicle, found, next );
+            CPPUNIT_ASSERT_EQUAL( expected.intersect, found.intersect );
+            if ( expected.intersect ) {
+                ++intersections;
+                CPPUNIT_ASSERT_EQUAL( expected.distance, found.distance );
+                CPPUNIT_ASSERT( expected.obstacle == found.obstacle );
+                CPPUNIT_ASSERT( expected.steerHint == found.steerHint );
+                // A hollow sphere seen from outside reports no surface point.
+                if ( expected.obstacle->seenFrom() != AbstractObstacle::inside ) {
+                    CPPUNIT_ASSERT( expected.surfacePoint == found.surfacePoint );
+                }
+            }
+        }
+        // Make sure the comparison is not trivial.
+        CPPUNIT_ASSERT( intersections > 100 );
+    }
+    
+    
+    void checkSteering( Scene const& scene, ObstacleBatch const& batch ) {
+        float const times[] = { 0.5f, 2.0f, 10.0f };
+        for ( size_t t = 0; t < 3; ++t ) {
+            for ( size_t i = 0; i < scene.vehicles().size(); ++i ) {
+                TestVehicle const& vehicle = scene.vehicles()[ i ];
+                CPPUNIT_ASSERT( Obstacle::steerToAvoidObstacles( vehicle, times[ t ], scene.group() ) ==
+                                batch.steerToAvoidObstacles( vehicle, times[ t ] ) );
+            }
+        }
+    }
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::ObstacleBatchTest::testFirstPathIntersection()
+{
+    Scene scene;
+    ObstacleBatch const batch( scene.group() );
+    CPPUNIT_ASSERT_EQUAL( scene.group().size(), batch.size() );
+    checkFirstPathIntersection( scene, batch );
+}
+
+
+
+void 
+OpenSteer::ObstacleBatchTest::testSteerToAvoidObstacles()
+{
+    Scene scene;
+    ObstacleBatch const batch( scene.group() );
+    checkSteering( scene, batch );
+}
+
+
+
+void 
+OpenSteer::ObstacleBatchTest::testRefit()
+{
+    Scene scene;
+    ObstacleBatch batch( scene.group() );
+    for ( size_t i = 0; i < scene.spheres().size(); ++i ) {
+        scene.spheres()[ i ].center += Vec3( -3.0f, 0.5f, 4.0f ) * float( i % 4 );
+    }
+    for ( size_t i = 0; i < scene.boxes().size(); ++i ) {
+        scene.boxes()[ i ].setPosition( scene.boxes()[ i ].position() + Vec3( 6.0f, 0.0f, -2.0f ) * float( i % 3 ) );
+    }
+    batch.refit();
+    checkFirstPathIntersection( scene, batch );
+    checkSteering( scene, batch );
+}
@@ -0,0 +1,96 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::ObstacleBatch.
+ */
+#ifndef OPENSTEER_OBSTACLEBATCHTEST_H
+#define OPENSTEER_OBSTACLEBATCHTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class ObstacleBatchTest : public CppUnit::TestFixture {
+    public:
+        ObstacleBatchTest();
+        virtual ~ObstacleBatchTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(ObstacleBatchTest);
+        CPPUNIT_TEST(testFirstPathIntersection);
+        CPPUNIT_TEST(testSteerToAvoidObstacles);
+        CPPUNIT_TEST(testRefit);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ObstacleBatchTest( ObstacleBatchTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ObstacleBatchTest& operator=( ObstacleBatchTest const& );
+        
+    private:
+        /**
+         * Tests that the batch finds the same nearest intersection as
+         * testing each obstacle of the group in turn.
+         */
+        void testFirstPathIntersection();
+        
+        /**
+         * Tests that the batch steers every vehicle exactly as the group
+         * does.
+         */
+        void testSteerToAvoidObstacles();
+        
+        /**
+         * Tests that after obstacles move a refit batch still agrees with
+         * the group.
+         */
+        void testRefit();
+        
+    }; // ObstacleBatchTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_OBSTACLEBATCHTEST_H
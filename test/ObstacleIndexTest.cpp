@@ -0,0 +1,263 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::ObstacleIndex.
+ */
+#include "ObstacleIndexTest.h"
+
+
+#include <vector>
+
+
+// Include OpenSteer::ObstacleIndex, OpenSteer::SphereObstacle, ...
+#include "OpenSteer/Obstacle.h"
+
+// Include OpenSteer::SimpleVehicle
+#include "OpenSteer/SimpleVehicle.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::ObstacleIndexTest );
+
+
+
+
+OpenSteer::ObstacleIndexTest::ObstacleIndexTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::ObstacleIndexTest::~ObstacleIndexTest()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::ObstacleIndexTest::setUp()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::ObstacleIndexTest::tearDown()
+{
+    // Nothing to do.
+}
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    
+    /**
+     * @c SimpleVehicle is abstract.
+     */
+    class TestVehicle : public SimpleVehicle {
+    public:
+        virtual void update( float const /* currentTime */, float const /* elapsedTime */ ) {
+            // Nothing to do.
+        }
+    }; // class TestVehicle
+    
+    
+    /**
+     * A small deterministic generator, independent of OpenSteer's global
+     * random number state.
+     */
+    class Random {
+    public:
+        Random() : state_( 12345u ) {}
+        float next( float low, float high ) {
+            state_ = state_ * 1664525u + 1013904223u;
+            return low + ( high - low ) * float( state_ >> 8 ) / float( 1u << 24 );
+        }
+    private:
+        unsigned int state_;
+    }; // class Random
+    
+    
+    /**
+     * Many obstacles of every kind in a 200 x 20 x 200 region, and vehicles
+     * scattered among them with all kinds of headings.
+     */
+    class Scene {
+    public:
+        Scene() : insideSphere_( 150.0f, Vec3::zero ), plane_( Vec3::side, Vec3::up, Vec3::forward, Vec3( 0.0f, 0.0f, -90.0f ) ) {
+            Random random;
+            for ( int i = 0; i < 400; ++i ) {
+                spheres_.push_back( SphereObstacle( random.next( 0.5f, 3.0f ), randomPosition( random ) ) );
+            }
+            for ( int i = 0; i < 40; ++i ) {
+                BoxObstacle box( random.next( 1.0f, 6.0f ), random.next( 1.0f, 6.0f ), random.next( 1.0f, 6.0f ) );
+                box.setPosition( randomPosition( random ) );
+                box.regenerateOrthonormalBasisUF( randomDirection( random ) );
+                boxes_.push_back( box );
+            }
+            for ( int i = 0; i < 40; ++i ) {
+                RectangleObstacle rectangle( random.next( 1.0f, 8.0f ), random.next( 1.0f, 8.0f ) );
+                rectangle.setPosition( randomPosition( random ) );
+                rectangle.regenerateOrthonormalBasisUF( randomDirection( random ) );
+                rectangle.setSeenFrom( AbstractObstacle::both );
+                rectangles_.push_back( rectangle );
+            }
+            insideSphere_.setSeenFrom( AbstractObstacle::inside );
+            
+            for ( size_t i = 0; i < spheres_.size(); ++i ) group_.push_back( &spheres_[ i ] );
+            for ( size_t i = 0; i < boxes_.size(); ++i ) group_.push_back( &boxes_[ i ] );
+            for ( size_t i = 0; i < rectangles_.size(); ++i ) group_.push_back( &rectangles_[ i ] );
+            group_.push_back( &insideSphere_ );
+            group_.push_back( &plane_ );
+            
+            vehicles_.resize( 500 );
+            for ( size_t i = 0; i < vehicles_.size(); ++i ) {
+                vehicles_[ i ].reset();
+                vehicles_[ i ].setPosition( randomPosition( random ) );
+                vehicles_[ i ].regenerateOrthonormalBasisUF( randomDirection( random ) );
+                vehicles_[ i ].setSpeed( random.next( 0.0f, 10.0f ) );
+                vehicles_[ i ].setRadius( random.next( 0.1f, 2.0f ) );
+            }
+            // One vehicle well outside the hollow sphere.
+            vehicles_[ 0 ].setPosition( Vec3( 200.0f, 0.0f, 0.0f ) );
+        }
+        
+        ObstacleGroup const& group() const { return group_; }
+        std::vector< TestVehicle > const& vehicles() const { return vehicles_; }
+        std::vector< SphereObstacle >& spheres() { return spheres_; }
+        std::vector< BoxObstacle >& boxes() { return boxes_; }
+        
+    private:
+        static Vec3 randomPosition( Random& random ) {
+            return Vec3( random.next( -100.0f, 100.0f ), random.next( -10.0f, 10.0f ), random.next( -100.0f, 100.0f ) );
+        }
+        
+        static Vec3 randomDirection( Random& random ) {
+            Vec3 const d( random.next( -1.0f, 1.0f ), random.next( -0.3f, 0.3f ), random.next( -1.0f, 1.0f ) );
+            return ( d.lengthSquared() > 0.0f ) ? d.normalize() : Vec3::forward;
+        }
+        
+        std::vector< SphereObstacle > spheres_;
+        std::vector< BoxObstacle > boxes_;
+        std::vector< RectangleObstacle > rectangles_;
+        SphereObstacle insideSphere_;
+        PlaneObstacle plane_;
+        ObstacleGroup group_;
+        std::vector< TestVehicle > vehicles_;
+    }; // class Scene
+    
+    
+    /**
+     * Checks that the index steers every vehicle of the scene as the
+     * obstacle group does, for several look ahead times.
+     */
+    void checkSteering( Scene const& scene, ObstacleIndex const& index ) {
+        float const times[] = { 0.5f, 2.0f, 10.0f };
+        size_t steered = 0;
+        for ( size_t t = 0; t < 3; ++t ) {
+            for ( size_t i = 0; i < scene.vehicles().size(); ++i ) {
+                TestVehicle const& vehicle = scene.vehicles()[ i ];
+                Vec3 const expected = Obstacle::steerToAvoidObstacles( vehicle, times[ t ], scene.group() );
+                Vec3 const found = index.steerToAvoidObstacles( vehicle, times[ t ] );
+                CPPUNIT_ASSERT( expected == found );
+                if ( expected != Vec3::zero ) {
+                    ++steered;
+                }
+            }
+        }
+        // Make sure the comparison is not trivial.
+        CPPUNIT_ASSERT( steered > 100 );
+    }
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::ObstacleIndexTest::testSteerToAvoidObstacles()
+{
+    Scene scene;
+    ObstacleIndex const index( scene.group() );
+    CPPUNIT_ASSERT_EQUAL( scene.group().size(), index.size() );
+    checkSteering( scene, index );
+}
+
+
+
+void 
+OpenSteer::ObstacleIndexTest::testFirstPathIntersection()
+{
+    Scene scene;
+    ObstacleIndex const index( scene.group() );
+    float const maxDistance = 15.0f;
+    for ( size_t i = 0; i < scene.vehicles().size(); ++i ) {
+        TestVehicle const& vehicle = scene.vehicles()[ i ];
+        AbstractObstacle::PathIntersection expected, found, next;
+        Obstacle::firstPathIntersectionWithObstacleGroup( vehicle, scene.group(), expected, next );
+        index.firstPathIntersection( vehicle, maxDistance, found, next );
+        if ( expected.intersect && expected.distance < maxDistance ) {
+            CPPUNIT_ASSERT( found.intersect );
+            CPPUNIT_ASSERT_EQUAL( expected.distance, found.distance );
+            CPPUNIT_ASSERT( expected.obstacle == found.obstacle );
+            CPPUNIT_ASSERT( expected.steerHint == found.steerHint );
+        } else {
+            CPPUNIT_ASSERT( ! found.intersect || found.distance >= maxDistance );
+        }
+    }
+}
+
+
+
+void 
+OpenSteer::ObstacleIndexTest::testRefit()
+{
+    Scene scene;
+    ObstacleIndex index( scene.group() );
+    
+    // Move one sphere across the region and refit it alone.
+    scene.spheres()[ 7 ].center = Vec3( -60.0f, 0.0f, 75.0f );
+    scene.spheres()[ 7 ].radius = 10.0f;
+    index.refit( 7 );
+    checkSteering( scene, index );
+    
+    // Move every sphere and box, then refit them all.
+    for ( size_t i = 0; i < scene.spheres().size(); ++i ) {
+        scene.spheres()[ i ].center += Vec3( 5.0f, 0.0f, -3.0f ) * float( i % 5 );
+    }
+    for ( size_t i = 0; i < scene.boxes().size(); ++i ) {
+        scene.boxes()[ i ].setPosition( scene.boxes()[ i ].position() + Vec3( -4.0f, 1.0f, 2.0f ) * float( i % 3 ) );
+    }
+    index.refit();
+    checkSteering( scene, index );
+}
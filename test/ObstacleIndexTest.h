@@ -0,0 +1,96 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::ObstacleIndex.
+ */
+#ifndef OPENSTEER_OBSTACLEINDEXTEST_H
+#define OPENSTEER_OBSTACLEINDEXTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class ObstacleIndexTest : public CppUnit::TestFixture {
+    public:
+        ObstacleIndexTest();
+        virtual ~ObstacleIndexTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(ObstacleIndexTest);
+        CPPUNIT_TEST(testSteerToAvoidObstacles);
+        CPPUNIT_TEST(testFirstPathIntersection);
+        CPPUNIT_TEST(testRefit);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ObstacleIndexTest( ObstacleIndexTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ObstacleIndexTest& operator=( ObstacleIndexTest const& );
+        
+    private:
+        /**
+         * Tests that the index steers every vehicle exactly as testing the
+         * whole obstacle group does.
+         */
+        void testSteerToAvoidObstacles();
+        
+        /**
+         * Tests that the index finds the same nearest intersection as the
+         * group whenever that is nearer than the distance of interest.
+         */
+        void testFirstPathIntersection();
+        
+        /**
+         * Tests that after obstacles move, refitting one or all of them
+         * keeps results the same as the group's.
+         */
+        void testRefit();
+        
+    }; // ObstacleIndexTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_OBSTACLEINDEXTEST_H
@@ -0,0 +1,340 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::PathDatasetWriter and 
+ * @c OpenSteer::PathDatasetReader.
+ */
+#include "PathDatasetTest.h"
+
+
+// Include std::cos, std::sin
+#include <cmath>
+
+// Include std::remove
+#include <cstdio>
+
+// Include memcpy
+#include <cstring>
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::PathDatasetWriter, OpenSteer::PathDatasetReader
+#include "OpenSteer/PathDataset.h"
+
+// Include OpenSteer::PathCursor
+#include "OpenSteer/PathCursor.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::PathDatasetTest );
+
+
+
+OpenSteer::PathDatasetTest::PathDatasetTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::PathDatasetTest::~PathDatasetTest()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::PathDatasetTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::PathDatasetTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    
+    /**
+     * A winding polyline of @a count points.
+     */
+    std::vector< Vec3 > windingPoints( size_t count, float phase ) {
+        std::vector< Vec3 > points;
+        for ( size_t i = 0; i < count; ++i ) {
+            float const t = float( i ) * 0.7f + phase;
+            points.push_back( Vec3( 10.0f * std::cos( t ) + float( i ), 0.5f * std::sin( 3.0f * t ), 10.0f * std::sin( t ) ) );
+        }
+        return points;
+    }
+    
+    
+    std::vector< Vec3 > queryPoints() {
+        std::vector< Vec3 > queries;
+        for ( int i = -20; i <= 60; i += 3 ) {
+            queries.push_back( Vec3( float( i ), 1.0f, float( i % 7 ) * 2.0f - 6.0f ) );
+        }
+        return queries;
+    }
+    
+    
+    /**
+     * Checks that @a view maps points and distances exactly like 
+     * @a original.
+     */
+    template< class PathAlike >
+    void checkSameMappings( PathAlike const& original, PathAlike const& view ) {
+        CPPUNIT_ASSERT_EQUAL( original.pointCount(), view.pointCount() );
+        CPPUNIT_ASSERT_EQUAL( original.segmentCount(), view.segmentCount() );
+        CPPUNIT_ASSERT_EQUAL( original.isCyclic(), view.isCyclic() );
+        CPPUNIT_ASSERT_EQUAL( original.length(), view.length() );
+        
+        std::vector< Vec3 > const queries = queryPoints();
+        PathCursor originalCursor, viewCursor;
+        for ( size_t i = 0; i < queries.size(); ++i ) {
+            Vec3 expectedTangent, tangent;
+            float expectedOutside = 0.0f, outside = 0.0f;
+            Vec3 const expected = original.mapPointToPath( queries[ i ], expectedTangent, expectedOutside, originalCursor );
+            Vec3 const mapped = view.mapPointToPath( queries[ i ], tangent, outside, viewCursor );
+            CPPUNIT_ASSERT( expected == mapped );
+            CPPUNIT_ASSERT( expectedTangent == tangent );
+            CPPUNIT_ASSERT_EQUAL( expectedOutside, outside );
+            CPPUNIT_ASSERT_EQUAL( original.mapPointToPathDistance( queries[ i ] ), view.mapPointToPathDistance( queries[ i ] ) );
+            
+            float const distance = float( i ) * 3.1f - 10.0f;
+            CPPUNIT_ASSERT( original.mapPathDistanceToPoint( distance ) == view.mapPathDistanceToPoint( distance ) );
+        }
+    }
+    
+    
+    /**
+     * Writes a dataset of a path, a single radius pathway and a segment 
+     * radii pathway with segment index, and the latter again without.
+     */
+    void writeDataset( PathDatasetWriter& writer,
+                       PolylineSegmentedPath& path,
+                       PolylineSegmentedPathwaySingleRadius& singleRadius,
+                       PolylineSegmentedPathwaySegmentRadii& segmentRadii ) {
+        std::vector< Vec3 > const points = windingPoints( 40, 0.0f );
+        std::vector< float > radii;
+        for ( size_t i = 0; i < points.size(); ++i ) {
+            radii.push_back( 1.0f + float( i % 5 ) * 0.5f );
+        }
+        
+        path.setPath( points.size(), &points[ 0 ], false );
+        singleRadius.setPathway( 25, &points[ 5 ], 2.5f, true );
+        segmentRadii.setPathway( points.size(), &points[ 0 ], &radii[ 0 ], true );
+        
+        CPPUNIT_ASSERT_EQUAL( size_t( 0 ), writer.addPath( path, true ) );
+        CPPUNIT_ASSERT_EQUAL( size_t( 1 ), writer.addPathway( singleRadius, true ) );
+        CPPUNIT_ASSERT_EQUAL( size_t( 2 ), writer.addPathway( segmentRadii, true ) );
+        CPPUNIT_ASSERT_EQUAL( size_t( 3 ), writer.addPathway( segmentRadii, false ) );
+    }
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::PathDatasetTest::testPathways()
+{
+    PathDatasetWriter writer;
+    PolylineSegmentedPath path;
+    PolylineSegmentedPathwaySingleRadius singleRadius;
+    PolylineSegmentedPathwaySegmentRadii segmentRadii;
+    writeDataset( writer, path, singleRadius, segmentRadii );
+    
+    std::vector< char > const bytes = writer.bytes();
+    PathDatasetReader reader;
+    CPPUNIT_ASSERT( reader.openMemory( &bytes[ 0 ], bytes.size() ) );
+    CPPUNIT_ASSERT_EQUAL( size_t( 4 ), reader.pathCount() );
+    CPPUNIT_ASSERT( ! reader.isCyclic( 0 ) );
+    CPPUNIT_ASSERT( reader.isCyclic( 2 ) );
+    CPPUNIT_ASSERT_EQUAL( size_t( 26 ), reader.pointCount( 1 ) );
+    CPPUNIT_ASSERT( reader.hasSingleRadius( 1 ) );
+    CPPUNIT_ASSERT( ! reader.hasSingleRadius( 2 ) );
+    CPPUNIT_ASSERT( reader.hasSegmentIndex( 2 ) );
+    CPPUNIT_ASSERT( ! reader.hasSegmentIndex( 3 ) );
+    
+    PolylineSegmentedPath pathView;
+    reader.view( 0, pathView );
+    CPPUNIT_ASSERT( pathView.isView() );
+    CPPUNIT_ASSERT( pathView.segmentIndexEnabled() );
+    checkSameMappings( path, pathView );
+    
+    PolylineSegmentedPathwaySingleRadius singleRadiusView;
+    CPPUNIT_ASSERT( reader.view( 1, singleRadiusView ) );
+    CPPUNIT_ASSERT_EQUAL( 2.5f, singleRadiusView.radius() );
+    checkSameMappings( singleRadius, singleRadiusView );
+    CPPUNIT_ASSERT( ! reader.view( 2, singleRadiusView ) );
+    CPPUNIT_ASSERT_EQUAL( 2.5f, singleRadiusView.radius() );
+    
+    // Views with and without the stored index map like the original with
+    // and without its own.
+    PolylineSegmentedPathwaySegmentRadii segmentRadiiView;
+    reader.view( 2, segmentRadiiView );
+    CPPUNIT_ASSERT( segmentRadiiView.segmentIndexEnabled() );
+    CPPUNIT_ASSERT_EQUAL( segmentRadii.segmentRadius( 3 ), segmentRadiiView.segmentRadius( 3 ) );
+    checkSameMappings( segmentRadii, segmentRadiiView );
+    
+    segmentRadii.setSegmentIndexEnabled( true );
+    checkSameMappings( segmentRadii, segmentRadiiView );
+    
+    reader.view( 3, segmentRadiiView );
+    CPPUNIT_ASSERT( ! segmentRadiiView.segmentIndexEnabled() );
+    checkSameMappings( segmentRadii, segmentRadiiView );
+    
+    // An index built over a view maps like the stored one.
+    segmentRadiiView.setSegmentIndexEnabled( true );
+    checkSameMappings( segmentRadii, segmentRadiiView );
+}
+
+
+
+void 
+OpenSteer::PathDatasetTest::testViewCopies()
+{
+    PathDatasetWriter writer;
+    PolylineSegmentedPath path;
+    PolylineSegmentedPathwaySingleRadius singleRadius;
+    PolylineSegmentedPathwaySegmentRadii segmentRadii;
+    writeDataset( writer, path, singleRadius, segmentRadii );
+    
+    std::vector< char > const bytes = writer.bytes();
+    PathDatasetReader reader;
+    CPPUNIT_ASSERT( reader.openMemory( &bytes[ 0 ], bytes.size() ) );
+    
+    PolylineSegmentedPathwaySegmentRadii view;
+    reader.view( 2, view );
+    
+    PolylineSegmentedPathwaySegmentRadii copy( view );
+    CPPUNIT_ASSERT( copy.isView() );
+    checkSameMappings( segmentRadii, copy );
+    
+    PolylineSegmentedPathwaySegmentRadii swapped;
+    swapped.swap( copy );
+    CPPUNIT_ASSERT( swapped.isView() );
+    CPPUNIT_ASSERT( ! copy.isView() );
+    checkSameMappings( segmentRadii, swapped );
+    
+    // Changing the radius of a single radius view rebuilds its index.
+    PolylineSegmentedPathwaySingleRadius singleRadiusView;
+    CPPUNIT_ASSERT( reader.view( 1, singleRadiusView ) );
+    singleRadius.setSegmentIndexEnabled( true );
+    singleRadius.setRadius( 4.0f );
+    singleRadiusView.setRadius( 4.0f );
+    checkSameMappings( singleRadius, singleRadiusView );
+    
+    // Replacing the pathway makes it own its data, independent of the 
+    // reader.
+    std::vector< Vec3 > const points = windingPoints( 10, 1.0f );
+    std::vector< float > const radii( points.size() - 1, 1.5f );
+    swapped.setPathway( points.size(), &points[ 0 ], &radii[ 0 ], false );
+    CPPUNIT_ASSERT( ! swapped.isView() );
+    reader.close();
+    
+    PolylineSegmentedPathwaySegmentRadii const expected( points.size(), &points[ 0 ], &radii[ 0 ], false );
+    checkSameMappings( expected, swapped );
+}
+
+
+
+void 
+OpenSteer::PathDatasetTest::testMalformed()
+{
+    PathDatasetWriter writer;
+    PolylineSegmentedPath path;
+    PolylineSegmentedPathwaySingleRadius singleRadius;
+    PolylineSegmentedPathwaySegmentRadii segmentRadii;
+    writeDataset( writer, path, singleRadius, segmentRadii );
+    
+    std::vector< char > bytes = writer.bytes();
+    PathDatasetReader reader;
+    CPPUNIT_ASSERT( reader.openMemory( &bytes[ 0 ], bytes.size() ) );
+    reader.close();
+    
+    // A directory entry pointing past the points.
+    CheckpointReader checkpoint;
+    CPPUNIT_ASSERT( checkpoint.openMemory( &bytes[ 0 ], bytes.size() ) );
+    size_t count = 0;
+    PathDatasetEntry const* entries = checkpoint.array< PathDatasetEntry >( checkpointTag( "PDIR" ), count );
+    CPPUNIT_ASSERT_EQUAL( size_t( 4 ), count );
+    size_t const offset = reinterpret_cast< char const* >( entries + 3 ) - &bytes[ 0 ];
+    checkpoint.close();
+    
+    PathDatasetEntry entry;
+    memcpy( &entry, &bytes[ offset ], sizeof( entry ) );
+    entry.firstPoint += 1;
+    memcpy( &bytes[ offset ], &entry, sizeof( entry ) );
+    CPPUNIT_ASSERT( ! reader.openMemory( &bytes[ 0 ], bytes.size() ) );
+    CPPUNIT_ASSERT( ! reader.isOpen() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), reader.pathCount() );
+    
+    // A checkpoint of something else.
+    CheckpointWriter other( "Boids", 0.0f );
+    CPPUNIT_ASSERT( ! reader.openMemory( &other.bytes()[ 0 ], other.bytes().size() ) );
+}
+
+
+
+void 
+OpenSteer::PathDatasetTest::testFile()
+{
+    char const* const fileName = "PathDatasetTest.paths";
+    
+    PathDatasetWriter writer;
+    PolylineSegmentedPath path;
+    PolylineSegmentedPathwaySingleRadius singleRadius;
+    PolylineSegmentedPathwaySegmentRadii segmentRadii;
+    writeDataset( writer, path, singleRadius, segmentRadii );
+    CPPUNIT_ASSERT( writer.writeFile( fileName ) );
+    
+    {
+        PathDatasetReader reader;
+        CPPUNIT_ASSERT( reader.open( fileName ) );
+        CPPUNIT_ASSERT_EQUAL( size_t( 4 ), reader.pathCount() );
+        
+        PolylineSegmentedPathwaySegmentRadii view;
+        reader.view( 2, view );
+        checkSameMappings( segmentRadii, view );
+    }
+    
+    std::remove( fileName );
+}
@@ -0,0 +1,106 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::PathDatasetWriter and 
+ * @c OpenSteer::PathDatasetReader.
+ */
+#ifndef OPENSTEER_PATHDATASETTEST_H
+#define OPENSTEER_PATHDATASETTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class PathDatasetTest : public CppUnit::TestFixture {
+    public:
+        PathDatasetTest();
+        virtual ~PathDatasetTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(PathDatasetTest);
+        CPPUNIT_TEST(testPathways);
+        CPPUNIT_TEST(testViewCopies);
+        CPPUNIT_TEST(testMalformed);
+        CPPUNIT_TEST(testFile);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        PathDatasetTest( PathDatasetTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        PathDatasetTest& operator=( PathDatasetTest const& );
+        
+    private:
+        /**
+         * Tests that views of stored paths and pathways, with and without
+         * segment index, map points and distances exactly like the 
+         * originals.
+         */
+        void testPathways();
+        
+        /**
+         * Tests that copies of a view share its arrays and that replacing
+         * the path makes it own its data again.
+         */
+        void testViewCopies();
+        
+        /**
+         * Tests that datasets whose directory doesn't fit the sections and
+         * checkpoints of other kinds are rejected.
+         */
+        void testMalformed();
+        
+        /**
+         * Tests writing a dataset file and mapping it back.
+         */
+        void testFile();
+        
+    }; // PathDatasetTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_PATHDATASETTEST_H
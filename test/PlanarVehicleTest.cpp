@@ -0,0 +1,182 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::PlanarVehicle.
+ */
+#include "PlanarVehicleTest.h"
+
+
+#include <cmath>
+
+
+// Include OpenSteer::PlanarVehicle
+#include "OpenSteer/PlanarVehicle.h"
+
+// Include OpenSteer::SimpleVehicle
+#include "OpenSteer/SimpleVehicle.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::PlanarVehicleTest );
+
+
+
+OpenSteer::PlanarVehicleTest::PlanarVehicleTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::PlanarVehicleTest::~PlanarVehicleTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::PlanarVehicleTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::PlanarVehicleTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    float const tolerance = 0.0001f;
+    float const elapsedTime = 1.0f / 60.0f;
+    
+    class TestVehicle : public SimpleVehicle {
+    public:
+        void update( float const, float const ) {}
+    };
+    
+    class TestPlanarVehicle : public PlanarVehicle {
+    public:
+        void update( float const, float const ) {}
+    };
+    
+    
+    /**
+     * A force turning one way and then the other, with a vertical part
+     * of @a lift times its horizontal length.
+     */
+    Vec3 testForce( int const step, float const lift ) {
+        float const t = 0.05f * step;
+        return Vec3( std::sin( t ), lift, std::cos( 0.7f * t ) ) * 0.2f;
+    }
+    
+    
+    bool equalVectors( Vec3 const& lhs, Vec3 const& rhs ) {
+        return ( lhs - rhs ).length() <= tolerance;
+    }
+    
+    
+    void configure( SimpleVehicle& vehicle ) {
+        vehicle.setMaxForce( 0.3f );
+        vehicle.setMaxSpeed( 2.0f );
+        vehicle.setSpeed( 0.5f );
+        vehicle.setPosition( Vec3( 3.0f, 0.0f, -1.0f ) );
+    }
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::PlanarVehicleTest::testStaysOnPlane()
+{
+    TestPlanarVehicle vehicle;
+    configure( vehicle );
+    
+    for ( int step = 0; step < 500; ++step ) {
+        vehicle.applySteeringForce( testForce( step, 0.8f ), elapsedTime );
+        
+        CPPUNIT_ASSERT_EQUAL( 0.0f, vehicle.position().y );
+        CPPUNIT_ASSERT_EQUAL( 0.0f, vehicle.forward().y );
+        CPPUNIT_ASSERT( Vec3::up == vehicle.up() );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0f, vehicle.forward().length(), tolerance );
+        CPPUNIT_ASSERT( equalVectors( crossProduct( vehicle.forward(), vehicle.up() ),
+                                      vehicle.side() ) );
+    }
+}
+
+
+
+void 
+OpenSteer::PlanarVehicleTest::testMatchesSimpleVehicleOnPlane()
+{
+    TestVehicle simple;
+    TestPlanarVehicle planar;
+    configure( simple );
+    configure( planar );
+    
+    for ( int step = 0; step < 500; ++step ) {
+        Vec3 const force = testForce( step, 0.0f );
+        simple.applySteeringForce( force, elapsedTime );
+        planar.applySteeringForce( force, elapsedTime );
+        
+        CPPUNIT_ASSERT( equalVectors( simple.position(), planar.position() ) );
+        CPPUNIT_ASSERT( equalVectors( simple.forward(), planar.forward() ) );
+        CPPUNIT_ASSERT( equalVectors( simple.side(), planar.side() ) );
+        CPPUNIT_ASSERT( equalVectors( simple.up(), planar.up() ) );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( simple.speed(), planar.speed(), tolerance );
+    }
+}
+
+
+
+void 
+OpenSteer::PlanarVehicleTest::testHeading()
+{
+    TestPlanarVehicle vehicle;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0f, vehicle.heading(), tolerance );
+    
+    float const quarterTurn = 0.5f * OPENSTEER_M_PI;
+    vehicle.setHeading( quarterTurn );
+    CPPUNIT_ASSERT( equalVectors( Vec3( 1.0f, 0.0f, 0.0f ), vehicle.forward() ) );
+    CPPUNIT_ASSERT( equalVectors( Vec3( 0.0f, 0.0f, 1.0f ), vehicle.side() ) );
+    CPPUNIT_ASSERT( Vec3::up == vehicle.up() );
+    
+    vehicle.regenerateOrthonormalBasisUF( Vec3( -2.0f, 5.0f, -2.0f ) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( -0.75f * OPENSTEER_M_PI, vehicle.heading(), tolerance );
+    CPPUNIT_ASSERT( equalVectors( Vec3( -1.0f, 0.0f, -1.0f ).normalize(), vehicle.forward() ) );
+}
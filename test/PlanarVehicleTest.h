@@ -0,0 +1,92 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::PlanarVehicle.
+ */
+#ifndef OPENSTEER_PLANARVEHICLETEST_H
+#define OPENSTEER_PLANARVEHICLETEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class PlanarVehicleTest : public CppUnit::TestFixture {
+    public:
+        PlanarVehicleTest();
+        virtual ~PlanarVehicleTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(PlanarVehicleTest);
+        CPPUNIT_TEST(testStaysOnPlane);
+        CPPUNIT_TEST(testMatchesSimpleVehicleOnPlane);
+        CPPUNIT_TEST(testHeading);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        PlanarVehicleTest( PlanarVehicleTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        PlanarVehicleTest& operator=( PlanarVehicleTest const& );
+        
+    private:
+        /**
+         * Tests that steering forces off the plane leave the vehicle on
+         * it, with up exactly global Y and an orthonormal basis.
+         */
+        void testStaysOnPlane();
+        
+        /**
+         * Tests that under forces on the plane the vehicle moves like a
+         * @c SimpleVehicle.
+         */
+        void testMatchesSimpleVehicleOnPlane();
+        
+        /**
+         * Tests that the heading angle and forward agree both ways.
+         */
+        void testHeading();
+        
+    }; // class PlanarVehicleTest
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_PLANARVEHICLETEST_H
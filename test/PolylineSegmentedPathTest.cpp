@@ -688,6 +688,115 @@ OpenSteer::PolylineSegmentedPathTest::testDistanceToPathMappings()
 
 
 
+void
+OpenSteer::PolylineSegmentedPathTest::testSegmentStartDistances()
+{
+    size_t const noHint = 100;
+    
+    PolylineSegmentedPath path0( *path_ );
+    CPPUNIT_ASSERT_EQUAL( 0.0f, path0.segmentStartDistance( 0 ) );
+    CPPUNIT_ASSERT_EQUAL( 2.0f, path0.segmentStartDistance( 1 ) );
+    CPPUNIT_ASSERT_EQUAL( 3.0f, path0.segmentStartDistance( 2 ) );
+    
+    // A distance at a segment end belongs to that segment.
+    float const distances[] = { -1.0f, 0.0f, 1.0f, 2.0f, 2.5f, 3.0f, 4.0f, 100.0f };
+    size_t const segments[] = { 0, 0, 0, 0, 1, 1, 2, 2 };
+    for ( size_t i = 0; i < 8; ++i ) {
+        CPPUNIT_ASSERT_EQUAL( segments[ i ], path0.segmentIndexAtDistance( distances[ i ], noHint ) );
+        for ( size_t hint = 0; hint < segmentCount_; ++hint ) {
+            CPPUNIT_ASSERT_EQUAL( segments[ i ], path0.segmentIndexAtDistance( distances[ i ], hint ) );
+        }
+    }
+    
+    // Start distances follow moved points.
+    Vec3 points[] = { Vec3( 1.0f, 0.0f, 0.0f ) };
+    path0.movePoints( 1, 1, points );
+    CPPUNIT_ASSERT_EQUAL( 1.0f, path0.segmentStartDistance( 1 ) );
+    CPPUNIT_ASSERT_EQUAL( 3.0f, path0.segmentStartDistance( 2 ) );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), path0.segmentIndexAtDistance( 2.0f, noHint ) );
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), path0.segmentIndexAtDistance( 0.5f, 2 ) );
+    
+    // Moving the first point of a cyclic path changes the closing segment.
+    PolylineSegmentedPath path1( *cyclicPath_ );
+    Vec3 points1[] = { Vec3( 0.0f, -1.0f, 0.0f ) };
+    path1.movePoints( 0, 1, points1 );
+    float expected = 0.0f;
+    for ( size_t i = 0; i < cyclicSegmentCount_; ++i ) {
+        CPPUNIT_ASSERT_EQUAL( expected, path1.segmentStartDistance( i ) );
+        expected += path1.segmentLength( i );
+    }
+    CPPUNIT_ASSERT_EQUAL( expected, path1.length() );
+    Vec3 const midpoint = ( path1.point( 3 ) + path1.point( 4 ) ) * 0.5f;
+    CPPUNIT_ASSERT( Vec3::distance( midpoint, path1.mapPathDistanceToPoint( expected - 0.5f * path1.segmentLength( 3 ) ) ) < 1.0e-5f );
+}
+
+
+
+
+void
+OpenSteer::PolylineSegmentedPathTest::testSlidingPath()
+{
+    PolylineSegmentedPath path0( *path_ );
+    
+    Vec3 const appended[] = { Vec3( 2.0f, 4.0f, 0.0f ) };
+    path0.appendPoints( 1, appended );
+    CPPUNIT_ASSERT_EQUAL( pointCount_ + 1, path0.pointCount() );
+    CPPUNIT_ASSERT_EQUAL( 2.0f, path0.segmentLength( 3 ) );
+    CPPUNIT_ASSERT_EQUAL( 0.0f, path0.startDistance() );
+    CPPUNIT_ASSERT_EQUAL( pathLength_ + 2.0f, path0.length() );
+    
+    // Distances keep their origin when the start of the path is removed.
+    path0.removeFirstPoints( 1 );
+    CPPUNIT_ASSERT_EQUAL( pointCount_, path0.pointCount() );
+    CPPUNIT_ASSERT_EQUAL( points_[ 1 ], path0.point( 0 ) );
+    CPPUNIT_ASSERT_EQUAL( 2.0f, path0.startDistance() );
+    CPPUNIT_ASSERT_EQUAL( 0.0f, path0.segmentStartDistance( 0 ) );
+    CPPUNIT_ASSERT_EQUAL( 1.0f, path0.segmentStartDistance( 1 ) );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), path0.segmentIndexAtDistance( 1.5f, 100 ) );
+    CPPUNIT_ASSERT_EQUAL( 3.0f, path0.mapPointToPathDistance( Vec3( 3.0f, -1.0f, 0.0f ) ) );
+    CPPUNIT_ASSERT_EQUAL( Vec3( 2.5f, 0.0f, 0.0f ), path0.mapPathDistanceToPoint( 2.5f ) );
+    
+    // Prepended segments lie before the old start.
+    Vec3 const prepended[] = { Vec3( -1.0f, 0.0f, 0.0f ), Vec3( 0.0f, 0.0f, 0.0f ) };
+    path0.prependPoints( 2, prepended );
+    CPPUNIT_ASSERT_EQUAL( pointCount_ + 2, path0.pointCount() );
+    CPPUNIT_ASSERT_EQUAL( prepended[ 0 ], path0.point( 0 ) );
+    CPPUNIT_ASSERT_EQUAL( points_[ 1 ], path0.point( 2 ) );
+    CPPUNIT_ASSERT_EQUAL( -1.0f, path0.startDistance() );
+    CPPUNIT_ASSERT_EQUAL( 3.0f, path0.segmentStartDistance( 2 ) );
+    CPPUNIT_ASSERT_EQUAL( 0.0f, path0.mapPointToPathDistance( Vec3( 0.0f, -1.0f, 0.0f ) ) );
+    CPPUNIT_ASSERT_EQUAL( Vec3( -0.5f, 0.0f, 0.0f ), path0.mapPathDistanceToPoint( -0.5f ) );
+    
+    path0.removeLastPoints( 2 );
+    CPPUNIT_ASSERT_EQUAL( pointCount_, path0.pointCount() );
+    CPPUNIT_ASSERT_EQUAL( points_[ 2 ], path0.point( 3 ) );
+    CPPUNIT_ASSERT_EQUAL( 4.0f, path0.length() );
+    
+    // The slid path maps like a path built from its points, only shifted
+    // by its start distance. Removing most points drops them for good.
+    path0.appendPoints( 1, appended );
+    path0.removeFirstPoints( 2 );
+    Vec3 const remaining[] = { points_[ 1 ], points_[ 2 ], appended[ 0 ] };
+    PolylineSegmentedPath path1( 3, remaining, false );
+    CPPUNIT_ASSERT_EQUAL( 2.0f, path0.startDistance() );
+    CPPUNIT_ASSERT_EQUAL( path1.length(), path0.length() );
+    for ( size_t i = 0; i < path1.segmentCount(); ++i ) {
+        CPPUNIT_ASSERT_EQUAL( path1.segmentStart( i ), path0.segmentStart( i ) );
+        CPPUNIT_ASSERT_EQUAL( path1.segmentStartDistance( i ), path0.segmentStartDistance( i ) );
+    }
+    
+    Vec3 const queries[] = { Vec3( 0.0f, 0.0f, 0.0f ), Vec3( 2.5f, 1.0f, 0.0f ), Vec3( 4.0f, 4.0f, 1.0f ) };
+    for ( size_t i = 0; i < 3; ++i ) {
+        Vec3 tangent0, tangent1;
+        float outside0 = 0.0f, outside1 = 0.0f;
+        CPPUNIT_ASSERT_EQUAL( path1.mapPointToPath( queries[ i ], tangent1, outside1 ), path0.mapPointToPath( queries[ i ], tangent0, outside0 ) );
+        CPPUNIT_ASSERT_EQUAL( tangent1, tangent0 );
+        CPPUNIT_ASSERT_EQUAL( outside1, outside0 );
+        CPPUNIT_ASSERT_EQUAL( path1.mapPointToPathDistance( queries[ i ] ) + 2.0f, path0.mapPointToPathDistance( queries[ i ] ) );
+    }
+}
+
+
 
 void
 OpenSteer::PolylineSegmentedPathTest::testCompareWithOldPathImplementation() 
@@ -66,6 +66,8 @@ namespace OpenSteer {
         CPPUNIT_TEST(testSegmentMappings);
         CPPUNIT_TEST(testPointToPathMappings);
         CPPUNIT_TEST(testDistanceToPathMappings);
+        CPPUNIT_TEST(testSegmentStartDistances);
+        CPPUNIT_TEST(testSlidingPath);
         CPPUNIT_TEST(testCompareWithOldPathImplementation);
         CPPUNIT_TEST_SUITE_END();
         
@@ -89,6 +91,8 @@ namespace OpenSteer {
         void testSegmentMappings();        
         void testPointToPathMappings();
         void testDistanceToPathMappings();
+        void testSegmentStartDistances();
+        void testSlidingPath();
         void testCompareWithOldPathImplementation();
         
         
@@ -0,0 +1,178 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::Profiler.
+ */
+#include "ProfilerTest.h"
+
+
+// Include std::string
+#include <string>
+
+// Include std::ostringstream
+#include <sstream>
+
+// Include std::thread
+#include <thread>
+
+// Include OpenSteer::Profiler
+#include "OpenSteer/Profiler.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::ProfilerTest );
+
+
+
+OpenSteer::ProfilerTest::ProfilerTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::ProfilerTest::~ProfilerTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::ProfilerTest::setUp()
+{
+    TestFixture::setUp();
+    Profiler::clear();
+}
+
+
+
+void 
+OpenSteer::ProfilerTest::tearDown()
+{
+    Profiler::enabled = false;
+    Profiler::clear();
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    
+    /**
+     * Counts the occurrences of @a pattern in @a text.
+     */
+    std::size_t count( std::string const& text, std::string const& pattern )
+    {
+        std::size_t result = 0;
+        for ( std::size_t i = text.find( pattern ); 
+              i != std::string::npos; 
+              i = text.find( pattern, i + 1 ) ) {
+            ++result;
+        }
+        return result;
+    }
+    
+    
+    std::string trace()
+    {
+        std::ostringstream os;
+        OpenSteer::Profiler::writeChromeTrace( os );
+        return os.str();
+    }
+    
+    
+    void recordOnThread()
+    {
+        OpenSteer::Profiler::setThreadName( "other" );
+        OpenSteer::Profiler::Scope scope( "onOtherThread" );
+    }
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::ProfilerTest::testDisabledRecordsNothing()
+{
+    {
+        Profiler::Scope scope( "off" );
+    }
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 0 ), Profiler::spanCount() );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 0 ), count( trace(), "\"off\"" ) );
+}
+
+
+
+void 
+OpenSteer::ProfilerTest::testNestedScopes()
+{
+    Profiler::enabled = true;
+    {
+        Profiler::Scope outer( "outer" );
+        {
+            Profiler::Scope inner( "inner \"quoted\"" );
+        }
+    }
+    Profiler::enabled = false;
+    
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 2 ), Profiler::spanCount() );
+    
+    std::string const json = trace();
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 2 ), count( json, "\"ph\":\"X\"" ) );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 1 ), count( json, "\"name\":\"outer\"" ) );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 1 ), count( json, "inner \\\"quoted\\\"" ) );
+    
+    // spans are written as they close: the inner one first
+    CPPUNIT_ASSERT( json.find( "inner" ) < json.find( "\"outer\"" ) );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 0 ), json.find( "{\"displayTimeUnit\"" ) );
+}
+
+
+
+void 
+OpenSteer::ProfilerTest::testThreadsAndRing()
+{
+    Profiler::enabled = true;
+    std::thread other( recordOnThread );
+    other.join();
+    
+    // this thread's ring was made before, if any test recorded already
+    for ( std::size_t i = 0; i < Profiler::ringCapacity + 10; ++i ) {
+        Profiler::Scope scope( "many" );
+    }
+    Profiler::enabled = false;
+    
+    std::string const json = trace();
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 1 ), count( json, "onOtherThread" ) );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 1 ), count( json, "\"name\":\"other\"" ) );
+    CPPUNIT_ASSERT_EQUAL( Profiler::ringCapacity, count( json, "\"many\"" ) );
+    CPPUNIT_ASSERT_EQUAL( Profiler::ringCapacity + 1, Profiler::spanCount() );
+}
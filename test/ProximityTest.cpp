@@ -0,0 +1,1074 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for the proximity databases in @c OpenSteer/Proximity.h.
+ */
+#include "ProximityTest.h"
+
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::ProximityTest );
+
+
+
+OpenSteer::ProximityTest::ProximityTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::ProximityTest::~ProximityTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::ProximityTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::ProximityTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    typedef AbstractProximityDatabase< Vec3* > Database;
+    typedef AbstractTokenForProximityDatabase< Vec3* > Token;
+    
+    
+    /**
+     * A scattered set of points in a 20 x 20 x 20 box around the origin,
+     * each stored in its own token of a database.
+     */
+    class Population {
+    public:
+        explicit Population( Database& database ) : points_( 500 ), tokens_( points_.size() ) {
+            for ( size_t i = 0; i < points_.size(); ++i ) {
+                points_[ i ] = Vec3( float( ( i * 37 ) % 200 ) * 0.1f - 10.0f,
+                                     float( ( i * 11 ) % 20 ) - 10.0f,
+                                     float( ( i * 53 ) % 199 ) * 0.1f - 10.0f );
+                tokens_[ i ] = database.allocateToken( &points_[ i ] );
+                tokens_[ i ]->updateForNewPosition( points_[ i ] );
+            }
+        }
+        
+        ~Population() {
+            for ( size_t i = 0; i < tokens_.size(); ++i ) {
+                delete tokens_[ i ];
+            }
+        }
+        
+        Token& token() { return *tokens_[ 0 ]; }
+        
+        /**
+         * Moves every point by a position dependent offset times @a scale
+         * (some of them out of the 20 x 20 x 20 box for large scales) and
+         * updates the database in one batch.
+         */
+        void moveAll( Database& database, WorkerPool* pool, float scale ) {
+            for ( size_t i = 0; i < points_.size(); ++i ) {
+                points_[ i ] += Vec3( float( i % 7 ) - 3.0f, 0.5f * float( i % 3 ), -2.0f ) * scale;
+            }
+            database.updateForNewPositions( &tokens_[ 0 ], &points_[ 0 ], points_.size(), pool );
+        }
+        
+        /**
+         * Points within @a radius of @a center sorted by distance.
+         */
+        std::vector< Vec3* > within( Vec3 const& center, float radius ) {
+            std::vector< Vec3* > result;
+            for ( size_t i = 0; i < points_.size(); ++i ) {
+                if ( ( points_[ i ] - center ).lengthSquared() < radius * radius ) {
+                    result.push_back( &points_[ i ] );
+                }
+            }
+            std::stable_sort( result.begin(), result.end(), NearerTo( center ) );
+            return result;
+        }
+        
+        class NearerTo {
+        public:
+            explicit NearerTo( Vec3 const& center ) : center_( center ) {}
+            bool operator()( Vec3 const* lhs, Vec3 const* rhs ) const {
+                return ( *lhs - center_ ).lengthSquared() < ( *rhs - center_ ).lengthSquared();
+            }
+        private:
+            Vec3 center_;
+        };
+        
+    private:
+        std::vector< Vec3 > points_;
+        std::vector< Token* > tokens_;
+    }; // class Population
+    
+    
+    Vec3 const centers[] = { Vec3( 0.0f, 0.0f, 0.0f ), Vec3( 3.0f, -2.0f, 7.5f ), Vec3( -9.0f, 9.0f, -9.0f ) };
+    float const radii[] = { 0.5f, 2.0f, 4.0f, 30.0f };
+    
+    
+    void checkFindNeighbors( Database& database ) {
+        Population population( database );
+        for ( size_t c = 0; c < 3; ++c ) {
+            for ( size_t r = 0; r < 4; ++r ) {
+                std::vector< Vec3* > expected = population.within( centers[ c ], radii[ r ] );
+                std::vector< Vec3* > found;
+                population.token().findNeighbors( centers[ c ], radii[ r ], found );
+                std::sort( expected.begin(), expected.end() );
+                std::sort( found.begin(), found.end() );
+                CPPUNIT_ASSERT( expected == found );
+            }
+        }
+    }
+    
+    
+    void checkFindNeighborRecords( Database& database ) {
+        Population population( database );
+        for ( size_t c = 0; c < 3; ++c ) {
+            for ( size_t r = 0; r < 4; ++r ) {
+                std::vector< Vec3* > expected = population.within( centers[ c ], radii[ r ] );
+                std::sort( expected.begin(), expected.end() );
+                
+                std::vector< NeighborRecord< Vec3* > > records;
+                population.token().findNeighbors( centers[ c ], radii[ r ], records );
+                
+                std::vector< Vec3* > found;
+                for ( size_t i = 0; i < records.size(); ++i ) {
+                    Vec3 const offset = *records[ i ].object - centers[ c ];
+                    CPPUNIT_ASSERT( offset == records[ i ].offset );
+                    CPPUNIT_ASSERT_EQUAL( offset.lengthSquared(), records[ i ].distanceSquared );
+                    found.push_back( records[ i ].object );
+                }
+                std::sort( found.begin(), found.end() );
+                CPPUNIT_ASSERT( expected == found );
+            }
+        }
+    }
+    
+    
+    void checkFindNeighborsCapped( Database& database ) {
+        Population population( database );
+        size_t const caps[] = { 0, 1, 5, 1000 };
+        for ( size_t c = 0; c < 3; ++c ) {
+            for ( size_t r = 0; r < 4; ++r ) {
+                std::vector< Vec3* > expected = population.within( centers[ c ], radii[ r ] );
+                std::sort( expected.begin(), expected.end() );
+                for ( size_t k = 0; k < 4; ++k ) {
+                    std::vector< Vec3* > found( caps[ k ] + 1, 0 );
+                    size_t const count = population.token().findNeighbors( centers[ c ], radii[ r ], &found[ 0 ], caps[ k ] );
+                    CPPUNIT_ASSERT_EQUAL( std::min( caps[ k ], expected.size() ), count );
+                    CPPUNIT_ASSERT( 0 == found[ caps[ k ] ] );
+                    found.resize( count );
+                    std::sort( found.begin(), found.end() );
+                    CPPUNIT_ASSERT( std::adjacent_find( found.begin(), found.end() ) == found.end() );
+                    CPPUNIT_ASSERT( std::includes( expected.begin(), expected.end(), found.begin(), found.end() ) );
+                }
+            }
+        }
+    }
+    
+    
+    void checkFindNearestNeighbors( Database& database ) {
+        Population population( database );
+        size_t const ks[] = { 0, 1, 7, 1000 };
+        for ( size_t c = 0; c < 3; ++c ) {
+            for ( size_t r = 0; r < 4; ++r ) {
+                std::vector< Vec3* > const expected = population.within( centers[ c ], radii[ r ] );
+                for ( size_t k = 0; k < 4; ++k ) {
+                    std::vector< Vec3* > found( ks[ k ] + 1, 0 );
+                    size_t const count = population.token().findNearestNeighbors( centers[ c ], radii[ r ], &found[ 0 ], ks[ k ] );
+                    CPPUNIT_ASSERT_EQUAL( std::min( ks[ k ], expected.size() ), count );
+                    for ( size_t i = 0; i < count; ++i ) {
+                        // Equal distances may come in either order.
+                        CPPUNIT_ASSERT_EQUAL( ( *expected[ i ] - centers[ c ] ).lengthSquared(),
+                                              ( *found[ i ] - centers[ c ] ).lengthSquared() );
+                    }
+                }
+            }
+        }
+    }
+    
+    
+    void checkFindNearestNeighborsExcluding( Population& population ) {
+        size_t const ks[] = { 1, 3, 1000 };
+        for ( size_t c = 0; c < 3; ++c ) {
+            for ( size_t r = 0; r < 4; ++r ) {
+                std::vector< Vec3* > expected = population.within( centers[ c ], radii[ r ] );
+                Vec3* const exclude = expected.empty() ? 0 : expected.front();
+                if ( exclude ) {
+                    expected.erase( expected.begin() );
+                }
+                for ( size_t k = 0; k < 3; ++k ) {
+                    std::vector< Vec3* > found( ks[ k ], 0 );
+                    size_t const count = population.token().findNearestNeighbors( centers[ c ], radii[ r ], &found[ 0 ], ks[ k ], exclude );
+                    CPPUNIT_ASSERT_EQUAL( std::min( ks[ k ], expected.size() ), count );
+                    for ( size_t i = 0; i < count; ++i ) {
+                        CPPUNIT_ASSERT( exclude != found[ i ] );
+                        CPPUNIT_ASSERT_EQUAL( ( *expected[ i ] - centers[ c ] ).lengthSquared(),
+                                              ( *found[ i ] - centers[ c ] ).lengthSquared() );
+                    }
+                }
+                
+                Vec3* const nearest = population.token().findNearestNeighbor( centers[ c ], radii[ r ], exclude );
+                if ( expected.empty() ) {
+                    CPPUNIT_ASSERT( 0 == nearest );
+                } else {
+                    CPPUNIT_ASSERT_EQUAL( ( *expected.front() - centers[ c ] ).lengthSquared(),
+                                          ( *nearest - centers[ c ] ).lengthSquared() );
+                }
+            }
+        }
+    }
+    
+    
+    void checkUpdateForNewPositions( Database& database, WorkerPool* pool ) {
+        Population population( database );
+        // Large moves change most cells, small ones few.
+        float const scales[] = { 1.0f, 0.01f, 0.01f, 1.0f, 0.1f };
+        for ( int step = 0; step < 5; ++step ) {
+            population.moveAll( database, pool, scales[ step ] );
+            for ( size_t c = 0; c < 3; ++c ) {
+                for ( size_t r = 0; r < 4; ++r ) {
+                    std::vector< Vec3* > expected = population.within( centers[ c ], radii[ r ] );
+                    std::vector< Vec3* > found;
+                    population.token().findNeighbors( centers[ c ], radii[ r ], found );
+                    std::sort( expected.begin(), expected.end() );
+                    std::sort( found.begin(), found.end() );
+                    CPPUNIT_ASSERT( expected == found );
+                }
+            }
+        }
+        CPPUNIT_ASSERT_EQUAL( 500, database.getPopulation() );
+    }
+    
+    
+    /**
+     * Queries a snapshot for each center and radius in turn (from as many
+     * threads as run it), counting results unlike the expected ones.
+     */
+    class QuerySnapshot {
+    public:
+        QuerySnapshot( ProximitySnapshot< Vec3* > const& snapshot,
+                       std::vector< std::vector< Vec3* > > const& expected,
+                       std::atomic< int >& mismatches )
+            : snapshot_( snapshot ), expected_( expected ), mismatches_( mismatches ) {}
+        
+        void operator()( size_t begin, size_t end ) {
+            for ( size_t i = begin; i < end; ++i ) {
+                size_t const c = i % 3;
+                size_t const r = ( i / 3 ) % 4;
+                std::vector< Vec3* > found;
+                snapshot_.findNeighbors( centers[ c ], radii[ r ], found );
+                std::sort( found.begin(), found.end() );
+                if ( found != expected_[ c * 4 + r ] ) {
+                    ++mismatches_;
+                }
+            }
+        }
+        
+    private:
+        ProximitySnapshot< Vec3* > const& snapshot_;
+        std::vector< std::vector< Vec3* > > const& expected_;
+        std::atomic< int >& mismatches_;
+    }; // class QuerySnapshot
+    
+    
+    /**
+     * Moves a population, to run on a thread of its own.
+     */
+    class MoveAll {
+    public:
+        MoveAll( Population& population, Database& database ) : population_( population ), database_( database ) {}
+        void operator()() { population_.moveAll( database_, 0, 1.0f ); }
+    private:
+        Population& population_;
+        Database& database_;
+    }; // class MoveAll
+    
+    
+    /**
+     * Objects counted by an occupancy histogram, in and outside of bins.
+     */
+    size_t occupancyPopulation( ProximityStatistics const& statistics ) {
+        size_t population = statistics.outsideBinPopulation;
+        for ( size_t n = 0; n < statistics.occupancy.size(); ++n ) {
+            population += n * statistics.occupancy[ n ];
+        }
+        return population;
+    }
+    
+    
+    void checkStatistics( Database& database, bool hasBins ) {
+        Population population( database );
+        ProximityStatistics statistics;
+        
+        // Nothing is counted by default.
+        std::vector< Vec3* > uncounted;
+        population.token().findNeighbors( centers[ 0 ], radii[ 1 ], uncounted );
+        database.getStatistics( statistics );
+        CPPUNIT_ASSERT_EQUAL( size_t( 0 ), statistics.queries );
+        
+        database.setStatisticsEnabled( true );
+        database.resetStatistics();
+        size_t accepted = 0;
+        for ( size_t c = 0; c < 3; ++c ) {
+            for ( size_t r = 0; r < 4; ++r ) {
+                std::vector< Vec3* > found;
+                population.token().findNeighbors( centers[ c ], radii[ r ], found );
+                accepted += found.size();
+            }
+        }
+        population.moveAll( database, 0, 1.0f );
+        
+        database.getStatistics( statistics, 501 );
+        CPPUNIT_ASSERT_EQUAL( size_t( 12 ), statistics.queries );
+        CPPUNIT_ASSERT_EQUAL( accepted, statistics.candidatesAccepted );
+        CPPUNIT_ASSERT( statistics.candidatesTested >= accepted );
+        CPPUNIT_ASSERT( statistics.binsVisited > 0 );
+        CPPUNIT_ASSERT_EQUAL( size_t( 500 ), statistics.positionUpdates );
+        CPPUNIT_ASSERT( statistics.binMigrations <= statistics.positionUpdates );
+        CPPUNIT_ASSERT_EQUAL( hasBins, statistics.binMigrations > 0 );
+        CPPUNIT_ASSERT_EQUAL( size_t( 500 ), occupancyPopulation( statistics ) );
+        
+        // A reset zeroes the counts, not the occupancy.
+        database.resetStatistics();
+        database.getStatistics( statistics, 8 );
+        CPPUNIT_ASSERT_EQUAL( size_t( 0 ), statistics.queries );
+        CPPUNIT_ASSERT_EQUAL( size_t( 0 ), statistics.candidatesTested );
+        CPPUNIT_ASSERT_EQUAL( size_t( 0 ), statistics.positionUpdates );
+        CPPUNIT_ASSERT_EQUAL( size_t( 8 ), statistics.occupancy.size() );
+        database.setStatisticsEnabled( false );
+    }
+    
+    
+    std::vector< std::vector< Vec3* > > sortedWithin( Population& population ) {
+        std::vector< std::vector< Vec3* > > result;
+        for ( size_t c = 0; c < 3; ++c ) {
+            for ( size_t r = 0; r < 4; ++r ) {
+                result.push_back( population.within( centers[ c ], radii[ r ] ) );
+                std::sort( result.back().begin(), result.back().end() );
+            }
+        }
+        return result;
+    }
+    
+    
+    void checkSnapshot( Database& database, WorkerPool& pool ) {
+        Population population( database );
+        CPPUNIT_ASSERT_EQUAL( 0, database.snapshot().getPopulation() );
+        database.publishSnapshot( 4.0f );
+        CPPUNIT_ASSERT_EQUAL( 500, database.snapshot().getPopulation() );
+        std::vector< std::vector< Vec3* > > const before = sortedWithin( population );
+        
+        // Many concurrent queries of the snapshot while the database takes
+        // the next frame's positions all see the published frame.
+        ProximitySnapshot< Vec3* > const& published = database.snapshot();
+        std::atomic< int > mismatches( 0 );
+        QuerySnapshot query( published, before, mismatches );
+        std::thread writer( MoveAll( population, database ) );
+        pool.parallelFor( 1200, query );
+        writer.join();
+        CPPUNIT_ASSERT_EQUAL( 0, mismatches.load() );
+        
+        // Publishing again shows the new frame, and leaves the previous
+        // snapshot as it was.
+        database.publishSnapshot( 4.0f );
+        std::vector< std::vector< Vec3* > > const after = sortedWithin( population );
+        CPPUNIT_ASSERT( &published != &database.snapshot() );
+        QuerySnapshot queryAfter( database.snapshot(), after, mismatches );
+        queryAfter( 0, 12 );
+        QuerySnapshot queryBefore( published, before, mismatches );
+        queryBefore( 0, 12 );
+        CPPUNIT_ASSERT_EQUAL( 0, mismatches.load() );
+    }
+    
+    
+    /**
+     * Loop body staging, for index i, the insertion (or with @a removing
+     * the removal) of token i unless i % 4 == 3, and otherwise querying
+     * @a database through @a resident, which must find @a expected objects
+     * however many requests other threads have staged meanwhile.
+     */
+    class StageOrQuery {
+    public:
+        StageOrQuery( Database& database, Token& resident,
+                      std::vector< Vec3 >& points, std::vector< Token* >& tokens,
+                      bool removing, size_t expected )
+            : database_( database ), resident_( resident ), points_( points ),
+              tokens_( tokens ), removing_( removing ), expected_( expected ),
+              mismatches_( 0 ) {}
+        
+        void operator()( size_t begin, size_t end ) {
+            std::vector< Vec3* > found;
+            for ( size_t i = begin; i < end; ++i ) {
+                if ( i % 4 == 3 ) {
+                    found.clear();
+                    resident_.findNeighbors( Vec3::zero, 30.0f, found );
+                    if ( found.size() != expected_ ) {
+                        ++mismatches_;
+                    }
+                } else if ( removing_ ) {
+                    database_.stageRemoval( tokens_[ i ] );
+                } else {
+                    database_.stageInsertion( &points_[ i ], points_[ i ], &tokens_[ i ] );
+                }
+            }
+        }
+        
+        int mismatches() const { return mismatches_; }
+        
+    private:
+        Database& database_;
+        Token& resident_;
+        std::vector< Vec3 >& points_;
+        std::vector< Token* >& tokens_;
+        bool const removing_;
+        size_t const expected_;
+        std::atomic< int > mismatches_;
+    }; // class StageOrQuery
+    
+    
+    void checkStagedMutations( Database& database, WorkerPool& pool ) {
+        Vec3 residentPoint( 0.0f, 0.0f, 0.0f );
+        Token* const resident = database.allocateToken( &residentPoint );
+        resident->updateForNewPosition( residentPoint );
+        
+        std::vector< Vec3 > points( 400 );
+        std::vector< Token* > tokens( points.size(), static_cast< Token* >( 0 ) );
+        std::vector< Vec3* > expected( 1, &residentPoint );
+        for ( size_t i = 0; i < points.size(); ++i ) {
+            points[ i ] = Vec3( float( ( i * 37 ) % 200 ) * 0.1f - 10.0f,
+                                float( ( i * 11 ) % 20 ) - 10.0f,
+                                float( ( i * 53 ) % 199 ) * 0.1f - 10.0f );
+            if ( i % 4 != 3 ) {
+                expected.push_back( &points[ i ] );
+            }
+        }
+        
+        // Insertions staged while other threads query change nothing
+        // until applied.
+        StageOrQuery inserting( database, *resident, points, tokens, false, 1 );
+        pool.parallelFor( points.size(), inserting, 16 );
+        CPPUNIT_ASSERT_EQUAL( 0, inserting.mismatches() );
+        CPPUNIT_ASSERT_EQUAL( 1, database.getPopulation() );
+        CPPUNIT_ASSERT( 0 == tokens[ 0 ] );
+        
+        CPPUNIT_ASSERT_EQUAL( expected.size() - 1, database.applyStagedMutations() );
+        CPPUNIT_ASSERT_EQUAL( int( expected.size() ), database.getPopulation() );
+        std::vector< Vec3* > found;
+        resident->findNeighbors( Vec3::zero, 30.0f, found );
+        std::sort( found.begin(), found.end() );
+        std::sort( expected.begin(), expected.end() );
+        CPPUNIT_ASSERT( expected == found );
+        
+        // The tokens made know their objects' positions and move.
+        tokens[ 0 ]->updateForNewPosition( Vec3( 100.0f, 100.0f, 100.0f ) );
+        found.clear();
+        resident->findNeighbors( Vec3::zero, 30.0f, found );
+        CPPUNIT_ASSERT_EQUAL( expected.size() - 1, found.size() );
+        
+        // Likewise for removals.
+        StageOrQuery removing( database, *resident, points, tokens, true, expected.size() - 1 );
+        pool.parallelFor( points.size(), removing, 16 );
+        CPPUNIT_ASSERT_EQUAL( 0, removing.mismatches() );
+        CPPUNIT_ASSERT_EQUAL( int( expected.size() ), database.getPopulation() );
+        
+        CPPUNIT_ASSERT_EQUAL( expected.size() - 1, database.applyStagedMutations() );
+        CPPUNIT_ASSERT_EQUAL( 1, database.getPopulation() );
+        CPPUNIT_ASSERT_EQUAL( size_t( 0 ), database.applyStagedMutations() );
+        
+        delete resident;
+    }
+    
+    
+    /**
+     * Checks that token @a k of @a tokens represents @a points[ k ]:
+     * moving it away takes just that point out of @a database's
+     * neighborhood of the origin.
+     */
+    void checkTokenRepresents( Database& database, std::vector< Vec3 >& points,
+                               std::vector< Token* >& tokens, size_t k ) {
+        Token* const probe = database.allocateToken( 0 );
+        probe->updateForNewPosition( Vec3::zero );
+        std::vector< Vec3* > found;
+        probe->findNeighbors( Vec3::zero, 30.0f, found );
+        CPPUNIT_ASSERT( std::find( found.begin(), found.end(), &points[ k ] ) != found.end() );
+        
+        tokens[ k ]->updateForNewPosition( Vec3( 100.0f, 100.0f, 100.0f ) );
+        std::vector< Vec3* > moved;
+        probe->findNeighbors( Vec3::zero, 30.0f, moved );
+        CPPUNIT_ASSERT_EQUAL( found.size() - 1, moved.size() );
+        CPPUNIT_ASSERT( std::find( moved.begin(), moved.end(), &points[ k ] ) == moved.end() );
+        
+        tokens[ k ]->updateForNewPosition( points[ k ] );
+        delete probe;
+    }
+    
+    
+    void checkMixedStagedMutations( Database& database ) {
+        std::vector< Vec3 > points( 12 );
+        std::vector< Token* > tokens( points.size(), static_cast< Token* >( 0 ) );
+        for ( size_t i = 0; i < points.size(); ++i ) {
+            points[ i ] = Vec3( float( i ) - 6.0f, float( i % 3 ), float( i % 5 ) - 2.0f );
+        }
+        for ( size_t i = 0; i < 6; ++i ) {
+            database.stageInsertion( &points[ i ], points[ i ], &tokens[ i ] );
+        }
+        CPPUNIT_ASSERT_EQUAL( size_t( 6 ), database.applyStagedMutations() );
+        
+        // Removals interleaved with insertions: each new token still
+        // lands where its own stageInsertion said.
+        for ( size_t i = 0; i < 3; ++i ) {
+            database.stageRemoval( tokens[ i ] );
+            tokens[ i ] = 0;
+            database.stageInsertion( &points[ 6 + i ], points[ 6 + i ], &tokens[ 6 + i ] );
+        }
+        CPPUNIT_ASSERT_EQUAL( size_t( 6 ), database.applyStagedMutations() );
+        CPPUNIT_ASSERT_EQUAL( 6, database.getPopulation() );
+        for ( size_t k = 6; k < 9; ++k ) {
+            CPPUNIT_ASSERT( 0 != tokens[ k ] );
+            checkTokenRepresents( database, points, tokens, k );
+        }
+        
+#ifdef NDEBUG
+        // Without the asserts, an insertion with nowhere to store its
+        // token inserts nothing and a NULL removal removes nothing,
+        // neither disturbing the requests around them.
+        database.stageInsertion( &points[ 9 ], points[ 9 ], 0 );
+        database.stageRemoval( 0 );
+        database.stageInsertion( &points[ 10 ], points[ 10 ], &tokens[ 10 ] );
+        database.stageRemoval( tokens[ 3 ] );
+        tokens[ 3 ] = 0;
+        database.stageInsertion( &points[ 11 ], points[ 11 ], &tokens[ 11 ] );
+        CPPUNIT_ASSERT_EQUAL( size_t( 5 ), database.applyStagedMutations() );
+        CPPUNIT_ASSERT_EQUAL( 7, database.getPopulation() );
+        checkTokenRepresents( database, points, tokens, 10 );
+        checkTokenRepresents( database, points, tokens, 11 );
+#endif
+        
+        for ( size_t i = 0; i < tokens.size(); ++i ) {
+            delete tokens[ i ];
+        }
+        CPPUNIT_ASSERT_EQUAL( 0, database.getPopulation() );
+    }
+    
+    
+    void checkTokenRemoval( Database& database ) {
+        std::vector< Vec3 > points( 300 );
+        std::vector< Vec3* > objects( points.size() );
+        for ( size_t i = 0; i < points.size(); ++i ) {
+            points[ i ] = Vec3( float( ( i * 37 ) % 200 ) * 0.1f - 10.0f,
+                                float( ( i * 11 ) % 20 ) - 10.0f,
+                                float( ( i * 53 ) % 199 ) * 0.1f - 10.0f );
+            objects[ i ] = &points[ i ];
+        }
+        std::vector< Token* > tokens( points.size() );
+        database.allocateTokens( &objects[ 0 ], objects.size(), &tokens[ 0 ] );
+        for ( size_t i = 0; i < tokens.size(); ++i ) {
+            tokens[ i ]->updateForNewPosition( points[ i ] );
+        }
+        CPPUNIT_ASSERT_EQUAL( 300, database.getPopulation() );
+        
+        // Delete every third token one by one, then the last hundred in
+        // one batch.
+        std::vector< Vec3* > expected;
+        std::vector< Token* > kept;
+        for ( size_t i = 0; i < 200; ++i ) {
+            if ( i % 3 == 0 ) {
+                delete tokens[ i ];
+            } else {
+                expected.push_back( objects[ i ] );
+                kept.push_back( tokens[ i ] );
+            }
+        }
+        Database::deleteTokens( &tokens[ 200 ], 100 );
+        CPPUNIT_ASSERT_EQUAL( int( expected.size() ), database.getPopulation() );
+        
+        // The remaining tokens still find exactly the remaining objects,
+        // and still move.
+        std::vector< Vec3* > found;
+        kept[ 0 ]->findNeighbors( Vec3::zero, 30.0f, found );
+        std::sort( found.begin(), found.end() );
+        CPPUNIT_ASSERT( expected == found );
+        
+        kept[ 0 ]->updateForNewPosition( Vec3( 100.0f, 100.0f, 100.0f ) );
+        found.clear();
+        kept[ 1 ]->findNeighbors( Vec3::zero, 30.0f, found );
+        CPPUNIT_ASSERT_EQUAL( expected.size() - 1, found.size() );
+        
+        Database::deleteTokens( &kept[ 0 ], kept.size() );
+        CPPUNIT_ASSERT_EQUAL( 0, database.getPopulation() );
+    }
+    
+    
+    /**
+     * A layered database of an LQ, a grid and a spatial hash layer.
+     */
+    class ThreeLayers : public LayeredProximityDatabase< Vec3* > {
+    public:
+        ThreeLayers() : LayeredProximityDatabase< Vec3* >( makeLayers() ) {}
+        
+    private:
+        static std::vector< layerType* > makeLayers() {
+            std::vector< layerType* > layers;
+            layers.push_back( new LQProximityDatabase< Vec3* >( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) ) );
+            layers.push_back( new GridProximityDatabase< Vec3* >( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) ) );
+            layers.push_back( new SpatialHashProximityDatabase< Vec3* >( 4.0f ) );
+            return layers;
+        }
+    };
+    
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::ProximityTest::testFindNeighbors()
+{
+    BruteForceProximityDatabase< Vec3* > bruteForce;
+    checkFindNeighbors( bruteForce );
+    
+    LQProximityDatabase< Vec3* > lq( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    checkFindNeighbors( lq );
+    
+    GridProximityDatabase< Vec3* > grid( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    checkFindNeighbors( grid );
+    
+    SpatialHashProximityDatabase< Vec3* > spatialHash( 4.0f );
+    checkFindNeighbors( spatialHash );
+}
+
+
+
+void 
+OpenSteer::ProximityTest::testFindNeighborRecords()
+{
+    BruteForceProximityDatabase< Vec3* > bruteForce;
+    checkFindNeighborRecords( bruteForce );
+    
+    LQProximityDatabase< Vec3* > lq( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    checkFindNeighborRecords( lq );
+    
+    GridProximityDatabase< Vec3* > grid( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    checkFindNeighborRecords( grid );
+    
+    SpatialHashProximityDatabase< Vec3* > spatialHash( 4.0f );
+    checkFindNeighborRecords( spatialHash );
+}
+
+
+
+void 
+OpenSteer::ProximityTest::testFindNeighborsCapped()
+{
+    BruteForceProximityDatabase< Vec3* > bruteForce;
+    checkFindNeighborsCapped( bruteForce );
+    
+    LQProximityDatabase< Vec3* > lq( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    checkFindNeighborsCapped( lq );
+    
+    GridProximityDatabase< Vec3* > grid( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    checkFindNeighborsCapped( grid );
+    
+    SpatialHashProximityDatabase< Vec3* > spatialHash( 4.0f );
+    checkFindNeighborsCapped( spatialHash );
+}
+
+
+
+void 
+OpenSteer::ProximityTest::testFindNearestNeighbors()
+{
+    BruteForceProximityDatabase< Vec3* > bruteForce;
+    checkFindNearestNeighbors( bruteForce );
+    
+    LQProximityDatabase< Vec3* > lq( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    checkFindNearestNeighbors( lq );
+    
+    GridProximityDatabase< Vec3* > grid( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    checkFindNearestNeighbors( grid );
+    
+    SpatialHashProximityDatabase< Vec3* > spatialHash( 4.0f );
+    checkFindNearestNeighbors( spatialHash );
+}
+
+
+
+void 
+OpenSteer::ProximityTest::testFindNearestNeighborsExcluding()
+{
+    BruteForceProximityDatabase< Vec3* > bruteForce;
+    {
+        Population population( bruteForce );
+        checkFindNearestNeighborsExcluding( population );
+    }
+    
+    GridProximityDatabase< Vec3* > grid( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    {
+        Population population( grid );
+        checkFindNearestNeighborsExcluding( population );
+    }
+    
+    LQProximityDatabase< Vec3* > lq( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    Population population( lq );
+    checkFindNearestNeighborsExcluding( population );
+    
+    // The nearest few of a dense population are found in the shells
+    // around the center's bin, not all the bins of a large sphere.
+    lq.setStatisticsEnabled( true );
+    ProximityStatistics statistics;
+    Vec3* nearest[ 3 ];
+    population.token().findNearestNeighbors( Vec3::zero, 30.0f, nearest, 3 );
+    lq.getStatistics( statistics );
+    CPPUNIT_ASSERT( statistics.binsVisited < 125 );
+    lq.resetStatistics();
+    std::vector< Vec3* > all;
+    population.token().findNeighbors( Vec3::zero, 30.0f, all );
+    lq.getStatistics( statistics );
+    CPPUNIT_ASSERT( statistics.binsVisited >= 125 );
+    lq.setStatisticsEnabled( false );
+    
+    // Mostly outside the super-brick, in its catch-all bin.
+    population.moveAll( lq, 0, 5.0f );
+    checkFindNearestNeighborsExcluding( population );
+}
+
+
+
+void 
+OpenSteer::ProximityTest::testUpdateForNewPositions()
+{
+    WorkerPool pool( 3 );
+    
+    BruteForceProximityDatabase< Vec3* > bruteForce;
+    checkUpdateForNewPositions( bruteForce, 0 );
+    
+    LQProximityDatabase< Vec3* > lq( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    checkUpdateForNewPositions( lq, 0 );
+    
+    LQProximityDatabase< Vec3* > parallelLQ( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    checkUpdateForNewPositions( parallelLQ, &pool );
+    
+    GridProximityDatabase< Vec3* > grid( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    checkUpdateForNewPositions( grid, 0 );
+    
+    SpatialHashProximityDatabase< Vec3* > spatialHash( 4.0f );
+    checkUpdateForNewPositions( spatialHash, 0 );
+}
+
+
+
+void 
+OpenSteer::ProximityTest::testSpatialHashUnbounded()
+{
+    // Two clusters far apart and far from the origin, in both directions.
+    Vec3 const corners[] = { Vec3( 123456.0f, -50.0f, -98764.0f ), Vec3( -250000.0f, 6.0f, 31000.0f ) };
+    std::vector< Vec3 > points;
+    for ( size_t c = 0; c < 2; ++c ) {
+        for ( int i = 0; i < 50; ++i ) {
+            points.push_back( corners[ c ] + Vec3( float( i % 5 ), float( i % 2 ), float( i / 5 ) ) );
+        }
+    }
+    
+    SpatialHashProximityDatabase< Vec3* > spatialHash( 2.0f );
+    std::vector< AbstractTokenForProximityDatabase< Vec3* >* > tokens;
+    for ( size_t i = 0; i < points.size(); ++i ) {
+        tokens.push_back( spatialHash.allocateToken( &points[ i ] ) );
+        tokens.back()->updateForNewPosition( points[ i ] );
+    }
+    
+    // Only cells holding points are kept: 3 x 1 x 5 per cluster.
+    CPPUNIT_ASSERT_EQUAL( 30, spatialHash.getOccupiedCellCount() );
+    
+    for ( size_t c = 0; c < 2; ++c ) {
+        std::vector< Vec3* > found;
+        tokens[ 0 ]->findNeighbors( corners[ c ], 100.0f, found );
+        CPPUNIT_ASSERT_EQUAL( size_t( 50 ), found.size() );
+        for ( size_t i = 0; i < found.size(); ++i ) {
+            CPPUNIT_ASSERT( ( *found[ i ] - corners[ c ] ).lengthSquared() < 100.0f * 100.0f );
+        }
+    }
+    
+    // A sphere covering both clusters walks the occupied cells.
+    std::vector< Vec3* > all;
+    tokens[ 0 ]->findNeighbors( Vec3::zero, 1.0e6f, all );
+    CPPUNIT_ASSERT_EQUAL( points.size(), all.size() );
+    
+    for ( size_t i = 0; i < tokens.size(); ++i ) {
+        delete tokens[ i ];
+    }
+    CPPUNIT_ASSERT_EQUAL( 0, spatialHash.getPopulation() );
+}
+
+
+
+void 
+OpenSteer::ProximityTest::testAdaptiveLQ()
+{
+    // Start far too coarse for queries of radius 2 in the 20 x 20 x 20 box.
+    LQProximityDatabase< Vec3* > lq( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 2.0f, 2.0f, 1.0f ) );
+    lq.setAdaptive( true, 3 );
+    Population population( lq );
+    
+    for ( int frame = 0; frame < 3; ++frame ) {
+        std::vector< Vec3* > found;
+        population.token().findNeighbors( centers[ 1 ], 2.0f, found );
+        lq.maintain();
+    }
+    
+    // Bins become about the query radius (or half that), except along
+    // the axis of a single division.
+    Vec3 const divisions = lq.getDivisions();
+    CPPUNIT_ASSERT( divisions.x >= 10.0f && divisions.x <= 20.0f );
+    CPPUNIT_ASSERT_EQUAL( divisions.x, divisions.y );
+    CPPUNIT_ASSERT_EQUAL( 1.0f, divisions.z );
+    
+    // Nothing is lost or misplaced by resizing.
+    CPPUNIT_ASSERT_EQUAL( 500, lq.getPopulation() );
+    for ( size_t c = 0; c < 3; ++c ) {
+        for ( size_t r = 0; r < 4; ++r ) {
+            std::vector< Vec3* > expected = population.within( centers[ c ], radii[ r ] );
+            std::vector< Vec3* > found;
+            population.token().findNeighbors( centers[ c ], radii[ r ], found );
+            std::sort( expected.begin(), expected.end() );
+            std::sort( found.begin(), found.end() );
+            CPPUNIT_ASSERT( expected == found );
+        }
+    }
+}
+
+
+
+void 
+OpenSteer::ProximityTest::testSnapshot()
+{
+    WorkerPool pool( 4 );
+    
+    BruteForceProximityDatabase< Vec3* > bruteForce;
+    checkSnapshot( bruteForce, pool );
+    
+    LQProximityDatabase< Vec3* > lq( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    checkSnapshot( lq, pool );
+    
+    GridProximityDatabase< Vec3* > grid( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    checkSnapshot( grid, pool );
+    
+    SpatialHashProximityDatabase< Vec3* > spatialHash( 4.0f );
+    checkSnapshot( spatialHash, pool );
+}
+
+
+
+void 
+OpenSteer::ProximityTest::testStatistics()
+{
+    BruteForceProximityDatabase< Vec3* > bruteForce;
+    checkStatistics( bruteForce, false );
+    
+    LQProximityDatabase< Vec3* > lq( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    checkStatistics( lq, true );
+    
+    GridProximityDatabase< Vec3* > grid( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    checkStatistics( grid, true );
+    
+    SpatialHashProximityDatabase< Vec3* > spatialHash( 4.0f );
+    checkStatistics( spatialHash, true );
+    
+    // Objects moved out of the LQ super-brick are in its catch-all bin,
+    // and a query reaching outside tests each of them.
+    LQProximityDatabase< Vec3* > small( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    Population population( small );
+    population.moveAll( small, 0, 5.0f );
+    small.setStatisticsEnabled( true );
+    std::vector< Vec3* > found;
+    population.token().findNeighbors( Vec3::zero, 30.0f, found );
+    
+    ProximityStatistics statistics;
+    small.getStatistics( statistics, 501 );
+    CPPUNIT_ASSERT( statistics.outsideBinPopulation > 0 );
+    CPPUNIT_ASSERT_EQUAL( statistics.outsideBinPopulation, statistics.outsideBinCandidates );
+    CPPUNIT_ASSERT_EQUAL( size_t( 500 ), occupancyPopulation( statistics ) );
+}
+
+
+
+void 
+OpenSteer::ProximityTest::testTokenRemoval()
+{
+    BruteForceProximityDatabase< Vec3* > bruteForce;
+    checkTokenRemoval( bruteForce );
+    
+    LQProximityDatabase< Vec3* > lq( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    checkTokenRemoval( lq );
+    
+    GridProximityDatabase< Vec3* > grid( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    checkTokenRemoval( grid );
+    
+    SpatialHashProximityDatabase< Vec3* > spatialHash( 4.0f );
+    checkTokenRemoval( spatialHash );
+}
+
+
+
+void 
+OpenSteer::ProximityTest::testLayers()
+{
+    // Everything in layer 0.
+    {
+        ThreeLayers layered;
+        checkFindNeighbors( layered );
+        checkFindNeighborRecords( layered );
+        checkFindNeighborsCapped( layered );
+        checkFindNearestNeighbors( layered );
+        checkTokenRemoval( layered );
+    }
+    
+    // Point i in layer i % 3.
+    ThreeLayers layered;
+    CPPUNIT_ASSERT_EQUAL( 3, layered.getLayerCount() );
+    CPPUNIT_ASSERT_EQUAL( 7u, layered.allLayers() );
+    std::vector< Vec3 > points( 300 );
+    std::vector< ThreeLayers::tokenType* > tokens( points.size() );
+    for ( size_t i = 0; i < points.size(); ++i ) {
+        points[ i ] = Vec3( float( ( i * 37 ) % 200 ) * 0.1f - 10.0f,
+                            float( ( i * 11 ) % 20 ) - 10.0f,
+                            float( ( i * 53 ) % 199 ) * 0.1f - 10.0f );
+        tokens[ i ] = layered.allocateToken( &points[ i ], int( i % 3 ) );
+        tokens[ i ]->updateForNewPosition( points[ i ] );
+    }
+    CPPUNIT_ASSERT_EQUAL( 100, layered.layer( 1 ).getPopulation() );
+    CPPUNIT_ASSERT_EQUAL( 300, layered.getPopulation() );
+    
+    Vec3 const center( 3.0f, -2.0f, 7.5f );
+    float const radius = 6.0f;
+    for ( unsigned int mask = 0; mask < 8; ++mask ) {
+        std::vector< Vec3* > expected;
+        for ( size_t i = 0; i < points.size(); ++i ) {
+            if ( ( mask & ThreeLayers::layerBit( int( i % 3 ) ) ) &&
+                 ( ( points[ i ] - center ).lengthSquared() < radius * radius ) ) {
+                expected.push_back( &points[ i ] );
+            }
+        }
+        std::sort( expected.begin(), expected.end() );
+        
+        std::vector< Vec3* > found;
+        tokens[ 0 ]->findNeighborsInLayers( center, radius, mask, found );
+        std::sort( found.begin(), found.end() );
+        CPPUNIT_ASSERT( expected == found );
+        
+        std::vector< NeighborRecord< Vec3* > > records;
+        tokens[ 1 ]->findNeighborsInLayers( center, radius, mask, records );
+        CPPUNIT_ASSERT_EQUAL( expected.size(), records.size() );
+        
+        std::vector< Vec3* > capped( expected.size() + 1 );
+        CPPUNIT_ASSERT_EQUAL( expected.size(), tokens[ 2 ]->findNeighborsInLayers( center, radius, mask, &capped[ 0 ], capped.size() ) );
+    }
+    
+    // A move to another layer keeps the position.
+    tokens[ 0 ]->setLayer( 2 );
+    CPPUNIT_ASSERT_EQUAL( 2, tokens[ 0 ]->getLayer() );
+    CPPUNIT_ASSERT_EQUAL( 99, layered.layer( 0 ).getPopulation() );
+    std::vector< Vec3* > found;
+    tokens[ 1 ]->findNeighborsInLayers( points[ 0 ], 0.01f, ThreeLayers::layerBit( 2 ), found );
+    CPPUNIT_ASSERT( std::find( found.begin(), found.end(), &points[ 0 ] ) != found.end() );
+    
+    for ( size_t i = 0; i < tokens.size(); ++i ) {
+        delete tokens[ i ];
+    }
+    CPPUNIT_ASSERT_EQUAL( 0, layered.getPopulation() );
+    
+    // Other databases keep everything in layer 0.
+    BruteForceProximityDatabase< Vec3* > bruteForce;
+    Population population( bruteForce );
+    std::vector< Vec3* > all;
+    std::vector< Vec3* > layer0;
+    std::vector< Vec3* > layer1;
+    population.token().findNeighbors( center, radius, all );
+    population.token().findNeighborsInLayers( center, radius, 1u, layer0 );
+    population.token().findNeighborsInLayers( center, radius, 2u, layer1 );
+    CPPUNIT_ASSERT( all == layer0 );
+    CPPUNIT_ASSERT( layer1.empty() );
+}
+
+
+
+void 
+OpenSteer::ProximityTest::testStagedMutations()
+{
+    WorkerPool pool( 4 );
+    
+    BruteForceProximityDatabase< Vec3* > bruteForce;
+    checkStagedMutations( bruteForce, pool );
+    
+    LQProximityDatabase< Vec3* > lq( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    checkStagedMutations( lq, pool );
+    
+    GridProximityDatabase< Vec3* > grid( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    checkStagedMutations( grid, pool );
+    
+    SpatialHashProximityDatabase< Vec3* > spatialHash( 4.0f );
+    checkStagedMutations( spatialHash, pool );
+    
+    ThreeLayers layered;
+    checkStagedMutations( layered, pool );
+    
+    BruteForceProximityDatabase< Vec3* > mixedBruteForce;
+    checkMixedStagedMutations( mixedBruteForce );
+    
+    LQProximityDatabase< Vec3* > mixedLQ( Vec3::zero, Vec3( 20.0f, 20.0f, 20.0f ), Vec3( 5.0f, 5.0f, 5.0f ) );
+    checkMixedStagedMutations( mixedLQ );
+    
+    // Requests never applied are dropped with the database.
+    Vec3 point;
+    Token* token = 0;
+    {
+        BruteForceProximityDatabase< Vec3* > dropped;
+        dropped.stageInsertion( &point, point, &token );
+    }
+    CPPUNIT_ASSERT( 0 == token );
+}
@@ -0,0 +1,176 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for the proximity databases in @c OpenSteer/Proximity.h.
+ */
+#ifndef OPENSTEER_PROXIMITYTEST_H
+#define OPENSTEER_PROXIMITYTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::BruteForceProximityDatabase, OpenSteer::LQProximityDatabase,
+// OpenSteer::GridProximityDatabase, OpenSteer::SpatialHashProximityDatabase
+#include "OpenSteer/Proximity.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class ProximityTest : public CppUnit::TestFixture {
+    public:
+        ProximityTest();
+        virtual ~ProximityTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(ProximityTest);
+        CPPUNIT_TEST(testFindNeighbors);
+        CPPUNIT_TEST(testFindNeighborRecords);
+        CPPUNIT_TEST(testFindNeighborsCapped);
+        CPPUNIT_TEST(testFindNearestNeighbors);
+        CPPUNIT_TEST(testFindNearestNeighborsExcluding);
+        CPPUNIT_TEST(testUpdateForNewPositions);
+        CPPUNIT_TEST(testSpatialHashUnbounded);
+        CPPUNIT_TEST(testAdaptiveLQ);
+        CPPUNIT_TEST(testSnapshot);
+        CPPUNIT_TEST(testStatistics);
+        CPPUNIT_TEST(testTokenRemoval);
+        CPPUNIT_TEST(testLayers);
+        CPPUNIT_TEST(testStagedMutations);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ProximityTest( ProximityTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ProximityTest& operator=( ProximityTest const& );
+        
+    private:
+        /**
+         * Tests that the databases find exactly the objects within the
+         * query sphere.
+         */
+        void testFindNeighbors();
+        
+        /**
+         * Tests that the record query finds the same objects as the plain
+         * one, each with its offset and distance squared from the center.
+         */
+        void testFindNeighborRecords();
+        
+        /**
+         * Tests that the fixed capacity query writes no more than its cap
+         * and only objects within the query sphere.
+         */
+        void testFindNeighborsCapped();
+        
+        /**
+         * Tests that the nearest neighbor query returns the k nearest
+         * objects in the sphere, nearest first.
+         */
+        void testFindNearestNeighbors();
+        
+        /**
+         * Tests that the nearest neighbor query leaves out the exclude
+         * object, in and outside of the LQ super-brick, and that the LQ
+         * search stops before visiting every bin in the sphere.
+         */
+        void testFindNearestNeighborsExcluding();
+        
+        /**
+         * Tests that a batch position update leaves the databases in the
+         * same state as updating each token in turn.
+         */
+        void testUpdateForNewPositions();
+        
+        /**
+         * Tests that the spatial hash finds objects arbitrarily far from
+         * the origin and keeps only occupied cells.
+         */
+        void testSpatialHashUnbounded();
+        
+        /**
+         * Tests that an adaptive LQ database resizes its bins to the query
+         * radius it sees, without losing any objects.
+         */
+        void testAdaptiveLQ();
+        
+        /**
+         * Tests that published snapshots answer concurrent queries as of
+         * the frame they were published, while the database is updated.
+         */
+        void testSnapshot();
+        
+        /**
+         * Tests that enabled statistics count queries, tested and accepted
+         * candidates, updates and bin migrations, and that the occupancy
+         * histogram accounts for every object.
+         */
+        void testStatistics();
+        
+        /**
+         * Tests that deleting tokens, one by one and in bulk, leaves the
+         * remaining tokens findable and movable.
+         */
+        void testTokenRemoval();
+        
+        /**
+         * Tests that a layered database behaves as any other with all
+         * objects in one layer, that layer queries find only the objects
+         * of the layers asked for, and that objects keep their positions
+         * when they change layers.
+         */
+        void testLayers();
+        
+        /**
+         * Tests that insertions and removals staged from several threads
+         * while others query are invisible to those queries, and take
+         * effect, tokens and all, when applied.
+         */
+        void testStagedMutations();
+        
+    }; // ProximityTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_PROXIMITYTEST_H
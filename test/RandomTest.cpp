@@ -0,0 +1,217 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::RandomStream.
+ */
+#include "RandomTest.h"
+
+
+// Include OpenSteer::RandomStream, OpenSteer::setRandomSeed
+#include "OpenSteer/Random.h"
+
+// Include OpenSteer::SimpleVehicle
+#include "OpenSteer/SimpleVehicle.h"
+
+// Include OpenSteer::frandom01
+#include "OpenSteer/Utilities.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::RandomTest );
+
+
+
+OpenSteer::RandomTest::RandomTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::RandomTest::~RandomTest()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::RandomTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::RandomTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    
+    /**
+     * @c SimpleVehicle is abstract.
+     */
+    class TestVehicle : public SimpleVehicle {
+    public:
+        virtual void update( float const /* currentTime */, float const /* elapsedTime */ ) {
+            // Nothing to do.
+        }
+    }; // class TestVehicle
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::RandomTest::testReferenceSequence()
+{
+    // Output of the pcg32 reference implementation for seed 42, stream 54.
+    uint32_t const expected[] = { 0xa15c02b7u, 0x7b47f409u, 0xba1d3330u,
+                                  0x83d2f293u, 0xbfa4784bu, 0xcbed606eu };
+    
+    RandomStream random( 42u, 54u );
+    for ( size_t i = 0; i < sizeof( expected ) / sizeof( expected[ 0 ] ); ++i ) {
+        CPPUNIT_ASSERT_EQUAL( expected[ i ], random.next() );
+    }
+}
+
+
+
+void 
+OpenSteer::RandomTest::testStreams()
+{
+    RandomStream first( 7u, 1u );
+    RandomStream same( 7u, 1u );
+    RandomStream other( 7u, 2u );
+    
+    int equalToOther = 0;
+    for ( int i = 0; i < 100; ++i ) {
+        uint32_t const value = first.next();
+        CPPUNIT_ASSERT_EQUAL( value, same.next() );
+        if ( value == other.next() ) {
+            ++equalToOther;
+        }
+    }
+    CPPUNIT_ASSERT( equalToOther < 2 );
+    
+    // Reseeding restarts a stream.
+    first.seed( 7u, 1u );
+    same.seed( 7u, 1u );
+    CPPUNIT_ASSERT( first == same );
+    first.next();
+    CPPUNIT_ASSERT( first != same );
+}
+
+
+
+void 
+OpenSteer::RandomTest::testRange()
+{
+    RandomStream random;
+    float sum = 0.0f;
+    int const count = 10000;
+    for ( int i = 0; i < count; ++i ) {
+        float const unit = random.frandom01();
+        CPPUNIT_ASSERT( unit >= 0.0f && unit < 1.0f );
+        sum += unit;
+        
+        float const bounded = random.frandom2( -3.0f, 5.0f );
+        CPPUNIT_ASSERT( bounded >= -3.0f && bounded < 5.0f );
+    }
+    
+    // The mean of a uniform distribution on [0, 1) is one half.
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.5, sum / count, 0.02 );
+}
+
+
+
+void 
+OpenSteer::RandomTest::testSeeding()
+{
+    uint64_t const oldSeed = randomSeed();
+    
+    setRandomSeed( 1234u );
+    CPPUNIT_ASSERT_EQUAL( uint64_t( 1234u ), randomSeed() );
+    float const first = frandom01();
+    float const second = frandom01();
+    
+    setRandomSeed( 1234u );
+    CPPUNIT_ASSERT_EQUAL( first, frandom01() );
+    CPPUNIT_ASSERT_EQUAL( second, frandom01() );
+    
+    // Two vehicles draw from different streams, each of which only
+    // depends on the seed and the vehicle's serial number.
+    TestVehicle vehicle;
+    TestVehicle neighbor;
+    RandomStream expected( 1234u, vehicle.serialNumber );
+    CPPUNIT_ASSERT( expected == vehicle.randomStream() );
+    CPPUNIT_ASSERT( vehicle.randomStream() != neighbor.randomStream() );
+    
+    setRandomSeed( oldSeed );
+}
+
+
+
+void 
+OpenSteer::RandomTest::testScope()
+{
+    RandomStream& threadStream = defaultRandomStream();
+    RandomStream const threadState = threadStream;
+    
+    RandomStream stream( 99u, 5u );
+    RandomStream expected = stream;
+    uint64_t vehicleCount = 0;
+    {
+        RandomScope scope( stream, 4321u, vehicleCount );
+        CPPUNIT_ASSERT( &defaultRandomStream() == &stream );
+        CPPUNIT_ASSERT_EQUAL( expected.frandom01(), frandom01() );
+        
+        // vehicles are numbered by the scope, whatever their serial numbers
+        TestVehicle first;
+        TestVehicle second;
+        CPPUNIT_ASSERT( RandomStream( 4321u, 0u ) == first.randomStream() );
+        CPPUNIT_ASSERT( RandomStream( 4321u, 1u ) == second.randomStream() );
+        CPPUNIT_ASSERT_EQUAL( uint64_t( 2u ), vehicleCount );
+    }
+    
+    CPPUNIT_ASSERT( &defaultRandomStream() == &threadStream );
+    CPPUNIT_ASSERT( defaultRandomStream() == threadState );
+    TestVehicle outside;
+    CPPUNIT_ASSERT( RandomStream( randomSeed(), outside.serialNumber ) == outside.randomStream() );
+    CPPUNIT_ASSERT_EQUAL( uint64_t( 2u ), vehicleCount );
+}
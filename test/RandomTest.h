@@ -0,0 +1,110 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::RandomStream.
+ */
+#ifndef OPENSTEER_RANDOMTEST_H
+#define OPENSTEER_RANDOMTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class RandomTest : public CppUnit::TestFixture {
+    public:
+        RandomTest();
+        virtual ~RandomTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(RandomTest);
+        CPPUNIT_TEST(testReferenceSequence);
+        CPPUNIT_TEST(testStreams);
+        CPPUNIT_TEST(testRange);
+        CPPUNIT_TEST(testSeeding);
+        CPPUNIT_TEST(testScope);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        RandomTest( RandomTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        RandomTest& operator=( RandomTest const& );
+        
+    private:
+        /**
+         * Tests that a stream produces the PCG32 reference sequence.
+         */
+        void testReferenceSequence();
+        
+        /**
+         * Tests that equal seeds and stream numbers give equal sequences
+         * and different stream numbers give different ones.
+         */
+        void testStreams();
+        
+        /**
+         * Tests that random floats stay inside their bounds.
+         */
+        void testRange();
+        
+        /**
+         * Tests that the global seed makes the default stream and the
+         * streams of new vehicles reproducible.
+         */
+        void testSeeding();
+        
+        /**
+         * Tests that inside a scope the default stream and the streams of
+         * new vehicles are the scope's, and outside it the thread's again.
+         */
+        void testScope();
+        
+    }; // RandomTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_RANDOMTEST_H
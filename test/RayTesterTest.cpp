@@ -0,0 +1,294 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c RayTester, the terrain heightfield ray caster.
+ */
+#include "RayTesterTest.h"
+
+
+#include <cmath>
+#include <vector>
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::RayTesterTest );
+
+
+
+OpenSteer::RayTesterTest::RayTesterTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::RayTesterTest::~RayTesterTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::RayTesterTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::RayTesterTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    
+    int const terrainWidth = 37;
+    int const terrainHeight = 23;
+    
+    
+    /**
+     * Small deterministic generator so the test terrain and rays do not 
+     * depend on the platform's @c rand.
+     */
+    class Random {
+    public:
+        explicit Random( unsigned int seed ) : state_( seed ) {}
+        
+        /**
+         * Returns a value in [ @a low, @a high ].
+         */
+        TRTScalar next( TRTScalar low, TRTScalar high ) {
+            state_ = state_ * 1664525u + 1013904223u;
+            return low + ( high - low ) * ( ( state_ >> 8 ) / TRTScalar( 1 << 24 ) );
+        }
+        
+    private:
+        unsigned int state_;
+    }; // class Random
+    
+    
+    /**
+     * Vertices of a bumpy heightfield over a regular grid, row by row.
+     */
+    std::vector< float > makeTerrain() {
+        Random random( 17 );
+        std::vector< float > verts;
+        for ( int z = 0; z < terrainHeight; ++z ) {
+            for ( int x = 0; x < terrainWidth; ++x ) {
+                verts.push_back( 2.0f * x - 30.0f );
+                verts.push_back( float( 3.0 * std::sin( 0.3 * x ) * std::cos( 0.4 * z ) 
+                                        + random.next( 0, 2 ) ) );
+                verts.push_back( 1.5f * z - 10.0f );
+            }
+        }
+        return verts;
+    }
+    
+    
+    /**
+     * Intersects a ray with one triangle like @c RayTester does (culling
+     * back faces), returns the ray parameter of the hit or -1.
+     */
+    TRTScalar intersectTriangle( TRTScalar const* eye, TRTScalar const* dir, 
+                                 float const* v0, float const* v1, float const* v2 ) {
+        TRTScalar edge1[ 3 ], edge2[ 3 ], tvec[ 3 ], pvec[ 3 ], qvec[ 3 ];
+        for ( int i = 0; i < 3; ++i ) {
+            edge1[ i ] = TRTScalar( v1[ i ] ) - v0[ i ];
+            edge2[ i ] = TRTScalar( v2[ i ] ) - v0[ i ];
+            tvec[ i ] = eye[ i ] - v0[ i ];
+        }
+        pvec[ 0 ] = dir[ 1 ] * edge2[ 2 ] - dir[ 2 ] * edge2[ 1 ];
+        pvec[ 1 ] = dir[ 2 ] * edge2[ 0 ] - dir[ 0 ] * edge2[ 2 ];
+        pvec[ 2 ] = dir[ 0 ] * edge2[ 1 ] - dir[ 1 ] * edge2[ 0 ];
+        TRTScalar const det = edge1[ 0 ] * pvec[ 0 ] + edge1[ 1 ] * pvec[ 1 ] + edge1[ 2 ] * pvec[ 2 ];
+        if ( det < 0.000001 ) {
+            return -1;
+        }
+        TRTScalar const u = tvec[ 0 ] * pvec[ 0 ] + tvec[ 1 ] * pvec[ 1 ] + tvec[ 2 ] * pvec[ 2 ];
+        if ( u < 0 || u > det ) {
+            return -1;
+        }
+        qvec[ 0 ] = tvec[ 1 ] * edge1[ 2 ] - tvec[ 2 ] * edge1[ 1 ];
+        qvec[ 1 ] = tvec[ 2 ] * edge1[ 0 ] - tvec[ 0 ] * edge1[ 2 ];
+        qvec[ 2 ] = tvec[ 0 ] * edge1[ 1 ] - tvec[ 1 ] * edge1[ 0 ];
+        TRTScalar const v = dir[ 0 ] * qvec[ 0 ] + dir[ 1 ] * qvec[ 1 ] + dir[ 2 ] * qvec[ 2 ];
+        if ( v < 0 || u + v > det ) {
+            return -1;
+        }
+        return ( edge2[ 0 ] * qvec[ 0 ] + edge2[ 1 ] * qvec[ 1 ] + edge2[ 2 ] * qvec[ 2 ] ) / det;
+    }
+    
+    
+    /**
+     * Nearest hit in [0, @a maxt] of a ray with all terrain triangles, or -1.
+     */
+    TRTScalar castAgainstAllTriangles( std::vector< float > const& verts, 
+                                       TRTScalar const* eye, TRTScalar const* dir, 
+                                       TRTScalar maxt ) {
+        TRTScalar nearest = -1;
+        for ( int z = 0; z < terrainHeight - 1; ++z ) {
+            for ( int x = 0; x < terrainWidth - 1; ++x ) {
+                float const* v = &verts[ 3 * ( x + z * terrainWidth ) ];
+                float const* right = v + 3;
+                float const* below = v + 3 * terrainWidth;
+                float const* belowRight = below + 3;
+                TRTScalar const t[ 2 ] = { intersectTriangle( eye, dir, v, below, right ),
+                                           intersectTriangle( eye, dir, belowRight, right, below ) };
+                for ( int i = 0; i < 2; ++i ) {
+                    if ( t[ i ] >= 0 && t[ i ] <= maxt && ( nearest < 0 || t[ i ] < nearest ) ) {
+                        nearest = t[ i ];
+                    }
+                }
+            }
+        }
+        return nearest;
+    }
+    
+    
+    /**
+     * Fills @a eyes and @a dirs with @a count rays around and over the test
+     * terrain. Some are vertical and some horizontal.
+     */
+    void makeRays( int count, std::vector< TRTScalar >& eyes, std::vector< TRTScalar >& dirs ) {
+        Random random( 4711 );
+        for ( int i = 0; i < count; ++i ) {
+            eyes.push_back( random.next( -40, 50 ) );
+            eyes.push_back( random.next( -2, 20 ) );
+            eyes.push_back( random.next( -20, 30 ) );
+            
+            TRTScalar dir[ 3 ] = { random.next( -1, 1 ), random.next( -1, 1 ), random.next( -1, 1 ) };
+            if ( 0 == i % 10 ) {
+                dir[ 0 ] = dir[ 2 ] = 0;
+                dir[ 1 ] = -1;
+            } else if ( 0 == i % 7 ) {
+                dir[ 1 ] = 0;
+            }
+            dirs.insert( dirs.end(), dir, dir + 3 );
+        }
+    }
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::RayTesterTest::testAgainstAllTriangles()
+{
+    std::vector< float > const verts = makeTerrain();
+    RayTester tester;
+    tester.SetData( terrainWidth, terrainHeight, &verts[ 0 ] );
+    
+    int const rayCount = 3000;
+    std::vector< TRTScalar > eyes, dirs;
+    makeRays( rayCount, eyes, dirs );
+    
+    int hits = 0;
+    for ( int i = 0; i < rayCount; ++i ) {
+        TRTScalar const* eye = &eyes[ 3 * i ];
+        TRTScalar const* dir = &dirs[ 3 * i ];
+        
+        RayTestInfo result;
+        tester.RayCast( result, eye, dir );
+        TRTScalar const expected = castAgainstAllTriangles( verts, eye, dir, TRT_INFINITY );
+        
+        CPPUNIT_ASSERT_EQUAL( expected >= 0, result.hitOccurred );
+        if ( result.hitOccurred ) {
+            ++hits;
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( expected, result.t, 1e-4 );
+            for ( int c = 0; c < 3; ++c ) {
+                CPPUNIT_ASSERT_DOUBLES_EQUAL( eye[ c ] + expected * dir[ c ], result.pos[ c ], 1e-3 );
+            }
+        }
+    }
+    
+    // Make sure the rays exercise both outcomes.
+    CPPUNIT_ASSERT( hits > rayCount / 10 );
+    CPPUNIT_ASSERT( hits < rayCount - rayCount / 10 );
+}
+
+
+
+void 
+OpenSteer::RayTesterTest::testMaxT()
+{
+    std::vector< float > const verts = makeTerrain();
+    RayTester tester;
+    tester.SetData( terrainWidth, terrainHeight, &verts[ 0 ] );
+    
+    TRTScalar const eye[ 3 ] = { 5, 30, 5 };
+    TRTScalar const down[ 3 ] = { 0, -1, 0 };
+    
+    RayTestInfo result;
+    tester.RayCast( result, eye, down );
+    CPPUNIT_ASSERT( result.hitOccurred );
+    TRTScalar const groundT = result.t;
+    
+    tester.RayCast( result, eye, down, groundT * 0.99 );
+    CPPUNIT_ASSERT( ! result.hitOccurred );
+    
+    tester.RayCast( result, eye, down, groundT * 1.01 );
+    CPPUNIT_ASSERT( result.hitOccurred );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( groundT, result.t, 1e-6 );
+}
+
+
+
+void 
+OpenSteer::RayTesterTest::testBatchMatchesSingleRays()
+{
+    std::vector< float > const verts = makeTerrain();
+    RayTester tester;
+    tester.SetData( terrainWidth, terrainHeight, &verts[ 0 ] );
+    
+    int const rayCount = 500;
+    std::vector< TRTScalar > eyes, dirs;
+    makeRays( rayCount, eyes, dirs );
+    std::vector< TRTScalar > maxts;
+    for ( int i = 0; i < rayCount; ++i ) {
+        maxts.push_back( TRTScalar( i % 40 ) );
+    }
+    
+    std::vector< RayTestInfo > batch( rayCount );
+    tester.TestRays( &batch[ 0 ], &eyes[ 0 ], &dirs[ 0 ], rayCount, &maxts[ 0 ] );
+    
+    for ( int i = 0; i < rayCount; ++i ) {
+        RayTestInfo single;
+        tester.RayCast( single, &eyes[ 3 * i ], &dirs[ 3 * i ], maxts[ i ] );
+        CPPUNIT_ASSERT_EQUAL( single.hitOccurred, batch[ i ].hitOccurred );
+        if ( single.hitOccurred ) {
+            CPPUNIT_ASSERT_EQUAL( single.t, batch[ i ].t );
+        }
+    }
+}
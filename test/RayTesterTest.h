@@ -0,0 +1,101 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c RayTester, the terrain heightfield ray caster.
+ */
+#ifndef OPENSTEER_RAYTESTERTEST_H
+#define OPENSTEER_RAYTESTERTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include RayTester
+#include "../src/TerrainRayTest.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class RayTesterTest : public CppUnit::TestFixture {
+    public:
+        RayTesterTest();
+        virtual ~RayTesterTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(RayTesterTest);
+        CPPUNIT_TEST(testAgainstAllTriangles);
+        CPPUNIT_TEST(testMaxT);
+        CPPUNIT_TEST(testBatchMatchesSingleRays);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        RayTesterTest( RayTesterTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        RayTesterTest& operator=( RayTesterTest const& );
+        
+    private:
+        /**
+         * Tests that the quadtree accelerated @c RayCast finds the same 
+         * nearest hit as testing the ray against every terrain triangle, for
+         * rays from above, inside and outside the terrain, including 
+         * vertical and horizontal ones.
+         */
+        void testAgainstAllTriangles();
+        
+        /**
+         * Tests that hits farther than @c maxt are not reported.
+         */
+        void testMaxT();
+        
+        /**
+         * Tests that @c TestRays returns the results of casting each of its
+         * rays alone.
+         */
+        void testBatchMatchesSingleRays();
+        
+    }; // RayTesterTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_RAYTESTERTEST_H
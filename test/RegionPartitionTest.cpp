@@ -0,0 +1,285 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::RegionPartition and @c OpenSteer::RegionNode.
+ */
+#include "RegionPartitionTest.h"
+
+
+// Include std::sort
+#include <algorithm>
+
+// Include std::thread
+#include <thread>
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::RegionPartition, OpenSteer::RegionNode, ...
+#include "OpenSteer/RegionPartition.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::RegionPartitionTest );
+
+
+
+OpenSteer::RegionPartitionTest::RegionPartitionTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::RegionPartitionTest::~RegionPartitionTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::RegionPartitionTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::RegionPartitionTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    /**
+     * Adds a vehicle at @a x on the X axis, tagged by its @a mass.
+     */
+    GhostVehicle* addVehicle( AVGroup& owned, float x, float mass = 1.0f )
+    {
+        GhostVehicle* vehicle = new GhostVehicle;
+        vehicle->setPosition( Vec3( x, 0.0f, 0.0f ) );
+        vehicle->setMass( mass );
+        owned.push_back( vehicle );
+        return vehicle;
+    }
+    
+    void deleteVehicles( AVGroup& owned )
+    {
+        for ( size_t i = 0; i < owned.size(); ++i ) {
+            delete owned[ i ];
+        }
+        owned.clear();
+    }
+    
+    /**
+     * Drops the emigrated vehicles and adopts the immigrants.
+     */
+    void applyExchange( RegionNode const& node, AVGroup& owned, std::vector< size_t > const& emigrated )
+    {
+        for ( size_t e = emigrated.size(); e > 0; --e ) {
+            size_t const i = emigrated[ e - 1 ];
+            delete owned[ i ];
+            owned.erase( owned.begin() + i );
+        }
+        for ( size_t i = 0; i < node.immigrants().size(); ++i ) {
+            GhostVehicle* vehicle = new GhostVehicle;
+            vehicle->restoreState( node.immigrants()[ i ] );
+            owned.push_back( vehicle );
+        }
+    }
+    
+    /**
+     * Moves a node's vehicles along X, wrapping around the world, and
+     * exchanges them with the other nodes each frame.
+     */
+    class NodeLoop {
+    public:
+        NodeLoop( RegionNode& n, AVGroup& o, int f ) : node( n ), owned( o ), frames( f ) {}
+        
+        void operator()() {
+            std::vector< size_t > emigrated;
+            for ( int frame = 0; frame < frames; ++frame ) {
+                for ( size_t i = 0; i < owned.size(); ++i ) {
+                    Vec3 p = owned[ i ]->position() + Vec3( 7.0f, 0.0f, 0.0f );
+                    if ( p.x >= 300.0f ) {
+                        p.x -= 300.0f;
+                    }
+                    owned[ i ]->setPosition( p );
+                }
+                node.exchange( owned, emigrated );
+                applyExchange( node, owned, emigrated );
+            }
+        }
+        
+    private:
+        RegionNode& node;
+        AVGroup& owned;
+        int frames;
+    };
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::RegionPartitionTest::testRegions()
+{
+    RegionPartition const partition( Vec3( -100.0f, 0.0f, -100.0f ), Vec3( 100.0f, 0.0f, 100.0f ), 2, 2 );
+    CPPUNIT_ASSERT_EQUAL( 4, partition.regionCount() );
+    CPPUNIT_ASSERT_EQUAL( 0, partition.regionOf( Vec3( -50.0f, 0.0f, -50.0f ) ) );
+    CPPUNIT_ASSERT_EQUAL( 1, partition.regionOf( Vec3( 50.0f, 0.0f, -50.0f ) ) );
+    CPPUNIT_ASSERT_EQUAL( 2, partition.regionOf( Vec3( -50.0f, 0.0f, 50.0f ) ) );
+    CPPUNIT_ASSERT_EQUAL( 3, partition.regionOf( Vec3( 50.0f, 0.0f, 50.0f ) ) );
+    CPPUNIT_ASSERT_EQUAL( 3, partition.regionOf( Vec3( 500.0f, 0.0f, 500.0f ) ) );
+    CPPUNIT_ASSERT_EQUAL( 2, partition.regionOf( Vec3( -500.0f, 0.0f, 10.0f ) ) );
+    
+    std::vector< int > near;
+    partition.regionsNear( Vec3( -50.0f, 0.0f, -50.0f ), 5.0f, 0, near );
+    CPPUNIT_ASSERT( near.empty() );
+    partition.regionsNear( Vec3( -1.0f, 0.0f, -50.0f ), 5.0f, 0, near );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), near.size() );
+    CPPUNIT_ASSERT_EQUAL( 1, near[ 0 ] );
+    partition.regionsNear( Vec3( -1.0f, 0.0f, -1.0f ), 5.0f, 0, near );
+    CPPUNIT_ASSERT_EQUAL( size_t( 3 ), near.size() );
+    
+    // beyond the bounds, the outer regions go on
+    partition.regionsNear( Vec3( -200.0f, 0.0f, -2.0f ), 5.0f, 0, near );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), near.size() );
+    CPPUNIT_ASSERT_EQUAL( 2, near[ 0 ] );
+}
+
+
+
+void 
+OpenSteer::RegionPartitionTest::testGhostsAndMigrants()
+{
+    RegionPartition const partition( Vec3( -100.0f, 0.0f, -100.0f ), Vec3( 100.0f, 0.0f, 100.0f ), 2, 1 );
+    LocalRegionTransport transport( 2 );
+    BruteForceProximityDatabase< AbstractVehicle* > pd1;
+    RegionNode node0( partition, 0, transport, 5.0f );
+    RegionNode node1( partition, 1, transport, 5.0f );
+    node1.setProximityDatabase( &pd1 );
+    
+    AVGroup owned0;
+    AVGroup owned1;
+    addVehicle( owned0, -2.0f );
+    addVehicle( owned0, -50.0f );
+    addVehicle( owned0, 3.0f, 7.0f );
+    GhostVehicle* probe = addVehicle( owned1, 1.0f );
+    addVehicle( owned1, 60.0f );
+    
+    std::vector< size_t > emigrated0;
+    std::vector< size_t > emigrated1;
+    node0.send( owned0, emigrated0 );
+    node1.send( owned1, emigrated1 );
+    node0.receive();
+    node1.receive();
+    
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), emigrated0.size() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 2 ), emigrated0[ 0 ] );
+    CPPUNIT_ASSERT( emigrated1.empty() );
+    CPPUNIT_ASSERT( node0.immigrants().empty() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), node1.immigrants().size() );
+    CPPUNIT_ASSERT_EQUAL( 3.0f, node1.immigrants()[ 0 ].position.x );
+    CPPUNIT_ASSERT_EQUAL( 7.0f, node1.immigrants()[ 0 ].mass );
+    
+    // node 0 sees node 1's vehicle near the border and its own emigrant
+    CPPUNIT_ASSERT_EQUAL( size_t( 2 ), node0.ghosts().size() );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), node1.ghosts().size() );
+    CPPUNIT_ASSERT_EQUAL( -2.0f, node1.ghosts()[ 0 ]->position().x );
+    
+    // the ghost is found by node 1's queries
+    RegionNode::ProximityToken* token = pd1.allocateToken( probe );
+    token->updateForNewPosition( probe->position() );
+    AVGroup found;
+    token->findNeighbors( probe->position(), 4.0f, found );
+    CPPUNIT_ASSERT( std::find( found.begin(), found.end(), node1.ghosts()[ 0 ] ) != found.end() );
+    delete token;
+    
+    deleteVehicles( owned0 );
+    deleteVehicles( owned1 );
+}
+
+
+
+void 
+OpenSteer::RegionPartitionTest::testThreadedNodes()
+{
+    int const nodeCount = 3;
+    int const perNode = 10;
+    RegionPartition const partition( Vec3( 0.0f, 0.0f, 0.0f ), Vec3( 300.0f, 0.0f, 10.0f ), nodeCount, 1 );
+    LocalRegionTransport transport( nodeCount );
+    
+    std::vector< RegionNode* > nodes;
+    std::vector< AVGroup > owned( nodeCount );
+    for ( int n = 0; n < nodeCount; ++n ) {
+        nodes.push_back( new RegionNode( partition, n, transport, 9.0f ) );
+        for ( int i = 0; i < perNode; ++i ) {
+            addVehicle( owned[ n ], 100.0f * n + 9.5f * i, float( n * perNode + i ) );
+        }
+    }
+    
+    std::vector< NodeLoop > loops;
+    for ( int n = 0; n < nodeCount; ++n ) {
+        loops.push_back( NodeLoop( *nodes[ n ], owned[ n ], 40 ) );
+    }
+    std::vector< std::thread > threads;
+    for ( int n = 0; n < nodeCount; ++n ) {
+        threads.push_back( std::thread( loops[ n ] ) );
+    }
+    for ( int n = 0; n < nodeCount; ++n ) {
+        threads[ n ].join();
+    }
+    
+    std::vector< float > tags;
+    for ( int n = 0; n < nodeCount; ++n ) {
+        for ( size_t i = 0; i < owned[ n ].size(); ++i ) {
+            CPPUNIT_ASSERT_EQUAL( n, partition.regionOf( owned[ n ][ i ]->position() ) );
+            tags.push_back( owned[ n ][ i ]->mass() );
+        }
+    }
+    std::sort( tags.begin(), tags.end() );
+    CPPUNIT_ASSERT_EQUAL( size_t( nodeCount * perNode ), tags.size() );
+    for ( size_t i = 0; i < tags.size(); ++i ) {
+        CPPUNIT_ASSERT_EQUAL( float( i ), tags[ i ] );
+    }
+    
+    for ( int n = 0; n < nodeCount; ++n ) {
+        deleteVehicles( owned[ n ] );
+        delete nodes[ n ];
+    }
+}
@@ -0,0 +1,99 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::RegionPartition and @c OpenSteer::RegionNode.
+ */
+#ifndef OPENSTEER_REGIONPARTITIONTEST_H
+#define OPENSTEER_REGIONPARTITIONTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class RegionPartitionTest : public CppUnit::TestFixture {
+    public:
+        RegionPartitionTest();
+        virtual ~RegionPartitionTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(RegionPartitionTest);
+        CPPUNIT_TEST(testRegions);
+        CPPUNIT_TEST(testGhostsAndMigrants);
+        CPPUNIT_TEST(testThreadedNodes);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        RegionPartitionTest( RegionPartitionTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        RegionPartitionTest& operator=( RegionPartitionTest const& );
+        
+    private:
+        /**
+         * Tests the region of positions inside and outside the bounds, and
+         * the regions near a position.
+         */
+        void testRegions();
+        
+        /**
+         * Tests that one exchange between two nodes ghosts the vehicles
+         * near the border into the other node's proximity database and
+         * moves the vehicles which crossed it.
+         */
+        void testGhostsAndMigrants();
+        
+        /**
+         * Tests that nodes on their own threads keep every vehicle exactly
+         * once, in its own region, while the vehicles cross the borders.
+         */
+        void testThreadedNodes();
+        
+    }; // RegionPartitionTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_REGIONPARTITIONTEST_H
@@ -0,0 +1,476 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::SegmentedPathIndex.
+ */
+#include "SegmentedPathIndexTest.h"
+
+
+// Include std::abs
+#include <cmath>
+
+#include <vector>
+
+
+// Include OpenSteer::PolylineSegmentedPath
+#include "OpenSteer/PolylineSegmentedPath.h"
+
+// Include OpenSteer::PolylineSegmentedPathwaySingleRadius
+#include "OpenSteer/PolylineSegmentedPathwaySingleRadius.h"
+
+// Include OpenSteer::PolylineSegmentedPathwaySegmentRadii
+#include "OpenSteer/PolylineSegmentedPathwaySegmentRadii.h"
+
+// Include OpenSteer::PathCursor
+#include "OpenSteer/PathCursor.h"
+
+// Include OpenSteer::mapPointsToPathAlike, OpenSteer::mapDistancesToPathAlike
+#include "OpenSteer/QueryPathAlike.h"
+
+// Include OpenSteer::PointToPathMapping, OpenSteer::PointToPathDistanceMapping, OpenSteer::PathDistanceToPointMapping
+#include "OpenSteer/QueryPathAlikeMappings.h"
+
+// Include OpenSteer::WorkerPool
+#include "OpenSteer/WorkerPool.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::SegmentedPathIndexTest );
+
+
+
+
+OpenSteer::SegmentedPathIndexTest::SegmentedPathIndexTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::SegmentedPathIndexTest::~SegmentedPathIndexTest()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndexTest::setUp()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndexTest::tearDown()
+{
+    // Nothing to do.
+}
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    
+    /**
+     * A small deterministic generator, independent of OpenSteer's global
+     * random number state.
+     */
+    class Random {
+    public:
+        Random() : state_( 2468u ) {}
+        float next( float low, float high ) {
+            state_ = state_ * 1664525u + 1013904223u;
+            return low + ( high - low ) * float( state_ >> 8 ) / float( 1u << 24 );
+        }
+    private:
+        unsigned int state_;
+    }; // class Random
+    
+    
+    /**
+     * A winding random walk that crosses itself now and then, so many
+     * segments are near each other.
+     */
+    std::vector< Vec3 > randomWalk( Random& random, size_t count ) {
+        std::vector< Vec3 > points;
+        Vec3 position( 0.0f, 0.0f, 0.0f );
+        Vec3 heading( 1.0f, 0.0f, 0.0f );
+        for ( size_t i = 0; i < count; ++i ) {
+            points.push_back( position );
+            heading = ( heading + Vec3( random.next( -0.6f, 0.6f ), random.next( -0.1f, 0.1f ), random.next( -0.6f, 0.6f ) ) ).normalize();
+            position += heading * random.next( 0.5f, 3.0f );
+        }
+        return points;
+    }
+    
+    
+    std::vector< Vec3 > queryPoints( Random& random, std::vector< Vec3 > const& points, size_t count ) {
+        std::vector< Vec3 > queries;
+        for ( size_t i = 0; i < count; ++i ) {
+            Vec3 const& near = points[ size_t( random.next( 0.0f, float( points.size() - 1 ) ) ) ];
+            float const spread = ( i % 10 == 0 ) ? 200.0f : 8.0f;
+            queries.push_back( near + Vec3( random.next( -spread, spread ), random.next( -spread, spread ), random.next( -spread, spread ) ) );
+        }
+        // Points exactly on path points, where adjacent segments tie.
+        for ( size_t i = 0; i < points.size(); i += 97 ) {
+            queries.push_back( points[ i ] );
+        }
+        return queries;
+    }
+    
+    
+    /**
+     * Checks that @a indexed, which uses a segment index, maps every query
+     * point exactly like a copy of it without the index. Distances along
+     * the path may differ by @a distanceTolerance.
+     */
+    template< class PathAlike >
+    void checkMappings( PathAlike const& indexed, std::vector< Vec3 > const& queries, float distanceTolerance = 0.0f ) {
+        CPPUNIT_ASSERT( indexed.segmentIndexEnabled() );
+        PathAlike plain( indexed );
+        plain.setSegmentIndexEnabled( false );
+        
+        for ( size_t i = 0; i < queries.size(); ++i ) {
+            Vec3 expectedTangent, tangent;
+            float expectedOutside = 0.0f, outside = 0.0f;
+            Vec3 const expected = plain.mapPointToPath( queries[ i ], expectedTangent, expectedOutside );
+            Vec3 const mapped = indexed.mapPointToPath( queries[ i ], tangent, outside );
+            CPPUNIT_ASSERT( expected == mapped );
+            CPPUNIT_ASSERT( expectedTangent == tangent );
+            CPPUNIT_ASSERT_EQUAL( expectedOutside, outside );
+            CPPUNIT_ASSERT( std::abs( plain.mapPointToPathDistance( queries[ i ] ) - indexed.mapPointToPathDistance( queries[ i ] ) ) <= distanceTolerance );
+        }
+    }
+    
+    
+    /**
+     * Checks that the batched mappings of @a queries and @a distances to
+     * @a pathAlike equal the mappings made point by point.
+     */
+    template< class PathAlike >
+    void checkBatchMappings( PathAlike const& pathAlike, std::vector< Vec3 > const& queries, std::vector< float > const& distances, WorkerPool& pool ) {
+        size_t const count = queries.size();
+        std::vector< PointToPathMapping > points( count );
+        std::vector< PointToPathDistanceMapping > pathDistances( count );
+        std::vector< PointToPathMapping > parallelPoints( count );
+        mapPointsToPathAlike( pathAlike, &queries[ 0 ], count, &points[ 0 ] );
+        mapPointsToPathAlike( pathAlike, &queries[ 0 ], count, &pathDistances[ 0 ] );
+        mapPointsToPathAlike( pathAlike, &queries[ 0 ], count, &parallelPoints[ 0 ], pool );
+        
+        for ( size_t i = 0; i < count; ++i ) {
+            PointToPathMapping expected;
+            PointToPathDistanceMapping expectedDistance;
+            mapPointToPathAlike( pathAlike, queries[ i ], expected );
+            mapPointToPathAlike( pathAlike, queries[ i ], expectedDistance );
+            CPPUNIT_ASSERT( expected.pointOnPathCenterLine == points[ i ].pointOnPathCenterLine );
+            CPPUNIT_ASSERT( expected.tangent == points[ i ].tangent );
+            CPPUNIT_ASSERT_EQUAL( expected.distancePointToPath, points[ i ].distancePointToPath );
+            CPPUNIT_ASSERT_EQUAL( expectedDistance.distanceOnPath, pathDistances[ i ].distanceOnPath );
+            CPPUNIT_ASSERT( expected.pointOnPathCenterLine == parallelPoints[ i ].pointOnPathCenterLine );
+            CPPUNIT_ASSERT_EQUAL( expected.distancePointToPath, parallelPoints[ i ].distancePointToPath );
+        }
+        
+        std::vector< PathDistanceToPointMapping > onPath( distances.size() );
+        std::vector< PathDistanceToPointMapping > parallelOnPath( distances.size() );
+        mapDistancesToPathAlike( pathAlike, &distances[ 0 ], distances.size(), &onPath[ 0 ] );
+        mapDistancesToPathAlike( pathAlike, &distances[ 0 ], distances.size(), &parallelOnPath[ 0 ], pool );
+        for ( size_t i = 0; i < distances.size(); ++i ) {
+            Vec3 const expected = pathAlike.mapPathDistanceToPoint( distances[ i ] );
+            CPPUNIT_ASSERT( expected == onPath[ i ].pointOnPathCenterLine );
+            CPPUNIT_ASSERT( expected == parallelOnPath[ i ].pointOnPathCenterLine );
+        }
+    }
+    
+    
+    std::vector< float > randomRadii( Random& random, size_t count ) {
+        std::vector< float > radii;
+        for ( size_t i = 0; i < count; ++i ) {
+            radii.push_back( random.next( 0.0f, 4.0f ) );
+        }
+        return radii;
+    }
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::SegmentedPathIndexTest::testPath()
+{
+    Random random;
+    std::vector< Vec3 > const points = randomWalk( random, 3000 );
+    std::vector< Vec3 > const queries = queryPoints( random, points, 2000 );
+    
+    PolylineSegmentedPath open( points.size(), &points[ 0 ], false );
+    open.setSegmentIndexEnabled( true );
+    checkMappings( open, queries );
+    
+    PolylineSegmentedPath cyclic;
+    cyclic.setSegmentIndexEnabled( true );
+    cyclic.setPath( points.size(), &points[ 0 ], true );
+    checkMappings( cyclic, queries );
+    
+    // A path of a single segment.
+    PolylineSegmentedPath shortest( 2, &points[ 0 ], false );
+    shortest.setSegmentIndexEnabled( true );
+    checkMappings( shortest, queries );
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndexTest::testPathwaySingleRadius()
+{
+    Random random;
+    std::vector< Vec3 > const points = randomWalk( random, 3000 );
+    std::vector< Vec3 > const queries = queryPoints( random, points, 2000 );
+    
+    PolylineSegmentedPathwaySingleRadius pathway( points.size(), &points[ 0 ], 2.0f, false );
+    pathway.setSegmentIndexEnabled( true );
+    checkMappings( pathway, queries );
+    
+    pathway.setRadius( 9.0f );
+    checkMappings( pathway, queries );
+    
+    pathway.setPathway( points.size() / 2, &points[ 0 ], 0.5f, true );
+    checkMappings( pathway, queries );
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndexTest::testPathwaySegmentRadii()
+{
+    Random random;
+    std::vector< Vec3 > const points = randomWalk( random, 3000 );
+    std::vector< Vec3 > const queries = queryPoints( random, points, 2000 );
+    std::vector< float > const radii = randomRadii( random, points.size() );
+    
+    PolylineSegmentedPathwaySegmentRadii pathway( points.size(), &points[ 0 ], &radii[ 0 ], false );
+    pathway.setSegmentIndexEnabled( true );
+    checkMappings( pathway, queries );
+    
+    // Few radii change, then most.
+    pathway.setSegmentRadius( 17, 30.0f );
+    std::vector< float > const moreRadii = randomRadii( random, 2500 );
+    pathway.setSegmentRadii( 100, 20, &moreRadii[ 0 ] );
+    checkMappings( pathway, queries );
+    pathway.setSegmentRadii( 0, moreRadii.size(), &moreRadii[ 0 ] );
+    checkMappings( pathway, queries );
+    
+    pathway.setPathway( points.size(), &points[ 0 ], &radii[ 0 ], true );
+    checkMappings( pathway, queries );
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndexTest::testMovePoints()
+{
+    Random random;
+    std::vector< Vec3 > const points = randomWalk( random, 3000 );
+    std::vector< Vec3 > const queries = queryPoints( random, points, 1000 );
+    std::vector< Vec3 > const moved = randomWalk( random, 2000 );
+    std::vector< float > const radii = randomRadii( random, points.size() );
+    
+    PolylineSegmentedPath path( points.size(), &points[ 0 ], true );
+    PolylineSegmentedPathwaySingleRadius single( points.size(), &points[ 0 ], 1.5f, true );
+    PolylineSegmentedPathwaySegmentRadii segmentRadii( points.size(), &points[ 0 ], &radii[ 0 ], true );
+    path.setSegmentIndexEnabled( true );
+    single.setSegmentIndexEnabled( true );
+    segmentRadii.setSegmentIndexEnabled( true );
+    
+    // Moving a few points far away and back into the middle of the path,
+    // the first point of the cycle, and most of the path at once.
+    size_t const starts[] = { 1500, 0, 10 };
+    size_t const counts[] = { 30, 5, 1990 };
+    Vec3 const offset( 40.0f, 3.0f, -25.0f );
+    for ( size_t m = 0; m < 3; ++m ) {
+        std::vector< Vec3 > newPoints;
+        for ( size_t i = 0; i < counts[ m ]; ++i ) {
+            newPoints.push_back( moved[ i ] + offset );
+        }
+        path.movePoints( starts[ m ], counts[ m ], &newPoints[ 0 ] );
+        single.movePoints( starts[ m ], counts[ m ], &newPoints[ 0 ] );
+        segmentRadii.movePoints( starts[ m ], counts[ m ], &newPoints[ 0 ] );
+        checkMappings( path, queries );
+        checkMappings( single, queries );
+        checkMappings( segmentRadii, queries );
+    }
+    
+    // Replacing the path keeps the index enabled.
+    path.setPath( moved.size(), &moved[ 0 ], false );
+    CPPUNIT_ASSERT( path.segmentIndexEnabled() );
+    checkMappings( path, queries );
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndexTest::testSlidingPath()
+{
+    Random random;
+    std::vector< Vec3 > const points = randomWalk( random, 6000 );
+    std::vector< Vec3 > const queries = queryPoints( random, points, 300 );
+    
+    // A window of points moving forward along the walk, now and then 
+    // stepping back.
+    size_t first = 2000;
+    size_t last = 2500;
+    PolylineSegmentedPath path( last - first, &points[ first ], false );
+    PolylineSegmentedPathwaySingleRadius single( last - first, &points[ first ], 1.5f, false );
+    path.setSegmentIndexEnabled( true );
+    single.setSegmentIndexEnabled( true );
+    
+    size_t const steps[] = { 1, 7, 40, 3, 300, 12, 1, 150 };
+    for ( size_t s = 0; s < 24; ++s ) {
+        size_t const step = steps[ s % 8 ];
+        if ( s % 6 == 5 ) {
+            path.prependPoints( step, &points[ first - step ] );
+            single.prependPoints( step, &points[ first - step ] );
+            path.removeLastPoints( step );
+            single.removeLastPoints( step );
+            first -= step;
+            last -= step;
+        } else {
+            path.appendPoints( step, &points[ last ] );
+            single.appendPoints( step, &points[ last ] );
+            path.removeFirstPoints( step );
+            single.removeFirstPoints( step );
+            first += step;
+            last += step;
+        }
+        
+        // The start distances are no longer summed from the path start.
+        checkMappings( path, queries, 1.0e-2f );
+        checkMappings( single, queries, 1.0e-2f );
+    }
+    
+    PolylineSegmentedPath rebuilt( last - first, &points[ first ], false );
+    CPPUNIT_ASSERT_EQUAL( rebuilt.segmentCount(), path.segmentCount() );
+    float const startDistance = path.startDistance();
+    CPPUNIT_ASSERT_EQUAL( startDistance, single.startDistance() );
+    float expectedStartDistance = 0.0f;
+    for ( size_t i = 2000; i < first; ++i ) {
+        expectedStartDistance += Vec3::distance( points[ i ], points[ i + 1 ] );
+    }
+    CPPUNIT_ASSERT( std::abs( expectedStartDistance - startDistance ) < 1.0e-2f );
+    for ( size_t i = 0; i < queries.size(); ++i ) {
+        Vec3 expectedTangent, tangent;
+        float expectedOutside = 0.0f, outside = 0.0f;
+        Vec3 const expected = rebuilt.mapPointToPath( queries[ i ], expectedTangent, expectedOutside );
+        CPPUNIT_ASSERT( expected == path.mapPointToPath( queries[ i ], tangent, outside ) );
+        CPPUNIT_ASSERT( expectedTangent == tangent );
+        CPPUNIT_ASSERT_EQUAL( expectedOutside, outside );
+        float const distance = path.mapPointToPathDistance( queries[ i ] ) - startDistance;
+        CPPUNIT_ASSERT( std::abs( rebuilt.mapPointToPathDistance( queries[ i ] ) - distance ) < 1.0e-2f );
+    }
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndexTest::testCursor()
+{
+    Random random;
+    std::vector< Vec3 > const points = randomWalk( random, 3000 );
+    PolylineSegmentedPathwaySingleRadius pathway( points.size(), &points[ 0 ], 2.0f, true );
+    pathway.setSegmentIndexEnabled( true );
+    PolylineSegmentedPathwaySingleRadius plain( pathway );
+    plain.setSegmentIndexEnabled( false );
+    
+    // A walker moving along the path, sometimes jumping far ahead or using
+    // a cursor left over from another path.
+    PathCursor cursor;
+    float const length = pathway.length();
+    for ( size_t step = 0; step < 3000; ++step ) {
+        if ( step % 500 == 250 ) {
+            cursor.setSegmentIndex( 1000000 );
+        } else if ( step % 500 == 499 ) {
+            cursor.setSegmentIndex( ( step * 7 ) % pathway.segmentCount() );
+        }
+        
+        float const distance = float( step ) * 0.9f + ( ( step % 100 == 0 ) ? 0.5f * length : 0.0f ) - 40.0f;
+        Vec3 const onPath = pathway.mapPathDistanceToPoint( distance, cursor );
+        Vec3 const expectedOnPath = plain.mapPathDistanceToPoint( distance );
+        CPPUNIT_ASSERT( onPath == expectedOnPath );
+        
+        Vec3 const query = onPath + Vec3( random.next( -4.0f, 4.0f ), random.next( -1.0f, 1.0f ), random.next( -4.0f, 4.0f ) );
+        Vec3 expectedTangent, tangent;
+        float expectedOutside = 0.0f, outside = 0.0f;
+        Vec3 const expected = plain.mapPointToPath( query, expectedTangent, expectedOutside );
+        CPPUNIT_ASSERT( expected == pathway.mapPointToPath( query, tangent, outside, cursor ) );
+        CPPUNIT_ASSERT( expectedTangent == tangent );
+        CPPUNIT_ASSERT_EQUAL( expectedOutside, outside );
+        CPPUNIT_ASSERT_EQUAL( plain.mapPointToPathDistance( query ), pathway.mapPointToPathDistance( query, cursor ) );
+        CPPUNIT_ASSERT( cursor.valid() );
+    }
+    
+    // Paths without an index ignore the cursor.
+    PathCursor unused;
+    Vec3 tangent;
+    float outside = 0.0f;
+    plain.mapPointToPath( points[ 10 ], tangent, outside, unused );
+    CPPUNIT_ASSERT( ! unused.valid() );
+}
+
+
+
+void 
+OpenSteer::SegmentedPathIndexTest::testBatchMappings()
+{
+    Random random;
+    std::vector< Vec3 > const points = randomWalk( random, 300 );
+    std::vector< Vec3 > const queries = queryPoints( random, points, 3000 );
+    std::vector< float > const radii = randomRadii( random, points.size() );
+    
+    PolylineSegmentedPath path( points.size(), &points[ 0 ], false );
+    PolylineSegmentedPathwaySingleRadius single( points.size(), &points[ 0 ], 1.5f, true );
+    PolylineSegmentedPathwaySegmentRadii segmentRadii( points.size(), &points[ 0 ], &radii[ 0 ], false );
+    
+    // Ascending distances with a few jumps back and out of range.
+    std::vector< float > distances;
+    for ( size_t i = 0; i < 2000; ++i ) {
+        distances.push_back( float( i ) * 0.4f - ( ( i % 300 == 0 ) ? 250.0f : 0.0f ) );
+    }
+    
+    WorkerPool pool( 4 );
+    checkBatchMappings( path, queries, distances, pool );
+    checkBatchMappings( single, queries, distances, pool );
+    checkBatchMappings( segmentRadii, queries, distances, pool );
+    
+    // Fewer points than a block and no points at all.
+    std::vector< Vec3 > const few( queries.begin(), queries.begin() + 5 );
+    checkBatchMappings( single, few, distances, pool );
+    PointToPathMapping unused;
+    mapPointsToPathAlike( single, &queries[ 0 ], 0, &unused );
+}
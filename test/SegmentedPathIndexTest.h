@@ -0,0 +1,124 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::SegmentedPathIndex.
+ */
+#ifndef OPENSTEER_SEGMENTEDPATHINDEXTEST_H
+#define OPENSTEER_SEGMENTEDPATHINDEXTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class SegmentedPathIndexTest : public CppUnit::TestFixture {
+    public:
+        SegmentedPathIndexTest();
+        virtual ~SegmentedPathIndexTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(SegmentedPathIndexTest);
+        CPPUNIT_TEST(testPath);
+        CPPUNIT_TEST(testPathwaySingleRadius);
+        CPPUNIT_TEST(testPathwaySegmentRadii);
+        CPPUNIT_TEST(testMovePoints);
+        CPPUNIT_TEST(testSlidingPath);
+        CPPUNIT_TEST(testCursor);
+        CPPUNIT_TEST(testBatchMappings);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        SegmentedPathIndexTest( SegmentedPathIndexTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        SegmentedPathIndexTest& operator=( SegmentedPathIndexTest const& );
+        
+    private:
+        /**
+         * Tests that open and cyclic paths map points identically with and
+         * without the segment index.
+         */
+        void testPath();
+        
+        /**
+         * Tests a pathway with a single radius, also after the radius
+         * changed.
+         */
+        void testPathwaySingleRadius();
+        
+        /**
+         * Tests a pathway with segment radii, also after radii changed.
+         */
+        void testPathwaySegmentRadii();
+        
+        /**
+         * Tests that mappings stay identical after points are moved or the
+         * path is replaced.
+         */
+        void testMovePoints();
+        
+        /**
+         * Tests that mappings stay identical while points are appended, 
+         * prepended and removed at the path ends, and equal those of a 
+         * path built from the remaining points.
+         */
+        void testSlidingPath();
+        
+        /**
+         * Tests that queries given a cursor find the same points as queries
+         * without one, whatever segment the cursor holds.
+         */
+        void testCursor();
+        
+        /**
+         * Tests that batched point and distance mappings, serial and split
+         * across threads, equal the mappings made one by one.
+         */
+        void testBatchMappings();
+        
+    }; // SegmentedPathIndexTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_SEGMENTEDPATHINDEXTEST_H
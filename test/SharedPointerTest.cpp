@@ -31,6 +31,12 @@
  */
 #include "SharedPointerTest.h"
 
+// Include std::thread
+#include <thread>
+
+// Include std::vector
+#include <vector>
+
 
 
 
@@ -96,190 +102,235 @@ namespace {
 
 
 
-void 
-OpenSteer::SharedPointerTest::testConstruction()
-{
-    // Testing automatic destruction of a raw pointer hold by a single 
-    // shared pointer.
-    CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
-    
-    SharedPointerTester< 0 >* rawPointer = new SharedPointerTester< 0 >();
+namespace {
     
-    CPPUNIT_ASSERT_EQUAL( 1, SharedPointerTester< 0 >::static_counter_ );
+    using namespace OpenSteer;
     
+    template< typename CountPolicy >
+    void checkConstruction()
     {
-        SharedPointer< SharedPointerTester< 0 > > sp( rawPointer );
-    }
+        // Testing automatic destruction of a raw pointer hold by a single 
+        // shared pointer.
+        CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
     
-    CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
+        SharedPointerTester< 0 >* rawPointer = new SharedPointerTester< 0 >();
     
+        CPPUNIT_ASSERT_EQUAL( 1, SharedPointerTester< 0 >::static_counter_ );
     
-    // Testing copy constructor.
-    rawPointer = new SharedPointerTester< 0 >();
+        {
+            SharedPointer< SharedPointerTester< 0 >, CountPolicy > sp( rawPointer );
+        }
+    
+        CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
+    
+    
+        // Testing copy constructor.
+        rawPointer = new SharedPointerTester< 0 >();
     
-    {
-        SharedPointer< SharedPointerTester< 0 > > sp0( rawPointer );
-        CPPUNIT_ASSERT_EQUAL( 1, SharedPointerTester< 0 >::static_counter_ );
-        CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( 1 ), sp0.useCount() );
         {
-                SharedPointer< SharedPointerTester< 0 > > sp1( sp0 );
-                CPPUNIT_ASSERT_EQUAL( 1, SharedPointerTester< 0 >::static_counter_ );
-                CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( 2 ), sp0.useCount() );
-                CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( 2 ), sp1.useCount() );
-                CPPUNIT_ASSERT_EQUAL( rawPointer, sp0.get() );
-                CPPUNIT_ASSERT_EQUAL( rawPointer, sp1.get() );
+            SharedPointer< SharedPointerTester< 0 >, CountPolicy > sp0( rawPointer );
+            CPPUNIT_ASSERT_EQUAL( 1, SharedPointerTester< 0 >::static_counter_ );
+            CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( 1 ), sp0.useCount() );
+            {
+                    SharedPointer< SharedPointerTester< 0 >, CountPolicy > sp1( sp0 );
+                    CPPUNIT_ASSERT_EQUAL( 1, SharedPointerTester< 0 >::static_counter_ );
+                    CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( 2 ), sp0.useCount() );
+                    CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( 2 ), sp1.useCount() );
+                    CPPUNIT_ASSERT_EQUAL( rawPointer, sp0.get() );
+                    CPPUNIT_ASSERT_EQUAL( rawPointer, sp1.get() );
+            }
+            CPPUNIT_ASSERT_EQUAL( 1, SharedPointerTester< 0 >::static_counter_ );
+            CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( 1 ), sp0.useCount() );
+            CPPUNIT_ASSERT_EQUAL( rawPointer, sp0.get() );
         }
-        CPPUNIT_ASSERT_EQUAL( 1, SharedPointerTester< 0 >::static_counter_ );
-        CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( 1 ), sp0.useCount() );
-        CPPUNIT_ASSERT_EQUAL( rawPointer, sp0.get() );
-    }
-    CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
+        CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
     
     
-    // Testing construction of an empty shared pointer.
-    {
-        SharedPointer< SharedPointerTester< 0 > > sp0;
-        CPPUNIT_ASSERT( 0 == sp0.get() );
-    }
+        // Testing construction of an empty shared pointer.
+        {
+            SharedPointer< SharedPointerTester< 0 >, CountPolicy > sp0;
+            CPPUNIT_ASSERT( 0 == sp0.get() );
+        }
 
     
-    CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
-}
+        CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
+    }
+    
+} // anonymous namespace
 
 
 
-void 
-OpenSteer::SharedPointerTest::testAssignment()
+void
+OpenSteer::SharedPointerTest::testConstruction()
 {
-    // Testing assignment of shared pointers pointing to 0.
-    {
-        SharedPointer< SharedPointerTester< 0 > > sp0;
-        SharedPointer< SharedPointerTester< 0 > > sp1( sp0 );
-        CPPUNIT_ASSERT( 0 == sp0.get() );
-        CPPUNIT_ASSERT( 0 == sp1.get() );
-    }
-    CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
+    checkConstruction< SharedPointerPlainCount >();
+    checkConstruction< SharedPointerAtomicCount >();
+}
+
+
+
+namespace {
     
+    using namespace OpenSteer;
     
-    // Testing assignment to a shared pointer holding 0.
+    template< typename CountPolicy >
+    void checkAssignment()
     {
-        SharedPointerTester< 0 >* rawPointer = new SharedPointerTester< 0 >();
-        SharedPointer< SharedPointerTester< 0 > > sp0;
-        SharedPointer< SharedPointerTester< 0 > > sp1( rawPointer );
-        SharedPointer< SharedPointerTester< 0 > > sp2( sp0 );
+        // Testing assignment of shared pointers pointing to 0.
+        {
+            SharedPointer< SharedPointerTester< 0 >, CountPolicy > sp0;
+            SharedPointer< SharedPointerTester< 0 >, CountPolicy > sp1( sp0 );
+            CPPUNIT_ASSERT( 0 == sp0.get() );
+            CPPUNIT_ASSERT( 0 == sp1.get() );
+        }
+        CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
+    
+    
+        // Testing assignment to a shared pointer holding 0.
+        {
+            SharedPointerTester< 0 >* rawPointer = new SharedPointerTester< 0 >();
+            SharedPointer< SharedPointerTester< 0 >, CountPolicy > sp0;
+            SharedPointer< SharedPointerTester< 0 >, CountPolicy > sp1( rawPointer );
+            SharedPointer< SharedPointerTester< 0 >, CountPolicy > sp2( sp0 );
         
-        sp0 = sp1;
-        CPPUNIT_ASSERT( 2 == sp0.useCount() );
-        CPPUNIT_ASSERT( 2 == sp1.useCount() );
-        CPPUNIT_ASSERT_EQUAL( rawPointer, sp0.get() );
-        CPPUNIT_ASSERT_EQUAL( rawPointer, sp1.get() );
-        CPPUNIT_ASSERT( 0 == sp2.get() );
-    }
-    CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
+            sp0 = sp1;
+            CPPUNIT_ASSERT( 2 == sp0.useCount() );
+            CPPUNIT_ASSERT( 2 == sp1.useCount() );
+            CPPUNIT_ASSERT_EQUAL( rawPointer, sp0.get() );
+            CPPUNIT_ASSERT_EQUAL( rawPointer, sp1.get() );
+            CPPUNIT_ASSERT( 0 == sp2.get() );
+        }
+        CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
     
     
-    // Testing assignment that should lead to a  destruction.
-    {
-        SharedPointerTester< 0 >* rawPointer0 = new SharedPointerTester< 0 >();
-        SharedPointerTester< 0 >* rawPointer1 = new SharedPointerTester< 0 >();
-        CPPUNIT_ASSERT_EQUAL( 2, SharedPointerTester< 0 >::static_counter_ );
+        // Testing assignment that should lead to a  destruction.
+        {
+            SharedPointerTester< 0 >* rawPointer0 = new SharedPointerTester< 0 >();
+            SharedPointerTester< 0 >* rawPointer1 = new SharedPointerTester< 0 >();
+            CPPUNIT_ASSERT_EQUAL( 2, SharedPointerTester< 0 >::static_counter_ );
         
-        SharedPointer< SharedPointerTester< 0 > > sp0( rawPointer0 );
-        SharedPointer< SharedPointerTester< 0 > > sp1( rawPointer1 );
-        sp1 = sp0;
+            SharedPointer< SharedPointerTester< 0 >, CountPolicy > sp0( rawPointer0 );
+            SharedPointer< SharedPointerTester< 0 >, CountPolicy > sp1( rawPointer1 );
+            sp1 = sp0;
         
-        CPPUNIT_ASSERT_EQUAL( 1, SharedPointerTester< 0 >::static_counter_ );
-        CPPUNIT_ASSERT( 2 == sp0.useCount() );
-        CPPUNIT_ASSERT( 2 == sp1.useCount() );
-        CPPUNIT_ASSERT_EQUAL( rawPointer0, sp0.get() );
-        CPPUNIT_ASSERT_EQUAL( rawPointer0, sp1.get() );
+            CPPUNIT_ASSERT_EQUAL( 1, SharedPointerTester< 0 >::static_counter_ );
+            CPPUNIT_ASSERT( 2 == sp0.useCount() );
+            CPPUNIT_ASSERT( 2 == sp1.useCount() );
+            CPPUNIT_ASSERT_EQUAL( rawPointer0, sp0.get() );
+            CPPUNIT_ASSERT_EQUAL( rawPointer0, sp1.get() );
+        }
+        CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
+    
     }
-    CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
     
-}
+} // anonymous namespace
 
 
 
-void 
-OpenSteer::SharedPointerTest::testReset()
+void
+OpenSteer::SharedPointerTest::testAssignment()
 {
-    // Reset a shared pointer that manages a 0-pointer.
+    checkAssignment< SharedPointerPlainCount >();
+    checkAssignment< SharedPointerAtomicCount >();
+}
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    template< typename CountPolicy >
+    void checkReset()
     {
-        SharedPointer< SharedPointerTester< 0 > > sp0;
-        sp0.reset();
-        CPPUNIT_ASSERT( 0 == sp0.get() );
-    }
-    CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
+        // Reset a shared pointer that manages a 0-pointer.
+        {
+            SharedPointer< SharedPointerTester< 0 >, CountPolicy > sp0;
+            sp0.reset();
+            CPPUNIT_ASSERT( 0 == sp0.get() );
+        }
+        CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
     
 
-    // Reset a shared pointer that manages a raw pointer.
-    {
-        SharedPointerTester< 0 >* rawPointer0 = new SharedPointerTester< 0 >();
-        CPPUNIT_ASSERT_EQUAL( 1, SharedPointerTester< 0 >::static_counter_ );
+        // Reset a shared pointer that manages a raw pointer.
+        {
+            SharedPointerTester< 0 >* rawPointer0 = new SharedPointerTester< 0 >();
+            CPPUNIT_ASSERT_EQUAL( 1, SharedPointerTester< 0 >::static_counter_ );
         
-        SharedPointer< SharedPointerTester< 0 > > sp0( rawPointer0 );
-        sp0.reset();
-        CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
-        CPPUNIT_ASSERT( 0 == sp0.get() );
+            SharedPointer< SharedPointerTester< 0 >, CountPolicy > sp0( rawPointer0 );
+            sp0.reset();
+            CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
+            CPPUNIT_ASSERT( 0 == sp0.get() );
         
         
-    }
-    CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
+        }
+        CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
 
-    // Reset more than once.
-    {
-        SharedPointerTester< 0 >* rawPointer0 = new SharedPointerTester< 0 >();
-        CPPUNIT_ASSERT_EQUAL( 1, SharedPointerTester< 0 >::static_counter_ );
+        // Reset more than once.
+        {
+            SharedPointerTester< 0 >* rawPointer0 = new SharedPointerTester< 0 >();
+            CPPUNIT_ASSERT_EQUAL( 1, SharedPointerTester< 0 >::static_counter_ );
         
-        SharedPointer< SharedPointerTester< 0 > > sp0( rawPointer0 );
-        sp0.reset();
-        CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
-        CPPUNIT_ASSERT( 0 == sp0.get() );
+            SharedPointer< SharedPointerTester< 0 >, CountPolicy > sp0( rawPointer0 );
+            sp0.reset();
+            CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
+            CPPUNIT_ASSERT( 0 == sp0.get() );
         
-        sp0.reset();
+            sp0.reset();
+            CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
+            CPPUNIT_ASSERT( 0 == sp0.get() );
+        }
         CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
-        CPPUNIT_ASSERT( 0 == sp0.get() );
-    }
-    CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
     
     
-    // Reset a shared pointer managing a 0-pointer with a new raw pointer.
-    {
-        SharedPointerTester< 0 >* rawPointer0 = new SharedPointerTester< 0 >();
-        CPPUNIT_ASSERT_EQUAL( 1, SharedPointerTester< 0 >::static_counter_ );
+        // Reset a shared pointer managing a 0-pointer with a new raw pointer.
+        {
+            SharedPointerTester< 0 >* rawPointer0 = new SharedPointerTester< 0 >();
+            CPPUNIT_ASSERT_EQUAL( 1, SharedPointerTester< 0 >::static_counter_ );
         
-        SharedPointer< SharedPointerTester< 0 > > sp0;
-        sp0.reset( rawPointer0 );
-        CPPUNIT_ASSERT_EQUAL( 1, SharedPointerTester< 0 >::static_counter_ );
-        CPPUNIT_ASSERT( rawPointer0 == sp0.get() );
+            SharedPointer< SharedPointerTester< 0 >, CountPolicy > sp0;
+            sp0.reset( rawPointer0 );
+            CPPUNIT_ASSERT_EQUAL( 1, SharedPointerTester< 0 >::static_counter_ );
+            CPPUNIT_ASSERT( rawPointer0 == sp0.get() );
         
-        sp0.reset();
-        CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
-        CPPUNIT_ASSERT( 0 == sp0.get() );
+            sp0.reset();
+            CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
+            CPPUNIT_ASSERT( 0 == sp0.get() );
         
-    }
-    CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
+        }
+        CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
     
     
-    // Reset a shared pointer managing a raw pointer with a new raw pointer.
-    {
-        SharedPointerTester< 0 >* rawPointer0 = new SharedPointerTester< 0 >();
-        SharedPointerTester< 0 >* rawPointer1 = new SharedPointerTester< 0 >();
-        CPPUNIT_ASSERT_EQUAL( 2, SharedPointerTester< 0 >::static_counter_ );
+        // Reset a shared pointer managing a raw pointer with a new raw pointer.
+        {
+            SharedPointerTester< 0 >* rawPointer0 = new SharedPointerTester< 0 >();
+            SharedPointerTester< 0 >* rawPointer1 = new SharedPointerTester< 0 >();
+            CPPUNIT_ASSERT_EQUAL( 2, SharedPointerTester< 0 >::static_counter_ );
         
-        SharedPointer< SharedPointerTester< 0 > > sp0( rawPointer0 );
-        sp0.reset( rawPointer1 );
-        CPPUNIT_ASSERT_EQUAL( 1, SharedPointerTester< 0 >::static_counter_ );
-        CPPUNIT_ASSERT( rawPointer1 == sp0.get() );
+            SharedPointer< SharedPointerTester< 0 >, CountPolicy > sp0( rawPointer0 );
+            sp0.reset( rawPointer1 );
+            CPPUNIT_ASSERT_EQUAL( 1, SharedPointerTester< 0 >::static_counter_ );
+            CPPUNIT_ASSERT( rawPointer1 == sp0.get() );
         
-        sp0.reset();
+            sp0.reset();
+            CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
+            CPPUNIT_ASSERT( 0 == sp0.get() );
+        }
         CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
-        CPPUNIT_ASSERT( 0 == sp0.get() );
-    }
-    CPPUNIT_ASSERT_EQUAL( 0, SharedPointerTester< 0 >::static_counter_ );
     
     
     
+    }
+    
+} // anonymous namespace
+
+
+
+void
+OpenSteer::SharedPointerTest::testReset()
+{
+    checkReset< SharedPointerPlainCount >();
+    checkReset< SharedPointerAtomicCount >();
 }
 
 
@@ -326,108 +377,275 @@ namespace {
 
 
 
-void
-OpenSteer::SharedPointerTest::testInheritance()
-{
-    {
-        Sub* rawSubPointer0 = new Sub();
-        SharedPointer< Super > sp0( rawSubPointer0 );
-        CPPUNIT_ASSERT_EQUAL( 1, Super::superCount_ );
-    }
-    CPPUNIT_ASSERT_EQUAL( 0, Super::superCount_ );
+namespace {
     
+    using namespace OpenSteer;
+    
+    template< typename CountPolicy >
+    void checkInheritance()
     {
-        Super* rawSuperPointer0 = new Super();
-        SharedPointer< Super > sp0( rawSuperPointer0 );
-        CPPUNIT_ASSERT_EQUAL( 1, Super::superCount_ );
-        CPPUNIT_ASSERT_EQUAL( 0, Sub::subCount_ );
+        {
+            Sub* rawSubPointer0 = new Sub();
+            SharedPointer< Super, CountPolicy > sp0( rawSubPointer0 );
+            CPPUNIT_ASSERT_EQUAL( 1, Super::superCount_ );
+        }
+        CPPUNIT_ASSERT_EQUAL( 0, Super::superCount_ );
+    
+        {
+            Super* rawSuperPointer0 = new Super();
+            SharedPointer< Super, CountPolicy > sp0( rawSuperPointer0 );
+            CPPUNIT_ASSERT_EQUAL( 1, Super::superCount_ );
+            CPPUNIT_ASSERT_EQUAL( 0, Sub::subCount_ );
         
-        Sub* rawSubPointer0 = new Sub();
-        SharedPointer< Sub > sp1( rawSubPointer0 );
-        CPPUNIT_ASSERT_EQUAL( 2, Super::superCount_ );
-        CPPUNIT_ASSERT_EQUAL( 1, Sub::subCount_ );
+            Sub* rawSubPointer0 = new Sub();
+            SharedPointer< Sub, CountPolicy > sp1( rawSubPointer0 );
+            CPPUNIT_ASSERT_EQUAL( 2, Super::superCount_ );
+            CPPUNIT_ASSERT_EQUAL( 1, Sub::subCount_ );
         
         
-        sp0 = sp1;
-        CPPUNIT_ASSERT_EQUAL( 1, Super::superCount_ );
-        CPPUNIT_ASSERT_EQUAL( 1, Sub::subCount_ );
+            sp0 = sp1;
+            CPPUNIT_ASSERT_EQUAL( 1, Super::superCount_ );
+            CPPUNIT_ASSERT_EQUAL( 1, Sub::subCount_ );
+        }
+        CPPUNIT_ASSERT_EQUAL( 0, Super::superCount_ );
+        CPPUNIT_ASSERT_EQUAL( 0, Sub::subCount_ );
     }
-    CPPUNIT_ASSERT_EQUAL( 0, Super::superCount_ );
-    CPPUNIT_ASSERT_EQUAL( 0, Sub::subCount_ );
-}
+    
+} // anonymous namespace
 
 
 
-void 
-OpenSteer::SharedPointerTest::testComparisons()
+void
+OpenSteer::SharedPointerTest::testInheritance()
 {
-    Super* rawSuperPointer0 = new Super();
-    SharedPointer< Super > sp0( rawSuperPointer0 );
+    checkInheritance< SharedPointerPlainCount >();
+    checkInheritance< SharedPointerAtomicCount >();
+}
+
+
+
+namespace {
     
-    Sub* rawSubPointer1 = new Sub();
-    SharedPointer< Super > sp1( rawSubPointer1 );
+    using namespace OpenSteer;
     
-    CPPUNIT_ASSERT( sp0 != sp1 );
-    CPPUNIT_ASSERT( ( sp0 < sp1 ) || ( sp1 < sp0 ) );
+    template< typename CountPolicy >
+    void checkComparisons()
+    {
+        Super* rawSuperPointer0 = new Super();
+        SharedPointer< Super, CountPolicy > sp0( rawSuperPointer0 );
     
-    sp1 = sp0;
+        Sub* rawSubPointer1 = new Sub();
+        SharedPointer< Super, CountPolicy > sp1( rawSubPointer1 );
     
-    CPPUNIT_ASSERT( sp0 == sp1 );
-    CPPUNIT_ASSERT( !( sp0 < sp1 ) && !( sp1 < sp0 ) );
+        CPPUNIT_ASSERT( sp0 != sp1 );
+        CPPUNIT_ASSERT( ( sp0 < sp1 ) || ( sp1 < sp0 ) );
+    
+        sp1 = sp0;
+    
+        CPPUNIT_ASSERT( sp0 == sp1 );
+        CPPUNIT_ASSERT( !( sp0 < sp1 ) && !( sp1 < sp0 ) );
+    
+        sp0.reset();
+        sp1.reset();
     
-    sp0.reset();
-    sp1.reset();
+        CPPUNIT_ASSERT( sp0 == sp1 );
+        // @todo Are these semantics really a good idea?
+        CPPUNIT_ASSERT( ( sp0 < sp1 ) || ( sp1 < sp0 ) );
     
-    CPPUNIT_ASSERT( sp0 == sp1 );
-    // @todo Are these semantics really a good idea?
-    CPPUNIT_ASSERT( ( sp0 < sp1 ) || ( sp1 < sp0 ) );
+    }
     
+} // anonymous namespace
+
+
+
+void
+OpenSteer::SharedPointerTest::testComparisons()
+{
+    checkComparisons< SharedPointerPlainCount >();
+    checkComparisons< SharedPointerAtomicCount >();
 }
 
 
 
 
-void 
-OpenSteer::SharedPointerTest::testImplicitBoolCast()
-{
-    Super* rawSuperPointer0 = new Super();
-    SharedPointer< Super > sp0;
+namespace {
     
-    if ( !sp0 ) {
-        CPPUNIT_ASSERT( true );
-    } else {
-        CPPUNIT_ASSERT( false );
-    }
+    using namespace OpenSteer;
+    
+    template< typename CountPolicy >
+    void checkImplicitBoolCast()
+    {
+        Super* rawSuperPointer0 = new Super();
+        SharedPointer< Super, CountPolicy > sp0;
+    
+        if ( !sp0 ) {
+            CPPUNIT_ASSERT( true );
+        } else {
+            CPPUNIT_ASSERT( false );
+        }
+    
+        sp0.reset( rawSuperPointer0 );
+        if ( sp0 ) {
+            CPPUNIT_ASSERT( true );
+        } else {
+            CPPUNIT_ASSERT( false );
+        }
     
-    sp0.reset( rawSuperPointer0 );
-    if ( sp0 ) {
-        CPPUNIT_ASSERT( true );
-    } else {
-        CPPUNIT_ASSERT( false );
     }
     
+} // anonymous namespace
+
+
+
+void
+OpenSteer::SharedPointerTest::testImplicitBoolCast()
+{
+    checkImplicitBoolCast< SharedPointerPlainCount >();
+    checkImplicitBoolCast< SharedPointerAtomicCount >();
 }
 
 
 
 
+namespace {
+    
+    using namespace OpenSteer;
+    
+    template< typename CountPolicy >
+    void checkSwap()
+    {
+        Super* rawSuperPointer0 = new Super();
+        SharedPointer< Super, CountPolicy > sp0( rawSuperPointer0 );
+    
+        Super* rawSuperPointer1 = new Super();
+        SharedPointer< Super, CountPolicy > sp1( rawSuperPointer1 );
+    
+        CPPUNIT_ASSERT_EQUAL( 2, Super::superCount_ );
+    
+        sp0.swap( sp1 );
+    
+        CPPUNIT_ASSERT( rawSuperPointer0 == sp1.get() );
+        CPPUNIT_ASSERT( rawSuperPointer1 == sp0.get() );
+        CPPUNIT_ASSERT_EQUAL( 2, Super::superCount_ );
+    
+    }
+    
+} // anonymous namespace
+
+
+
 void
 OpenSteer::SharedPointerTest::testSwap()
 {
-    Super* rawSuperPointer0 = new Super();
-    SharedPointer< Super > sp0( rawSuperPointer0 );
+    checkSwap< SharedPointerPlainCount >();
+    checkSwap< SharedPointerAtomicCount >();
+}
+
+
+
+namespace {
     
-    Super* rawSuperPointer1 = new Super();
-    SharedPointer< Super > sp1( rawSuperPointer1 );
+    using namespace OpenSteer;
     
-    CPPUNIT_ASSERT_EQUAL( 2, Super::superCount_ );
     
-    sp0.swap( sp1 );
+    struct ConstructorArguments {
+        
+        ConstructorArguments( int _first, float _second ) : first( _first ), second( _second ) {
+            ++instanceCount_;
+        }
+        
+        ~ConstructorArguments() {
+            --instanceCount_;
+        }
+        
+        int const first;
+        float const second;
+        static int instanceCount_;
+    };
+    
+    int ConstructorArguments::instanceCount_ = 0;
     
-    CPPUNIT_ASSERT( rawSuperPointer0 == sp1.get() );
-    CPPUNIT_ASSERT( rawSuperPointer1 == sp0.get() );
-    CPPUNIT_ASSERT_EQUAL( 2, Super::superCount_ );
     
+    template< typename CountPolicy >
+    void checkMakeShared()
+    {
+        {
+            SharedPointer< ConstructorArguments, CountPolicy > sp0 = makeShared< ConstructorArguments, CountPolicy >( 3, 0.5f );
+            CPPUNIT_ASSERT_EQUAL( 1, ConstructorArguments::instanceCount_ );
+            CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( 1 ), sp0.useCount() );
+            CPPUNIT_ASSERT_EQUAL( 3, sp0->first );
+            CPPUNIT_ASSERT_EQUAL( 0.5f, sp0->second );
+            
+            SharedPointer< ConstructorArguments, CountPolicy > sp1( sp0 );
+            CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( 2 ), sp0.useCount() );
+            CPPUNIT_ASSERT( sp0 == sp1 );
+            
+            sp0.reset();
+            CPPUNIT_ASSERT_EQUAL( 1, ConstructorArguments::instanceCount_ );
+            CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( 1 ), sp1.useCount() );
+        }
+        CPPUNIT_ASSERT_EQUAL( 0, ConstructorArguments::instanceCount_ );
+        
+        // A sub class placed in one allocation is destroyed through a super
+        // class shared pointer.
+        {
+            SharedPointer< Super, CountPolicy > sp0 = makeShared< Sub, CountPolicy >();
+            CPPUNIT_ASSERT_EQUAL( 1, Super::superCount_ );
+            CPPUNIT_ASSERT_EQUAL( 1, Sub::subCount_ );
+            CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( 1 ), sp0.useCount() );
+        }
+        CPPUNIT_ASSERT_EQUAL( 0, Super::superCount_ );
+        CPPUNIT_ASSERT_EQUAL( 0, Sub::subCount_ );
+    }
+    
+    
+    template< typename CountPolicy >
+    void copyAndDestroy( SharedPointer< ConstructorArguments, CountPolicy > const& shared, int copies )
+    {
+        for ( int i = 0; i < copies; ++i ) {
+            SharedPointer< ConstructorArguments, CountPolicy > copy( shared );
+            CPPUNIT_ASSERT( copy.get() == shared.get() );
+        }
+    }
+    
+} // anonymous namespace
+
+
+
+void
+OpenSteer::SharedPointerTest::testMakeShared()
+{
+    checkMakeShared< SharedPointerPlainCount >();
+    checkMakeShared< SharedPointerAtomicCount >();
+    
+    // The default policy must be usable without naming it.
+    SharedPointer< ConstructorArguments > sp0 = makeShared< ConstructorArguments >( 1, 2.0f );
+    CPPUNIT_ASSERT_EQUAL( 1, sp0->first );
+}
+
+
+
+void
+OpenSteer::SharedPointerTest::testConcurrentCopies()
+{
+    int const threadCount = 4;
+    int const copiesPerThread = 100000;
+    
+    {
+        SharedPointer< ConstructorArguments, SharedPointerAtomicCount > sp0 = makeShared< ConstructorArguments, SharedPointerAtomicCount >( 0, 0.0f );
+        
+        std::vector< std::thread > threads;
+        for ( int i = 0; i < threadCount; ++i ) {
+            threads.push_back( std::thread( copyAndDestroy< SharedPointerAtomicCount >, sp0, copiesPerThread ) );
+        }
+        for ( int i = 0; i < threadCount; ++i ) {
+            threads[ i ].join();
+        }
+        
+        CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( 1 ), sp0.useCount() );
+        CPPUNIT_ASSERT_EQUAL( 1, ConstructorArguments::instanceCount_ );
+    }
+    CPPUNIT_ASSERT_EQUAL( 0, ConstructorArguments::instanceCount_ );
 }
 
 
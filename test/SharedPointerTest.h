@@ -63,6 +63,8 @@ namespace OpenSteer {
         CPPUNIT_TEST(testComparisons);
         CPPUNIT_TEST(testImplicitBoolCast);
         CPPUNIT_TEST(testSwap);
+        CPPUNIT_TEST(testMakeShared);
+        CPPUNIT_TEST(testConcurrentCopies);
         CPPUNIT_TEST_SUITE_END();
         
     private:
@@ -114,6 +116,18 @@ namespace OpenSteer {
          */
         void testSwap();
         
+        /**
+         * Tests constructing the managed object and its reference count in
+         * one allocation.
+         */
+        void testMakeShared();
+        
+        /**
+         * Tests copying and destroying shared pointers to one object from
+         * several threads with the atomic reference count.
+         */
+        void testConcurrentCopies();
+        
         
 
         
@@ -0,0 +1,227 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::SimulationSnapshot and
+ * @c OpenSteer::SnapshotTripleBuffer.
+ */
+#include "SimulationSnapshotTest.h"
+
+
+#include <thread>
+
+// Include OpenSteer::SimpleVehicle
+#include "OpenSteer/SimpleVehicle.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::SimulationSnapshotTest );
+
+
+
+OpenSteer::SimulationSnapshotTest::SimulationSnapshotTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::SimulationSnapshotTest::~SimulationSnapshotTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::SimulationSnapshotTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::SimulationSnapshotTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    
+    /**
+     * A vehicle which stays where it is put.
+     */
+    class StillVehicle : public OpenSteer::SimpleVehicle {
+    public:
+        void update( float const, float const ) {}
+    };
+    
+    
+    /**
+     * Fills a snapshot with @a count lines all starting at x = @a count, so
+     * a reader can tell a whole snapshot from a mix of two.
+     */
+    void fillSnapshot( OpenSteer::SimulationSnapshot& snapshot, int count )
+    {
+        snapshot.clear();
+        for ( int i = 0; i < count; ++i ) {
+            snapshot.addLine( OpenSteer::Vec3( float( count ), 0.0f, 0.0f ),
+                              OpenSteer::Vec3( float( i ), 0.0f, 0.0f ),
+                              OpenSteer::gWhite );
+        }
+    }
+    
+    
+    /**
+     * Whether all lines of a snapshot were written by one @c fillSnapshot.
+     */
+    bool isWhole( OpenSteer::SimulationSnapshot const& snapshot )
+    {
+        for ( size_t i = 0; i < snapshot.lines.size(); ++i ) {
+            if ( snapshot.lines[ i ].startPoint.x != float( snapshot.lines.size() ) ) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    
+    /**
+     * Publishes snapshots of 1 to @a count lines.
+     */
+    void publishSnapshots( OpenSteer::SnapshotTripleBuffer* buffer, int count )
+    {
+        for ( int i = 1; i <= count; ++i ) {
+            fillSnapshot( buffer->back(), i );
+            buffer->publish();
+        }
+    }
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::SimulationSnapshotTest::testCaptureVehicles()
+{
+    StillVehicle a;
+    StillVehicle b;
+    StillVehicle other;
+    b.setPosition( Vec3( 1.0f, 2.0f, 3.0f ) );
+    b.regenerateOrthonormalBasisUF( Vec3( 0.0f, 0.0f, -1.0f ) );
+    b.setRadius( 2.5f );
+    b.setSpeed( 0.75f );
+    
+    AVGroup group;
+    group.push_back( &a );
+    group.push_back( &b );
+    
+    SimulationSnapshot snapshot;
+    snapshot.captureVehicles( group, &b );
+    CPPUNIT_ASSERT_EQUAL( size_t( 2 ), snapshot.vehicles.size() );
+    CPPUNIT_ASSERT_EQUAL( 1, snapshot.selected );
+    
+    SimulationSnapshot::Vehicle const& record = *snapshot.selectedVehicle();
+    CPPUNIT_ASSERT( Vec3( 1.0f, 2.0f, 3.0f ) == record.position );
+    CPPUNIT_ASSERT( b.forward() == record.forward );
+    CPPUNIT_ASSERT( b.side() == record.side );
+    CPPUNIT_ASSERT( b.up() == record.up );
+    CPPUNIT_ASSERT_EQUAL( 2.5f, record.radius );
+    CPPUNIT_ASSERT_EQUAL( 0.75f, record.speed );
+    
+    snapshot.captureVehicles( group, &other );
+    CPPUNIT_ASSERT_EQUAL( -1, snapshot.selected );
+    CPPUNIT_ASSERT( 0 == snapshot.selectedVehicle() );
+}
+
+
+
+void 
+OpenSteer::SimulationSnapshotTest::testHandOff()
+{
+    SnapshotTripleBuffer buffer;
+    CPPUNIT_ASSERT( ! buffer.acquire() );
+    
+    fillSnapshot( buffer.back(), 1 );
+    buffer.publish();
+    CPPUNIT_ASSERT( buffer.acquire() );
+    CPPUNIT_ASSERT_EQUAL( 1ul, buffer.front().serialNumber );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), buffer.front().lines.size() );
+    
+    // nothing new: the reader keeps what it has
+    CPPUNIT_ASSERT( ! buffer.acquire() );
+    CPPUNIT_ASSERT_EQUAL( 1ul, buffer.front().serialNumber );
+    
+    // the writer never gets the reader's buffer
+    CPPUNIT_ASSERT( &buffer.back() != &buffer.front() );
+    
+    // of several publications only the latest is seen
+    fillSnapshot( buffer.back(), 2 );
+    buffer.publish();
+    CPPUNIT_ASSERT( &buffer.back() != &buffer.front() );
+    fillSnapshot( buffer.back(), 3 );
+    buffer.publish();
+    CPPUNIT_ASSERT( buffer.acquire() );
+    CPPUNIT_ASSERT_EQUAL( 3ul, buffer.front().serialNumber );
+    CPPUNIT_ASSERT_EQUAL( size_t( 3 ), buffer.front().lines.size() );
+    CPPUNIT_ASSERT( ! buffer.acquire() );
+}
+
+
+
+void 
+OpenSteer::SimulationSnapshotTest::testConcurrentHandOff()
+{
+    int const count = 20000;
+    SnapshotTripleBuffer buffer;
+    std::thread writer( publishSnapshots, &buffer, count );
+    
+    unsigned long last = 0;
+    bool whole = true;
+    bool ordered = true;
+    while ( last < (unsigned long) count ) {
+        if ( buffer.acquire() ) {
+            SimulationSnapshot const& snapshot = buffer.front();
+            whole = whole && isWhole( snapshot ) &&
+                    ( snapshot.lines.size() == snapshot.serialNumber );
+            ordered = ordered && ( snapshot.serialNumber > last );
+            last = snapshot.serialNumber;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    writer.join();
+    
+    CPPUNIT_ASSERT( whole );
+    CPPUNIT_ASSERT( ordered );
+    CPPUNIT_ASSERT_EQUAL( (unsigned long) count, last );
+}
@@ -0,0 +1,101 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::SimulationSnapshot and
+ * @c OpenSteer::SnapshotTripleBuffer.
+ */
+#ifndef OPENSTEER_SIMULATIONSNAPSHOTTEST_H
+#define OPENSTEER_SIMULATIONSNAPSHOTTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::SimulationSnapshot, OpenSteer::SnapshotTripleBuffer
+#include "OpenSteer/SimulationSnapshot.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class SimulationSnapshotTest : public CppUnit::TestFixture {
+    public:
+        SimulationSnapshotTest();
+        virtual ~SimulationSnapshotTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(SimulationSnapshotTest);
+        CPPUNIT_TEST(testCaptureVehicles);
+        CPPUNIT_TEST(testHandOff);
+        CPPUNIT_TEST(testConcurrentHandOff);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        SimulationSnapshotTest( SimulationSnapshotTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        SimulationSnapshotTest& operator=( SimulationSnapshotTest const& );
+        
+    private:
+        /**
+         * Tests that a capture copies each vehicle's state and finds the
+         * selected vehicle's index.
+         */
+        void testCaptureVehicles();
+        
+        /**
+         * Tests that @c acquire switches to the latest published snapshot,
+         * skipping ones published in between, and only when there is one.
+         */
+        void testHandOff();
+        
+        /**
+         * Tests that a reader thread only ever sees whole snapshots, in
+         * publication order, while a writer thread publishes.
+         */
+        void testConcurrentHandOff();
+        
+    }; // SimulationSnapshotTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_SIMULATIONSNAPSHOTTEST_H
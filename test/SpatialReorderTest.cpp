@@ -0,0 +1,187 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::SpatialReorder.
+ */
+#include "SpatialReorderTest.h"
+
+
+
+#include <algorithm>
+#include <vector>
+
+
+// Include OpenSteer::SpatialReorder, OpenSteer::mortonCode
+#include "OpenSteer/SpatialReorder.h"
+
+// Include OpenSteer::RandomStream
+#include "OpenSteer/Random.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::SpatialReorderTest );
+
+
+
+OpenSteer::SpatialReorderTest::SpatialReorderTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::SpatialReorderTest::~SpatialReorderTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::SpatialReorderTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::SpatialReorderTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+void 
+OpenSteer::SpatialReorderTest::testMortonCode()
+{
+    Vec3 const low( 0.0f, 0.0f, 0.0f );
+    Vec3 const high( 1.0f, 1.0f, 1.0f );
+    
+    CPPUNIT_ASSERT_EQUAL( uint64_t( 0 ), mortonCode( low, low, high ) );
+    CPPUNIT_ASSERT_EQUAL( ( uint64_t( 1 ) << 63 ) - 1, mortonCode( high, low, high ) );
+    
+    // clamped to the box
+    CPPUNIT_ASSERT_EQUAL( uint64_t( 0 ), mortonCode( Vec3( -5.0f, -5.0f, -5.0f ), low, high ) );
+    CPPUNIT_ASSERT_EQUAL( mortonCode( high, low, high ), mortonCode( Vec3( 5.0f, 5.0f, 5.0f ), low, high ) );
+    
+    // the top bits of x, y and z in turn, z's highest
+    uint64_t const top = uint64_t( 1 ) << 60;
+    CPPUNIT_ASSERT_EQUAL( top, mortonCode( Vec3( 0.5f, 0.0f, 0.0f ), low, high ) );
+    CPPUNIT_ASSERT_EQUAL( top << 1, mortonCode( Vec3( 0.0f, 0.5f, 0.0f ), low, high ) );
+    CPPUNIT_ASSERT_EQUAL( top << 2, mortonCode( Vec3( 0.0f, 0.0f, 0.5f ), low, high ) );
+}
+
+
+
+void 
+OpenSteer::SpatialReorderTest::testPassSortsAlongTheCurve()
+{
+    RandomStream random( 5 );
+    std::size_t const count = 1000;
+    std::vector< Vec3 > positions( count );
+    std::vector< int > ids( count );
+    for ( std::size_t i = 0; i < count; ++i ) {
+        positions[ i ] = RandomVectorInUnitRadiusSphere( random ) * 50.0f;
+        ids[ i ] = int( i );
+    }
+    std::vector< Vec3 > const original( positions );
+    
+    SpatialReorder reorder;
+    reorder.setSchedule( 1, 4 );
+    CPPUNIT_ASSERT( reorder.beginFrame( count ) );
+    reorder.beginPass( &positions[ 0 ], count );
+    
+    int frames = 0;
+    for ( ;; ) {
+        CPPUNIT_ASSERT( reorder.exchanges().size() <= count / 4 );
+        for ( std::size_t e = 0; e < reorder.exchanges().size(); ++e ) {
+            SpatialReorder::Exchange const& x = reorder.exchanges()[ e ];
+            std::swap( positions[ x.first ], positions[ x.second ] );
+            std::swap( ids[ x.first ], ids[ x.second ] );
+        }
+        ++frames;
+        if ( ! reorder.passInProgress() ) {
+            break;
+        }
+        CPPUNIT_ASSERT( ! reorder.beginFrame( count ) );
+    }
+    CPPUNIT_ASSERT_EQUAL( 4, frames );
+    CPPUNIT_ASSERT_EQUAL( 1ul, reorder.passCount() );
+    
+    // a permutation of the original positions, in Morton order
+    Vec3 low = original[ 0 ];
+    Vec3 high = original[ 0 ];
+    for ( std::size_t i = 0; i < count; ++i ) {
+        low.set( std::min( low.x, original[ i ].x ), std::min( low.y, original[ i ].y ), std::min( low.z, original[ i ].z ) );
+        high.set( std::max( high.x, original[ i ].x ), std::max( high.y, original[ i ].y ), std::max( high.z, original[ i ].z ) );
+    }
+    for ( std::size_t i = 0; i < count; ++i ) {
+        CPPUNIT_ASSERT( original[ ids[ i ] ] == positions[ i ] );
+        if ( i > 0 ) {
+            CPPUNIT_ASSERT( mortonCode( positions[ i - 1 ], low, high ) <= mortonCode( positions[ i ], low, high ) );
+        }
+    }
+}
+
+
+
+void 
+OpenSteer::SpatialReorderTest::testSchedule()
+{
+    std::vector< Vec3 > positions( 10 );
+    for ( std::size_t i = 0; i < positions.size(); ++i ) {
+        positions[ i ] = Vec3( float( positions.size() - i ), 0.0f, 0.0f );
+    }
+    
+    // off by default
+    SpatialReorder reorder;
+    for ( int frame = 0; frame < 10; ++frame ) {
+        CPPUNIT_ASSERT( ! reorder.beginFrame( positions.size() ) );
+    }
+    
+    // due every third frame
+    reorder.setSchedule( 3, 2 );
+    CPPUNIT_ASSERT( ! reorder.beginFrame( positions.size() ) );
+    CPPUNIT_ASSERT( ! reorder.beginFrame( positions.size() ) );
+    CPPUNIT_ASSERT( reorder.beginFrame( positions.size() ) );
+    reorder.beginPass( &positions[ 0 ], positions.size() );
+    CPPUNIT_ASSERT( reorder.passInProgress() );
+    CPPUNIT_ASSERT( ! reorder.exchanges().empty() );
+    
+    // a new size abandons the pass, the next is a period later
+    CPPUNIT_ASSERT( ! reorder.beginFrame( positions.size() + 1 ) );
+    CPPUNIT_ASSERT( ! reorder.passInProgress() );
+    CPPUNIT_ASSERT( reorder.exchanges().empty() );
+    CPPUNIT_ASSERT_EQUAL( 0ul, reorder.passCount() );
+    CPPUNIT_ASSERT( ! reorder.beginFrame( positions.size() ) );
+    CPPUNIT_ASSERT( ! reorder.beginFrame( positions.size() ) );
+    CPPUNIT_ASSERT( reorder.beginFrame( positions.size() ) );
+}
@@ -0,0 +1,93 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::SpatialReorder.
+ */
+#ifndef OPENSTEER_SPATIALREORDERTEST_H
+#define OPENSTEER_SPATIALREORDERTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class SpatialReorderTest : public CppUnit::TestFixture {
+    public:
+        SpatialReorderTest();
+        virtual ~SpatialReorderTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(SpatialReorderTest);
+        CPPUNIT_TEST(testMortonCode);
+        CPPUNIT_TEST(testPassSortsAlongTheCurve);
+        CPPUNIT_TEST(testSchedule);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        SpatialReorderTest( SpatialReorderTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        SpatialReorderTest& operator=( SpatialReorderTest const& );
+        
+    private:
+        /**
+         * Tests the interleaving and clamping of @c mortonCode.
+         */
+        void testMortonCode();
+        
+        /**
+         * Tests that carrying out a pass's exchanges sorts positions by
+         * their Morton codes, settling a share of them per frame.
+         */
+        void testPassSortsAlongTheCurve();
+        
+        /**
+         * Tests when passes are due, and that a change of population size
+         * abandons a pass.
+         */
+        void testSchedule();
+        
+    }; // class SpatialReorderTest
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_SPATIALREORDERTEST_H
@@ -0,0 +1,319 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for the statically dispatched neighbor and path following
+ * behaviors of @c OpenSteer::SteerLibraryMixin.
+ */
+#include "SteerLibraryTest.h"
+
+
+// Include std::sin, std::cos
+#include <cmath>
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::SimpleVehicle
+#include "OpenSteer/SimpleVehicle.h"
+
+// Include OpenSteer::PolylineSegmentedPathwaySingleRadius
+#include "OpenSteer/PolylineSegmentedPathwaySingleRadius.h"
+
+// Include OpenSteer::PolylineSegmentedPathwaySegmentRadii
+#include "OpenSteer/PolylineSegmentedPathwaySegmentRadii.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::SteerLibraryTest );
+
+
+
+OpenSteer::SteerLibraryTest::SteerLibraryTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::SteerLibraryTest::~SteerLibraryTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::SteerLibraryTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::SteerLibraryTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    
+    class TestVehicle : public OpenSteer::SimpleVehicle {
+    public:
+        void update( float const, float const ) {}
+    };
+    
+    typedef std::vector< TestVehicle* > TestGroup;
+    
+    
+    /**
+     * Places @a count vehicles on a jittered grid with assorted headings
+     * and speeds, close enough that every behavior finds neighbors.
+     */
+    void makeFlock( std::vector< TestVehicle >& flock, std::size_t count )
+    {
+        flock.resize( count );
+        for ( std::size_t i = 0; i < count; ++i ) {
+            TestVehicle& v = flock[ i ];
+            float const x = float( i % 4 ) * 1.5f + 0.1f * float( i % 3 );
+            float const z = float( i / 4 ) * 1.5f - 0.2f * float( i % 5 );
+            v.setPosition( OpenSteer::Vec3( x, 0.0f, z ) );
+            float const angle = 0.7f * float( i );
+            v.regenerateOrthonormalBasisUF( OpenSteer::Vec3( std::sin( angle ), 0.0f, std::cos( angle ) ) );
+            v.setSpeed( 0.5f + 0.25f * float( i % 4 ) );
+        }
+    }
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::SteerLibraryTest::testStaticGroupMatchesVirtual()
+{
+    std::vector< TestVehicle > flock;
+    makeFlock( flock, 12 );
+    
+    AVGroup virtualGroup;
+    TestGroup staticGroup;
+    for ( std::size_t i = 0; i < flock.size(); ++i ) {
+        virtualGroup.push_back( &flock[ i ] );
+        staticGroup.push_back( &flock[ i ] );
+    }
+    
+    for ( std::size_t i = 0; i < flock.size(); ++i ) {
+        TestVehicle& v = flock[ i ];
+        
+        CPPUNIT_ASSERT( v.steerToAvoidNeighbors( 3.0f, virtualGroup ) ==
+                        v.steerToAvoidNeighbors< TestVehicle >( 3.0f, staticGroup ) );
+        CPPUNIT_ASSERT( v.steerToAvoidCloseNeighbors( 0.5f, virtualGroup ) ==
+                        v.steerToAvoidCloseNeighbors< TestVehicle >( 0.5f, staticGroup ) );
+        CPPUNIT_ASSERT( v.steerForSeparation( 5.0f, -0.7f, virtualGroup ) ==
+                        v.steerForSeparation< TestVehicle >( 5.0f, -0.7f, staticGroup ) );
+        CPPUNIT_ASSERT( v.steerForAlignment( 5.0f, 0.7f, virtualGroup ) ==
+                        v.steerForAlignment< TestVehicle >( 5.0f, 0.7f, staticGroup ) );
+        CPPUNIT_ASSERT( v.steerForCohesion( 5.0f, -0.15f, virtualGroup ) ==
+                        v.steerForCohesion< TestVehicle >( 5.0f, -0.15f, staticGroup ) );
+        
+        // an AbstractVehicle group can be read statically too
+        CPPUNIT_ASSERT( v.steerForCohesion( 5.0f, -0.15f, virtualGroup ) ==
+                        v.steerForCohesion< TestVehicle >( 5.0f, -0.15f, virtualGroup ) );
+    }
+    
+    // the flock is dense enough that avoidance really steers
+    CPPUNIT_ASSERT( Vec3::zero != flock[ 5 ].steerToAvoidNeighbors< TestVehicle >( 3.0f, staticGroup ) );
+}
+
+
+
+void 
+OpenSteer::SteerLibraryTest::testStaticRecordsMatchVirtual()
+{
+    std::vector< TestVehicle > flock;
+    makeFlock( flock, 12 );
+    
+    for ( std::size_t i = 0; i < flock.size(); ++i ) {
+        TestVehicle& v = flock[ i ];
+        
+        AVNeighborGroup records;
+        for ( std::size_t j = 0; j < flock.size(); ++j ) {
+            Vec3 const offset = flock[ j ].position() - v.position();
+            records.push_back( AVNeighbor( &flock[ j ], offset.lengthSquared(), offset ) );
+        }
+        
+        CPPUNIT_ASSERT( v.steerForSeparation( 5.0f, -0.7f, records ) ==
+                        v.steerForSeparation< TestVehicle >( 5.0f, -0.7f, records ) );
+        CPPUNIT_ASSERT( v.steerForAlignment( 5.0f, 0.7f, records ) ==
+                        v.steerForAlignment< TestVehicle >( 5.0f, 0.7f, records ) );
+        CPPUNIT_ASSERT( v.steerForCohesion( 5.0f, -0.15f, records ) ==
+                        v.steerForCohesion< TestVehicle >( 5.0f, -0.15f, records ) );
+        
+        // the flock is dense enough that cohesion finds neighbors
+        if ( 5 == i ) {
+            CPPUNIT_ASSERT( Vec3::zero != v.steerForCohesion< TestVehicle >( 5.0f, -0.15f, records ) );
+        }
+    }
+}
+
+
+
+
+void 
+OpenSteer::SteerLibraryTest::testFlockingMatchesSeparateBehaviors()
+{
+    std::vector< TestVehicle > flock;
+    makeFlock( flock, 12 );
+    
+    BoidBehavior const behaviors[] = {
+        BoidBehavior( BoidBehavior::separation, 2.0f, -0.707f, 12.0f ),
+        BoidBehavior( BoidBehavior::alignment, 3.5f, 0.7f, 8.0f ),
+        BoidBehavior( BoidBehavior::cohesion, 5.0f, -0.15f, 8.0f ),
+        BoidBehavior( BoidBehavior::cohesion, 0.1f, 0.9f, 2.0f )
+    };
+    
+    for ( std::size_t i = 0; i < flock.size(); ++i ) {
+        TestVehicle& v = flock[ i ];
+        
+        AVNeighborGroup records;
+        for ( std::size_t j = 0; j < flock.size(); ++j ) {
+            Vec3 const offset = flock[ j ].position() - v.position();
+            records.push_back( AVNeighbor( &flock[ j ], offset.lengthSquared(), offset ) );
+        }
+        
+        Vec3 const separate = ( v.steerForSeparation( 2.0f, -0.707f, records ) * 12.0f +
+                                v.steerForAlignment( 3.5f, 0.7f, records ) * 8.0f +
+                                v.steerForCohesion( 5.0f, -0.15f, records ) * 8.0f +
+                                v.steerForCohesion( 0.1f, 0.9f, records ) * 2.0f );
+        CPPUNIT_ASSERT( separate == v.steerForFlocking( behaviors, 4, records ) );
+        CPPUNIT_ASSERT( separate == v.steerForFlocking< TestVehicle >( behaviors, 4, records ) );
+        CPPUNIT_ASSERT( Vec3::zero == v.steerForFlocking( behaviors, 0, records ) );
+    }
+}
+
+
+
+namespace {
+    
+    /**
+     * Compares the polyline pathway and @c Pathway path following of each 
+     * vehicle of @a flock, in both directions, with cursors carried along.
+     * Returns the number of vehicles which steer.
+     */
+    template< class PolylinePathway >
+    int comparePathFollowing( std::vector< TestVehicle >& flock, PolylinePathway const& path )
+    {
+        OpenSteer::Pathway const& virtualPath = path;
+        int steering = 0;
+        for ( std::size_t i = 0; i < flock.size(); ++i ) {
+            TestVehicle& v = flock[ i ];
+            OpenSteer::PathCursor polylineCursor;
+            OpenSteer::PathCursor virtualCursor;
+            for ( int direction = -1; direction <= 1; direction += 2 ) {
+                OpenSteer::Vec3 const follow = v.steerToFollowPath( direction, 3.0f, path, polylineCursor );
+                CPPUNIT_ASSERT( follow == v.steerToFollowPath( direction, 3.0f, virtualPath, virtualCursor ) );
+                CPPUNIT_ASSERT( v.steerToStayOnPath( 3.0f, path, polylineCursor ) ==
+                                v.steerToStayOnPath( 3.0f, virtualPath, virtualCursor ) );
+                if ( OpenSteer::Vec3::zero != follow ) {
+                    ++steering;
+                }
+            }
+        }
+        return steering;
+    }
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::SteerLibraryTest::testPolylinePathwayMatchesVirtual()
+{
+    std::vector< TestVehicle > flock;
+    makeFlock( flock, 12 );
+    
+    Vec3 const points[] = { Vec3( -2.0f, 0.0f, -2.0f ), 
+                            Vec3( 3.0f, 0.0f, -1.0f ), 
+                            Vec3( 4.0f, 0.0f, 4.0f ),
+                            Vec3( -1.0f, 0.0f, 5.0f ) };
+    float const radii[] = { 0.5f, 1.0f, 0.25f };
+    
+    PolylineSegmentedPathwaySingleRadius const singleRadius( 4, points, 0.5f, true );
+    PolylineSegmentedPathwaySegmentRadii const segmentRadii( 4, points, radii, false );
+    
+    CPPUNIT_ASSERT( 0 < comparePathFollowing( flock, singleRadius ) );
+    CPPUNIT_ASSERT( 0 < comparePathFollowing( flock, segmentRadii ) );
+}
+
+
+
+namespace {
+    
+    
+    void checkMotion( TestVehicle const& v )
+    {
+        CPPUNIT_ASSERT( v.forward() * v.speed() == v.velocity() );
+        CPPUNIT_ASSERT( v.position() + ( v.forward() * v.speed() ) * 2.0f == v.predictFuturePosition( 2.0f ) );
+    }
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::SteerLibraryTest::testVelocityFollowsMotion()
+{
+    TestVehicle v;
+    checkMotion( v );
+    
+    v.setSpeed( 2.0f );
+    checkMotion( v );
+    
+    v.setForward( Vec3( 1.0f, 0.0f, 0.0f ) );
+    checkMotion( v );
+    
+    v.regenerateOrthonormalBasis( Vec3( 0.0f, 0.0f, -3.0f ) );
+    checkMotion( v );
+    
+    v.applySteeringForce( Vec3( 0.05f, 0.0f, 0.02f ), 0.1f );
+    checkMotion( v );
+    
+    v.applyBrakingForce( 0.5f, 0.1f );
+    checkMotion( v );
+    
+    v.randomizeHeadingOnXZPlane();
+    checkMotion( v );
+    
+    v.reset();
+    checkMotion( v );
+    CPPUNIT_ASSERT( Vec3::zero == v.velocity() );
+}
@@ -0,0 +1,112 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for the statically dispatched neighbor behaviors of
+ * @c OpenSteer::SteerLibraryMixin.
+ */
+#ifndef OPENSTEER_STEERLIBRARYTEST_H
+#define OPENSTEER_STEERLIBRARYTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class SteerLibraryTest : public CppUnit::TestFixture {
+    public:
+        SteerLibraryTest();
+        virtual ~SteerLibraryTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(SteerLibraryTest);
+        CPPUNIT_TEST(testStaticGroupMatchesVirtual);
+        CPPUNIT_TEST(testStaticRecordsMatchVirtual);
+        CPPUNIT_TEST(testFlockingMatchesSeparateBehaviors);
+        CPPUNIT_TEST(testPolylinePathwayMatchesVirtual);
+        CPPUNIT_TEST(testVelocityFollowsMotion);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        SteerLibraryTest( SteerLibraryTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        SteerLibraryTest& operator=( SteerLibraryTest const& );
+        
+    private:
+        /**
+         * Tests that the behaviors taking a group of a concrete vehicle
+         * type return exactly what the @c AVGroup versions return.
+         */
+        void testStaticGroupMatchesVirtual();
+        
+        /**
+         * Tests that the boid behaviors taking proximity query records
+         * return exactly the same with static and virtual dispatch.
+         */
+        void testStaticRecordsMatchVirtual();
+        
+        /**
+         * Tests that @c steerForFlocking returns exactly the weighted sum
+         * of the separate boid behaviors, with static and virtual dispatch.
+         */
+        void testFlockingMatchesSeparateBehaviors();
+        
+        /**
+         * Tests that the path following behaviors taking a polyline pathway
+         * return exactly what the @c Pathway versions return.
+         */
+        void testPolylinePathwayMatchesVirtual();
+        
+        /**
+         * Tests that the velocity and squared speed a vehicle keeps stay
+         * equal to forward times speed through every change of either,
+         * and predict the same future position.
+         */
+        void testVelocityFollowsMotion();
+        
+    }; // SteerLibraryTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_STEERLIBRARYTEST_H
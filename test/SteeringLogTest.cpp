@@ -0,0 +1,294 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::SteeringRecorder and 
+ * @c OpenSteer::SteeringReplayer.
+ */
+#include "SteeringLogTest.h"
+
+
+// Include std::remove
+#include <cstdio>
+
+// Include std::ifstream
+#include <fstream>
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::SteeringRecorder, OpenSteer::SteeringReplayer
+#include "OpenSteer/SteeringLog.h"
+
+// Include OpenSteer::SimpleVehicle
+#include "OpenSteer/SimpleVehicle.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::SteeringLogTest );
+
+
+
+OpenSteer::SteeringLogTest::SteeringLogTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::SteeringLogTest::~SteeringLogTest()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::SteeringLogTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::SteeringLogTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    
+    char const* const fileName = "SteeringLogTest.steering";
+    
+    
+    /**
+     * @c SimpleVehicle is abstract.
+     */
+    class TestVehicle : public SimpleVehicle {
+    public:
+        TestVehicle() {
+            setMaxForce( 1.0f );
+        }
+        
+        virtual void update( float const /* currentTime */, float const elapsedTime ) {
+            applySteeringForce( steerForWander( elapsedTime ), elapsedTime );
+        }
+    }; // class TestVehicle
+    
+    
+    void makeGroup( std::vector< TestVehicle >& vehicles, AVGroup& group )
+    {
+        group.clear();
+        for ( size_t i = 0; i < vehicles.size(); ++i ) {
+            vehicles[ i ].setPosition( Vec3( static_cast< float >( i ), 0.0f, 0.0f ) );
+            group.push_back( &vehicles[ i ] );
+        }
+    }
+    
+    
+    /**
+     * Update every vehicle, except the odd ones on odd frames.
+     */
+    void updateGroup( std::vector< TestVehicle >& vehicles, int frame )
+    {
+        for ( size_t i = 0; i < vehicles.size(); ++i ) {
+            if ( ( i % 2 == 0 ) || ( frame % 2 == 0 ) ) {
+                vehicles[ i ].update( 0.0f, 0.1f );
+            }
+        }
+    }
+    
+    
+    bool samePositions( std::vector< TestVehicle > const& a, std::vector< TestVehicle > const& b )
+    {
+        for ( size_t i = 0; i < a.size(); ++i ) {
+            if ( ! ( a[ i ].position() == b[ i ].position() ) ||
+                 ! ( a[ i ].forward() == b[ i ].forward() ) ||
+                 ( a[ i ].speed() != b[ i ].speed() ) ) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::SteeringLogTest::testExactReplay()
+{
+    std::vector< TestVehicle > recorded( 4 );
+    AVGroup recordedGroup;
+    makeGroup( recorded, recordedGroup );
+    
+    SteeringRecorder recorder;
+    CPPUNIT_ASSERT( recorder.open( fileName, recordedGroup, 0 ) );
+    for ( int frame = 0; frame < 100; ++frame ) {
+        updateGroup( recorded, frame );
+        CPPUNIT_ASSERT( recorder.recordFrame( recordedGroup, 0.1f * ( frame + 1 ) ) );
+    }
+    recorder.close();
+    
+    // The replay starts from the recorded initial state, wherever its
+    // vehicles are.
+    std::vector< TestVehicle > replayed( 4 );
+    AVGroup replayedGroup;
+    makeGroup( replayed, replayedGroup );
+    replayed[ 0 ].setPosition( Vec3( 5.0f, 5.0f, 5.0f ) );
+    
+    SteeringReplayer replayer;
+    CPPUNIT_ASSERT( replayer.open( fileName ) );
+    for ( int frame = 0; frame < 100; ++frame ) {
+        CPPUNIT_ASSERT( ! replayer.atEnd() );
+        CPPUNIT_ASSERT( replayer.replayFrame( replayedGroup ) );
+    }
+    CPPUNIT_ASSERT( replayer.atEnd() );
+    CPPUNIT_ASSERT( ! replayer.replayFrame( replayedGroup ) );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 100 ), replayer.frameCount() );
+    CPPUNIT_ASSERT_EQUAL( 0.1f * 100, replayer.currentTime() );
+    
+    CPPUNIT_ASSERT( samePositions( recorded, replayed ) );
+    CPPUNIT_ASSERT( ! ( recorded[ 0 ].position() == Vec3( 0.0f, 0.0f, 0.0f ) ) );
+    
+    std::remove( fileName );
+}
+
+
+
+void 
+OpenSteer::SteeringLogTest::testKeyframes()
+{
+    std::vector< TestVehicle > recorded( 3 );
+    AVGroup recordedGroup;
+    makeGroup( recorded, recordedGroup );
+    
+    SteeringRecorder recorder;
+    CPPUNIT_ASSERT( recorder.open( fileName, recordedGroup, 20 ) );
+    for ( int frame = 0; frame < 30; ++frame ) {
+        updateGroup( recorded, frame );
+        if ( frame == 10 ) {
+            recorded[ 1 ].setPosition( recorded[ 1 ].position() + Vec3( 0.0f, 3.0f, 0.0f ) );
+        }
+        CPPUNIT_ASSERT( recorder.recordFrame( recordedGroup, 0.0f ) );
+    }
+    recorder.close();
+    
+    std::vector< TestVehicle > replayed( 3 );
+    AVGroup replayedGroup;
+    makeGroup( replayed, replayedGroup );
+    
+    SteeringReplayer replayer;
+    CPPUNIT_ASSERT( replayer.open( fileName ) );
+    for ( int frame = 0; frame < 20; ++frame ) {
+        CPPUNIT_ASSERT( replayer.replayFrame( replayedGroup ) );
+    }
+    CPPUNIT_ASSERT( ! samePositions( recorded, replayed ) );
+    
+    // The keyframe after frame 20 puts the jump in, the rest is exact.
+    for ( int frame = 20; frame < 30; ++frame ) {
+        CPPUNIT_ASSERT( replayer.replayFrame( replayedGroup ) );
+    }
+    CPPUNIT_ASSERT( samePositions( recorded, replayed ) );
+    
+    std::remove( fileName );
+}
+
+
+
+void 
+OpenSteer::SteeringLogTest::testCompression()
+{
+    size_t const vehicleCount = 10;
+    int const frameCount = 50;
+    std::vector< TestVehicle > vehicles( vehicleCount );
+    AVGroup group;
+    makeGroup( vehicles, group );
+    
+    SteeringRecorder recorder;
+    CPPUNIT_ASSERT( recorder.open( fileName, group, 0 ) );
+    for ( int frame = 0; frame < frameCount; ++frame ) {
+        for ( size_t i = 0; i < vehicleCount; ++i ) {
+            vehicles[ i ].applySteeringForce( Vec3( 0.5f, 0.0f, 0.25f ), 0.1f );
+        }
+        CPPUNIT_ASSERT( recorder.recordFrame( group, 0.0f ) );
+    }
+    recorder.close();
+    
+    std::ifstream file( fileName, std::ios::binary | std::ios::ate );
+    size_t const size = static_cast< size_t >( file.tellg() );
+    file.close();
+    
+    // After the first frame each vehicle takes a flag and four zero bytes
+    // per frame, besides the header and initial keyframe.
+    size_t const chunkHeader = 16;
+    size_t const fixed = 16 + chunkHeader + vehicleCount * sizeof( CheckpointVehicle );
+    size_t const firstFrame = chunkHeader + vehicleCount * ( 1 + 4 * 5 );
+    size_t const laterFrame = chunkHeader + vehicleCount * ( 1 + 4 );
+    CPPUNIT_ASSERT( size <= fixed + firstFrame + ( frameCount - 1 ) * laterFrame );
+    
+    std::remove( fileName );
+}
+
+
+
+void 
+OpenSteer::SteeringLogTest::testMismatch()
+{
+    std::vector< TestVehicle > vehicles( 3 );
+    AVGroup group;
+    makeGroup( vehicles, group );
+    
+    SteeringRecorder recorder;
+    CPPUNIT_ASSERT( recorder.open( fileName, group ) );
+    updateGroup( vehicles, 0 );
+    CPPUNIT_ASSERT( recorder.recordFrame( group, 0.0f ) );
+    recorder.close();
+    
+    std::vector< TestVehicle > fewer( 2 );
+    AVGroup fewerGroup;
+    makeGroup( fewer, fewerGroup );
+    SteeringReplayer replayer;
+    CPPUNIT_ASSERT( replayer.open( fileName ) );
+    CPPUNIT_ASSERT( ! replayer.replayFrame( fewerGroup ) );
+    
+    {
+        std::ofstream other( fileName, std::ios::binary | std::ios::trunc );
+        other << "not a steering log";
+    }
+    CPPUNIT_ASSERT( ! replayer.open( fileName ) );
+    CPPUNIT_ASSERT( ! replayer.isOpen() );
+    
+    std::remove( fileName );
+}
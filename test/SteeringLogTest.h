@@ -0,0 +1,106 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::SteeringRecorder and 
+ * @c OpenSteer::SteeringReplayer.
+ */
+#ifndef OPENSTEER_STEERINGLOGTEST_H
+#define OPENSTEER_STEERINGLOGTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class SteeringLogTest : public CppUnit::TestFixture {
+    public:
+        SteeringLogTest();
+        virtual ~SteeringLogTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(SteeringLogTest);
+        CPPUNIT_TEST(testExactReplay);
+        CPPUNIT_TEST(testKeyframes);
+        CPPUNIT_TEST(testCompression);
+        CPPUNIT_TEST(testMismatch);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        SteeringLogTest( SteeringLogTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        SteeringLogTest& operator=( SteeringLogTest const& );
+        
+    private:
+        /**
+         * Tests that replaying the recorded forces into vehicles starting
+         * elsewhere moves them exactly like the recorded ones, including
+         * vehicles not steered in every frame.
+         */
+        void testExactReplay();
+        
+        /**
+         * Tests that keyframes catch up with changes made to the vehicles
+         * besides steering.
+         */
+        void testKeyframes();
+        
+        /**
+         * Tests that unchanged forces take a byte per component.
+         */
+        void testCompression();
+        
+        /**
+         * Tests that logs are not replayed into groups of another size and
+         * that other files are rejected.
+         */
+        void testMismatch();
+        
+    }; // SteeringLogTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_STEERINGLOGTEST_H
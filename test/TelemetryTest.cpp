@@ -0,0 +1,241 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::TelemetryWriter and 
+ * @c OpenSteer::TelemetryReader.
+ */
+#include "TelemetryTest.h"
+
+
+// Include std::string
+#include <string>
+
+// Include std::vector
+#include <vector>
+
+// Include getpid
+#include <unistd.h>
+
+// Include OpenSteer::TelemetryWriter, OpenSteer::TelemetryReader
+#include "OpenSteer/Telemetry.h"
+
+// Include OpenSteer::SimpleVehicle
+#include "OpenSteer/SimpleVehicle.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::TelemetryTest );
+
+
+
+OpenSteer::TelemetryTest::TelemetryTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::TelemetryTest::~TelemetryTest()
+{
+    // Nothing to do.
+}
+
+
+
+void 
+OpenSteer::TelemetryTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::TelemetryTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    
+    /**
+     * @c SimpleVehicle is abstract.
+     */
+    class TestVehicle : public SimpleVehicle {
+    public:
+        virtual void update( float const /* currentTime */, float const /* elapsedTime */ ) {
+            // Nothing to do.
+        }
+    }; // class TestVehicle
+    
+    
+    /**
+     * A stream name of its own for each test run.
+     */
+    std::string streamName()
+    {
+        return "/OpenSteerTelemetryTest." + std::to_string( getpid() );
+    }
+    
+    
+    /**
+     * Vehicles at x positions 0, 1, 2... moving along z at speed 2.
+     */
+    void placeVehicles( std::vector< TestVehicle >& vehicles, AVGroup& group )
+    {
+        group.clear();
+        for ( size_t i = 0; i < vehicles.size(); ++i ) {
+            vehicles[ i ].setPosition( Vec3( static_cast< float >( i ), 0.0f, 0.0f ) );
+            vehicles[ i ].setSpeed( 2.0f );
+            group.push_back( &vehicles[ i ] );
+        }
+    }
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::TelemetryTest::testPublish()
+{
+    std::vector< TestVehicle > vehicles( 3 );
+    AVGroup group;
+    placeVehicles( vehicles, group );
+    
+    TelemetryWriter writer;
+    CPPUNIT_ASSERT( writer.open( streamName().c_str(), 8 ) );
+    
+    TelemetryReader reader;
+    CPPUNIT_ASSERT( reader.open( streamName().c_str() ) );
+    CPPUNIT_ASSERT_EQUAL( static_cast< uint64_t >( 0 ), reader.latestFrame() );
+    
+    std::vector< TelemetryRecord > records;
+    float time = 0.0f;
+    CPPUNIT_ASSERT( ! reader.readFrame( 1, records, time ) );
+    
+    writer.publish( group, 0.5f );
+    vehicles[ 1 ].setPosition( Vec3( 7.0f, 8.0f, 9.0f ) );
+    writer.publish( group, 1.0f );
+    CPPUNIT_ASSERT_EQUAL( static_cast< uint64_t >( 2 ), writer.frameCount() );
+    CPPUNIT_ASSERT_EQUAL( static_cast< uint64_t >( 2 ), reader.latestFrame() );
+    
+    CPPUNIT_ASSERT( reader.readFrame( 1, records, time ) );
+    CPPUNIT_ASSERT_EQUAL( 0.5f, time );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 3 ), records.size() );
+    CPPUNIT_ASSERT( Vec3( 1.0f, 0.0f, 0.0f ) == records[ 1 ].position );
+    
+    CPPUNIT_ASSERT( reader.readFrame( 2, records, time ) );
+    CPPUNIT_ASSERT_EQUAL( 1.0f, time );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 3 ), records.size() );
+    for ( size_t i = 0; i < records.size(); ++i ) {
+        CPPUNIT_ASSERT( vehicles[ i ].position() == records[ i ].position );
+        CPPUNIT_ASSERT( vehicles[ i ].velocity() == records[ i ].velocity );
+        CPPUNIT_ASSERT( vehicles[ i ].forward() == records[ i ].forward );
+    }
+    
+    CPPUNIT_ASSERT( ! reader.readFrame( 3, records, time ) );
+}
+
+
+
+void 
+OpenSteer::TelemetryTest::testOverwrittenFrames()
+{
+    std::vector< TestVehicle > vehicles( 2 );
+    AVGroup group;
+    placeVehicles( vehicles, group );
+    
+    TelemetryWriter writer;
+    CPPUNIT_ASSERT( writer.open( streamName().c_str(), 2, 2 ) );
+    TelemetryReader reader;
+    CPPUNIT_ASSERT( reader.open( streamName().c_str() ) );
+    
+    for ( int i = 1; i <= 5; ++i ) {
+        writer.publish( group, static_cast< float >( i ) );
+    }
+    
+    std::vector< TelemetryRecord > records;
+    float time = 0.0f;
+    CPPUNIT_ASSERT_EQUAL( static_cast< uint64_t >( 5 ), reader.latestFrame() );
+    CPPUNIT_ASSERT( ! reader.readFrame( 3, records, time ) );
+    CPPUNIT_ASSERT( reader.readFrame( 4, records, time ) );
+    CPPUNIT_ASSERT_EQUAL( 4.0f, time );
+    CPPUNIT_ASSERT( reader.readFrame( 5, records, time ) );
+    CPPUNIT_ASSERT_EQUAL( 5.0f, time );
+}
+
+
+
+void 
+OpenSteer::TelemetryTest::testCapacity()
+{
+    std::vector< TestVehicle > vehicles( 5 );
+    AVGroup group;
+    placeVehicles( vehicles, group );
+    
+    TelemetryWriter writer;
+    CPPUNIT_ASSERT( ! writer.open( streamName().c_str(), 0 ) );
+    CPPUNIT_ASSERT( writer.open( streamName().c_str(), 3 ) );
+    TelemetryReader reader;
+    CPPUNIT_ASSERT( reader.open( streamName().c_str() ) );
+    
+    writer.publish( group, 1.0f );
+    
+    std::vector< TelemetryRecord > records;
+    float time = 0.0f;
+    CPPUNIT_ASSERT( reader.readFrame( 1, records, time ) );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 3 ), records.size() );
+    CPPUNIT_ASSERT( Vec3( 2.0f, 0.0f, 0.0f ) == records[ 2 ].position );
+}
+
+
+
+void 
+OpenSteer::TelemetryTest::testClose()
+{
+    TelemetryWriter writer;
+    CPPUNIT_ASSERT( writer.open( streamName().c_str(), 1 ) );
+    CPPUNIT_ASSERT( writer.isOpen() );
+    
+    TelemetryReader reader;
+    CPPUNIT_ASSERT( reader.open( streamName().c_str() ) );
+    
+    writer.close();
+    CPPUNIT_ASSERT( ! writer.isOpen() );
+    
+    // Readers keep their mapping, but the stream can no longer be opened.
+    CPPUNIT_ASSERT_EQUAL( static_cast< uint64_t >( 0 ), reader.latestFrame() );
+    TelemetryReader lateReader;
+    CPPUNIT_ASSERT( ! lateReader.open( streamName().c_str() ) );
+}
@@ -0,0 +1,104 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::TelemetryWriter and 
+ * @c OpenSteer::TelemetryReader.
+ */
+#ifndef OPENSTEER_TELEMETRYTEST_H
+#define OPENSTEER_TELEMETRYTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class TelemetryTest : public CppUnit::TestFixture {
+    public:
+        TelemetryTest();
+        virtual ~TelemetryTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(TelemetryTest);
+        CPPUNIT_TEST(testPublish);
+        CPPUNIT_TEST(testOverwrittenFrames);
+        CPPUNIT_TEST(testCapacity);
+        CPPUNIT_TEST(testClose);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        TelemetryTest( TelemetryTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        TelemetryTest& operator=( TelemetryTest const& );
+        
+    private:
+        /**
+         * Tests that a reader sees the published frames with the vehicles'
+         * positions, velocities and headings.
+         */
+        void testPublish();
+        
+        /**
+         * Tests that frames older than the ring are no longer readable
+         * while the newer ones are.
+         */
+        void testOverwrittenFrames();
+        
+        /**
+         * Tests that only the first capacity vehicles are published.
+         */
+        void testCapacity();
+        
+        /**
+         * Tests that a closed writer removes its stream.
+         */
+        void testClose();
+        
+    }; // TelemetryTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_TELEMETRYTEST_H
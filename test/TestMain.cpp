@@ -36,6 +36,9 @@
 // Include OPENSTEER_UNUSED_PARAMETER
 #include "OpenSteer/UnusedParameter.h"
 
+// To include EXIT_SUCCESS and EXIT_FAILURE
+#include <cstdlib>
+
 
 
 int main( int argc, char* argv[] ) 
@@ -49,5 +52,5 @@ int main( int argc, char* argv[] )
     test_runner.addTest( test_factory_registry.makeTest() );
     bool successful_test = test_runner.run();
     
-    return successful_test;
+    return successful_test ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -0,0 +1,321 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::TiledHeightfield.
+ */
+#include "TiledHeightfieldTest.h"
+
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+
+// Include RayTester
+#include "../src/TerrainRayTest.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::TiledHeightfieldTest );
+
+
+
+OpenSteer::TiledHeightfieldTest::TiledHeightfieldTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::TiledHeightfieldTest::~TiledHeightfieldTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::TiledHeightfieldTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::TiledHeightfieldTest::tearDown()
+{
+    TestFixture::tearDown();
+    std::remove( "TiledHeightfieldTest.tiles" );
+}
+
+
+
+namespace {
+    
+    
+    char const* const fileName = "TiledHeightfieldTest.tiles";
+    
+    // 69 x 44 cells: neither a multiple of the 16 cell tiles
+    int const fieldWidth = 70;
+    int const fieldHeight = 45;
+    int const tileLog2 = 4;
+    
+    float const originX = -20.0f;
+    float const originZ = 5.0f;
+    float const spacingX = 2.0f;
+    float const spacingZ = 1.5f;
+    
+    
+    /**
+     * Deterministic pseudo random heights, row by row.
+     */
+    std::vector< float > makeHeights() {
+        std::vector< float > heights;
+        unsigned int state = 99;
+        for ( int i = 0; i < fieldWidth * fieldHeight; ++i ) {
+            state = state * 1664525u + 1013904223u;
+            heights.push_back( ( state >> 8 ) / float( 1 << 24 ) * 10.0f - 3.0f );
+        }
+        return heights;
+    }
+    
+    
+    float heightOf( std::vector< float > const& heights, int i, int j ) {
+        return heights[ i + j * fieldWidth ];
+    }
+    
+    
+    /**
+     * Writes the test heights and opens them.
+     */
+    void writeAndOpen( std::vector< float > const& heights, OpenSteer::TiledHeightfield& field ) {
+        CPPUNIT_ASSERT( OpenSteer::TiledHeightfield::write( fileName, fieldWidth, fieldHeight, &heights[ 0 ], 
+                                                            originX, originZ, spacingX, spacingZ, tileLog2 ) );
+        CPPUNIT_ASSERT( field.open( fileName ) );
+    }
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::TiledHeightfieldTest::testRoundTrip()
+{
+    std::vector< float > const heights = makeHeights();
+    TiledHeightfield field;
+    writeAndOpen( heights, field );
+    
+    CPPUNIT_ASSERT_EQUAL( fieldWidth, field.width() );
+    CPPUNIT_ASSERT_EQUAL( fieldHeight, field.height() );
+    CPPUNIT_ASSERT_EQUAL( 5, field.tilesX() );
+    CPPUNIT_ASSERT_EQUAL( 3, field.tilesZ() );
+    
+    for ( int j = 0; j < fieldHeight; ++j ) {
+        for ( int i = 0; i < fieldWidth; ++i ) {
+            CPPUNIT_ASSERT_EQUAL( heightOf( heights, i, j ), field.vertexHeight( i, j ) );
+            
+            float const x = originX + i * spacingX;
+            float const z = originZ + j * spacingZ;
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( heightOf( heights, i, j ), field.heightAt( x, z ), 1e-4 );
+        }
+    }
+    
+    // Tile ranges cover the tile's vertices, shared edges included.
+    for ( int tz = 0; tz < field.tilesZ(); ++tz ) {
+        for ( int tx = 0; tx < field.tilesX(); ++tx ) {
+            float low = heightOf( heights, tx * 16, tz * 16 );
+            float high = low;
+            for ( int j = tz * 16; j <= std::min( tz * 16 + 16, fieldHeight - 1 ); ++j ) {
+                for ( int i = tx * 16; i <= std::min( tx * 16 + 16, fieldWidth - 1 ); ++i ) {
+                    low = std::min( low, heightOf( heights, i, j ) );
+                    high = std::max( high, heightOf( heights, i, j ) );
+                }
+            }
+            CPPUNIT_ASSERT_EQUAL( low, field.tileMinHeight( tx, tz ) );
+            CPPUNIT_ASSERT_EQUAL( high, field.tileMaxHeight( tx, tz ) );
+        }
+    }
+    
+    // Halfway along a cell's top edge the surface is the mean of its ends.
+    float const mid = 0.5f * ( heightOf( heights, 3, 7 ) + heightOf( heights, 4, 7 ) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( mid, field.heightAt( originX + 3.5f * spacingX, originZ + 7 * spacingZ ), 1e-4 );
+}
+
+
+
+void 
+OpenSteer::TiledHeightfieldTest::testNodeMaxHeights()
+{
+    std::vector< float > const heights = makeHeights();
+    TiledHeightfield field;
+    writeAndOpen( heights, field );
+    
+    int const cellsX = fieldWidth - 1;
+    int const cellsZ = fieldHeight - 1;
+    for ( int level = 0; level <= tileLog2; ++level ) {
+        int const side = 1 << level;
+        for ( int z = 0; z * side < cellsZ; ++z ) {
+            for ( int x = 0; x * side < cellsX; ++x ) {
+                float expected = heightOf( heights, x * side, z * side );
+                for ( int j = z * side; j <= std::min( ( z + 1 ) * side, cellsZ ); ++j ) {
+                    for ( int i = x * side; i <= std::min( ( x + 1 ) * side, cellsX ); ++i ) {
+                        expected = std::max( expected, heightOf( heights, i, j ) );
+                    }
+                }
+                CPPUNIT_ASSERT_EQUAL( expected, field.nodeMaxHeight( level, x, z ) );
+            }
+        }
+    }
+}
+
+
+
+void 
+OpenSteer::TiledHeightfieldTest::testEviction()
+{
+    std::vector< float > const heights = makeHeights();
+    TiledHeightfield field;
+    writeAndOpen( heights, field );
+    CPPUNIT_ASSERT_EQUAL( 0, field.residentTileCount() );
+    
+    // Touch every tile, the first one least recently.
+    for ( int tz = 0; tz < field.tilesZ(); ++tz ) {
+        for ( int tx = 0; tx < field.tilesX(); ++tx ) {
+            field.vertexHeight( tx * 16, tz * 16 );
+        }
+    }
+    int const tileCount = field.tilesX() * field.tilesZ();
+    CPPUNIT_ASSERT_EQUAL( tileCount, field.residentTileCount() );
+    
+    size_t const tileBytes = field.residentBytes() / tileCount;
+    field.setMemoryBudget( 3 * tileBytes );
+    CPPUNIT_ASSERT_EQUAL( tileCount - 3, field.evictColdTiles() );
+    CPPUNIT_ASSERT_EQUAL( 3, field.residentTileCount() );
+    CPPUNIT_ASSERT_EQUAL( 0, field.evictColdTiles() );
+    
+    // The last tile touched stayed, the first one went.
+    field.vertexHeight( fieldWidth - 1, fieldHeight - 1 );
+    CPPUNIT_ASSERT_EQUAL( 3, field.residentTileCount() );
+    CPPUNIT_ASSERT_EQUAL( heightOf( heights, 0, 0 ), field.vertexHeight( 0, 0 ) );
+    CPPUNIT_ASSERT_EQUAL( 4, field.residentTileCount() );
+    
+    // Evicted tiles read back unchanged.
+    for ( int j = 0; j < fieldHeight; ++j ) {
+        for ( int i = 0; i < fieldWidth; ++i ) {
+            CPPUNIT_ASSERT_EQUAL( heightOf( heights, i, j ), field.vertexHeight( i, j ) );
+        }
+    }
+    
+    field.prefetch( 0.0f, 20.0f, 10.0f );
+    CPPUNIT_ASSERT_EQUAL( tileCount, field.residentTileCount() );
+}
+
+
+
+void 
+OpenSteer::TiledHeightfieldTest::testRejectsBadFiles()
+{
+    TiledHeightfield field;
+    CPPUNIT_ASSERT( ! field.open( "no such file.tiles" ) );
+    CPPUNIT_ASSERT( ! field.isOpen() );
+    
+    // A file which is not a tiled heightfield.
+    FILE* file = std::fopen( fileName, "wb" );
+    CPPUNIT_ASSERT( file != NULL );
+    char const garbage[] = "this is not a tiled heightfield, nor is it long enough to be one";
+    std::fwrite( garbage, 1, sizeof( garbage ), file );
+    std::fclose( file );
+    CPPUNIT_ASSERT( ! field.open( fileName ) );
+    
+    // A valid file cut short.
+    std::vector< float > const heights = makeHeights();
+    CPPUNIT_ASSERT( TiledHeightfield::write( fileName, fieldWidth, fieldHeight, &heights[ 0 ], 
+                                             originX, originZ, spacingX, spacingZ, tileLog2 ) );
+    std::vector< char > bytes;
+    file = std::fopen( fileName, "rb" );
+    char buffer[ 4096 ];
+    size_t n;
+    while ( ( n = std::fread( buffer, 1, sizeof( buffer ), file ) ) > 0 ) {
+        bytes.insert( bytes.end(), buffer, buffer + n );
+    }
+    std::fclose( file );
+    file = std::fopen( fileName, "wb" );
+    std::fwrite( &bytes[ 0 ], 1, bytes.size() - 1, file );
+    std::fclose( file );
+    CPPUNIT_ASSERT( ! field.open( fileName ) );
+}
+
+
+
+void 
+OpenSteer::TiledHeightfieldTest::testRayTesterOnTiles()
+{
+    std::vector< float > const heights = makeHeights();
+    TiledHeightfield field;
+    writeAndOpen( heights, field );
+    
+    std::vector< float > verts;
+    for ( int j = 0; j < fieldHeight; ++j ) {
+        for ( int i = 0; i < fieldWidth; ++i ) {
+            verts.push_back( originX + i * spacingX );
+            verts.push_back( heightOf( heights, i, j ) );
+            verts.push_back( originZ + j * spacingZ );
+        }
+    }
+    RayTester inMemory;
+    inMemory.SetData( fieldWidth, fieldHeight, &verts[ 0 ] );
+    RayTester tiled;
+    tiled.SetTiles( &field );
+    
+    unsigned int state = 7;
+    int hits = 0;
+    for ( int r = 0; r < 2000; ++r ) {
+        TRTScalar values[ 6 ];
+        for ( int c = 0; c < 6; ++c ) {
+            state = state * 1664525u + 1013904223u;
+            values[ c ] = ( state >> 8 ) / TRTScalar( 1 << 24 );
+        }
+        TRTScalar const eye[ 3 ] = { -30 + 160 * values[ 0 ], -5 + 20 * values[ 1 ], -5 + 80 * values[ 2 ] };
+        TRTScalar const dir[ 3 ] = { 2 * values[ 3 ] - 1, 2 * values[ 4 ] - 1, 2 * values[ 5 ] - 1 };
+        
+        RayTestInfo expected, result;
+        inMemory.RayCast( expected, eye, dir );
+        tiled.RayCast( result, eye, dir );
+        CPPUNIT_ASSERT_EQUAL( expected.hitOccurred, result.hitOccurred );
+        if ( expected.hitOccurred ) {
+            ++hits;
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.t, result.t, 1e-6 );
+            for ( int c = 0; c < 3; ++c ) {
+                CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.norm[ c ], result.norm[ c ], 1e-6 );
+            }
+        }
+    }
+    CPPUNIT_ASSERT( hits > 200 );
+}
@@ -0,0 +1,115 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::TiledHeightfield.
+ */
+#ifndef OPENSTEER_TILEDHEIGHTFIELDTEST_H
+#define OPENSTEER_TILEDHEIGHTFIELDTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::TiledHeightfield
+#include "OpenSteer/TiledHeightfield.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class TiledHeightfieldTest : public CppUnit::TestFixture {
+    public:
+        TiledHeightfieldTest();
+        virtual ~TiledHeightfieldTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(TiledHeightfieldTest);
+        CPPUNIT_TEST(testRoundTrip);
+        CPPUNIT_TEST(testNodeMaxHeights);
+        CPPUNIT_TEST(testEviction);
+        CPPUNIT_TEST(testRejectsBadFiles);
+        CPPUNIT_TEST(testRayTesterOnTiles);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        TiledHeightfieldTest( TiledHeightfieldTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        TiledHeightfieldTest& operator=( TiledHeightfieldTest const& );
+        
+    private:
+        /**
+         * Tests that written heights, tile ranges and surface heights read
+         * back from the mapped file, for a grid which does not fill its 
+         * last tiles.
+         */
+        void testRoundTrip();
+        
+        /**
+         * Tests the tiles' max height quadtrees against the max of the 
+         * cells each node covers.
+         */
+        void testNodeMaxHeights();
+        
+        /**
+         * Tests that touched tiles count as resident and that eviction 
+         * releases the least recently used ones down to the budget, 
+         * without changing what queries return.
+         */
+        void testEviction();
+        
+        /**
+         * Tests that missing and malformed files do not open.
+         */
+        void testRejectsBadFiles();
+        
+        /**
+         * Tests that a @c RayTester casting against the tiles finds the 
+         * same hits as one built from the same heights in memory.
+         */
+        void testRayTesterOnTiles();
+        
+    }; // TiledHeightfieldTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_TILEDHEIGHTFIELDTEST_H
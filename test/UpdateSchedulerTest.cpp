@@ -0,0 +1,328 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::UpdateScheduler.
+ */
+#include "UpdateSchedulerTest.h"
+
+
+// Include std::reverse, std::swap
+#include <algorithm>
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::UpdateScheduler
+#include "OpenSteer/UpdateScheduler.h"
+
+// Include OpenSteer::Vec3
+#include "OpenSteer/Vec3.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::UpdateSchedulerTest );
+
+
+
+OpenSteer::UpdateSchedulerTest::UpdateSchedulerTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::UpdateSchedulerTest::~UpdateSchedulerTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::UpdateSchedulerTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::UpdateSchedulerTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    
+    /**
+     * @a count agents along the x axis, one unit apart, starting at the
+     * origin.
+     */
+    std::vector< OpenSteer::Vec3 > makeRow( std::size_t count )
+    {
+        std::vector< OpenSteer::Vec3 > positions;
+        for ( std::size_t i = 0; i < count; ++i ) {
+            positions.push_back( OpenSteer::Vec3( float( i ), 0.0f, 0.0f ) );
+        }
+        return positions;
+    }
+    
+    
+    float const dt = 0.25f;
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::UpdateSchedulerTest::testWithoutBandsAllAreDue()
+{
+    std::vector< Vec3 > const positions = makeRow( 10 );
+    UpdateScheduler scheduler;
+    scheduler.addFocus( Vec3::zero );
+    
+    for ( int frame = 0; frame < 3; ++frame ) {
+        scheduler.schedule( &positions[ 0 ], positions.size(), dt );
+        CPPUNIT_ASSERT_EQUAL( positions.size(), scheduler.dueAgents().size() );
+        for ( std::size_t i = 0; i < positions.size(); ++i ) {
+            CPPUNIT_ASSERT( scheduler.isDue( i ) );
+            CPPUNIT_ASSERT_EQUAL( dt, scheduler.elapsedTime( i ) );
+            CPPUNIT_ASSERT_EQUAL( i, scheduler.dueAgents()[ i ] );
+        }
+    }
+}
+
+
+
+void 
+OpenSteer::UpdateSchedulerTest::testBandsAccumulateElapsedTime()
+{
+    // agents 0..4 every frame, 5..9 every other frame, the rest every 4th
+    std::vector< Vec3 > const positions = makeRow( 20 );
+    UpdateScheduler scheduler;
+    scheduler.addBand( 9.5f, 2 );
+    scheduler.addBand( 4.5f, 1 );
+    scheduler.addBand( 100.0f, 4 );
+    scheduler.addFocus( Vec3::zero );
+    
+    std::vector< float > simulated( positions.size(), 0.0f );
+    std::vector< int > updates( positions.size(), 0 );
+    int const frames = 8;
+    for ( int frame = 0; frame < frames; ++frame ) {
+        scheduler.schedule( &positions[ 0 ], positions.size(), dt );
+        for ( std::size_t i = 0; i < positions.size(); ++i ) {
+            if ( scheduler.isDue( i ) ) {
+                simulated[ i ] += scheduler.elapsedTime( i );
+                ++updates[ i ];
+            }
+        }
+    }
+    
+    for ( std::size_t i = 0; i < positions.size(); ++i ) {
+        int const band = i < 5 ? 0 : ( i < 10 ? 1 : 2 );
+        int const period = 1 << band;
+        CPPUNIT_ASSERT_EQUAL( band, scheduler.band( i ) );
+        CPPUNIT_ASSERT_EQUAL( frames / period, updates[ i ] );
+        
+        // whatever was simulated lags the frames by less than a period
+        float const lag = frames * dt - simulated[ i ];
+        CPPUNIT_ASSERT( lag >= 0.0f );
+        CPPUNIT_ASSERT( lag < period * dt );
+    }
+}
+
+
+
+void 
+OpenSteer::UpdateSchedulerTest::testBandScale()
+{
+    // agents 0..4 in the near band, until it is halved to reach 0..2
+    std::vector< Vec3 > const positions = makeRow( 10 );
+    UpdateScheduler scheduler;
+    scheduler.addBand( 4.5f, 1 );
+    scheduler.addBand( 100.0f, 2 );
+    scheduler.addFocus( Vec3::zero );
+    
+    scheduler.setBandScale( 0.5f );
+    scheduler.schedule( &positions[ 0 ], positions.size(), dt );
+    for ( std::size_t i = 0; i < positions.size(); ++i ) {
+        CPPUNIT_ASSERT_EQUAL( i < 3 ? 0 : 1, scheduler.band( i ) );
+    }
+    
+    scheduler.setBandScale( 1.0f );
+    scheduler.schedule( &positions[ 0 ], positions.size(), dt );
+    for ( std::size_t i = 0; i < positions.size(); ++i ) {
+        CPPUNIT_ASSERT_EQUAL( i < 5 ? 0 : 1, scheduler.band( i ) );
+    }
+}
+
+
+
+void 
+OpenSteer::UpdateSchedulerTest::testLoadIsFlat()
+{
+    // all agents are beyond the only band, so in its 4 frame period
+    std::vector< Vec3 > const positions = makeRow( 40 );
+    UpdateScheduler scheduler;
+    scheduler.addBand( 0.0f, 4 );
+    scheduler.addFocus( Vec3( -1.0f, 0.0f, 0.0f ) );
+    
+    for ( int frame = 0; frame < 8; ++frame ) {
+        scheduler.schedule( &positions[ 0 ], positions.size(), dt );
+        CPPUNIT_ASSERT_EQUAL( std::size_t( 10 ), scheduler.dueAgents().size() );
+    }
+}
+
+
+
+void 
+OpenSteer::UpdateSchedulerTest::testMaxStaleness()
+{
+    std::vector< Vec3 > const positions = makeRow( 8 );
+    UpdateScheduler scheduler;
+    scheduler.addBand( 0.0f, 8 );
+    scheduler.setMaxStaleness( 3 * dt );
+    scheduler.addFocus( Vec3( -1.0f, 0.0f, 0.0f ) );
+    
+    std::vector< int > sinceUpdate( positions.size(), 0 );
+    for ( int frame = 0; frame < 16; ++frame ) {
+        scheduler.schedule( &positions[ 0 ], positions.size(), dt );
+        for ( std::size_t i = 0; i < positions.size(); ++i ) {
+            ++sinceUpdate[ i ];
+            if ( scheduler.isDue( i ) ) {
+                CPPUNIT_ASSERT( scheduler.elapsedTime( i ) <= 3 * dt );
+                sinceUpdate[ i ] = 0;
+            }
+            CPPUNIT_ASSERT( sinceUpdate[ i ] < 3 );
+        }
+    }
+}
+
+
+
+void 
+OpenSteer::UpdateSchedulerTest::testSleeping()
+{
+    // agents 10 apart: only the last one keeps moving
+    std::vector< Vec3 > positions = makeRow( 10 );
+    for ( std::size_t i = 0; i < positions.size(); ++i ) {
+        positions[ i ] *= 10.0f;
+    }
+    UpdateScheduler scheduler;
+    scheduler.setSleeping( 0.1f, 0.1f, 3, 2.0f );
+    CPPUNIT_ASSERT( scheduler.sleepingIsOn() );
+    
+    for ( int frame = 0; frame < 3; ++frame ) {
+        scheduler.schedule( &positions[ 0 ], positions.size(), dt );
+        CPPUNIT_ASSERT_EQUAL( positions.size(), scheduler.dueAgents().size() );
+        for ( std::size_t i = 0; i < positions.size(); ++i ) {
+            bool const moving = ( 9 == i );
+            scheduler.noteActivity( i, moving ? 1.0f : 0.05f, 0.0f );
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 9 ), scheduler.sleepingCount() );
+    
+    // only the moving agent is due
+    scheduler.schedule( &positions[ 0 ], positions.size(), dt );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 1 ), scheduler.dueAgents().size() );
+    CPPUNIT_ASSERT( scheduler.isDue( 9 ) );
+    CPPUNIT_ASSERT( scheduler.isAsleep( 8 ) );
+    CPPUNIT_ASSERT_EQUAL( 0.0f, scheduler.elapsedTime( 8 ) );
+    
+    // it comes near agent 4, which wakes and is due the same frame
+    positions[ 9 ] = positions[ 4 ] + Vec3( 1.0f, 0.0f, 0.0f );
+    scheduler.schedule( &positions[ 0 ], positions.size(), dt );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 2 ), scheduler.dueAgents().size() );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 4 ), scheduler.dueAgents()[ 0 ] );
+    CPPUNIT_ASSERT_EQUAL( dt, scheduler.elapsedTime( 4 ) );
+    CPPUNIT_ASSERT( ! scheduler.isAsleep( 4 ) );
+    
+    // a resting agent next to sleeping ones does not wake them
+    scheduler.noteActivity( 9, 0.0f, 0.0f );
+    scheduler.noteActivity( 4, 0.0f, 0.0f );
+    positions[ 9 ] = positions[ 3 ];
+    scheduler.schedule( &positions[ 0 ], positions.size(), dt );
+    CPPUNIT_ASSERT( scheduler.isAsleep( 3 ) );
+    
+    // woken from outside
+    scheduler.wake( 0 );
+    scheduler.schedule( &positions[ 0 ], positions.size(), dt );
+    CPPUNIT_ASSERT( scheduler.isDue( 0 ) );
+    
+    // and all of them when sleeping is turned off
+    scheduler.setSleeping( 0.0f, 0.0f, 0, 0.0f );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 0 ), scheduler.sleepingCount() );
+    scheduler.schedule( &positions[ 0 ], positions.size(), dt );
+    CPPUNIT_ASSERT_EQUAL( positions.size(), scheduler.dueAgents().size() );
+}
+
+
+
+void 
+OpenSteer::UpdateSchedulerTest::testReorderAgents()
+{
+    // only agent 9 keeps moving, the others fall asleep
+    std::vector< Vec3 > positions = makeRow( 10 );
+    for ( std::size_t i = 0; i < positions.size(); ++i ) {
+        positions[ i ] *= 10.0f;
+    }
+    UpdateScheduler scheduler;
+    scheduler.setSleeping( 0.1f, 0.1f, 3, 0.0f );
+    for ( int frame = 0; frame < 3; ++frame ) {
+        scheduler.schedule( &positions[ 0 ], positions.size(), dt );
+        for ( std::size_t i = 0; i < positions.size(); ++i ) {
+            scheduler.noteActivity( i, ( 9 == i ) ? 1.0f : 0.0f, 0.0f );
+        }
+    }
+    CPPUNIT_ASSERT( ! scheduler.isAsleep( 9 ) );
+    CPPUNIT_ASSERT( scheduler.isAsleep( 0 ) );
+    
+    scheduler.swapAgents( 0, 9 );
+    std::swap( positions[ 0 ], positions[ 9 ] );
+    CPPUNIT_ASSERT( ! scheduler.isAsleep( 0 ) );
+    CPPUNIT_ASSERT( scheduler.isAsleep( 9 ) );
+    scheduler.schedule( &positions[ 0 ], positions.size(), dt );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 1 ), scheduler.dueAgents().size() );
+    CPPUNIT_ASSERT( scheduler.isDue( 0 ) );
+    
+    // reversed, the moving agent is the last again
+    std::vector< std::size_t > order( positions.size() );
+    for ( std::size_t i = 0; i < order.size(); ++i ) {
+        order[ i ] = order.size() - 1 - i;
+    }
+    scheduler.reorderAgents( order );
+    std::reverse( positions.begin(), positions.end() );
+    CPPUNIT_ASSERT( ! scheduler.isAsleep( 9 ) );
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 9 ), scheduler.sleepingCount() );
+    scheduler.schedule( &positions[ 0 ], positions.size(), dt );
+    CPPUNIT_ASSERT( scheduler.isDue( 9 ) );
+}
@@ -0,0 +1,122 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::UpdateScheduler.
+ */
+#ifndef OPENSTEER_UPDATESCHEDULERTEST_H
+#define OPENSTEER_UPDATESCHEDULERTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class UpdateSchedulerTest : public CppUnit::TestFixture {
+    public:
+        UpdateSchedulerTest();
+        virtual ~UpdateSchedulerTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(UpdateSchedulerTest);
+        CPPUNIT_TEST(testWithoutBandsAllAreDue);
+        CPPUNIT_TEST(testBandsAccumulateElapsedTime);
+        CPPUNIT_TEST(testBandScale);
+        CPPUNIT_TEST(testLoadIsFlat);
+        CPPUNIT_TEST(testMaxStaleness);
+        CPPUNIT_TEST(testSleeping);
+        CPPUNIT_TEST(testReorderAgents);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        UpdateSchedulerTest( UpdateSchedulerTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        UpdateSchedulerTest& operator=( UpdateSchedulerTest const& );
+        
+    private:
+        /**
+         * Tests that without bands every agent is due every frame with the
+         * frame's elapsed time.
+         */
+        void testWithoutBandsAllAreDue();
+        
+        /**
+         * Tests that agents are due once per period of their band, and
+         * that their elapsed times add up to the time simulated.
+         */
+        void testBandsAccumulateElapsedTime();
+        
+        /**
+         * Tests that scaling the bands moves agents into farther bands,
+         * and scaling back restores them.
+         */
+        void testBandScale();
+        
+        /**
+         * Tests that the updates of a band are spread evenly over frames.
+         */
+        void testLoadIsFlat();
+        
+        /**
+         * Tests that the maximum staleness overrides long band periods.
+         */
+        void testMaxStaleness();
+        
+        /**
+         * Tests that agents at rest fall asleep and are not due, and that
+         * active agents nearby, @c wake and turning sleeping off wake them.
+         */
+        void testSleeping();
+        
+        /**
+         * Tests that @c swapAgents and @c reorderAgents move per agent
+         * state with the agents.
+         */
+        void testReorderAgents();
+        
+    }; // UpdateSchedulerTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_UPDATESCHEDULERTEST_H
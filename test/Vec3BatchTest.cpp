@@ -0,0 +1,255 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for the @c OpenSteer::Vec3Batch operations.
+ */
+#include "Vec3BatchTest.h"
+
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::Vec3BatchTest );
+
+
+
+OpenSteer::Vec3BatchTest::Vec3BatchTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::Vec3BatchTest::~Vec3BatchTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::Vec3BatchTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::Vec3BatchTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    /**
+     * Counts below, at and above multiples of the 4 and 8 lane widths.
+     */
+    size_t const counts[] = { 0, 1, 3, 4, 5, 7, 8, 9, 16, 17, 100 };
+    size_t const countCount = sizeof( counts ) / sizeof( counts[ 0 ] );
+    
+    /**
+     * Fills @a batch with @a count deterministic, varied vectors.
+     */
+    void fill( Vec3Batch& batch, size_t count ) {
+        batch.clear();
+        for ( size_t i = 0; i < count; ++i ) {
+            float const t = 0.37f * i;
+            batch.push_back( Vec3( 10.0f * t - 3.0f, ( i % 3 ) * -2.5f, 1.0f / ( 1.0f + t ) ) );
+        }
+    }
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::Vec3BatchTest::testInstructionSet()
+{
+    char const* const name = vec3BatchInstructionSet();
+    CPPUNIT_ASSERT( 0 != name );
+    CPPUNIT_ASSERT( 0 < std::strlen( name ) );
+}
+
+
+
+void 
+OpenSteer::Vec3BatchTest::testDistanceSquared()
+{
+    Vec3 const point( 1.5f, -2.0f, 0.25f );
+    
+    for ( size_t c = 0; c < countCount; ++c ) {
+        Vec3Batch batch;
+        fill( batch, counts[ c ] );
+        std::vector< float > result( counts[ c ] + 1, -1.0f );
+        batch.distanceSquared( point, &result[ 0 ] );
+        
+        for ( size_t i = 0; i < counts[ c ]; ++i ) {
+            CPPUNIT_ASSERT_EQUAL( ( batch.get( i ) - point ).lengthSquared(), result[ i ] );
+        }
+        
+        // Nothing is written past the end.
+        CPPUNIT_ASSERT_EQUAL( -1.0f, result[ counts[ c ] ] );
+    }
+}
+
+
+
+void 
+OpenSteer::Vec3BatchTest::testDot()
+{
+    Vec3 const v( 0.5f, 3.0f, -1.25f );
+    
+    for ( size_t c = 0; c < countCount; ++c ) {
+        Vec3Batch batch;
+        fill( batch, counts[ c ] );
+        std::vector< float > result( counts[ c ] + 1, -1.0f );
+        batch.dot( v, &result[ 0 ] );
+        
+        for ( size_t i = 0; i < counts[ c ]; ++i ) {
+            CPPUNIT_ASSERT_EQUAL( v.dot( batch.get( i ) ), result[ i ] );
+        }
+    }
+}
+
+
+
+void 
+OpenSteer::Vec3BatchTest::testNormalize()
+{
+    for ( size_t c = 0; c < countCount; ++c ) {
+        Vec3Batch batch;
+        fill( batch, counts[ c ] );
+        if ( counts[ c ] > 2 ) {
+            batch.set( 2, Vec3::zero );
+        }
+        Vec3Batch expected = batch;
+        
+        batch.normalize();
+        
+        for ( size_t i = 0; i < counts[ c ]; ++i ) {
+            Vec3 const e = expected.get( i ).normalize();
+            Vec3 const r = batch.get( i );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( e.x, r.x, 0.000001f );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( e.y, r.y, 0.000001f );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( e.z, r.z, 0.000001f );
+        }
+    }
+}
+
+
+
+void 
+OpenSteer::Vec3BatchTest::testSumOfOffsets()
+{
+    Vec3 const point( -4.0f, 1.0f, 2.0f );
+    
+    for ( size_t c = 0; c < countCount; ++c ) {
+        Vec3Batch batch;
+        fill( batch, counts[ c ] );
+        
+        Vec3 expected;
+        for ( size_t i = 0; i < counts[ c ]; ++i ) {
+            expected += batch.get( i ) - point;
+        }
+        
+        Vec3 const result = batch.sumOfOffsets( point );
+        float const tolerance = 0.0001f * ( 1.0f + expected.length() );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.x, result.x, tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.y, result.y, tolerance );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.z, result.z, tolerance );
+    }
+}
+
+
+
+void 
+OpenSteer::Vec3BatchTest::testNearestApproachMany()
+{
+    Vec3 const position( -4.0f, 1.0f, 2.0f );
+    Vec3 const velocity( 1.5f, 0.0f, -0.5f );
+    
+    for ( size_t c = 0; c < countCount; ++c ) {
+        size_t const count = counts[ c ];
+        Vec3Batch positions;
+        Vec3Batch velocities;
+        fill( positions, count );
+        fill( velocities, count );
+        if ( count > 2 ) {
+            velocities.set( 2, velocity );
+        }
+        
+        std::vector< float > x( count + 1 ), y( count + 1 ), z( count + 1 );
+        std::vector< float > u( count + 1 ), v( count + 1 ), w( count + 1 );
+        for ( size_t i = 0; i < count; ++i ) {
+            Vec3 const p = positions.get( i );
+            Vec3 const q = velocities.get( i ) - Vec3( 0.5f, 0.0f, 0.0f );
+            x[ i ] = p.x; y[ i ] = p.y; z[ i ] = p.z;
+            u[ i ] = q.x; v[ i ] = q.y; w[ i ] = q.z;
+        }
+        
+        std::vector< float > time( count + 1, -1.0f );
+        std::vector< float > distance( count + 1, -1.0f );
+        nearestApproachMany( position, velocity,
+                             &x[ 0 ], &y[ 0 ], &z[ 0 ], &u[ 0 ], &v[ 0 ], &w[ 0 ],
+                             count, &time[ 0 ], &distance[ 0 ] );
+        
+        for ( size_t i = 0; i < count; ++i ) {
+            Vec3 const otherPosition( x[ i ], y[ i ], z[ i ] );
+            Vec3 const otherVelocity( u[ i ], v[ i ], w[ i ] );
+            Vec3 const relVelocity = otherVelocity - velocity;
+            float const relSpeed = relVelocity.length();
+            float expectedTime = 0.0f;
+            if ( relSpeed != 0.0f ) {
+                Vec3 const relTangent = relVelocity / relSpeed;
+                float const projection = relTangent.dot( position - otherPosition );
+                expectedTime = projection / relSpeed;
+            }
+            float const expectedDistance = 
+                Vec3::distance( position + velocity * expectedTime, 
+                                otherPosition + otherVelocity * expectedTime );
+            
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( expectedTime, time[ i ], 
+                                          0.0001f * ( 1.0f + std::fabs( expectedTime ) ) );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( expectedDistance, distance[ i ], 
+                                          0.0001f * ( 1.0f + expectedDistance ) );
+        }
+        
+        // Nothing is written past the end.
+        CPPUNIT_ASSERT_EQUAL( -1.0f, time[ count ] );
+        CPPUNIT_ASSERT_EQUAL( -1.0f, distance[ count ] );
+    }
+}
@@ -0,0 +1,119 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for the @c OpenSteer::Vec3Batch operations.
+ */
+#ifndef OPENSTEER_VEC3BATCHTEST_H
+#define OPENSTEER_VEC3BATCHTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::Vec3Batch
+#include "OpenSteer/Vec3Batch.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class Vec3BatchTest : public CppUnit::TestFixture {
+    public:
+        Vec3BatchTest();
+        virtual ~Vec3BatchTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(Vec3BatchTest);
+        CPPUNIT_TEST(testInstructionSet);
+        CPPUNIT_TEST(testDistanceSquared);
+        CPPUNIT_TEST(testDot);
+        CPPUNIT_TEST(testNormalize);
+        CPPUNIT_TEST(testSumOfOffsets);
+        CPPUNIT_TEST(testNearestApproachMany);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        Vec3BatchTest( Vec3BatchTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        Vec3BatchTest& operator=( Vec3BatchTest const& );
+        
+    private:
+        /**
+         * Tests that an instruction set name is reported.
+         */
+        void testInstructionSet();
+        
+        /**
+         * Tests @c distanceSquaredMany against @c Vec3::lengthSquared for
+         * counts around multiples of the SIMD width.
+         */
+        void testDistanceSquared();
+        
+        /**
+         * Tests @c dotMany against @c Vec3::dot.
+         */
+        void testDot();
+        
+        /**
+         * Tests @c normalizeMany against @c Vec3::normalize, including zero
+         * length vectors.
+         */
+        void testNormalize();
+        
+        /**
+         * Tests @c sumOfOffsets against a sequential sum of offsets.
+         */
+        void testSumOfOffsets();
+        
+        /**
+         * Tests @c nearestApproachMany against the sequential nearest
+         * approach computation, including a vehicle moving exactly like
+         * the reference one.
+         */
+        void testNearestApproachMany();
+        
+    }; // Vec3BatchTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_VEC3BATCHTEST_H
@@ -0,0 +1,288 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::VehiclePopulation.
+ */
+#include "VehiclePopulationTest.h"
+
+
+#include <cmath>
+#include <vector>
+
+
+// Include OpenSteer::PlanarVehicle
+#include "OpenSteer/PlanarVehicle.h"
+
+// Include OpenSteer::SimpleVehicle
+#include "OpenSteer/SimpleVehicle.h"
+
+// Include OpenSteer::WorkerPool
+#include "OpenSteer/WorkerPool.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::VehiclePopulationTest );
+
+
+
+OpenSteer::VehiclePopulationTest::VehiclePopulationTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::VehiclePopulationTest::~VehiclePopulationTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::VehiclePopulationTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::VehiclePopulationTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    using namespace OpenSteer;
+    
+    float const tolerance = 0.0001f;
+    
+    /**
+     * A concrete @c SimpleVehicle which is only moved by the test.
+     */
+    class TestVehicle : public SimpleVehicle {
+    public:
+        virtual void update( float const /* currentTime */, float const /* elapsedTime */ ) {
+            // Nothing to do.
+        }
+    }; // class TestVehicle
+    
+    
+    /**
+     * A @c TestVehicle which regenerates its local space by banking.
+     */
+    class BankingVehicle : public TestVehicle {
+    public:
+        virtual void regenerateLocalSpace( Vec3 const& newVelocity, float const elapsedTime ) {
+            regenerateLocalSpaceForBanking( newVelocity, elapsedTime );
+        }
+    }; // class BankingVehicle
+    
+    
+    /**
+     * A concrete @c PlanarVehicle which is only moved by the test.
+     */
+    class TestPlanarVehicle : public PlanarVehicle {
+    public:
+        virtual void update( float const /* currentTime */, float const /* elapsedTime */ ) {
+            // Nothing to do.
+        }
+    }; // class TestPlanarVehicle
+    
+    
+    /**
+     * Deterministic steering force for vehicle @a i at step @a step.
+     */
+    Vec3 testForce( size_t i, int step ) {
+        float const t = 0.1f * step + 0.7f * i;
+        return Vec3( std::sin( t ), 0.3f * std::cos( 1.3f * t ), std::cos( t ) ) * ( 0.05f + 0.02f * i );
+    }
+    
+    
+    bool equalVectors( Vec3 const& lhs, Vec3 const& rhs ) {
+        return ( lhs - rhs ).length() <= tolerance;
+    }
+    
+    
+    /**
+     * Configures vehicle @a i with its own limits and a starting state.
+     */
+    void configure( SimpleVehicle& vehicle, size_t i ) {
+        vehicle.setMass( 1.0f + 0.5f * i );
+        vehicle.setMaxForce( 0.1f + 0.05f * i );
+        vehicle.setMaxSpeed( 0.5f + 0.25f * i );
+        vehicle.setRadius( 0.25f * ( i + 1 ) );
+        vehicle.setSpeed( 0.1f * i );
+        vehicle.setPosition( Vec3( 1.0f * i, 0.0f, -2.0f * i ) );
+    }
+    
+    
+    /**
+     * Steps @a vehicles and a population loaded from them side by side and
+     * checks that their state stays equal.
+     */
+    template< class Vehicle >
+    void checkMatchesSimpleVehicle( VehiclePopulation::LocalSpaceMode mode ) {
+        size_t const count = 5;
+        float const elapsedTime = 1.0f / 60.0f;
+        
+        std::vector< Vehicle > vehicles( count );
+        VehiclePopulation population( mode );
+        for ( size_t i = 0; i < count; ++i ) {
+            configure( vehicles[ i ], i );
+            population.add( vehicles[ i ] );
+        }
+        
+        WorkerPool pool( 2 );
+        std::vector< Vec3 > forces( count );
+        for ( int step = 0; step < 300; ++step ) {
+            for ( size_t i = 0; i < count; ++i ) {
+                forces[ i ] = testForce( i, step );
+                vehicles[ i ].applySteeringForce( forces[ i ], elapsedTime );
+            }
+            
+            if ( 0 == step % 2 ) {
+                population.applySteeringForces( &forces[ 0 ], elapsedTime );
+            } else {
+                population.applySteeringForces( &forces[ 0 ], elapsedTime, pool );
+            }
+            
+            for ( size_t i = 0; i < count; ++i ) {
+                CPPUNIT_ASSERT( equalVectors( vehicles[ i ].position(), population.position( i ) ) );
+                CPPUNIT_ASSERT( equalVectors( vehicles[ i ].forward(), population.forward( i ) ) );
+                CPPUNIT_ASSERT( equalVectors( vehicles[ i ].side(), population.side( i ) ) );
+                CPPUNIT_ASSERT( equalVectors( vehicles[ i ].up(), population.up( i ) ) );
+                CPPUNIT_ASSERT( equalVectors( vehicles[ i ].smoothedAcceleration(), population.smoothedAcceleration( i ) ) );
+                CPPUNIT_ASSERT( equalVectors( vehicles[ i ].smoothedPosition(), population.smoothedPosition( i ) ) );
+                CPPUNIT_ASSERT_DOUBLES_EQUAL( vehicles[ i ].speed(), population.speed( i ), tolerance );
+            }
+        }
+    }
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::VehiclePopulationTest::testAddLoadStore()
+{
+    TestVehicle reset;
+    VehiclePopulation population;
+    
+    size_t const first = population.add();
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), first );
+    CPPUNIT_ASSERT( reset.position() == population.position( first ) );
+    CPPUNIT_ASSERT( reset.forward() == population.forward( first ) );
+    CPPUNIT_ASSERT( reset.side() == population.side( first ) );
+    CPPUNIT_ASSERT( reset.up() == population.up( first ) );
+    CPPUNIT_ASSERT_EQUAL( reset.speed(), population.speed( first ) );
+    CPPUNIT_ASSERT_EQUAL( reset.mass(), population.mass( first ) );
+    CPPUNIT_ASSERT_EQUAL( reset.maxForce(), population.maxForce( first ) );
+    CPPUNIT_ASSERT_EQUAL( reset.maxSpeed(), population.maxSpeed( first ) );
+    CPPUNIT_ASSERT_EQUAL( reset.radius(), population.radius( first ) );
+    
+    TestVehicle vehicle;
+    configure( vehicle, 3 );
+    vehicle.regenerateOrthonormalBasis( Vec3( 1.0f, 0.0f, 1.0f ) );
+    vehicle.resetSmoothedAcceleration( Vec3( 0.1f, 0.2f, 0.3f ) );
+    vehicle.resetSmoothedPosition( Vec3( 4.0f, 5.0f, 6.0f ) );
+    size_t const second = population.add( vehicle );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), second );
+    CPPUNIT_ASSERT_EQUAL( size_t( 2 ), population.size() );
+    
+    TestVehicle copy;
+    population.store( second, copy );
+    CPPUNIT_ASSERT( vehicle.position() == copy.position() );
+    CPPUNIT_ASSERT( vehicle.forward() == copy.forward() );
+    CPPUNIT_ASSERT( vehicle.side() == copy.side() );
+    CPPUNIT_ASSERT( vehicle.up() == copy.up() );
+    CPPUNIT_ASSERT( vehicle.velocity() == copy.velocity() );
+    CPPUNIT_ASSERT( vehicle.smoothedAcceleration() == copy.smoothedAcceleration() );
+    CPPUNIT_ASSERT( vehicle.smoothedPosition() == copy.smoothedPosition() );
+    CPPUNIT_ASSERT_EQUAL( vehicle.mass(), copy.mass() );
+    CPPUNIT_ASSERT_EQUAL( vehicle.maxForce(), copy.maxForce() );
+    CPPUNIT_ASSERT_EQUAL( vehicle.maxSpeed(), copy.maxSpeed() );
+    CPPUNIT_ASSERT_EQUAL( vehicle.radius(), copy.radius() );
+}
+
+
+
+void 
+OpenSteer::VehiclePopulationTest::testRemove()
+{
+    VehiclePopulation population;
+    for ( size_t i = 0; i < 4; ++i ) {
+        TestVehicle vehicle;
+        configure( vehicle, i );
+        population.add( vehicle );
+    }
+    
+    Vec3 const lastPosition = population.position( 3 );
+    float const lastMass = population.mass( 3 );
+    
+    population.remove( 1 );
+    CPPUNIT_ASSERT_EQUAL( size_t( 3 ), population.size() );
+    CPPUNIT_ASSERT( lastPosition == population.position( 1 ) );
+    CPPUNIT_ASSERT_EQUAL( lastMass, population.mass( 1 ) );
+    
+    population.remove( 2 );
+    CPPUNIT_ASSERT_EQUAL( size_t( 2 ), population.size() );
+    CPPUNIT_ASSERT( lastPosition == population.position( 1 ) );
+    
+    population.clear();
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), population.size() );
+}
+
+
+
+void 
+OpenSteer::VehiclePopulationTest::testMatchesSimpleVehicle()
+{
+    checkMatchesSimpleVehicle< TestVehicle >( VehiclePopulation::alignWithVelocity );
+}
+
+
+
+void 
+OpenSteer::VehiclePopulationTest::testMatchesSimpleVehicleBanking()
+{
+    checkMatchesSimpleVehicle< BankingVehicle >( VehiclePopulation::banking );
+}
+
+
+
+void 
+OpenSteer::VehiclePopulationTest::testMatchesPlanarVehicle()
+{
+    checkMatchesSimpleVehicle< TestPlanarVehicle >( VehiclePopulation::planar );
+}
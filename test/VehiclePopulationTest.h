@@ -0,0 +1,112 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::VehiclePopulation.
+ */
+#ifndef OPENSTEER_VEHICLEPOPULATIONTEST_H
+#define OPENSTEER_VEHICLEPOPULATIONTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::VehiclePopulation
+#include "OpenSteer/VehiclePopulation.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class VehiclePopulationTest : public CppUnit::TestFixture {
+    public:
+        VehiclePopulationTest();
+        virtual ~VehiclePopulationTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(VehiclePopulationTest);
+        CPPUNIT_TEST(testAddLoadStore);
+        CPPUNIT_TEST(testRemove);
+        CPPUNIT_TEST(testMatchesSimpleVehicle);
+        CPPUNIT_TEST(testMatchesSimpleVehicleBanking);
+        CPPUNIT_TEST(testMatchesPlanarVehicle);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        VehiclePopulationTest( VehiclePopulationTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        VehiclePopulationTest& operator=( VehiclePopulationTest const& );
+        
+    private:
+        /**
+         * Tests that a vehicle's state survives a round trip through the
+         * population and that @c add() matches a reset @c SimpleVehicle.
+         */
+        void testAddLoadStore();
+        
+        /**
+         * Tests that @c remove moves the last vehicle into the freed slot.
+         */
+        void testRemove();
+        
+        /**
+         * Tests that @c applySteeringForces integrates like
+         * @c SimpleVehicle::applySteeringForce over many steps.
+         */
+        void testMatchesSimpleVehicle();
+        
+        /**
+         * As above for the banking local space mode.
+         */
+        void testMatchesSimpleVehicleBanking();
+        
+        /**
+         * As above for the planar mode and @c PlanarVehicle (with forces
+         * off the plane, which both project onto it).
+         */
+        void testMatchesPlanarVehicle();
+        
+    }; // VehiclePopulationTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_VEHICLEPOPULATIONTEST_H
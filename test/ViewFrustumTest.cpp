@@ -0,0 +1,223 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::ViewFrustum.
+ */
+#include "ViewFrustumTest.h"
+
+
+// Include std::vector
+#include <vector>
+
+// Include std::sort
+#include <algorithm>
+
+// Include OpenSteer::ViewFrustum
+#include "OpenSteer/ViewFrustum.h"
+
+// Include OpenSteer::LQProximityDatabase
+#include "OpenSteer/Proximity.h"
+
+// Include OpenSteer::SimpleVehicle
+#include "OpenSteer/SimpleVehicle.h"
+
+// Include OpenSteer::RandomStream
+#include "OpenSteer/Random.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::ViewFrustumTest );
+
+
+
+OpenSteer::ViewFrustumTest::ViewFrustumTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::ViewFrustumTest::~ViewFrustumTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::ViewFrustumTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::ViewFrustumTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    typedef OpenSteer::AbstractVehicle* Vehicle;
+    typedef OpenSteer::AbstractTokenForProximityDatabase< Vehicle > Token;
+    
+    
+    class TestVehicle : public OpenSteer::SimpleVehicle {
+    public:
+        void update( float const, float const ) {}
+    };
+    
+    
+    /**
+     * A camera at the origin looking along +z with a 90 degree field of
+     * view, so the side planes are at 45 degrees.
+     */
+    OpenSteer::ViewFrustum alongZ() {
+        return OpenSteer::ViewFrustum( OpenSteer::Vec3( 0.0f, 0.0f, 0.0f ),
+                                       OpenSteer::Vec3( 0.0f, 0.0f, 10.0f ),
+                                       OpenSteer::Vec3( 0.0f, 1.0f, 0.0f ),
+                                       90.0f, 1.0f, 1.0f, 100.0f );
+    }
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::ViewFrustumTest::testIntersectsSphere()
+{
+    ViewFrustum const frustum = alongZ();
+    
+    CPPUNIT_ASSERT( frustum.intersectsSphere( Vec3( 0.0f, 0.0f, 50.0f ), 1.0f ) );
+    CPPUNIT_ASSERT( frustum.intersectsSphere( Vec3( 40.0f, -40.0f, 50.0f ), 1.0f ) );
+    CPPUNIT_ASSERT( frustum.intersectsSphere( Vec3( 0.0f, 0.0f, 100.5f ), 1.0f ) );
+    
+    CPPUNIT_ASSERT( ! frustum.intersectsSphere( Vec3( 0.0f, 0.0f, -5.0f ), 1.0f ) );
+    CPPUNIT_ASSERT( ! frustum.intersectsSphere( Vec3( 0.0f, 0.0f, 0.5f ), 0.1f ) );
+    CPPUNIT_ASSERT( ! frustum.intersectsSphere( Vec3( 0.0f, 0.0f, 105.0f ), 1.0f ) );
+    CPPUNIT_ASSERT( ! frustum.intersectsSphere( Vec3( 60.0f, 0.0f, 50.0f ), 1.0f ) );
+    CPPUNIT_ASSERT( ! frustum.intersectsSphere( Vec3( 0.0f, 60.0f, 50.0f ), 1.0f ) );
+}
+
+
+
+void 
+OpenSteer::ViewFrustumTest::testBoundingSphereOfGroundInView()
+{
+    // 20 above the ground looking straight down: the visible part of the
+    // ground is a square of half width 20 tan(22.5 degrees)
+    ViewFrustum const frustum( Vec3( 0.0f, 20.0f, 0.0f ),
+                               Vec3( 0.0f, 0.0f, 0.0f ),
+                               Vec3( 0.0f, 0.0f, 1.0f ),
+                               45.0f, 1.0f, 1.0f, 400.0f );
+    float const halfWidth = 20.0f * 0.41421356f;
+    
+    Vec3 center;
+    float radius = 0.0f;
+    CPPUNIT_ASSERT( frustum.boundingSphereWithin( Vec3( -1000.0f, 0.0f, -1000.0f ),
+                                                  Vec3( 1000.0f, 0.0f, 1000.0f ),
+                                                  center, radius ) );
+    CPPUNIT_ASSERT( center.length() < 0.01f );
+    CPPUNIT_ASSERT( radius >= halfWidth * 1.41421356f - 0.01f );
+    CPPUNIT_ASSERT( radius < halfWidth * 1.41421356f + 0.01f );
+}
+
+
+
+void 
+OpenSteer::ViewFrustumTest::testBoxOutOfView()
+{
+    ViewFrustum const frustum = alongZ();
+    
+    Vec3 center;
+    float radius = 0.0f;
+    CPPUNIT_ASSERT( ! frustum.boundingSphereWithin( Vec3( -10.0f, -10.0f, -30.0f ),
+                                                    Vec3( 10.0f, 10.0f, -5.0f ),
+                                                    center, radius ) );
+    CPPUNIT_ASSERT( ! frustum.boundingSphereWithin( Vec3( -10.0f, -10.0f, 150.0f ),
+                                                    Vec3( 10.0f, 10.0f, 200.0f ),
+                                                    center, radius ) );
+    CPPUNIT_ASSERT( frustum.boundingSphereWithin( Vec3( -10.0f, -10.0f, -30.0f ),
+                                                  Vec3( 10.0f, 10.0f, 30.0f ),
+                                                  center, radius ) );
+}
+
+
+
+void 
+OpenSteer::ViewFrustumTest::testFindVisibleVehiclesMatchesAllVehicles()
+{
+    Vec3 const extent( 100.0f, 100.0f, 100.0f );
+    LQProximityDatabase< Vehicle > database( Vec3( 0.0f, 0.0f, 0.0f ),
+                                             extent,
+                                             Vec3( 10.0f, 10.0f, 10.0f ) );
+    std::vector< TestVehicle > vehicles( 500 );
+    std::vector< Token* > tokens( vehicles.size() );
+    RandomStream random( 5 );
+    for ( std::size_t i = 0; i < vehicles.size(); ++i ) {
+        vehicles[ i ].setPosition( Vec3( random.frandom2( -50.0f, 50.0f ),
+                                         random.frandom2( -50.0f, 50.0f ),
+                                         random.frandom2( -50.0f, 50.0f ) ) );
+        tokens[ i ] = database.allocateToken( &vehicles[ i ] );
+        tokens[ i ]->updateForNewPosition( vehicles[ i ].position() );
+    }
+    
+    // from inside the box looking at a corner of it
+    ViewFrustum const frustum( Vec3( 10.0f, 0.0f, 10.0f ),
+                               Vec3( 50.0f, 20.0f, 50.0f ),
+                               Vec3( 0.0f, 1.0f, 0.0f ),
+                               45.0f, 1.5f, 1.0f, 400.0f );
+    
+    std::vector< AbstractVehicle* > expected;
+    for ( std::size_t i = 0; i < vehicles.size(); ++i ) {
+        if ( frustum.intersectsSphere( vehicles[ i ].position(), vehicles[ i ].radius() ) ) {
+            expected.push_back( &vehicles[ i ] );
+        }
+    }
+    
+    std::vector< AbstractVehicle* > found( 1, &vehicles[ 0 ] );
+    frustum.findVisibleVehicles( *tokens[ 0 ], extent * -0.5f, extent * 0.5f,
+                                 vehicles[ 0 ].radius(), found );
+    CPPUNIT_ASSERT( found[ 0 ] == &vehicles[ 0 ] );
+    found.erase( found.begin() );
+    
+    std::sort( expected.begin(), expected.end() );
+    std::sort( found.begin(), found.end() );
+    CPPUNIT_ASSERT( ! expected.empty() );
+    CPPUNIT_ASSERT( expected.size() < vehicles.size() / 4 );
+    CPPUNIT_ASSERT( found == expected );
+    
+    for ( std::size_t i = 0; i < tokens.size(); ++i ) {
+        delete tokens[ i ];
+    }
+}
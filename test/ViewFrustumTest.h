@@ -0,0 +1,102 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::ViewFrustum.
+ */
+#ifndef OPENSTEER_VIEWFRUSTUMTEST_H
+#define OPENSTEER_VIEWFRUSTUMTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class ViewFrustumTest : public CppUnit::TestFixture {
+    public:
+        ViewFrustumTest();
+        virtual ~ViewFrustumTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(ViewFrustumTest);
+        CPPUNIT_TEST(testIntersectsSphere);
+        CPPUNIT_TEST(testBoundingSphereOfGroundInView);
+        CPPUNIT_TEST(testBoxOutOfView);
+        CPPUNIT_TEST(testFindVisibleVehiclesMatchesAllVehicles);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ViewFrustumTest( ViewFrustumTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        ViewFrustumTest& operator=( ViewFrustumTest const& );
+        
+    private:
+        /**
+         * Tests that spheres in front of the camera intersect the frustum,
+         * and spheres behind it, beyond the far plane or off to its side
+         * do not.
+         */
+        void testIntersectsSphere();
+        
+        /**
+         * Tests that looking straight down at a large ground plane the
+         * sphere bounding its visible part is about as small as the part
+         * itself.
+         */
+        void testBoundingSphereOfGroundInView();
+        
+        /**
+         * Tests that a box behind the camera has no visible part.
+         */
+        void testBoxOutOfView();
+        
+        /**
+         * Tests that the vehicles found visible through the proximity
+         * database are those of all vehicles which intersect the frustum,
+         * appended to the given group.
+         */
+        void testFindVisibleVehiclesMatchesAllVehicles();
+        
+    }; // class ViewFrustumTest
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_VIEWFRUSTUMTEST_H
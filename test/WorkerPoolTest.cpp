@@ -0,0 +1,302 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::WorkerPool.
+ */
+#include "WorkerPoolTest.h"
+
+
+// Include OpenSteer::SimulationContexts
+#include "OpenSteer/SimulationContext.h"
+
+#include <atomic>
+#include <vector>
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::WorkerPoolTest );
+
+
+
+OpenSteer::WorkerPoolTest::WorkerPoolTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::WorkerPoolTest::~WorkerPoolTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::WorkerPoolTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::WorkerPoolTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    
+    /**
+     * Counts how often each index is visited and the largest range seen.
+     */
+    class VisitCounter {
+    public:
+        explicit VisitCounter( size_t count ) : visits_( count ), largestRange_( 0 ) {
+            for ( size_t i = 0; i < count; ++i ) {
+                visits_[ i ] = 0;
+            }
+        }
+        
+        void operator()( size_t begin, size_t end ) {
+            for ( size_t i = begin; i < end; ++i ) {
+                ++visits_[ i ];
+            }
+            
+            size_t const range = end - begin;
+            size_t largest = largestRange_.load();
+            while ( range > largest && 
+                    ! largestRange_.compare_exchange_weak( largest, range ) ) {
+                // Retry with the updated largest value.
+            }
+        }
+        
+        bool eachVisitedOnce() const {
+            for ( size_t i = 0; i < visits_.size(); ++i ) {
+                if ( 1 != visits_[ i ].load() ) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        
+        size_t largestRange() const {
+            return largestRange_.load();
+        }
+        
+    private:
+        std::vector< std::atomic< int > > visits_;
+        std::atomic< size_t > largestRange_;
+    }; // class VisitCounter
+    
+    
+    /**
+     * Runs an inner loop on the same pool for each index of the outer one.
+     */
+    class NestedLoop {
+    public:
+        NestedLoop( OpenSteer::WorkerPool& pool, std::vector< VisitCounter* > const& counters, size_t innerCount, size_t innerGrainSize = 0 ) 
+            : pool_( pool ), counters_( counters ), innerCount_( innerCount ), innerGrainSize_( innerGrainSize ) {}
+        
+        void operator()( size_t begin, size_t end ) {
+            for ( size_t i = begin; i < end; ++i ) {
+                pool_.parallelFor( innerCount_, *counters_[ i ], innerGrainSize_ );
+            }
+        }
+        
+    private:
+        OpenSteer::WorkerPool& pool_;
+        std::vector< VisitCounter* > const& counters_;
+        size_t innerCount_;
+        size_t innerGrainSize_;
+    }; // class NestedLoop
+    
+    
+    /**
+     * Appends each index it visits to the neighbors of the calling thread's
+     * simulation context.
+     */
+    class ContextFiller {
+    public:
+        explicit ContextFiller( OpenSteer::SimulationContexts& contexts ) 
+            : contexts_( contexts ) {}
+        
+        void operator()( size_t begin, size_t end ) {
+            OpenSteer::SimulationContext& context = contexts_.forThisThread();
+            for ( size_t i = begin; i < end; ++i ) {
+                context.neighbors.push_back( reinterpret_cast< OpenSteer::AbstractVehicle* >( i + 1 ) );
+            }
+        }
+        
+    private:
+        OpenSteer::SimulationContexts& contexts_;
+    }; // class ContextFiller
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::WorkerPoolTest::testThreadCount()
+{
+    WorkerPool single( 1 );
+    CPPUNIT_ASSERT_EQUAL( 1, single.threadCount() );
+    
+    WorkerPool four( 4 );
+    CPPUNIT_ASSERT_EQUAL( 4, four.threadCount() );
+    
+    four.setThreadCount( 2 );
+    CPPUNIT_ASSERT_EQUAL( 2, four.threadCount() );
+    
+    WorkerPool hardware;
+    CPPUNIT_ASSERT( hardware.threadCount() >= 1 );
+}
+
+
+
+void 
+OpenSteer::WorkerPoolTest::testEachIndexVisitedOnce()
+{
+    int const threadCounts[] = { 1, 2, 3, 8 };
+    size_t const counts[] = { 0, 1, 7, 100, 10007 };
+    
+    for ( size_t t = 0; t < sizeof( threadCounts ) / sizeof( threadCounts[ 0 ] ); ++t ) {
+        WorkerPool pool( threadCounts[ t ] );
+        
+        for ( size_t c = 0; c < sizeof( counts ) / sizeof( counts[ 0 ] ); ++c ) {
+            VisitCounter counter( counts[ c ] );
+            pool.parallelFor( counts[ c ], counter );
+            CPPUNIT_ASSERT( counter.eachVisitedOnce() );
+        }
+    }
+}
+
+
+
+void 
+OpenSteer::WorkerPoolTest::testGrainSize()
+{
+    WorkerPool pool( 4 );
+    
+    VisitCounter counter( 1000 );
+    pool.parallelFor( 1000, counter, 16 );
+    CPPUNIT_ASSERT( counter.eachVisitedOnce() );
+    CPPUNIT_ASSERT( counter.largestRange() <= 16 );
+    
+    // Without workers the caller runs the ranges itself, just as small.
+    WorkerPool single( 1 );
+    VisitCounter serial( 1000 );
+    single.parallelFor( 1000, serial, 16 );
+    CPPUNIT_ASSERT( serial.eachVisitedOnce() );
+    CPPUNIT_ASSERT( serial.largestRange() <= 16 );
+    
+    // So does a loop nested in the body of another.
+    std::vector< VisitCounter* > counters;
+    for ( size_t i = 0; i < 8; ++i ) {
+        counters.push_back( new VisitCounter( 300 ) );
+    }
+    NestedLoop loop( pool, counters, 300, 16 );
+    pool.parallelFor( counters.size(), loop, 1 );
+    for ( size_t i = 0; i < counters.size(); ++i ) {
+        CPPUNIT_ASSERT( counters[ i ]->eachVisitedOnce() );
+        CPPUNIT_ASSERT( counters[ i ]->largestRange() <= 16 );
+        delete counters[ i ];
+    }
+}
+
+
+
+void 
+OpenSteer::WorkerPoolTest::testRepeatedLoops()
+{
+    WorkerPool pool( 4 );
+    
+    for ( int frame = 0; frame < 1000; ++frame ) {
+        VisitCounter counter( 257 );
+        pool.parallelFor( 257, counter, 8 );
+        CPPUNIT_ASSERT( counter.eachVisitedOnce() );
+    }
+}
+
+
+
+void 
+OpenSteer::WorkerPoolTest::testNestedLoops()
+{
+    WorkerPool pool( 4 );
+    size_t const outerCount = 64;
+    size_t const innerCount = 300;
+    
+    std::vector< VisitCounter* > counters;
+    for ( size_t i = 0; i < outerCount; ++i ) {
+        counters.push_back( new VisitCounter( innerCount ) );
+    }
+    
+    NestedLoop loop( pool, counters, innerCount );
+    pool.parallelFor( outerCount, loop, 1 );
+    
+    for ( size_t i = 0; i < outerCount; ++i ) {
+        CPPUNIT_ASSERT( counters[ i ]->eachVisitedOnce() );
+        delete counters[ i ];
+    }
+}
+
+
+
+void 
+OpenSteer::WorkerPoolTest::testThreadContexts()
+{
+    CPPUNIT_ASSERT_EQUAL( 0, WorkerPool::currentThreadIndex() );
+    
+    WorkerPool pool( 4 );
+    SimulationContexts contexts;
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), contexts.size() );
+    contexts.prepare( pool );
+    CPPUNIT_ASSERT_EQUAL( size_t( 4 ), contexts.size() );
+    
+    size_t const count = 10000;
+    ContextFiller filler( contexts );
+    pool.parallelFor( count, filler, 7 );
+    
+    // Each index went to exactly one context.
+    std::vector< int > visits( count, 0 );
+    for ( size_t c = 0; c < contexts.size(); ++c ) {
+        AVGroup const& neighbors = contexts[ c ].neighbors;
+        for ( size_t n = 0; n < neighbors.size(); ++n ) {
+            ++visits[ reinterpret_cast< size_t >( neighbors[ n ] ) - 1 ];
+        }
+    }
+    for ( size_t i = 0; i < count; ++i ) {
+        CPPUNIT_ASSERT_EQUAL( 1, visits[ i ] );
+    }
+}
@@ -0,0 +1,119 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::WorkerPool.
+ */
+#ifndef OPENSTEER_WORKERPOOLTEST_H
+#define OPENSTEER_WORKERPOOLTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+// Include OpenSteer::WorkerPool
+#include "OpenSteer/WorkerPool.h"
+
+
+
+namespace OpenSteer {
+    
+    
+    class WorkerPoolTest : public CppUnit::TestFixture {
+    public:
+        WorkerPoolTest();
+        virtual ~WorkerPoolTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(WorkerPoolTest);
+        CPPUNIT_TEST(testThreadCount);
+        CPPUNIT_TEST(testEachIndexVisitedOnce);
+        CPPUNIT_TEST(testGrainSize);
+        CPPUNIT_TEST(testRepeatedLoops);
+        CPPUNIT_TEST(testNestedLoops);
+        CPPUNIT_TEST(testThreadContexts);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        WorkerPoolTest( WorkerPoolTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        WorkerPoolTest& operator=( WorkerPoolTest const& );
+        
+    private:
+        /**
+         * Tests construction with explicit and hardware thread counts.
+         */
+        void testThreadCount();
+        
+        /**
+         * Tests that @c parallelFor calls its body for every index of the
+         * range exactly once, for several pool and range sizes.
+         */
+        void testEachIndexVisitedOnce();
+        
+        /**
+         * Tests that no sub-range handed to the body exceeds the grain size.
+         */
+        void testGrainSize();
+        
+        /**
+         * Tests many back to back loops on one pool, as a per frame update
+         * does.
+         */
+        void testRepeatedLoops();
+        
+        /**
+         * Tests that a loop started from inside a loop body on the same 
+         * pool runs to completion.
+         */
+        void testNestedLoops();
+        
+        /**
+         * Tests that loop bodies see distinct thread indices below the
+         * thread count, so each can use its own simulation context.
+         */
+        void testThreadContexts();
+        
+    }; // WorkerPoolTest
+    
+    
+    
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_WORKERPOOLTEST_H
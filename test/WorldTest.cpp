@@ -0,0 +1,298 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::World and @c OpenSteer::WorldScheduler.
+ */
+#include "WorldTest.h"
+
+
+// Include std::string
+#include <string>
+
+// Include std::vector
+#include <vector>
+
+// Include OpenSteer::World, OpenSteer::WorldScheduler
+#include "OpenSteer/World.h"
+
+// Include OpenSteer::PlugIn
+#include "OpenSteer/PlugIn.h"
+
+// Include OpenSteer::SimpleVehicle
+#include "OpenSteer/SimpleVehicle.h"
+
+// Include OpenSteer::WorkerPool
+#include "OpenSteer/WorkerPool.h"
+
+// Include OpenSteer::frandom01
+#include "OpenSteer/Utilities.h"
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( OpenSteer::WorldTest );
+
+
+
+OpenSteer::WorldTest::WorldTest()
+{
+    // Nothing to do.
+}
+
+
+
+OpenSteer::WorldTest::~WorldTest()
+{
+    // Nothing to do.
+}
+
+
+
+
+void 
+OpenSteer::WorldTest::setUp()
+{
+    TestFixture::setUp();
+}
+
+
+
+void 
+OpenSteer::WorldTest::tearDown()
+{
+    TestFixture::tearDown();
+}
+
+
+
+namespace {
+    
+    class TestVehicle : public OpenSteer::SimpleVehicle {
+    public:
+        void update( float const, float const ) {}
+    };
+    
+    
+    /**
+     * Vehicles placed with the default random stream which wander by their
+     * own streams, at a speed set by the parameter "speed".  Neither the
+     * prototypes nor the world instances are registered.
+     */
+    class WanderPlugIn : public OpenSteer::PlugIn {
+    public:
+        WanderPlugIn() : PlugIn( worldInstance ), speed_( 1.0f ) {}
+        
+        const char* name() { return "Wander"; }
+        
+        void open() {
+            speed_ = 1.0f;
+            for ( int i = 0; i < 20; ++i ) {
+                TestVehicle* const vehicle = new TestVehicle;
+                vehicle->setPosition( OpenSteer::Vec3( OpenSteer::frandom01(), 0.0f,
+                                                       OpenSteer::frandom01() ) );
+                vehicles_.push_back( vehicle );
+            }
+        }
+        
+        void update( float const, float const elapsedTime ) {
+            for ( std::size_t i = 0; i < vehicles_.size(); ++i ) {
+                OpenSteer::RandomStream& random =
+                    static_cast< TestVehicle* >( vehicles_[ i ] )->randomStream();
+                OpenSteer::Vec3 const step( random.frandom2( -1.0f, 1.0f ), 0.0f,
+                                            random.frandom2( -1.0f, 1.0f ) );
+                vehicles_[ i ]->setPosition( vehicles_[ i ]->position() +
+                                             step * speed_ * elapsedTime );
+            }
+        }
+        
+        void redraw( float const, float const ) {}
+        
+        void close() {
+            for ( std::size_t i = 0; i < vehicles_.size(); ++i ) {
+                delete vehicles_[ i ];
+            }
+            vehicles_.clear();
+        }
+        
+        bool setParameter( char const* name, float const value ) {
+            if ( std::string( name ) != "speed" ) {
+                return false;
+            }
+            speed_ = value;
+            return true;
+        }
+        
+        float speed() const { return speed_; }
+        
+        const OpenSteer::AVGroup& allVehicles() { return vehicles_; }
+        
+        OpenSteer::AbstractPlugIn* newWorldInstance() { return new WanderPlugIn; }
+        
+    private:
+        OpenSteer::AVGroup vehicles_;
+        float speed_;
+    };
+    
+    
+    /**
+     * A PlugIn only running as its singleton.
+     */
+    class SingletonPlugIn : public WanderPlugIn {
+    public:
+        OpenSteer::AbstractPlugIn* newWorldInstance() { return NULL; }
+    };
+    
+    
+    /**
+     * The positions of the vehicles of @a world.
+     */
+    std::vector< OpenSteer::Vec3 > positions( OpenSteer::World& world ) {
+        std::vector< OpenSteer::Vec3 > result;
+        OpenSteer::AVGroup const& vehicles = world.allVehicles();
+        for ( std::size_t i = 0; i < vehicles.size(); ++i ) {
+            result.push_back( vehicles[ i ]->position() );
+        }
+        return result;
+    }
+    
+    
+    float const stepSize = 1.0f / 60.0f;
+    
+    
+} // anonymous namespace
+
+
+
+void 
+OpenSteer::WorldTest::testSingletonPlugInHasNoWorld()
+{
+    SingletonPlugIn singleton;
+    World world( singleton, 1u );
+    CPPUNIT_ASSERT( ! world.isValid() );
+    
+    WanderPlugIn prototype;
+    World other( prototype, 1u );
+    CPPUNIT_ASSERT( other.isValid() );
+    CPPUNIT_ASSERT( &other.plugIn() != &prototype );
+}
+
+
+
+void 
+OpenSteer::WorldTest::testSchedulerStepsEveryWorld()
+{
+    WanderPlugIn prototype;
+    std::vector< World* > worlds;
+    WorkerPool pool( 4 );
+    WorldScheduler scheduler( pool );
+    for ( uint64_t seed = 0; seed < 50; ++seed ) {
+        worlds.push_back( new World( prototype, seed ) );
+        scheduler.add( *worlds.back() );
+    }
+    CPPUNIT_ASSERT_EQUAL( std::size_t( 50 ), scheduler.size() );
+    
+    scheduler.openAll();
+    scheduler.step( stepSize, 10 );
+    scheduler.step( stepSize );
+    for ( std::size_t i = 0; i < worlds.size(); ++i ) {
+        CPPUNIT_ASSERT( worlds[ i ]->isOpen() );
+        CPPUNIT_ASSERT_EQUAL( 11, worlds[ i ]->stepCount() );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( 11 * stepSize, worlds[ i ]->currentTime(), 1e-5 );
+        CPPUNIT_ASSERT_EQUAL( std::size_t( 20 ), worlds[ i ]->allVehicles().size() );
+    }
+    CPPUNIT_ASSERT( prototype.allVehicles().empty() );
+    
+    scheduler.closeAll();
+    for ( std::size_t i = 0; i < worlds.size(); ++i ) {
+        CPPUNIT_ASSERT( ! worlds[ i ]->isOpen() );
+        delete worlds[ i ];
+    }
+}
+
+
+
+void 
+OpenSteer::WorldTest::testWorldsRepeatThemselves()
+{
+    WanderPlugIn prototype;
+    
+    // alone, on this thread
+    World alone( prototype, 7u );
+    alone.open();
+    for ( int i = 0; i < 30; ++i ) {
+        alone.step( stepSize );
+    }
+    
+    // among others on a pool, created after many other vehicles
+    std::vector< World* > worlds;
+    WorkerPool pool( 4 );
+    WorldScheduler scheduler( pool );
+    for ( uint64_t seed = 0; seed < 16; ++seed ) {
+        worlds.push_back( new World( prototype, seed ) );
+        scheduler.add( *worlds.back() );
+    }
+    scheduler.openAll();
+    scheduler.step( stepSize, 30 );
+    
+    CPPUNIT_ASSERT( positions( alone ) == positions( *worlds[ 7 ] ) );
+    CPPUNIT_ASSERT( positions( alone ) != positions( *worlds[ 8 ] ) );
+    
+    for ( std::size_t i = 0; i < worlds.size(); ++i ) {
+        delete worlds[ i ];
+    }
+}
+
+
+
+void 
+OpenSteer::WorldTest::testParametersReachTheWorldInstance()
+{
+    WanderPlugIn prototype;
+    World world( prototype, 1u );
+    CPPUNIT_ASSERT( ! world.setParameter( "speed", 0.0f ) );
+    
+    world.open();
+    CPPUNIT_ASSERT( ! world.setParameter( "size", 0.0f ) );
+    CPPUNIT_ASSERT( world.setParameter( "speed", 0.0f ) );
+    CPPUNIT_ASSERT_EQUAL( 1.0f, prototype.speed() );
+    
+    std::vector< Vec3 > const before = positions( world );
+    for ( int i = 0; i < 10; ++i ) {
+        world.step( stepSize );
+    }
+    std::vector< Vec3 > const after = positions( world );
+    for ( std::size_t i = 0; i < before.size(); ++i ) {
+        CPPUNIT_ASSERT( before[ i ] == after[ i ] );
+    }
+    
+    // reopening restores the default speed
+    WanderPlugIn& instance = static_cast< WanderPlugIn& >( world.plugIn() );
+    CPPUNIT_ASSERT_EQUAL( 0.0f, instance.speed() );
+    world.close();
+    world.open();
+    CPPUNIT_ASSERT_EQUAL( 1.0f, instance.speed() );
+    world.close();
+}
@@ -0,0 +1,101 @@
+/**
+ * OpenSteer -- Steering Behaviors for Autonomous Characters
+ *
+ * Copyright (c) 2002-2005, Sony Computer Entertainment America
+ * Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * @file
+ *
+ * Unit test for @c OpenSteer::World and @c OpenSteer::WorldScheduler.
+ */
+#ifndef OPENSTEER_WORLDTEST_H
+#define OPENSTEER_WORLDTEST_H
+
+
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+
+namespace OpenSteer {
+    
+    
+    class WorldTest : public CppUnit::TestFixture {
+    public:
+        WorldTest();
+        virtual ~WorldTest();
+        
+        virtual void setUp();
+        virtual void tearDown();
+        
+        CPPUNIT_TEST_SUITE(WorldTest);
+        CPPUNIT_TEST(testSingletonPlugInHasNoWorld);
+        CPPUNIT_TEST(testSchedulerStepsEveryWorld);
+        CPPUNIT_TEST(testWorldsRepeatThemselves);
+        CPPUNIT_TEST(testParametersReachTheWorldInstance);
+        CPPUNIT_TEST_SUITE_END();
+        
+    private:
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        WorldTest( WorldTest const& );
+        
+        /**
+         * Not implemented to make it non-copyable.
+         */
+        WorldTest& operator=( WorldTest const& );
+        
+    private:
+        /**
+         * Tests that a world of a PlugIn which cannot make world
+         * instances is not valid.
+         */
+        void testSingletonPlugInHasNoWorld();
+        
+        /**
+         * Tests that the scheduler opens, steps and closes every world,
+         * each with its own unregistered PlugIn instance.
+         */
+        void testSchedulerStepsEveryWorld();
+        
+        /**
+         * Tests that worlds with equal seeds end up in the same state
+         * whether stepped alone or concurrently with other worlds, and
+         * worlds with different seeds do not.
+         */
+        void testWorldsRepeatThemselves();
+        
+        /**
+         * Tests that parameters set through an open world reach its
+         * PlugIn instance, not the prototype, until it is reopened.
+         */
+        void testParametersReachTheWorldInstance();
+        
+    }; // class WorldTest
+    
+} // namespace OpenSteer
+
+
+#endif // OPENSTEER_WORLDTEST_H